@@ -20,6 +20,19 @@
 
 #include "bradler16.h"
 
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define ADLER16_SIMD
+#include "bratomic.h"
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+#if defined(BURGER_MSVC)
+#define ADLER16_TARGET(x)
+#else
+#define ADLER16_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
 #if !defined(DOXYGEN)
 // Note : Do NOT alter these defines or the checksum
 // will not be the same as found in deflate/inflate gzip
@@ -29,6 +42,59 @@
 #define LARGESTBLOCK 5802	// NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
 #endif
 
+//
+// SSSE3 version for Intel/AMD processors.
+// It's compiled with the instruction set enabled on a per
+// function basis and only called if CPUID reports the feature
+//
+
+#if defined(ADLER16_SIMD)
+
+//
+// Checksum uBlocks 32 byte blocks, the same way as the
+// SSSE3 version of CalcAdler32() but with the 8 bit prime
+//
+
+ADLER16_TARGET("ssse3") static Word Adler16SSSE3(Word uAdler16,const Word8 *pInput,WordPtr uBlocks)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i Ones = _mm_set1_epi16(1);
+	const __m128i Taps1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17);
+	const __m128i Taps2 = _mm_setr_epi8(16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	Word32 uAdditive = static_cast<Word8>(uAdler16);
+	Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);
+	do {
+		// Don't overflow 32 bits before the modulo
+		WordPtr uCount = LARGESTBLOCK/32;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+		__m128i PrevSums = _mm_cvtsi32_si128(static_cast<int>(uAdditive*static_cast<Word32>(uCount)));
+		__m128i Factorial = _mm_cvtsi32_si128(static_cast<int>(uFactorial));
+		__m128i Additive = _mm_setzero_si128();
+		do {
+			__m128i Bytes1 = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput)));
+			__m128i Bytes2 = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput+16)));
+			PrevSums = _mm_add_epi32(PrevSums,Additive);
+			Additive = _mm_add_epi32(Additive,_mm_add_epi32(_mm_sad_epu8(Bytes1,Zero),_mm_sad_epu8(Bytes2,Zero)));
+			Factorial = _mm_add_epi32(Factorial,_mm_madd_epi16(_mm_maddubs_epi16(Bytes1,Taps1),Ones));
+			Factorial = _mm_add_epi32(Factorial,_mm_madd_epi16(_mm_maddubs_epi16(Bytes2,Taps2),Ones));
+			pInput += 32;
+		} while (--uCount);
+		Factorial = _mm_add_epi32(Factorial,_mm_slli_epi32(PrevSums,5));
+
+		// Add the lanes together
+		Additive = _mm_add_epi32(Additive,_mm_shuffle_epi32(Additive,_MM_SHUFFLE(1,0,3,2)));
+		Factorial = _mm_add_epi32(Factorial,_mm_shuffle_epi32(Factorial,_MM_SHUFFLE(1,0,3,2)));
+		Factorial = _mm_add_epi32(Factorial,_mm_shuffle_epi32(Factorial,_MM_SHUFFLE(2,3,0,1)));
+		uAdditive = (uAdditive+static_cast<Word32>(_mm_cvtsi128_si32(Additive)))%LARGESTPRIME;
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(Factorial))%LARGESTPRIME;
+	} while (uBlocks);
+	return static_cast<Word>((uFactorial<<8U)+uAdditive);
+}
+#endif
+
 /*! ************************************
 
 	\brief Compute the (Mark) Adler-16 checksum
@@ -46,6 +112,9 @@
 	The upper 8 bits is a factorial additive checksum based on the
 	additive checksum with a starting value of 0
 
+	On Intel and AMD processors with SSSE3, the sums are
+	calculated 32 bytes at a time with the same result.
+
 	\param pInput Pointer to a buffer to be checksummed
 	\param uInputLength Number of bytes in the buffer to be checksummed
 	\param uAdler16 Alder-16 from previous calculations or one if a new checksum is desired
@@ -60,6 +129,17 @@ Word BURGER_API Burger::CalcAdler16(const void *pInput,WordPtr uInputLength,Word
 {
 	// Anything to process?
 	if (pInput && uInputLength) {
+#if defined(ADLER16_SIMD)
+		if ((uInputLength>=64) && GetCPUID()->HasSSSE3()) {
+			uAdler16 = Adler16SSSE3(uAdler16,static_cast<const Word8 *>(pInput),uInputLength>>5U);
+			pInput = static_cast<const Word8 *>(pInput)+(uInputLength&(~static_cast<WordPtr>(31U)));
+			uInputLength &= 31U;
+			// Was everything processed?
+			if (!uInputLength) {
+				return uAdler16;
+			}
+		}
+#endif
 
 		Word32 uAdditive = static_cast<Word8>(uAdler16);		// Get the additive checksum
 		Word32 uFactorial = static_cast<Word8>(uAdler16>>8U);	// Get the factorial checksum
@@ -20,6 +20,25 @@
 
 #include "bradler32.h"
 
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define ADLER32_SIMD
+#include "bratomic.h"
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+// AVX2 requires Visual Studio 2012 or higher
+#if !defined(BURGER_MSVC) || (_MSC_VER>=1700)
+#define ADLER32_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(BURGER_MSVC)
+#define ADLER32_TARGET(x)
+#else
+#define ADLER32_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
 #if !defined(DOXYGEN)
 // Note : Do NOT alter these defines or the checksum
 // will not be the same as found in deflate/inflate gzip
@@ -29,6 +48,115 @@
 #define LARGESTBLOCK 5552U	// This is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
 #endif
 
+//
+// Hardware accelerated versions for Intel/AMD processors.
+// They are compiled with the instruction set enabled on a per
+// function basis and only called if CPUID reports the feature
+//
+
+#if defined(ADLER32_SIMD)
+
+//
+// Checksum uBlocks 32 byte blocks.
+//
+// The additive sum is the sum of all the bytes, found with psadbw.
+// Each byte adds (32-index) times itself to the factorial sum within
+// the block, found with pmaddubsw. The additive sum at the start
+// of each block is added to the factorial sum 32 times, so it's
+// accumulated in PrevSums and multiplied by 32 at the end.
+//
+
+ADLER32_TARGET("ssse3") static Word32 Adler32SSSE3(Word32 uAdler32,const Word8 *pInput,WordPtr uBlocks)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i Ones = _mm_set1_epi16(1);
+	const __m128i Taps1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17);
+	const __m128i Taps2 = _mm_setr_epi8(16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	Word32 uAdditive = uAdler32&0xFFFFU;
+	Word32 uFactorial = uAdler32>>16U;
+	do {
+		// Don't overflow 32 bits before the modulo
+		WordPtr uCount = LARGESTBLOCK/32;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+		__m128i PrevSums = _mm_cvtsi32_si128(static_cast<int>(uAdditive*static_cast<Word32>(uCount)));
+		__m128i Factorial = _mm_cvtsi32_si128(static_cast<int>(uFactorial));
+		__m128i Additive = _mm_setzero_si128();
+		do {
+			__m128i Bytes1 = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput)));
+			__m128i Bytes2 = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput+16)));
+			PrevSums = _mm_add_epi32(PrevSums,Additive);
+			Additive = _mm_add_epi32(Additive,_mm_add_epi32(_mm_sad_epu8(Bytes1,Zero),_mm_sad_epu8(Bytes2,Zero)));
+			Factorial = _mm_add_epi32(Factorial,_mm_madd_epi16(_mm_maddubs_epi16(Bytes1,Taps1),Ones));
+			Factorial = _mm_add_epi32(Factorial,_mm_madd_epi16(_mm_maddubs_epi16(Bytes2,Taps2),Ones));
+			pInput += 32;
+		} while (--uCount);
+		Factorial = _mm_add_epi32(Factorial,_mm_slli_epi32(PrevSums,5));
+
+		// Add the lanes together
+		Additive = _mm_add_epi32(Additive,_mm_shuffle_epi32(Additive,_MM_SHUFFLE(1,0,3,2)));
+		Factorial = _mm_add_epi32(Factorial,_mm_shuffle_epi32(Factorial,_MM_SHUFFLE(1,0,3,2)));
+		Factorial = _mm_add_epi32(Factorial,_mm_shuffle_epi32(Factorial,_MM_SHUFFLE(2,3,0,1)));
+		uAdditive = (uAdditive+static_cast<Word32>(_mm_cvtsi128_si32(Additive)))%LARGESTPRIME;
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(Factorial))%LARGESTPRIME;
+	} while (uBlocks);
+	return (uFactorial<<16U)+uAdditive;
+}
+
+#if defined(ADLER32_AVX)
+
+//
+// Same as Adler32SSSE3() with 64 byte blocks
+//
+
+ADLER32_TARGET("avx2") static Word32 Adler32AVX2(Word32 uAdler32,const Word8 *pInput,WordPtr uBlocks)
+{
+	const __m256i Zero = _mm256_setzero_si256();
+	const __m256i Ones = _mm256_set1_epi16(1);
+	const __m256i Taps1 = _mm256_setr_epi8(64,63,62,61,60,59,58,57,56,55,54,53,52,51,50,49,
+		48,47,46,45,44,43,42,41,40,39,38,37,36,35,34,33);
+	const __m256i Taps2 = _mm256_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+		16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+	Word32 uAdditive = uAdler32&0xFFFFU;
+	Word32 uFactorial = uAdler32>>16U;
+	do {
+		// Don't overflow 32 bits before the modulo
+		WordPtr uCount = LARGESTBLOCK/64;
+		if (uBlocks<uCount) {
+			uCount = uBlocks;
+		}
+		uBlocks -= uCount;
+		__m256i PrevSums = _mm256_setr_epi32(static_cast<int>(uAdditive*static_cast<Word32>(uCount)),0,0,0,0,0,0,0);
+		__m256i Factorial = _mm256_setr_epi32(static_cast<int>(uFactorial),0,0,0,0,0,0,0);
+		__m256i Additive = _mm256_setzero_si256();
+		do {
+			__m256i Bytes1 = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pInput)));
+			__m256i Bytes2 = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pInput+32)));
+			PrevSums = _mm256_add_epi32(PrevSums,Additive);
+			Additive = _mm256_add_epi32(Additive,_mm256_add_epi32(_mm256_sad_epu8(Bytes1,Zero),_mm256_sad_epu8(Bytes2,Zero)));
+			Factorial = _mm256_add_epi32(Factorial,_mm256_madd_epi16(_mm256_maddubs_epi16(Bytes1,Taps1),Ones));
+			Factorial = _mm256_add_epi32(Factorial,_mm256_madd_epi16(_mm256_maddubs_epi16(Bytes2,Taps2),Ones));
+			pInput += 64;
+		} while (--uCount);
+		Factorial = _mm256_add_epi32(Factorial,_mm256_slli_epi32(PrevSums,6));
+
+		// Add the lanes together
+		__m128i Additive128 = _mm_add_epi32(_mm256_castsi256_si128(Additive),_mm256_extracti128_si256(Additive,1));
+		__m128i Factorial128 = _mm_add_epi32(_mm256_castsi256_si128(Factorial),_mm256_extracti128_si256(Factorial,1));
+		Additive128 = _mm_add_epi32(Additive128,_mm_shuffle_epi32(Additive128,_MM_SHUFFLE(1,0,3,2)));
+		Factorial128 = _mm_add_epi32(Factorial128,_mm_shuffle_epi32(Factorial128,_MM_SHUFFLE(1,0,3,2)));
+		Factorial128 = _mm_add_epi32(Factorial128,_mm_shuffle_epi32(Factorial128,_MM_SHUFFLE(2,3,0,1)));
+		uAdditive = (uAdditive+static_cast<Word32>(_mm_cvtsi128_si32(Additive128)))%LARGESTPRIME;
+		uFactorial = static_cast<Word32>(_mm_cvtsi128_si32(Factorial128))%LARGESTPRIME;
+	} while (uBlocks);
+	_mm256_zeroupper();
+	return (uFactorial<<16U)+uAdditive;
+}
+#endif
+#endif
+
 /*! ************************************
 
 	\brief Compute the (Mark) Adler-32 checksum
@@ -43,13 +171,16 @@
 	The upper 16 bits is a factorial additive checksum based on the
 	additive checksum with a starting value of 0
 
+	On Intel and AMD processors with AVX2 or SSSE3, the sums are
+	calculated 64 or 32 bytes at a time with the same result.
+
 	\param pInput Pointer to a buffer to be checksummed
 	\param uInputLength Number of bytes in the buffer to be checksummed
 	\param uAdler32 Alder-32 from previous calculations or one if a new checksum is desired
 
 	\return 32 bit Alder-32 checksum of the data
 
-	\sa CalcCRC32B(const void *,WordPtr,Word32) or CalcAdler16(const void *,WordPtr,Word32)
+	\sa CalcCRC32B(const void *,WordPtr,Word32), CombineAdler32(Word32,Word32,WordPtr) or CalcAdler16(const void *,WordPtr,Word32)
 
 ***************************************/
 
@@ -57,6 +188,27 @@ Word32 BURGER_API Burger::CalcAdler32(const void *pInput,WordPtr uInputLength,Wo
 {
 	// Any data to process?
 	if (pInput && uInputLength) {
+#if defined(ADLER32_SIMD)
+		if (uInputLength>=64) {
+			const CPUID_t *pCPUID = GetCPUID();
+#if defined(ADLER32_AVX)
+			if (pCPUID->HasAVX2() && pCPUID->IsAVXEnabled()) {
+				uAdler32 = Adler32AVX2(uAdler32,static_cast<const Word8 *>(pInput),uInputLength>>6U);
+				pInput = static_cast<const Word8 *>(pInput)+(uInputLength&(~static_cast<WordPtr>(63U)));
+				uInputLength &= 63U;
+			} else
+#endif
+			if (pCPUID->HasSSSE3()) {
+				uAdler32 = Adler32SSSE3(uAdler32,static_cast<const Word8 *>(pInput),uInputLength>>5U);
+				pInput = static_cast<const Word8 *>(pInput)+(uInputLength&(~static_cast<WordPtr>(31U)));
+				uInputLength &= 31U;
+			}
+			// Was everything processed?
+			if (!uInputLength) {
+				return uAdler32;
+			}
+		}
+#endif
 		Word32 uAdditive = static_cast<Word16>(uAdler32);	// Get the additive checksum
 		uAdler32 = static_cast<Word16>(uAdler32>>16U);	 	// Get the factorial checksum
 		do {
@@ -81,3 +233,47 @@ Word32 BURGER_API Burger::CalcAdler32(const void *pInput,WordPtr uInputLength,Wo
 	// Return the result
 	return uAdler32;
 }
+
+/*! ************************************
+
+	\brief Combine two (Mark) Adler-32 checksums
+
+	Given the Adler-32 checksums of two buffers, return the checksum
+	of the second buffer appended to the first, without
+	accessing the data. This allows buffers to be checksummed in pieces
+	on separate threads.
+
+	\param uAdler1 Alder-32 of the first buffer
+	\param uAdler2 Alder-32 of the second buffer, started with one
+	\param uLength2 Length in bytes of the second buffer
+
+	\return 32 bit Alder-32 checksum of both buffers
+
+	\sa CalcAdler32(const void *,WordPtr,Word32)
+
+***************************************/
+
+Word32 BURGER_API Burger::CombineAdler32(Word32 uAdler1,Word32 uAdler2,WordPtr uLength2)
+{
+	// Each byte of the second buffer added the first buffer's
+	// additive checksum to the factorial one more time
+	Word32 uRemainder = static_cast<Word32>(uLength2%LARGESTPRIME);
+	Word32 uAdditive = uAdler1&0xFFFFU;
+	Word32 uFactorial = (uRemainder*uAdditive)%LARGESTPRIME;
+	// The starting value of one in uAdler2 is counted twice, remove it
+	uAdditive += (uAdler2&0xFFFFU)+LARGESTPRIME-1U;
+	uFactorial += (uAdler1>>16U)+(uAdler2>>16U)+LARGESTPRIME-uRemainder;
+	if (uAdditive>=LARGESTPRIME) {
+		uAdditive -= LARGESTPRIME;
+	}
+	if (uAdditive>=LARGESTPRIME) {
+		uAdditive -= LARGESTPRIME;
+	}
+	if (uFactorial>=(LARGESTPRIME*2U)) {
+		uFactorial -= (LARGESTPRIME*2U);
+	}
+	if (uFactorial>=LARGESTPRIME) {
+		uFactorial -= LARGESTPRIME;
+	}
+	return (uFactorial<<16U)+uAdditive;
+}
@@ -25,6 +25,7 @@
 /* BEGIN */
 namespace Burger {
 extern Word32 BURGER_API CalcAdler32(const void *pInput,WordPtr uInputLength,Word32 uAdler32=1);
+extern Word32 BURGER_API CombineAdler32(Word32 uAdler1,Word32 uAdler2,WordPtr uLength2);
 }
 /* END */
 
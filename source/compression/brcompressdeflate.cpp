@@ -100,6 +100,15 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressDeflate,Burger::Compress);
 #define Z_MEM_ERROR    (-4)
 #define Z_BUF_ERROR    (-5)
 #define Z_VERSION_ERROR (-6)
+
+// SSE2 is always present on processors that have it enabled in the compiler
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(__SSE2__))
+#define DEFLATE_SSE2
+#ifndef __BRVISUALSTUDIO_H__
+#include "brvisualstudio.h"
+#endif
+#include <emmintrin.h>
+#endif
 #endif
 
 /*! ************************************
@@ -287,6 +296,96 @@ const Burger::CompressDeflate::StaticTreeDesc_t Burger::CompressDeflate::g_Stati
 	NULL,g_ExtraBitLengthBits,0,BL_CODES, MAX_BL_BITS
 };
 
+/*! ************************************
+
+	\brief Match finder settings for each compression level
+
+	Levels 1 through 9 are the same as the ones used by zlib, level
+	10 uses the level 9 match finder with the optimal parser.
+
+***************************************/
+
+const Burger::CompressDeflate::Config_t Burger::CompressDeflate::g_Configuration[LEVEL_OPTIMAL+1] = {
+	// good lazy nice chain
+	{ 0,   0,   0,    0,PARSE_STORED},	// 0 Store only
+	{ 4,   4,   8,    4,PARSE_GREEDY},	// 1 Maximum speed, no lazy matches
+	{ 4,   5,  16,    8,PARSE_GREEDY},	// 2
+	{ 4,   6,  32,   32,PARSE_GREEDY},	// 3
+	{ 4,   4,  16,   16,PARSE_LAZY},	// 4 Lazy matches
+	{ 8,  16,  32,   32,PARSE_LAZY},	// 5
+	{ 8,  16, 128,  128,PARSE_LAZY},	// 6
+	{ 8,  32, 128,  256,PARSE_LAZY},	// 7
+	{32, 128, 258, 1024,PARSE_LAZY},	// 8
+	{32, 258, 258, 4096,PARSE_LAZY},	// 9 Maximum lazy compression
+	{32, 258, 258, 4096,PARSE_OPTIMAL}	// 10 Optimal parsing
+};
+
+#if !defined(DOXYGEN)
+
+//
+// Return log2(uInput) in 1/16th units, the fraction is a linear
+// approximation from the four bits below the highest set bit
+//
+
+static Word DeflateLog2(Word32 uInput)
+{
+	Word uBit = 0;
+	while (uInput>>(uBit+1U)) {
+		++uBit;
+	}
+	Word uFraction = (uBit>=4) ? (uInput>>(uBit-4U)) : (uInput<<(4U-uBit));
+	return (uBit<<4U)+(uFraction&15U);
+}
+
+//
+// Convert a frequency into an estimated code length in 1/16th bits
+//
+
+static Word32 DeflateSymbolCost(Word32 uCount,Word uTotalLog2)
+{
+	// Unused symbols are assumed to be a little rarer than the rarest
+	Word uCost = uCount ? (uTotalLog2-DeflateLog2(uCount)) : (uTotalLog2+16U);
+	if (uCost<16U) {
+		uCost = 16U;
+	} else if (uCost>(15U*16U)) {
+		uCost = 15U*16U;
+	}
+	return uCost;
+}
+
+#if defined(DEFLATE_SSE2)
+
+//
+// Return the number of matching bytes (up to MAX_MATCH) using
+// 16 byte compares
+//
+
+static BURGER_INLINE Word DeflateMatchLength(const Word8 *pScan,const Word8 *pMatch)
+{
+	Word uLength = 0;
+	do {
+		__m128i vScan = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pScan+uLength));
+		__m128i vMatch = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pMatch+uLength));
+		Word32 uMask = static_cast<Word32>(_mm_movemask_epi8(_mm_cmpeq_epi8(vScan,vMatch)))^0xFFFFU;
+		if (uMask) {
+			unsigned long uIndex;
+			_BitScanForward(&uIndex,uMask);
+			return uLength+static_cast<Word>(uIndex);
+		}
+		uLength += 16;
+	} while (uLength<256);
+	// The last two bytes of a maximum length match
+	if (pScan[256]!=pMatch[256]) {
+		return 256;
+	}
+	if (pScan[257]!=pMatch[257]) {
+		return 257;
+	}
+	return 258;
+}
+#endif
+#endif
+
 /*! ************************************
 
 	\brief Insert a 16 bit value in the output stream in Big Endian order
@@ -1094,31 +1193,35 @@ void Burger::CompressDeflate::FlushBlock(const Word8 *buf,Word32 stored_len,Word
 
     /* Build the Huffman trees unless a stored block is forced */
 
-	 /* Check if the file is ascii or binary */
-	if (m_eDataType == Z_UNKNOWN) {
-		SetDataType();
-	}
-	/* Construct the literal and distance trees */
-	BuildTree(&m_LiteralDescription);
+	if (m_eParser != PARSE_STORED) {
+		 /* Check if the file is ascii or binary */
+		if (m_eDataType == Z_UNKNOWN) {
+			SetDataType();
+		}
+		/* Construct the literal and distance trees */
+		BuildTree(&m_LiteralDescription);
 
-	BuildTree(&m_DistanceDescription);
-	/* At this point, opt_len and static_len are the total bit lengths of
-	 * the compressed block data, excluding the tree representations.
-	 */
+		BuildTree(&m_DistanceDescription);
+		/* At this point, opt_len and static_len are the total bit lengths of
+		 * the compressed block data, excluding the tree representations.
+		 */
 
-	/* Build the bit length tree for the above two trees, and get the index
-	 * in bl_order of the last bit length code to send.
-	 */
-	max_blindex = BuildBitLengthTree();
+		/* Build the bit length tree for the above two trees, and get the index
+		 * in bl_order of the last bit length code to send.
+		 */
+		max_blindex = BuildBitLengthTree();
 
-	/* Determine the best encoding. Compute first the block length in bytes*/
-	opt_lenb = (m_uOptimalLength+3+7)>>3;
-	static_lenb = (m_uStaticLength+3+7)>>3;
+		/* Determine the best encoding. Compute first the block length in bytes*/
+		opt_lenb = (m_uOptimalLength+3+7)>>3;
+		static_lenb = (m_uStaticLength+3+7)>>3;
 
 
-	if (static_lenb <= opt_lenb) {
-		opt_lenb = static_lenb;
-    }
+		if (static_lenb <= opt_lenb) {
+			opt_lenb = static_lenb;
+		}
+	} else {
+		opt_lenb = static_lenb = stored_len + 5; /* force a stored block */
+	}
 
     if (stored_len+4 <= opt_lenb && buf != NULL) {
                        /* 4: two words for the lengths */
@@ -1182,12 +1285,12 @@ void Burger::CompressDeflate::FlushPending(void)
 
 Word Burger::CompressDeflate::LongestMatch(Word cur_match)
 {
-    unsigned chain_length = c_uMaxChainLength;/* max hash chain length */
+    unsigned chain_length = m_uMaxChainLength;/* max hash chain length */
     Word8 *scan = m_Window + m_uStringStart; /* current string */
     Word8 *match;                       /* matched string */
     int len;                           /* length of current match */
     int best_len = static_cast<int>(m_uPreviousLength);              /* best match length so far */
-    int nice_match = c_iNiceMatch;             /* stop if match long enough */
+    int nice_match = static_cast<int>(m_uNiceMatch);             /* stop if match long enough */
     Word limit = m_uStringStart > (Word)(c_uWSize-MIN_LOOKAHEAD) ?
         m_uStringStart - (Word)(c_uWSize-MIN_LOOKAHEAD) : 0;
     /* Stop when cur_match becomes <= limit. To simplify the code,
@@ -1199,7 +1302,9 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
     /* Compare two bytes at a time. Note: this is not always beneficial.
      * Try with and without -DUNALIGNED_OK to check.
      */
+#if !defined(DEFLATE_SSE2)
     Word8 *strend = m_Window + m_uStringStart + MAX_MATCH - 1;
+#endif
     Word16 scan_start = *(Word16*)scan;
     Word16 scan_end   = *(Word16*)(scan+best_len-1);
 
@@ -1209,7 +1314,7 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
      */
 
     /* Do not waste too much time if we already have a good match: */
-    if (m_uPreviousLength >= c_uGoodMatch) {
+    if (m_uPreviousLength >= m_uGoodMatch) {
         chain_length >>= 2;
     }
     /* Do not look for matches beyond the end of the input. This is necessary
@@ -1230,6 +1335,12 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
         if (*(Word16*)(match+best_len-1) != scan_end ||
             *(Word16*)match != scan_start) continue;
 
+#if defined(DEFLATE_SSE2)
+        /* Compare 16 bytes at a time, the first two bytes are known
+         * to match. Reads stop at strstart+257, same as below.
+         */
+        len = static_cast<int>(DeflateMatchLength(scan,match));
+#else
         /* It is not necessary to compare scan[2] and match[2] since they are
          * always equal when the other bytes match, given that the hash keys
          * are equal and that HASH_BITS >= 8. Compare 2 bytes at a time at
@@ -1253,6 +1364,7 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
 
         len = (MAX_MATCH - 1) - (int)(strend-scan);
         scan = strend - (MAX_MATCH-1);
+#endif
 
 
         if (len > best_len) {
@@ -1268,6 +1380,137 @@ Word Burger::CompressDeflate::LongestMatch(Word cur_match)
     return m_uLookAhead;
 }
 
+/* ===========================================================================
+ * Copy without compression as much as possible from the input stream, return
+ * the current block state.
+ * This function does not insert new strings in the dictionary since
+ * uncompressible data is probably not useful. This function is used
+ * only for the level=0 compression option.
+ */
+Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateStored(int flush)
+{
+    /* Stored blocks are limited to 0xffff bytes, pending_buf is limited
+     * to pending_buf_size, and each stored block has a 5 byte header:
+     */
+    Word max_block_size = 0xffff;
+    if (max_block_size > sizeof(m_PendingBuffer) - 5) {
+        max_block_size = static_cast<Word>(sizeof(m_PendingBuffer) - 5);
+    }
+
+    /* Copy as much as possible from input to output: */
+    for (;;) {
+        /* Fill the window as much as possible: */
+        if (m_uLookAhead <= 1) {
+            FillWindow();
+            if (m_uLookAhead == 0 && flush == Z_NO_FLUSH) return STATE_NEEDMORE;
+
+            if (m_uLookAhead == 0) break; /* flush the current block */
+        }
+        m_uStringStart += m_uLookAhead;
+        m_uLookAhead = 0;
+
+        /* Emit a stored block if pending_buf will be full: */
+        IntPtr max_start = m_iBlockStart + static_cast<IntPtr>(max_block_size);
+        if (static_cast<IntPtr>(m_uStringStart) >= max_start) {
+            /* strstart == 0 is possible when wraparound on 16-bit machine */
+            m_uLookAhead = static_cast<Word>(m_uStringStart - max_start);
+            m_uStringStart = static_cast<Word>(max_start);
+            FlushBlock(0);
+        }
+        /* Flush if we may have to slide, otherwise block_start may become
+         * negative and the data will be gone:
+         */
+        if (m_uStringStart - static_cast<Word>(m_iBlockStart) >= (c_uWSize-MIN_LOOKAHEAD)) {
+            FlushBlock(0);
+        }
+    }
+    FlushBlock(flush == Z_FINISH);
+    return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
+}
+
+/* ===========================================================================
+ * Compress as much as possible from the input stream, return the current
+ * block state.
+ * This function does not perform lazy evaluation of matches and inserts
+ * new strings in the dictionary only for unmatched strings or for short
+ * matches. It is used only for the fast compression options.
+ */
+Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateFast(int flush)
+{
+    Word hash_head = 0; /* head of the hash chain */
+    int bflush;           /* set if current block must be flushed */
+
+    for (;;) {
+        /* Make sure that we always have enough lookahead, except
+         * at the end of the input file. We need MAX_MATCH bytes
+         * for the next match, plus MIN_MATCH bytes to insert the
+         * string following the next match.
+         */
+        if (m_uLookAhead < MIN_LOOKAHEAD) {
+            FillWindow();
+            if (m_uLookAhead < MIN_LOOKAHEAD && flush == Z_NO_FLUSH) {
+                return STATE_NEEDMORE;
+            }
+            if (m_uLookAhead == 0) break; /* flush the current block */
+        }
+
+        /* Insert the string window[strstart .. strstart+2] in the
+         * dictionary, and set hash_head to the head of the hash chain:
+         */
+        if (m_uLookAhead >= MIN_MATCH) {
+            hash_head = InsertString(m_uStringStart);
+        }
+
+        /* Find the longest match, discarding those <= prev_length.
+         * At this point we have always match_length < MIN_MATCH
+         */
+        if (hash_head != 0 && m_uStringStart - hash_head <= (c_uWSize-MIN_LOOKAHEAD)) {
+            /* To simplify the code, we prevent matches with the string
+             * of window index 0 (in particular we have to avoid a match
+             * of the string with itself at the start of the input file).
+             */
+            m_uMatchLength = LongestMatch (hash_head);
+            /* longest_match() sets match_start */
+        }
+        if (m_uMatchLength >= MIN_MATCH) {
+            bflush = static_cast<int>(TallyDistance(m_uStringStart - m_uMatchStart,m_uMatchLength - MIN_MATCH));
+
+            m_uLookAhead -= m_uMatchLength;
+
+            /* Insert new strings in the hash table only if the match length
+             * is not too large. This saves time but degrades compression.
+             */
+            if (m_uMatchLength <= m_uMaxLazyMatch && m_uLookAhead >= MIN_MATCH) {
+                m_uMatchLength--; /* string at strstart already in hash table */
+                do {
+                    m_uStringStart++;
+                    hash_head = InsertString(m_uStringStart);
+                    /* strstart never exceeds WSIZE-MAX_MATCH, so there are
+                     * always MIN_MATCH bytes ahead.
+                     */
+                } while (--m_uMatchLength != 0);
+                m_uStringStart++;
+            } else {
+                m_uStringStart += m_uMatchLength;
+                m_uMatchLength = 0;
+                m_uInsertHash = m_Window[m_uStringStart];
+                m_uInsertHash = UpdateHash(m_uInsertHash,m_Window[m_uStringStart+1]);
+                /* If lookahead < MIN_MATCH, ins_h is garbage, but it does not
+                 * matter since it will be recomputed at next deflate call.
+                 */
+            }
+        } else {
+            /* No match, output a literal byte */
+            bflush = static_cast<int>(TallyLiteral(m_Window[m_uStringStart]));
+            m_uLookAhead--;
+            m_uStringStart++;
+        }
+        if (bflush) FlushBlock(0);
+    }
+    FlushBlock(flush == Z_FINISH);
+    return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
+}
+
 /* ===========================================================================
  * Same as above, but achieves better compression. We use a lazy
  * evaluation for matches: a match is finally adopted only if there is
@@ -1306,7 +1549,7 @@ Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateSlow(int fl
 		m_uPreviousMatch = m_uMatchStart;
         m_uMatchLength = MIN_MATCH-1;
 
-        if (hash_head != 0 && m_uPreviousLength < c_uMaxLazyMatch &&
+        if (hash_head != 0 && m_uPreviousLength < m_uMaxLazyMatch &&
             m_uStringStart - hash_head <= (c_uWSize-MIN_LOOKAHEAD)) {
             /* To simplify the code, we prevent matches with the string
              * of window index 0 (in particular we have to avoid a match
@@ -1381,6 +1624,280 @@ Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateSlow(int fl
 	return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
 }
 
+/*! ************************************
+
+	\brief Set the optimal parser's costs to those of the static trees
+
+	Used for the first run of a stream, before any statistics
+	have been gathered.
+
+***************************************/
+
+void Burger::CompressDeflate::OptimalCostsInit(void)
+{
+	Optimal_t *pOptimal = m_pOptimal;
+	Word i = 0;
+	do {
+		pOptimal->m_LiteralCost[i] = static_cast<Word32>(g_StaticLengthTrees[i].m_DataLength.m_uLength)<<4U;
+	} while (++i<LITERALS);
+	i = MIN_MATCH;
+	do {
+		Word uCode = g_LengthCodes[i-MIN_MATCH];
+		pOptimal->m_LengthCost[i] = (static_cast<Word32>(g_StaticLengthTrees[uCode+LITERALS+1].m_DataLength.m_uLength+g_ExtraLengthBits[uCode]))<<4U;
+	} while (++i<=MAX_MATCH);
+	i = 0;
+	do {
+		pOptimal->m_DistanceCost[i] = static_cast<Word32>(g_StaticDistanceTrees[i].m_DataLength.m_uLength+g_ExtraDistanceBits[i])<<4U;
+	} while (++i<D_CODES);
+}
+
+/*! ************************************
+
+	\brief Update the optimal parser's costs from symbol frequencies
+
+	Convert the frequencies in m_SymbolCount and m_DistanceCount
+	into estimated code lengths, and add in the extra bits.
+
+***************************************/
+
+void Burger::CompressDeflate::OptimalCostsUpdate(void)
+{
+	Optimal_t *pOptimal = m_pOptimal;
+	Word32 uTotal = 0;
+	Word i = 0;
+	do {
+		uTotal += pOptimal->m_SymbolCount[i];
+	} while (++i<L_CODES);
+	Word uTotalLog2 = DeflateLog2(uTotal);
+
+	i = 0;
+	do {
+		pOptimal->m_LiteralCost[i] = DeflateSymbolCost(pOptimal->m_SymbolCount[i],uTotalLog2);
+	} while (++i<LITERALS);
+	i = MIN_MATCH;
+	do {
+		Word uCode = g_LengthCodes[i-MIN_MATCH];
+		pOptimal->m_LengthCost[i] = DeflateSymbolCost(pOptimal->m_SymbolCount[uCode+LITERALS+1],uTotalLog2)+(static_cast<Word32>(g_ExtraLengthBits[uCode])<<4U);
+	} while (++i<=MAX_MATCH);
+
+	// If there were no matches, keep the current distance costs
+	uTotal = 0;
+	i = 0;
+	do {
+		uTotal += pOptimal->m_DistanceCount[i];
+	} while (++i<D_CODES);
+	if (uTotal) {
+		uTotalLog2 = DeflateLog2(uTotal);
+		i = 0;
+		do {
+			pOptimal->m_DistanceCost[i] = DeflateSymbolCost(pOptimal->m_DistanceCount[i],uTotalLog2)+(static_cast<Word32>(g_ExtraDistanceBits[i])<<4U);
+		} while (++i<D_CODES);
+	}
+}
+
+/*! ************************************
+
+	\brief Find the cheapest path through a run of the window
+
+	Using the matches in m_MatchLength and m_MatchDistance for each position
+	starting at m_uStringStart, find the sequence of literals and matches
+	with the lowest estimated cost to reach the end of the run. Any length
+	from MIN_MATCH up to the longest match at a position is considered.
+
+	On exit, m_OptimalLength and m_OptimalDistance hold the
+	last step to reach each position.
+
+	\param uRun Number of bytes in the run
+
+***************************************/
+
+void Burger::CompressDeflate::OptimalParse(Word uRun)
+{
+	Optimal_t *pOptimal = m_pOptimal;
+	Word32 *pCost = pOptimal->m_OptimalCost;
+	pCost[0] = 0;
+	Word i = 1;
+	do {
+		pCost[i] = OPTIMAL_INFINITY;
+	} while (++i<=uRun);
+
+	const Word8 *pInput = m_Window+m_uStringStart;
+	i = 0;
+	do {
+		Word32 uCost = pCost[i];
+
+		// Step with a literal
+		Word32 uNewCost = uCost+pOptimal->m_LiteralCost[pInput[i]];
+		if (uNewCost<pCost[i+1]) {
+			pCost[i+1] = uNewCost;
+			pOptimal->m_OptimalLength[i+1] = 1;
+		}
+
+		// Step with any length of the match found here
+		Word uLength = pOptimal->m_MatchLength[i];
+		if (uLength) {
+			Word uDistance = pOptimal->m_MatchDistance[i];
+			Word uTemp = uDistance-1;
+			uTemp = (uTemp < 256) ? g_DistanceCodes[uTemp] : g_DistanceCodes[256+(uTemp>>7)];
+			uCost += pOptimal->m_DistanceCost[uTemp];
+			Word uStep = MIN_MATCH;
+			do {
+				uNewCost = uCost+pOptimal->m_LengthCost[uStep];
+				if (uNewCost<pCost[i+uStep]) {
+					pCost[i+uStep] = uNewCost;
+					pOptimal->m_OptimalLength[i+uStep] = static_cast<Word16>(uStep);
+					pOptimal->m_OptimalDistance[i+uStep] = static_cast<Word16>(uDistance);
+				}
+			} while (++uStep<=uLength);
+		}
+	} while (++i<uRun);
+}
+
+/*! ************************************
+
+	\brief Compress using optimal parsing
+
+	Instead of deciding on a match one position at a time, the longest match
+	for every position of a run of up to OPTIMAL_RUN bytes is found first.
+	The cheapest path through the run is then found with OptimalParse()
+	using costs estimated from the symbol frequencies. The path is parsed
+	twice, the first path's frequencies are used to refine the costs
+	for the second.
+
+	\param flush Z_NO_FLUSH or Z_FINISH
+	\return State of the current block
+
+***************************************/
+
+Burger::CompressDeflate::eBlockState Burger::CompressDeflate::DeflateOptimal(int flush)
+{
+	Optimal_t *pOptimal = m_pOptimal;
+	for (;;) {
+		// Make sure that we always have enough lookahead, except
+		// at the end of the input file.
+		if (m_uLookAhead < MIN_LOOKAHEAD) {
+			FillWindow();
+			if (m_uLookAhead < MIN_LOOKAHEAD && flush == Z_NO_FLUSH) {
+				return STATE_NEEDMORE;
+			}
+			if (!m_uLookAhead) {
+				break;
+			}
+		}
+
+		// Keep MIN_LOOKAHEAD bytes for every position of the run, except
+		// at the end of the input
+		Word uStart = m_uStringStart;
+		Word uLookAhead = m_uLookAhead;
+		Word uRun = uLookAhead;
+		if ((flush == Z_NO_FLUSH) || m_uInputLength) {
+			uRun -= MIN_LOOKAHEAD-1;
+		}
+		// LongestMatch() can't start past this point in the window
+		Word uLimit = (c_uWindowSize-MIN_LOOKAHEAD+1)-uStart;
+		if (uRun>uLimit) {
+			uRun = uLimit;
+		}
+		if (uRun>OPTIMAL_RUN) {
+			uRun = OPTIMAL_RUN;
+		}
+
+		// Find the longest match for every position
+		m_uPreviousLength = MIN_MATCH-1;
+		Word i = 0;
+		do {
+			m_uStringStart = uStart+i;
+			m_uLookAhead = uLookAhead-i;
+			Word uLength = 0;
+			Word uDistance = 0;
+			if (m_uLookAhead >= MIN_MATCH) {
+				Word uHashHead = InsertString(m_uStringStart);
+				if (uHashHead && ((m_uStringStart-uHashHead) <= (c_uWSize-MIN_LOOKAHEAD))) {
+					uLength = LongestMatch(uHashHead);
+					uDistance = m_uStringStart-m_uMatchStart;
+				}
+			}
+			// Matches can't leave the run
+			if (uLength>(uRun-i)) {
+				uLength = uRun-i;
+			}
+			if (uLength<MIN_MATCH) {
+				uLength = 0;
+			}
+			pOptimal->m_MatchLength[i] = static_cast<Word16>(uLength);
+			pOptimal->m_MatchDistance[i] = static_cast<Word16>(uDistance);
+			++i;
+
+			// A long match is almost certainly the best choice, insert
+			// the strings it covers without searching them
+			if (uLength>=m_uNiceMatch) {
+				while (--uLength) {
+					if ((uLookAhead-i) >= MIN_MATCH) {
+						InsertString(uStart+i);
+					}
+					pOptimal->m_MatchLength[i] = 0;
+					++i;
+				}
+			}
+		} while (i<uRun);
+		m_uStringStart = uStart;
+		m_uLookAhead = uLookAhead;
+
+		// First pass, gather the symbol frequencies of the cheapest path
+		OptimalParse(uRun);
+		MemoryClear(pOptimal->m_SymbolCount,sizeof(pOptimal->m_SymbolCount));
+		MemoryClear(pOptimal->m_DistanceCount,sizeof(pOptimal->m_DistanceCount));
+		pOptimal->m_SymbolCount[END_BLOCK] = 1;
+		i = uRun;
+		do {
+			Word uStep = pOptimal->m_OptimalLength[i];
+			if (uStep==1) {
+				i -= 1;
+				++pOptimal->m_SymbolCount[m_Window[uStart+i]];
+			} else {
+				Word uTemp = pOptimal->m_OptimalDistance[i]-1U;
+				++pOptimal->m_DistanceCount[(uTemp < 256) ? g_DistanceCodes[uTemp] : g_DistanceCodes[256+(uTemp>>7)]];
+				++pOptimal->m_SymbolCount[g_LengthCodes[uStep-MIN_MATCH]+LITERALS+1];
+				i -= uStep;
+			}
+		} while (i);
+
+		// Second pass with the refined costs
+		OptimalCostsUpdate();
+		OptimalParse(uRun);
+
+		// Reverse the path so it can be output from the start
+		i = uRun;
+		do {
+			Word uStep = pOptimal->m_OptimalLength[i];
+			Word uDistance = pOptimal->m_OptimalDistance[i];
+			i -= uStep;
+			pOptimal->m_MatchLength[i] = static_cast<Word16>(uStep);
+			pOptimal->m_MatchDistance[i] = static_cast<Word16>(uDistance);
+		} while (i);
+
+		// Output the path
+		do {
+			Word uStep = pOptimal->m_MatchLength[i];
+			Word bFlush;
+			if (uStep==1) {
+				bFlush = TallyLiteral(m_Window[uStart+i]);
+			} else {
+				bFlush = TallyDistance(pOptimal->m_MatchDistance[i],uStep-MIN_MATCH);
+			}
+			i += uStep;
+			if (bFlush) {
+				m_uStringStart = uStart+i;
+				FlushBlock(0);
+			}
+		} while (i<uRun);
+		m_uStringStart = uStart+uRun;
+		m_uLookAhead = uLookAhead-uRun;
+	}
+	FlushBlock(flush == Z_FINISH);
+	return flush == Z_FINISH ? STATE_FINISHDONE : STATE_BLOCKDONE;
+}
+
 /* ===========================================================================
  * Send one empty static block to give enough lookahead for inflate.
  * This takes 10 bits, of which 7 may remain in the bit buffer.
@@ -1437,6 +1954,73 @@ void Burger::CompressDeflate::LongestMatchInit(void)
 	m_uMatchLength = m_uPreviousLength = MIN_MATCH-1;
 	m_bMatchAvailable = 0;
 	m_uInsertHash = 0;
+
+	// Load the match finder settings for the compression level
+	const Config_t *pConfig = &g_Configuration[m_uLevel];
+	m_uGoodMatch = pConfig->m_uGoodLength;
+	m_uMaxLazyMatch = pConfig->m_uMaxLazy;
+	m_uNiceMatch = pConfig->m_uNiceLength;
+	m_uMaxChainLength = pConfig->m_uMaxChain;
+	m_eParser = static_cast<eParser>(pConfig->m_uParser);
+
+	// The optimal parser's tables are large, so only keep them
+	// around while the optimal parser is in use
+	if (m_eParser == PARSE_OPTIMAL) {
+		if (!m_pOptimal) {
+			m_pOptimal = static_cast<Optimal_t *>(Alloc(sizeof(Optimal_t)));
+		}
+		if (m_pOptimal) {
+			OptimalCostsInit();
+		} else {
+			// Out of memory, fall back to the best lazy matching
+			pConfig = &g_Configuration[LEVEL_BEST];
+			m_uGoodMatch = pConfig->m_uGoodLength;
+			m_uMaxLazyMatch = pConfig->m_uMaxLazy;
+			m_uNiceMatch = pConfig->m_uNiceLength;
+			m_uMaxChainLength = pConfig->m_uMaxChain;
+			m_eParser = static_cast<eParser>(pConfig->m_uParser);
+		}
+	} else if (m_pOptimal) {
+		Free(m_pOptimal);
+		m_pOptimal = NULL;
+	}
+}
+
+/*! ************************************
+
+	\brief Load a preset dictionary
+
+	Copy the last 32K (less MIN_LOOKAHEAD) of the dictionary into the
+	window and insert it into the hash so the following data can
+	be matched against it. Must be called after DeflateReset() and
+	before any data is compressed.
+
+	\param pDictionary Pointer to the dictionary
+	\param uDictionaryLength Number of bytes in the dictionary
+
+***************************************/
+
+void Burger::CompressDeflate::SetDictionary(const Word8 *pDictionary,WordPtr uDictionaryLength)
+{
+	if (uDictionaryLength >= MIN_MATCH) {
+		m_uAdler = CalcAdler32(pDictionary,uDictionaryLength,m_uAdler);
+
+		// Only the end of the dictionary can be reached by a match
+		Word uLength = c_uWSize-MIN_LOOKAHEAD;
+		if (uDictionaryLength < uLength) {
+			uLength = static_cast<Word>(uDictionaryLength);
+		}
+		pDictionary += uDictionaryLength-uLength;
+		MemoryCopy(m_Window,pDictionary,uLength);
+		m_uStringStart = uLength;
+		m_iBlockStart = static_cast<IntPtr>(uLength);
+
+		m_uInsertHash = UpdateHash(m_Window[0],m_Window[1]);
+		Word i = 0;
+		do {
+			InsertString(i);
+		} while (++i <= (uLength-MIN_MATCH));
+	}
 }
 
 /* ========================================================================= */
@@ -1534,13 +2118,7 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 	/* Write the zlib header */
 	if (m_eState == INIT_STATE) {
 
-		Word header = (Z_DEFLATED + ((c_uWBits-8)<<4)) << 8;
-		Word level_flags = (Z_BEST_COMPRESSION-1) >> 1;
-
-		if (level_flags > 3) level_flags = 3;
-		header |= (level_flags << 6);
-		if (m_uStringStart != 0) header |= PRESET_DICT;
-		header += 31 - (header % 31);
+		Word header = GetHeader(m_uLevel,m_uStringStart != 0);
 
 		m_eState = BUSY_STATE;
 		OutputBigEndian16(header);
@@ -1577,7 +2155,20 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 		(flush != Z_NO_FLUSH && m_eState != FINISH_STATE)) {
 		eBlockState bstate;
 
-		bstate = DeflateSlow(flush);
+		switch (m_eParser) {
+		case PARSE_STORED:
+			bstate = DeflateStored(flush);
+			break;
+		case PARSE_GREEDY:
+			bstate = DeflateFast(flush);
+			break;
+		case PARSE_OPTIMAL:
+			bstate = DeflateOptimal(flush);
+			break;
+		default:
+			bstate = DeflateSlow(flush);
+			break;
+		}
 
 		if (bstate == STATE_FINISHSTARTED || bstate == STATE_FINISHDONE) {
 			m_eState = FINISH_STATE;
@@ -1632,11 +2223,24 @@ int Burger::CompressDeflate::PerformDeflate(int flush)
 
 Burger::CompressDeflate::CompressDeflate() :
 	Compress(),
-	m_bInitialized(FALSE)
+	m_pOptimal(NULL),
+	m_bInitialized(FALSE),
+	m_uLevel(LEVEL_DEFAULT)
 {
 	m_uSignature = Signature;
 }
 
+/*! ************************************
+
+	\brief Release the optimal parser's tables
+
+***************************************/
+
+Burger::CompressDeflate::~CompressDeflate()
+{
+	Free(m_pOptimal);
+}
+
 /*! ************************************
 
 	\brief Reset the RLE compressor
@@ -1654,6 +2258,133 @@ Burger::Compress::eError Burger::CompressDeflate::Init(void)
 	return Compress::COMPRESS_OUTOFMEMORY;
 }
 
+/*! ************************************
+
+	\brief Compress a block of raw deflate data
+
+	Compress the input as a complete piece of a deflate stream without
+	the zlib header or Adler-32 trailer. Unless it's the last block, the
+	data ends with an empty stored block so the output is a whole number
+	of bytes and can be followed by the output of another call. The
+	output replaces the contents of GetOutput().
+
+	If a dictionary is supplied, the input can contain matches to the
+	last 32K of the dictionary. This is used to split a large buffer into
+	blocks compressed on separate threads that decompress as a single
+	stream, where the dictionary is the data that precedes the block.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes of data to compress
+	\param pDictionary Pointer to the data that precedes the input or \ref NULL
+	\param uDictionaryLength Number of bytes of the dictionary
+	\param bLast \ref TRUE if this is the final block of the stream
+	\return Zero if no error, non-zero on error
+	\sa GetHeader(Word,Word)
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflate::ProcessBlock(const void *pInput,WordPtr uInputLength,const void *pDictionary,WordPtr uDictionaryLength,Word bLast)
+{
+	m_Output.Clear();
+	if (DeflateInit()!=Z_OK) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	// Raw deflate data, no header or trailer
+	m_bNoHeader = 1;
+	DeflateReset();
+	if (pDictionary) {
+		SetDictionary(static_cast<const Word8 *>(pDictionary),uDictionaryLength);
+	}
+	m_pInput = static_cast<const Word8 *>(pInput);
+	m_uInputLength = uInputLength;
+	int err = PerformDeflate(bLast ? Z_FINISH : Z_SYNC_FLUSH);
+	DeflateEnd();
+	if (err!=Z_OK && err!=Z_STREAM_END) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Return the zlib stream header for a compression level
+
+	The two byte header is stored in big endian order at the start of a
+	zlib stream.
+
+	\param uLevel Compression level from \ref LEVEL_STORED to \ref LEVEL_OPTIMAL
+	\param bDictionary \ref TRUE if the stream uses a preset dictionary
+	\return 16 bit zlib stream header
+	\sa ProcessBlock(const void *,WordPtr,const void *,WordPtr,Word)
+
+***************************************/
+
+Word Burger::CompressDeflate::GetHeader(Word uLevel,Word bDictionary)
+{
+	Word uHeader = (Z_DEFLATED + ((c_uWBits-8)<<4)) << 8;
+	Word uLevelFlags;
+	if (uLevel < 2) {
+		uLevelFlags = 0;
+	} else if (uLevel < 6) {
+		uLevelFlags = 1;
+	} else if (uLevel == 6) {
+		uLevelFlags = 2;
+	} else {
+		uLevelFlags = 3;
+	}
+	uHeader |= (uLevelFlags << 6);
+	if (bDictionary) {
+		uHeader |= PRESET_DICT;
+	}
+	// Make the header a multiple of 31
+	uHeader += 31 - (uHeader % 31);
+	return uHeader;
+}
+
+/*! ************************************
+
+	\brief Set the compression level
+
+	Select how much time is spent finding matches. Level 0 stores the data
+	without compression, levels 1 through 3 use greedy matching, levels 4
+	through 9 use lazy matching with longer hash chain searches as the
+	level increases and level 10 uses optimal parsing. All levels create
+	a standard zlib stream.
+
+	The level takes effect when a new stream is started, which is either
+	the first call to Process() after Init() or Finalize(), or immediately
+	if no data has been compressed since the last Init().
+
+	The tables used by level 10 are only allocated while it's selected.
+	If they can't be allocated, level 9 is used instead.
+
+	\param uLevel Compression level from \ref LEVEL_STORED to \ref LEVEL_OPTIMAL, values above are clamped
+	\sa GetLevel(void) const
+
+***************************************/
+
+void Burger::CompressDeflate::SetLevel(Word uLevel)
+{
+	if (uLevel>LEVEL_OPTIMAL) {
+		uLevel = LEVEL_OPTIMAL;
+	}
+	m_uLevel = uLevel;
+	// Nothing has been compressed, so the new settings can be used now
+	if (m_bInitialized && (m_eState == INIT_STATE) && !m_uStringStart && !m_uLookAhead) {
+		LongestMatchInit();
+	}
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressDeflate::GetLevel(void) const
+	\brief Return the compression level
+
+	\return Compression level from \ref LEVEL_STORED to \ref LEVEL_OPTIMAL
+	\sa SetLevel(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Compress the input data using RLE
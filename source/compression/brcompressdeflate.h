@@ -55,6 +55,13 @@ protected:
 		Z_UNKNOWN=2			///< Unknown data
 	};
 
+	enum eParser {
+		PARSE_STORED,		///< Store the data without compression
+		PARSE_GREEDY,		///< Take the longest match at each position
+		PARSE_LAZY,			///< Take a match only if the next position doesn't have a longer one
+		PARSE_OPTIMAL		///< Choose the cheapest path through all matches of a run
+	};
+
 	enum eStreamTreeType {
 		STORED_BLOCK=0,		///< Uncompressed data
 		STATIC_TREES=1,		///< Compressed with the static tree
@@ -84,7 +91,30 @@ protected:
 		END_BLOCK=256,			///< End of block literal code
 		REP_3_6=16,				///< Repeat previous bit length 3-6 times (2 bits of repeat count)
 		REPZ_3_10=17,			///< Repeat a zero length 3-10 times  (3 bits of repeat count)
-		REPZ_11_138=18			///< Repeat a zero length 11-138 times  (7 bits of repeat count)
+		REPZ_11_138=18,			///< Repeat a zero length 11-138 times  (7 bits of repeat count)
+		OPTIMAL_RUN=4096,		///< Maximum number of bytes parsed at once by DeflateOptimal()
+		OPTIMAL_INFINITY=0x7FFFFFFF	///< Cost of a position that hasn't been reached by DeflateOptimal()
+	};
+
+	struct Config_t {
+		Word16 m_uGoodLength;	///< Reduce lazy search above this match length
+		Word16 m_uMaxLazy;		///< Do not perform lazy search above this match length, for greedy, do not insert strings into the hash above this length
+		Word16 m_uNiceLength;	///< Quit search above this match length
+		Word16 m_uMaxChain;		///< Maximum number of hash chain entries to search
+		Word16 m_uParser;		///< eParser value of the parser to use
+	};
+
+	struct Optimal_t {
+		Word32 m_OptimalCost[OPTIMAL_RUN+1];		///< Cheapest cost in 1/16th bits to reach each position of the run
+		Word16 m_OptimalLength[OPTIMAL_RUN+1];		///< Length of the cheapest step that reaches each position (1 for a literal)
+		Word16 m_OptimalDistance[OPTIMAL_RUN+1];	///< Distance of the cheapest step that reaches each position
+		Word16 m_MatchLength[OPTIMAL_RUN];			///< Longest match found at each position of the run, reused as the forward path
+		Word16 m_MatchDistance[OPTIMAL_RUN];		///< Distance of the longest match at each position of the run
+		Word32 m_LiteralCost[LITERALS];				///< Estimated cost in 1/16th bits of each literal
+		Word32 m_LengthCost[MAX_MATCH+1];			///< Estimated cost in 1/16th bits of each match length, including extra bits
+		Word32 m_DistanceCost[D_CODES];				///< Estimated cost in 1/16th bits of each distance code, including extra bits
+		Word32 m_SymbolCount[L_CODES];				///< Literal/length symbol frequencies of the last parse
+		Word32 m_DistanceCount[D_CODES];			///< Distance symbol frequencies of the last parse
 	};
 
 	struct CodeData_t {
@@ -122,13 +152,10 @@ protected:
 	static const Word c_uHashShift = ((c_uHashBits+MIN_MATCH-1)/MIN_MATCH);		///< Number of bits by which m_uInsertHash must be shifted at each input step. It must be such that after MIN_MATCH steps, the oldest byte no longer takes part in the hash key, that is: hash_shift * MIN_MATCH >= hash_bits
 	static const Word c_uLiteralBufferSize = 1 << (MAX_MEM_LEVEL + 6);	///< 16K elements by default
 	static const Word c_uWindowSize = 2*c_uWSize;		///< Actual size of window: 2*wSize, except when the user input buffer is directly used as sliding window.
-	static const Word c_uMaxLazyMatch = 258;	///< Attempt to find a better match only when the current match is strictly smaller than this value. This mechanism is used only for compression levels >= 4.
-	static const Word c_uGoodMatch = 32;
-	static const int c_iNiceMatch = 258;		///< Stop searching when current match exceeds this
-	static const Word c_uMaxChainLength = 4096;	///< To speed up deflation, hash chains are never searched beyond this length.  A higher limit improves compression ratio but degrades the speed.
 
 	const Word8 *m_pInput;		///< Next input byte
 	Word8 *m_pPendingOutput;	///< Next pending byte to output to the stream
+	Optimal_t *m_pOptimal;		///< State for the optimal parser, only allocated for \ref LEVEL_OPTIMAL
 	WordPtr m_uInputLength;		///< Number of bytes available at next_in
 	IntPtr m_iBlockStart;		///< Window position at the beginning of the current output block. Gets negative when the window is moved backwards.
 	Word32 m_uAdler;			///< Adler32 value of the uncompressed data
@@ -148,6 +175,12 @@ protected:
 	Word m_uBitIndexValid;		///< Number of bits in the output buffer
 	Word m_bInitialized;		///< \ref TRUE if initialized
 	Word m_uLastEOBLength;		///< bit length of EOB code for last block
+	Word m_uLevel;				///< Compression level for the next stream
+	Word m_uMaxLazyMatch;		///< Attempt to find a better match only when the current match is strictly smaller than this value. For greedy parsing, the longest match whose strings are inserted in the hash.
+	Word m_uGoodMatch;			///< Use a quarter of the chain length when the previous match is at least this long
+	Word m_uNiceMatch;			///< Stop searching when current match exceeds this
+	Word m_uMaxChainLength;		///< To speed up deflation, hash chains are never searched beyond this length. A higher limit improves compression ratio but degrades the speed.
+	eParser m_eParser;			///< Parser for the current stream
 	int m_iPending;				///< Number of bytes in the pending buffer
 	int m_bNoHeader;			///< Suppress zlib header and adler32
 	int m_iLastFlush;			///< Value of flush param for previous deflate call
@@ -170,7 +203,7 @@ protected:
 	Word16 m_BitLengthCount[MAX_BITS+1];		///< MAX_BITS = 15, so this is long aligned
 	Word16 m_DataBuffer[c_uLiteralBufferSize];		///< Buffer for distances. To simplify the code, d_buf and l_buf have the same number of elements. To use different lengths, an extra flag array would be necessary.
 	Word8 m_LiteralBuffer[c_uLiteralBufferSize];	///< buffer for literals or lengths
-	Word8 m_PendingBuffer[c_uLiteralBufferSize];	///< Output still pending
+	Word8 m_PendingBuffer[c_uLiteralBufferSize*4];	///< Output still pending, large enough for a full literal buffer of the longest codes
 	Word8 m_Depth[2*L_CODES+1];					///< Depth of each subtree used as tie breaker for trees of equal frequency
 	Word8 m_Window[c_uWSize*2];					///< Sliding window. Input bytes are read into the second half of the window, and move to the first half later to keep a dictionary of at least wSize bytes. With this organization, matches are limited to a distance of wSize-MAX_MATCH bytes, but this ensures that IO is always performed with a length multiple of the block size. 
 
@@ -296,10 +329,17 @@ protected:
 	void FlushBlock(const Word8 *buf,Word32 stored_len,Word bEOF);
 	void FlushPending(void);
 	Word LongestMatch(Word cur_match);
+	eBlockState DeflateStored(int flush);
+	eBlockState DeflateFast(int flush);
 	eBlockState DeflateSlow(int flush);
+	void OptimalCostsInit(void);
+	void OptimalCostsUpdate(void);
+	void OptimalParse(Word uRun);
+	eBlockState DeflateOptimal(int flush);
 	void Align(void);
 	int DeflateEnd(void);
 	void LongestMatchInit(void);
+	void SetDictionary(const Word8 *pDictionary,WordPtr uDictionaryLength);
 	int DeflateReset(void);
 	int DeflateInit(void);
 	int PerformDeflate(int flush);
@@ -317,12 +357,26 @@ protected:
 	static const StaticTreeDesc_t g_StaticBitLengthDescription;
 	static const Word8 g_DistanceCodes[DIST_CODE_LEN];
 	static const Word8 g_LengthCodes[MAX_MATCH-MIN_MATCH+1];
+	static const Config_t g_Configuration[];
 public:
+	enum {
+		LEVEL_STORED=0,		///< No compression, data is saved in stored blocks
+		LEVEL_FASTEST=1,	///< Fastest compression with greedy matching
+		LEVEL_LAZY=4,		///< Fastest compression with lazy matching
+		LEVEL_BEST=9,		///< Best lazy matching compression (Default)
+		LEVEL_OPTIMAL=10,	///< Optimal parsing, slowest but smallest output
+		LEVEL_DEFAULT=LEVEL_BEST	///< Level used if SetLevel() is never called
+	};
 	static const Word32 Signature = 0x5A4C4942;		///< 'ZLIB'
 	CompressDeflate(void);
+	virtual ~CompressDeflate();
 	virtual eError Init(void);
 	virtual eError Process(const void *pInput,WordPtr uInputLength);
 	virtual eError Finalize(void);
+	eError ProcessBlock(const void *pInput,WordPtr uInputLength,const void *pDictionary=NULL,WordPtr uDictionaryLength=0,Word bLast=FALSE);
+	void SetLevel(Word uLevel);
+	BURGER_INLINE Word GetLevel(void) const { return m_uLevel; }
+	static Word GetHeader(Word uLevel,Word bDictionary=FALSE);
 };
 }
 /* END */
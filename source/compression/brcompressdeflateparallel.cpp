@@ -0,0 +1,505 @@
+/***************************************
+
+	Compress using Deflate on multiple threads
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcompressdeflateparallel.h"
+#include "bradler32.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressDeflateParallel,Burger::Compress);
+#endif
+
+/*! ************************************
+
+	\class Burger::CompressDeflateParallel
+	\brief Compress data using Deflate on multiple threads
+
+	The input is split into blocks that are compressed at the same
+	time by the threads of a JobScheduler. Each block is compressed
+	with CompressDeflate::ProcessBlock() as raw deflate data that ends
+	on a byte boundary, and the blocks are joined in order into a
+	single zlib stream that can be decompressed by DecompressDeflate
+	or any zlib compatible decoder.
+
+	Since the blocks can't share a hash table, the last 32K of
+	data before each block is used as a preset dictionary so matches can
+	still cross block boundaries. This can be disabled with
+	SetUseDictionary() so each block is fully independent.
+
+	Data passed to Process() is buffered until enough blocks are
+	available for every thread, so memory use doesn't depend on
+	the size of the input.
+
+	\sa Burger::CompressDeflate or Burger::DecompressDeflate
+
+***************************************/
+
+/*! ************************************
+
+	\brief Compress a range of blocks
+
+	Called by JobScheduler::ParallelFor() on any thread. Each thread
+	uses the CompressDeflate instance for its slot and stores the
+	compressed data in the block's record.
+
+	\param pData Pointer to the CompressDeflateParallel
+	\param uStart Index of the first block to compress
+	\param uEnd Index past the last block to compress
+	\param uSlot Thread slot making the call
+
+***************************************/
+
+void BURGER_API Burger::CompressDeflateParallel::CompressBlocks(void *pData,WordPtr uStart,WordPtr uEnd,Word uSlot)
+{
+	CompressDeflateParallel *pThis = static_cast<CompressDeflateParallel *>(pData);
+	CompressDeflate *pCompress = pThis->m_ppCompressors[uSlot];
+	do {
+		Block_t *pBlock = &pThis->m_pBlocks[uStart];
+		WordPtr uOffset = pThis->m_uDictionaryLength+(uStart*pThis->m_uBlockSize);
+		WordPtr uLength = pThis->m_uBufferLength-uOffset;
+		if (uLength>pThis->m_uBlockSize) {
+			uLength = pThis->m_uBlockSize;
+		}
+		const Word8 *pInput = pThis->m_pBuffer+uOffset;
+
+		// The data before this block is the dictionary
+		const Word8 *pDictionary = NULL;
+		WordPtr uDictionaryLength = 0;
+		if (pThis->m_bUseDictionary && uOffset) {
+			uDictionaryLength = uOffset;
+			if (uDictionaryLength>DICTIONARY_SIZE) {
+				uDictionaryLength = DICTIONARY_SIZE;
+			}
+			pDictionary = pInput-uDictionaryLength;
+		}
+
+		Word bLast = pThis->m_bLastBatch && ((uStart+1)==pThis->m_uBlockCount);
+		pBlock->m_eError = pCompress->ProcessBlock(pInput,uLength,pDictionary,uDictionaryLength,bLast);
+		pBlock->m_uAdler = CalcAdler32(pInput,uLength);
+
+		// Keep the output since the compressor will be reused
+		WordPtr uPackedSize = pCompress->GetOutputSize();
+		if (uPackedSize>pBlock->m_uBufferSize) {
+			Free(pBlock->m_pData);
+			pBlock->m_pData = static_cast<Word8 *>(Alloc(uPackedSize));
+			if (!pBlock->m_pData) {
+				pBlock->m_uBufferSize = 0;
+				pBlock->m_uLength = 0;
+				pBlock->m_eError = COMPRESS_OUTOFMEMORY;
+				continue;
+			}
+			pBlock->m_uBufferSize = uPackedSize;
+		}
+		pCompress->GetOutput()->Flatten(pBlock->m_pData,uPackedSize);
+		pBlock->m_uLength = uPackedSize;
+	} while (++uStart<uEnd);
+}
+
+/*! ************************************
+
+	\brief Allocate the buffers and compressors
+
+	Create the job scheduler if needed, a CompressDeflate for
+	every thread and the input buffer for a batch of blocks.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflateParallel::Allocate(void)
+{
+	if (!m_pScheduler) {
+		m_pOwnedScheduler = New<JobScheduler>();
+		if (!m_pOwnedScheduler) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+		m_pScheduler = m_pOwnedScheduler;
+	}
+	Word uSlotCount = m_pScheduler->GetSlotCount();
+	m_uSlotCount = uSlotCount;
+	m_ppCompressors = static_cast<CompressDeflate **>(AllocClear(sizeof(CompressDeflate *)*uSlotCount));
+	Word uBatchCount = uSlotCount*BLOCKSPERSLOT;
+	m_uBatchCount = uBatchCount;
+	m_pBlocks = static_cast<Block_t *>(AllocClear(sizeof(Block_t)*uBatchCount));
+	m_uBufferSize = DICTIONARY_SIZE+(m_uBlockSize*uBatchCount);
+	m_pBuffer = static_cast<Word8 *>(Alloc(m_uBufferSize));
+	if (!m_ppCompressors || !m_pBlocks || !m_pBuffer) {
+		Release();
+		return COMPRESS_OUTOFMEMORY;
+	}
+	Word i = 0;
+	do {
+		CompressDeflate *pCompress = New<CompressDeflate>();
+		if (!pCompress) {
+			Release();
+			return COMPRESS_OUTOFMEMORY;
+		}
+		pCompress->SetLevel(m_uLevel);
+		m_ppCompressors[i] = pCompress;
+	} while (++i<uSlotCount);
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Release the buffers and compressors
+
+	Dispose of everything allocated by Allocate(). The job scheduler
+	is only disposed of if it was created by this class.
+
+***************************************/
+
+void Burger::CompressDeflateParallel::Release(void)
+{
+	if (m_ppCompressors) {
+		Word i = 0;
+		do {
+			Delete(m_ppCompressors[i]);
+		} while (++i<m_uSlotCount);
+		Free(m_ppCompressors);
+		m_ppCompressors = NULL;
+	}
+	if (m_pBlocks) {
+		Word i = 0;
+		do {
+			Free(m_pBlocks[i].m_pData);
+		} while (++i<m_uBatchCount);
+		Free(m_pBlocks);
+		m_pBlocks = NULL;
+	}
+	Free(m_pBuffer);
+	m_pBuffer = NULL;
+	m_uBufferSize = 0;
+	m_uBufferLength = 0;
+	m_uDictionaryLength = 0;
+	m_uSlotCount = 0;
+	m_uBatchCount = 0;
+	if (m_pOwnedScheduler) {
+		Delete(m_pOwnedScheduler);
+		m_pOwnedScheduler = NULL;
+		m_pScheduler = NULL;
+	}
+}
+
+/*! ************************************
+
+	\brief Compress the buffered data
+
+	Compress every block in the input buffer in parallel and append them
+	to the output. If this isn't the end of the stream, the end of the
+	data is kept as the dictionary for the next batch.
+
+	\param bLast \ref TRUE if the stream ends with this batch
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflateParallel::CompressBatch(Word bLast)
+{
+	// Output the zlib header at the start of the stream
+	if (!m_bHeaderSent) {
+		Word uHeader = CompressDeflate::GetHeader(m_uLevel);
+		m_Output.Append(static_cast<Word8>(uHeader>>8U));
+		m_Output.Append(static_cast<Word8>(uHeader));
+		m_bHeaderSent = TRUE;
+	}
+
+	// An empty final batch is a single empty block
+	WordPtr uDataLength = m_uBufferLength-m_uDictionaryLength;
+	Word uBlockCount = static_cast<Word>((uDataLength+(m_uBlockSize-1))/m_uBlockSize);
+	if (!uBlockCount) {
+		uBlockCount = 1;
+	}
+	m_uBlockCount = uBlockCount;
+	m_bLastBatch = bLast;
+	m_pScheduler->ParallelFor(uBlockCount,CompressBlocks,this,1);
+
+	// Join the blocks in order
+	eError Error = COMPRESS_OKAY;
+	WordPtr uRemaining = uDataLength;
+	const Block_t *pBlock = m_pBlocks;
+	do {
+		if (pBlock->m_eError!=COMPRESS_OKAY) {
+			Error = pBlock->m_eError;
+		}
+		m_Output.Append(pBlock->m_pData,pBlock->m_uLength);
+		WordPtr uLength = uRemaining;
+		if (uLength>m_uBlockSize) {
+			uLength = m_uBlockSize;
+		}
+		uRemaining -= uLength;
+		m_uAdler = CombineAdler32(m_uAdler,pBlock->m_uAdler,uLength);
+		++pBlock;
+	} while (--uBlockCount);
+
+	if (bLast) {
+		// Output the Adler-32 in big endian order and reset for a new stream
+		m_Output.Append(static_cast<Word8>(m_uAdler>>24U));
+		m_Output.Append(static_cast<Word8>(m_uAdler>>16U));
+		m_Output.Append(static_cast<Word8>(m_uAdler>>8U));
+		m_Output.Append(static_cast<Word8>(m_uAdler));
+		m_uAdler = 1;
+		m_bHeaderSent = FALSE;
+		m_uBufferLength = 0;
+		m_uDictionaryLength = 0;
+	} else {
+		// Keep the end of the data for the next batch's dictionary
+		WordPtr uKeep = 0;
+		if (m_bUseDictionary) {
+			uKeep = m_uBufferLength;
+			if (uKeep>DICTIONARY_SIZE) {
+				uKeep = DICTIONARY_SIZE;
+			}
+			MemoryMove(m_pBuffer,m_pBuffer+(m_uBufferLength-uKeep),uKeep);
+		}
+		m_uBufferLength = uKeep;
+		m_uDictionaryLength = uKeep;
+	}
+	return Error;
+}
+
+/*! ************************************
+
+	\brief Default constructor
+
+	If a JobScheduler isn't supplied, one with a worker thread
+	for every CPU is created when data is first compressed.
+
+	\param pScheduler Pointer to the JobScheduler to use or \ref NULL to create one
+
+***************************************/
+
+Burger::CompressDeflateParallel::CompressDeflateParallel(JobScheduler *pScheduler) :
+	Compress(),
+	m_pScheduler(pScheduler),
+	m_pOwnedScheduler(NULL),
+	m_ppCompressors(NULL),
+	m_pBlocks(NULL),
+	m_pBuffer(NULL),
+	m_uBufferSize(0),
+	m_uBufferLength(0),
+	m_uDictionaryLength(0),
+	m_uBlockSize(DEFAULT_BLOCKSIZE),
+	m_uSlotCount(0),
+	m_uBatchCount(0),
+	m_uBlockCount(0),
+	m_uLevel(CompressDeflate::LEVEL_DEFAULT),
+	m_bUseDictionary(TRUE),
+	m_bLastBatch(FALSE),
+	m_bHeaderSent(FALSE),
+	m_uAdler(1)
+{
+	m_uSignature = Signature;
+}
+
+/*! ************************************
+
+	\brief Destructor
+
+	Releases the compressors and buffers
+
+***************************************/
+
+Burger::CompressDeflateParallel::~CompressDeflateParallel()
+{
+	Release();
+}
+
+/*! ************************************
+
+	\brief Reset the compressor
+
+	Discard the output and any buffered data. The compressors
+	and buffers are released so changes to the block size take effect.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflateParallel::Init(void)
+{
+	m_Output.Clear();
+	Release();
+	m_uAdler = 1;
+	m_bHeaderSent = FALSE;
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Compress the input data using Deflate
+
+	Buffer the data and when there is enough for a full block
+	on every thread, compress it.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes to compress
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflateParallel::Process(const void *pInput,WordPtr uInputLength)
+{
+	eError Error = COMPRESS_OKAY;
+	if (uInputLength) {
+		if (!m_pBuffer) {
+			Error = Allocate();
+		}
+		while ((Error==COMPRESS_OKAY) && uInputLength) {
+			// Only compress a full batch when there is more data, so
+			// Finalize() always has a block to mark as the last one
+			WordPtr uBatchSize = m_uBlockSize*m_uBatchCount;
+			WordPtr uSpace = (m_uDictionaryLength+uBatchSize)-m_uBufferLength;
+			if (!uSpace) {
+				Error = CompressBatch(FALSE);
+				if (Error!=COMPRESS_OKAY) {
+					break;
+				}
+				uSpace = uBatchSize;
+			}
+			if (uSpace>uInputLength) {
+				uSpace = uInputLength;
+			}
+			MemoryCopy(m_pBuffer+m_uBufferLength,pInput,uSpace);
+			m_uBufferLength += uSpace;
+			pInput = static_cast<const Word8 *>(pInput)+uSpace;
+			uInputLength -= uSpace;
+		}
+	}
+	return Error;
+}
+
+/*! ************************************
+
+	\brief Finalize Deflate compression
+
+	Compress the buffered data as the end of the stream
+	and append the Adler-32 checksum.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressDeflateParallel::Finalize(void)
+{
+	eError Error = COMPRESS_OKAY;
+	if (!m_pBuffer) {
+		Error = Allocate();
+	}
+	if (Error==COMPRESS_OKAY) {
+		Error = CompressBatch(TRUE);
+	}
+	return Error;
+}
+
+/*! ************************************
+
+	\brief Set the compression level
+
+	The level is passed to every CompressDeflate instance. See
+	CompressDeflate::SetLevel(Word) for a description of the levels.
+
+	\param uLevel Compression level from \ref CompressDeflate::LEVEL_STORED to \ref CompressDeflate::LEVEL_OPTIMAL, values above are clamped
+	\sa GetLevel(void) const
+
+***************************************/
+
+void Burger::CompressDeflateParallel::SetLevel(Word uLevel)
+{
+	if (uLevel>CompressDeflate::LEVEL_OPTIMAL) {
+		uLevel = CompressDeflate::LEVEL_OPTIMAL;
+	}
+	m_uLevel = uLevel;
+	if (m_ppCompressors) {
+		Word i = 0;
+		do {
+			m_ppCompressors[i]->SetLevel(uLevel);
+		} while (++i<m_uSlotCount);
+	}
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressDeflateParallel::GetLevel(void) const
+	\brief Return the compression level
+
+	\return Compression level from \ref CompressDeflate::LEVEL_STORED to \ref CompressDeflate::LEVEL_OPTIMAL
+	\sa SetLevel(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Set the size of each block
+
+	Larger blocks compress slightly better, but need more data before all
+	of the threads are busy. If data is being compressed, the new size
+	takes effect after the next call to Init().
+
+	\param uBlockSize Number of bytes compressed by each job, clamped to \ref MIN_BLOCKSIZE
+	\sa GetBlockSize(void) const
+
+***************************************/
+
+void Burger::CompressDeflateParallel::SetBlockSize(WordPtr uBlockSize)
+{
+	if (uBlockSize<MIN_BLOCKSIZE) {
+		uBlockSize = MIN_BLOCKSIZE;
+	}
+	m_uBlockSize = uBlockSize;
+}
+
+/*! ************************************
+
+	\fn WordPtr Burger::CompressDeflateParallel::GetBlockSize(void) const
+	\brief Return the size of each block
+
+	\return Number of bytes compressed by each job
+	\sa SetBlockSize(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::CompressDeflateParallel::SetUseDictionary(Word bUseDictionary)
+	\brief Enable the use of preset dictionaries
+
+	If enabled (The default), each block can match the 32K of
+	data before it, which improves compression. If disabled, the
+	blocks are independent.
+
+	\param bUseDictionary \ref TRUE to use the previous data as a dictionary
+	\sa GetUseDictionary(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::CompressDeflateParallel::GetUseDictionary(void) const
+	\brief Return \ref TRUE if preset dictionaries are used
+
+	\return \ref TRUE if each block can match the data before it
+	\sa SetUseDictionary(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::CompressDeflateParallel::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
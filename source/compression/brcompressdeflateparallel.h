@@ -0,0 +1,92 @@
+/***************************************
+
+	Compress using Deflate on multiple threads
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRCOMPRESSDEFLATEPARALLEL_H__
+#define __BRCOMPRESSDEFLATEPARALLEL_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRCOMPRESS_H__
+#include "brcompress.h"
+#endif
+
+#ifndef __BRCOMPRESSDEFLATE_H__
+#include "brcompressdeflate.h"
+#endif
+
+#ifndef __BRJOBSCHEDULER_H__
+#include "brjobscheduler.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class CompressDeflateParallel : public Compress {
+	BURGER_DISABLECOPYCONSTRUCTORS(CompressDeflateParallel);
+	BURGER_RTTI_IN_CLASS();
+public:
+	enum {
+		DEFAULT_BLOCKSIZE=0x20000,	///< Default number of bytes compressed by each job
+		MIN_BLOCKSIZE=0x1000,		///< Smallest block size allowed
+		DICTIONARY_SIZE=0x8000,		///< Bytes of the previous block used as a preset dictionary
+		BLOCKSPERSLOT=4				///< Number of blocks queued for each thread at a time
+	};
+protected:
+	struct Block_t {
+		Word8 *m_pData;				///< Compressed data
+		WordPtr m_uLength;			///< Number of bytes of compressed data
+		WordPtr m_uBufferSize;		///< Allocated size of m_pData
+		Word32 m_uAdler;			///< Adler-32 of the uncompressed data
+		eError m_eError;			///< Result of compression
+	};
+	JobScheduler *m_pScheduler;		///< Scheduler used for compression
+	JobScheduler *m_pOwnedScheduler;	///< Scheduler created by this class if one wasn't supplied
+	CompressDeflate **m_ppCompressors;	///< Compressor for each thread slot
+	Block_t *m_pBlocks;				///< Output of each block of a batch
+	Word8 *m_pBuffer;				///< Input buffer, starting with the dictionary
+	WordPtr m_uBufferSize;			///< Size of m_pBuffer in bytes
+	WordPtr m_uBufferLength;		///< Number of valid bytes in m_pBuffer, including the dictionary
+	WordPtr m_uDictionaryLength;	///< Number of bytes at the start of m_pBuffer from the previous batch
+	WordPtr m_uBlockSize;			///< Number of bytes compressed by each job
+	Word m_uSlotCount;				///< Number of entries in m_ppCompressors
+	Word m_uBatchCount;				///< Number of entries in m_pBlocks
+	Word m_uBlockCount;				///< Number of blocks in the batch being compressed
+	Word m_uLevel;					///< Compression level
+	Word m_bUseDictionary;			///< \ref TRUE if blocks use the previous data as a dictionary
+	Word m_bLastBatch;				///< \ref TRUE if the batch being compressed ends the stream
+	Word m_bHeaderSent;				///< \ref TRUE if the zlib header was output
+	Word32 m_uAdler;				///< Adler-32 of all of the data compressed so far
+
+	static void BURGER_API CompressBlocks(void *pData,WordPtr uStart,WordPtr uEnd,Word uSlot);
+	eError Allocate(void);
+	void Release(void);
+	eError CompressBatch(Word bLast);
+public:
+	static const Word32 Signature = CompressDeflate::Signature;		///< 'ZLIB'
+	CompressDeflateParallel(JobScheduler *pScheduler=NULL);
+	virtual ~CompressDeflateParallel();
+	virtual eError Init(void);
+	virtual eError Process(const void *pInput,WordPtr uInputLength);
+	virtual eError Finalize(void);
+	void SetLevel(Word uLevel);
+	BURGER_INLINE Word GetLevel(void) const { return m_uLevel; }
+	void SetBlockSize(WordPtr uBlockSize);
+	BURGER_INLINE WordPtr GetBlockSize(void) const { return m_uBlockSize; }
+	BURGER_INLINE void SetUseDictionary(Word bUseDictionary) { m_bUseDictionary = bUseDictionary; }
+	BURGER_INLINE Word GetUseDictionary(void) const { return m_bUseDictionary; }
+};
+}
+/* END */
+
+#endif
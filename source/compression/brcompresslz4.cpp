@@ -0,0 +1,391 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcompresslz4.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZ4,Burger::Compress);
+
+// Processors that can read misaligned values in hardware
+#if defined(BURGER_INTELARCHITECTURE) || defined(BURGER_ARM64)
+#define LZ4_UNALIGNED
+#endif
+
+//
+// Read 4 bytes as a little endian 32 bit value
+//
+
+static BURGER_INLINE Word32 LZ4Load32(const Word8 *pInput)
+{
+#if defined(LZ4_UNALIGNED) && defined(BURGER_LITTLEENDIAN)
+	return static_cast<const Word32 *>(static_cast<const void *>(pInput))[0];
+#else
+	return static_cast<Word32>(pInput[0])|(static_cast<Word32>(pInput[1])<<8U)|
+		(static_cast<Word32>(pInput[2])<<16U)|(static_cast<Word32>(pInput[3])<<24U);
+#endif
+}
+
+//
+// Hash 4 bytes into an index for m_HashTable
+//
+
+static BURGER_INLINE Word LZ4Hash(Word32 uSequence,Word uHashBits)
+{
+	return static_cast<Word>((uSequence*2654435761U)>>(32U-uHashBits));
+}
+
+//
+// Return the number of matching bytes, stopping at pLimit
+//
+
+static BURGER_INLINE Word LZ4MatchLength(const Word8 *pInput,const Word8 *pMatch,const Word8 *pLimit)
+{
+	const Word8 *pStart = pInput;
+#if defined(LZ4_UNALIGNED) && defined(BURGER_64BITCPU)
+	// Compare 8 bytes at a time
+	while (pInput<(pLimit-7)) {
+		if (static_cast<const Word64 *>(static_cast<const void *>(pInput))[0]!=
+			static_cast<const Word64 *>(static_cast<const void *>(pMatch))[0]) {
+			break;
+		}
+		pInput += 8;
+		pMatch += 8;
+	}
+#endif
+	while ((pInput<pLimit) && (pInput[0]==pMatch[0])) {
+		++pInput;
+		++pMatch;
+	}
+	return static_cast<Word>(pInput-pStart);
+}
+#endif
+
+/*! ************************************
+
+	\class Burger::CompressLZ4
+	\brief Compress data using LZ4 encoding
+
+	LZ4 is a byte oriented Lempel Ziv encoding without entropy
+	coding, which trades compression ratio for decompression that
+	runs at near memory copy speed. The output is the LZ4 block format
+	documented here.
+
+	https://github.com/lz4/lz4/blob/master/doc/lz4_Block_format.md
+
+	The data is a series of sequences. Each one starts with a token byte,
+	the upper 4 bits are the number of literal bytes and the lower 4 bits
+	are the match length minus 4. A value of 15 in either field means
+	bytes follow that are added to the length until a byte that isn't 255.
+	The literal length is followed by the literals, then a 16 bit little
+	endian offset (1-65535) back into the decompressed data and then the
+	extra bytes of the match length. The last sequence only has literals.
+
+	Matches are found with a single entry hash table and the search
+	skips ahead faster through data that doesn't compress. The last
+	12 bytes never start a match and the last 5 bytes are always literals,
+	so the output can be decoded by any LZ4 block decoder.
+
+	\sa Burger::DecompressLZ4
+
+***************************************/
+
+/*! ************************************
+
+	\brief Output the extra bytes of a length
+
+	\param uLength Length minus 15
+
+***************************************/
+
+void Burger::CompressLZ4::OutputLength(WordPtr uLength)
+{
+	while (uLength>=255U) {
+		m_Output.Append(static_cast<Word8>(255U));
+		uLength -= 255U;
+	}
+	m_Output.Append(static_cast<Word8>(uLength));
+}
+
+/*! ************************************
+
+	\brief Output a sequence
+
+	Output the pending literals up to uLiteralEnd and a match. If the
+	match length is zero, only the literals are output, which ends
+	the stream.
+
+	\param uLiteralEnd Index in m_Buffer past the last literal
+	\param uMatchLength Length of the match or zero for the last sequence
+	\param uOffset Distance back to the matching data
+
+***************************************/
+
+void Burger::CompressLZ4::OutputSequence(Word uLiteralEnd,Word uMatchLength,Word uOffset)
+{
+	WordPtr uLiterals = m_uLiteralsLength+(uLiteralEnd-m_uLiteralStart);
+	Word uToken = (uLiterals<RUNMASK) ? static_cast<Word>(uLiterals<<4U) : (RUNMASK<<4U);
+	Word uMatchCode = 0;
+	if (uMatchLength) {
+		uMatchCode = uMatchLength-MINMATCH;
+		uToken |= (uMatchCode<RUNMASK) ? uMatchCode : RUNMASK;
+	}
+	m_Output.Append(static_cast<Word8>(uToken));
+	if (uLiterals>=RUNMASK) {
+		OutputLength(uLiterals-RUNMASK);
+	}
+
+	// Literals that were slid out of the buffer come first
+	if (m_uLiteralsLength) {
+		m_Output.Append(m_pLiterals,m_uLiteralsLength);
+		m_uLiteralsLength = 0;
+	}
+	if (uLiteralEnd!=m_uLiteralStart) {
+		m_Output.Append(m_Buffer+m_uLiteralStart,uLiteralEnd-m_uLiteralStart);
+	}
+	if (uMatchLength) {
+		// Note: This is put in the stream as little endian!!
+		m_Output.Append(static_cast<Word16>(uOffset));
+		if (uMatchCode>=RUNMASK) {
+			OutputLength(uMatchCode-RUNMASK);
+		}
+	}
+	m_uLiteralStart = uLiteralEnd+uMatchLength;
+}
+
+/*! ************************************
+
+	\brief Find and output matches in the buffer
+
+	Search for matches from m_uPosition up to 12 bytes from the end
+	of the buffer and output a sequence for each one.
+	Bytes without matches are left as pending literals.
+
+***************************************/
+
+void Burger::CompressLZ4::Parse(void)
+{
+	Word uEnd = m_uBufferLength;
+	if (uEnd<=MFLIMIT) {
+		return;
+	}
+	const Word uParseLimit = uEnd-MFLIMIT;
+	const Word8 *pMatchLimit = m_Buffer+(uEnd-LASTLITERALS);
+	const Word8 *pBuffer = m_Buffer;
+	Word32 *pHashTable = m_HashTable;
+	Word uPosition = m_uPosition;
+	Word uSearches = 1U<<SKIPSTRENGTH;
+	while (uPosition<uParseLimit) {
+		Word32 uSequence = LZ4Load32(pBuffer+uPosition);
+		Word32 *pHash = &pHashTable[LZ4Hash(uSequence,HASHBITS)];
+		Word uCandidate = pHash[0];
+		pHash[0] = static_cast<Word32>(uPosition);
+		if ((uCandidate<uPosition) && ((uPosition-uCandidate)<WINDOWSIZE) &&
+			(LZ4Load32(pBuffer+uCandidate)==uSequence)) {
+
+			// Include matching literals before the match
+			while ((uPosition>m_uLiteralStart) && uCandidate &&
+				(pBuffer[uPosition-1]==pBuffer[uCandidate-1])) {
+				--uPosition;
+				--uCandidate;
+			}
+			Word uLength = MINMATCH+LZ4MatchLength(pBuffer+uPosition+MINMATCH,pBuffer+uCandidate+MINMATCH,pMatchLimit);
+			OutputSequence(uPosition,uLength,uPosition-uCandidate);
+			uPosition += uLength;
+
+			// Index a position inside the match for the next search
+			pHashTable[LZ4Hash(LZ4Load32(pBuffer+uPosition-2),HASHBITS)] = static_cast<Word32>(uPosition-2);
+			uSearches = 1U<<SKIPSTRENGTH;
+		} else {
+			// Move faster the longer it's been since the last match
+			uPosition += uSearches>>SKIPSTRENGTH;
+			++uSearches;
+		}
+	}
+	m_uPosition = uPosition;
+}
+
+/*! ************************************
+
+	\brief Discard the oldest half of the buffer
+
+	Move the second half of the buffer to the start and adjust
+	the hash table. Pending literals in the discarded half are
+	saved in m_pLiterals.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Slide(void)
+{
+	if (m_uLiteralStart<WINDOWSIZE) {
+		WordPtr uCount = WINDOWSIZE-m_uLiteralStart;
+		WordPtr uNewLength = m_uLiteralsLength+uCount;
+		if (uNewLength>m_uLiteralsSize) {
+			WordPtr uNewSize = uNewLength*2;
+			Word8 *pLiterals = static_cast<Word8 *>(Realloc(m_pLiterals,uNewSize));
+			if (!pLiterals) {
+				return COMPRESS_OUTOFMEMORY;
+			}
+			m_pLiterals = pLiterals;
+			m_uLiteralsSize = uNewSize;
+		}
+		MemoryCopy(m_pLiterals+m_uLiteralsLength,m_Buffer+m_uLiteralStart,uCount);
+		m_uLiteralsLength = uNewLength;
+		m_uLiteralStart = WINDOWSIZE;
+	}
+	MemoryMove(m_Buffer,m_Buffer+WINDOWSIZE,m_uBufferLength-WINDOWSIZE);
+	m_uBufferLength -= WINDOWSIZE;
+	m_uPosition -= WINDOWSIZE;
+	m_uLiteralStart -= WINDOWSIZE;
+
+	// Entries for the discarded half point to the start of the buffer,
+	// which only costs a failed compare
+	Word32 *pHash = m_HashTable;
+	Word i = HASHSIZE;
+	do {
+		Word32 uIndex = pHash[0];
+		pHash[0] = (uIndex>=WINDOWSIZE) ? uIndex-WINDOWSIZE : 0;
+		++pHash;
+	} while (--i);
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Reset the state for a new stream
+
+***************************************/
+
+void Burger::CompressLZ4::Reset(void)
+{
+	m_uLiteralsLength = 0;
+	m_uBufferLength = 0;
+	m_uPosition = 0;
+	m_uLiteralStart = 0;
+	MemoryClear(m_HashTable,sizeof(m_HashTable));
+}
+
+/*! ************************************
+
+	\brief Initialize the compressor to defaults
+
+***************************************/
+
+Burger::CompressLZ4::CompressLZ4(void) :
+	Compress(),
+	m_pLiterals(NULL),
+	m_uLiteralsSize(0)
+{
+	m_uSignature = Signature;
+	Reset();
+}
+
+/*! ************************************
+
+	\brief Release the pending literal buffer
+
+***************************************/
+
+Burger::CompressLZ4::~CompressLZ4()
+{
+	Free(m_pLiterals);
+}
+
+/*! ************************************
+
+	\brief Reset the LZ4 compressor
+
+	Discard the output and start a new stream
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Init(void)
+{
+	m_Output.Clear();
+	Reset();
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Compress the input data using LZ4
+
+	Data is copied into a 128K buffer and compressed when the buffer
+	is full, so the output doesn't depend on how the input is split
+	between calls.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes to compress
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Process(const void *pInput,WordPtr uInputLength)
+{
+	eError Error = COMPRESS_OKAY;
+	while (uInputLength) {
+		// Only compress a full buffer when there is more data, so
+		// Finalize() handles the end of the stream
+		if (m_uBufferLength==BUFFERSIZE) {
+			Parse();
+			Error = Slide();
+			if (Error!=COMPRESS_OKAY) {
+				break;
+			}
+		}
+		WordPtr uChunk = BUFFERSIZE-m_uBufferLength;
+		if (uChunk>uInputLength) {
+			uChunk = uInputLength;
+		}
+		MemoryCopy(m_Buffer+m_uBufferLength,pInput,uChunk);
+		m_uBufferLength += static_cast<Word>(uChunk);
+		pInput = static_cast<const Word8 *>(pInput)+uChunk;
+		uInputLength -= uChunk;
+	}
+	return Error;
+}
+
+/*! ************************************
+
+	\brief Finalize LZ4 compression
+
+	Compress the buffered data and output the remaining bytes as
+	the final literal only sequence. The compressor is reset
+	for another stream.
+
+	\return Zero if no error, non-zero on error
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Finalize(void)
+{
+	Parse();
+	OutputSequence(m_uBufferLength,0,0);
+	Reset();
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::CompressLZ4::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
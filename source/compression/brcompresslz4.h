@@ -0,0 +1,74 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRCOMPRESSLZ4_H__
+#define __BRCOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRBASE_H__
+#include "brbase.h"
+#endif
+
+#ifndef __BROUTPUTMEMORYSTREAM_H__
+#include "broutputmemorystream.h"
+#endif
+
+#ifndef __BRCOMPRESS_H__
+#include "brcompress.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class CompressLZ4 : public Compress {
+	BURGER_DISABLECOPYCONSTRUCTORS(CompressLZ4);
+	BURGER_RTTI_IN_CLASS();
+protected:
+	static const Word WINDOWSIZE=0x10000;		///< Matches can reach back 65535 bytes
+	static const Word BUFFERSIZE=WINDOWSIZE*2;	///< Size of the input buffer, the first half is the history
+	static const Word HASHBITS=14;				///< Number of bits in a hash value
+	static const Word HASHSIZE=1<<HASHBITS;		///< Number of entries in the hash table
+	static const Word MINMATCH=4;				///< Shortest match
+	static const Word LASTLITERALS=5;			///< The last 5 bytes of the stream are always literals
+	static const Word MFLIMIT=12;				///< A match can't start within 12 bytes of the end of the stream
+	static const Word RUNMASK=15;				///< Token value that signals extra length bytes
+	static const Word SKIPSTRENGTH=6;			///< After 64 failed searches, skip bytes faster
+
+	Word8 *m_pLiterals;						///< Pending literals that were slid out of the buffer
+	WordPtr m_uLiteralsSize;				///< Allocated size of m_pLiterals
+	WordPtr m_uLiteralsLength;				///< Number of bytes in m_pLiterals
+	Word m_uBufferLength;					///< Number of valid bytes in m_Buffer
+	Word m_uPosition;						///< Index in m_Buffer of the next byte to search for a match
+	Word m_uLiteralStart;					///< Index in m_Buffer of the first literal not output
+	Word32 m_HashTable[HASHSIZE];			///< Most recent index in m_Buffer for each hash value
+	Word8 m_Buffer[BUFFERSIZE];				///< Input data, the first half is the history
+
+	void OutputLength(WordPtr uLength);
+	void OutputSequence(Word uLiteralEnd,Word uMatchLength,Word uOffset);
+	void Parse(void);
+	eError Slide(void);
+	void Reset(void);
+public:
+	static const Word32 Signature = 0x4C5A3420;		///< 'LZ4 '
+	CompressLZ4(void);
+	virtual ~CompressLZ4();
+	virtual eError Init(void);
+	virtual eError Process(const void *pInput,WordPtr uInputLength);
+	virtual eError Finalize(void);
+};
+}
+/* END */
+
+#endif
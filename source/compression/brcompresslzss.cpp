@@ -12,9 +12,21 @@
 ***************************************/
 
 #include "brcompresslzss.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZSS,Burger::Compress);
+
+//
+// Hash 3 bytes into an index for m_pHashHead
+//
+
+static BURGER_INLINE Word LZSSHash(const Word8 *pInput,Word uHashBits)
+{
+	Word32 uSequence = static_cast<Word32>(pInput[0])|(static_cast<Word32>(pInput[1])<<8U)|(static_cast<Word32>(pInput[2])<<16U);
+	return static_cast<Word>((uSequence*2654435761U)>>(32U-uHashBits));
+}
 #endif
 
 /*! ************************************
@@ -41,6 +53,20 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::CompressLZSS,Burger::Compress);
 	and added to the current output pointer and the bytes are 
 	copied from the previously decompressed data to the current buffer
 
+	The original match finder keeps a binary search tree of every string
+	in the window, which is updated for every byte of input. For large
+	amounts of data, SetMatchFinder(MATCHFINDER_HASHCHAIN) uses hash chains
+	of 3 byte strings instead, and stops searching after GetChainDepth()
+	entries. It's much faster, the output is the same format and is usually
+	about the same size.
+
+	SetLargeWindow(\ref TRUE) outputs a variant with a 65535 byte window
+	and matches of 3 to 258 bytes, which always uses the hash chain match
+	finder. The match token is three bytes, the distance minus one as a
+	16 bit little endian value followed by the length minus 3.
+	Burger::DecompressLZSS must have Burger::DecompressLZSS::SetLargeWindow(\ref TRUE)
+	called to decompress it.
+
 	\sa Burger::DecompressLZSS
 
 ***************************************/
@@ -256,6 +282,312 @@ void Burger::CompressLZSS::InitTrees(void)
 
 	// No data is in the cache
 	m_uCachedLength = 0;
+
+	// No bit mask is pending
+	m_uBitMaskOffset = 0;
+	m_bBitMask = 0;
+	m_bOrMask = 0;
+}
+
+/*! ************************************
+
+	\brief Output a literal byte
+
+	Add a byte to the output and set its bit in the bit mask.
+	Used by the hash chain match finder.
+
+	\param uValue Byte to output
+	\sa OutputMatch(Word,Word)
+
+***************************************/
+
+void Burger::CompressLZSS::OutputLiteral(Word uValue)
+{
+	// Insert a bit mask if one isn't pending
+	if (!m_bOrMask) {
+		m_uBitMaskOffset = m_Output.GetSize();
+		m_Output.Append(static_cast<Word8>(0));
+		m_bOrMask = 1;
+		m_bBitMask = 0;
+	}
+	m_bBitMask |= m_bOrMask;		// 'send one byte' flag
+	m_Output.Append(static_cast<Word8>(uValue));
+	m_bOrMask <<= 1;
+	// All filled?
+	if (!m_bOrMask) {
+		m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+	}
+}
+
+/*! ************************************
+
+	\brief Output a match
+
+	Add a match token to the output in either the 4096 or 65535
+	byte window format. Used by the hash chain match finder.
+
+	\param uLength Length of the match
+	\param uDistance Distance back to the matching data
+	\sa OutputLiteral(Word)
+
+***************************************/
+
+void Burger::CompressLZSS::OutputMatch(Word uLength,Word uDistance)
+{
+	// Insert a bit mask if one isn't pending
+	if (!m_bOrMask) {
+		m_uBitMaskOffset = m_Output.GetSize();
+		m_Output.Append(static_cast<Word8>(0));
+		m_bOrMask = 1;
+		m_bBitMask = 0;
+	}
+	// Note: This is put in the stream as little endian!!
+	if (m_bLargeWindow) {
+		m_Output.Append(static_cast<Word16>(uDistance-1));
+		m_Output.Append(static_cast<Word8>(uLength-(MINMATCHLENGTH+1)));
+	} else {
+		Word uNewToken = (0U-uDistance)&0xFFF;
+		uNewToken = uNewToken|((uLength-(MINMATCHLENGTH+1))<<12);
+		m_Output.Append(static_cast<Word16>(uNewToken));
+	}
+	m_bOrMask <<= 1;
+	// All filled?
+	if (!m_bOrMask) {
+		m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+	}
+}
+
+/*! ************************************
+
+	\brief Initialize the hash chain match finder
+
+	Allocate the buffers for the hash chain match finder if needed
+	and reset them.
+
+	\return Zero if no error, non-zero on error
+	\sa ReleaseHash(void)
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZSS::InitHash(void)
+{
+	if (!m_pHashBuffer) {
+		// 64K window with a 64K entry hash or a 4K window with a 4K entry hash.
+		// The small window uses a larger buffer so it's not moved as often
+		Word uWindowSize = m_bLargeWindow ? LARGEWINDOWSIZE : RINGBUFFERSIZE;
+		Word uHashBufferSize = m_bLargeWindow ? LARGEWINDOWSIZE*2 : RINGBUFFERSIZE*8;
+		Word uHashBits = m_bLargeWindow ? 16U : 12U;
+		WordPtr uHeadSize = (static_cast<WordPtr>(1U)<<uHashBits)*sizeof(Word32);
+		WordPtr uPreviousSize = uWindowSize*sizeof(Word16);
+		Word8 *pBuffer = static_cast<Word8 *>(Alloc(uHeadSize+uPreviousSize+uHashBufferSize));
+		if (!pBuffer) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+		m_pHashHead = static_cast<Word32 *>(static_cast<void *>(pBuffer));
+		m_pHashPrevious = static_cast<Word16 *>(static_cast<void *>(pBuffer+uHeadSize));
+		m_pHashBuffer = pBuffer+uHeadSize+uPreviousSize;
+		m_uWindowSize = uWindowSize;
+		m_uHashBufferSize = uHashBufferSize;
+		m_uHashBits = uHashBits;
+	}
+	MemoryFill(m_pHashHead,0xFF,(static_cast<WordPtr>(1U)<<m_uHashBits)*sizeof(Word32));
+	m_uHashLength = 0;
+	m_uHashPosition = 0;
+	m_uHashInserted = 0;
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Release the hash chain match finder buffers
+
+	\sa InitHash(void)
+
+***************************************/
+
+void Burger::CompressLZSS::ReleaseHash(void)
+{
+	// The hash table is the start of the allocation
+	Free(m_pHashHead);
+	m_pHashBuffer = NULL;
+	m_pHashHead = NULL;
+	m_pHashPrevious = NULL;
+	m_uHashLength = 0;
+	m_uHashPosition = 0;
+	m_uHashInserted = 0;
+}
+
+/*! ************************************
+
+	\brief Add a string to the hash chains
+
+	\param uPosition Index in m_pHashBuffer of a string of at least 3 bytes
+
+***************************************/
+
+void Burger::CompressLZSS::InsertHash(Word uPosition)
+{
+	Word32 *pHead = &m_pHashHead[LZSSHash(m_pHashBuffer+uPosition,m_uHashBits)];
+	Word32 uPrevious = pHead[0];
+	Word uDistance = 0;
+	// Distances that don't fit end the chain
+	if ((uPrevious!=HASHNOTUSED) && ((uPosition-uPrevious)<LARGEWINDOWSIZE)) {
+		uDistance = uPosition-uPrevious;
+	}
+	m_pHashPrevious[uPosition&(m_uWindowSize-1)] = static_cast<Word16>(uDistance);
+	pHead[0] = static_cast<Word32>(uPosition);
+}
+
+/*! ************************************
+
+	\brief Find the longest match with the hash chains
+
+	All positions before uPosition must be in the hash chains.
+	The search stops after m_uChainDepth entries or if a match
+	of uMaxLength bytes is found.
+
+	\param uPosition Index in m_pHashBuffer of the string to match
+	\param uMaxLength Maximum length of a match
+	\param pDistance Pointer to receive the distance to the match
+	\return Length of the match or zero if there's no match of 3 bytes or more
+
+***************************************/
+
+Word Burger::CompressLZSS::FindMatch(Word uPosition,Word uMaxLength,Word *pDistance)
+{
+	if (uMaxLength<(MINMATCHLENGTH+1)) {
+		return 0;
+	}
+	const Word8 *pString = m_pHashBuffer+uPosition;
+	Word32 uCandidate = m_pHashHead[LZSSHash(pString,m_uHashBits)];
+	Word uMaxDistance = m_bLargeWindow ? LARGEWINDOWSIZE-1 : RINGBUFFERSIZE;
+	Word uBestLength = MINMATCHLENGTH;
+	Word uDepth = m_uChainDepth;
+	while (uCandidate!=HASHNOTUSED) {
+		Word uDistance = uPosition-uCandidate;
+		if (uDistance>uMaxDistance) {
+			break;
+		}
+		const Word8 *pMatch = m_pHashBuffer+uCandidate;
+		// Check the byte that would make a longer match first
+		if ((pMatch[uBestLength]==pString[uBestLength]) && (pMatch[0]==pString[0])) {
+			Word uLength = 1;
+			while ((uLength<uMaxLength) && (pMatch[uLength]==pString[uLength])) {
+				++uLength;
+			}
+			if (uLength>uBestLength) {
+				uBestLength = uLength;
+				pDistance[0] = uDistance;
+				if (uLength>=uMaxLength) {
+					break;
+				}
+			}
+		}
+		if (!--uDepth) {
+			break;
+		}
+		Word uPrevious = m_pHashPrevious[uCandidate&(m_uWindowSize-1)];
+		// End of the chain or slid out of the buffer?
+		if (!uPrevious || (uPrevious>uCandidate)) {
+			break;
+		}
+		uCandidate -= uPrevious;
+	}
+	return (uBestLength>MINMATCHLENGTH) ? uBestLength : 0;
+}
+
+/*! ************************************
+
+	\brief Compress the buffered data with the hash chains
+
+	Output tokens for the data in m_pHashBuffer. Unless this is the
+	end of the stream, the last maximum match length bytes are left
+	in the buffer so every match can be as long as possible.
+
+	If there's a longer match at the next byte, the current byte
+	is output as a literal instead of taking the match.
+
+	\param bLast \ref TRUE if this is the end of the stream
+
+***************************************/
+
+void Burger::CompressLZSS::ParseHash(Word bLast)
+{
+	const Word uEnd = m_uHashLength;
+	const Word uMaxMatch = m_bLargeWindow ? LARGEMAXMATCHLENGTH : MAXMATCHLENGTH;
+	if (!bLast && (uEnd<=uMaxMatch)) {
+		return;
+	}
+	const Word uLimit = bLast ? uEnd : uEnd-uMaxMatch;
+	// Strings with less than 3 bytes can't be hashed
+	const Word uHashLimit = (uEnd>=(MINMATCHLENGTH+1)) ? uEnd-MINMATCHLENGTH : 0;
+	const Word8 *pBuffer = m_pHashBuffer;
+	Word uPosition = m_uHashPosition;
+	Word uInserted = m_uHashInserted;
+	while (uPosition<uLimit) {
+		while ((uInserted<uPosition) && (uInserted<uHashLimit)) {
+			InsertHash(uInserted);
+			++uInserted;
+		}
+		Word uMaxLength = uEnd-uPosition;
+		if (uMaxLength>uMaxMatch) {
+			uMaxLength = uMaxMatch;
+		}
+		Word uDistance = 0;
+		Word uLength = FindMatch(uPosition,uMaxLength,&uDistance);
+		if (uLength && (uLength<uMaxLength) && ((uPosition+1)<uLimit)) {
+			// Would a match at the next byte be longer?
+			if (uInserted==uPosition) {
+				InsertHash(uInserted);
+				++uInserted;
+			}
+			Word uNextMaxLength = uEnd-(uPosition+1);
+			if (uNextMaxLength>uMaxMatch) {
+				uNextMaxLength = uMaxMatch;
+			}
+			Word uNextDistance = 0;
+			if (FindMatch(uPosition+1,uNextMaxLength,&uNextDistance)>uLength) {
+				uLength = 0;
+			}
+		}
+		if (uLength) {
+			OutputMatch(uLength,uDistance);
+			uPosition += uLength;
+		} else {
+			OutputLiteral(pBuffer[uPosition]);
+			++uPosition;
+		}
+	}
+	m_uHashPosition = uPosition;
+	m_uHashInserted = uInserted;
+}
+
+/*! ************************************
+
+	\brief Discard all but the last window of the hash chain buffer
+
+	Move the last window of data to the start of the buffer and adjust
+	the hash table. The chains store distances, so only the
+	head entries need to change.
+
+***************************************/
+
+void Burger::CompressLZSS::SlideHash(void)
+{
+	// Always a multiple of the window size, so the chain indexes don't change
+	Word uSlide = m_uHashBufferSize-m_uWindowSize;
+	MemoryMove(m_pHashBuffer,m_pHashBuffer+uSlide,m_uHashLength-uSlide);
+	m_uHashLength -= uSlide;
+	m_uHashPosition -= uSlide;
+	m_uHashInserted -= uSlide;
+
+	Word32 *pHead = m_pHashHead;
+	WordPtr i = static_cast<WordPtr>(1U)<<m_uHashBits;
+	do {
+		Word32 uIndex = pHead[0];
+		pHead[0] = ((uIndex!=HASHNOTUSED) && (uIndex>=uSlide)) ? uIndex-uSlide : HASHNOTUSED;
+		++pHead;
+	} while (--i);
 }
 
 /*! ************************************
@@ -265,12 +597,35 @@ void Burger::CompressLZSS::InitTrees(void)
 ***************************************/
 
 Burger::CompressLZSS::CompressLZSS() :
-	Compress()
+	Compress(),
+	m_pHashBuffer(NULL),
+	m_pHashHead(NULL),
+	m_pHashPrevious(NULL),
+	m_eMatchFinder(MATCHFINDER_TREE),
+	m_bLargeWindow(FALSE),
+	m_uChainDepth(DEFAULT_CHAINDEPTH),
+	m_uWindowSize(RINGBUFFERSIZE),
+	m_uHashBufferSize(RINGBUFFERSIZE*8),
+	m_uHashBits(12),
+	m_uHashLength(0),
+	m_uHashPosition(0),
+	m_uHashInserted(0)
 {
 	m_uSignature = Signature;
 	InitTrees();
 }
 
+/*! ************************************
+
+	\brief Release the hash chain buffers
+
+***************************************/
+
+Burger::CompressLZSS::~CompressLZSS()
+{
+	ReleaseHash();
+}
+
 /***************************************
 
 	Initialize
@@ -282,6 +637,9 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Init(void)
 	// Clear any previous output
 	m_Output.Clear();
 	InitTrees();
+	if (m_pHashBuffer) {
+		InitHash();
+	}
 	return COMPRESS_OKAY;
 }
 
@@ -293,6 +651,32 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Init(void)
 
 Burger::CompressLZSS::eError Burger::CompressLZSS::Process(const void *pInput,WordPtr uInputLength)
 {
+	if (m_bLargeWindow || (m_eMatchFinder==MATCHFINDER_HASHCHAIN)) {
+		if (!m_pHashBuffer) {
+			eError Error = InitHash();
+			if (Error!=COMPRESS_OKAY) {
+				return Error;
+			}
+		}
+		// Compress only when the buffer is full, so the output
+		// doesn't depend on how the input is split
+		const Word uBufferSize = m_uHashBufferSize;
+		while (uInputLength) {
+			if (m_uHashLength==uBufferSize) {
+				ParseHash(FALSE);
+				SlideHash();
+			}
+			WordPtr uChunk = uBufferSize-m_uHashLength;
+			if (uChunk>uInputLength) {
+				uChunk = uInputLength;
+			}
+			MemoryCopy(m_pHashBuffer+m_uHashLength,pInput,uChunk);
+			m_uHashLength += static_cast<Word>(uChunk);
+			pInput = static_cast<const Word8 *>(pInput)+uChunk;
+			uInputLength -= uChunk;
+		}
+		return COMPRESS_OKAY;
+	}
 	if (uInputLength) {
 
 		// Read MAXMATCHLENGTH bytes into the last MAXMATCHLENGTH bytes of the buffer
@@ -412,6 +796,14 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Process(const void *pInput,Wo
 
 Burger::CompressLZSS::eError Burger::CompressLZSS::Finalize(void)
 {
+	if (m_pHashBuffer && (m_bLargeWindow || (m_eMatchFinder==MATCHFINDER_HASHCHAIN))) {
+		ParseHash(TRUE);
+		if (m_bOrMask) {
+			m_Output.Overwrite(&m_bBitMask,1,m_uBitMaskOffset);
+		}
+		InitTrees();
+		return InitHash();
+	}
 	// Finally, insert the whole string just read. The
 	// global variables MatchSize and MatchOffset are set.
 	if (m_uCachedLength) {
@@ -489,6 +881,96 @@ Burger::CompressLZSS::eError Burger::CompressLZSS::Finalize(void)
 	return COMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Select the match finder
+
+	Only change the match finder before any data is compressed.
+	The large window always uses MATCHFINDER_HASHCHAIN.
+
+	\param uMatchFinder CompressLZSS::MATCHFINDER_TREE or CompressLZSS::MATCHFINDER_HASHCHAIN
+	\sa GetMatchFinder(void) const or SetLargeWindow(Word)
+
+***************************************/
+
+void Burger::CompressLZSS::SetMatchFinder(eMatchFinder uMatchFinder)
+{
+	m_eMatchFinder = uMatchFinder;
+}
+
+/*! ************************************
+
+	\fn Burger::CompressLZSS::eMatchFinder Burger::CompressLZSS::GetMatchFinder(void) const
+	\brief Return the match finder
+
+	\return CompressLZSS::MATCHFINDER_TREE or CompressLZSS::MATCHFINDER_HASHCHAIN
+	\sa SetMatchFinder(eMatchFinder)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Enable the large window format
+
+	Output the format with a 65535 byte window and matches up to
+	258 bytes. Only change this before any data is compressed.
+
+	\param bLargeWindow \ref TRUE for the large window format, \ref FALSE for the 4096 byte window
+	\sa GetLargeWindow(void) const or Burger::DecompressLZSS::SetLargeWindow(Word)
+
+***************************************/
+
+void Burger::CompressLZSS::SetLargeWindow(Word bLargeWindow)
+{
+	bLargeWindow = (bLargeWindow!=0);
+	if (m_bLargeWindow!=bLargeWindow) {
+		// The buffers are a different size
+		ReleaseHash();
+		m_bLargeWindow = bLargeWindow;
+	}
+	m_uSignature = bLargeWindow ? SignatureLargeWindow : Signature;
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZSS::GetLargeWindow(void) const
+	\brief Return \ref TRUE if the large window format is output
+
+	\return \ref TRUE if the large window is in use
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Set the hash chain search depth
+
+	Set the maximum number of strings checked for each match by the
+	hash chain match finder. Higher values compress better and slower.
+
+	\param uChainDepth Number of entries to search, zero is changed to 1
+	\sa GetChainDepth(void) const
+
+***************************************/
+
+void Burger::CompressLZSS::SetChainDepth(Word uChainDepth)
+{
+	if (!uChainDepth) {
+		uChainDepth = 1;
+	}
+	m_uChainDepth = uChainDepth;
+}
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZSS::GetChainDepth(void) const
+	\brief Return the hash chain search depth
+
+	\return Maximum number of entries searched for each match
+	\sa SetChainDepth(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\var const Burger::StaticRTTI Burger::CompressLZSS::g_StaticRTTI
@@ -33,12 +33,22 @@
 /* BEGIN */
 namespace Burger {
 class CompressLZSS : public Compress {
+	BURGER_DISABLECOPYCONSTRUCTORS(CompressLZSS);
 	BURGER_RTTI_IN_CLASS();
+public:
+	enum eMatchFinder {
+		MATCHFINDER_TREE,			///< Binary search trees, the original LZSS match finder
+		MATCHFINDER_HASHCHAIN		///< Hash chains with a bounded search depth
+	};
+	static const Word DEFAULT_CHAINDEPTH=32;		///< Default number of hash chain entries to search
 protected:
 	static const Word RINGBUFFERSIZE=4096;		///< Size of the LZSS ring buffer
 	static const Word MAXMATCHLENGTH=18;		///< Largest size of a string to match
 	static const Word MINMATCHLENGTH=2;			///< Encode string into position and length
 	static const Word NOTUSED=RINGBUFFERSIZE;	///< Index for root of binary search trees
+	static const Word LARGEWINDOWSIZE=0x10000;	///< Size of the large window
+	static const Word LARGEMAXMATCHLENGTH=258;	///< Largest size of a string to match with the large window
+	static const Word32 HASHNOTUSED=0xFFFFFFFFU;	///< Empty hash table entry
 
 	WordPtr m_uBitMaskOffset;					///< Location in the output stream to store any bit masks
 	Word m_uSourceIndex;						///< Index to insert nodes into
@@ -55,15 +65,44 @@ protected:
 	Word8 m_bOrMask;							///< Bit mask for which bit is currently being modified
 	Word8 m_RingBuffer[RINGBUFFERSIZE+MAXMATCHLENGTH-1];	///< Ring buffer of size RINGBUFFERSIZE, with extra MAXMATCHLENGTH-1 bytes to facilitate string comparison
 
+	Word8 *m_pHashBuffer;						///< Input buffer for the hash chain match finder, starting with the history
+	Word32 *m_pHashHead;						///< Most recent index in m_pHashBuffer for each hash value
+	Word16 *m_pHashPrevious;					///< Distance to the previous index with the same hash
+	eMatchFinder m_eMatchFinder;				///< Match finder to use
+	Word m_bLargeWindow;						///< \ref TRUE if the large window format is output
+	Word m_uChainDepth;							///< Maximum number of hash chain entries to search
+	Word m_uWindowSize;							///< Size of the window for the hash chain match finder
+	Word m_uHashBufferSize;						///< Size of m_pHashBuffer in bytes
+	Word m_uHashBits;							///< Number of bits in a hash value
+	Word m_uHashLength;							///< Number of valid bytes in m_pHashBuffer
+	Word m_uHashPosition;						///< Index in m_pHashBuffer of the next byte to encode
+	Word m_uHashInserted;						///< Index in m_pHashBuffer of the next byte to add to the hash chains
+
 	void DeleteNode(WordPtr uNodeNumber);
 	void InsertNode(WordPtr uNodeNumber);
 	void InitTrees(void);
+	void OutputLiteral(Word uValue);
+	void OutputMatch(Word uLength,Word uDistance);
+	eError InitHash(void);
+	void ReleaseHash(void);
+	void InsertHash(Word uPosition);
+	Word FindMatch(Word uPosition,Word uMaxLength,Word *pDistance);
+	void ParseHash(Word bLast);
+	void SlideHash(void);
 public:
 	static const Word32 Signature = 0x4C5A5353;		///< 'LZSS'
+	static const Word32 SignatureLargeWindow = 0x4C5A534C;	///< 'LZSL'
 	CompressLZSS(void);
+	virtual ~CompressLZSS();
 	virtual eError Init(void);
 	virtual eError Process(const void *pInput,WordPtr uInputLength);
 	virtual eError Finalize(void);
+	void SetMatchFinder(eMatchFinder uMatchFinder);
+	BURGER_INLINE eMatchFinder GetMatchFinder(void) const { return m_eMatchFinder; }
+	void SetLargeWindow(Word bLargeWindow);
+	BURGER_INLINE Word GetLargeWindow(void) const { return m_bLargeWindow; }
+	void SetChainDepth(Word uChainDepth);
+	BURGER_INLINE Word GetChainDepth(void) const { return m_uChainDepth; }
 };
 }
 /* END */
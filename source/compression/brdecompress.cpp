@@ -95,6 +95,31 @@ Burger::Decompress::Decompress(void) :
 
 ***************************************/
 
+/*! ************************************
+
+	\brief Create a new instance of this decompressor
+
+	Allocate a new instance of the same decompression algorithm
+	in a reset state. This allows multiple threads to decompress
+	data with the same algorithm at the same time, since each
+	thread will need its own instance. Only the algorithm is
+	duplicated, not the state of a decompression in progress.
+
+	Release the new instance with Delete(const Base *).
+
+	\note The base class returns \ref NULL so decompressors
+	that don't implement this function are used only by
+	one thread at a time.
+
+	\return Pointer to a new instance or \ref NULL if not supported or out of memory
+
+***************************************/
+
+Burger::Decompress *Burger::Decompress::Clone(void) const
+{
+	return NULL;
+}
+
 /*! ************************************
 
 	\fn WordPtr Burger::Decompress::GetTotalInputSize(void) const
@@ -42,6 +42,7 @@ public:
 	Decompress(void);
 	virtual eError Reset(void) = 0;
 	virtual eError Process(void *pOutput,WordPtr uOutputChunkSize,const void *pInput,WordPtr uInputChunkLength) = 0;
+	virtual Decompress *Clone(void) const;
 	BURGER_INLINE WordPtr GetTotalInputSize(void) const { return m_uTotalInput; }
 	BURGER_INLINE WordPtr GetTotalOutputSize(void) const { return m_uTotalOutput; }
 	BURGER_INLINE WordPtr GetProcessedInputSize(void) const { return m_uInputLength; }
@@ -65,6 +65,19 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressDeflate,Burger::Decompress);
 /// If BMAX needs to be larger than 16, then h and x[] should be uLong.
 #define BMAX 15		///< maximum bit length of any code
 
+// Processors that can read and write misaligned 64 bit values in hardware
+// use the wide decoder
+#if defined(BURGER_INTELARCHITECTURE) || defined(BURGER_ARM64)
+#define DEFLATE_WIDE
+#if defined(BURGER_AMD64) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define DEFLATE_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+/// Bytes a wide match copy can write past the end of the match
+#define DEFLATE_WIDESLACK 16
+
 #endif
 
 /***************************************
@@ -514,6 +527,247 @@ ByeBye:;
 	return iErrorCode;
 }
 
+#if defined(DEFLATE_WIDE) && !defined(DOXYGEN)
+
+//
+// Read 8 bytes of the input stream as a little endian 64 bit value
+//
+
+static BURGER_INLINE Word64 DeflateLoad64(const Word8 *pInput)
+{
+	return static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+}
+
+//
+// Copy 8 bytes, the source must be at least 8 bytes behind the destination
+//
+
+static BURGER_INLINE void DeflateCopy8(Word8 *pOutput,const Word8 *pInput)
+{
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[0] = static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+}
+
+//
+// Copy 16 bytes, the source must be at least 16 bytes behind the destination
+//
+
+static BURGER_INLINE void DeflateCopy16(Word8 *pOutput,const Word8 *pInput)
+{
+#if defined(DEFLATE_SSE2)
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pOutput)),_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput))));
+#else
+	Word64 uLow = static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+	Word64 uHigh = static_cast<const Word64 *>(static_cast<const void *>(pInput))[1];
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[0] = uLow;
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[1] = uHigh;
+#endif
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Optimized decompression code for 64 bit capable processors
+
+	Modern version of Fast(). The bit bucket is 64 bits wide and it's
+	refilled with a single 8 byte read which tops it off to 56-63 bits, so
+	a complete length/distance pair (48 bits at most) can be decoded
+	without checking the input again. Literals are decoded up to three at
+	a time from the same refill. Matches that don't cross the end of the
+	sliding window are copied 16 or 8 bytes at a time, overlapping
+	runs of a single byte are filled 16 bytes at a time.
+
+	Called with at least 8 bytes of input and enough room in the window
+	for a 258 byte match plus the 16 bytes a wide copy can write past the
+	end of the match. The output is identical to Fast(), only the speed
+	differs.
+
+	\note This is only available on processors that can read misaligned
+	64 bit values, on all others, Fast() is used.
+
+	\param uBitLength Length of the bit stream
+	\param uBitDistance Bit distance for huffman decoding
+	\param pHuffmanLength Pointer to the huffman table for length entries
+	\param pHuffmanDistance Pointer to the huffman table for distance entries
+
+	\return Error code
+	\sa Fast(Word,Word,const DeflateHuft_t *,const DeflateHuft_t *)
+
+***************************************/
+
+#if defined(DEFLATE_WIDE) || defined(DOXYGEN)
+int Burger::DecompressDeflate::FastWide(Word uBitLength,Word uBitDistance,const DeflateHuft_t *pHuffmanLength,const DeflateHuft_t *pHuffmanDistance)
+{
+	// load input, output, bit values
+	const Word8 *pInput = m_pInput;
+	const Word8 *pInputEnd = pInput+m_uInputChunkLength;
+	Word64 uBitBucket = m_uBitBucket;
+	Word uBitCount = m_uBitCount;
+	Word8 *pWindowWrite = m_pWindowWrite;
+
+	// Stop when a maximum length match and its overshoot no longer fits
+	const Word8 *pWindowLimit = (pWindowWrite<m_pWindowRead ? m_pWindowRead-1 : &m_WindowBuffer[1<<MAX_WBITS])-(258+DEFLATE_WIDESLACK);
+
+	// initialize masks
+	Word uMaskLength = g_DeflateMask[uBitLength];
+	Word uMaskDistance = g_DeflateMask[uBitDistance];
+
+	int iErrorCode;
+	do {
+		// Top off the bit bucket, bits past uBitCount are either zero or
+		// the same bits that this read will insert
+		uBitBucket |= DeflateLoad64(pInput)<<uBitCount;
+		pInput += (63U-uBitCount)>>3U;
+		uBitCount |= 56U;
+
+		// max bits for literal/length code
+		const DeflateHuft_t *pHuffman = pHuffmanLength + (static_cast<Word>(uBitBucket) & uMaskLength);
+		Word uExtra = pHuffman->m_bExtraOperation;
+		if (!uExtra) {
+			// Literal code, root table codes are 9 bits at most so up
+			// to three can be decoded from one refill
+			Word uCount = 3;
+			do {
+				uBitBucket>>=pHuffman->m_bBitCount;
+				uBitCount-=pHuffman->m_bBitCount;
+				pWindowWrite[0] = static_cast<Word8>(pHuffman->m_uBase);
+				++pWindowWrite;
+				if (!--uCount) {
+					break;
+				}
+				pHuffman = pHuffmanLength + (static_cast<Word>(uBitBucket) & uMaskLength);
+			} while (!pHuffman->m_bExtraOperation);
+			continue;
+		}
+		// Length code
+		for (;;) {
+			uBitBucket>>=pHuffman->m_bBitCount;
+			uBitCount-=pHuffman->m_bBitCount;
+			if (uExtra & 0x10) {
+				// Get extra bits for length
+				uExtra &= 0xF;
+				WordPtr uBytesToCopy = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+				uBitBucket>>=uExtra;
+				uBitCount-=uExtra;
+
+				// max bits for distance code, no refill is needed
+				pHuffman = pHuffmanDistance + (static_cast<Word>(uBitBucket) & uMaskDistance);
+				uExtra = pHuffman->m_bExtraOperation;
+				for (;;) {
+					uBitBucket>>=pHuffman->m_bBitCount;
+					uBitCount-=pHuffman->m_bBitCount;
+					if (uExtra & 0x10) {
+						// get extra bits (up to 13)
+						uExtra &= 0xF;
+						WordPtr uDistance = pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+						uBitBucket>>= uExtra;
+						uBitCount-=uExtra;
+
+						// do the copy
+						if (static_cast<WordPtr>(pWindowWrite - m_WindowBuffer) >= uDistance) {
+							// The source is contiguous, copy in wide chunks
+							// and let the last chunk overshoot the match
+							const Word8 *pSourceCopy = pWindowWrite - uDistance;
+							Word8 *pMatchEnd = pWindowWrite + uBytesToCopy;
+							if (uDistance>=16) {
+								do {
+									DeflateCopy16(pWindowWrite,pSourceCopy);
+									pSourceCopy+=16;
+									pWindowWrite+=16;
+								} while (pWindowWrite<pMatchEnd);
+							} else if (uDistance>=8) {
+								do {
+									DeflateCopy8(pWindowWrite,pSourceCopy);
+									pSourceCopy+=8;
+									pWindowWrite+=8;
+								} while (pWindowWrite<pMatchEnd);
+							} else if (uDistance==1) {
+								// Run of a single byte
+								Word64 uFill = static_cast<Word64>(pSourceCopy[0])*0x0101010101010101ULL;
+								do {
+									static_cast<Word64 *>(static_cast<void *>(pWindowWrite))[0] = uFill;
+									static_cast<Word64 *>(static_cast<void *>(pWindowWrite))[1] = uFill;
+									pWindowWrite+=16;
+								} while (pWindowWrite<pMatchEnd);
+							} else {
+								// Short repeating pattern
+								do {
+									pWindowWrite[0] = pSourceCopy[0];
+									++pSourceCopy;
+									++pWindowWrite;
+								} while (pWindowWrite<pMatchEnd);
+							}
+							pWindowWrite = pMatchEnd;
+						} else {
+							// else offset after destination
+							// bytes from offset to end
+							uExtra = static_cast<Word>(uDistance - static_cast<WordPtr>(pWindowWrite - m_WindowBuffer));
+							const Word8 *pSourceCopy = &m_WindowBuffer[1<<MAX_WBITS] - uExtra;	// pointer to offset
+							if (uBytesToCopy > uExtra) {		// if source crosses,
+								uBytesToCopy -= uExtra;			// copy to end of window
+								do {
+									pWindowWrite[0] = pSourceCopy[0];
+									++pSourceCopy;
+									++pWindowWrite;
+								} while (--uExtra);
+								pSourceCopy = m_WindowBuffer;	// copy rest from start of window
+							}
+							// copy all or what's left
+							do {
+								pWindowWrite[0] = pSourceCopy[0];
+								++pSourceCopy;
+								++pWindowWrite;
+							} while (--uBytesToCopy);
+						}
+						break;
+					}
+					if (uExtra & 0x40) {
+						iErrorCode = Z_DATA_ERROR;
+						goto ByeBye;
+					}
+					pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+					uExtra = pHuffman->m_bExtraOperation;
+				}
+				break;
+			}
+			if (uExtra & 0x40) {
+				if (uExtra & 0x20) {
+					iErrorCode = Z_STREAM_END;
+					goto ByeBye;
+				}
+				iErrorCode = Z_DATA_ERROR;
+				goto ByeBye;
+			}
+			pHuffman = pHuffman + pHuffman->m_uBase + (static_cast<Word>(uBitBucket) & g_DeflateMask[uExtra]);
+			uExtra = pHuffman->m_bExtraOperation;
+			if (!uExtra) {
+				uBitBucket>>=pHuffman->m_bBitCount;
+				uBitCount-=pHuffman->m_bBitCount;
+				pWindowWrite[0] = static_cast<Word8>(pHuffman->m_uBase);
+				++pWindowWrite;
+				break;
+			}
+		}
+	} while ((pWindowWrite <= pWindowLimit) && (static_cast<WordPtr>(pInputEnd-pInput) >= 8));
+
+	// Not enough input or output--restore pointers and return
+	iErrorCode = Z_OK;
+ByeBye:;
+	// Return whole unused bytes to the input stream and discard
+	// the bits that were read ahead
+	WordPtr uUsed = static_cast<WordPtr>(pInput-m_pInput);
+	uUsed = (uBitCount>>3U) < uUsed ? (uBitCount>>3U) : uUsed;
+	pInput-=uUsed;
+	uBitCount-=static_cast<Word>(uUsed)<<3U;
+	m_uBitBucket=static_cast<Word32>(uBitBucket & ((static_cast<Word64>(1)<<uBitCount)-1U));
+	m_uBitCount=uBitCount;
+	m_uInputChunkLength=static_cast<WordPtr>(pInputEnd-pInput);
+	m_pInput=pInput;
+	m_pWindowWrite=pWindowWrite;
+	return iErrorCode;
+}
+#endif
+
 /*! ************************************
 
 	\brief Process the decompression codes
@@ -549,7 +803,14 @@ int Burger::DecompressDeflate::ProcessCodes(int iErrorCode)
 				m_uInputChunkLength=uInputLength;
 				m_pInput=pInput;
 				m_pWindowWrite=pWindowWrite;
-				iErrorCode = Fast(m_bCodeLengthBits,m_bCodeDistanceBits,m_pCodeTreeLength,m_pCodeTreeDistance);
+#if defined(DEFLATE_WIDE)
+				if (m_bWideDecoder && (uRemainingWindow >= (258+DEFLATE_WIDESLACK))) {
+					iErrorCode = FastWide(m_bCodeLengthBits,m_bCodeDistanceBits,m_pCodeTreeLength,m_pCodeTreeDistance);
+				} else
+#endif
+				{
+					iErrorCode = Fast(m_bCodeLengthBits,m_bCodeDistanceBits,m_pCodeTreeLength,m_pCodeTreeDistance);
+				}
 				pInput=m_pInput;
 				uInputLength=m_uInputChunkLength;
 				uBitBucket=m_uBitBucket;
@@ -1501,7 +1762,8 @@ Burger::DecompressDeflate::DecompressDeflate() :
 	Decompress(),
 	m_pInput(NULL),
 	m_pOutput(NULL),
-	m_pTreesLengths(NULL)
+	m_pTreesLengths(NULL),
+	m_bWideDecoder(TRUE)
 {
 	Reset();
 }
@@ -1538,6 +1800,20 @@ Burger::Decompress::eError Burger::DecompressDeflate::Reset(void)
 	return DECOMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Create a new Deflate decompressor
+
+	\return Pointer to a new reset instance or \ref NULL if out of memory
+	\sa Decompress::Clone(void) const
+
+***************************************/
+
+Burger::Decompress *Burger::DecompressDeflate::Clone(void) const
+{
+	return New<DecompressDeflate>();
+}
+
 /*! ************************************
 
 	\brief Decompress data using Deflate compression
@@ -1768,6 +2044,32 @@ Burger::Decompress::eError Burger::DecompressDeflate::Process(void *pOutput,Word
 }
 
 
+/*! ************************************
+
+	\fn void Burger::DecompressDeflate::SetWideDecoder(Word bEnable)
+	\brief Enable or disable the wide decoder
+
+	On processors that can read misaligned 64 bit values, the decompressor
+	switches to FastWide() when there is enough input and room in the
+	sliding window. Passing \ref FALSE forces the original byte oriented
+	decoder to be used instead. The output is the same either way, this
+	exists to compare the speed of the two decoders.
+
+	\param bEnable \ref TRUE to allow the wide decoder (Default), \ref FALSE to disable it
+	\sa GetWideDecoder(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::DecompressDeflate::GetWideDecoder(void) const
+	\brief Return \ref TRUE if the wide decoder is allowed
+
+	\return \ref TRUE if the wide decoder is allowed, \ref FALSE if not
+	\sa SetWideDecoder(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Decompress data using Deflate compression
@@ -116,6 +116,7 @@ protected:
 	Word m_uTreesTable;			///< Table lengths (14 bits)
 	Word m_uTreesIndex;			///< Index into blends (or border)
 	Word m_uTreesDepth;			///< Bit length tree depth
+	Word m_bWideDecoder;		///< \ref TRUE if FastWide() is allowed to run
 	Word8 m_bCodeLengthBits;	///< Length tree bits decoded per branch
 	Word8 m_bCodeDistanceBits;	///< Distance tree bits decoder per branch
 
@@ -127,6 +128,7 @@ protected:
 
 	int Flush(int iErrorCode);
 	int Fast(Word uBitLength,Word uBitDistance,const DeflateHuft_t *pHuffmanLength,const DeflateHuft_t *pHuffmanDistance);
+	int FastWide(Word uBitLength,Word uBitDistance,const DeflateHuft_t *pHuffmanLength,const DeflateHuft_t *pHuffmanDistance);
 	int ProcessCodes(int iErrorCode);
 	void CodesReset(Word bCodeLengthBits,Word bCodeDistanceBits,const DeflateHuft_t *pCodeTreeLength,const DeflateHuft_t *pCodeTreeDistance);
 	static int BuildHuffmanTrees(const Word *pSampleCounts,Word uNumberSamples,Word uMaxSample,const Word *pDefaultLengths,const Word *pDefaultBits,DeflateHuft_t **ppNewTree,Word *pNewTreeSize,DeflateHuft_t *pExistingTree,Word *pHuffmanCount,Word *pWorkArea);
@@ -140,6 +142,9 @@ public:
 	~DecompressDeflate();
 	virtual eError Reset(void);
 	virtual eError Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+	virtual Decompress *Clone(void) const;
+	BURGER_INLINE void SetWideDecoder(Word bEnable) { m_bWideDecoder = bEnable; }
+	BURGER_INLINE Word GetWideDecoder(void) const { return m_bWideDecoder; }
 };
 extern Decompress::eError BURGER_API SimpleDecompressDeflate(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 }
@@ -12,6 +12,7 @@
 ***************************************/
 
 #include "brdecompresslbmrle.h"
+#include "brglobalmemorymanager.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressILBMRLE,Burger::Decompress);
@@ -63,6 +64,20 @@ Burger::Decompress::eError Burger::DecompressILBMRLE::Reset(void)
 	return DECOMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Create a new RLE decompressor
+
+	\return Pointer to a new reset instance or \ref NULL if out of memory
+	\sa Decompress::Clone(void) const
+
+***************************************/
+
+Burger::Decompress *Burger::DecompressILBMRLE::Clone(void) const
+{
+	return New<DecompressILBMRLE>();
+}
+
 /*! ************************************
 
 	\brief Decompress data using RLE compression
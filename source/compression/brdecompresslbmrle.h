@@ -41,6 +41,7 @@ public:
 	DecompressILBMRLE();
 	virtual eError Reset(void);
 	virtual eError Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+	virtual Decompress *Clone(void) const;
 };
 extern Decompress::eError BURGER_API SimpleDecompressILBMRLE(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 }
@@ -0,0 +1,458 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdecompresslz4.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZ4,Burger::Decompress);
+
+// Processors that can read and write misaligned 64 bit values in hardware
+// use the wide decoder
+#if defined(BURGER_INTELARCHITECTURE) || defined(BURGER_ARM64)
+#define LZ4_WIDE
+#if defined(BURGER_AMD64) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define LZ4_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+// Bytes a wide copy can read or write past the end of the data
+#define LZ4_WIDESLACK 16
+
+#if defined(LZ4_WIDE)
+
+//
+// Copy 8 bytes, the source must be at least 8 bytes behind the destination
+//
+
+static BURGER_INLINE void LZ4Copy8(Word8 *pOutput,const Word8 *pInput)
+{
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[0] = static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+}
+
+//
+// Copy 16 bytes, the source must be at least 16 bytes behind the destination
+//
+
+static BURGER_INLINE void LZ4Copy16(Word8 *pOutput,const Word8 *pInput)
+{
+#if defined(LZ4_SSE2)
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pOutput)),_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput))));
+#else
+	Word64 uLow = static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+	Word64 uHigh = static_cast<const Word64 *>(static_cast<const void *>(pInput))[1];
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[0] = uLow;
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[1] = uHigh;
+#endif
+}
+#endif
+#endif
+
+/*! ************************************
+
+	\class Burger::DecompressLZ4
+	\brief Decompress LZ4 format
+
+	Decompress data in the LZ4 block format (Documented here Burger::CompressLZ4 )
+
+	Decompression is a series of memory copies with no entropy decoding,
+	so on processors that can access misaligned memory, sequences that
+	fit in the buffers are copied 8 or 16 bytes at a time. Sequences that
+	cross the end of the input or output buffers are decoded a byte
+	at a time so the data can be streamed in any size chunks.
+
+	Like Burger::DecompressLZSS, matches are read from the previous
+	output, so when decompressing in multiple calls, each call's
+	output buffer must directly follow the previous one.
+
+	To use this format in a Burger::RezFile, register an instance
+	as one of the application codecs and the RezFile will use
+	it for every entry marked with that codec.
+
+	\code
+	Burger::DecompressLZ4 LZ4;
+	RezFile.LogDecompressor(3,&LZ4);
+	\endcode
+
+	\sa Burger::Decompress and Burger::CompressLZ4
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+	Initializes the defaults
+
+***************************************/
+
+Burger::DecompressLZ4::DecompressLZ4() :
+	m_uLength(0),
+	m_uOffset(0),
+	m_uToken(0),
+	m_eState(STATE_TOKEN)
+{
+	m_uSignature = Signature;
+}
+
+/*! ************************************
+
+	\brief Reset the LZ4 decompression
+
+	\return Decompress::DECOMPRESS_OKAY (No error is possible)
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Reset(void)
+{
+	m_uTotalOutput = 0;
+	m_uTotalInput = 0;
+	m_uLength = 0;
+	m_uOffset = 0;
+	m_uToken = 0;
+	m_eState = STATE_TOKEN;
+	return DECOMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Create a new LZ4 decompressor
+
+	\return Pointer to a new reset instance or \ref NULL if out of memory
+	\sa Decompress::Clone(void) const
+
+***************************************/
+
+Burger::Decompress *Burger::DecompressLZ4::Clone(void) const
+{
+	return New<DecompressLZ4>();
+}
+
+/*! ************************************
+
+	\brief Decompress data using LZ4 compression
+
+	Using the LZ4 block format, decompress the data. A match offset
+	that points before the start of the decompressed data returns
+	Decompress::DECOMPRESS_BADINPUT.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa Burger::SimpleDecompressLZ4()
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	m_uInputLength = uInputChunkLength;
+	m_uOutputLength = uOutputChunkLength;
+
+	Word8 *pWork = static_cast<Word8 *>(pOutput);
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	WordPtr uLength = m_uLength;
+	WordPtr uOffset = m_uOffset;
+	Word uToken = m_uToken;
+	eState MyState = m_eState;
+	eError uResult = DECOMPRESS_OKAY;
+	// Bytes output before this call, for checking offsets
+	const WordPtr uHistory = m_uTotalOutput;
+
+	for (;;) {
+		switch (MyState) {
+		case STATE_TOKEN:
+#if defined(LZ4_WIDE)
+			// Decode whole sequences with wide copies while there is
+			// enough room in both buffers for the copies to overrun
+			while ((uInputChunkLength>=LZ4_WIDESLACK) && (uOutputChunkLength>=(LZ4_WIDESLACK*2))) {
+				const Word8 *pEnd = pSource+uInputChunkLength;
+				const Word8 *pNext = pSource;
+				uToken = pNext[0];
+				++pNext;
+				WordPtr uLiterals = uToken>>4U;
+				if (uLiterals==15) {
+					Word uTemp = 0;
+					do {
+						if (pNext>=pEnd) {
+							break;
+						}
+						uTemp = pNext[0];
+						++pNext;
+						uLiterals += uTemp;
+					} while (uTemp==255);
+				}
+				// Room for the literals, the offset and the overrun?
+				if ((static_cast<WordPtr>(pEnd-pNext)<(uLiterals+2+LZ4_WIDESLACK)) ||
+					(uOutputChunkLength<(uLiterals+LZ4_WIDESLACK))) {
+					break;
+				}
+				const Word8 *pLiterals = pNext;
+				pNext += uLiterals;
+				uOffset = static_cast<WordPtr>(pNext[0])|(static_cast<WordPtr>(pNext[1])<<8U);
+				pNext += 2;
+				uLength = uToken&15U;
+				if (uLength==15) {
+					Word uTemp = 0;
+					do {
+						if (pNext>=pEnd) {
+							break;
+						}
+						uTemp = pNext[0];
+						++pNext;
+						uLength += uTemp;
+					} while (uTemp==255);
+				}
+				uLength += 4;
+				// Can the match be copied? Let the byte decoder deal with
+				// the edge cases and the errors
+				if ((pNext>=pEnd) || (uOutputChunkLength<(uLiterals+uLength+LZ4_WIDESLACK)) ||
+					!uOffset || (uOffset>(uHistory+static_cast<WordPtr>(pWork-static_cast<Word8 *>(pOutput))+uLiterals))) {
+					break;
+				}
+
+				// Copy the literals 16 bytes at a time
+				Word8 *pDest = pWork;
+				const Word8 *pLiteralsEnd = pLiterals+uLiterals;
+				do {
+					LZ4Copy16(pDest,pLiterals);
+					pDest += 16;
+					pLiterals += 16;
+				} while (pLiterals<pLiteralsEnd);
+				pDest = pWork+uLiterals;
+
+				// Copy the match, the wide copy can only be used
+				// if the source is outside of the bytes being written
+				const Word8 *pMatch = pDest-uOffset;
+				Word8 *pMatchEnd = pDest+uLength;
+				if (uOffset>=16) {
+					do {
+						LZ4Copy16(pDest,pMatch);
+						pDest += 16;
+						pMatch += 16;
+					} while (pDest<pMatchEnd);
+				} else if (uOffset>=8) {
+					do {
+						LZ4Copy8(pDest,pMatch);
+						pDest += 8;
+						pMatch += 8;
+					} while (pDest<pMatchEnd);
+				} else {
+					// Repeat the pattern until it's at least 8 bytes long
+					WordPtr uStep = uOffset;
+					do {
+						uStep += uOffset;
+					} while (uStep<8);
+					Word8 *pPatternEnd = pDest+uStep;
+					do {
+						pDest[0] = pMatch[0];
+						++pDest;
+						++pMatch;
+					} while (pDest<pPatternEnd);
+					pMatch = pDest-uStep;
+					while (pDest<pMatchEnd) {
+						LZ4Copy8(pDest,pMatch);
+						pDest += 8;
+						pMatch += 8;
+					}
+				}
+				pWork = pMatchEnd;
+				uOutputChunkLength -= uLiterals+uLength;
+				uInputChunkLength -= static_cast<WordPtr>(pNext-pSource);
+				pSource = pNext;
+			}
+#endif
+			if (!uInputChunkLength) {
+				goto Exit;
+			}
+			uToken = pSource[0];
+			++pSource;
+			--uInputChunkLength;
+			uLength = uToken>>4U;
+			if (uLength==15) {
+				MyState = STATE_LITERALLENGTH;
+				break;
+			}
+			MyState = STATE_LITERALS;
+			break;
+
+		case STATE_LITERALLENGTH:
+			{
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				Word uTemp = pSource[0];
+				++pSource;
+				--uInputChunkLength;
+				uLength += uTemp;
+				if (uTemp!=255) {
+					MyState = STATE_LITERALS;
+				}
+			}
+			break;
+
+		case STATE_LITERALS:
+			if (uLength) {
+				WordPtr uCount = uLength;
+				if (uCount>uInputChunkLength) {
+					uCount = uInputChunkLength;
+				}
+				if (uCount>uOutputChunkLength) {
+					uCount = uOutputChunkLength;
+				}
+				if (!uCount) {
+					goto Exit;
+				}
+				MemoryCopy(pWork,pSource,uCount);
+				pWork += uCount;
+				pSource += uCount;
+				uInputChunkLength -= uCount;
+				uOutputChunkLength -= uCount;
+				uLength -= uCount;
+				if (uLength) {
+					goto Exit;
+				}
+			}
+			// The stream can end here
+			MyState = STATE_OFFSET;
+			break;
+
+		case STATE_OFFSET:
+			if (!uInputChunkLength) {
+				goto Exit;
+			}
+			uOffset = pSource[0];
+			++pSource;
+			--uInputChunkLength;
+			MyState = STATE_OFFSET2;
+			break;
+
+		case STATE_OFFSET2:
+			if (!uInputChunkLength) {
+				goto Exit;
+			}
+			uOffset |= static_cast<WordPtr>(pSource[0])<<8U;
+			++pSource;
+			--uInputChunkLength;
+			// Does the match start before the data?
+			if (!uOffset || (uOffset>(uHistory+static_cast<WordPtr>(pWork-static_cast<Word8 *>(pOutput))))) {
+				uResult = DECOMPRESS_BADINPUT;
+				goto Exit;
+			}
+			uLength = uToken&15U;
+			if (uLength==15) {
+				MyState = STATE_MATCHLENGTH;
+				break;
+			}
+			uLength += 4;
+			MyState = STATE_MATCH;
+			break;
+
+		case STATE_MATCHLENGTH:
+			{
+				if (!uInputChunkLength) {
+					goto Exit;
+				}
+				Word uTemp = pSource[0];
+				++pSource;
+				--uInputChunkLength;
+				uLength += uTemp;
+				if (uTemp!=255) {
+					uLength += 4;
+					MyState = STATE_MATCH;
+				}
+			}
+			break;
+
+		case STATE_MATCH:
+			{
+				WordPtr uCount = uLength;
+				if (uCount>uOutputChunkLength) {
+					uCount = uOutputChunkLength;
+				}
+				if (!uCount) {
+					goto Exit;
+				}
+				uOutputChunkLength -= uCount;
+				uLength -= uCount;
+				// The source may overlap the destination, so copy a byte at a time
+				const Word8 *pMatch = pWork-uOffset;
+				do {
+					pWork[0] = pMatch[0];
+					++pWork;
+					++pMatch;
+				} while (--uCount);
+				if (uLength) {
+					goto Exit;
+				}
+				MyState = STATE_TOKEN;
+			}
+			break;
+		}
+	}
+Exit:
+	m_uLength = uLength;
+	m_uOffset = uOffset;
+	m_uToken = uToken;
+	m_eState = MyState;
+
+	// How did the decompression go?
+
+	m_uOutputLength -= uOutputChunkLength;
+	m_uInputLength -= uInputChunkLength;
+	m_uTotalOutput += m_uOutputLength;
+	m_uTotalInput += m_uInputLength;
+	if (uResult!=DECOMPRESS_OKAY) {
+		return uResult;
+	}
+	// Output buffer not big enough?
+	if (uOutputChunkLength) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+
+	// Input data remaining or a sequence was cut short?
+	if (uInputChunkLength || ((MyState!=STATE_TOKEN) && (MyState!=STATE_OFFSET))) {
+		return DECOMPRESS_OUTPUTOVERRUN;
+	}
+	// Decompression is complete
+	return DECOMPRESS_OKAY;
+}
+
+/***************************************
+
+	Decompress using LZ4.
+	I assume I can decompress in one pass.
+	This makes for fast and tight code.
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	Burger::DecompressLZ4 Local;
+	Local.DecompressLZ4::Reset();
+	return Local.DecompressLZ4::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+}
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::DecompressLZ4::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
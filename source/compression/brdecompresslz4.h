@@ -0,0 +1,55 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDECOMPRESSLZ4_H__
+#define __BRDECOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRDECOMPRESS_H__
+#include "brdecompress.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class DecompressLZ4 : public Decompress {
+	BURGER_RTTI_IN_CLASS();
+protected:
+	enum eState {
+		STATE_TOKEN,			///< Start of a sequence
+		STATE_LITERALLENGTH,	///< Reading the extra bytes of the literal length
+		STATE_LITERALS,			///< Copying literals
+		STATE_OFFSET,			///< Get the low byte of the match offset
+		STATE_OFFSET2,			///< Get the high byte of the match offset
+		STATE_MATCHLENGTH,		///< Reading the extra bytes of the match length
+		STATE_MATCH				///< Memory copy in progress
+	};
+	WordPtr m_uLength;		///< Bytes remaining in the literal or match copy
+	WordPtr m_uOffset;		///< Distance back to the match data
+	Word m_uToken;			///< Token of the current sequence
+	eState m_eState;		///< State of the decompression
+public:
+	static const Word32 Signature = 0x4C5A3420;		///< 'LZ4 '
+	DecompressLZ4();
+	virtual eError Reset(void);
+	virtual eError Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+	virtual Decompress *Clone(void) const;
+};
+extern Decompress::eError BURGER_API SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+}
+/* END */
+
+#endif
+
@@ -12,6 +12,7 @@
 ***************************************/
 
 #include "brdecompresslzss.h"
+#include "brglobalmemorymanager.h"
 
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
@@ -24,6 +25,9 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
 	
 	Decompress data in LZSS format (Documented here Burger::CompressLZSS )
 
+	Data compressed with Burger::CompressLZSS::SetLargeWindow(\ref TRUE)
+	needs SetLargeWindow(\ref TRUE) to be called before decompression.
+
 	\sa Burger::Decompress and Burger::CompressLZSS
 
 ***************************************/
@@ -38,7 +42,8 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::DecompressLZSS,Burger::Decompress);
 
 Burger::DecompressLZSS::DecompressLZSS() :
 	m_uBitBucket(1),
-	m_eState(STATE_INIT)
+	m_eState(STATE_INIT),
+	m_bLargeWindow(FALSE)
 {
 	m_uSignature = Signature;
 }
@@ -60,6 +65,52 @@ Burger::Decompress::eError Burger::DecompressLZSS::Reset(void)
 	return DECOMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Create a new LZSS decompressor
+
+	\return Pointer to a new reset instance or \ref NULL if out of memory
+	\sa Decompress::Clone(void) const
+
+***************************************/
+
+Burger::Decompress *Burger::DecompressLZSS::Clone(void) const
+{
+	DecompressLZSS *pResult = New<DecompressLZSS>();
+	if (pResult) {
+		pResult->SetLargeWindow(m_bLargeWindow);
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Select the large window format
+
+	Only change the format before any data is decompressed.
+
+	\param bLargeWindow \ref TRUE for data compressed with
+		Burger::CompressLZSS::SetLargeWindow(\ref TRUE)
+	\sa GetLargeWindow(void) const
+
+***************************************/
+
+void Burger::DecompressLZSS::SetLargeWindow(Word bLargeWindow)
+{
+	m_bLargeWindow = (bLargeWindow!=0);
+	m_uSignature = m_bLargeWindow ? SignatureLargeWindow : Signature;
+}
+
+/*! ************************************
+
+	\fn Word Burger::DecompressLZSS::GetLargeWindow(void) const
+	\brief Return \ref TRUE if the large window format is decompressed
+
+	\return \ref TRUE if the large window format is in use
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Decompress data using LZSS compression
@@ -78,6 +129,9 @@ Burger::Decompress::eError Burger::DecompressLZSS::Reset(void)
 
 Burger::Decompress::eError Burger::DecompressLZSS::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	if (m_bLargeWindow) {
+		return ProcessLargeWindow(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+	}
 	m_uInputLength = uInputChunkLength;
 	m_uOutputLength = uOutputChunkLength;
 
@@ -261,6 +315,149 @@ Exit:
 	return DECOMPRESS_OKAY;
 }
 
+/*! ************************************
+
+	\brief Decompress data using the LZSS large window format
+
+	Called by Process() when the large window format is selected.
+	Tokens are a 16 bit distance minus one and an 8 bit length minus 3.
+	A distance that points before the start of the decompressed data
+	returns Decompress::DECOMPRESS_BADINPUT.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa SetLargeWindow(Word)
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZSS::ProcessLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	m_uInputLength = uInputChunkLength;
+	m_uOutputLength = uOutputChunkLength;
+
+	Word8 *pWork = static_cast<Word8 *>(pOutput);
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	Word uBitBucket = m_uBitBucket;
+	WordPtr uRunCount = m_uRunCount;
+	WordPtr uOffset = m_uOffset;
+	eState MyState = m_eState;
+	eError uResult = DECOMPRESS_OKAY;
+	// Bytes output before this call, for checking distances
+	const WordPtr uHistory = m_uTotalOutput;
+
+	for (;;) {
+		if (MyState==STATE_INIT) {
+			if (uBitBucket==1) {
+				// No input?
+				if (!uInputChunkLength) {
+					break;
+				}
+				// Grab the next bit bucket
+				uBitBucket = static_cast<Word>(pSource[0])|0x100U;
+				++pSource;
+				--uInputChunkLength;
+			}
+			// No data to fetch?
+			if (!uInputChunkLength) {
+				break;
+			}
+			if (uBitBucket&1U) {
+				if (!uOutputChunkLength) {
+					break;
+				}
+				// Copy a byte
+				pWork[0] = pSource[0];
+				++pSource;
+				++pWork;
+				--uInputChunkLength;
+				--uOutputChunkLength;
+				uBitBucket>>=1;
+				continue;
+			}
+			// Low byte of the distance
+			uRunCount = pSource[0];
+			++pSource;
+			--uInputChunkLength;
+			MyState = STATE_16BIT2;
+		}
+		if (MyState==STATE_16BIT2) {
+			if (!uInputChunkLength) {
+				break;
+			}
+			// Distance is stored minus one
+			WordPtr uDistance = (uRunCount|(static_cast<WordPtr>(pSource[0])<<8U))+1;
+			// Does the match start before the data?
+			if (uDistance>(uHistory+static_cast<WordPtr>(pWork-static_cast<Word8 *>(pOutput)))) {
+				uResult = DECOMPRESS_BADINPUT;
+				break;
+			}
+			++pSource;
+			--uInputChunkLength;
+			// Make it negative
+			uOffset = static_cast<WordPtr>(0)-uDistance;
+			MyState = STATE_LENGTH;
+		}
+		if (MyState==STATE_LENGTH) {
+			if (!uInputChunkLength) {
+				break;
+			}
+			uRunCount = static_cast<WordPtr>(pSource[0])+3;
+			++pSource;
+			--uInputChunkLength;
+			MyState = STATE_RUN;
+		}
+		// Copy the run, the source may overlap
+		WordPtr uCount = uRunCount;
+		if (uCount>uOutputChunkLength) {
+			uCount = uOutputChunkLength;
+		}
+		uRunCount -= uCount;
+		uOutputChunkLength -= uCount;
+		if (uCount) {
+			const Word8 *pMatch = pWork+uOffset;
+			do {
+				pWork[0] = pMatch[0];
+				++pWork;
+				++pMatch;
+			} while (--uCount);
+		}
+		if (uRunCount) {
+			break;
+		}
+		uBitBucket>>=1;
+		MyState = STATE_INIT;
+	}
+	m_uBitBucket = uBitBucket;
+	m_uRunCount = uRunCount;
+	m_uOffset = uOffset;
+	m_eState = MyState;
+
+	// How did the decompression go?
+
+	m_uOutputLength -= uOutputChunkLength;
+	m_uInputLength -= uInputChunkLength;
+	m_uTotalOutput += m_uOutputLength;
+	m_uTotalInput += m_uInputLength;
+	if (uResult!=DECOMPRESS_OKAY) {
+		return uResult;
+	}
+	// Output buffer not big enough?
+	if (uOutputChunkLength) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+
+	// Input data remaining or a token is incomplete?
+	if (uInputChunkLength || (MyState!=STATE_INIT)) {
+		return DECOMPRESS_OUTPUTOVERRUN;
+	}
+	// Decompression is complete
+	return DECOMPRESS_OKAY;
+}
+
 /***************************************
 
 	Decompress using LZSS.
@@ -30,17 +30,24 @@ protected:
 	enum eState {
 		STATE_INIT,			///< Start of a compression token	
 		STATE_16BIT2,		///< Grab the 2nd half of a 16 bit run token
-		STATE_RUN			///< Memory copy in progress
+		STATE_RUN,			///< Memory copy in progress
+		STATE_LENGTH		///< Grab the length byte of a large window token
 	};
 	WordPtr m_uRunCount;	///< Previous 16 bit token (Half)
 	WordPtr m_uOffset;		///< Previous destination pointer
 	Word m_uBitBucket;		///< Previous bit bucket
 	eState m_eState;		///< State of the decompression
+	Word m_bLargeWindow;	///< \ref TRUE if the data uses the large window format
+	eError ProcessLargeWindow(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 public:
 	static const Word32 Signature = 0x4C5A5353;		///< 'LZSS'
+	static const Word32 SignatureLargeWindow = 0x4C5A534C;	///< 'LZSL'
 	DecompressLZSS();
 	virtual eError Reset(void);
 	virtual eError Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+	virtual Decompress *Clone(void) const;
+	void SetLargeWindow(Word bLargeWindow);
+	BURGER_INLINE Word GetLargeWindow(void) const { return m_bLargeWindow; }
 };
 extern Decompress::eError BURGER_API SimpleDecompressLZSS(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
 }
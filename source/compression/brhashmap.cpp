@@ -16,6 +16,7 @@
 #include "brhashmap.h"
 #include "brsdbmhash.h"
 #include "brdjb2hash.h"
+#include "brxxhash.h"
 #include "brglobalmemorymanager.h"
 #include "brstringfunctions.h"
 #include "brstring.h"
@@ -172,6 +173,97 @@ WordPtr BURGER_API Burger::DJB2StringHashXorCaseFunctor(const void *pData,WordPt
 	return DJB2HashXorCase(static_cast<const String *>(pData)->GetPtr(),static_cast<const String *>(pData)->GetLength());
 }
 
+//
+// Fit a 64 bit hash into a WordPtr
+//
+
+static BURGER_INLINE WordPtr FoldHash(Word64 uHash)
+{
+#if defined(BURGER_64BITCPU)
+	return static_cast<WordPtr>(uHash);
+#else
+	return static_cast<WordPtr>(uHash^(uHash>>32U));
+#endif
+}
+
+/*! ************************************
+
+	\brief xxHash64 hash callback for HashMapShared
+
+	Invoke the xxHash64 hashing algorithm on the contents of a class
+	using the default seed value. This is the default hash for HashMap.
+
+	On 32 bit CPUs, the upper and lower 32 bits are combined.
+
+	\param pData Pointer to a data chunk to hash
+	\param uDataSize Size of the data chunk in bytes
+	\return WordPtr wide hash of the class
+	\sa XXHash64CaseFunctor(), HashMapShared or XXHash64()
+
+***************************************/
+
+WordPtr BURGER_API Burger::XXHash64Functor(const void *pData,WordPtr uDataSize)
+{
+	return FoldHash(XXHash64(pData,uDataSize));
+}
+
+/*! ************************************
+
+	\brief Case insensitive xxHash64 hash callback for HashMapShared
+
+	Invoke the xxHash64 hashing algorithm on the contents of a class
+	using the default seed value and convert all upper case characters into lower case.
+
+	\param pData Pointer to a data chunk to hash
+	\param uDataSize Size of the data chunk in bytes
+	\return WordPtr wide hash of the class
+	\sa XXHash64Functor(), HashMapShared or XXHash64Case()
+
+***************************************/
+
+WordPtr BURGER_API Burger::XXHash64CaseFunctor(const void *pData,WordPtr uDataSize)
+{
+	return FoldHash(XXHash64Case(pData,uDataSize));
+}
+
+/*! ************************************
+
+	\brief xxHash64 hash callback for HashMapString
+
+	Invoke the xxHash64 hashing algorithm on the contents of 
+	a \ref String class using the default seed value.
+
+	\param pData Pointer to a \ref String to hash
+	\param uDataSize Size of the data chunk in bytes (Not used)
+	\return WordPtr wide hash of the class
+	\sa XXHash64StringCaseFunctor(), HashMapString or XXHash64()
+
+***************************************/
+
+WordPtr BURGER_API Burger::XXHash64StringFunctor(const void *pData,WordPtr /* uDataSize */)
+{
+	return FoldHash(XXHash64(static_cast<const String *>(pData)->GetPtr(),static_cast<const String *>(pData)->GetLength()));
+}
+
+/*! ************************************
+
+	\brief Case insensitive xxHash64 hash callback for HashMapStringCase
+
+	Invoke the case insensitive xxHash64 hashing algorithm on the contents of 
+	a \ref String class using the default seed value.
+
+	\param pData Pointer to a \ref String to hash with case insensitivity
+	\param uDataSize Size of the data chunk in bytes (Not used)
+	\return WordPtr wide hash of the class
+	\sa XXHash64StringFunctor(), HashMapStringCase or XXHash64Case()
+
+***************************************/
+
+WordPtr BURGER_API Burger::XXHash64StringCaseFunctor(const void *pData,WordPtr /* uDataSize */)
+{
+	return FoldHash(XXHash64Case(static_cast<const String *>(pData)->GetPtr(),static_cast<const String *>(pData)->GetLength()));
+}
+
 /*! ************************************
 
 	\class Burger::HashMapShared::Entry
@@ -1099,6 +1191,10 @@ void BURGER_API Burger::HashMapShared::SetCapacity(WordPtr uNewSize)
 	based class, from a code point of view, HashMap
 	is a dispatcher to HashMapShared.
 
+	\note The default hash is XXHash64Functor(). Iteration order
+	depends on the hash function and is not stable across versions
+	of Burgerlib, so don't save or compare data that relies on it.
+
 	\sa HashMapShared
 
 ***************************************/
@@ -1554,7 +1650,10 @@ void BURGER_API Burger::HashMapShared::SetCapacity(WordPtr uNewSize)
 	\note String hashing is case sensitive. For case insensitive
 	hashing, use HashMapStringCase
 
-	\sa DJB2StringHashXorFunctor, HashMapShared, HashMap or HashMapStringCase
+	\note Iteration order follows the hash of each String, which is
+	XXHash64StringFunctor() by default. It may change between versions.
+
+	\sa XXHash64StringFunctor, HashMapShared, HashMap or HashMapStringCase
 
 ***************************************/
 
@@ -1568,7 +1667,7 @@ void BURGER_API Burger::HashMapShared::SetCapacity(WordPtr uNewSize)
 	\note String hashing is case sensitive. For case insensitive
 	hashing, use HashMapStringCase
 
-	\sa DJB2StringHashXorFunctor or HashMapStringCase
+	\sa XXHash64StringFunctor or HashMapStringCase
 
 ***************************************/
 
@@ -1612,7 +1711,10 @@ Word BURGER_API Burger::HashMapStringCaseTest(const void *pA,const void *pB)
 	\note String hashing is case insensitive. For case sensitive
 	hashing, use HashMapString
 
-	\sa DJB2StringHashXorCaseFunctor, HashMapStringCaseTest(const void *,const void *),
+	\note As with HashMapString, don't rely on the iteration order,
+	it changes if the default hash function changes.
+
+	\sa XXHash64StringCaseFunctor, HashMapStringCaseTest(const void *,const void *),
 		HashMapShared, HashMap or HashMapString
 
 ***************************************/
@@ -1627,6 +1729,6 @@ Word BURGER_API Burger::HashMapStringCaseTest(const void *pA,const void *pB)
 	\note String hashing is case insensitive. For case sensitive
 	hashing, use HashMapString
 
-	\sa DJB2StringHashXorCaseFunctor or HashMapString
+	\sa XXHash64StringCaseFunctor or HashMapString
 
 ***************************************/
\ No newline at end of file
@@ -38,6 +38,10 @@ extern WordPtr BURGER_API DJB2HashXorFunctor(const void *pData,WordPtr uDataSize
 extern WordPtr BURGER_API DJB2HashXorCaseFunctor(const void *pData,WordPtr uDataSize);
 extern WordPtr BURGER_API DJB2StringHashXorFunctor(const void *pData,WordPtr uDataSize);
 extern WordPtr BURGER_API DJB2StringHashXorCaseFunctor(const void *pData,WordPtr uDataSize);
+extern WordPtr BURGER_API XXHash64Functor(const void *pData,WordPtr uDataSize);
+extern WordPtr BURGER_API XXHash64CaseFunctor(const void *pData,WordPtr uDataSize);
+extern WordPtr BURGER_API XXHash64StringFunctor(const void *pData,WordPtr uDataSize);
+extern WordPtr BURGER_API XXHash64StringCaseFunctor(const void *pData,WordPtr uDataSize);
 
 class HashMapShared {
 protected:
@@ -74,7 +78,7 @@ protected:
 	HashMapShared(WordPtr uEntrySize,WordPtr uFirstSize,WordPtr uSecondOffset,
 		TestProc pTestFunction,EntryConstructProc pEntryConstructFunction,
 		EntryCopyProc pEntryCopyFunction,EntryInvalidateProc pEntryInvalidationFunction,
-		HashProc pHashFunction=SDBMHashFunctor) : 
+		HashProc pHashFunction=XXHash64Functor) : 
 		m_pEntries(NULL),
 		m_uEntrySize(uEntrySize),
 		m_uFirstSize(uFirstSize),
@@ -166,7 +170,7 @@ class HashMap : public HashMapShared {
 	}
 	static Word BURGER_API EqualsTest(const void *pA,const void *pB) { return static_cast<const T *>(pA)[0] == static_cast<const T *>(pB)[0]; }
 public:
-	HashMap(HashProc pHashFunction = SDBMHashFunctor) : 
+	HashMap(HashProc pHashFunction = XXHash64Functor) : 
 		HashMapShared(sizeof(Entry),sizeof(T),BURGER_OFFSETOF(Entry,second),
 		EqualsTest,Construct,Copy,Invalidate,pHashFunction) { }
 	HashMap(HashProc pHashFunction,TestProc pTestProc) : 
@@ -261,13 +265,13 @@ public:
 
 template<class U>
 class HashMapString : public HashMap<String,U > {
-public: HashMapString() : HashMap<String,U >(DJB2StringHashXorFunctor) {}
+public: HashMapString() : HashMap<String,U >(XXHash64StringFunctor) {}
 };
 
 extern Word BURGER_API HashMapStringCaseTest(const void *pA,const void *pB);
 template<class U>
 class HashMapStringCase : public HashMap<String,U > {
-public: HashMapStringCase() : HashMap<String,U >(DJB2StringHashXorCaseFunctor,HashMapStringCaseTest) {}
+public: HashMapStringCase() : HashMap<String,U >(XXHash64StringCaseFunctor,HashMapStringCaseTest) {}
 };
 
 }
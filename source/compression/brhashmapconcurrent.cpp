@@ -0,0 +1,221 @@
+/***************************************
+
+	Sharded HashMap template for multi-threaded access
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brhashmapconcurrent.h"
+#include "brtick.h"
+
+/*! ************************************
+
+	\class Burger::HashMapConcurrentShared
+	\brief Base class for HashMapConcurrent
+
+	Contains the shard lock and the shard selection code that
+	doesn't depend on the key and data types.
+
+	\sa HashMapConcurrent
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapConcurrentShared::ShardLock
+	\brief Reader/writer spin lock for a single shard
+
+	Any number of readers can hold the lock at the same time, a
+	writer has exclusive access. Acquiring a read lock that isn't
+	contested is a single atomic compare and swap, no operating
+	system call is made.
+
+	A writer that is waiting sets a pending flag which blocks any new
+	readers so a steady stream of readers can't starve the writer.
+
+	\note This lock is not recursive. Don't take a write lock while
+		holding a read lock on the same shard.
+
+	\sa HashMapConcurrent
+
+***************************************/
+
+//
+// Spin a short while before giving up the time slice
+//
+
+static void BURGER_API ShardLockWait(Word *pSpinCount)
+{
+	Word uSpinCount = pSpinCount[0];
+	if (uSpinCount<64) {
+		pSpinCount[0] = uSpinCount+1;
+	} else {
+		Burger::Sleep(Burger::SLEEP_YIELD);
+	}
+}
+
+/*! ************************************
+
+	\brief Acquire a read lock
+
+	Wait until no writer owns or is waiting for the lock
+	and increment the reader count.
+
+	\sa UnlockRead(void) or LockWrite(void)
+
+***************************************/
+
+void BURGER_API Burger::HashMapConcurrentShared::ShardLock::LockRead(void)
+{
+	Word uSpinCount = 0;
+	for (;;) {
+		Word32 uState = m_uState;
+		if (!(uState&(WRITER|PENDING))) {
+			if (AtomicSetIfMatch(&m_uState,uState,uState+1)) {
+				break;
+			}
+		} else {
+			if (!uSpinCount) {
+				AtomicPreIncrement(&m_uContentionCount);
+			}
+			ShardLockWait(&uSpinCount);
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Acquire a write lock
+
+	If the lock is free, take it immediately. If readers own the lock,
+	mark the lock as pending so no new readers can enter and wait for
+	the existing readers to leave.
+
+	\sa UnlockWrite(void) or LockRead(void)
+
+***************************************/
+
+void BURGER_API Burger::HashMapConcurrentShared::ShardLock::LockWrite(void)
+{
+	Word uSpinCount = 0;
+	for (;;) {
+		Word32 uState = m_uState;
+		if (!uState) {
+			if (AtomicSetIfMatch(&m_uState,0,WRITER)) {
+				break;
+			}
+		} else if (!(uState&(WRITER|PENDING))) {
+			// Readers own the lock, block new readers
+			if (AtomicSetIfMatch(&m_uState,uState,uState|PENDING)) {
+				if (!uSpinCount) {
+					AtomicPreIncrement(&m_uContentionCount);
+				}
+				// Wait for the readers to leave
+				while (m_uState!=PENDING) {
+					ShardLockWait(&uSpinCount);
+				}
+				AtomicSwap(&m_uState,WRITER);
+				break;
+			}
+		} else {
+			// Another writer has the lock
+			if (!uSpinCount) {
+				AtomicPreIncrement(&m_uContentionCount);
+			}
+			ShardLockWait(&uSpinCount);
+		}
+	}
+}
+
+/*! ************************************
+
+	\fn void Burger::HashMapConcurrentShared::ShardLock::UnlockRead(void)
+	\brief Release a read lock
+
+	\sa LockRead(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::HashMapConcurrentShared::ShardLock::UnlockWrite(void)
+	\brief Release a write lock
+
+	\sa LockWrite(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::HashMapConcurrentShared::ShardLock::GetContentionCount(void) const
+	\brief Return the number of times a lock request had to wait
+
+	\return Number of contested lock requests
+	\sa ResetContentionCount(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::HashMapConcurrentShared::GetShardHash(const void *pKey,WordPtr uKeySize) const
+	\brief Hash a key for shard selection
+
+	The HashMap inside each shard indexes with the low bits of
+	the same hash, so the shard is selected with the middle bits
+	of the hash multiplied by the golden ratio.
+
+	\param pKey Pointer to the key
+	\param uKeySize Size of the key in bytes
+	\return Value to select a shard with
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapConcurrent
+	\brief HashMap for use by multiple threads
+
+	The keys are split across a fixed number of shards, each with its
+	own HashMap and reader/writer lock. Threads that access different
+	shards never wait on each other and lookups in the same shard
+	run in parallel.
+
+	Since another thread can change an entry at any time, lookups
+	copy the data out while the lock is held instead of returning a
+	pointer into the HashMap.
+
+	\tparam T Key type
+	\tparam U Data type
+	\tparam uShardCount Number of shards, a power of 2 is the fastest
+	\tparam Map HashMap class used for each shard
+
+	\sa HashMap, HashMapConcurrentString or HashMapConcurrentShared::ShardLock
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapConcurrentString
+	\brief String key / data pair HashMap for use by multiple threads
+
+	\note String hashing is case sensitive. For case insensitive
+	hashing, use HashMapConcurrentStringCase
+
+	\sa HashMapConcurrent or HashMapString
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapConcurrentStringCase
+	\brief Case insensitive String key / data pair HashMap for use by multiple threads
+
+	\sa HashMapConcurrent or HashMapStringCase
+
+***************************************/
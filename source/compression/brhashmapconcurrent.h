@@ -0,0 +1,178 @@
+/***************************************
+
+	Sharded HashMap template for multi-threaded access
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRHASHMAPCONCURRENT_H__
+#define __BRHASHMAPCONCURRENT_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRHASHMAP_H__
+#include "brhashmap.h"
+#endif
+
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class HashMapConcurrentShared {
+	BURGER_DISABLECOPYCONSTRUCTORS(HashMapConcurrentShared);
+public:
+	typedef WordPtr (BURGER_API *HashProc)(const void *pData,WordPtr uDataSize);	///< Function prototype for user supplied hash generator
+	enum {
+		DEFAULTSHARDCOUNT=16,		///< Default number of shards
+		CACHELINESIZE=64			///< Size of a cache line, shards are padded to prevent false sharing
+	};
+	class ShardLock {
+		BURGER_DISABLECOPYCONSTRUCTORS(ShardLock);
+		enum {
+			WRITER=0x80000000U,		///< Set when a writer owns the lock
+			PENDING=0x40000000U,	///< Set when a writer is waiting for the readers to leave
+			READERMASK=0x3FFFFFFFU	///< Mask for the count of readers
+		};
+		volatile Word32 m_uState;		///< Reader count and writer flags
+		volatile Word32 m_uContentionCount;	///< Number of times a writer or reader had to wait
+	public:
+		ShardLock() : m_uState(0),m_uContentionCount(0) {}
+		void BURGER_API LockRead(void);
+		BURGER_INLINE void UnlockRead(void) { AtomicPreDecrement(&m_uState); }
+		void BURGER_API LockWrite(void);
+		BURGER_INLINE void UnlockWrite(void) { AtomicSwap(&m_uState,0); }
+		BURGER_INLINE Word32 GetContentionCount(void) const { return m_uContentionCount; }
+		BURGER_INLINE void ResetContentionCount(void) { m_uContentionCount = 0; }
+	};
+protected:
+	HashProc m_pHashFunction;	///< Pointer to the hash function used to select a shard
+	HashMapConcurrentShared(HashProc pHashFunction) : m_pHashFunction(pHashFunction) {}
+	BURGER_INLINE Word32 GetShardHash(const void *pKey,WordPtr uKeySize) const
+	{
+		// The HashMap in the shard uses the low bits, so use the high bits of a multiply
+		return (static_cast<Word32>(m_pHashFunction(pKey,uKeySize))*0x9E3779B9U)>>16U;
+	}
+};
+
+template<class T,class U,Word uShardCount=HashMapConcurrentShared::DEFAULTSHARDCOUNT,class Map=HashMap<T,U> >
+class HashMapConcurrent : public HashMapConcurrentShared {
+	BURGER_DISABLECOPYCONSTRUCTORS(HashMapConcurrent);
+	struct Shard_t {
+		ShardLock m_Lock;			///< Reader/writer lock for this shard
+		Map m_HashMap;				///< Hash for the keys that belong to this shard
+		Word8 m_Padding[CACHELINESIZE-((sizeof(ShardLock)+sizeof(Map))%CACHELINESIZE)];	///< Keep shards on different cache lines
+	};
+	Shard_t m_Shards[uShardCount];	///< Array of shards
+	BURGER_INLINE Shard_t *GetShard(const T &rKey) { return &m_Shards[GetShardHash(&rKey,sizeof(T))%uShardCount]; }
+public:
+	HashMapConcurrent(HashProc pHashFunction=XXHash64Functor) : HashMapConcurrentShared(pHashFunction) {}
+	void Set(const T &rKey,const U &rValue)
+	{
+		Shard_t *pShard = GetShard(rKey);
+		pShard->m_Lock.LockWrite();
+		pShard->m_HashMap.Set(rKey,rValue);
+		pShard->m_Lock.UnlockWrite();
+	}
+	Word Insert(const T &rKey,const U &rValue)
+	{
+		Shard_t *pShard = GetShard(rKey);
+		pShard->m_Lock.LockWrite();
+		Word uResult = FALSE;
+		if (!pShard->m_HashMap.GetData(rKey)) {
+			pShard->m_HashMap.add(rKey,rValue);
+			uResult = TRUE;
+		}
+		pShard->m_Lock.UnlockWrite();
+		return uResult;
+	}
+	Word GetData(const T &rKey,U *pOutput)
+	{
+		Shard_t *pShard = GetShard(rKey);
+		pShard->m_Lock.LockRead();
+		Word uResult = static_cast<const Map *>(&pShard->m_HashMap)->GetData(rKey,pOutput);
+		pShard->m_Lock.UnlockRead();
+		return uResult;
+	}
+	Word IsPresent(const T &rKey)
+	{
+		Shard_t *pShard = GetShard(rKey);
+		pShard->m_Lock.LockRead();
+		Word uResult = static_cast<const Map *>(&pShard->m_HashMap)->GetData(rKey)!=NULL;
+		pShard->m_Lock.UnlockRead();
+		return uResult;
+	}
+	Word Erase(const T &rKey)
+	{
+		Shard_t *pShard = GetShard(rKey);
+		pShard->m_Lock.LockWrite();
+		typename Map::iterator it = pShard->m_HashMap.find(rKey);
+		Word uResult = !it.IsEnd();
+		if (uResult) {
+			pShard->m_HashMap.erase(it);
+		}
+		pShard->m_Lock.UnlockWrite();
+		return uResult;
+	}
+	void Clear(void)
+	{
+		Word i = 0;
+		do {
+			m_Shards[i].m_Lock.LockWrite();
+			m_Shards[i].m_HashMap.Clear();
+			m_Shards[i].m_Lock.UnlockWrite();
+		} while (++i<uShardCount);
+	}
+	WordPtr GetEntryCount(void)
+	{
+		WordPtr uResult = 0;
+		Word i = 0;
+		do {
+			m_Shards[i].m_Lock.LockRead();
+			uResult += m_Shards[i].m_HashMap.GetEntryCount();
+			m_Shards[i].m_Lock.UnlockRead();
+		} while (++i<uShardCount);
+		return uResult;
+	}
+	Word32 GetContentionCount(void) const
+	{
+		Word32 uResult = 0;
+		Word i = 0;
+		do {
+			uResult += m_Shards[i].m_Lock.GetContentionCount();
+		} while (++i<uShardCount);
+		return uResult;
+	}
+	void ResetContentionCount(void)
+	{
+		Word i = 0;
+		do {
+			m_Shards[i].m_Lock.ResetContentionCount();
+		} while (++i<uShardCount);
+	}
+	BURGER_INLINE static Word GetShardCount(void) { return uShardCount; }
+};
+
+template<class U,Word uShardCount=HashMapConcurrentShared::DEFAULTSHARDCOUNT>
+class HashMapConcurrentString : public HashMapConcurrent<String,U,uShardCount,HashMapString<U> > {
+public: HashMapConcurrentString() : HashMapConcurrent<String,U,uShardCount,HashMapString<U> >(XXHash64StringFunctor) {}
+};
+
+template<class U,Word uShardCount=HashMapConcurrentShared::DEFAULTSHARDCOUNT>
+class HashMapConcurrentStringCase : public HashMapConcurrent<String,U,uShardCount,HashMapStringCase<U> > {
+public: HashMapConcurrentStringCase() : HashMapConcurrent<String,U,uShardCount,HashMapStringCase<U> >(XXHash64StringCaseFunctor) {}
+};
+
+}
+/* END */
+
+#endif
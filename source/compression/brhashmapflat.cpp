@@ -0,0 +1,379 @@
+/***************************************
+
+	Open addressing HashMap template for mapping a key to data
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brhashmapflat.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\struct Burger::HashMapFlatHash
+	\brief Default hash functor for HashMapFlat
+
+	Hashes the raw bytes of the key with XXHash64(). Integer and
+	pointer keys are specialized to return the key itself since
+	HashMapFlat will mix the bits of the returned value.
+
+	A custom hash functor needs to be a class with a const
+	operator() that accepts the key and returns a \ref WordPtr.
+
+	\sa HashMapFlat or HashMapFlatEqual
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::HashMapFlatEqual
+	\brief Default equality functor for HashMapFlat
+
+	Compares two keys with operator==().
+
+	\sa HashMapFlat or HashMapFlatHash
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::HashMapFlatStringHash
+	\brief String hash functor for HashMapFlatString
+
+	Hashes the contents of a String with XXHash64().
+
+	\sa HashMapFlatString or HashMapFlatStringCaseHash
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::HashMapFlatStringCaseHash
+	\brief Case insensitive String hash functor for HashMapFlatStringCase
+
+	Hashes the contents of a String with XXHash64Case().
+
+	\sa HashMapFlatStringCase or HashMapFlatStringCaseEqual
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::HashMapFlatStringCaseEqual
+	\brief Case insensitive String equality functor for HashMapFlatStringCase
+
+	Compares two String classes with StringCaseCompare().
+
+	\sa HashMapFlatStringCase or HashMapFlatStringCaseHash
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapFlatShared
+	\brief Base class for HashMapFlat
+
+	HashMapFlat stores its entries directly in an array and resolves
+	collisions by probing the array instead of chaining. A parallel
+	array of control bytes holds one byte per entry. The byte is either
+	\ref CONTROL_EMPTY, \ref CONTROL_DELETED or 7 bits of the hash
+	of the key stored in the entry.
+
+	Lookups test \ref GROUPSIZE control bytes at a time. On CPUs with
+	SSE2 this is a single compare, so most keys that aren't a match
+	are rejected without touching the entry array. The first \ref GROUPSIZE
+	control bytes are mirrored after the end of the control array so
+	a group can be loaded from any index without wrapping.
+
+	This class contains the code that doesn't depend on the
+	key and data types.
+
+	\note This class is not intended to be directly used,
+		it's intended to be derived by HashMapFlat
+
+	\sa HashMapFlat or HashMapShared
+
+***************************************/
+
+/*! ************************************
+
+	\brief Control bytes for a HashMapFlatShared with no memory
+
+	A newly constructed hash points to this group so lookups
+	don't need to test for a \ref NULL pointer.
+
+***************************************/
+
+const Word8 BURGER_ALIGN(Burger::HashMapFlatShared::g_EmptyGroup[Burger::HashMapFlatShared::GROUPSIZE],16) = {
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY,
+	Burger::HashMapFlatShared::CONTROL_EMPTY,Burger::HashMapFlatShared::CONTROL_EMPTY
+};
+
+/*! ************************************
+
+	\brief Allocate an empty table
+
+	Allocate the control bytes and the entry array in a single
+	block of memory and mark every entry as \ref CONTROL_EMPTY.
+	The previous buffer is not released, the caller is responsible
+	for that.
+
+	\param uCount Number of entries to allocate (Must be a power of 2 and at least \ref MINIMUMSIZE)
+	\param uSlotSize Size in bytes of each entry
+	\sa ReleaseBuffer(void) or DisposeBuffer(Word8 *)
+
+***************************************/
+
+void BURGER_API Burger::HashMapFlatShared::CreateBuffer(WordPtr uCount,WordPtr uSlotSize)
+{
+	BURGER_ASSERT((uCount>=MINIMUMSIZE) && !(uCount&(uCount-1)));
+	// The control array size is a multiple of 16, so the entries are aligned
+	WordPtr uControlSize = uCount+GROUPSIZE;
+	Word8 *pControl = static_cast<Word8 *>(Alloc(uControlSize+(uCount*uSlotSize)));
+	BURGER_ASSERT(pControl);
+	MemoryFill(pControl,CONTROL_EMPTY,uControlSize);
+	m_pControl = pControl;
+	m_pSlots = pControl+uControlSize;
+	m_uSizeMask = uCount-1;
+	m_uEntryCount = 0;
+	m_uGrowthLeft = GetMaxLoad(uCount);
+}
+
+/*! ************************************
+
+	\brief Release the table memory
+
+	Free the buffer and set the hash to the empty state.
+	No destructors are called, HashMapFlat::Clear() handles that.
+
+	\sa CreateBuffer(WordPtr,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMapFlatShared::ReleaseBuffer(void)
+{
+	DisposeBuffer(m_pControl);
+	m_pControl = const_cast<Word8 *>(g_EmptyGroup);
+	m_pSlots = NULL;
+	m_uSizeMask = 0;
+	m_uEntryCount = 0;
+	m_uGrowthLeft = 0;
+}
+
+/*! ************************************
+
+	\brief Release a buffer allocated by CreateBuffer()
+
+	\param pControl Pointer to the control bytes, \ref g_EmptyGroup is ignored
+	\sa CreateBuffer(WordPtr,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMapFlatShared::DisposeBuffer(Word8 *pControl)
+{
+	if (pControl!=g_EmptyGroup) {
+		Free(pControl);
+	}
+}
+
+/*! ************************************
+
+	\brief Return the table size needed for a number of entries
+
+	Tables are only filled to 7/8ths of their size before
+	they are grown to keep the probe sequences short.
+
+	\param uCount Number of entries that need to fit
+	\return Power of 2 table size that can hold uCount entries
+	\sa GetMaxLoad(WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::HashMapFlatShared::GetTableSize(WordPtr uCount)
+{
+	WordPtr uSize = MINIMUMSIZE;
+	while (GetMaxLoad(uSize)<uCount) {
+		uSize <<= 1U;
+	}
+	return uSize;
+}
+
+/*! ************************************
+
+	\brief Find the next valid entry
+
+	Scan the control bytes starting at uIndex for an entry
+	that is in use. The scan tests \ref GROUPSIZE entries at a time.
+
+	\param uIndex Index to start scanning from
+	\return Index of the next valid entry or \ref INVALID_INDEX if there are no more
+	\sa HashMapFlat::begin(void)
+
+***************************************/
+
+WordPtr BURGER_API Burger::HashMapFlatShared::FindNext(WordPtr uIndex) const
+{
+	if (m_uEntryCount) {
+		WordPtr uSize = m_uSizeMask+1;
+		while (uIndex<uSize) {
+			// Entries in use have the high bit clear
+			Word32 uMatch = (~MatchFree(m_pControl+uIndex))&0xFFFFU;
+			// Ignore the mirrored bytes
+			WordPtr uRemaining = uSize-uIndex;
+			if (uRemaining<GROUPSIZE) {
+				uMatch &= (1U<<uRemaining)-1U;
+			}
+			if (uMatch) {
+				return uIndex+GetLowestBit(uMatch);
+			}
+			uIndex += GROUPSIZE;
+		}
+	}
+	return INVALID_INDEX;
+}
+
+/*! ************************************
+
+	\fn WordPtr Burger::HashMapFlatShared::GetMaxLoad(WordPtr uSize)
+	\brief Number of entries a table can hold before it must grow
+
+	\param uSize Size of the table (Power of 2)
+	\return 7/8ths of uSize
+	\sa GetTableSize(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::HashMapFlatShared::MixHash(WordPtr uHash)
+	\brief Mix the bits of a hash value
+
+	Multiply by the golden ratio and fold the upper bits into the
+	lower bits. The lower 7 bits become the control byte and the
+	rest select the starting probe position, so hash functions that
+	only vary in a few bits still spread across the table.
+
+	\param uHash Value returned by the hash functor
+	\return Mixed hash value
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::HashMapFlatShared::MatchByte(const Word8 *pGroup,Word uValue)
+	\brief Test a group of control bytes for a value
+
+	\param pGroup Pointer to \ref GROUPSIZE control bytes
+	\param uValue Value to test for
+	\return Bit mask with a bit set for every control byte that matched
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::HashMapFlatShared::MatchFree(const Word8 *pGroup)
+	\brief Test a group of control bytes for unused entries
+
+	\param pGroup Pointer to \ref GROUPSIZE control bytes
+	\return Bit mask with a bit set for every control byte that is empty or deleted
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::HashMapFlatShared::MatchEmpty(const Word8 *pGroup)
+	\brief Test a group of control bytes for empty entries
+
+	Deleted entries don't match since a probe sequence must
+	continue past them.
+
+	\param pGroup Pointer to \ref GROUPSIZE control bytes
+	\return Bit mask with a bit set for every control byte that is empty
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::HashMapFlatShared::SetControl(WordPtr uIndex,Word uValue)
+	\brief Set a control byte
+
+	Set the control byte and its mirrored copy, if any.
+
+	\param uIndex Index of the entry
+	\param uValue New control byte
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::HashMapFlatShared::FindFreeSlot(WordPtr uHash) const
+	\brief Find the first unused entry in a probe sequence
+
+	\param uHash Mixed hash value of the key
+	\return Index of the first empty or deleted entry
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapFlat
+	\brief Open addressing key / data pair hash for quick lookup and retrieval
+
+	HashMapFlat has the same interface as HashMap but stores the entries
+	in a single array that is probed \ref HashMapFlatShared::GROUPSIZE entries
+	at a time. The hash and equality tests are template functors so they
+	are compiled inline with the lookup code instead of being called
+	through a function pointer.
+
+	Erasing an entry marks it as deleted. Iterators remain valid during
+	an erase, however adding an entry may rebuild the table which
+	invalidates all iterators and pointers to data.
+
+	\tparam T Key type
+	\tparam U Data type
+	\tparam Hash Hash functor, defaults to HashMapFlatHash
+	\tparam Test Equality functor, defaults to HashMapFlatEqual
+
+	\sa HashMapFlatShared, HashMapFlatString or HashMap
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapFlatString
+	\brief String key / data pair open addressing hash
+
+	A HashMapFlat that uses the string contained in a String
+	as the key data.
+
+	\note String hashing is case sensitive. For case insensitive
+	hashing, use HashMapFlatStringCase
+
+	\sa HashMapFlat or HashMapString
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::HashMapFlatStringCase
+	\brief Case insensitive String key / data pair open addressing hash
+
+	A HashMapFlat that uses the string contained in a String
+	as the key data ignoring case.
+
+	\sa HashMapFlat or HashMapStringCase
+
+***************************************/
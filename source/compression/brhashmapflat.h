@@ -0,0 +1,480 @@
+/***************************************
+
+	Open addressing HashMap template for mapping a key to data
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRHASHMAPFLAT_H__
+#define __BRHASHMAPFLAT_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRASSERT_H__
+#include "brassert.h"
+#endif
+
+#ifndef __BRSTRING_H__
+#include "brstring.h"
+#endif
+
+#ifndef __BRXXHASH_H__
+#include "brxxhash.h"
+#endif
+
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(__SSE2__))
+#ifndef __BRVISUALSTUDIO_H__
+#include "brvisualstudio.h"
+#endif
+#include <emmintrin.h>
+#endif
+
+/* BEGIN */
+namespace Burger {
+template<class T>
+struct HashMapFlatHash {
+	BURGER_INLINE WordPtr operator()(const T &rKey) const { return static_cast<WordPtr>(XXHash64(&rKey,sizeof(T))); }
+};
+template<>
+struct HashMapFlatHash<Word32> {
+	BURGER_INLINE WordPtr operator()(Word32 uKey) const { return uKey; }
+};
+template<>
+struct HashMapFlatHash<Int32> {
+	BURGER_INLINE WordPtr operator()(Int32 iKey) const { return static_cast<WordPtr>(static_cast<Word32>(iKey)); }
+};
+template<>
+struct HashMapFlatHash<Word64> {
+	BURGER_INLINE WordPtr operator()(Word64 uKey) const { return static_cast<WordPtr>(uKey^(uKey>>32U)); }
+};
+template<>
+struct HashMapFlatHash<Int64> {
+	BURGER_INLINE WordPtr operator()(Int64 iKey) const { return static_cast<WordPtr>(static_cast<Word64>(iKey)^(static_cast<Word64>(iKey)>>32U)); }
+};
+template<class T>
+struct HashMapFlatHash<T *> {
+	BURGER_INLINE WordPtr operator()(const T *pKey) const { return reinterpret_cast<WordPtr>(pKey); }
+};
+template<class T>
+struct HashMapFlatEqual {
+	BURGER_INLINE Word operator()(const T &rA,const T &rB) const { return rA==rB; }
+};
+struct HashMapFlatStringHash {
+	BURGER_INLINE WordPtr operator()(const String &rKey) const { return static_cast<WordPtr>(XXHash64(rKey.GetPtr(),rKey.GetLength())); }
+};
+struct HashMapFlatStringCaseHash {
+	BURGER_INLINE WordPtr operator()(const String &rKey) const { return static_cast<WordPtr>(XXHash64Case(rKey.GetPtr(),rKey.GetLength())); }
+};
+struct HashMapFlatStringCaseEqual {
+	BURGER_INLINE Word operator()(const String &rA,const String &rB) const { return StringCaseCompare(rA.GetPtr(),rB.GetPtr())==0; }
+};
+
+class HashMapFlatShared {
+public:
+	static const WordPtr INVALID_INDEX = BURGER_MAXWORDPTR;		///< Error value for invalid indexes
+	enum {
+		GROUPSIZE=16,			///< Number of control bytes tested with a single probe
+		MINIMUMSIZE=16,			///< Smallest table size (Must be at least GROUPSIZE)
+		CONTROL_EMPTY=0x80,		///< Control byte for a slot that was never used
+		CONTROL_DELETED=0xFE,	///< Control byte for a slot that was erased
+		TAGMASK=0x7F			///< Mask for the hash bits stored in a control byte
+	};
+protected:
+	Word8 *m_pControl;			///< Control bytes, one per slot followed by a copy of the first GROUPSIZE bytes
+	void *m_pSlots;				///< Key / data storage, only slots with a valid control byte are constructed
+	WordPtr m_uSizeMask;		///< (Power of 2)-1 size mask used for wrapping probe indexes
+	WordPtr m_uEntryCount;		///< Number of valid entries in the hash
+	WordPtr m_uGrowthLeft;		///< Number of empty slots that can be used before the table must grow
+	static const Word8 BURGER_ALIGN(g_EmptyGroup[GROUPSIZE],16);	///< Control bytes used by a table with no memory
+
+	HashMapFlatShared() :
+		m_pControl(const_cast<Word8 *>(g_EmptyGroup)),
+		m_pSlots(NULL),
+		m_uSizeMask(0),
+		m_uEntryCount(0),
+		m_uGrowthLeft(0)
+	{
+	}
+	void BURGER_API CreateBuffer(WordPtr uCount,WordPtr uSlotSize);
+	void BURGER_API ReleaseBuffer(void);
+	static void BURGER_API DisposeBuffer(Word8 *pControl);
+	static WordPtr BURGER_API GetTableSize(WordPtr uCount);
+	WordPtr BURGER_API FindNext(WordPtr uIndex) const;
+	BURGER_INLINE static WordPtr GetMaxLoad(WordPtr uSize) { return uSize-(uSize>>3U); }
+	BURGER_INLINE static WordPtr MixHash(WordPtr uHash)
+	{
+		// Spread the bits so weak hashes (Like integers) use the whole table
+#if defined(BURGER_64BITCPU)
+		uHash *= 0x9E3779B97F4A7C15ULL;
+		return uHash^(uHash>>32U);
+#else
+		uHash *= 0x9E3779B9U;
+		return uHash^(uHash>>16U);
+#endif
+	}
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(__SSE2__))
+	BURGER_INLINE static Word32 MatchByte(const Word8 *pGroup,Word uValue)
+	{
+		__m128i vGroup = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pGroup));
+		return static_cast<Word32>(_mm_movemask_epi8(_mm_cmpeq_epi8(vGroup,_mm_set1_epi8(static_cast<char>(uValue)))));
+	}
+	BURGER_INLINE static Word32 MatchFree(const Word8 *pGroup)
+	{
+		// Both empty and deleted have the high bit set
+		return static_cast<Word32>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pGroup))));
+	}
+	BURGER_INLINE static Word GetLowestBit(Word32 uMask)
+	{
+		unsigned long uResult;
+		_BitScanForward(&uResult,uMask);
+		return static_cast<Word>(uResult);
+	}
+#else
+	BURGER_INLINE static Word32 MatchByte(const Word8 *pGroup,Word uValue)
+	{
+		Word32 uResult = 0;
+		Word i = 0;
+		do {
+			if (pGroup[i]==uValue) {
+				uResult |= 1U<<i;
+			}
+		} while (++i<GROUPSIZE);
+		return uResult;
+	}
+	BURGER_INLINE static Word32 MatchFree(const Word8 *pGroup)
+	{
+		Word32 uResult = 0;
+		Word i = 0;
+		do {
+			uResult |= static_cast<Word32>(pGroup[i]>>7U)<<i;
+		} while (++i<GROUPSIZE);
+		return uResult;
+	}
+	BURGER_INLINE static Word GetLowestBit(Word32 uMask)
+	{
+		Word uResult = 0;
+		while (!(uMask&1U)) {
+			uMask >>= 1U;
+			++uResult;
+		}
+		return uResult;
+	}
+#endif
+	BURGER_INLINE static Word32 MatchEmpty(const Word8 *pGroup) { return MatchByte(pGroup,CONTROL_EMPTY); }
+	BURGER_INLINE void SetControl(WordPtr uIndex,Word uValue)
+	{
+		m_pControl[uIndex] = static_cast<Word8>(uValue);
+		// The first GROUPSIZE bytes are mirrored after the end so probes never wrap
+		m_pControl[((uIndex-GROUPSIZE)&m_uSizeMask)+GROUPSIZE] = static_cast<Word8>(uValue);
+	}
+	WordPtr FindFreeSlot(WordPtr uHash) const
+	{
+		WordPtr uPosition = (uHash>>7U)&m_uSizeMask;
+		WordPtr uStep = 0;
+		for (;;) {
+			Word32 uMatch = MatchFree(m_pControl+uPosition);
+			if (uMatch) {
+				return (uPosition+GetLowestBit(uMatch))&m_uSizeMask;
+			}
+			uStep += GROUPSIZE;
+			uPosition = (uPosition+uStep)&m_uSizeMask;
+		}
+	}
+public:
+	class const_iterator {
+	protected:
+		const HashMapFlatShared* m_pParent;	///< Pointer to the parent class instance
+		WordPtr m_uIndex;					///< Last accessed index
+		const_iterator(const HashMapFlatShared *pParent,WordPtr uIndex) :
+			m_pParent(pParent),m_uIndex(uIndex)
+		{
+		}
+	public:
+		BURGER_INLINE Word IsEnd(void) const { return (m_uIndex == INVALID_INDEX); }
+		BURGER_INLINE void operator++() {
+			if (m_uIndex!=INVALID_INDEX) {
+				m_uIndex = m_pParent->FindNext(m_uIndex+1);
+			}
+		}
+		BURGER_INLINE Word operator==(const const_iterator& it) const {
+			return (m_pParent == it.m_pParent) && (m_uIndex == it.m_uIndex);
+		}
+		BURGER_INLINE Word operator!=(const const_iterator& it) const {
+			return (m_pParent != it.m_pParent) || (m_uIndex != it.m_uIndex);
+		}
+	};
+	BURGER_INLINE WordPtr GetEntryCount(void) const { return m_uEntryCount; }
+	BURGER_INLINE WordPtr GetSizeMask(void) const { return m_uSizeMask; }
+	BURGER_INLINE Word IsEmpty(void) const { return (m_uEntryCount == 0); }
+};
+
+template<class T,class U,class Hash=HashMapFlatHash<T>,class Test=HashMapFlatEqual<T> >
+class HashMapFlat : public HashMapFlatShared {
+public:
+	struct Entry {
+		T first;				///< Key value
+		U second;				///< Data associated with the key
+	};
+	class const_iterator;
+private:
+	friend class const_iterator;
+	BURGER_INLINE Entry *GetEntry(WordPtr uIndex) const
+	{
+		BURGER_ASSERT(m_pSlots && (uIndex <= m_uSizeMask) && (m_pControl[uIndex]<CONTROL_EMPTY));
+		return static_cast<Entry *>(m_pSlots)+uIndex;
+	}
+	WordPtr FindIndex(const T &rKey) const
+	{
+		const Hash HashFunctor = Hash();
+		const Test TestFunctor = Test();
+		WordPtr uHash = MixHash(HashFunctor(rKey));
+		Word uTag = static_cast<Word>(uHash&TAGMASK);
+		WordPtr uPosition = (uHash>>7U)&m_uSizeMask;
+		WordPtr uStep = 0;
+		const Entry *pSlots = static_cast<const Entry *>(m_pSlots);
+		for (;;) {
+			const Word8 *pGroup = m_pControl+uPosition;
+			Word32 uMatch = MatchByte(pGroup,uTag);
+			while (uMatch) {
+				WordPtr uIndex = (uPosition+GetLowestBit(uMatch))&m_uSizeMask;
+				if (TestFunctor(pSlots[uIndex].first,rKey)) {
+					return uIndex;
+				}
+				uMatch &= uMatch-1;
+			}
+			// An empty slot ends the probe sequence
+			if (MatchEmpty(pGroup)) {
+				return INVALID_INDEX;
+			}
+			uStep += GROUPSIZE;
+			uPosition = (uPosition+uStep)&m_uSizeMask;
+		}
+	}
+	// Place an entry known not to be in the table into a table with room
+	Entry *Insert(WordPtr uHash)
+	{
+		WordPtr uIndex = FindFreeSlot(uHash);
+		m_uGrowthLeft -= (m_pControl[uIndex]==CONTROL_EMPTY);
+		SetControl(uIndex,static_cast<Word>(uHash&TAGMASK));
+		++m_uEntryCount;
+		return static_cast<Entry *>(m_pSlots)+uIndex;
+	}
+	void Rehash(WordPtr uNewSize)
+	{
+		const Hash HashFunctor = Hash();
+		Word8 *pOldControl = m_pControl;
+		Entry *pOldEntry = static_cast<Entry *>(m_pSlots);
+		WordPtr uOldSize = pOldEntry ? m_uSizeMask+1 : 0;
+		CreateBuffer(uNewSize,sizeof(Entry));
+		if (uOldSize) {
+			WordPtr i = 0;
+			do {
+				if (pOldControl[i]<CONTROL_EMPTY) {
+					Entry *pNewEntry = Insert(MixHash(HashFunctor(pOldEntry->first)));
+					new (&pNewEntry->first) T(pOldEntry->first);
+					new (&pNewEntry->second) U(pOldEntry->second);
+					pOldEntry->first.~T();
+					pOldEntry->second.~U();
+				}
+				++pOldEntry;
+			} while (++i<uOldSize);
+			DisposeBuffer(pOldControl);
+		}
+	}
+	void Grow(void)
+	{
+		WordPtr uNewSize = MINIMUMSIZE;
+		if (m_pSlots) {
+			uNewSize = m_uSizeMask+1;
+			// If the table is mostly erased entries, rebuild at the same size
+			if (m_uEntryCount>=(GetMaxLoad(uNewSize)>>1U)) {
+				uNewSize <<= 1U;
+			}
+		}
+		Rehash(uNewSize);
+	}
+	Entry *AddEntry(const T &rKey)
+	{
+		const Hash HashFunctor = Hash();
+		WordPtr uHash = MixHash(HashFunctor(rKey));
+		if (!m_uGrowthLeft && (m_pControl[FindFreeSlot(uHash)]==CONTROL_EMPTY)) {
+			Grow();
+		}
+		return Insert(uHash);
+	}
+	void CopyEntries(const HashMapFlat<T,U,Hash,Test> &rHashMap)
+	{
+		WordPtr uCount = rHashMap.m_uEntryCount;
+		if (uCount) {
+			const Hash HashFunctor = Hash();
+			CreateBuffer(GetTableSize(uCount),sizeof(Entry));
+			WordPtr uIndex = rHashMap.FindNext(0);
+			do {
+				const Entry *pOldEntry = rHashMap.GetEntry(uIndex);
+				Entry *pNewEntry = Insert(MixHash(HashFunctor(pOldEntry->first)));
+				new (&pNewEntry->first) T(pOldEntry->first);
+				new (&pNewEntry->second) U(pOldEntry->second);
+				uIndex = rHashMap.FindNext(uIndex+1);
+			} while (uIndex!=INVALID_INDEX);
+		}
+	}
+public:
+	HashMapFlat() {}
+	HashMapFlat(WordPtr uDefault) { SetCapacity(uDefault); }
+	HashMapFlat(const HashMapFlat<T,U,Hash,Test>& rHashMap) : HashMapFlatShared() { CopyEntries(rHashMap); }
+	~HashMapFlat() { Clear(); }
+	HashMapFlat<T,U,Hash,Test>& operator=(const HashMapFlat<T,U,Hash,Test>& rHashMap)
+	{
+		if (&rHashMap!=this) {
+			Clear();
+			CopyEntries(rHashMap);
+		}
+		return *this;
+	}
+	U &operator[](const T& rKey)
+	{
+		WordPtr uIndex = FindIndex(rKey);
+		if (uIndex!=INVALID_INDEX) {
+			return GetEntry(uIndex)->second;
+		}
+		Entry *pEntry = AddEntry(rKey);
+		new (&pEntry->first) T(rKey);
+		new (&pEntry->second) U();
+		return pEntry->second;
+	}
+	void Set(const T &rKey,const U &rValue)
+	{
+		WordPtr uIndex = FindIndex(rKey);
+		if (uIndex==INVALID_INDEX) {
+			add(rKey,rValue);
+		} else {
+			GetEntry(uIndex)->second = rValue;
+		}
+	}
+	void add(const T &rKey,const U &rValue)
+	{
+		BURGER_ASSERT(FindIndex(rKey)==INVALID_INDEX);
+		Entry *pEntry = AddEntry(rKey);
+		new (&pEntry->first) T(rKey);
+		new (&pEntry->second) U(rValue);
+	}
+	BURGER_INLINE U *GetData(const T& rKey)
+	{
+		WordPtr uIndex = FindIndex(rKey);
+		return (uIndex!=INVALID_INDEX) ? &GetEntry(uIndex)->second : NULL;
+	}
+	BURGER_INLINE const U *GetData(const T& rKey) const
+	{
+		WordPtr uIndex = FindIndex(rKey);
+		return (uIndex!=INVALID_INDEX) ? &GetEntry(uIndex)->second : NULL;
+	}
+	Word GetData(const T& rKey,U *pOutput) const
+	{
+		WordPtr uIndex = FindIndex(rKey);
+		Word uResult = FALSE;
+		if (uIndex!=INVALID_INDEX) {
+			pOutput[0] = GetEntry(uIndex)->second;
+			uResult = TRUE;
+		}
+		return uResult;
+	}
+	void Clear(void)
+	{
+		if (m_uEntryCount) {
+			Entry *pEntry = static_cast<Entry *>(m_pSlots);
+			const Word8 *pControl = m_pControl;
+			WordPtr uCount = m_uSizeMask+1;
+			do {
+				if (pControl[0]<CONTROL_EMPTY) {
+					pEntry->first.~T();
+					pEntry->second.~U();
+				}
+				++pEntry;
+				++pControl;
+			} while (--uCount);
+		}
+		ReleaseBuffer();
+	}
+	void Resize(WordPtr uNewSize)
+	{
+		if (uNewSize < m_uEntryCount) {
+			uNewSize = m_uEntryCount;
+		}
+		if (!uNewSize) {
+			Clear();
+		} else {
+			uNewSize = GetTableSize(uNewSize);
+			if (!m_pSlots || (uNewSize!=(m_uSizeMask+1))) {
+				Rehash(uNewSize);
+			}
+		}
+	}
+	BURGER_INLINE void SetCapacity(WordPtr uNewSize)
+	{
+		if (uNewSize < m_uEntryCount) {
+			uNewSize = m_uEntryCount;
+		}
+		Resize((uNewSize*3U)>>1U);
+	}
+
+	class iterator;
+	class const_iterator : public HashMapFlatShared::const_iterator {
+		const_iterator(const HashMapFlatShared *pParent,WordPtr uIndex) : HashMapFlatShared::const_iterator(pParent,uIndex) {}
+		friend class HashMapFlat<T,U,Hash,Test>;
+		friend class iterator;
+	public:
+		BURGER_INLINE const Entry *GetPtr(void) const {
+			BURGER_ASSERT(!this->IsEnd());
+			return static_cast<const HashMapFlat<T,U,Hash,Test> *>(this->m_pParent)->GetEntry(this->m_uIndex);
+		}
+		BURGER_INLINE const Entry &operator*() const { return GetPtr()[0]; }
+		BURGER_INLINE const Entry *operator->() const { return GetPtr(); }
+	};
+	class iterator : public const_iterator {
+		friend class HashMapFlat<T,U,Hash,Test>;
+		iterator(HashMapFlatShared *pParent,WordPtr uIndex) : const_iterator(pParent,uIndex) {}
+	public:
+		BURGER_INLINE Entry &operator*() const { return const_cast<Entry *>(const_iterator::GetPtr())[0]; }
+		BURGER_INLINE Entry *operator->() const { return const_cast<Entry *>(const_iterator::GetPtr()); }
+	};
+	BURGER_INLINE iterator begin(void) { return iterator(this,FindNext(0)); }
+	BURGER_INLINE const_iterator begin(void) const { return const_iterator(this,FindNext(0)); }
+	BURGER_INLINE iterator end(void) { return iterator(this,INVALID_INDEX); }
+	BURGER_INLINE const_iterator end(void) const { return const_iterator(this,INVALID_INDEX); }
+	BURGER_INLINE iterator find(const T& rKey) { return iterator(this,FindIndex(rKey)); }
+	BURGER_INLINE const_iterator find(const T& rKey) const { return const_iterator(this,FindIndex(rKey)); }
+	void erase(const iterator& it)
+	{
+		if (!it.IsEnd() && (it.m_pParent == this)) {
+			Entry *pEntry = GetEntry(it.m_uIndex);
+			pEntry->first.~T();
+			pEntry->second.~U();
+			SetControl(it.m_uIndex,CONTROL_DELETED);
+			--m_uEntryCount;
+		}
+	}
+	BURGER_INLINE void erase(const T& rKey) { erase(find(rKey)); }
+};
+
+template<class U>
+class HashMapFlatString : public HashMapFlat<String,U,HashMapFlatStringHash> {
+public: HashMapFlatString() {}
+};
+
+template<class U>
+class HashMapFlatStringCase : public HashMapFlat<String,U,HashMapFlatStringCaseHash,HashMapFlatStringCaseEqual> {
+public: HashMapFlatStringCase() {}
+};
+
+}
+/* END */
+
+#endif
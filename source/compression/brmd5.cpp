@@ -20,6 +20,24 @@
 #include "brstringfunctions.h"
 #include "brfixedpoint.h"
 
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define MD5_SIMD
+#include "bratomic.h"
+#include <emmintrin.h>
+
+// AVX2 requires Visual Studio 2012 or higher
+#if !defined(BURGER_MSVC) || (_MSC_VER>=1700)
+#define MD5_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(BURGER_MSVC)
+#define MD5_TARGET(x)
+#else
+#define MD5_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
 /*! ************************************
 
 	\struct Burger::MD5_t
@@ -116,6 +134,218 @@ void BURGER_API Burger::MD5Hasher_t::Init(void)
 
 #endif
 
+//
+// Hardware accelerated versions for Intel/AMD processors.
+// They are compiled with the instruction set enabled on a per
+// function basis and only called if CPUID reports the feature
+//
+
+#if defined(MD5_SIMD)
+
+// The 64 constants used by the rounds, in order
+static const Word32 g_MD5Constants[64] = {
+	0xd76aa478U,0xe8c7b756U,0x242070dbU,0xc1bdceeeU,
+	0xf57c0fafU,0x4787c62aU,0xa8304613U,0xfd469501U,
+	0x698098d8U,0x8b44f7afU,0xffff5bb1U,0x895cd7beU,
+	0x6b901122U,0xfd987193U,0xa679438eU,0x49b40821U,
+	0xf61e2562U,0xc040b340U,0x265e5a51U,0xe9b6c7aaU,
+	0xd62f105dU,0x02441453U,0xd8a1e681U,0xe7d3fbc8U,
+	0x21e1cde6U,0xc33707d6U,0xf4d50d87U,0x455a14edU,
+	0xa9e3e905U,0xfcefa3f8U,0x676f02d9U,0x8d2a4c8aU,
+	0xfffa3942U,0x8771f681U,0x6d9d6122U,0xfde5380cU,
+	0xa4beea44U,0x4bdecfa9U,0xf6bb4b60U,0xbebfbc70U,
+	0x289b7ec6U,0xeaa127faU,0xd4ef3085U,0x04881d05U,
+	0xd9d4d039U,0xe6db99e5U,0x1fa27cf8U,0xc4ac5665U,
+	0xf4292244U,0x432aff97U,0xab9423a7U,0xfc93a039U,
+	0x655b59c3U,0x8f0ccc92U,0xffeff47dU,0x85845dd1U,
+	0x6fa87e4fU,0xfe2ce6e0U,0xa3014314U,0x4e0811a1U,
+	0xf7537e82U,0xbd3af235U,0x2ad7d2bbU,0xeb86d391U
+};
+
+//
+// Load a little endian 32 bit word from each lane's input
+//
+
+static BURGER_INLINE int MD5LoadWord(const Word8 *pInput)
+{
+	return static_cast<int>(Burger::LittleEndian::LoadAny(static_cast<const Word32 *>(static_cast<const void *>(pInput))));
+}
+
+//
+// Hash uCount 64 byte blocks from 4 messages at once, one message
+// per 32 bit lane. pState has 4 rows of 8 Word32 entries, one row for
+// each of the a,b,c,d hash values and one column per message
+//
+
+#define MD5_ROTL128(x,n) _mm_or_si128(_mm_slli_epi32(x,n),_mm_srli_epi32(x,32-(n)))
+#define MD5_F128(b,c,d) _mm_xor_si128(d,_mm_and_si128(b,_mm_xor_si128(c,d)))
+#define MD5_G128(b,c,d) _mm_xor_si128(c,_mm_and_si128(d,_mm_xor_si128(b,c)))
+#define MD5_H128(b,c,d) _mm_xor_si128(_mm_xor_si128(b,c),d)
+#define MD5_I128(b,c,d) _mm_xor_si128(c,_mm_or_si128(b,_mm_xor_si128(d,AllOnes)))
+#define MD5_STEP128(f,a,b,c,d,x,s,i) a = _mm_add_epi32(b,MD5_ROTL128(_mm_add_epi32(_mm_add_epi32(a,f(b,c,d)), \
+	_mm_add_epi32(x,_mm_set1_epi32(static_cast<int>(g_MD5Constants[i])))),s))
+
+MD5_TARGET("sse2") static void MD5ProcessLanesSSE2(Word32 *pState,const Word8 * const *ppInputs,WordPtr uCount)
+{
+	const __m128i AllOnes = _mm_set1_epi32(-1);
+	__m128i a = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState)));
+	__m128i b = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+8)));
+	__m128i c = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+16)));
+	__m128i d = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+24)));
+	WordPtr uOffset = 0;
+	do {
+		__m128i X[16];
+		Word i = 0;
+		do {
+			X[i] = _mm_set_epi32(MD5LoadWord(ppInputs[3]+uOffset),MD5LoadWord(ppInputs[2]+uOffset),
+				MD5LoadWord(ppInputs[1]+uOffset),MD5LoadWord(ppInputs[0]+uOffset));
+			uOffset += 4;
+		} while (++i<16);
+
+		__m128i aSave = a;
+		__m128i bSave = b;
+		__m128i cSave = c;
+		__m128i dSave = d;
+
+		// Round 1
+		i = 0;
+		do {
+			MD5_STEP128(MD5_F128,a,b,c,d,X[i],SHIFT11,i);
+			MD5_STEP128(MD5_F128,d,a,b,c,X[i+1],SHIFT12,i+1);
+			MD5_STEP128(MD5_F128,c,d,a,b,X[i+2],SHIFT13,i+2);
+			MD5_STEP128(MD5_F128,b,c,d,a,X[i+3],SHIFT14,i+3);
+			i += 4;
+		} while (i<16);
+
+		// Round 2
+		do {
+			MD5_STEP128(MD5_G128,a,b,c,d,X[(i*5+1)&15],SHIFT21,i);
+			MD5_STEP128(MD5_G128,d,a,b,c,X[(i*5+6)&15],SHIFT22,i+1);
+			MD5_STEP128(MD5_G128,c,d,a,b,X[(i*5+11)&15],SHIFT23,i+2);
+			MD5_STEP128(MD5_G128,b,c,d,a,X[(i*5)&15],SHIFT24,i+3);
+			i += 4;
+		} while (i<32);
+
+		// Round 3
+		do {
+			MD5_STEP128(MD5_H128,a,b,c,d,X[(i*3+5)&15],SHIFT31,i);
+			MD5_STEP128(MD5_H128,d,a,b,c,X[(i*3+8)&15],SHIFT32,i+1);
+			MD5_STEP128(MD5_H128,c,d,a,b,X[(i*3+11)&15],SHIFT33,i+2);
+			MD5_STEP128(MD5_H128,b,c,d,a,X[(i*3+14)&15],SHIFT34,i+3);
+			i += 4;
+		} while (i<48);
+
+		// Round 4
+		do {
+			MD5_STEP128(MD5_I128,a,b,c,d,X[(i*7)&15],SHIFT41,i);
+			MD5_STEP128(MD5_I128,d,a,b,c,X[(i*7+7)&15],SHIFT42,i+1);
+			MD5_STEP128(MD5_I128,c,d,a,b,X[(i*7+14)&15],SHIFT43,i+2);
+			MD5_STEP128(MD5_I128,b,c,d,a,X[(i*7+21)&15],SHIFT44,i+3);
+			i += 4;
+		} while (i<64);
+
+		a = _mm_add_epi32(a,aSave);
+		b = _mm_add_epi32(b,bSave);
+		c = _mm_add_epi32(c,cSave);
+		d = _mm_add_epi32(d,dSave);
+	} while (--uCount);
+
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState)),a);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+8)),b);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+16)),c);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+24)),d);
+}
+
+#if defined(MD5_AVX)
+
+//
+// Same as MD5ProcessLanesSSE2() but with 8 messages at once
+//
+
+#define MD5_ROTL256(x,n) _mm256_or_si256(_mm256_slli_epi32(x,n),_mm256_srli_epi32(x,32-(n)))
+#define MD5_F256(b,c,d) _mm256_xor_si256(d,_mm256_and_si256(b,_mm256_xor_si256(c,d)))
+#define MD5_G256(b,c,d) _mm256_xor_si256(c,_mm256_and_si256(d,_mm256_xor_si256(b,c)))
+#define MD5_H256(b,c,d) _mm256_xor_si256(_mm256_xor_si256(b,c),d)
+#define MD5_I256(b,c,d) _mm256_xor_si256(c,_mm256_or_si256(b,_mm256_xor_si256(d,AllOnes)))
+#define MD5_STEP256(f,a,b,c,d,x,s,i) a = _mm256_add_epi32(b,MD5_ROTL256(_mm256_add_epi32(_mm256_add_epi32(a,f(b,c,d)), \
+	_mm256_add_epi32(x,_mm256_set1_epi32(static_cast<int>(g_MD5Constants[i])))),s))
+
+MD5_TARGET("avx2") static void MD5ProcessLanesAVX2(Word32 *pState,const Word8 * const *ppInputs,WordPtr uCount)
+{
+	const __m256i AllOnes = _mm256_set1_epi32(-1);
+	__m256i a = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState)));
+	__m256i b = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+8)));
+	__m256i c = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+16)));
+	__m256i d = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+24)));
+	WordPtr uOffset = 0;
+	do {
+		__m256i X[16];
+		Word i = 0;
+		do {
+			X[i] = _mm256_set_epi32(MD5LoadWord(ppInputs[7]+uOffset),MD5LoadWord(ppInputs[6]+uOffset),
+				MD5LoadWord(ppInputs[5]+uOffset),MD5LoadWord(ppInputs[4]+uOffset),
+				MD5LoadWord(ppInputs[3]+uOffset),MD5LoadWord(ppInputs[2]+uOffset),
+				MD5LoadWord(ppInputs[1]+uOffset),MD5LoadWord(ppInputs[0]+uOffset));
+			uOffset += 4;
+		} while (++i<16);
+
+		__m256i aSave = a;
+		__m256i bSave = b;
+		__m256i cSave = c;
+		__m256i dSave = d;
+
+		// Round 1
+		i = 0;
+		do {
+			MD5_STEP256(MD5_F256,a,b,c,d,X[i],SHIFT11,i);
+			MD5_STEP256(MD5_F256,d,a,b,c,X[i+1],SHIFT12,i+1);
+			MD5_STEP256(MD5_F256,c,d,a,b,X[i+2],SHIFT13,i+2);
+			MD5_STEP256(MD5_F256,b,c,d,a,X[i+3],SHIFT14,i+3);
+			i += 4;
+		} while (i<16);
+
+		// Round 2
+		do {
+			MD5_STEP256(MD5_G256,a,b,c,d,X[(i*5+1)&15],SHIFT21,i);
+			MD5_STEP256(MD5_G256,d,a,b,c,X[(i*5+6)&15],SHIFT22,i+1);
+			MD5_STEP256(MD5_G256,c,d,a,b,X[(i*5+11)&15],SHIFT23,i+2);
+			MD5_STEP256(MD5_G256,b,c,d,a,X[(i*5)&15],SHIFT24,i+3);
+			i += 4;
+		} while (i<32);
+
+		// Round 3
+		do {
+			MD5_STEP256(MD5_H256,a,b,c,d,X[(i*3+5)&15],SHIFT31,i);
+			MD5_STEP256(MD5_H256,d,a,b,c,X[(i*3+8)&15],SHIFT32,i+1);
+			MD5_STEP256(MD5_H256,c,d,a,b,X[(i*3+11)&15],SHIFT33,i+2);
+			MD5_STEP256(MD5_H256,b,c,d,a,X[(i*3+14)&15],SHIFT34,i+3);
+			i += 4;
+		} while (i<48);
+
+		// Round 4
+		do {
+			MD5_STEP256(MD5_I256,a,b,c,d,X[(i*7)&15],SHIFT41,i);
+			MD5_STEP256(MD5_I256,d,a,b,c,X[(i*7+7)&15],SHIFT42,i+1);
+			MD5_STEP256(MD5_I256,c,d,a,b,X[(i*7+14)&15],SHIFT43,i+2);
+			MD5_STEP256(MD5_I256,b,c,d,a,X[(i*7+21)&15],SHIFT44,i+3);
+			i += 4;
+		} while (i<64);
+
+		a = _mm256_add_epi32(a,aSave);
+		b = _mm256_add_epi32(b,bSave);
+		c = _mm256_add_epi32(c,cSave);
+		d = _mm256_add_epi32(d,dSave);
+	} while (--uCount);
+
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState)),a);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+8)),b);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+16)),c);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+24)),d);
+	_mm256_zeroupper();
+}
+#endif
+#endif
+
 /*! ************************************
 
 	\brief Process a single 64 byte block of data
@@ -346,3 +576,115 @@ void BURGER_API Burger::Hash(MD5_t *pOutput,const void *pInput,WordPtr uLength)
 	// Return the resulting hash
 	MemoryCopy(pOutput,&Context.m_Hash,16);
 }
+
+/*! ************************************
+
+	\brief Create MD5 keys for several buffers at once
+	
+	Given an array of buffers, generate an MD5 hash key for each
+	one. The results are identical to calling
+	Hash(MD5_t *,const void *,WordPtr) on each buffer.
+
+	On Intel and AMD processors, 8 buffers are hashed at once with
+	AVX2 or 4 at once with SSE2, one buffer per 32 bit lane. The
+	lanes process the number of 64 byte blocks that all the buffers
+	in the group have in common and the remaining data of each
+	buffer is finished one buffer at a time, so the best speed is
+	when all the buffers are about the same size.
+
+	\param pOutput Pointer to an array of uCount uninitialized MD5_t structures
+	\param ppInputs Pointer to an array of uCount pointers to buffers to hash
+	\param pLengths Pointer to an array of uCount buffer lengths in bytes
+	\param uCount Number of buffers to hash
+
+	\sa Hash(MD5_t *,const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMultiple(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+#if defined(MD5_SIMD)
+	const CPUID_t *pCPUID = GetCPUID();
+	Word uLanes = 0;
+#if defined(MD5_AVX)
+	if (pCPUID->HasAVX2() && pCPUID->IsAVXEnabled()) {
+		uLanes = 8;
+	} else
+#endif
+	if (pCPUID->HasSSE2()) {
+		uLanes = 4;
+	}
+	if (uLanes) {
+		while (uCount) {
+			WordPtr uGroup = uCount;
+			if (uGroup>uLanes) {
+				uGroup = uLanes;
+			}
+
+			// Find the number of blocks all the messages have.
+			// Unused lanes hash the first message again
+			const Word8 *pInputs[8];
+			WordPtr uBlocks = pLengths[0]>>6;
+			Word i = 0;
+			do {
+				Word uSource = (i<uGroup) ? i : 0;
+				pInputs[i] = static_cast<const Word8 *>(ppInputs[uSource]);
+				if ((pLengths[uSource]>>6)<uBlocks) {
+					uBlocks = pLengths[uSource]>>6;
+				}
+			} while (++i<uLanes);
+
+			// Transpose the starting hash, one row per hash word
+			Word32 State[4*8];
+			i = 0;
+			do {
+				State[i] = 0x67452301;
+				State[i+8] = 0xefcdab89;
+				State[i+16] = 0x98badcfe;
+				State[i+24] = 0x10325476;
+			} while (++i<8);
+
+			if (uBlocks) {
+#if defined(MD5_AVX)
+				if (uLanes==8) {
+					MD5ProcessLanesAVX2(State,pInputs,uBlocks);
+				} else
+#endif
+				{
+					MD5ProcessLanesSSE2(State,pInputs,uBlocks);
+				}
+			}
+
+			// Finish each message on its own
+			WordPtr uProcessed = uBlocks<<6;
+			i = 0;
+			do {
+				MD5Hasher_t Context;
+				Word32 *pHash32 = static_cast<Word32 *>(static_cast<void *>(Context.m_Hash.m_Hash));
+				LittleEndian::Store(pHash32,State[i]);
+				LittleEndian::Store(pHash32+1,State[i+8]);
+				LittleEndian::Store(pHash32+2,State[i+16]);
+				LittleEndian::Store(pHash32+3,State[i+24]);
+				Context.m_uByteCount = uProcessed;
+				Context.Process(pInputs[i]+uProcessed,pLengths[i]-uProcessed);
+				Context.Finalize();
+				MemoryCopy(&pOutput[i],&Context.m_Hash,16);
+			} while (++i<uGroup);
+
+			pOutput += uGroup;
+			ppInputs += uGroup;
+			pLengths += uGroup;
+			uCount -= uGroup;
+		}
+		return;
+	}
+#endif
+	if (uCount) {
+		do {
+			Hash(pOutput,ppInputs[0],pLengths[0]);
+			++pOutput;
+			++ppInputs;
+			++pLengths;
+		} while (--uCount);
+	}
+}
@@ -41,6 +41,7 @@ struct MD5Hasher_t {
 };
 
 extern void BURGER_API Hash(MD5_t *pOutput,const void *pInput,WordPtr uLength);
+extern void BURGER_API HashMultiple(MD5_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount);
 
 }
 /* END */
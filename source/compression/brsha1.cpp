@@ -20,6 +20,30 @@
 #include "brstringfunctions.h"
 #include "brfixedpoint.h"
 
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define SHA1_SIMD
+#include "bratomic.h"
+#include <emmintrin.h>
+
+// SHA extensions require Visual Studio 2015 or higher
+#if !defined(BURGER_MSVC) || (_MSC_VER>=1900)
+#define SHA1_SHANI
+#include <immintrin.h>
+#endif
+
+// AVX2 requires Visual Studio 2012 or higher
+#if !defined(BURGER_MSVC) || (_MSC_VER>=1700)
+#define SHA1_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(BURGER_MSVC)
+#define SHA1_TARGET(x)
+#else
+#define SHA1_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
 /*! ************************************
 
 	\struct Burger::SHA1_t
@@ -89,6 +113,366 @@ void BURGER_API Burger::SHA1Hasher_t::Init(void)
 	m_uByteCount = 0;
 }
 
+//
+// Hardware accelerated versions for Intel/AMD processors.
+// They are compiled with the instruction set enabled on a per
+// function basis and only called if CPUID reports the feature
+//
+
+#if defined(SHA1_SIMD)
+
+#if defined(SHA1_SHANI)
+
+//
+// Process uCount 64 byte blocks with the SHA extensions.
+// pHash is the 20 byte big endian hash in SHA1_t format
+//
+
+SHA1_TARGET("sha,ssse3") static void SHA1ProcessSHA(Word8 *pHash,const Word8 *pInput,WordPtr uCount)
+{
+	// Reverse all 16 bytes, so the first big endian word is in the high lane
+	const __m128i ByteSwap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+
+	__m128i ABCD = _mm_shuffle_epi8(_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pHash))),ByteSwap);
+	__m128i E0 = _mm_set_epi32(static_cast<int>(Burger::BigEndian::LoadAny(static_cast<const Word32 *>(static_cast<const void *>(pHash+16)))),0,0,0);
+	__m128i E1;
+	__m128i MSG0;
+	__m128i MSG1;
+	__m128i MSG2;
+	__m128i MSG3;
+	do {
+		__m128i ABCDSave = ABCD;
+		__m128i E0Save = E0;
+
+		// Rounds 0-3
+		MSG0 = _mm_shuffle_epi8(_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput))),ByteSwap);
+		E0 = _mm_add_epi32(E0,MSG0);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,0);
+
+		// Rounds 4-7
+		MSG1 = _mm_shuffle_epi8(_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput+16))),ByteSwap);
+		E1 = _mm_sha1nexte_epu32(E1,MSG1);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,0);
+		MSG0 = _mm_sha1msg1_epu32(MSG0,MSG1);
+
+		// Rounds 8-11
+		MSG2 = _mm_shuffle_epi8(_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput+32))),ByteSwap);
+		E0 = _mm_sha1nexte_epu32(E0,MSG2);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,0);
+		MSG1 = _mm_sha1msg1_epu32(MSG1,MSG2);
+		MSG0 = _mm_xor_si128(MSG0,MSG2);
+
+		// Rounds 12-15
+		MSG3 = _mm_shuffle_epi8(_mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pInput+48))),ByteSwap);
+		E1 = _mm_sha1nexte_epu32(E1,MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0,MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,0);
+		MSG2 = _mm_sha1msg1_epu32(MSG2,MSG3);
+		MSG1 = _mm_xor_si128(MSG1,MSG3);
+
+		// Rounds 16-19
+		E0 = _mm_sha1nexte_epu32(E0,MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1,MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,0);
+		MSG3 = _mm_sha1msg1_epu32(MSG3,MSG0);
+		MSG2 = _mm_xor_si128(MSG2,MSG0);
+
+		// Rounds 20-23
+		E1 = _mm_sha1nexte_epu32(E1,MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2,MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,1);
+		MSG0 = _mm_sha1msg1_epu32(MSG0,MSG1);
+		MSG3 = _mm_xor_si128(MSG3,MSG1);
+
+		// Rounds 24-27
+		E0 = _mm_sha1nexte_epu32(E0,MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3,MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,1);
+		MSG1 = _mm_sha1msg1_epu32(MSG1,MSG2);
+		MSG0 = _mm_xor_si128(MSG0,MSG2);
+
+		// Rounds 28-31
+		E1 = _mm_sha1nexte_epu32(E1,MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0,MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,1);
+		MSG2 = _mm_sha1msg1_epu32(MSG2,MSG3);
+		MSG1 = _mm_xor_si128(MSG1,MSG3);
+
+		// Rounds 32-35
+		E0 = _mm_sha1nexte_epu32(E0,MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1,MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,1);
+		MSG3 = _mm_sha1msg1_epu32(MSG3,MSG0);
+		MSG2 = _mm_xor_si128(MSG2,MSG0);
+
+		// Rounds 36-39
+		E1 = _mm_sha1nexte_epu32(E1,MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2,MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,1);
+		MSG0 = _mm_sha1msg1_epu32(MSG0,MSG1);
+		MSG3 = _mm_xor_si128(MSG3,MSG1);
+
+		// Rounds 40-43
+		E0 = _mm_sha1nexte_epu32(E0,MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3,MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,2);
+		MSG1 = _mm_sha1msg1_epu32(MSG1,MSG2);
+		MSG0 = _mm_xor_si128(MSG0,MSG2);
+
+		// Rounds 44-47
+		E1 = _mm_sha1nexte_epu32(E1,MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0,MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,2);
+		MSG2 = _mm_sha1msg1_epu32(MSG2,MSG3);
+		MSG1 = _mm_xor_si128(MSG1,MSG3);
+
+		// Rounds 48-51
+		E0 = _mm_sha1nexte_epu32(E0,MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1,MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,2);
+		MSG3 = _mm_sha1msg1_epu32(MSG3,MSG0);
+		MSG2 = _mm_xor_si128(MSG2,MSG0);
+
+		// Rounds 52-55
+		E1 = _mm_sha1nexte_epu32(E1,MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2,MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,2);
+		MSG0 = _mm_sha1msg1_epu32(MSG0,MSG1);
+		MSG3 = _mm_xor_si128(MSG3,MSG1);
+
+		// Rounds 56-59
+		E0 = _mm_sha1nexte_epu32(E0,MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3,MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,2);
+		MSG1 = _mm_sha1msg1_epu32(MSG1,MSG2);
+		MSG0 = _mm_xor_si128(MSG0,MSG2);
+
+		// Rounds 60-63
+		E1 = _mm_sha1nexte_epu32(E1,MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0,MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,3);
+		MSG2 = _mm_sha1msg1_epu32(MSG2,MSG3);
+		MSG1 = _mm_xor_si128(MSG1,MSG3);
+
+		// Rounds 64-67
+		E0 = _mm_sha1nexte_epu32(E0,MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1,MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,3);
+		MSG3 = _mm_sha1msg1_epu32(MSG3,MSG0);
+		MSG2 = _mm_xor_si128(MSG2,MSG0);
+
+		// Rounds 68-71
+		E1 = _mm_sha1nexte_epu32(E1,MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2,MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,3);
+		MSG3 = _mm_xor_si128(MSG3,MSG1);
+
+		// Rounds 72-75
+		E0 = _mm_sha1nexte_epu32(E0,MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3,MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E0,3);
+
+		// Rounds 76-79
+		E1 = _mm_sha1nexte_epu32(E1,MSG3);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD,E1,3);
+		// Add in the adjusted hash
+		E0 = _mm_sha1nexte_epu32(E0,E0Save);
+		ABCD = _mm_add_epi32(ABCD,ABCDSave);
+		pInput += 64;
+	} while (--uCount);
+
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pHash)),_mm_shuffle_epi8(ABCD,ByteSwap));
+	Burger::BigEndian::Store(static_cast<Word32 *>(static_cast<void *>(pHash+16)),static_cast<Word32>(_mm_cvtsi128_si32(_mm_srli_si128(E0,12))));
+}
+#endif
+
+//
+// Load a big endian 32 bit word from each lane's input
+//
+
+static BURGER_INLINE int SHA1LoadWord(const Word8 *pInput)
+{
+	return static_cast<int>(Burger::BigEndian::LoadAny(static_cast<const Word32 *>(static_cast<const void *>(pInput))));
+}
+
+//
+// Hash uCount 64 byte blocks from 4 messages at once, one message
+// per 32 bit lane. pState has 5 rows of 8 Word32 entries, one row for
+// each of the a,b,c,d,e hash values and one column per message
+//
+
+#define SHA1_ROTL128(x,n) _mm_or_si128(_mm_slli_epi32(x,n),_mm_srli_epi32(x,32-(n)))
+#define SHA1_NEXT128(i) W[(i)&15] = SHA1_ROTL128(_mm_xor_si128(_mm_xor_si128(W[((i)+13)&15],W[((i)+8)&15]),_mm_xor_si128(W[((i)+2)&15],W[(i)&15])),1)
+#define SHA1_ROUND128(f,k,w) Temp = _mm_add_epi32(_mm_add_epi32(SHA1_ROTL128(a,5),f),_mm_add_epi32(_mm_add_epi32(e,k),w)); \
+	e = d; d = c; c = SHA1_ROTL128(b,30); b = a; a = Temp
+
+SHA1_TARGET("sse2") static void SHA1ProcessLanesSSE2(Word32 *pState,const Word8 * const *ppInputs,WordPtr uCount)
+{
+	__m128i a = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState)));
+	__m128i b = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+8)));
+	__m128i c = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+16)));
+	__m128i d = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+24)));
+	__m128i e = _mm_loadu_si128(static_cast<const __m128i *>(static_cast<const void *>(pState+32)));
+	const Word8 *pInput0 = ppInputs[0];
+	const Word8 *pInput1 = ppInputs[1];
+	const Word8 *pInput2 = ppInputs[2];
+	const Word8 *pInput3 = ppInputs[3];
+	do {
+		__m128i W[16];
+		__m128i Temp;
+		Word i = 0;
+		do {
+			W[i] = _mm_set_epi32(SHA1LoadWord(pInput3),SHA1LoadWord(pInput2),SHA1LoadWord(pInput1),SHA1LoadWord(pInput0));
+			pInput0 += 4;
+			pInput1 += 4;
+			pInput2 += 4;
+			pInput3 += 4;
+		} while (++i<16);
+
+		__m128i aSave = a;
+		__m128i bSave = b;
+		__m128i cSave = c;
+		__m128i dSave = d;
+		__m128i eSave = e;
+
+		// 4 rounds of 20 operations each
+		__m128i K = _mm_set1_epi32(0x5a827999);
+		i = 0;
+		do {
+			if (i>=16) {
+				SHA1_NEXT128(i);
+			}
+			SHA1_ROUND128(_mm_xor_si128(_mm_and_si128(_mm_xor_si128(c,d),b),d),K,W[i&15]);
+		} while (++i<20);
+		K = _mm_set1_epi32(0x6ed9eba1);
+		do {
+			SHA1_NEXT128(i);
+			SHA1_ROUND128(_mm_xor_si128(_mm_xor_si128(b,c),d),K,W[i&15]);
+		} while (++i<40);
+		K = _mm_set1_epi32(static_cast<int>(0x8f1bbcdcU));
+		do {
+			SHA1_NEXT128(i);
+			SHA1_ROUND128(_mm_or_si128(_mm_and_si128(_mm_or_si128(b,c),d),_mm_and_si128(b,c)),K,W[i&15]);
+		} while (++i<60);
+		K = _mm_set1_epi32(static_cast<int>(0xca62c1d6U));
+		do {
+			SHA1_NEXT128(i);
+			SHA1_ROUND128(_mm_xor_si128(_mm_xor_si128(b,c),d),K,W[i&15]);
+		} while (++i<80);
+
+		a = _mm_add_epi32(a,aSave);
+		b = _mm_add_epi32(b,bSave);
+		c = _mm_add_epi32(c,cSave);
+		d = _mm_add_epi32(d,dSave);
+		e = _mm_add_epi32(e,eSave);
+	} while (--uCount);
+
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState)),a);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+8)),b);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+16)),c);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+24)),d);
+	_mm_storeu_si128(static_cast<__m128i *>(static_cast<void *>(pState+32)),e);
+}
+
+#if defined(SHA1_AVX)
+
+//
+// Same as SHA1ProcessLanesSSE2() but with 8 messages at once
+//
+
+#define SHA1_ROTL256(x,n) _mm256_or_si256(_mm256_slli_epi32(x,n),_mm256_srli_epi32(x,32-(n)))
+#define SHA1_NEXT256(i) W[(i)&15] = SHA1_ROTL256(_mm256_xor_si256(_mm256_xor_si256(W[((i)+13)&15],W[((i)+8)&15]),_mm256_xor_si256(W[((i)+2)&15],W[(i)&15])),1)
+#define SHA1_ROUND256(f,k,w) Temp = _mm256_add_epi32(_mm256_add_epi32(SHA1_ROTL256(a,5),f),_mm256_add_epi32(_mm256_add_epi32(e,k),w)); \
+	e = d; d = c; c = SHA1_ROTL256(b,30); b = a; a = Temp
+
+SHA1_TARGET("avx2") static void SHA1ProcessLanesAVX2(Word32 *pState,const Word8 * const *ppInputs,WordPtr uCount)
+{
+	__m256i a = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState)));
+	__m256i b = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+8)));
+	__m256i c = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+16)));
+	__m256i d = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+24)));
+	__m256i e = _mm256_loadu_si256(static_cast<const __m256i *>(static_cast<const void *>(pState+32)));
+	WordPtr uOffset = 0;
+	do {
+		__m256i W[16];
+		__m256i Temp;
+		Word i = 0;
+		do {
+			W[i] = _mm256_set_epi32(SHA1LoadWord(ppInputs[7]+uOffset),SHA1LoadWord(ppInputs[6]+uOffset),
+				SHA1LoadWord(ppInputs[5]+uOffset),SHA1LoadWord(ppInputs[4]+uOffset),
+				SHA1LoadWord(ppInputs[3]+uOffset),SHA1LoadWord(ppInputs[2]+uOffset),
+				SHA1LoadWord(ppInputs[1]+uOffset),SHA1LoadWord(ppInputs[0]+uOffset));
+			uOffset += 4;
+		} while (++i<16);
+
+		__m256i aSave = a;
+		__m256i bSave = b;
+		__m256i cSave = c;
+		__m256i dSave = d;
+		__m256i eSave = e;
+
+		// 4 rounds of 20 operations each
+		__m256i K = _mm256_set1_epi32(0x5a827999);
+		i = 0;
+		do {
+			if (i>=16) {
+				SHA1_NEXT256(i);
+			}
+			SHA1_ROUND256(_mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(c,d),b),d),K,W[i&15]);
+		} while (++i<20);
+		K = _mm256_set1_epi32(0x6ed9eba1);
+		do {
+			SHA1_NEXT256(i);
+			SHA1_ROUND256(_mm256_xor_si256(_mm256_xor_si256(b,c),d),K,W[i&15]);
+		} while (++i<40);
+		K = _mm256_set1_epi32(static_cast<int>(0x8f1bbcdcU));
+		do {
+			SHA1_NEXT256(i);
+			SHA1_ROUND256(_mm256_or_si256(_mm256_and_si256(_mm256_or_si256(b,c),d),_mm256_and_si256(b,c)),K,W[i&15]);
+		} while (++i<60);
+		K = _mm256_set1_epi32(static_cast<int>(0xca62c1d6U));
+		do {
+			SHA1_NEXT256(i);
+			SHA1_ROUND256(_mm256_xor_si256(_mm256_xor_si256(b,c),d),K,W[i&15]);
+		} while (++i<80);
+
+		a = _mm256_add_epi32(a,aSave);
+		b = _mm256_add_epi32(b,bSave);
+		c = _mm256_add_epi32(c,cSave);
+		d = _mm256_add_epi32(d,dSave);
+		e = _mm256_add_epi32(e,eSave);
+	} while (--uCount);
+
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState)),a);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+8)),b);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+16)),c);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+24)),d);
+	_mm256_storeu_si256(static_cast<__m256i *>(static_cast<void *>(pState+32)),e);
+	_mm256_zeroupper();
+}
+#endif
+#endif
+
 /*! ************************************
 
 	\brief Process a single 64 byte block of data
@@ -96,6 +480,9 @@ void BURGER_API Burger::SHA1Hasher_t::Init(void)
 	MD5 data is processed in 64 byte chunks. This function
 	will process 64 bytes on input and update the hash and checksum
 
+	On Intel and AMD processors that have the SHA extensions, the
+	hash is calculated with the sha1rnds4 instruction
+
 	\param pBlock Pointer to a buffer of 64 bytes of data to hash
 	\sa Process(const void *,WordPtr), Finalize(void) or Init(void)
 
@@ -103,6 +490,13 @@ void BURGER_API Burger::SHA1Hasher_t::Init(void)
 
 void BURGER_API Burger::SHA1Hasher_t::Process(const Word8 *pBlock)
 {
+#if defined(SHA1_SHANI)
+	const CPUID_t *pCPUID = GetCPUID();
+	if (pCPUID->HasSHA() && pCPUID->HasSSSE3()) {
+		SHA1ProcessSHA(m_Hash.m_Hash,pBlock,1);
+		return;
+	}
+#endif
 	Word32 DataBlock[16];
 	WordPtr i = 0;
 	const Word32 *pBlock32 = static_cast<const Word32 *>(static_cast<const void *>(pBlock));
@@ -260,10 +654,21 @@ void BURGER_API Burger::SHA1Hasher_t::Process(const void *pInput,WordPtr uLength
 		// Perform the checksum directly on the memory buffers
 
 		if ((i+63)<uLength) {
-			do {
-	 			Process(static_cast<const Word8 *>(pInput)+i);
-				i += 64;
-			} while ((i+63) < uLength);
+#if defined(SHA1_SHANI)
+			// Process all of the blocks in a single call
+			const CPUID_t *pCPUID = GetCPUID();
+			if (pCPUID->HasSHA() && pCPUID->HasSSSE3()) {
+				WordPtr uBlocks = (uLength-i)>>6;
+				SHA1ProcessSHA(m_Hash.m_Hash,static_cast<const Word8 *>(pInput)+i,uBlocks);
+				i += uBlocks<<6;
+			} else
+#endif
+			{
+				do {
+	 				Process(static_cast<const Word8 *>(pInput)+i);
+					i += 64;
+				} while ((i+63) < uLength);
+			}
 		}
 		index = 0;
 	} else {
@@ -331,3 +736,123 @@ void BURGER_API Burger::Hash(SHA1_t *pOutput,const void *pInput,WordPtr uLength)
 	// Return the resulting hash
 	MemoryCopy(pOutput,&Context.m_Hash,20);
 }
+
+/*! ************************************
+
+	\brief Create SHA-1 keys for several buffers at once
+	
+	Given an array of buffers, generate a SHA-1 hash key for each
+	one. The results are identical to calling
+	Hash(SHA1_t *,const void *,WordPtr) on each buffer.
+
+	On Intel and AMD processors, 8 buffers are hashed at once with
+	AVX2 or 4 at once with SSE2, one buffer per 32 bit lane. The
+	lanes process the number of 64 byte blocks that all the buffers
+	in the group have in common and the remaining data of each
+	buffer is finished one buffer at a time, so the best speed is
+	when all the buffers are about the same size.
+
+	If the processor has SHA extensions, each buffer is hashed with
+	the SHA extensions instead, since they are faster than the lanes.
+
+	\param pOutput Pointer to an array of uCount uninitialized SHA1_t structures
+	\param ppInputs Pointer to an array of uCount pointers to buffers to hash
+	\param pLengths Pointer to an array of uCount buffer lengths in bytes
+	\param uCount Number of buffers to hash
+
+	\sa Hash(SHA1_t *,const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::HashMultiple(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount)
+{
+#if defined(SHA1_SIMD)
+	const CPUID_t *pCPUID = GetCPUID();
+	Word uLanes = 0;
+	// The SHA extensions are faster than 8 lanes of AVX2
+	if (!pCPUID->HasSHA() || !pCPUID->HasSSSE3()) {
+#if defined(SHA1_AVX)
+		if (pCPUID->HasAVX2() && pCPUID->IsAVXEnabled()) {
+			uLanes = 8;
+		} else
+#endif
+		if (pCPUID->HasSSE2()) {
+			uLanes = 4;
+		}
+	}
+	if (uLanes) {
+		while (uCount) {
+			WordPtr uGroup = uCount;
+			if (uGroup>uLanes) {
+				uGroup = uLanes;
+			}
+
+			// Find the number of blocks all the messages have.
+			// Unused lanes hash the first message again
+			const Word8 *pInputs[8];
+			WordPtr uBlocks = pLengths[0]>>6;
+			Word i = 0;
+			do {
+				Word uSource = (i<uGroup) ? i : 0;
+				pInputs[i] = static_cast<const Word8 *>(ppInputs[uSource]);
+				if ((pLengths[uSource]>>6)<uBlocks) {
+					uBlocks = pLengths[uSource]>>6;
+				}
+			} while (++i<uLanes);
+
+			// Transpose the starting hash, one row per hash word
+			Word32 State[5*8];
+			i = 0;
+			do {
+				State[i] = 0x67452301;
+				State[i+8] = 0xefcdab89;
+				State[i+16] = 0x98badcfe;
+				State[i+24] = 0x10325476;
+				State[i+32] = 0xc3d2e1f0;
+			} while (++i<8);
+
+			if (uBlocks) {
+#if defined(SHA1_AVX)
+				if (uLanes==8) {
+					SHA1ProcessLanesAVX2(State,pInputs,uBlocks);
+				} else
+#endif
+				{
+					SHA1ProcessLanesSSE2(State,pInputs,uBlocks);
+				}
+			}
+
+			// Finish each message on its own
+			WordPtr uProcessed = uBlocks<<6;
+			i = 0;
+			do {
+				SHA1Hasher_t Context;
+				Word32 *pHash32 = static_cast<Word32 *>(static_cast<void *>(Context.m_Hash.m_Hash));
+				BigEndian::Store(pHash32,State[i]);
+				BigEndian::Store(pHash32+1,State[i+8]);
+				BigEndian::Store(pHash32+2,State[i+16]);
+				BigEndian::Store(pHash32+3,State[i+24]);
+				BigEndian::Store(pHash32+4,State[i+32]);
+				Context.m_uByteCount = uProcessed;
+				Context.Process(pInputs[i]+uProcessed,pLengths[i]-uProcessed);
+				Context.Finalize();
+				MemoryCopy(&pOutput[i],&Context.m_Hash,20);
+			} while (++i<uGroup);
+
+			pOutput += uGroup;
+			ppInputs += uGroup;
+			pLengths += uGroup;
+			uCount -= uGroup;
+		}
+		return;
+	}
+#endif
+	if (uCount) {
+		do {
+			Hash(pOutput,ppInputs[0],pLengths[0]);
+			++pOutput;
+			++ppInputs;
+			++pLengths;
+		} while (--uCount);
+	}
+}
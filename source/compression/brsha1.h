@@ -41,6 +41,7 @@ struct SHA1Hasher_t {
 };
 
 extern void BURGER_API Hash(SHA1_t *pOutput,const void *pInput,WordPtr uLength);
+extern void BURGER_API HashMultiple(SHA1_t *pOutput,const void * const *ppInputs,const WordPtr *pLengths,WordPtr uCount);
 
 }
 /* END */
@@ -0,0 +1,387 @@
+/***************************************
+
+	xxHash64 hash manager (Yann Collet's algorithm)
+
+	Implemented following the documentation found in
+	https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brxxhash.h"
+#include "brendian.h"
+#include "brfixedpoint.h"
+#include "brstringfunctions.h"
+
+//
+// The five primes used by xxHash64
+//
+
+#if !defined(DOXYGEN)
+#define XXH_PRIME1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME3 0x165667B19E3779F9ULL
+#define XXH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME5 0x27D4EB2F165667C5ULL
+#endif
+
+//
+// Load little endian values from any address
+//
+
+static BURGER_INLINE Word64 XXHashLoad64(const Word8 *pInput)
+{
+#if defined(BURGER_INTELARCHITECTURE)
+	// Intel processors read misaligned data in hardware
+	return static_cast<const Word64 *>(static_cast<const void *>(pInput))[0];
+#else
+	return Burger::LittleEndian::LoadAny(static_cast<const Word64 *>(static_cast<const void *>(pInput)));
+#endif
+}
+
+static BURGER_INLINE Word32 XXHashLoad32(const Word8 *pInput)
+{
+#if defined(BURGER_INTELARCHITECTURE)
+	return static_cast<const Word32 *>(static_cast<const void *>(pInput))[0];
+#else
+	return Burger::LittleEndian::LoadAny(static_cast<const Word32 *>(static_cast<const void *>(pInput)));
+#endif
+}
+
+static BURGER_INLINE void XXHashStore64(Word8 *pOutput,Word64 uInput)
+{
+#if defined(BURGER_INTELARCHITECTURE)
+	static_cast<Word64 *>(static_cast<void *>(pOutput))[0] = uInput;
+#else
+	Burger::LittleEndian::StoreAny(static_cast<Word64 *>(static_cast<void *>(pOutput)),uInput);
+#endif
+}
+
+//
+// Convert to lower case 8 bytes at a time. Each byte's
+// high bit is used to test for 'A' to 'Z' without a carry
+// into the next byte
+//
+
+static void XXHashToLower(Word8 *pOutput,const Word8 *pInput,WordPtr uLength)
+{
+	WordPtr uCount = uLength>>3U;
+	if (uCount) {
+		do {
+			Word64 uData = XXHashLoad64(pInput);
+			Word64 uLow7 = uData&0x7F7F7F7F7F7F7F7FULL;
+			// High bit set if >='A' and <='Z' and the byte is not >=0x80
+			Word64 uMask = (uLow7+0x3F3F3F3F3F3F3F3FULL)&(~(uLow7+0x2525252525252525ULL))&(~uData)&0x8080808080808080ULL;
+			XXHashStore64(pOutput,uData|(uMask>>2U));
+			pInput += 8;
+			pOutput += 8;
+		} while (--uCount);
+	}
+	uLength &= 7;
+	if (uLength) {
+		do {
+			pOutput[0] = static_cast<Word8>(Burger::ToLower(pInput[0]));
+			++pInput;
+			++pOutput;
+		} while (--uLength);
+	}
+}
+
+//
+// Mix 8 bytes of input into an accumulator
+//
+
+static BURGER_INLINE Word64 XXHashRound(Word64 uAccumulator,Word64 uInput)
+{
+	uAccumulator += uInput*XXH_PRIME2;
+	return Burger::RotateLeft(uAccumulator,31)*XXH_PRIME1;
+}
+
+//
+// Fold an accumulator into the hash
+//
+
+static BURGER_INLINE Word64 XXHashMerge(Word64 uHash,Word64 uAccumulator)
+{
+	uHash ^= XXHashRound(0,uAccumulator);
+	return (uHash*XXH_PRIME1)+XXH_PRIME4;
+}
+
+//
+// Process as many 32 byte stripes as possible, return the
+// number of bytes processed
+//
+
+static WordPtr XXHashStripes(Word64 *pState,const Word8 *pInput,WordPtr uLength)
+{
+	Word64 v1 = pState[0];
+	Word64 v2 = pState[1];
+	Word64 v3 = pState[2];
+	Word64 v4 = pState[3];
+	WordPtr uCount = uLength>>5U;
+	if (uCount) {
+		do {
+			v1 = XXHashRound(v1,XXHashLoad64(pInput));
+			v2 = XXHashRound(v2,XXHashLoad64(pInput+8));
+			v3 = XXHashRound(v3,XXHashLoad64(pInput+16));
+			v4 = XXHashRound(v4,XXHashLoad64(pInput+24));
+			pInput += 32;
+		} while (--uCount);
+	}
+	pState[0] = v1;
+	pState[1] = v2;
+	pState[2] = v3;
+	pState[3] = v4;
+	return uLength&(~static_cast<WordPtr>(31U));
+}
+
+//
+// Combine the accumulators into a single hash
+//
+
+static Word64 XXHashCombine(const Word64 *pState)
+{
+	Word64 uHash = Burger::RotateLeft(pState[0],1)+Burger::RotateLeft(pState[1],7)+
+		Burger::RotateLeft(pState[2],12)+Burger::RotateLeft(pState[3],18);
+	uHash = XXHashMerge(uHash,pState[0]);
+	uHash = XXHashMerge(uHash,pState[1]);
+	uHash = XXHashMerge(uHash,pState[2]);
+	return XXHashMerge(uHash,pState[3]);
+}
+
+//
+// Mix in the last 0-31 bytes and scramble the bits
+//
+
+static Word64 XXHashFinish(Word64 uHash,const Word8 *pInput,WordPtr uLength)
+{
+	while (uLength>=8) {
+		uHash ^= XXHashRound(0,XXHashLoad64(pInput));
+		uHash = (Burger::RotateLeft(uHash,27)*XXH_PRIME1)+XXH_PRIME4;
+		pInput += 8;
+		uLength -= 8;
+	}
+	if (uLength>=4) {
+		uHash ^= static_cast<Word64>(XXHashLoad32(pInput))*XXH_PRIME1;
+		uHash = (Burger::RotateLeft(uHash,23)*XXH_PRIME2)+XXH_PRIME3;
+		pInput += 4;
+		uLength -= 4;
+	}
+	if (uLength) {
+		do {
+			uHash ^= static_cast<Word64>(pInput[0])*XXH_PRIME5;
+			uHash = Burger::RotateLeft(uHash,11)*XXH_PRIME1;
+			++pInput;
+		} while (--uLength);
+	}
+
+	// Avalanche
+	uHash ^= uHash>>33U;
+	uHash *= XXH_PRIME2;
+	uHash ^= uHash>>29U;
+	uHash *= XXH_PRIME3;
+	return uHash^(uHash>>32U);
+}
+
+/*! ************************************
+
+	\struct Burger::XXHash64Hasher_t
+	\brief Multi-pass xxHash64 hash generator
+
+	This structure is needed to perform a multi-pass xxHash64 hash
+	and contains cached data and the running accumulators. The result
+	is the same as calling XXHash64(const void *,WordPtr,Word64) on
+	all of the data at once.
+	\code
+		Burger::XXHash64Hasher_t Context;
+		// Initialize
+		Context.Init();
+		// Process data in passes
+		Context.Process(Buffer1,sizeof(Buffer1));
+		Context.Process(Buffer2,sizeof(Buffer2));
+		// Wrap up the processing
+		Context.Finalize();
+		// Return the resulting hash
+		Word64 uHash = Context.m_uHash;
+	\endcode
+
+	\sa XXHash64(const void *,WordPtr,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize the xxHash64 hasher
+
+	Call this function before any hashing is performed
+
+	\param uSeed Value to seed the hash with.
+	\sa Process(const void *,WordPtr) or Finalize(void)
+
+***************************************/
+
+void BURGER_API Burger::XXHash64Hasher_t::Init(Word64 uSeed)
+{
+	m_uHash = 0;
+	m_uState[0] = uSeed+XXH_PRIME1+XXH_PRIME2;
+	m_uState[1] = uSeed+XXH_PRIME2;
+	// Finalize() uses this as the seed if less than 32 bytes were hashed
+	m_uState[2] = uSeed;
+	m_uState[3] = uSeed-XXH_PRIME1;
+	m_uByteCount = 0;
+}
+
+/*! ************************************
+
+	\brief Process an arbitrary number of input bytes
+
+	Process input data into the hash. If data chunks are not
+	a multiple of 32 bytes, the excess will be cached and
+	a future call will continue the hashing where it left
+	off.
+
+	\param pInput Pointer to a buffer of data to hash
+	\param uLength Number of bytes to hash
+	\sa Finalize(void)
+
+***************************************/
+
+void BURGER_API Burger::XXHash64Hasher_t::Process(const void *pInput,WordPtr uLength)
+{
+	// Compute number of bytes mod 32
+	WordPtr uIndex = static_cast<WordPtr>(m_uByteCount)&0x1FU;
+	m_uByteCount += uLength;
+
+	const Word8 *pWork = static_cast<const Word8 *>(pInput);
+	if (uIndex) {
+		// Fill the cache first
+		WordPtr uFill = 32-uIndex;
+		if (uLength<uFill) {
+			MemoryCopy(&m_CacheBuffer[uIndex],pWork,uLength);
+			return;
+		}
+		MemoryCopy(&m_CacheBuffer[uIndex],pWork,uFill);
+		XXHashStripes(m_uState,m_CacheBuffer,32);
+		pWork += uFill;
+		uLength -= uFill;
+	}
+
+	// Hash directly from the input and cache the remainder
+	WordPtr uProcessed = XXHashStripes(m_uState,pWork,uLength);
+	MemoryCopy(m_CacheBuffer,pWork+uProcessed,uLength-uProcessed);
+}
+
+/*! ************************************
+
+	\brief Finalize the hashing
+
+	When multi-pass hashing is performed, this call is necessary to
+	finalize the hash and store it in m_uHash.
+
+	\sa Init(Word64), Process(const void *,WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::XXHash64Hasher_t::Finalize(void)
+{
+	Word64 uHash;
+	if (m_uByteCount>=32) {
+		uHash = XXHashCombine(m_uState);
+	} else {
+		uHash = m_uState[2]+XXH_PRIME5;
+	}
+	m_uHash = XXHashFinish(uHash+m_uByteCount,m_CacheBuffer,static_cast<WordPtr>(m_uByteCount)&0x1FU);
+}
+
+/*! ************************************
+
+	\brief Hash data using the xxHash64 algorithm
+
+	xxHash64 was created by Yann Collet. It processes 32 bytes per
+	iteration in four independent 64 bit lanes and mixes every input
+	bit into every output bit, so both the low bits used by HashMap's
+	power of 2 masking and the high bits are well distributed.
+
+	The result matches the reference implementation, so hashes can
+	be compared with other tools.
+
+	Further reading: http://cyan4973.github.io/xxHash/
+
+	\param pInput Pointer to the data to hash
+	\param uInputCount Number of bytes of data to hash
+	\param uHashSeed Value to seed the hash with.
+	\return 64 bit hash value generated by the data.
+	\sa XXHash64Case(const void *,WordPtr,Word64) or XXHash64Hasher_t
+
+***************************************/
+
+Word64 BURGER_API Burger::XXHash64(const void *pInput,WordPtr uInputCount,Word64 uHashSeed)
+{
+	const Word8 *pWork = static_cast<const Word8 *>(pInput);
+	Word64 uHash;
+	if (uInputCount>=32) {
+		Word64 State[4];
+		State[0] = uHashSeed+XXH_PRIME1+XXH_PRIME2;
+		State[1] = uHashSeed+XXH_PRIME2;
+		State[2] = uHashSeed;
+		State[3] = uHashSeed-XXH_PRIME1;
+		WordPtr uProcessed = XXHashStripes(State,pWork,uInputCount);
+		uHash = XXHashCombine(State);
+		pWork += uProcessed;
+	} else {
+		uHash = uHashSeed+XXH_PRIME5;
+	}
+	return XXHashFinish(uHash+uInputCount,pWork,uInputCount&0x1FU);
+}
+
+/*! ************************************
+
+	\brief Hash string data using forced lower case using the xxHash64 algorithm
+
+	The data is converted to lower case in small chunks and passed to
+	an XXHash64Hasher_t. The result is the same as calling
+	XXHash64(const void *,WordPtr,Word64) on a lower case copy of the data.
+
+	\note This function converts all upper case characters into lower case
+		to yield a case insensitive hash
+
+	\param pInput Pointer to the data to hash
+	\param uInputCount Number of bytes of data to hash
+	\param uHashSeed Value to seed the hash with.
+	\return 64 bit hash value generated by the data.
+	\sa XXHash64(const void *,WordPtr,Word64)
+
+***************************************/
+
+Word64 BURGER_API Burger::XXHash64Case(const void *pInput,WordPtr uInputCount,Word64 uHashSeed)
+{
+	Word8 Buffer[256];
+	const Word8 *pWork = static_cast<const Word8 *>(pInput);
+
+	// Short strings are hashed in a single pass
+	if (uInputCount<=sizeof(Buffer)) {
+		XXHashToLower(Buffer,pWork,uInputCount);
+		return XXHash64(Buffer,uInputCount,uHashSeed);
+	}
+
+	XXHash64Hasher_t Context;
+	Context.Init(uHashSeed);
+	do {
+		WordPtr uChunk = uInputCount;
+		if (uChunk>sizeof(Buffer)) {
+			uChunk = sizeof(Buffer);
+		}
+		XXHashToLower(Buffer,pWork,uChunk);
+		Context.Process(Buffer,uChunk);
+		pWork += uChunk;
+		uInputCount -= uChunk;
+	} while (uInputCount);
+	Context.Finalize();
+	return Context.m_uHash;
+}
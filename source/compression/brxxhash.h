@@ -0,0 +1,41 @@
+/***************************************
+
+	xxHash64 hash manager (Yann Collet's algorithm)
+
+	Implemented following the documentation found in
+	https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+	
+***************************************/
+
+#ifndef __BRXXHASH_H__
+#define __BRXXHASH_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct XXHash64Hasher_t {
+	Word64 m_uHash;				///< Hash value after Finalize() is called
+	Word64 m_uState[4];			///< Running accumulators, one for each 8 bytes of a 32 byte stripe
+	Word64 m_uByteCount;		///< Number of bytes processed (64 bit value)
+	Word8 m_CacheBuffer[32];	///< input buffer for processing
+
+	void BURGER_API Init(Word64 uSeed=0);
+	void BURGER_API Process(const void *pInput,WordPtr uLength);
+	void BURGER_API Finalize(void);
+};
+extern Word64 BURGER_API XXHash64(const void *pInput,WordPtr uInputCount,Word64 uHashSeed=0);
+extern Word64 BURGER_API XXHash64Case(const void *pInput,WordPtr uInputCount,Word64 uHashSeed=0);
+}
+/* END */
+
+#endif
@@ -42,6 +42,7 @@
 Burger::File::File() :
 	m_pFile(NULL),
 	m_uPosition(0),
+	m_uAsyncResult(0),
 	m_Filename(),
 	m_Semaphore()
 {
@@ -67,6 +68,7 @@ Burger::File::File() :
 Burger::File::File(const char *pFileName,eFileAccess eAccess) :
 	m_pFile(NULL),
 	m_uPosition(0),
+	m_uAsyncResult(0),
 	m_Filename(pFileName),
 	m_Semaphore()
 {
@@ -93,6 +95,7 @@ Burger::File::File(const char *pFileName,eFileAccess eAccess) :
 Burger::File::File(Filename *pFileName,eFileAccess eAccess) :
 	m_pFile(NULL),
 	m_uPosition(0),
+	m_uAsyncResult(0),
 	m_Filename(pFileName[0]),
 	m_Semaphore()
 {
@@ -224,7 +227,7 @@ Word BURGER_API Burger::File::Open(const char *pFileName,eFileAccess eAccess)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::File::Open(Filename *pFileName,eFileAccess eAccess)
 {
 	static const char *g_OpenFlags[4] = {
@@ -526,6 +529,30 @@ Word BURGER_API Burger::File::ReadAsync(void *pOutput,WordPtr uSize)
 	return 0;
 }
 
+/*! ************************************
+
+	\brief Queue a scatter read
+
+	Read data from the file mark into several buffers in
+	order, as if ReadAsync() was called for each one. The total
+	number of bytes read is passed to the next callback.
+
+	\note The array of vectors and the buffers must remain valid
+	until the read completes.
+
+	\param pVectors Pointer to an array of buffers to fill
+	\param uCount Number of entries in the array
+	\return Zero
+	\sa ReadAsync(void *,WordPtr) or FileManager::QueueCallback(File *,FileManager::ProcCallback)
+
+***************************************/
+
+Word BURGER_API Burger::File::ReadVectorAsync(const FileManager::IOVector_t *pVectors,Word uCount)
+{
+	FileManager::g_pFileManager->AddQueue(this,FileManager::IOCOMMAND_READVECTOR,const_cast<FileManager::IOVector_t *>(pVectors),uCount);
+	return 0;
+}
+
 
 /*! ************************************
 
@@ -30,6 +30,10 @@
 #include "brcriticalsection.h"
 #endif
 
+#ifndef __BRFILEMANAGER_H__
+#include "brfilemanager.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 class File {
@@ -53,6 +57,7 @@ public:
 private:
 	void *m_pFile;				///< Open file reference
 	WordPtr m_uPosition;		///< Seek position
+	WordPtr m_uAsyncResult;		///< Result of the last asynchronous command, passed to the next callback
 	Filename m_Filename;		///< Name of the file that was opened
 	Semaphore m_Semaphore;		///< Semaphore for syncing file operations
 #if defined(BURGER_MAC) || defined(DOXYGEN)
@@ -76,6 +81,7 @@ public:
 	WordPtr BURGER_API GetSize(void);
 	WordPtr BURGER_API Read(void *pOutput,WordPtr uSize);
 	Word BURGER_API ReadAsync(void *pOutput,WordPtr uSize);
+	Word BURGER_API ReadVectorAsync(const FileManager::IOVector_t *pVectors,Word uCount);
 	WordPtr BURGER_API Write(const void *pInput,WordPtr uSize);
 	WordPtr BURGER_API GetMark(void);
 	Word BURGER_API SetMark(WordPtr uMark);
@@ -16,6 +16,8 @@
 #include "brfileansihelpers.h"
 #include "brdebug.h"
 #include "brglobals.h"
+#include "bratomic.h"
+#include "brstringfunctions.h"
 #include <stdio.h>
 
 #if defined(BURGER_XBOX360)
@@ -82,15 +84,31 @@ Burger::FileManager *Burger::FileManager::g_pFileManager;
 /*! ************************************
 
 	\brief Construct the file manager
-	
+
+	Allocate the asynchronous IO queue and start the
+	worker thread that services it.
+
+	\param uQueueDepth Number of entries in the IO queue (Power of 2)
+
 ***************************************/
 
-Burger::FileManager::FileManager() :
+Burger::FileManager::FileManager(Word uQueueDepth) :
 	m_PingIOThread(),
-	m_IOThreadSync(),
+	m_QueueSpace(static_cast<Word32>(uQueueDepth)),
 	m_Thread(),
+	m_SyncLock(),
+	m_SyncDone(),
+	m_uSyncsIssued(0),
+	m_uSyncsDone(0),
 	m_uQueueStart(0),
-	m_uQueueEnd(0)
+	m_uQueueEnd(0),
+	m_uQueueMask(static_cast<Word32>(uQueueDepth-1)),
+	m_uLastError(0),
+	m_pIOQueue(NULL),
+	m_pBatch(NULL)
+#if defined(BURGER_LINUX)
+	,m_pIOUring(NULL)
+#endif
 #if defined(BURGER_MSDOS)
 	,m_bAllowed(FALSE)
 #endif
@@ -100,12 +118,20 @@ Burger::FileManager::FileManager() :
 #endif
 {
 	MemoryClear(m_pPrefix,sizeof(m_pPrefix));
-	MemoryClear(m_IOQueue,sizeof(m_IOQueue));
 
-#if 0
-	// Start up the worker thread
-	m_Thread.Start(QueueHandler,this);
+	// The ring buffer and the batch share one allocation
+	Queue_t *pQueue = static_cast<Queue_t *>(AllocClear(sizeof(Queue_t)*2*uQueueDepth));
+	if (pQueue) {
+		m_pIOQueue = pQueue;
+		m_pBatch = pQueue+uQueueDepth;
+
+		// Start up the worker thread on platforms that have threads.
+		// Otherwise, AddQueue() performs the commands immediately.
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || \
+	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
+		m_Thread.Start(QueueHandler,this);
 #endif
+	}
 }
 
 /*! ************************************
@@ -116,10 +142,16 @@ Burger::FileManager::FileManager() :
 
 Burger::FileManager::~FileManager()
 {
-	// Send a message to kill the thread
-	AddQueue(NULL,IOCOMMAND_ENDTHREAD,NULL,0);
-	// Wait until the thread dies
-	m_Thread.Wait();
+	if (m_Thread.IsInitialized()) {
+		// Send a message to kill the thread
+		AddQueue(NULL,IOCOMMAND_ENDTHREAD,NULL,0);
+		// Wait until the thread dies
+		m_Thread.Wait();
+	}
+	Free(m_pIOQueue);
+	m_pIOQueue = NULL;
+	m_pBatch = NULL;
+
 	// Release all of my prefixes
 	Word i = PREFIXMAX;
 	const char **pTable = m_pPrefix;
@@ -143,16 +175,29 @@ Burger::FileManager::~FileManager()
 	Call this function once on startup to start up
 	the burgerlib file manager. This function's primary
 	purpose is to initialize the default prefixes.
+
+	The depth of the asynchronous IO queue is rounded up to
+	a power of 2. When the queue is full, threads issuing
+	asynchronous commands will sleep until the IO thread
+	has consumed an entry.
 	
+	\param uQueueDepth Maximum number of pending asynchronous IO commands
 	\sa Burger::FileManager::DefaultPrefixes(void) or Burger::FileManager::Shutdown(void)
 
 ***************************************/
 
-void BURGER_API Burger::FileManager::Init(void)
+void BURGER_API Burger::FileManager::Init(Word uQueueDepth)
 {
 	FileManager *pThis = g_pFileManager;
 	if (!pThis) {
-		pThis = new (Alloc(sizeof(FileManager))) FileManager;
+		// Sanity check the queue size
+		if (uQueueDepth<4) {
+			uQueueDepth = 4;
+		} else if (uQueueDepth>0x10000U) {
+			uQueueDepth = 0x10000U;
+		}
+		uQueueDepth = PowerOf2(static_cast<Word32>(uQueueDepth));
+		pThis = new (Alloc(sizeof(FileManager))) FileManager(uQueueDepth);
 		g_pFileManager = pThis;
 
 		// Init the directory cache (MacOS)
@@ -205,6 +250,127 @@ void BURGER_API Burger::FileManager::Shutdown(void)
 	}
 }
 
+/*! ************************************
+
+	\brief Return the number of entries in the asynchronous IO queue
+
+	\return Number of commands that can be pending at once, zero if the file manager isn't started
+	\sa Burger::FileManager::Init(Word)
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetQueueDepth(void)
+{
+	Word uResult = 0;
+	FileManager *pThis = g_pFileManager;
+	if (pThis) {
+		uResult = pThis->m_uQueueMask+1;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Issue a completion callback from the IO thread
+
+	Append a callback to the asynchronous IO queue. Once all
+	of the commands issued before it have completed, the
+	callback is invoked from the IO thread with a copy of the
+	queue entry. Queue_t::m_pFile is set to pFile and
+	Queue_t::m_uLength contains the result of the last command
+	issued on pFile. Since commands from many threads are
+	interleaved, results are tracked per file.
+
+	Callbacks are delivered in batches. All the callbacks found
+	in a run of commands are issued after the run has been
+	processed so the IO thread isn't interleaving user code
+	with file operations.
+
+	\note Do not call FlushIO() from within a callback, the IO thread
+	will wait on itself.
+
+	\param pFile Pointer to the Burger::File the callback refers to, can be \ref NULL
+	\param pCallback Function to call
+	\sa Burger::FileManager::FlushIO(void)
+
+***************************************/
+
+void BURGER_API Burger::FileManager::QueueCallback(File *pFile,ProcCallback pCallback)
+{
+	g_pFileManager->AddQueue(pFile,IOCOMMAND_CALLBACK,reinterpret_cast<void *>(pCallback),0);
+}
+
+/*! ************************************
+
+	\brief Wait until all pending asynchronous IO has completed
+
+	Place a sync command in the IO queue and sleep until the
+	IO thread reaches it. All commands and callbacks issued before
+	this call by any thread are complete when this function returns.
+
+	Each sync command carries a ticket number and the IO thread
+	records the highest ticket it has reached. The caller waits on a
+	ConditionVariable owned by the FileManager until its ticket is
+	reached, so the IO thread never touches the caller's stack.
+
+	\sa Burger::FileManager::QueueCallback(File *,ProcCallback)
+
+***************************************/
+
+void BURGER_API Burger::FileManager::FlushIO(void)
+{
+	FileManager *pThis = g_pFileManager;
+	if (pThis && pThis->m_Thread.IsInitialized()) {
+		Word32 uTicket = AtomicPreIncrement(&pThis->m_uSyncsIssued);
+		pThis->AddQueue(NULL,IOCOMMAND_SYNC,NULL,uTicket);
+		pThis->m_SyncLock.Lock();
+		// Tickets can wrap, so test the difference
+		while (static_cast<Int32>(pThis->m_uSyncsDone-uTicket)<0) {
+			pThis->m_SyncDone.Wait(&pThis->m_SyncLock);
+		}
+		pThis->m_SyncLock.Unlock();
+	}
+}
+
+/*! ************************************
+
+	\brief Register buffers for fixed buffer reads
+
+	On platforms that support it, such as io_uring on Linux,
+	buffers can be pinned by the operating system ahead of time
+	so reads into them skip the per read page mapping. Once
+	registered, any asynchronous read whose destination lies
+	entirely inside one of the buffers is issued as a fixed buffer read.
+
+	Registering a new set of buffers releases the previous set.
+	Pass \ref NULL and zero to release all of the buffers.
+
+	\note The buffers must remain valid until they are released.
+
+	\param pBuffers Array of buffers to register
+	\param uCount Number of buffers, up to \ref cMaxFixedBuffers
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not supported or another error code
+	\sa Burger::File::ReadAsync(void *,WordPtr)
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::RegisterBuffers(const IOVector_t *pBuffers,Word uCount)
+{
+	Word uResult = File::NOT_IMPLEMENTED;
+	FileManager *pThis = g_pFileManager;
+	if (pThis && pThis->m_Thread.IsInitialized()) {
+		// Let the IO thread perform the registration in order
+		RegisterBuffers_t Request;
+		Request.m_pBuffers = pBuffers;
+		Request.m_uCount = uCount;
+		Request.m_uResult = File::NOT_IMPLEMENTED;
+		pThis->AddQueue(NULL,IOCOMMAND_REGISTERBUFFERS,&Request,0);
+		FlushIO();
+		uResult = Request.m_uResult;
+	}
+	return uResult;
+}
+
 /*! ************************************
 
 	\fn Burger::FileManager::AreLongFilenamesAllowed(void)
@@ -320,7 +486,7 @@ Word BURGER_API Burger::FileManager::GetVolumeNumber(const char *pVolumeName)
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 void BURGER_API Burger::FileManager::DefaultPrefixes(void)
 {
@@ -495,7 +661,7 @@ Word BURGER_API Burger::FileManager::GetModificationTime(const char *pFileName,T
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::GetModificationTime(Filename * /* pFileName */,TimeDate_t * /* pOutput */)
 {
 	return TRUE;		// Error!
@@ -538,7 +704,7 @@ Word BURGER_API Burger::FileManager::GetCreationTime(const char *pFileName,TimeD
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::GetCreationTime(Filename * /* pFileName */,TimeDate_t * /* pOutput */)
 {
 	return TRUE;		// Error!
@@ -582,7 +748,7 @@ Word BURGER_API Burger::FileManager::DoesFileExist(const char *pFileName)
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::DoesFileExist(Filename *pFileName)
 {
 #if defined(BURGER_DS)
@@ -972,7 +1138,7 @@ Word BURGER_API Burger::FileManager::CreateDirectoryPath(const char *pFileName)
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::CreateDirectoryPath(Filename * /* pFileName */ )
 {
 	return File::NOT_IMPLEMENTED;		// Always error out
@@ -1073,7 +1239,7 @@ Word BURGER_API Burger::FileManager::DeleteFile(const char *pFileName)
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::DeleteFile(Filename *pFileName)
 {
 #if defined(BURGER_DS)
@@ -1127,7 +1293,7 @@ Word BURGER_API Burger::FileManager::RenameFile(const char *pNewName,const char
 	
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::RenameFile(Filename *pNewName,Filename *pOldName)
 {
 #if defined(BURGER_DS)
@@ -1187,7 +1353,7 @@ Word BURGER_API Burger::FileManager::ChangeOSDirectory(const char *pDirName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::ChangeOSDirectory(Filename * /* pDirName */)
 {
 	return File::NOT_IMPLEMENTED;	// Error!
@@ -1244,7 +1410,7 @@ FILE * BURGER_API Burger::FileManager::OpenFile(const char *pFileName,const char
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 FILE * BURGER_API Burger::FileManager::OpenFile(Filename *pFileName,const char *pType)
 {
 #if defined(BURGER_DS)
@@ -1541,28 +1707,319 @@ void * BURGER_API Burger::FileManager::LoadFile(Filename *pFileName,WordPtr *pLe
 #endif
 }
 
+/*! ************************************
+
+	\brief Append a command to the asynchronous IO queue
+
+	The queue is a bounded ring buffer shared by any number of
+	producer threads and consumed by a single IO thread.
+	A producer first acquires a free entry from m_QueueSpace,
+	sleeping if the queue is full, then claims a unique
+	position with an atomic increment. Once the entry is filled
+	in, its sequence number is set to publish it and the IO
+	thread is pinged. No lock is taken.
+
+	If there is no IO thread, the command is executed immediately.
+
+	\param pFile Pointer to the file to perform the command on
+	\param uIOCommand Command to execute
+	\param pBuffer Pointer to the data buffer or callback
+	\param uLength Length of the buffer or a command parameter
+
+***************************************/
+
 void BURGER_API Burger::FileManager::AddQueue(File *pFile,eIOCommand uIOCommand,void *pBuffer,WordPtr uLength)
 {
-	WaitUntilQueueHasSpace();
+	// No worker thread? Do it now.
+	if (!m_Thread.IsInitialized()) {
+		Queue_t Temp;
+		Temp.m_pFile = pFile;
+		Temp.m_pBuffer = pBuffer;
+		Temp.m_uLength = uLength;
+		Temp.m_uIOCommand = uIOCommand;
+		Temp.m_uSequence = 0;
+		WordPtr *pResult = pFile ? &pFile->m_uAsyncResult : &m_uLastError;
+		if (uIOCommand==IOCOMMAND_CALLBACK) {
+			Temp.m_uLength = pResult[0];
+			pResult[0] = 0;
+			reinterpret_cast<ProcCallback>(pBuffer)(&Temp);
+		} else {
+			pResult[0] = ExecuteIO(&Temp);
+		}
+		return;
+	}
 
-	// Get the pointer to the end of the queue
+	// Sleep if the IO thread has fallen behind
+	WaitUntilQueueHasSpace();
 
-	Word32 uEnd = m_uQueueEnd;
+	// Claim a position, no other producer will get this entry
+	Word32 uPosition = AtomicPostIncrement(&m_uQueueEnd);
+	Queue_t *pQueue = &m_pIOQueue[uPosition&m_uQueueMask];
 
-	// Get the pointer to the next entry
-	Queue_t *pQueue = &m_IOQueue[uEnd];
 	// Fill it in
 	pQueue->m_pFile = pFile;
 	pQueue->m_uIOCommand = uIOCommand;
 	pQueue->m_pBuffer = pBuffer;
 	pQueue->m_uLength = uLength;
-	m_uQueueEnd = (uEnd+1)&(cMaxQueue-1);
+
+	// Publish the entry (The swap is a full memory barrier)
+	AtomicSwap(&pQueue->m_uSequence,uPosition+1);
 
 	// Send a message to the thread to execute
 	m_PingIOThread.Release();
 }
 
+/*! ************************************
+
+	\brief Execute a single file command
+
+	Perform the file operation requested by a queue entry
+	by calling the synchronous Burger::File functions.
+
+	\param pQueue Pointer to the command to execute
+	\return Result of the command, passed to the next callback
+
+***************************************/
+
+WordPtr BURGER_API Burger::FileManager::ExecuteIO(const Queue_t *pQueue)
+{
+	WordPtr uResult = 0;
+	File *pFile = pQueue->m_pFile;
+	switch (pQueue->m_uIOCommand) {
+
+	// Open a file
+	case IOCOMMAND_OPEN:
+		uResult = pFile->Open(&pFile->m_Filename,static_cast<File::eFileAccess>(pQueue->m_uLength&3));
+		break;
+
+	// Close the file
+	case IOCOMMAND_CLOSE:
+		uResult = pFile->Close();
+		break;
+
+	// Read in data
+	case IOCOMMAND_READ:
+		uResult = pFile->Read(pQueue->m_pBuffer,pQueue->m_uLength);
+		break;
+
+	// Write out data
+	case IOCOMMAND_WRITE:
+		uResult = pFile->Write(pQueue->m_pBuffer,pQueue->m_uLength);
+		break;
+
+	// Seek the file
+	case IOCOMMAND_SEEK:
+		uResult = pFile->SetMark(pQueue->m_uLength);
+		break;
+
+	// Seek to the end of the file
+	case IOCOMMAND_SEEKEOF:
+		uResult = pFile->SetMarkAtEOF();
+		break;
+
+	// Read into several buffers, stop on a short read
+	case IOCOMMAND_READVECTOR:
+		{
+			const IOVector_t *pVector = static_cast<const IOVector_t *>(pQueue->m_pBuffer);
+			WordPtr uCount = pQueue->m_uLength;
+			if (uCount) {
+				do {
+					WordPtr uRead = pFile->Read(pVector->m_pBuffer,pVector->m_uLength);
+					uResult += uRead;
+					if (uRead!=pVector->m_uLength) {
+						break;
+					}
+					++pVector;
+				} while (--uCount);
+			}
+		}
+		break;
+
+	default:;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Execute a batch of commands
+
+	Reads are handed to the platform IO engine, if one is
+	present, so many of them are in flight at once. Every other
+	command waits for the outstanding reads to finish before
+	it is executed, so the order of the commands is
+	preserved. Once the whole batch is done, the results are
+	passed along to the completion callbacks which are issued
+	in order.
+
+	A sync or end thread command is always the last entry
+	in a batch.
+
+	\param pBatch Pointer to an array of commands
+	\param uCount Number of commands in the batch (Can't be zero)
+	\return \ref TRUE if the IO thread was asked to exit
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::ProcessBatch(Queue_t *pBatch,Word uCount)
+{
+	// Execute all the commands, reads may be left in flight
+	Queue_t *pWork = pBatch;
+	Word i = uCount;
+	do {
+		switch (pWork->m_uIOCommand) {
+		case IOCOMMAND_READ:
+		case IOCOMMAND_READVECTOR:
+			if (!SubmitIO(pWork)) {
+				pWork->m_uLength = ExecuteIO(pWork);
+			}
+			break;
+
+		// These are handled below
+		case IOCOMMAND_CALLBACK:
+		case IOCOMMAND_SYNC:
+		case IOCOMMAND_ENDTHREAD:
+			break;
+
+		case IOCOMMAND_REGISTERBUFFERS:
+			{
+				CompleteIO();
+				RegisterBuffers_t *pRequest = static_cast<RegisterBuffers_t *>(pWork->m_pBuffer);
+				pRequest->m_uResult = RegisterIOBuffers(pRequest->m_pBuffers,pRequest->m_uCount);
+			}
+			break;
+
+		// Everything else needs the reads to be finished
+		default:
+			CompleteIO();
+			pWork->m_uLength = ExecuteIO(pWork);
+			break;
+		}
+		++pWork;
+	} while (--i);
+
+	// Wait for all the reads
+	CompleteIO();
+
+	// Pass the results and issue the callbacks
+	Word bQuit = FALSE;
+	do {
+		File *pFile = pBatch->m_pFile;
+		// Results are tracked per file since commands
+		// from many threads are interleaved
+		WordPtr *pResult = pFile ? &pFile->m_uAsyncResult : &m_uLastError;
+		switch (pBatch->m_uIOCommand) {
+		case IOCOMMAND_CALLBACK:
+			pBatch->m_uLength = pResult[0];
+			pResult[0] = 0;		// Release error
+			reinterpret_cast<ProcCallback>(pBatch->m_pBuffer)(pBatch);
+			break;
+
+		// Issue a sync command to signal that
+		// this command token was reached. Tickets from
+		// different threads can be queued out of order,
+		// so only move forward
+		case IOCOMMAND_SYNC:
+			m_SyncLock.Lock();
+			if (static_cast<Int32>(static_cast<Word32>(pBatch->m_uLength)-m_uSyncsDone)>0) {
+				m_uSyncsDone = static_cast<Word32>(pBatch->m_uLength);
+			}
+			m_SyncDone.Broadcast();
+			m_SyncLock.Unlock();
+			break;
+
+		// Was the thread requested to shut down?
+		case IOCOMMAND_ENDTHREAD:
+			bQuit = TRUE;
+			break;
+
+		case IOCOMMAND_REGISTERBUFFERS:
+			break;
+
+		default:
+			pResult[0] = pBatch->m_uLength;
+			break;
+		}
+		++pBatch;
+	} while (--uCount);
+	return bQuit;
+}
+
+/*! ************************************
+
+	\brief Worker thread for asynchronous file IO
+
+	Sleep until a producer pings, then copy out every
+	published entry in order. Each entry is returned to the
+	producers as soon as it's copied so the queue drains as
+	fast as possible. The copied commands are executed as a batch.
+
+	\param pData Pointer to the Burger::FileManager
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::FileManager::QueueHandler(void *pData)
+{
+	FileManager *pThis = static_cast<FileManager *>(pData);
+	Queue_t *pBatch = pThis->m_pBatch;
+	Word32 uMask = pThis->m_uQueueMask;
+	Word32 uPosition = pThis->m_uQueueStart;
+
+	// Use the platform's asynchronous IO, if available
+	pThis->StartIOEngine();
+
+	Word bQuit = FALSE;
+	do {
+		// Wait until there's a command in the queue
+		pThis->m_PingIOThread.Acquire();
+
+		for (;;) {
+			// Gather a run of commands
+			Word uCount = 0;
+			do {
+				Queue_t *pQueue = &pThis->m_pIOQueue[uPosition&uMask];
+
+				// Stop at an entry that was claimed but not published yet,
+				// its producer will ping again when it's ready.
+				// (The compare is a full memory barrier)
+				if (!AtomicSetIfMatch(&pQueue->m_uSequence,uPosition+1,uPosition+1)) {
+					break;
+				}
+
+				// Get the command and hand the entry back to the producers
+				Queue_t *pCommand = &pBatch[uCount];
+				pCommand->m_pFile = pQueue->m_pFile;
+				pCommand->m_pBuffer = pQueue->m_pBuffer;
+				pCommand->m_uLength = pQueue->m_uLength;
+				eIOCommand uIOCommand = pQueue->m_uIOCommand;
+				pCommand->m_uIOCommand = uIOCommand;
+				pCommand->m_uSequence = uPosition+1;
+				++uPosition;
+				pThis->m_uQueueStart = uPosition;
+				pThis->m_QueueSpace.Release();
+				++uCount;
+
+				// Syncs must be answered after everything before them
+				if ((uIOCommand==IOCOMMAND_SYNC) || (uIOCommand==IOCOMMAND_ENDTHREAD)) {
+					break;
+				}
+			} while (uCount<=uMask);
+
+			// Nothing left?
+			if (!uCount) {
+				break;
+			}
+			bQuit = pThis->ProcessBatch(pBatch,uCount);
+			if (bQuit) {
+				break;
+			}
+		}
+	} while (!bQuit);
 
+	pThis->ShutdownIOEngine();
+	return 0;
+}
 
 /*! ************************************
 
@@ -44,7 +44,8 @@ class File;
 class FileManager {
 	friend class File;
 public:
-	static const Word cMaxQueue = 128;	///< Maximum number of pending IO events (Power of 2)
+	static const Word cDefaultQueueDepth = 128;	///< Default number of pending IO events (Power of 2)
+	static const Word cMaxFixedBuffers = 16;	///< Maximum number of buffers that can be registered with RegisterBuffers()
 	enum {
 		PREFIXCURRENT=8,		///< 8: Current working directory at application launch
 		PREFIXAPPLICATION=9,	///< 9: Directory where the application executable resides
@@ -62,8 +63,10 @@ public:
 		IOCOMMAND_WRITE,	///< Pending write file command
 		IOCOMMAND_SEEK,		///< Pending seek file command
 		IOCOMMAND_SEEKEOF,	///< Pending seek to end of file command
+		IOCOMMAND_READVECTOR,	///< Pending scatter read file command
 		IOCOMMAND_CALLBACK,	///< Pending completion callback command
 		IOCOMMAND_SYNC,		///< Pending sync command
+		IOCOMMAND_REGISTERBUFFERS,	///< Pending fixed buffer registration command
 		IOCOMMAND_ENDTHREAD	///< Pending end thread command
 	};
 	struct Queue_t {
@@ -71,25 +74,60 @@ public:
 		void *m_pBuffer;			///< Pointer to the I/O buffer or callback pointer
 		WordPtr m_uLength;			///< Value to attach to the command
 		eIOCommand m_uIOCommand;	///< IO Command
+		volatile Word32 m_uSequence;	///< Queue position plus one, set when the entry is ready for the IO thread
+	};
+	struct IOVector_t {
+		void *m_pBuffer;			///< Pointer to the buffer
+		WordPtr m_uLength;			///< Size of the buffer in bytes
 	};
 	typedef	void (BURGER_API *ProcCallback)(Queue_t *pQueue);
 
 private:
-	FileManager();
+	struct RegisterBuffers_t {
+		const IOVector_t *m_pBuffers;	///< Array of buffers to register
+		Word m_uCount;					///< Number of entries in m_pBuffers
+		Word m_uResult;					///< Result from the IO thread
+	};
+	FileManager(Word uQueueDepth);
 	~FileManager();
-	void BURGER_API FlushIO(void) {}
-	void BURGER_API WaitUntilQueueHasSpace(void) {}
+	BURGER_INLINE void WaitUntilQueueHasSpace(void) { m_QueueSpace.Acquire(); }
 	void BURGER_API AddQueue(File *pFile,eIOCommand uIOCommand,void *pBuffer,WordPtr uLength);
-	void BURGER_API Sync(File *pFile);
+	static WordPtr BURGER_API ExecuteIO(const Queue_t *pQueue);
+	Word BURGER_API ProcessBatch(Queue_t *pBatch,Word uCount);
 	static WordPtr BURGER_API QueueHandler(void *pData);
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	void BURGER_API StartIOEngine(void);
+	void BURGER_API ShutdownIOEngine(void);
+	Word BURGER_API SubmitIO(Queue_t *pQueue);
+	void BURGER_API CompleteIO(void);
+	Word BURGER_API RegisterIOBuffers(const IOVector_t *pBuffers,Word uCount);
+#else
+	BURGER_INLINE void StartIOEngine(void) {}
+	BURGER_INLINE void ShutdownIOEngine(void) {}
+	BURGER_INLINE Word SubmitIO(Queue_t * /* pQueue */) { return FALSE; }
+	BURGER_INLINE void CompleteIO(void) {}
+	BURGER_INLINE Word RegisterIOBuffers(const IOVector_t * /* pBuffers */,Word /* uCount */) { return 1; }		// File::NOT_IMPLEMENTED
+#endif
 
 	Semaphore m_PingIOThread;			///< Semaphore to ping the IO thread
-	Semaphore m_IOThreadSync;			///< Semaphore to get a reply from the IO thread for syncing
+	Semaphore m_QueueSpace;				///< Semaphore counting the free entries in the IO queue
 	Thread m_Thread;					///< Worker thread record pointer
-	volatile Word32 m_uQueueStart;		///< Index to the queue start
-	volatile Word32 m_uQueueEnd;		///< Index to the end of the queue
+	CriticalSection m_SyncLock;			///< Lock for m_uSyncsDone
+	ConditionVariable m_SyncDone;		///< Signaled when the IO thread reaches a sync command
+	volatile Word32 m_uSyncsIssued;		///< Number of sync commands issued by FlushIO()
+	Word32 m_uSyncsDone;				///< Highest sync command reached by the IO thread
+	volatile Word32 m_uQueueStart;		///< Position of the next entry the IO thread will consume
+	volatile Word32 m_uQueueEnd;		///< Position of the next entry to be claimed by a producer
+	Word32 m_uQueueMask;				///< Number of entries in the IO queue minus one (Power of 2)
+	WordPtr m_uLastError;				///< Result of the last command without a file, passed to the next callback
+	Queue_t *m_pIOQueue;				///< Ring buffer of IO events
+	Queue_t *m_pBatch;					///< Commands copied out of the IO queue for processing as a batch
 	const char *m_pPrefix[PREFIXMAX];	///< Array of prefix strings
-	Queue_t m_IOQueue[cMaxQueue];		///< Queue of IO events
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	struct IOUring_t;
+	IOUring_t *m_pIOUring;				///< io_uring read engine, \ref NULL if not available (Linux only)
+#endif
 
 #if defined(BURGER_MSDOS) || defined(DOXYGEN)
 	Word8 m_bAllowed;					///< True if MSDOS has long filename support (MSDOS Only)
@@ -103,8 +141,12 @@ private:
 	static FileManager *g_pFileManager;	///< Global instance of the file manager
 
 public:
-	static void BURGER_API Init(void);
+	static void BURGER_API Init(Word uQueueDepth=cDefaultQueueDepth);
 	static void BURGER_API Shutdown(void);
+	static Word BURGER_API GetQueueDepth(void);
+	static void BURGER_API QueueCallback(File *pFile,ProcCallback pCallback);
+	static void BURGER_API FlushIO(void);
+	static Word BURGER_API RegisterBuffers(const IOVector_t *pBuffers,Word uCount);
 #if defined(BURGER_MSDOS)
 	static Word BURGER_API AreLongFilenamesAllowed(void);
 #else
@@ -169,7 +211,7 @@ public:
 
 class FileManagerSimple {
 public:
-	FileManagerSimple() { FileManager::Init(); }
+	FileManagerSimple(Word uQueueDepth=FileManager::cDefaultQueueDepth) { FileManager::Init(uQueueDepth); }
 	~FileManagerSimple() { FileManager::Shutdown(); }
 };
 }
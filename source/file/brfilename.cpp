@@ -1190,7 +1190,7 @@ void BURGER_API Burger::Filename::Expand(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 const char * BURGER_API Burger::Filename::GetNative(void)
 {
 	return m_pFilename;
@@ -1211,7 +1211,7 @@ const char * BURGER_API Burger::Filename::GetNative(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 void BURGER_API Burger::Filename::SetSystemWorkingDirectory(void)
 {
@@ -1233,7 +1233,7 @@ void BURGER_API Burger::Filename::SetSystemWorkingDirectory(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::Filename::SetApplicationDirectory(void)
 {
 	Clear();
@@ -1254,7 +1254,7 @@ void BURGER_API Burger::Filename::SetApplicationDirectory(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::Filename::SetMachinePrefsDirectory(void)
 {
 	Clear();
@@ -1276,7 +1276,7 @@ void BURGER_API Burger::Filename::SetMachinePrefsDirectory(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOS) || defined(BURGER_XBOX360) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::Filename::SetUserPrefsDirectory(void)
 {
 	Clear();
@@ -1303,7 +1303,7 @@ void BURGER_API Burger::Filename::SetUserPrefsDirectory(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MSDOS) || defined(BURGER_MACOS) || defined(BURGER_IOS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::Filename::SetFromNative(const char *pInput)
 {
 	Set(pInput);
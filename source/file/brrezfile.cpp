@@ -19,6 +19,8 @@
 #include "brfile.h"
 #include "brfileansihelpers.h"
 #include "brglobals.h"
+#include "bratomic.h"
+#include "brcriticalsection.h"
 #include <stdlib.h>
 
 /*! ************************************
@@ -34,6 +36,19 @@
 	where the data is coming from and how it's cached in memory
 	for performance
 
+	If the archive is opened with memory mapping enabled, entries
+	that are stored uncompressed are not copied into handles. Load()
+	returns a pointer directly into the mapped image of the file
+	and only the reference count in the entry is updated. Pages
+	are brought in by the operating system on demand, so only the
+	data that is actually touched becomes resident. The pages are
+	mapped copy on write, so modifying the returned data is safe,
+	but the changes are not written back to the archive.
+
+	\note Only Load() returns mapped data, LoadHandle() always
+	returns a handle so the data can be managed by the
+	MemoryManagerHandle.
+
 ***************************************/
 
 /*! ************************************
@@ -655,6 +670,87 @@ void BURGER_API Burger::RezFile::FixupFilenames(char *pText)
 	ProcessRezNames();
 }
 
+/*! ************************************
+
+	\brief Test if an external file overrides a resource entry
+
+	If external files are enabled and the entry has a name,
+	check if a file with that name exists. The result
+	is cached in the entry so the file system is only
+	queried once.
+
+	\param pEntry Pointer to the resource entry to test
+	\return \ref TRUE if the data will be loaded from an external file
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::TestExternalFile(RezEntry_t *pEntry)
+{
+	Word uResult = FALSE;
+	if (pEntry->m_pRezName && m_bExternalFileEnabled) {
+		Word32 uFlags = pEntry->m_uFlags;
+		if (!(uFlags&ENTRYFLAGSTESTED)) {
+			uFlags |= ENTRYFLAGSTESTED;
+			if (FileManager::DoesFileExist(pEntry->m_pRezName)) {
+				uFlags |= ENTRYFLAGSFILEFOUND;
+			}
+			pEntry->m_uFlags = uFlags;
+		}
+		if (uFlags&ENTRYFLAGSFILEFOUND) {
+			uResult = TRUE;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Return a pointer to an entry's data in the memory mapped file
+
+	If the rez file is memory mapped and the entry is stored
+	uncompressed, return a pointer to the data inside of the
+	mapping. If the data is already cached in a handle or
+	if an external file overrides the entry, return \ref NULL
+	so the caller will use the handle instead.
+
+	\note The reference count is not modified.
+
+	\param pEntry Pointer to the resource entry to test
+	\return Pointer to the data in the mapping or \ref NULL if the entry must be loaded into a handle
+
+***************************************/
+
+Word8 * BURGER_API Burger::RezFile::GetMappedData(RezEntry_t *pEntry)
+{
+	Word8 *pResult = NULL;
+	Word32 uFlags = pEntry->m_uFlags;
+	// Only uncompressed data can be shared with the mapping
+	if (m_pMappedFile && !(uFlags&ENTRYFLAGSDECOMPMASK)) {
+		void **ppData = pEntry->m_ppData;
+		if (ppData) {
+			// Cached in memory? Use the cached copy
+			if (ppData[0]) {
+				return NULL;
+			}
+			// Discard the purged handle
+			pEntry->m_ppData = NULL;
+			m_pMemoryManager->FreeHandle(ppData);
+		}
+
+		// External files override the rez file contents
+		if (TestExternalFile(pEntry)) {
+			return NULL;
+		}
+
+		// Make sure the data is entirely inside the mapping
+		WordPtr uFileOffset = pEntry->m_uFileOffset;
+		WordPtr uLength = pEntry->m_uLength;
+		if (uFileOffset && uLength && (uLength<=m_uMappedSize) && (uFileOffset<=(m_uMappedSize-uLength))) {
+			pResult = m_pMappedFile+uFileOffset;
+		}
+	}
+	return pResult;
+}
 
 /*! ************************************
 
@@ -674,6 +770,8 @@ Burger::RezFile::RezFile(Burger::MemoryManagerHandle *pMemoryManager) :
 	m_uRezNameCount(0),
 	m_pGroups(NULL),
 	m_pRezNames(NULL),
+	m_pMappedFile(NULL),
+	m_uMappedSize(0),
 	m_bExternalFileEnabled(TRUE)
 {
 	Word i=0;
@@ -709,19 +807,20 @@ Burger::RezFile::~RezFile()
 	\param pMemoryManager Pointer to a valid handle based memory manager
 	\param pFileName Pointer to a "C" string of a filename to a rez file
 	\param uStartOffset Offset in bytes from the start of the file where the rezfile image resides. Normally this is zero.
+	\param bMapFile \ref TRUE to memory map the file for zero copy access to uncompressed entries
 
 	\return \ref NULL if out of memory or the file is not a valid rezfile
 	\sa Burger::Delete(const RezFile *)
 
 ***************************************/
 
-Burger::RezFile * BURGER_API Burger::RezFile::New(Burger::MemoryManagerHandle *pMemoryManager,const char *pFileName,Word32 uStartOffset)
+Burger::RezFile * BURGER_API Burger::RezFile::New(Burger::MemoryManagerHandle *pMemoryManager,const char *pFileName,Word32 uStartOffset,Word bMapFile)
 {
 	// Manually allocate the memory
 	RezFile *pThis = new (Alloc(sizeof(RezFile))) RezFile(pMemoryManager);
 	if (pThis) {
 	// Load up the data
-		if (!pThis->Init(pFileName,uStartOffset)) {
+		if (!pThis->Init(pFileName,uStartOffset,bMapFile)) {
 			// We're good!
 			return pThis;
 		}
@@ -736,15 +835,23 @@ Burger::RezFile * BURGER_API Burger::RezFile::New(Burger::MemoryManagerHandle *p
 
 	\brief Open a resource file for reading
 
+	If memory mapping is requested, the entire file is mapped
+	into the address space. If the platform doesn't support
+	mapping or the mapping failed, the file is accessed
+	with normal reads. Call IsMapped() to see if the mapping
+	succeeded.
+
 	\param pFileName Pointer to "C" string of the filename to open
 	\param uStartOffset Offset from the start of the file where the rezfile image resides. Normally zero.
+	\param bMapFile \ref TRUE to memory map the file for zero copy access to uncompressed entries
 
 	\return \ref FALSE if no error occurred.
 		A non-zero value (error code) if it couldn't open the file
+	\sa IsMapped(void) const
 
 ***************************************/
 
-Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
+Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset,Word bMapFile)
 {
 	// If there was a previous file, release it
 	Shutdown();
@@ -795,6 +902,10 @@ Word BURGER_API Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
 								m_pGroups = pRezGroup;	// Get the memory
 								m_bExternalFileEnabled = TRUE;	// External files are ok
 								ProcessRezNames();		// Make the initial name hash
+								// Failure to map is not an error, it will use reads instead
+								if (bMapFile) {
+									MapFile(pFileName);
+								}
 								return FALSE;
 							}
 						}
@@ -850,6 +961,8 @@ void BURGER_API Burger::RezFile::Shutdown(void)
 			pGroups = reinterpret_cast<RezGroup_t *>(pEntry);
 		} while (--uGroupCount);
 	}
+	// Release the memory mapped file (If any)
+	UnmapFile();
 	// Release the resource groups
 	Free(m_pGroups);
 	// Release the name list
@@ -941,11 +1054,27 @@ Word BURGER_API Burger::RezFile::SetExternalFlag(Word bEnable)
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word Burger::RezFile::IsMapped(void) const
+	\brief Return \ref TRUE if the rez file is memory mapped
+
+	\return \ref TRUE if uncompressed entries are returned directly from a file mapping
+	\sa Init(const char *,Word32,Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Log a resource decompressor
+
+	Any Burger::Decompress codec, such as Burger::DecompressLZSS or
+	Burger::DecompressLZ4, can be assigned to a compressor ID. Batch
+	loading uses Decompress::Clone() to decompress on multiple threads.
+
 	\param uCompressID Compressor ID (1-3)
 	\param pProc Pointer to a decompression codec
+	\sa Burger::DecompressLZ4
 
 ***************************************/
 
@@ -1231,7 +1360,7 @@ void BURGER_API Burger::RezFile::Remove(Word uRezNum)
 	if (ppData) {		// Was there memory?
 		pEntry->m_ppData = NULL;		// Mark as GONE
 		Word32 uOffset = pEntry->m_uFlags;
-		pEntry->m_uFlags = uOffset&(~ENTRYFLAGSREFCOUNT);	/* No references */
+		pEntry->m_uFlags = uOffset&(~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));	/* No references */
 #if defined(_DEBUG)
 		// A single reference is not an error. More than 1 is a problem
 		if (Globals::AreWarningsEnabled() && (uOffset&ENTRYFLAGSREFCOUNT)>=(ENTRYFLAGSREFADD*2)) {
@@ -1534,7 +1663,8 @@ Word BURGER_API Burger::RezFile::GetIDFromPointer(const void *pRez,Word *pRezNum
 				// Check the entries for this handle
 				
 				do {
-					if (pEntry->m_ppData && (pEntry->m_ppData[0] == pRez)) {		// Is it a match?
+					if ((pEntry->m_ppData && (pEntry->m_ppData[0] == pRez)) ||		// Is it a match?
+						((pEntry->m_uFlags&ENTRYFLAGSMAPPED) && ((m_pMappedFile+pEntry->m_uFileOffset) == pRez))) {
 						if (pRezNum) {						// Do I want the ID number?
 							pRezNum[0] = (pGroups->m_uBaseRezNum+pGroups->m_uCount)-uCount;
 						}
@@ -1785,16 +1915,47 @@ void ** BURGER_API Burger::RezFile::LoadHandle(const char *pRezName,Word *pLoade
 /*! ************************************
 
 	\brief Load in a resource
+
+	If the rez file is memory mapped and the resource is
+	stored uncompressed, the pointer returned is inside
+	of the file mapping and no memory is allocated.
+
 	\param uRezNum Resource number
 	\param pLoadedFlag Pointer to a \ref Word that's
 		set to \ref TRUE if the data was freshly loaded
 		or \ref FALSE if it's a cached copy
-	\return \ref NULL if the data was not found or a valid handle with the data
+	\return \ref NULL if the data was not found or a valid pointer to the data
 
 ***************************************/
 
 void * BURGER_API Burger::RezFile::Load(Word uRezNum,Word *pLoadedFlag)
 {
+	// Can the data come straight from the file mapping?
+	if (m_pMappedFile) {
+		RezEntry_t *pEntry = Find(uRezNum);
+		if (pEntry) {
+			Word8 *pData = GetMappedData(pEntry);
+			if (pData) {
+				Word32 uFlags = pEntry->m_uFlags;
+				if (pLoadedFlag) {
+					// It's new if no one else has a reference
+					pLoadedFlag[0] = !(uFlags&ENTRYFLAGSMAPPED);
+				}
+				// Increase the reference count
+				pEntry->m_uFlags = (uFlags+ENTRYFLAGSREFADD)|ENTRYFLAGSMAPPED;
+#if defined(_DEBUG)
+				if (!(uFlags&ENTRYFLAGSMAPPED) && (Globals::GetTraceFlag()&Globals::TRACE_REZLOAD)) {	// Should I print it?
+					if (pEntry->m_pRezName) {
+						Debug::Message("Mapped resource %u named %s\n",uRezNum,pEntry->m_pRezName);
+					} else {
+						Debug::Message("Mapped resource %u\n",uRezNum);
+					}
+				}
+#endif
+				return pData;
+			}
+		}
+	}
 	// Load the handle and dereference it
 	return m_pMemoryManager->Lock(LoadHandle(uRezNum,pLoadedFlag));
 }
@@ -1806,14 +1967,627 @@ void * BURGER_API Burger::RezFile::Load(Word uRezNum,Word *pLoadedFlag)
 	\param pLoadedFlag Pointer to a \ref Word that's
 		set to \ref TRUE if the data was freshly loaded
 		or \ref FALSE if it's a cached copy
-	\return \ref NULL if the data was not found or a valid handle with the data
+	\return \ref NULL if the data was not found or a valid pointer to the data
 
 ***************************************/
 
 void * BURGER_API Burger::RezFile::Load(const char *pRezName,Word *pLoadedFlag)
 {
-	// Load the handle and dereference it
-	return m_pMemoryManager->Lock(LoadHandle(pRezName,pLoadedFlag));
+	// Get the index number
+	Word uRezNum = GetRezNum(pRezName);
+	if (uRezNum == INVALIDREZNUM) {
+		uRezNum = AddName(pRezName);	// Try to add it
+		if (uRezNum==INVALIDREZNUM) {	// No good?
+			if (pLoadedFlag) {
+				pLoadedFlag[0] = FALSE;
+			}
+			return NULL;				// Bad news
+		}
+	}
+	return Load(uRezNum,pLoadedFlag);
+}
+
+/*! ************************************
+
+	\struct Burger::RezFile::BatchRead_t
+	\brief Coalesced read shared by LoadBatch() entries
+
+	When several resources are near each other in the rez file,
+	LoadBatch() reads them all with a single read into a shared
+	buffer. The buffer is released once every entry that uses it
+	has been processed.
+
+***************************************/
+
+struct Burger::RezFile::BatchRead_t {
+	Word8 *m_pBuffer;			///< Buffer holding the data read from the rez file
+	Word m_uPending;			///< Number of entries still using the buffer
+};
+
+/*! ************************************
+
+	\struct Burger::RezFile::BatchJob_t
+	\brief A single resource being loaded by LoadBatch()
+
+	Everything a worker thread needs is copied into this
+	structure, so worker threads never touch the RezFile.
+
+***************************************/
+
+struct Burger::RezFile::BatchJob_t {
+	void **m_ppData;			///< Handle that receives the data
+	Word8 *m_pOutput;			///< Locked pointer to the handle's memory
+	const Word8 *m_pInput;		///< Data image from the rez file, \ref NULL if it was read in place
+	BatchRead_t *m_pRead;		///< Coalesced read this entry came from or \ref NULL
+	WordPtr m_uFileOffset;		///< Offset into the rez file
+	WordPtr m_uLength;			///< Length of the data in memory
+	WordPtr m_uPackedLength;	///< Length of the data in the rez file
+	Word m_uRezNum;				///< Resource number
+	Word m_uCodec;				///< Decompressor index plus one, zero if not compressed
+	Word m_uResult;				///< \ref FALSE if loaded successfully
+};
+
+/*! ************************************
+
+	\struct Burger::RezFile::BatchQueue_t
+	\brief Queue shared between LoadBatch() and the worker threads
+
+***************************************/
+
+struct Burger::RezFile::BatchQueue_t {
+	BatchJob_t **m_ppTasks;		///< Entries to process in submission order, \ref NULL to exit
+	BatchJob_t **m_ppFinished;	///< Entries the worker threads have completed
+	volatile Word32 m_uTaken;	///< Index of the next task a worker will take
+	Word m_uFinishedCount;		///< Number of valid entries in m_ppFinished (Protected by m_Lock)
+	Semaphore m_Work;			///< Released once for every queued task
+	Semaphore m_Finished;		///< Released once for every finished task
+	CriticalSection m_Lock;		///< Lock for m_ppFinished
+};
+
+/*! ************************************
+
+	\struct Burger::RezFile::BatchWorker_t
+	\brief Worker thread used by LoadBatch()
+
+***************************************/
+
+struct Burger::RezFile::BatchWorker_t {
+	BatchQueue_t *m_pQueue;		///< Shared work queue
+	Decompress *m_Decompressors[MAXCODECS];	///< Decompressor instances owned by this thread
+	Thread m_Thread;			///< Thread executing BatchWorker()
+};
+
+/*! ************************************
+
+	\brief Used to sort LoadBatch() entries by file offset
+
+	Called by qsort()
+	\param pFirst First BatchJob_t * to compare
+	\param pSecond Second BatchJob_t * to compare
+	\return Negative, zero or positive for sorting
+
+***************************************/
+
+int BURGER_ANSIAPI Burger::RezFile::QSortBatchJobs(const void *pFirst,const void *pSecond)
+{
+	WordPtr uFirst = static_cast<const BatchJob_t *>(pFirst)->m_uFileOffset;
+	WordPtr uSecond = static_cast<const BatchJob_t *>(pSecond)->m_uFileOffset;
+	int iResult = 0;
+	if (uFirst<uSecond) {
+		iResult = -1;
+	} else if (uFirst>uSecond) {
+		iResult = 1;
+	}
+	return iResult;
+}
+
+/*! ************************************
+
+	\brief Decompress or copy a LoadBatch() entry
+
+	This is called by the worker threads and by LoadBatch()
+	itself, so it only uses data stored in the BatchJob_t.
+
+	\param pJob Pointer to the entry to process
+	\param ppDecompressors Array of decompressors the calling thread is allowed to use
+	\return \ref FALSE if successful, \ref TRUE if the data was corrupt
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::ProcessBatchJob(BatchJob_t *pJob,Decompress * const *ppDecompressors)
+{
+	Word uResult = FALSE;
+	Word uCodec = pJob->m_uCodec;
+	if (!uCodec) {
+		// Data read in place needs no work
+		if (pJob->m_pInput) {
+			MemoryCopy(pJob->m_pOutput,pJob->m_pInput,pJob->m_uLength);
+		}
+	} else {
+		Decompress *pDecompressor = ppDecompressors[uCodec-1];
+		pDecompressor->Reset();
+		if (pDecompressor->Process(pJob->m_pOutput,pJob->m_uLength,pJob->m_pInput,pJob->m_uPackedLength)==Decompress::DECOMPRESS_BADINPUT) {
+			uResult = TRUE;
+		}
+		pDecompressor->Reset();
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Worker thread for LoadBatch()
+
+	Take entries from the queue, process them and
+	post them to the finished list until a \ref NULL
+	entry is found.
+
+	\param pThis Pointer to the BatchWorker_t for this thread
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::RezFile::BatchWorker(void *pThis)
+{
+	BatchWorker_t *pWorker = static_cast<BatchWorker_t *>(pThis);
+	BatchQueue_t *pQueue = pWorker->m_pQueue;
+	for (;;) {
+		pQueue->m_Work.Acquire();
+		BatchJob_t *pJob = pQueue->m_ppTasks[AtomicPostIncrement(&pQueue->m_uTaken)];
+		// End of the batch?
+		if (!pJob) {
+			break;
+		}
+		pJob->m_uResult = ProcessBatchJob(pJob,pWorker->m_Decompressors);
+		pQueue->m_Lock.Lock();
+		pQueue->m_ppFinished[pQueue->m_uFinishedCount] = pJob;
+		++pQueue->m_uFinishedCount;
+		pQueue->m_Lock.Unlock();
+		pQueue->m_Finished.Release();
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Complete a LoadBatch() entry
+
+	Called on the thread that invoked LoadBatch(). Attach
+	the loaded handle to the resource entry, release the
+	shared read buffer and issue the completion callback.
+
+	\param pJob Pointer to the finished entry
+	\param pProc Completion callback or \ref NULL
+	\param pData Pointer passed to the completion callback
+	\return \ref FALSE if successful, \ref TRUE if the data could not be loaded
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::FinishBatchJob(BatchJob_t *pJob,LoadBatchProc pProc,void *pData)
+{
+	// Release the coalesced read buffer if no one needs it anymore
+	BatchRead_t *pRead = pJob->m_pRead;
+	if (pRead) {
+		if (!--pRead->m_uPending) {
+			Free(pRead->m_pBuffer);
+			pRead->m_pBuffer = NULL;
+		}
+	}
+
+	// Look up the entry again, callbacks may have added names
+	Word uRezNum = pJob->m_uRezNum;
+	RezEntry_t *pEntry = Find(uRezNum);
+	void **ppData = pJob->m_ppData;
+	if (ppData) {
+		m_pMemoryManager->Unlock(ppData);
+		if (pJob->m_uResult || !pEntry) {
+			m_pMemoryManager->FreeHandle(ppData);
+			ppData = NULL;
+		} else if (pEntry->m_ppData) {
+			// A callback loaded this resource while it was in flight, use that copy
+			m_pMemoryManager->FreeHandle(ppData);
+			ppData = pEntry->m_ppData;
+			m_pMemoryManager->SetPurgeFlag(ppData,FALSE);
+			pEntry->m_uFlags += ENTRYFLAGSREFADD;
+		} else {
+			pEntry->m_ppData = ppData;
+			pEntry->m_uFlags += ENTRYFLAGSREFADD;
+#if defined(_DEBUG)
+			if (Globals::GetTraceFlag()&Globals::TRACE_REZLOAD) {	// Should I print it?
+				if (pEntry->m_pRezName) {
+					Debug::Message("Batch loaded resource %u named %s\n",uRezNum,pEntry->m_pRezName);
+				} else {
+					Debug::Message("Batch loaded resource %u\n",uRezNum);
+				}
+			}
+#endif
+		}
+	}
+	if (pEntry) {
+		pEntry->m_uFlags &= (~ENTRYFLAGSBATCH);
+	}
+	if (pProc) {
+		pProc(pData,uRezNum,ppData);
+	}
+	return ppData==NULL;
+}
+
+/*! ************************************
+
+	\brief Load a list of resources
+
+	Load every resource in the list as if LoadHandle() was
+	called on each one, but much faster when many resources
+	are needed at once, such as when loading a level.
+
+	Resources that are read from the rez file are sorted by
+	their location in the file so the file is read from
+	beginning to end. Resources that are close to each other
+	are read with a single large read and the decompression
+	is performed by worker threads while the next read
+	is in progress.
+
+	Resources that are already cached or that come from
+	external files are loaded with LoadHandle() before the
+	batch begins.
+
+	Every resource that loaded has its reference count
+	incremented, so Release() must be called on each one
+	when it's no longer needed, exactly as with LoadHandle().
+
+	The callback is issued on the calling thread once for
+	every entry in the list, in the order the entries finish loading
+	which may not match the order of the list. The handle passed to
+	the callback is \ref NULL if the resource could not be loaded.
+
+	\note The callback may call Load() or Release(), but must
+	not call Shutdown() or Remove() on this RezFile.
+
+	\param pRezNums Pointer to an array of resource numbers
+	\param uCount Number of entries in the array
+	\param pProc Function to call as each resource finishes loading, can be \ref NULL
+	\param pData Pointer passed to the callback
+	\return Number of resources that could not be loaded, zero if all were loaded
+	\sa LoadHandle(Word,Word *)
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::LoadBatch(const Word *pRezNums,Word uCount,LoadBatchProc pProc,void *pData)
+{
+	Word uFailed = 0;
+	if (uCount) {
+
+		// Allocate all of the tracking memory in one shot
+		WordPtr uJobsSize = sizeof(BatchJob_t)*uCount;
+		WordPtr uReadsSize = sizeof(BatchRead_t)*uCount;
+		WordPtr uTasksSize = sizeof(BatchJob_t *)*(uCount+BATCHTHREADS);
+		WordPtr uFinishedSize = sizeof(BatchJob_t *)*uCount;
+		BatchJob_t *pJobs = static_cast<BatchJob_t *>(Alloc(uJobsSize+uReadsSize+uTasksSize+uFinishedSize+(sizeof(Word)*uCount)));
+		BatchRead_t *pReads = NULL;
+		BatchQueue_t Queue;
+		Word *pDeferred = NULL;
+		if (pJobs) {
+			pReads = reinterpret_cast<BatchRead_t *>(reinterpret_cast<Word8 *>(pJobs)+uJobsSize);
+			Queue.m_ppTasks = reinterpret_cast<BatchJob_t **>(reinterpret_cast<Word8 *>(pReads)+uReadsSize);
+			Queue.m_ppFinished = reinterpret_cast<BatchJob_t **>(reinterpret_cast<Word8 *>(Queue.m_ppTasks)+uTasksSize);
+			pDeferred = reinterpret_cast<Word *>(reinterpret_cast<Word8 *>(Queue.m_ppFinished)+uFinishedSize);
+		}
+		Queue.m_uTaken = 0;
+		Queue.m_uFinishedCount = 0;
+
+		// Pass 1, anything that can't be read straight from the rez file
+		// is loaded immediately.
+
+		BatchJob_t *pJob = pJobs;
+		Word uDeferred = 0;
+		Word uCompressed = 0;
+		const Word *pWork = pRezNums;
+		Word i = uCount;
+		do {
+			Word uRezNum = pWork[0];
+			++pWork;
+			RezEntry_t *pEntry = Find(uRezNum);
+			if (pEntry && pJobs) {
+				Word32 uFlags = pEntry->m_uFlags;
+				// Listed twice? Load it after the first one is done
+				if (uFlags&ENTRYFLAGSBATCH) {
+					pDeferred[uDeferred] = uRezNum;
+					++uDeferred;
+					continue;
+				}
+				// Discard purged handles
+				void **ppData = pEntry->m_ppData;
+				if (ppData && !ppData[0]) {
+					pEntry->m_ppData = NULL;
+					m_pMemoryManager->FreeHandle(ppData);
+					ppData = NULL;
+				}
+				Word uCodec = (uFlags>>ENTRYFLAGSDECOMPSHIFT)&3;
+				// Old format files don't have the length in the header
+				if (!ppData && m_File.IsOpened() && pEntry->m_uFileOffset && pEntry->m_uLength &&
+					(!uCodec || m_Decompressors[uCodec-1]) && !TestExternalFile(pEntry)) {
+					pEntry->m_uFlags = uFlags|ENTRYFLAGSBATCH;
+					pJob->m_ppData = NULL;
+					pJob->m_pOutput = NULL;
+					pJob->m_pInput = NULL;
+					pJob->m_pRead = NULL;
+					pJob->m_uFileOffset = pEntry->m_uFileOffset;
+					pJob->m_uLength = pEntry->m_uLength;
+					pJob->m_uPackedLength = uCodec ? pEntry->m_uCompressedLength : pEntry->m_uLength;
+					pJob->m_uRezNum = uRezNum;
+					pJob->m_uCodec = uCodec;
+					pJob->m_uResult = TRUE;
+					if (uCodec) {
+						++uCompressed;
+					}
+					++pJob;
+					continue;
+				}
+			}
+			void **ppData = LoadHandle(uRezNum);
+			if (!ppData) {
+				++uFailed;
+			}
+			if (pProc) {
+				pProc(pData,uRezNum,ppData);
+			}
+		} while (--i);
+
+		Word uJobs = static_cast<Word>(pJob-pJobs);
+		if (uJobs) {
+
+			// Sort by file position
+			qsort(pJobs,uJobs,sizeof(BatchJob_t),QSortBatchJobs);
+
+			// Allocate and lock all of the handles, so
+			// the worker threads can write to them
+			pJob = pJobs;
+			i = uJobs;
+			do {
+				RezEntry_t *pEntry = Find(pJob->m_uRezNum);
+				void **ppData = m_pMemoryManager->AllocHandle(pJob->m_uLength,(pEntry->m_uFlags&ENTRYFLAGSHIGHMEMORY) ? MemoryManagerHandle::FIXED : 0);
+				if (ppData) {
+					m_pMemoryManager->SetID(ppData,pJob->m_uRezNum);
+					pJob->m_ppData = ppData;
+					pJob->m_pOutput = static_cast<Word8 *>(m_pMemoryManager->Lock(ppData));
+				} else {
+					// Out of memory
+					uFailed += FinishBatchJob(pJob,pProc,pData);
+				}
+				++pJob;
+			} while (--i);
+
+			// Start up the worker threads to decompress in parallel
+			BatchWorker_t Workers[BATCHTHREADS];
+			Word uWorkers = 0;
+			Word bShared[MAXCODECS];
+			Word uCodec = 0;
+			do {
+				bShared[uCodec] = TRUE;
+			} while (++uCodec<MAXCODECS);
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || \
+	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
+			Word uWanted = (uCompressed<BATCHTHREADS) ? uCompressed : BATCHTHREADS;
+			while (uWorkers<uWanted) {
+				BatchWorker_t *pWorker = &Workers[uWorkers];
+				pWorker->m_pQueue = &Queue;
+				uCodec = 0;
+				do {
+					Decompress *pDecompressor = m_Decompressors[uCodec];
+					if (pDecompressor) {
+						// A codec without private copies stays on this thread
+						pDecompressor = pDecompressor->Clone();
+						if (!pDecompressor) {
+							bShared[uCodec] = FALSE;
+						}
+					}
+					pWorker->m_Decompressors[uCodec] = pDecompressor;
+				} while (++uCodec<MAXCODECS);
+				if (pWorker->m_Thread.Start(BatchWorker,pWorker)) {
+					uCodec = 0;
+					do {
+						Delete(pWorker->m_Decompressors[uCodec]);
+					} while (++uCodec<MAXCODECS);
+					break;
+				}
+				++uWorkers;
+			}
+#endif
+
+			// Read the data in file order, combining nearby entries
+			Word uQueued = 0;
+			Word uFinished = 0;
+			BatchRead_t *pRead = pReads;
+			Word uIndex = 0;
+			do {
+				BatchJob_t *pFirst = &pJobs[uIndex];
+				WordPtr uStart = pFirst->m_uFileOffset;
+				WordPtr uEnd = uStart+pFirst->m_uPackedLength;
+				Word uLast = uIndex;
+				Word uPending = 0;
+				do {
+					pJob = &pJobs[uLast];
+					WordPtr uNextEnd = pJob->m_uFileOffset+pJob->m_uPackedLength;
+					if (uLast!=uIndex) {
+						// Too far away or too much data?
+						if (pJob->m_uFileOffset>(uEnd+BATCHGAPSIZE)) {
+							break;
+						}
+						if (uNextEnd>uEnd) {
+							if ((uNextEnd-uStart)>BATCHREADSIZE) {
+								break;
+							}
+							uEnd = uNextEnd;
+						}
+					}
+					if (pJob->m_ppData) {
+						++uPending;
+					}
+				} while (++uLast<uJobs);
+
+				if (uPending) {
+					// Get the data, either from the mapping or the file
+					WordPtr uSize = uEnd-uStart;
+					const Word8 *pSource = NULL;
+					Word8 *pBuffer = NULL;
+					Word bInPlace = FALSE;
+					if (m_pMappedFile) {
+						if (uEnd<=m_uMappedSize) {
+							pSource = m_pMappedFile+uStart;
+						}
+					} else {
+						m_File.SetMark(uStart);
+						if (((uLast-uIndex)==1) && !pFirst->m_uCodec) {
+							// A lone uncompressed entry is read directly into its handle
+							if (m_File.Read(pFirst->m_pOutput,uSize)==uSize) {
+								pSource = pFirst->m_pOutput;
+								bInPlace = TRUE;
+							}
+						} else {
+							pBuffer = static_cast<Word8 *>(Alloc(uSize));
+							if (pBuffer) {
+								if (m_File.Read(pBuffer,uSize)==uSize) {
+									pSource = pBuffer;
+								} else {
+									Free(pBuffer);
+									pBuffer = NULL;
+								}
+							}
+						}
+					}
+					if (pBuffer) {
+						pRead->m_pBuffer = pBuffer;
+						pRead->m_uPending = uPending;
+					}
+
+					// Dispatch the entries
+					pJob = pFirst;
+					i = uLast-uIndex;
+					do {
+						if (pJob->m_ppData) {
+							if (!pSource) {
+								// Read error
+								uFailed += FinishBatchJob(pJob,pProc,pData);
+							} else {
+								if (pBuffer) {
+									pJob->m_pRead = pRead;
+								}
+								if (!bInPlace) {
+									pJob->m_pInput = pSource+(pJob->m_uFileOffset-uStart);
+								}
+								uCodec = pJob->m_uCodec;
+								if (uWorkers && (!uCodec || bShared[uCodec-1])) {
+									Queue.m_ppTasks[uQueued] = pJob;
+									++uQueued;
+									Queue.m_Work.Release();
+								} else {
+									pJob->m_uResult = ProcessBatchJob(pJob,m_Decompressors);
+									uFailed += FinishBatchJob(pJob,pProc,pData);
+								}
+							}
+						}
+						++pJob;
+					} while (--i);
+					if (pBuffer) {
+						++pRead;
+					}
+				}
+
+				// Report anything the worker threads have finished
+				while ((uFinished<uQueued) && !Queue.m_Finished.TryAcquire(0)) {
+					Queue.m_Lock.Lock();
+					pJob = Queue.m_ppFinished[uFinished];
+					Queue.m_Lock.Unlock();
+					++uFinished;
+					uFailed += FinishBatchJob(pJob,pProc,pData);
+				}
+				uIndex = uLast;
+			} while (uIndex<uJobs);
+
+			// Shut down the worker threads
+			if (uWorkers) {
+				i = 0;
+				do {
+					Queue.m_ppTasks[uQueued+i] = NULL;
+					Queue.m_Work.Release();
+				} while (++i<uWorkers);
+
+				// Wait for the stragglers
+				while (uFinished<uQueued) {
+					Queue.m_Finished.Acquire();
+					Queue.m_Lock.Lock();
+					pJob = Queue.m_ppFinished[uFinished];
+					Queue.m_Lock.Unlock();
+					++uFinished;
+					uFailed += FinishBatchJob(pJob,pProc,pData);
+				}
+				i = 0;
+				do {
+					Workers[i].m_Thread.Wait();
+					uCodec = 0;
+					do {
+						Delete(Workers[i].m_Decompressors[uCodec]);
+					} while (++uCodec<MAXCODECS);
+				} while (++i<uWorkers);
+			}
+		}
+
+		// Duplicates are in the cache now
+		if (uDeferred) {
+			pWork = pDeferred;
+			do {
+				Word uRezNum = pWork[0];
+				++pWork;
+				void **ppData = LoadHandle(uRezNum);
+				if (!ppData) {
+					++uFailed;
+				}
+				if (pProc) {
+					pProc(pData,uRezNum,ppData);
+				}
+			} while (--uDeferred);
+		}
+		Free(pJobs);
+	}
+	return uFailed;
+}
+
+/*! ************************************
+
+	\brief Load a list of resources by name
+
+	Convert the names into resource numbers, adding names that
+	are not in the dictionary, and call LoadBatch(const Word *,Word,LoadBatchProc,void *).
+
+	\param ppRezNames Pointer to an array of resource names
+	\param uCount Number of entries in the array
+	\param pProc Function to call as each resource finishes loading, can be \ref NULL
+	\param pData Pointer passed to the callback
+	\return Number of resources that could not be loaded, zero if all were loaded
+	\sa LoadBatch(const Word *,Word,LoadBatchProc,void *)
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::LoadBatch(const char * const *ppRezNames,Word uCount,LoadBatchProc pProc,void *pData)
+{
+	Word uFailed = 0;
+	if (uCount) {
+		Word *pRezNums = static_cast<Word *>(Alloc(sizeof(Word)*uCount));
+		if (!pRezNums) {
+			return uCount;
+		}
+		Word i = 0;
+		do {
+			Word uRezNum = GetRezNum(ppRezNames[i]);
+			if (uRezNum==INVALIDREZNUM) {
+				uRezNum = AddName(ppRezNames[i]);	// Try to add it
+			}
+			pRezNums[i] = uRezNum;
+		} while (++i<uCount);
+		uFailed = LoadBatch(pRezNums,uCount,pProc,pData);
+		Free(pRezNums);
+	}
+	return uFailed;
 }
 
 /*! ************************************
@@ -1831,6 +2605,24 @@ Word BURGER_API Burger::RezFile::Read(Word uRezNum,void *pBuffer,WordPtr uBuffer
 {	
 	// Assume failure
 	Word uResult = TRUE;
+
+	// Memory mapped data can be copied without touching the cache
+	if (m_pMappedFile) {
+		RezEntry_t *pEntry = Find(uRezNum);
+		if (pEntry) {
+			const Word8 *pData = GetMappedData(pEntry);
+			if (pData) {
+				WordPtr uLength = pEntry->m_uLength;
+				if (uBufferSize>=uLength) {
+					uBufferSize = uLength;
+					uResult = FALSE;
+				}
+				MemoryCopy(pBuffer,pData,uBufferSize);
+				return uResult;
+			}
+		}
+	}
+
 	void **ppData = LoadHandle(uRezNum);	// Load it in
 	if (ppData) {							// Ok?
 		RezEntry_t *pEntry = Find(uRezNum);
@@ -1896,6 +2688,8 @@ void BURGER_API Burger::RezFile::Release(Word uRezNum)
 			uOffset-=ENTRYFLAGSREFADD;			// Release a reference
 			pEntry->m_uFlags = uOffset;
 			if (!(uOffset&ENTRYFLAGSREFCOUNT)) {		// No longer referenced?
+				// Mapped data has nothing to release
+				pEntry->m_uFlags = uOffset&(~ENTRYFLAGSMAPPED);
 				void **ppData = pEntry->m_ppData;
 				if (ppData) {							// Is there a handle?
 					m_pMemoryManager->Unlock(ppData);				// Unlock it
@@ -1933,6 +2727,8 @@ void BURGER_API Burger::RezFile::Release(const char *pRezName)
 				uOffset-=ENTRYFLAGSREFADD;			/* Release a reference */
 				pEntry->m_uFlags = uOffset;
 				if (!(uOffset&ENTRYFLAGSREFCOUNT)) {		/* No longer referenced? */
+					// Mapped data has nothing to release
+					pEntry->m_uFlags = uOffset&(~ENTRYFLAGSMAPPED);
 					void **ppData = pEntry->m_ppData;
 					if (ppData) {			/* Is there a handle? */
 						m_pMemoryManager->Unlock(ppData);		/* Unlock it */
@@ -1962,13 +2758,16 @@ void BURGER_API Burger::RezFile::Kill(Word uRezNum)
 		if (ppData) {		/* Is there a handle? */
 			pEntry->m_ppData = NULL;		/* Mark as GONE */
 			Word32 uOffset = pEntry->m_uFlags;
-			pEntry->m_uFlags = uOffset&(~ENTRYFLAGSREFCOUNT);	/* No references */
+			pEntry->m_uFlags = uOffset&(~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));	/* No references */
 #if defined(_DEBUG)
 			if (Globals::AreWarningsEnabled() && ((uOffset&ENTRYFLAGSREFCOUNT)>=ENTRYFLAGSREFADD*2)) {
 				Debug::Message("RezFile::Kill() : Killing resource %u that is referenced %lu times\n",uRezNum,uOffset>>ENTRYFLAGSREFSHIFT);
 			}
 #endif
 			m_pMemoryManager->FreeHandle(ppData);
+		} else {
+			// Memory mapped data only has references to remove
+			pEntry->m_uFlags &= (~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));
 		}
 	}
 }
@@ -1993,13 +2792,16 @@ void BURGER_API Burger::RezFile::Kill(const char *pRezName)
 			if (ppData) {		/* Is there a handle? */
 				pEntry->m_ppData = NULL;		/* Mark as GONE */
 				Word32 uOffset = pEntry->m_uFlags;
-				pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
+				pEntry->m_uFlags = uOffset & (~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));	/* No references */
 #if defined(_DEBUG)
 				if (Globals::AreWarningsEnabled() && (uOffset&ENTRYFLAGSREFCOUNT)>=(ENTRYFLAGSREFADD*2)) {
 					Debug::Message("RezFile::Kill() : Killing resource %s that is referenced %lu times\n",pRezName,uOffset>>ENTRYFLAGSREFSHIFT);
 				}
 #endif
 				m_pMemoryManager->FreeHandle(ppData);
+			} else {
+				// Memory mapped data only has references to remove
+				pEntry->m_uFlags &= (~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));
 			}
 		}
 	}
@@ -2021,7 +2823,7 @@ void BURGER_API Burger::RezFile::Detach(Word uRezNum)
 	if (pEntry) {		/* Scan for the resource */
 		pEntry->m_ppData = NULL;		/* Mark as GONE */
 		Word32 uOffset = pEntry->m_uFlags;
-		pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
+		pEntry->m_uFlags = uOffset & (~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));	/* No references */
 #if defined(_DEBUG)
 		if (Globals::AreWarningsEnabled() && (uOffset&ENTRYFLAGSREFCOUNT)!=ENTRYFLAGSREFADD) {	/* 1 time is ok */
 			Debug::Message("RezFile::Detach() : Detaching resource %u that is referenced %lu times\n",uRezNum,uOffset>>ENTRYFLAGSREFSHIFT);
@@ -2048,7 +2850,7 @@ void BURGER_API Burger::RezFile::Detach(const char *pRezName)
 		if (pEntry) {		/* Scan for the resource */
 			pEntry->m_ppData = NULL;		/* Mark as GONE */
 			Word32 uOffset = pEntry->m_uFlags;
-			pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
+			pEntry->m_uFlags = uOffset & (~(ENTRYFLAGSREFCOUNT|ENTRYFLAGSMAPPED));	/* No references */
 #if defined(_DEBUG)
 			if (Globals::AreWarningsEnabled() && (uOffset&ENTRYFLAGSREFCOUNT)!=ENTRYFLAGSREFADD) {	/* 1 time is ok */
 				Debug::Message("ResourceDetachByName() : Detaching resource %s that is referenced %lu times\n",pRezName,uOffset>>ENTRYFLAGSREFSHIFT);
@@ -2071,6 +2873,13 @@ void BURGER_API Burger::RezFile::Detach(const char *pRezName)
 
 void BURGER_API Burger::RezFile::Preload(Word uRezNum)
 {
+	// Memory mapped data doesn't need to be copied into the cache
+	if (m_pMappedFile) {
+		RezEntry_t *pEntry = Find(uRezNum);
+		if (pEntry && GetMappedData(pEntry)) {
+			return;
+		}
+	}
 	if (LoadHandle(uRezNum)) {	// Get the handle
 		Release(uRezNum);		// Release the resource
 	}
@@ -2098,9 +2907,7 @@ void BURGER_API Burger::RezFile::Preload(const char *pRezName)
 			return;						// Bad news!
 		}
 	}
-	if (LoadHandle(uRezNum)) {	// Get the handle
-		Release(uRezNum);		// Release it
-	}
+	Preload(uRezNum);
 }
 
 
@@ -49,6 +49,7 @@ public:
 		ENTRYFLAGSDECOMPSHIFT=19			///< Shift value to get the decompression type index (2 bits)
 	};
 	static const Word INVALIDREZNUM = static_cast<Word>(-1);	///< Illegal resource number, used as an error code
+	typedef void (BURGER_API *LoadBatchProc)(void *pData,Word uRezNum,void **ppData);	///< Function prototype for LoadBatch() completion callbacks
 
 	struct RootHeader_t {
 		char m_Name[4];			///< 'BRGR' 
@@ -73,6 +74,9 @@ public:
 private:
 	enum {
 		MAXBUFFER = 65536,					///< Size of decompression buffer
+		BATCHTHREADS = 4,					///< Maximum number of decompression threads used by LoadBatch()
+		BATCHREADSIZE = 0x400000,			///< Largest coalesced read performed by LoadBatch()
+		BATCHGAPSIZE = MAXBUFFER,			///< Largest unused gap between entries that LoadBatch() will read through
 		// Flags on for data records in the Rez File
 		REZOFFSETFIXED=0x80000000,			///< True if load in fixed memory
 		REZOFFSETDECOMPMASK=0x60000000,		///< Mask for decompressors
@@ -81,6 +85,8 @@ private:
 		// Defines for the bits in m_uFileOffset on disk
 		ENTRYFLAGSTESTED=0x00000001,		///< True if the filename was checked
 		ENTRYFLAGSFILEFOUND=0x0000002,		///< True if a file was found
+		ENTRYFLAGSMAPPED=0x00000004,		///< True if references point into the memory mapped file
+		ENTRYFLAGSBATCH=0x00000008,			///< True if the entry is queued in a LoadBatch() call
 		// Used by the rez file parser
 		SWAPENDIAN=0x01,					///< Manually swap endian
 		OLDFORMAT=0x02						///< Parsing an old rez file format
@@ -100,6 +106,10 @@ private:
 		Word m_uCount;			///< Number of entries
 		RezEntry_t m_Array[1];	///< First entry
 	};
+	struct BatchRead_t;
+	struct BatchJob_t;
+	struct BatchQueue_t;
+	struct BatchWorker_t;
 public:
 	struct FilenameToRezNum_t {
 		const char *m_pRezName;	///< Pointer to the filename
@@ -113,9 +123,15 @@ private:
 	Word32 m_uRezNameCount;				///< Number of resource names in m_pRezNames
 	RezGroup_t *m_pGroups;				///< Array of resource groups
 	FilenameToRezNum_t *m_pRezNames;	///< Pointer to sorted resource names if present
+	Word8 *m_pMappedFile;				///< Pointer to the memory mapped rez file or \ref NULL if not mapped
+	WordPtr m_uMappedSize;				///< Size in bytes of the memory mapped rez file
 	Word m_bExternalFileEnabled;		///< \ref TRUE if external file access is enabled
 
 	static int BURGER_ANSIAPI QSortNames(const void *pFirst,const void *pSecond);
+	static int BURGER_ANSIAPI QSortBatchJobs(const void *pFirst,const void *pSecond);
+	static Word BURGER_API ProcessBatchJob(BatchJob_t *pJob,Decompress * const *ppDecompressors);
+	static WordPtr BURGER_API BatchWorker(void *pThis);
+	Word BURGER_API FinishBatchJob(BatchJob_t *pJob,LoadBatchProc pProc,void *pData);
 	WordPtr BURGER_API GetRezGroupBytes(void) const;
 	void BURGER_API AdjustNamePointers(WordPtr uAdjust);
 	RezEntry_t * BURGER_API Find(Word uRezNum) const;
@@ -123,15 +139,25 @@ private:
 	static RezGroup_t * BURGER_API ParseRezFileHeader(const Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset);
 	void BURGER_API ProcessRezNames(void);
 	void BURGER_API FixupFilenames(char *pText);
+	Word BURGER_API TestExternalFile(RezEntry_t *pEntry);
+	Word8 * BURGER_API GetMappedData(RezEntry_t *pEntry);
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	Word BURGER_API MapFile(const char *pFileName);
+	void BURGER_API UnmapFile(void);
+#else
+	BURGER_INLINE Word MapFile(const char * /* pFileName */) { return File::NOT_IMPLEMENTED; }
+	BURGER_INLINE void UnmapFile(void) {}
+#endif
 public:
 	RezFile(MemoryManagerHandle *pMemoryManager);
 	~RezFile();
-	static RezFile * BURGER_API New(MemoryManagerHandle *pMemoryManager,const char *pFileName,Word32 uStartOffset=0);
-	Word BURGER_API Init(const char *pFileName,Word32 uStartOffset=0);
+	static RezFile * BURGER_API New(MemoryManagerHandle *pMemoryManager,const char *pFileName,Word32 uStartOffset=0,Word bMapFile=FALSE);
+	Word BURGER_API Init(const char *pFileName,Word32 uStartOffset=0,Word bMapFile=FALSE);
 	void BURGER_API Shutdown(void);
 	void BURGER_API PurgeCache(void);
 	Word BURGER_API SetExternalFlag(Word bEnable);
 	Word BURGER_INLINE GetExternalFlag(void) const { return m_bExternalFileEnabled; }
+	BURGER_INLINE Word IsMapped(void) const { return m_pMappedFile!=NULL; }
 	void BURGER_API LogDecompressor(Word uCompressID,Decompress *pProc);
 	Word BURGER_API GetRezNum(const char *pRezName) const;
 	Word BURGER_API GetName(Word uRezNum,char *pBuffer,WordPtr uBufferSize) const;
@@ -150,6 +176,8 @@ public:
 	void ** BURGER_API LoadHandle(const char *pRezName,Word *pLoadedFlag=NULL);
 	void * BURGER_API Load(Word uRezNum,Word *pLoadedFlag=NULL);
 	void * BURGER_API Load(const char *pRezName,Word *pLoadedFlag=NULL);
+	Word BURGER_API LoadBatch(const Word *pRezNums,Word uCount,LoadBatchProc pProc=NULL,void *pData=NULL);
+	Word BURGER_API LoadBatch(const char * const *ppRezNames,Word uCount,LoadBatchProc pProc=NULL,void *pData=NULL);
 	Word BURGER_API Read(Word uRezNum,void *pBuffer,WordPtr uBufferSize);
 	Word BURGER_API Read(const char *pRezName,void *pBuffer,WordPtr uBufferSize);
 	void BURGER_API Release(Word uRezNum);
@@ -0,0 +1,34 @@
+/***************************************
+
+	Work stealing job scheduler, iOS version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brjobscheduler.h"
+
+#if defined(BURGER_IOS)
+#include <unistd.h>
+
+/***************************************
+
+	Return the number of CPU cores that are online
+
+***************************************/
+
+Word BURGER_API Burger::JobScheduler::GetCPUCount(void)
+{
+	long iCount = sysconf(_SC_NPROCESSORS_ONLN);
+	if (iCount<1) {
+		iCount = 1;
+	}
+	return static_cast<Word>(iCount);
+}
+
+#endif
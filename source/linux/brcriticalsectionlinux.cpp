@@ -0,0 +1,464 @@
+/***************************************
+
+	Class to handle critical sections, Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcriticalsection.h"
+
+#if defined(BURGER_LINUX)
+#include "brassert.h"
+#include "bratomic.h"
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/***************************************
+
+	Convert a timeout in milliseconds into an absolute
+	CLOCK_MONOTONIC time. Using the monotonic clock
+	prevents a change in the wall clock from causing
+	a premature or extended timeout.
+
+***************************************/
+
+static void BURGER_API MillisecondsToMonotonic(timespec *pOutput,Word uMilliseconds)
+{
+	clock_gettime(CLOCK_MONOTONIC,pOutput);
+	Word uSeconds = uMilliseconds/1000U;
+	// Get the remainder in NANOSECONDS
+	long lNanoseconds = static_cast<long>((uMilliseconds-(uSeconds*1000U))*1000000U);
+	lNanoseconds += pOutput->tv_nsec;
+	// Handle wrap around
+	if (lNanoseconds>=1000000000L) {
+		lNanoseconds-=1000000000L;
+		++uSeconds;
+	}
+	pOutput->tv_sec += static_cast<time_t>(uSeconds);
+	pOutput->tv_nsec = lNanoseconds;
+}
+
+/***************************************
+
+	Initialize the CriticalSection
+
+	Use a recursive mutex to match the behavior of
+	the other platforms, code such as the handle memory
+	manager will lock the CriticalSection again from
+	the thread that already owns it
+
+***************************************/
+
+Burger::CriticalSection::CriticalSection()
+{
+	// Verify the the Burgerlib opaque version is the same size as the real one
+	BURGER_COMPILE_TIME_ASSERT(sizeof(Burger::pthread_mutex_t)==sizeof(::pthread_mutex_t));
+
+	pthread_mutexattr_t Attributes;
+	pthread_mutexattr_init(&Attributes);
+	pthread_mutexattr_settype(&Attributes,PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(reinterpret_cast< ::pthread_mutex_t *>(&m_Lock),&Attributes);
+	pthread_mutexattr_destroy(&Attributes);
+}
+
+Burger::CriticalSection::~CriticalSection()
+{
+	pthread_mutex_destroy(reinterpret_cast< ::pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Lock the CriticalSection
+
+***************************************/
+
+void Burger::CriticalSection::Lock()
+{
+	pthread_mutex_lock(reinterpret_cast< ::pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Try to lock the CriticalSection
+
+***************************************/
+
+Word Burger::CriticalSection::TryLock()
+{
+	return pthread_mutex_trylock(reinterpret_cast< ::pthread_mutex_t *>(&m_Lock))!=EBUSY;
+}
+
+/***************************************
+
+	Unlock the CriticalSection
+
+***************************************/
+
+void Burger::CriticalSection::Unlock()
+{
+	pthread_mutex_unlock(reinterpret_cast< ::pthread_mutex_t *>(&m_Lock));
+}
+
+/***************************************
+
+	Initialize the semaphore
+
+	The semaphore is implemented directly on a futex with
+	m_uCount being the futex word. An uncontested Acquire()
+	or Release() never enters the kernel.
+
+***************************************/
+
+Burger::Semaphore::Semaphore(Word32 uCount) :
+	m_uWaiting(0),
+	m_uCount(uCount)
+{
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Burger::Semaphore::~Semaphore()
+{
+	m_uCount = 0;
+}
+
+/***************************************
+
+	Attempt to acquire the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::TryAcquire(Word uMilliseconds)
+{
+	timespec TimeOut;
+	Word bTimeOutSet = FALSE;
+	for (;;) {
+		// Is there a resource available?
+		Word32 uCount = m_uCount;
+		if (uCount) {
+			// Try to grab it, if another thread beat me to it, try again
+			if (AtomicSetIfMatch(&m_uCount,uCount,uCount-1)) {
+				return 0;
+			}
+			continue;
+		}
+
+		// No waiting?
+		if (!uMilliseconds) {
+			return 1;
+		}
+
+		// Get the absolute time to give up (Only once, so
+		// spurious wakeups don't extend the timeout)
+		const timespec *pTimeOut = NULL;
+		if (uMilliseconds!=BURGER_MAXUINT) {
+			if (!bTimeOutSet) {
+				MillisecondsToMonotonic(&TimeOut,uMilliseconds);
+				bTimeOutSet = TRUE;
+			}
+			pTimeOut = &TimeOut;
+		}
+
+		// Sleep only if the count is still zero, FUTEX_WAIT_BITSET
+		// uses absolute CLOCK_MONOTONIC time for the timeout
+		AtomicPreIncrement(&m_uWaiting);
+		long lResult = syscall(SYS_futex,&m_uCount,FUTEX_WAIT_BITSET_PRIVATE,0,pTimeOut,NULL,FUTEX_BITSET_MATCH_ANY);
+		int iError = errno;
+		AtomicPreDecrement(&m_uWaiting);
+
+		// Timed out?
+		if ((lResult==-1) && (iError==ETIMEDOUT)) {
+			return 1;
+		}
+		// Woken, interrupted or the count changed, so try again
+	}
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::Release(void)
+{
+	AtomicPreIncrement(&m_uCount);
+	// Only call the kernel if there's someone to wake up
+	if (m_uWaiting) {
+		syscall(SYS_futex,&m_uCount,FUTEX_WAKE_PRIVATE,1,NULL,NULL,0);
+	}
+	return 0;
+}
+
+/***************************************
+
+	Initialize the condition variable
+
+	The condition variable uses CLOCK_MONOTONIC for timeouts
+
+***************************************/
+
+Burger::ConditionVariable::ConditionVariable() :
+	m_bInitialized(FALSE)
+{
+	// Safety switch to verify the declaration in brlinuxtypes.h matches the real thing
+	BURGER_COMPILE_TIME_ASSERT(sizeof(Burger::pthread_cond_t)==sizeof(::pthread_cond_t));
+
+	pthread_condattr_t Attributes;
+	if (!pthread_condattr_init(&Attributes)) {
+		pthread_condattr_setclock(&Attributes,CLOCK_MONOTONIC);
+		if (!pthread_cond_init(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable),&Attributes)) {
+			m_bInitialized = TRUE;
+		}
+		pthread_condattr_destroy(&Attributes);
+	}
+}
+
+/***************************************
+
+	Release the resources
+
+***************************************/
+
+Burger::ConditionVariable::~ConditionVariable()
+{
+	if (m_bInitialized) {
+		pthread_cond_destroy(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable));
+		m_bInitialized = FALSE;
+	}
+}
+
+/***************************************
+
+	Signal a waiting thread
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Signal(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_signal(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable))) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Signal all waiting threads
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Broadcast(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_broadcast(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable))) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait for a signal (With timeout)
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSection,Word uMilliseconds)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (uMilliseconds==BURGER_MAXUINT) {
+			if (!pthread_cond_wait(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable),reinterpret_cast< ::pthread_mutex_t *>(&pCriticalSection->m_Lock))) {
+				uResult = 0;
+			}
+		} else {
+
+			// Determine the time in the future to timeout at
+			timespec StopTimeHere;
+			MillisecondsToMonotonic(&StopTimeHere,uMilliseconds);
+			int iResult;
+			do {
+				// Send the signal and possibly time out
+				iResult = pthread_cond_timedwait(reinterpret_cast< ::pthread_cond_t *>(&m_ConditionVariable),reinterpret_cast< ::pthread_mutex_t *>(&pCriticalSection->m_Lock),&StopTimeHere);
+				// Interrupted?
+			} while (iResult == EINTR);
+
+			// W00t! We're good!
+			if (!iResult) {
+				uResult = 0;
+
+			// Time out?
+			} else if (iResult == ETIMEDOUT) {
+				uResult = 1;
+			}
+			// Otherwise, leave uResult as an error
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	This code fragment calls the Run function that has
+	permission to access the members
+
+***************************************/
+
+static void * Dispatcher(void *pThis)
+{
+	Burger::Thread::Run(pThis);
+	return NULL;
+}
+
+/***************************************
+
+	Initialize a thread to a dormant state
+
+***************************************/
+
+Burger::Thread::Thread() :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_uThreadHandle(0),
+	m_Started(0),
+	m_uResult(BURGER_MAXUINT)
+{
+	BURGER_COMPILE_TIME_ASSERT(sizeof(::pthread_t)==sizeof(m_uThreadHandle));
+}
+
+/***************************************
+
+	Initialize a thread and begin execution
+
+***************************************/
+
+Burger::Thread::Thread(FunctionPtr pThread,void *pData) :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_uThreadHandle(0),
+	m_Started(0),
+	m_uResult(BURGER_MAXUINT)
+{
+	Start(pThread,pData);
+}
+
+/***************************************
+
+	Release resources
+
+***************************************/
+
+Burger::Thread::~Thread()
+{
+	Kill();
+}
+
+/***************************************
+
+	Launch a new thread if one isn't already started
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Start(FunctionPtr pFunction,void *pData)
+{
+	Word uResult = 10;
+	if (!m_uThreadHandle) {
+		m_pFunction = pFunction;
+		m_pData = pData;
+		pthread_attr_t Attributes;
+		if (!pthread_attr_init(&Attributes)) {
+			pthread_attr_setdetachstate(&Attributes,PTHREAD_CREATE_JOINABLE);
+			::pthread_t ThreadHandle;
+			if (!pthread_create(&ThreadHandle,&Attributes,Dispatcher,this)) {
+				m_uThreadHandle = static_cast<WordPtr>(ThreadHandle);
+				// Wait until the thread has started. The semaphore is
+				// a member so the new thread can't touch a destroyed
+				// object if Release() is still running after this returns
+				m_Started.Acquire();
+				// All good!
+				uResult = 0;
+			}
+			pthread_attr_destroy(&Attributes);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait until the thread has completed execution
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Wait(void)
+{
+	Word uResult = 10;
+	if (m_uThreadHandle) {
+		// Wait until the thread completes execution
+		pthread_join(static_cast< ::pthread_t>(m_uThreadHandle),NULL);
+		// Allow restarting
+		m_uThreadHandle = 0;
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Invoke the nuclear option to kill a thread
+	NOT RECOMMENDED!
+
+	pthread_kill() with SIGKILL would take down
+	the entire process on Linux, so cancel the thread
+	and reap it instead
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Kill(void)
+{
+	Word uResult = 0;
+	if (m_uThreadHandle) {
+		::pthread_t ThreadHandle = static_cast< ::pthread_t>(m_uThreadHandle);
+		pthread_cancel(ThreadHandle);
+		pthread_join(ThreadHandle,NULL);
+		m_uThreadHandle = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Synchronize and then execute the thread and save
+	the result if any
+
+***************************************/
+
+void BURGER_API Burger::Thread::Run(void *pThis)
+{
+	Thread *pThread = static_cast<Thread *>(pThis);
+	pThread->m_Started.Release();
+	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
+}
+
+#endif
@@ -0,0 +1,384 @@
+/***************************************
+
+	Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfile.h"
+
+#if defined(BURGER_LINUX)
+
+/***************************************
+
+	Linux version of Burger::File
+
+	The file mark is kept in m_uPosition and all
+	reads and writes are performed with pread() and
+	pwrite() so the kernel's shared file offset
+	is never touched. This allows the FileManager
+	I/O thread and the owning thread to issue
+	positioned I/O on the same descriptor safely.
+
+***************************************/
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	\brief Open a file using a Burger::Filename
+
+	Close any previously opened file and open a new file.
+
+	\param pFileName Pointer to a Burger::Filename object
+	\param eAccess Enumeration on permissions requested on the opened file
+	\return File::OKAY if no error, error code if not.
+	\sa Open(const char *, eFileAccess) and File(const char *,eFileAccess)
+
+***************************************/
+
+Word BURGER_API Burger::File::Open(Filename *pFileName,eFileAccess eAccess)
+{
+	Close();
+	eAccess = static_cast<eFileAccess>(eAccess&3);
+
+	static const int g_Permissions[4] = { O_RDONLY|O_CLOEXEC,O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,O_WRONLY|O_CREAT|O_CLOEXEC,O_RDWR|O_CREAT|O_CLOEXEC };
+	int fp = open(pFileName->GetNative(),g_Permissions[eAccess],0666);
+	Word uResult = FILENOTFOUND;
+	if (fp!=-1) {
+		m_pFile = reinterpret_cast<void *>(static_cast<WordPtr>(fp));
+		m_uPosition = 0;
+		uResult = OKAY;
+		if (eAccess==APPEND) {
+			uResult = SetMarkAtEOF();
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Close any open file
+
+	Close any previously opened file
+
+	\return File::OKAY if no error, error code if not.
+	\sa Open(const char *, eFileAccess) and Open(Filename *,eFileAccess)
+
+***************************************/
+
+Word BURGER_API Burger::File::Close(void)
+{
+	Word uResult = OKAY;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		int eClose = close(fp);
+		if (eClose==-1) {
+			uResult = IOERROR;
+		}
+		m_pFile = NULL;
+		m_uPosition = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Return the size of a file in bytes
+
+	If a file is open, query the operating system for the size of the file
+	in bytes.
+
+	\note The return value is 32 bits wide on a 32 bit operating system, 64 bits
+	wide on 64 bit operating systems
+	\return 0 if error or an empty file. Non-zero is the size of the file in bytes.
+	\sa Open(const char *, eFileAccess) and Open(Filename *,eFileAccess)
+
+***************************************/
+
+WordPtr BURGER_API Burger::File::GetSize(void)
+{
+	WordPtr uSize = 0;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		int iError = fstat(fp,&MyStat);
+		if (iError!=-1) {
+#if defined(BURGER_64BITCPU)
+			uSize = static_cast<WordPtr>(MyStat.st_size);
+#else
+			if (static_cast<Word64>(MyStat.st_size)<=static_cast<Word64>(0xFFFFFFFFU)) {
+				uSize = static_cast<WordPtr>(MyStat.st_size);
+			} else {
+				uSize = 0xFFFFFFFFU;
+			}
+#endif
+		}
+	}
+	return uSize;
+}
+
+/***************************************
+
+	\brief Read data from an open file
+
+	If a file is open, perform a read operation. This function will fail
+	if the file was not opened for read access.
+
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa Write(const void *,WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::File::Read(void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pOutput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			// pread() can return short, so loop until EOF or an error
+			do {
+				ssize_t iRead = pread(fp,static_cast<Word8 *>(pOutput)+uResult,uSize-uResult,static_cast<off_t>(m_uPosition));
+				if (iRead<=0) {
+					// Retry if interrupted by a signal
+					if ((iRead==-1) && (errno==EINTR)) {
+						continue;
+					}
+					break;
+				}
+				uResult += static_cast<WordPtr>(iRead);
+				m_uPosition += static_cast<WordPtr>(iRead);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write data into an open file
+
+	If a file is open, perform a write operation. This function will fail
+	if the file was not opened for write access.
+
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa Read(void *,WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::File::Write(const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			do {
+				ssize_t iWrite = pwrite(fp,static_cast<const Word8 *>(pInput)+uResult,uSize-uResult,static_cast<off_t>(m_uPosition));
+				if (iWrite<=0) {
+					// Retry if interrupted by a signal
+					if ((iWrite==-1) && (errno==EINTR)) {
+						continue;
+					}
+					break;
+				}
+				uResult += static_cast<WordPtr>(iWrite);
+				m_uPosition += static_cast<WordPtr>(iWrite);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the current file mark
+
+	If a file is open, return the location
+	of the file mark for future reads or writes.
+
+	\return Current file mark or zero if an error occurred
+	\sa Write(const void *,WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::File::GetMark(void)
+{
+	WordPtr uMark = 0;
+	if (m_pFile) {
+		uMark = m_uPosition;
+	}
+	return uMark;
+}
+
+/***************************************
+
+	\brief Set the current file mark
+
+	If a file is open, set the read/write mark at the location passed.
+
+	\param uMark Value to set the new file mark to.
+	\return File::OKAY if successful, File::INVALID_MARK if not.
+	\sa GetMark() or SetMarkAtEOF()
+
+***************************************/
+
+Word BURGER_API Burger::File::SetMark(WordPtr uMark)
+{
+	Word uResult = INVALID_MARK;
+	if (m_pFile) {
+		m_uPosition = uMark;
+		uResult = OKAY;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the current file mark at the end of the file
+
+	If a file is open, set the read/write mark to the end of the file.
+
+	\return File::OKAY if successful, File::INVALID_MARK if not.
+	\sa GetMark() or SetMark()
+
+***************************************/
+
+Word BURGER_API Burger::File::SetMarkAtEOF(void)
+{
+	Word uResult = INVALID_MARK;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		if (fstat(fp,&MyStat)!=-1) {
+			m_uPosition = static_cast<WordPtr>(MyStat.st_size);
+			uResult = OKAY;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the time the file was last modified
+
+	If a file is open, query the operating system for the last time
+	the file was modified.
+
+	\param pOutput Pointer to a Burger::TimeDate_t to receive the file modification time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa GetCreationTime() or SetModificationTime()
+
+***************************************/
+
+Word BURGER_API Burger::File::GetModificationTime(TimeDate_t *pOutput)
+{
+	Word uResult = FILENOTFOUND;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		int iError = fstat(fp,&MyStat);
+		if (iError!=-1) {
+			// If it succeeded, the file must exist
+			pOutput->Load(&MyStat.st_mtim);
+			uResult = OKAY;
+		}
+	}
+	if (uResult!=OKAY) {
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the time the file was created
+
+	Linux file systems don't reliably record a creation
+	time, so the status change time is returned instead.
+
+	\param pOutput Pointer to a Burger::TimeDate_t to receive the file creation time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa GetModificationTime() or SetCreationTime()
+
+***************************************/
+
+Word BURGER_API Burger::File::GetCreationTime(TimeDate_t *pOutput)
+{
+	Word uResult = FILENOTFOUND;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		int iError = fstat(fp,&MyStat);
+		if (iError!=-1) {
+			pOutput->Load(&MyStat.st_ctim);
+			uResult = OKAY;
+		}
+	}
+	if (uResult!=OKAY) {
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the time the file was last modified
+
+	If a file is open, call the operating system to set the file
+	modification time to the passed value.
+
+	\param pInput Pointer to a Burger::TimeDate_t to use for the new file modification time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa SetCreationTime() or GetModificationTime()
+
+***************************************/
+
+Word BURGER_API Burger::File::SetModificationTime(const TimeDate_t *pInput)
+{
+	Word uResult = FILENOTFOUND;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		timespec Array[2];
+		if (!pInput->Store(&Array[1])) {
+			// Leave the access time alone
+			Array[0].tv_sec = 0;
+			Array[0].tv_nsec = UTIME_OMIT;
+			if (futimens(fp,Array)!=-1) {
+				uResult = OKAY;
+			}
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the time the file was created
+
+	Linux doesn't allow the creation time to be changed
+
+	\param pInput Pointer to a Burger::TimeDate_t to use for the new file creation time
+	\return File::NOT_IMPLEMENTED
+	\sa SetModificationTime() or GetCreationTime()
+
+***************************************/
+
+Word BURGER_API Burger::File::SetCreationTime(const TimeDate_t * /* pInput */)
+{
+	return NOT_IMPLEMENTED;
+}
+
+#endif
@@ -0,0 +1,711 @@
+/***************************************
+
+	Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfilemanager.h"
+
+#if defined(BURGER_LINUX)
+#include "brfile.h"
+#include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+#include "brassert.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/***************************************
+
+	Set the initial default prefixs for a power up state
+	*: = Boot volume
+	$: = System folder
+	@: = Prefs folder
+	8: = Default directory
+	9: = Application directory
+
+***************************************/
+
+void BURGER_API Burger::FileManager::DefaultPrefixes(void)
+{
+	// Linux only has a single root volume
+	SetPrefix(PREFIXBOOT,":");
+
+	Filename MyFilename;
+	MyFilename.SetSystemWorkingDirectory();
+	// Set the standard work prefix
+	SetPrefix(PREFIXCURRENT,&MyFilename);
+
+	MyFilename.SetApplicationDirectory();
+	SetPrefix(PREFIXAPPLICATION,&MyFilename);
+
+	// System configuration files
+	SetPrefix(PREFIXSYSTEM,":etc:");
+
+	MyFilename.SetUserPrefsDirectory();
+	SetPrefix(PREFIXPREFS,&MyFilename);
+}
+
+/***************************************
+
+	This routine will get the time and date
+	from a file.
+	Note, this routine is Operating system specific!!!
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetModificationTime(Filename *pFileName,TimeDate_t *pOutput)
+{
+	Word uResult;
+	struct stat MyStat;
+	if (stat(pFileName->GetNative(),&MyStat)==-1) {
+		pOutput->Clear();
+		uResult = File::FILENOTFOUND;
+	} else {
+		// Get the file dates
+		pOutput->Load(&MyStat.st_mtim);
+		// It's parsed!
+		uResult = File::OKAY;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	This routine will get the time and date
+	from a file.
+
+	Linux file systems don't reliably record the creation
+	time so use the status change time instead
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetCreationTime(Filename *pFileName,TimeDate_t *pOutput)
+{
+	Word uResult;
+	struct stat MyStat;
+	if (stat(pFileName->GetNative(),&MyStat)==-1) {
+		pOutput->Clear();
+		uResult = File::FILENOTFOUND;
+	} else {
+		// Get the file dates
+		pOutput->Load(&MyStat.st_ctim);
+		// It's parsed!
+		uResult = File::OKAY;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Determine if a file exists.
+	I will return TRUE if the specified path
+	is a path to a file that exists, if it doesn't exist
+	or it's a directory, I return FALSE.
+	Note : I do not check if the file havs any data in it.
+	Just the existence of the file.
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::DoesFileExist(Filename *pFileName)
+{
+	Word uResult = FALSE;
+	struct stat MyStat;
+	if (stat(pFileName->GetNative(),&MyStat)!=-1) {
+		// If it succeeded, the file must exist
+		if (!S_ISDIR(MyStat.st_mode)) {
+			uResult = TRUE;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Create a directory path using an operating system native name
+	Return FALSE if successful, or TRUE if an error
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::CreateDirectoryPath(Filename *pFileName)
+{
+	// Assume an eror condition
+	Word uResult = File::IOERROR;
+	// Get the full path
+	const char *pPath = pFileName->GetNative();
+
+	// Already here?
+
+	struct stat MyStat;
+	int eError = stat(pPath,&MyStat);
+	if (eError==0) {
+		// Ensure it's a directory for sanity's sake
+		if (S_ISDIR(MyStat.st_mode)) {
+			// There already is a directory here by this name.
+			// Exit okay!
+			uResult = File::OKAY;
+		}
+
+	} else {
+		// No folder here...
+		// Let's try the easy way
+		eError = mkdir(pPath,0777);
+		if (eError==0) {
+			// That was easy!
+			uResult = File::OKAY;
+
+		} else {
+
+			// Check the pathname
+			if (pPath[0]) {
+
+				// This is more complex, parse each
+				// segment of the folder to see if it
+				// either already exists, and if not,
+				// create it.
+
+				// Skip the leading '/'
+				char *pWork = const_cast<char *>(pPath)+1;
+				// Is there a mid fragment?
+				char *pEnd = StringCharacter(pWork,'/');
+				if (pEnd) {
+
+					// Let's iterate! Assume success unless
+					// an error occurs in this loop.
+
+					uResult = File::OKAY;
+					do {
+						// Terminate at the fragment
+						pEnd[0] = 0;
+						// Create the directory (Maybe)
+						eError = mkdir(pPath,0777);
+						// Restore the pathname
+						pEnd[0] = '/';
+						// Error and it's not because it's already present
+						if (eError!=0 && errno != EEXIST) {
+							// Uh, oh... Perhaps not enough permissions?
+							uResult = File::IOERROR;
+							break;
+						}
+						// Skip past this fragment
+						pWork = pEnd+1;
+						// Get to the next fragement
+						pEnd = StringCharacter(pWork,'/');
+						// All done?
+					} while (pEnd);
+
+					// Create the final directory
+					if (uResult==File::OKAY) {
+						eError = mkdir(pPath,0777);
+						if (eError!=0 && errno != EEXIST) {
+							uResult = File::IOERROR;
+						}
+					}
+				}
+			}
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Delete a file using native file system
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::DeleteFile(Filename *pFileName)
+{
+	if (!remove(pFileName->GetNative())) {
+		return FALSE;
+	}
+	return TRUE;		/* Oh oh... */
+}
+
+/***************************************
+
+	Rename a file using native pathnames
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::RenameFile(Filename *pNewName,Filename *pOldName)
+{
+	if (!rename(pOldName->GetNative(),pNewName->GetNative())) {
+		return FALSE;
+	}
+	return TRUE;		/* Oh oh... */
+}
+
+/***************************************
+
+	Change a directory using long filenames
+	This only accepts Native OS filenames
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::ChangeOSDirectory(Filename *pDirName)
+{
+	if (!chdir(pDirName->GetNative())) {
+		return FALSE;
+	}
+	return static_cast<Word>(-1);	// Error!
+}
+
+/***************************************
+
+	Open a file using a native path
+
+***************************************/
+
+FILE * BURGER_API Burger::FileManager::OpenFile(Filename *pFileName,const char *pType)
+{
+	return fopen(pFileName->GetNative(),pType);
+}
+
+/***************************************
+
+	io_uring read engine
+
+	The FileManager IO thread hands reads to the kernel
+	through an io_uring instance so many reads are in flight
+	at once. Other commands wait for the outstanding reads
+	before executing, which keeps the command order intact.
+
+	If the kernel doesn't support io_uring, the engine isn't
+	started and the IO thread performs all commands with
+	blocking calls.
+
+***************************************/
+
+// Maximum number of reads submitted at once
+static const Word32 g_uMaxRingEntries = 4096;
+
+struct Burger::FileManager::IOUring_t {
+	struct InFlight_t {
+		Queue_t *m_pQueue;			///< Command being performed
+		int m_iFile;				///< File descriptor being read
+		WordPtr m_uOffset;			///< File offset of the read
+		WordPtr m_uRequested;		///< Number of bytes requested
+	};
+	int m_iRing;					///< io_uring file descriptor
+	Word32 m_uEntries;				///< Number of submission entries
+	Word32 m_uUsed;					///< Number of entries used since the last CompleteIO()
+	Word32 m_uUnsubmitted;			///< Number of entries not yet passed to the kernel
+	void *m_pSubmitRing;			///< Mapped submission ring
+	WordPtr m_uSubmitRingSize;		///< Size of the submission ring mapping
+	void *m_pCompleteRing;			///< Mapped completion ring (Can be the same as m_pSubmitRing)
+	WordPtr m_uCompleteRingSize;	///< Size of the completion ring mapping
+	io_uring_sqe *m_pSubmitEntries;	///< Mapped submission entries
+	WordPtr m_uSubmitEntriesSize;	///< Size of the submission entries mapping
+	Word32 *m_pSubmitTail;			///< Submission ring tail
+	Word32 m_uSubmitMask;			///< Submission ring mask
+	Word32 *m_pSubmitArray;			///< Submission ring index array
+	Word32 *m_pCompleteHead;		///< Completion ring head
+	Word32 *m_pCompleteTail;		///< Completion ring tail
+	Word32 m_uCompleteMask;			///< Completion ring mask
+	io_uring_cqe *m_pCompleteEntries;	///< Completion entries
+	Word m_uFixedCount;				///< Number of registered buffers
+	IOVector_t m_FixedBuffers[cMaxFixedBuffers];	///< Registered buffers
+	InFlight_t *m_pInFlight;		///< Reads submitted since the last CompleteIO()
+};
+
+/***************************************
+
+	Read from an offset, looping until done, EOF or error
+
+***************************************/
+
+static WordPtr BURGER_API ReadAt(int iFile,void *pOutput,WordPtr uSize,WordPtr uOffset)
+{
+	WordPtr uResult = 0;
+	while (uResult<uSize) {
+		ssize_t iRead = pread(iFile,static_cast<Word8 *>(pOutput)+uResult,uSize-uResult,static_cast<off_t>(uOffset+uResult));
+		if (iRead<=0) {
+			// Retry if interrupted by a signal
+			if ((iRead==-1) && (errno==EINTR)) {
+				continue;
+			}
+			break;
+		}
+		uResult += static_cast<WordPtr>(iRead);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Start up io_uring
+
+***************************************/
+
+void BURGER_API Burger::FileManager::StartIOEngine(void)
+{
+	// Buffer vectors are handed directly to the kernel
+	BURGER_COMPILE_TIME_ASSERT(sizeof(IOVector_t)==sizeof(struct iovec));
+
+	Word32 uEntries = m_uQueueMask+1;
+	if (uEntries>g_uMaxRingEntries) {
+		uEntries = g_uMaxRingEntries;
+	}
+	io_uring_params Params;
+	MemoryClear(&Params,sizeof(Params));
+	int iRing = static_cast<int>(syscall(__NR_io_uring_setup,uEntries,&Params));
+	if (iRing<0) {
+		// Not supported or not permitted, use blocking calls
+		return;
+	}
+
+	IOUring_t *pRing = static_cast<IOUring_t *>(AllocClear(sizeof(IOUring_t)));
+	if (pRing) {
+		pRing->m_iRing = iRing;
+		pRing->m_uEntries = Params.sq_entries;
+		pRing->m_pInFlight = static_cast<IOUring_t::InFlight_t *>(Alloc(sizeof(IOUring_t::InFlight_t)*Params.sq_entries));
+
+		// Map in the rings
+		pRing->m_uSubmitRingSize = Params.sq_off.array+(Params.sq_entries*sizeof(Word32));
+		pRing->m_uCompleteRingSize = Params.cq_off.cqes+(Params.cq_entries*sizeof(io_uring_cqe));
+		if (Params.features&IORING_FEAT_SINGLE_MMAP) {
+			if (pRing->m_uCompleteRingSize>pRing->m_uSubmitRingSize) {
+				pRing->m_uSubmitRingSize = pRing->m_uCompleteRingSize;
+			}
+			pRing->m_uCompleteRingSize = 0;
+		}
+		void *pSubmitRing = mmap(NULL,pRing->m_uSubmitRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_SQ_RING);
+		void *pCompleteRing = pSubmitRing;
+		if (pRing->m_uCompleteRingSize && (pSubmitRing!=MAP_FAILED)) {
+			pCompleteRing = mmap(NULL,pRing->m_uCompleteRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_CQ_RING);
+		}
+		pRing->m_uSubmitEntriesSize = Params.sq_entries*sizeof(io_uring_sqe);
+		void *pEntries = mmap(NULL,pRing->m_uSubmitEntriesSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_SQES);
+
+		// Mark the failed mappings so the shutdown code skips them
+		pRing->m_pSubmitRing = (pSubmitRing!=MAP_FAILED) ? pSubmitRing : NULL;
+		pRing->m_pCompleteRing = (pCompleteRing!=MAP_FAILED) ? pCompleteRing : NULL;
+		pRing->m_pSubmitEntries = (pEntries!=MAP_FAILED) ? static_cast<io_uring_sqe *>(pEntries) : NULL;
+		m_pIOUring = pRing;
+
+		if (!pRing->m_pInFlight || !pRing->m_pSubmitRing || !pRing->m_pCompleteRing || !pRing->m_pSubmitEntries) {
+			ShutdownIOEngine();
+			return;
+		}
+
+		Word8 *pSubmit = static_cast<Word8 *>(pSubmitRing);
+		pRing->m_pSubmitTail = reinterpret_cast<Word32 *>(pSubmit+Params.sq_off.tail);
+		pRing->m_uSubmitMask = reinterpret_cast<Word32 *>(pSubmit+Params.sq_off.ring_mask)[0];
+		pRing->m_pSubmitArray = reinterpret_cast<Word32 *>(pSubmit+Params.sq_off.array);
+		Word8 *pComplete = static_cast<Word8 *>(pCompleteRing);
+		pRing->m_pCompleteHead = reinterpret_cast<Word32 *>(pComplete+Params.cq_off.head);
+		pRing->m_pCompleteTail = reinterpret_cast<Word32 *>(pComplete+Params.cq_off.tail);
+		pRing->m_uCompleteMask = reinterpret_cast<Word32 *>(pComplete+Params.cq_off.ring_mask)[0];
+		pRing->m_pCompleteEntries = reinterpret_cast<io_uring_cqe *>(pComplete+Params.cq_off.cqes);
+	} else {
+		close(iRing);
+	}
+}
+
+/***************************************
+
+	Shut down io_uring
+
+***************************************/
+
+void BURGER_API Burger::FileManager::ShutdownIOEngine(void)
+{
+	IOUring_t *pRing = m_pIOUring;
+	if (pRing) {
+		m_pIOUring = NULL;
+		if (pRing->m_pSubmitEntries) {
+			munmap(pRing->m_pSubmitEntries,pRing->m_uSubmitEntriesSize);
+		}
+		if (pRing->m_pCompleteRing && (pRing->m_pCompleteRing!=pRing->m_pSubmitRing)) {
+			munmap(pRing->m_pCompleteRing,pRing->m_uCompleteRingSize);
+		}
+		if (pRing->m_pSubmitRing) {
+			munmap(pRing->m_pSubmitRing,pRing->m_uSubmitRingSize);
+		}
+		// Closing the ring releases the registered buffers
+		close(pRing->m_iRing);
+		Free(pRing->m_pInFlight);
+		Free(pRing);
+	}
+}
+
+/***************************************
+
+	Queue a read into the submission ring.
+	Return FALSE if the read must be performed
+	with a blocking call.
+
+	The file mark is advanced as if the read completed,
+	CompleteIO() pulls it back on a short read.
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::SubmitIO(Queue_t *pQueue)
+{
+	IOUring_t *pRing = m_pIOUring;
+	if (!pRing) {
+		return FALSE;
+	}
+	File *pFile = pQueue->m_pFile;
+	int iFile = static_cast<int>(reinterpret_cast<WordPtr>(pFile->m_pFile));
+	if (!iFile) {
+		return FALSE;
+	}
+
+	// Get the size of the read
+	WordPtr uRequested;
+	if (pQueue->m_uIOCommand==IOCOMMAND_READVECTOR) {
+		uRequested = 0;
+		const IOVector_t *pVector = static_cast<const IOVector_t *>(pQueue->m_pBuffer);
+		WordPtr uCount = pQueue->m_uLength;
+		// The kernel limits the number of vectors
+		if (uCount>IOV_MAX) {
+			return FALSE;
+		}
+		while (uCount) {
+			uRequested += pVector->m_uLength;
+			++pVector;
+			--uCount;
+		}
+	} else {
+		uRequested = pQueue->m_uLength;
+	}
+	// Nothing to read or too large for a single request?
+	if (!uRequested || (uRequested>=0x80000000U) || !pQueue->m_pBuffer) {
+		return FALSE;
+	}
+
+	// Make room
+	if (pRing->m_uUsed==pRing->m_uEntries) {
+		CompleteIO();
+	}
+	Word32 uSlot = pRing->m_uUsed++;
+	IOUring_t::InFlight_t *pInFlight = &pRing->m_pInFlight[uSlot];
+	pInFlight->m_pQueue = pQueue;
+	pInFlight->m_iFile = iFile;
+	pInFlight->m_uOffset = pFile->m_uPosition;
+	pInFlight->m_uRequested = uRequested;
+
+	// Fill in the submission entry
+	Word32 uTail = pRing->m_pSubmitTail[0];
+	Word32 uIndex = uTail&pRing->m_uSubmitMask;
+	io_uring_sqe *pEntry = &pRing->m_pSubmitEntries[uIndex];
+	MemoryClear(pEntry,sizeof(io_uring_sqe));
+	pEntry->fd = iFile;
+	pEntry->off = pFile->m_uPosition;
+	pEntry->addr = reinterpret_cast<WordPtr>(pQueue->m_pBuffer);
+	pEntry->user_data = uSlot;
+	if (pQueue->m_uIOCommand==IOCOMMAND_READVECTOR) {
+		pEntry->opcode = IORING_OP_READV;
+		pEntry->len = static_cast<Word32>(pQueue->m_uLength);
+	} else {
+		pEntry->opcode = IORING_OP_READ;
+		pEntry->len = static_cast<Word32>(uRequested);
+
+		// Is the destination inside a registered buffer?
+		const Word8 *pBuffer = static_cast<const Word8 *>(pQueue->m_pBuffer);
+		Word i = 0;
+		Word uFixedCount = pRing->m_uFixedCount;
+		while (i<uFixedCount) {
+			const IOVector_t *pFixed = &pRing->m_FixedBuffers[i];
+			const Word8 *pStart = static_cast<const Word8 *>(pFixed->m_pBuffer);
+			if ((pBuffer>=pStart) && ((pBuffer+uRequested)<=(pStart+pFixed->m_uLength))) {
+				pEntry->opcode = IORING_OP_READ_FIXED;
+				pEntry->buf_index = static_cast<Word16>(i);
+				break;
+			}
+			++i;
+		}
+	}
+	pRing->m_pSubmitArray[uIndex] = uIndex;
+	// Publish the entry to the kernel
+	__atomic_store_n(pRing->m_pSubmitTail,uTail+1,__ATOMIC_RELEASE);
+	++pRing->m_uUnsubmitted;
+
+	// Advance the file mark
+	pFile->m_uPosition += uRequested;
+	return TRUE;
+}
+
+/***************************************
+
+	Submit all queued reads and wait for every
+	read in flight to finish. The number of bytes
+	read is stored in each command's m_uLength.
+
+	If the kernel refuses to submit or wait on the
+	ring, the reads it hasn't completed are performed
+	with blocking calls. If reads that are already in
+	flight can't be waited on, io_uring is shut down
+	and all future reads use blocking calls.
+
+***************************************/
+
+void BURGER_API Burger::FileManager::CompleteIO(void)
+{
+	IOUring_t *pRing = m_pIOUring;
+	if (!pRing || !pRing->m_uUsed) {
+		return;
+	}
+	Word32 uRemaining = pRing->m_uUsed;
+	Word bShutdown = FALSE;
+	do {
+		// First entry to perform with blocking calls (None)
+		Word32 uRetry = pRing->m_uUsed;
+
+		// Submit and sleep until at least one read is done
+		int iResult = static_cast<int>(syscall(__NR_io_uring_enter,pRing->m_iRing,pRing->m_uUnsubmitted,1,IORING_ENTER_GETEVENTS,NULL,0));
+		if (iResult>=0) {
+			pRing->m_uUnsubmitted -= static_cast<Word32>(iResult);
+		} else {
+			int iError = errno;
+			if ((iError!=EINTR) && (iError!=EAGAIN) && (iError!=EBUSY)) {
+				if (pRing->m_uUnsubmitted) {
+					// The kernel refused the reads, take them back
+					Word32 uUnsubmitted = pRing->m_uUnsubmitted;
+					pRing->m_pSubmitTail[0] -= uUnsubmitted;
+					uRetry = pRing->m_uUsed-uUnsubmitted;
+					uRemaining -= uUnsubmitted;
+					pRing->m_uUnsubmitted = 0;
+				} else {
+					// The reads in flight can't be waited on, so
+					// perform all unfinished reads and give up on the ring
+					uRetry = 0;
+					bShutdown = TRUE;
+				}
+			}
+		}
+
+		// Process the completions
+		Word32 uHead = pRing->m_pCompleteHead[0];
+		Word32 uTail = __atomic_load_n(pRing->m_pCompleteTail,__ATOMIC_ACQUIRE);
+		while (uHead!=uTail) {
+			const io_uring_cqe *pComplete = &pRing->m_pCompleteEntries[uHead&pRing->m_uCompleteMask];
+			IOUring_t::InFlight_t *pInFlight = &pRing->m_pInFlight[pComplete->user_data];
+			Queue_t *pQueue = pInFlight->m_pQueue;
+			// Mark as finished
+			pInFlight->m_pQueue = NULL;
+			int iRead = pComplete->res;
+			WordPtr uRead = (iRead>0) ? static_cast<WordPtr>(iRead) : 0;
+
+			// An error or a partial read? Finish it with blocking calls.
+			// Zero is the end of file.
+			if (iRead && (uRead<pInFlight->m_uRequested)) {
+				if (pQueue->m_uIOCommand==IOCOMMAND_READVECTOR) {
+					const IOVector_t *pVector = static_cast<const IOVector_t *>(pQueue->m_pBuffer);
+					WordPtr uSkip = uRead;
+					WordPtr uOffset = pInFlight->m_uOffset+uRead;
+					WordPtr uCount = pQueue->m_uLength;
+					do {
+						if (uSkip>=pVector->m_uLength) {
+							uSkip -= pVector->m_uLength;
+						} else {
+							WordPtr uChunk = pVector->m_uLength-uSkip;
+							WordPtr uPart = ReadAt(pInFlight->m_iFile,static_cast<Word8 *>(pVector->m_pBuffer)+uSkip,uChunk,uOffset);
+							uRead += uPart;
+							uOffset += uPart;
+							uSkip = 0;
+							if (uPart!=uChunk) {
+								break;
+							}
+						}
+						++pVector;
+					} while (--uCount);
+				} else {
+					uRead += ReadAt(pInFlight->m_iFile,static_cast<Word8 *>(pQueue->m_pBuffer)+uRead,pInFlight->m_uRequested-uRead,pInFlight->m_uOffset+uRead);
+				}
+			}
+			pQueue->m_uLength = uRead;
+
+			// On a short read, pull back the file mark
+			if (uRead<pInFlight->m_uRequested) {
+				File *pFile = pQueue->m_pFile;
+				WordPtr uMark = pInFlight->m_uOffset+uRead;
+				if (uMark<pFile->m_uPosition) {
+					pFile->m_uPosition = uMark;
+				}
+			}
+			++uHead;
+			--uRemaining;
+		}
+		__atomic_store_n(pRing->m_pCompleteHead,uHead,__ATOMIC_RELEASE);
+
+		// Perform the unfinished reads with blocking calls
+		if (uRetry<pRing->m_uUsed) {
+			IOUring_t::InFlight_t *pInFlight = &pRing->m_pInFlight[uRetry];
+			Word32 uCount = pRing->m_uUsed-uRetry;
+			do {
+				Queue_t *pQueue = pInFlight->m_pQueue;
+				if (pQueue) {
+					pInFlight->m_pQueue = NULL;
+					File *pFile = pQueue->m_pFile;
+					WordPtr uMark = pFile->m_uPosition;
+					pFile->m_uPosition = pInFlight->m_uOffset;
+					WordPtr uRead = ExecuteIO(pQueue);
+					pQueue->m_uLength = uRead;
+					// Keep the mark unless the read came up short
+					if (uRead==pInFlight->m_uRequested) {
+						pFile->m_uPosition = uMark;
+					}
+				}
+				++pInFlight;
+			} while (--uCount);
+		}
+	} while (uRemaining && !bShutdown);
+	pRing->m_uUsed = 0;
+	if (bShutdown) {
+		ShutdownIOEngine();
+	}
+}
+
+/***************************************
+
+	Register buffers for IORING_OP_READ_FIXED
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::RegisterIOBuffers(const IOVector_t *pBuffers,Word uCount)
+{
+	IOUring_t *pRing = m_pIOUring;
+	if (!pRing) {
+		return File::NOT_IMPLEMENTED;
+	}
+	if (uCount>cMaxFixedBuffers) {
+		return File::OUTOFRANGE;
+	}
+
+	// Release the previous set
+	if (pRing->m_uFixedCount) {
+		syscall(__NR_io_uring_register,pRing->m_iRing,IORING_UNREGISTER_BUFFERS,NULL,0);
+		pRing->m_uFixedCount = 0;
+	}
+	Word uResult = File::OKAY;
+	if (uCount) {
+		// This can fail if the buffers exceed RLIMIT_MEMLOCK
+		if (syscall(__NR_io_uring_register,pRing->m_iRing,IORING_REGISTER_BUFFERS,pBuffers,uCount)<0) {
+			uResult = File::IOERROR;
+		} else {
+			MemoryCopy(pRing->m_FixedBuffers,pBuffers,sizeof(IOVector_t)*uCount);
+			pRing->m_uFixedCount = uCount;
+		}
+	}
+	return uResult;
+}
+
+#endif
@@ -0,0 +1,272 @@
+/***************************************
+
+	Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfilename.h"
+
+#if defined(BURGER_LINUX)
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brstring.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+#include <libgen.h>
+
+/***************************************
+
+	Expand a filename into Linux format.
+
+	Using the rules for a Burgerlib type pathname, expand a path
+	into a FULL pathname native to the Linux file system.
+
+	Linux has a single root, so there are no volume names. The
+	first directory of a fully qualified Burgerlib pathname is
+	the first directory off of the root.
+
+	All returned pathnames will NOT have a trailing "/", they will
+	take the form of /foo/bar/file.txt or similar
+
+	Examples:<br>
+	":home:foo:bar.txt" = "/home/foo/bar.txt"<br>
+	"@:game:data.dat" = "/home/<Current user>/.config/game/data.dat"
+
+***************************************/
+
+const char * BURGER_API Burger::Filename::GetNative(void)
+{
+	Expand();		// Resolve prefixes
+
+	const Word8 *pFullPathName = reinterpret_cast<const Word8 *>(m_pFilename);
+	WordPtr uOutputLength = StringLength(reinterpret_cast<const char *>(pFullPathName))+10;
+
+	// Release any previous buffer
+	if (m_pNativeFilename!=m_NativeFilename) {
+		Free(m_pNativeFilename);
+		m_pNativeFilename = m_NativeFilename;
+	}
+	char *pOutput = m_NativeFilename;
+	if (uOutputLength>=sizeof(m_NativeFilename)) {
+		pOutput = static_cast<char *>(Alloc(uOutputLength));
+		if (!pOutput) {
+			m_NativeFilename[0] = 0;
+			return m_NativeFilename;
+		}
+	}
+	m_pNativeFilename = pOutput;
+
+	// Convert the path, colons to slashes
+
+	Word uTemp = pFullPathName[0];
+	if (uTemp) {
+		do {
+			++pFullPathName;
+			if (uTemp==':') {
+				uTemp = '/';		// Unix style
+			}
+			pOutput[0] = static_cast<char>(uTemp);
+			++pOutput;
+			uTemp = pFullPathName[0];
+		} while (uTemp);
+
+		// A trailing slash assumes more to follow, get rid of it
+		--pOutput;
+		if ((pOutput==m_pNativeFilename) ||		// Only a '/'? (Skip the check then)
+			(reinterpret_cast<Word8*>(pOutput)[0]!='/')) {
+			++pOutput;		// Remove trailing slash
+		}
+	}
+	pOutput[0] = 0;			// Terminate the "C" string
+	return m_pNativeFilename;
+}
+
+/***************************************
+
+	\brief Set the filename to the current working directory
+
+	Query the operating system for the current working directory and
+	set the filename to that directory. The path is converted
+	into UTF8 character encoding and stored in Burgerlib
+	filename format
+
+***************************************/
+
+void BURGER_API Burger::Filename::SetSystemWorkingDirectory(void)
+{
+	Clear();
+	char *pTemp = getcwd(NULL,0);
+	if (pTemp) {
+		SetFromNative(pTemp);
+		free(pTemp);
+	}
+}
+
+/***************************************
+
+	\brief Set the filename to the application's directory
+
+	Determine the directory where the application resides and set
+	the filename to that directory. The path is converted
+	into UTF8 character encoding and stored in Burgerlib
+	filename format.
+
+	The kernel exposes the executable's path via /proc/self/exe
+
+***************************************/
+
+void BURGER_API Burger::Filename::SetApplicationDirectory(void)
+{
+	Clear();
+	char NameBuffer[PATH_MAX+1];
+	ssize_t iLength = readlink("/proc/self/exe",NameBuffer,sizeof(NameBuffer)-1);
+	if ((iLength>0) && (iLength<static_cast<ssize_t>(sizeof(NameBuffer)))) {
+		NameBuffer[iLength] = 0;
+		// Pop the executable name
+		SetFromNative(dirname(NameBuffer));
+	}
+}
+
+/***************************************
+
+	Get the folder for user configuration files
+
+	Follow the XDG base directory specification, use
+	$XDG_CONFIG_HOME if set, otherwise, $HOME/.config
+
+***************************************/
+
+static void BURGER_API SetConfigDirectory(Burger::Filename *pOutput)
+{
+	const char *pConfig = getenv("XDG_CONFIG_HOME");
+	if (pConfig && pConfig[0]=='/') {
+		pOutput->SetFromNative(pConfig);
+	} else {
+		const char *pHome = getenv("HOME");
+		if (pHome && pHome[0]) {
+			Burger::String Temp(pHome,"/.config");
+			pOutput->SetFromNative(Temp.GetPtr());
+		}
+	}
+}
+
+/***************************************
+
+	\brief Set the filename to the local machine preferences directory
+
+	Determine the directory where the user's preferences that are
+	local to the machine is located. The path is converted
+	into UTF8 character encoding and stored in Burgerlib
+	filename format.
+
+***************************************/
+
+void BURGER_API Burger::Filename::SetMachinePrefsDirectory(void)
+{
+	Clear();
+	SetConfigDirectory(this);
+}
+
+/***************************************
+
+	\brief Set the filename to the user's preferences directory
+
+	Determine the directory where the user's preferences that
+	could be shared among all machines the user has an account
+	with is located. The path is converted
+	into UTF8 character encoding and stored in Burgerlib
+	filename format.
+
+***************************************/
+
+void BURGER_API Burger::Filename::SetUserPrefsDirectory(void)
+{
+	Clear();
+	SetConfigDirectory(this);
+}
+
+/***************************************
+
+	Convert a Linux filename into BurgerLib format.
+
+	Using the rules for a Burgerlib type pathname, expand a path
+	from a Linux filename into BurgerLib.
+
+	The pathname will have an ending colon.
+
+	Examples:<br>
+	"/foo/bar.txt" = ":foo:bar.txt:"<br>
+	"foo/bar.txt" = "8:foo:bar.txt:"<br>
+
+***************************************/
+
+void BURGER_API Burger::Filename::SetFromNative(const char *pInput)
+{
+	Clear();	// Clear out the previous string
+
+	// Determine the length of the prefix
+	WordPtr uInputLength = StringLength(pInput);
+	const char *pBaseName;
+	WordPtr uBaseNameLength;
+	if (reinterpret_cast<const Word8 *>(pInput)[0]!='/') {		// Must I prefix with the current directory?
+		if ((uInputLength>=2) && !MemoryCompare("./",pInput,2)) {		// Dispose of "current directory"
+			pInput+=2;
+			uInputLength-=2;
+		}
+		pBaseName = "8:";
+		uBaseNameLength = 2;
+	} else {
+		// Leading slash becomes the leading colon
+		pBaseName = ":";
+		uBaseNameLength = 1;
+		++pInput;
+		--uInputLength;
+	}
+
+	WordPtr uOutputLength = uBaseNameLength+uInputLength+10;
+	char *pOutput = m_Filename;
+	if (uOutputLength>=sizeof(m_Filename)) {
+		pOutput = static_cast<char *>(Alloc(uOutputLength));
+		if (!pOutput) {
+			return;
+		}
+	}
+	m_pFilename = pOutput;
+
+	MemoryCopy(pOutput,pBaseName,uBaseNameLength);
+	pOutput+=uBaseNameLength;
+
+	// Now, just copy the rest of the path
+
+	Word uTemp = reinterpret_cast<const Word8*>(pInput)[0];
+	if (uTemp) {				// Any more?
+		do {
+			++pInput;			// Accept char
+			if (uTemp=='/') {
+				uTemp = ':';
+			}
+			pOutput[0] = static_cast<char>(uTemp);	// Save char
+			++pOutput;
+			uTemp = reinterpret_cast<const Word8*>(pInput)[0];	// Next char
+		} while (uTemp);		// Still more?
+	}
+
+	// The wrap up...
+	// Make sure it's appended with a colon
+
+	if (reinterpret_cast<const Word8*>(pOutput)[-1]!=':') {
+		pOutput[0] = ':';
+		++pOutput;
+	}
+	pOutput[0] = 0;			// End the string with zero
+}
+
+#endif
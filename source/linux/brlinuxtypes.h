@@ -0,0 +1,38 @@
+/***************************************
+
+	Typedefs specific to Linux
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRLINUXTYPES_H__
+#define __BRLINUXTYPES_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+#if defined(BURGER_LINUX) && !defined(DOXYGEN)
+namespace Burger {
+#if defined(BURGER_ARM64)
+	struct pthread_mutex_t { Word64 m_Opaque[6]; };
+	struct pthread_cond_t { Word64 m_Opaque[6]; };
+#elif defined(BURGER_64BITCPU)
+	struct pthread_mutex_t { Word64 m_Opaque[5]; };
+	struct pthread_cond_t { Word64 m_Opaque[6]; };
+#else
+	struct pthread_mutex_t { Word32 m_Opaque[6]; };
+	struct pthread_cond_t { Word32 m_Opaque[12]; };
+#endif
+}
+#endif
+/* END */
+
+#endif
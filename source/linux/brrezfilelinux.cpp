@@ -0,0 +1,85 @@
+/***************************************
+
+	Resource manager, Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brrezfile.h"
+
+#if defined(BURGER_LINUX)
+#include "brfilename.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	\brief Memory map the rez file
+
+	Open the file a second time and map the entire file
+	into the address space. The descriptor is closed once the
+	mapping exists since the mapping holds its own reference
+	to the file.
+
+	The pages are mapped private and writable so any changes
+	an application makes to the loaded data are copy on write
+	and never reach the file.
+
+	\param pFileName Pointer to "C" string of the filename to map
+	\return File::OKAY if successful, error code if not.
+
+***************************************/
+
+Word BURGER_API Burger::RezFile::MapFile(const char *pFileName)
+{
+	UnmapFile();
+	Filename MyFilename(pFileName);
+	int fp = open(MyFilename.GetNative(),O_RDONLY|O_CLOEXEC);
+	if (fp==-1) {
+		return File::FILENOTFOUND;
+	}
+	Word uResult = File::IOERROR;
+	struct stat MyStat;
+	if (fstat(fp,&MyStat)!=-1) {
+		// Don't bother with empty files or files that don't fit in the address space
+		Word64 uSize = static_cast<Word64>(MyStat.st_size);
+		if (uSize && (uSize==static_cast<WordPtr>(uSize))) {
+			void *pMap = mmap(NULL,static_cast<size_t>(uSize),PROT_READ|PROT_WRITE,MAP_PRIVATE,fp,0);
+			if (pMap!=MAP_FAILED) {
+				m_pMappedFile = static_cast<Word8 *>(pMap);
+				m_uMappedSize = static_cast<WordPtr>(uSize);
+				uResult = File::OKAY;
+			}
+		}
+	}
+	close(fp);
+	return uResult;
+}
+
+/***************************************
+
+	\brief Release the memory mapped rez file
+
+	All pointers into the mapping that were given to the
+	application are invalid after this call.
+
+***************************************/
+
+void BURGER_API Burger::RezFile::UnmapFile(void)
+{
+	if (m_pMappedFile) {
+		munmap(m_pMappedFile,m_uMappedSize);
+		m_pMappedFile = NULL;
+		m_uMappedSize = 0;
+	}
+}
+
+#endif
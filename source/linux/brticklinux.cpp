@@ -0,0 +1,187 @@
+/***************************************
+
+	Incremental tick Manager Class, Linux version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brtick.h"
+
+#if defined(BURGER_LINUX)
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+
+/***************************************
+
+	All timers are derived from CLOCK_MONOTONIC so
+	they are immune to changes to the wall clock
+	and they never go backwards.
+
+	Since the monotonic clock is already in nanoseconds,
+	each tick value is converted with integer math
+	without a running anchor. The 64 bit intermediate
+	value is truncated, so the 32 bit result wraps
+	around cleanly.
+
+***************************************/
+
+/***************************************
+
+	Read the current system tick value
+
+***************************************/
+
+Word32 BURGER_API Burger::Tick::Read(void)
+{
+	timespec uTime;
+	clock_gettime(CLOCK_MONOTONIC,&uTime);
+	Word64 uTicks = (static_cast<Word64>(uTime.tv_sec)*TICKSPERSEC)+
+		((static_cast<Word64>(uTime.tv_nsec)*TICKSPERSEC)/1000000000ULL);
+	return static_cast<Word32>(uTicks);
+}
+
+/***************************************
+
+	Read the time in microsecond increments
+
+***************************************/
+
+Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
+{
+	timespec uTime;
+	clock_gettime(CLOCK_MONOTONIC,&uTime);
+	Word64 uTicks = (static_cast<Word64>(uTime.tv_sec)*1000000ULL)+
+		(static_cast<Word64>(uTime.tv_nsec)/1000ULL);
+	return static_cast<Word32>(uTicks);
+}
+
+/***************************************
+
+	Read the time in millisecond increments
+
+***************************************/
+
+Word32 BURGER_API Burger::Tick::ReadMilliseconds(void)
+{
+	timespec uTime;
+	clock_gettime(CLOCK_MONOTONIC,&uTime);
+	Word64 uTicks = (static_cast<Word64>(uTime.tv_sec)*1000ULL)+
+		(static_cast<Word64>(uTime.tv_nsec)/1000000ULL);
+	return static_cast<Word32>(uTicks);
+}
+
+/***************************************
+
+	\brief Reset the timer
+
+	Set m_uBaseTime to the current high precision time, however
+	this function will not reset the elapsed time.
+
+	\sa Reset(void)
+
+***************************************/
+
+void BURGER_API Burger::FloatTimer::SetBase(void)
+{
+	timespec uTime;
+	clock_gettime(CLOCK_MONOTONIC,&uTime);
+	m_uBaseTime = static_cast<Word64>(uTime.tv_sec);
+	m_uBaseTimeNano = static_cast<Word64>(uTime.tv_nsec);
+}
+
+/***************************************
+
+	\brief Read the timer in seconds
+
+	Return the elapsed time in seconds from the last
+	time this timer was reset. If the timer is paused, the
+	value will be at the time mark when the pause was invoked.
+
+	\sa Pause(void) or Reset(void)
+
+***************************************/
+
+float BURGER_API Burger::FloatTimer::GetTime(void)
+{
+	float fResult;
+
+	// If paused, just return the frozen elapsed time
+	if (m_bPaused) {
+		fResult = m_fElapsedTime;
+	} else {
+
+		timespec uTick;
+		clock_gettime(CLOCK_MONOTONIC,&uTick);
+
+		Word64 uMark = static_cast<Word64>(uTick.tv_sec);
+		Word64 uMarkNano = static_cast<Word64>(uTick.tv_nsec);
+
+		// CLOCK_MONOTONIC never goes backwards, so the only
+		// thing to handle is the borrow from the nanoseconds
+		Word64 uElapsedTime = uMark-m_uBaseTime;
+		Word64 uElapsedTimeNano;
+		if (uMarkNano<m_uBaseTimeNano) {
+			--uElapsedTime;
+			uElapsedTimeNano = (uMarkNano+1000000000ULL)-m_uBaseTimeNano;
+		} else {
+			uElapsedTimeNano = uMarkNano-m_uBaseTimeNano;
+		}
+		m_uBaseTime = uMark;
+		m_uBaseTimeNano = uMarkNano;
+
+		// Apply to seconds elapsed
+		uElapsedTime += m_uElapsedTime;
+		uElapsedTimeNano += m_uElapsedTimeNano;
+
+		// Handle wrap around
+		if (uElapsedTimeNano>=1000000000ULL) {
+			++uElapsedTime;
+			uElapsedTimeNano-=1000000000ULL;
+		}
+		m_uElapsedTime = uElapsedTime;
+		m_uElapsedTimeNano = uElapsedTimeNano;
+
+		// Convert from integer to float, using a high precision integer
+		// as the source to get around floating point imprecision.
+		fResult = static_cast<float>(static_cast<double>(uElapsedTime) + (static_cast<double>(uElapsedTimeNano)*0.000000001));
+		m_fElapsedTime = fResult;
+	}
+	return fResult;
+}
+
+/***************************************
+
+	Sleep the current thread
+
+***************************************/
+
+void BURGER_API Burger::Sleep(Word32 uMilliseconds)
+{
+	// Yield the time quantum?
+	if (uMilliseconds==SLEEP_YIELD) {
+		sched_yield();
+
+	// Sleep until a signal is received
+	} else if (uMilliseconds==SLEEP_INFINITE) {
+		pause();
+	} else {
+		timespec SleepTime;
+		// Seconds to sleep
+		SleepTime.tv_sec = static_cast<time_t>(uMilliseconds/1000U);
+		// Nanoseconds to sleep
+		SleepTime.tv_nsec = static_cast<long>((uMilliseconds%1000U)*1000000U);
+		// Restart the sleep if interrupted by a signal, with the time remaining
+		while (clock_nanosleep(CLOCK_MONOTONIC,0,&SleepTime,&SleepTime)==EINTR) {
+		}
+	}
+}
+
+#endif
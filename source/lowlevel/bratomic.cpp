@@ -13,6 +13,7 @@
 
 #include "bratomic.h"
 #include "brstringfunctions.h"
+#include "brtick.h"
 
 #if (defined(BURGER_PPC) && defined(BURGER_MACOSX))
 #include <sys/sysctl.h>
@@ -591,6 +592,20 @@ BURGER_DECLSPECNAKED Word BURGER_API Burger::IsCPUIDPresent(void)
 
 ***************************************/
 
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasPCLMULQDQ(void) const
+	\brief Returns non-zero if the PCLMULQDQ instruction is available
+
+	https://en.wikipedia.org/wiki/CLMUL_instruction_set
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instruction is available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTELARCHITECTURE
+
+***************************************/
+
 /*! ************************************
 
 	\fn BURGER_INLINE Word Burger::CPUID_t::HasAVX(void) const
@@ -605,6 +620,55 @@ BURGER_DECLSPECNAKED Word BURGER_API Burger::IsCPUIDPresent(void)
 
 ***************************************/
 
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::IsAVXEnabled(void) const
+	\brief Returns non-zero if AVX instructions can be executed
+
+	HasAVX() only reports that the CPU supports AVX. The operating
+	system also has to save the YMM registers on a context switch,
+	otherwise AVX instructions will fault. This function tests for
+	the XSAVE support and the YMM state in XCR0.
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are usable, zero if not.
+	\sa HasAVX(void) const or void CPUID(CPUID_t *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasAVX2(void) const
+	\brief Returns non-zero if AVX2 instructions are available
+
+	https://en.wikipedia.org/wiki/Advanced_Vector_Extensions#Advanced_Vector_Extensions_2
+
+	\note This structure only matters on systems with an x86 or x64 CPU.
+		Use IsAVXEnabled() to test if the operating system supports
+		the YMM registers.
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa IsAVXEnabled(void) const or void CPUID(CPUID_t *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn BURGER_INLINE Word Burger::CPUID_t::HasSHA(void) const
+	\brief Returns non-zero if the SHA instructions are available
+
+	The SHA extensions accelerate SHA-1 and SHA-256 hashing.
+
+	https://en.wikipedia.org/wiki/Intel_SHA_extensions
+
+	\note This structure only matters on systems with an x86 or x64 CPU
+
+	\return Non-zero if the instructions are available, zero if not.
+	\sa void CPUID(CPUID_t *) or BURGER_INTELARCHITECTURE
+
+***************************************/
+
 /*! ************************************
 
 	\fn BURGER_INLINE Word Burger::CPUID_t::HasCMPXCHG16B(void) const
@@ -786,6 +850,31 @@ static Word32 BURGER_API FixCount(Word32 uBase,int iValue)
 	return static_cast<Word32>(iValue);
 }
 
+//
+// Read XCR0 to see which register sets the operating system
+// saves on a context switch. Only call if OSXSAVE is set.
+//
+
+#if defined(BURGER_MSVC) && (_MSC_VER>=1700)
+#include <immintrin.h>
+#endif
+
+static Word32 BURGER_API GetXCR0(void)
+{
+#if defined(BURGER_MSVC) && (_MSC_VER>=1700)
+	return static_cast<Word32>(_xgetbv(0));
+#elif defined(BURGER_GNUC) || defined(BURGER_LLVM)
+	Word32 uEAX;
+	Word32 uEDX;
+	// xgetbv is emitted as bytes for assemblers that don't know it
+	__asm__ __volatile__(".byte 0x0F,0x01,0xD0" : "=a"(uEAX),"=d"(uEDX) : "c"(0));
+	return uEAX;
+#else
+	// Assume the OS doesn't support AVX
+	return 0;
+#endif
+}
+
 #endif
 
 void BURGER_API Burger::CPUID(CPUID_t *pOutput)
@@ -850,6 +939,11 @@ void BURGER_API Burger::CPUID(CPUID_t *pOutput)
 		pOutput->m_uCPUID1ECX = static_cast<Word32>(Results[2]);
 		pOutput->m_uCPUID1EDX = static_cast<Word32>(Results[3]);
 
+		// Does the OS support XSAVE? If so, get the enabled register sets
+		if (pOutput->m_uCPUID1ECX&0x08000000U) {
+			pOutput->m_uXGETBV0 = GetXCR0();
+		}
+
 		// Even more features?
 		if (uHighestID>=7) {
 #if defined(BURGER_MSVC) && (_MSC_VER<1600)
@@ -928,6 +1022,43 @@ void BURGER_API Burger::CPUID(CPUID_t *pOutput)
 #endif
 }
 
+/*! ************************************
+
+	\brief Return a cached \ref CPUID_t structure
+
+	The first call will fill in a CPUID_t with CPUID(CPUID_t *)
+	and every later call will return the same copy. It's meant
+	for code that selects a SIMD version of a function on each
+	call, so the CPUID instruction is only executed once.
+
+	If several threads call this function at the same time, one
+	will read the CPU features and the others wait until it's done.
+
+	\return Pointer to a read only CPUID_t for this machine
+	\sa CPUID(CPUID_t *)
+
+***************************************/
+
+static Burger::CPUID_t g_CachedCPUID;
+static volatile Word32 g_uCachedCPUIDState;	// 0 = not read, 1 = reading, 2 = valid
+
+const Burger::CPUID_t * BURGER_API Burger::GetCPUID(void)
+{
+	if (g_uCachedCPUIDState!=2) {
+		if (AtomicSetIfMatch(&g_uCachedCPUIDState,0,1)) {
+			CPUID(&g_CachedCPUID);
+			// The swap is a full barrier, the structure is written first
+			AtomicSwap(&g_uCachedCPUIDState,2);
+		} else {
+			// Another thread is reading the CPU features
+			while (g_uCachedCPUIDState!=2) {
+				Sleep(SLEEP_YIELD);
+			}
+		}
+	}
+	return &g_CachedCPUID;
+}
+
 /*! ************************************
 
 	\brief Return \ref TRUE if the AltiVec instruction set is present
@@ -80,6 +80,7 @@ struct CPUID_t {
 	Word32 m_uCPUID7EBX;				///< Feature bits CPUID(7)	-> EBX
 	Word32 m_uCPUID7ECX;				///< Feature bits CPUID(7) -> ECX
 	Word32 m_uCPUID7EDX;				///< Feature bits CPUID(7) -> EDX
+	Word32 m_uXGETBV0;					///< Register state enabled by the operating system XGETBV(0) -> EAX
 	eCPU m_uCPUType;					///< \ref TRUE if the CPU's name is AuthenticAMD
 	char m_CPUName[16];					///< 12 character brand name of the CPU (Null terminated)
 	char m_BrandName[52];				///< 48 character full name of the CPU (Null terminated)
@@ -96,7 +97,11 @@ struct CPUID_t {
 	BURGER_INLINE Word HasSSE41(void) const { return m_uCPUID1ECX&0x00080000U; }
 	BURGER_INLINE Word HasSSE42(void) const { return m_uCPUID1ECX& 0x00100000U; }
 	BURGER_INLINE Word HasAES(void) const { return m_uCPUID1ECX&0x02000000U; }
+	BURGER_INLINE Word HasPCLMULQDQ(void) const { return m_uCPUID1ECX&0x00000002U; }
 	BURGER_INLINE Word HasAVX(void) const { return m_uCPUID1ECX&0x10000000U; }
+	BURGER_INLINE Word IsAVXEnabled(void) const { return ((m_uCPUID1ECX&0x18000000U)==0x18000000U) && ((m_uXGETBV0&6U)==6U); }
+	BURGER_INLINE Word HasAVX2(void) const { return m_uCPUID7EBX&0x00000020U; }
+	BURGER_INLINE Word HasSHA(void) const { return m_uCPUID7EBX&0x20000000U; }
 	BURGER_INLINE Word HasCMPXCHG16B(void) const { return m_uCPUID1ECX&0x00002000U; }
 	BURGER_INLINE Word HasF16C(void) const { return m_uCPUID1ECX&0x20000000U; }
 	BURGER_INLINE Word HasFMA3(void) const { return m_uCPUID1ECX&0x00001000U; }
@@ -108,6 +113,7 @@ struct CPUID_t {
 };
 
 extern void BURGER_API CPUID(CPUID_t *pOutput);
+extern const CPUID_t * BURGER_API GetCPUID(void);
 
 #if defined(BURGER_PS3) || defined(BURGER_XBOX360)
 BURGER_INLINE Word HasAltiVec(void) { return TRUE; }
@@ -500,7 +506,7 @@ BURGER_INLINE Word32 AtomicPreDecrement(volatile Word32 *pInput) { return __sync
 BURGER_INLINE Word32 AtomicPostDecrement(volatile Word32 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
 
 BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp; do { uTemp = pOutput[0]; } while(__sync_val_compare_and_swap(pOutput,uTemp,uInput)!=uTemp); return uTemp;}
 BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { return __sync_add_and_fetch(pInput,1); }
@@ -509,7 +515,7 @@ BURGER_INLINE Word64 AtomicPreDecrement(volatile Word64 *pInput) { return __sync
 BURGER_INLINE Word64 AtomicPostDecrement(volatile Word64 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
 	
 #elif (((__GNUC * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__) <= 40100) && defined(BURGER_MACOSX)) || defined(DOXYGEN)
 	
@@ -39,7 +39,7 @@
 
 #if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_PS3) || \
 	defined(BURGER_PS4) || defined(BURGER_SHIELD) || defined(BURGER_VITA) || \
-	defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::CriticalSection::CriticalSection()
 {
 }
@@ -256,7 +256,7 @@ Burger::CriticalSectionStatic::~CriticalSectionStatic()
 ***************************************/
 
 #if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_VITA) || \
-	defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 /*! ************************************
 
@@ -384,7 +384,7 @@ Word BURGER_API Burger::Semaphore::Release(void)
 
 ***************************************/
 
-#if !(defined(BURGER_SHIELD) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_SHIELD) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::ConditionVariable::ConditionVariable() :
 	m_CriticalSection(),
 	m_WaitSemaphore(0),
@@ -560,7 +560,7 @@ Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSectio
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::Thread::Thread() :
 	m_pFunction(NULL),
 	m_pData(NULL),
@@ -50,6 +50,10 @@
 #include "briostypes.h"
 #endif
 
+#if defined(BURGER_LINUX) && !defined(__BRLINUXTYPES_H__)
+#include "brlinuxtypes.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 class CriticalSection {
@@ -63,9 +67,9 @@ class CriticalSection {
 #if defined(BURGER_PS4) || defined(DOXYGEN)
 	pthread_mutex *m_Lock;		///< Critical section for PS4 (PS4 only)
 #endif
-#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	friend class ConditionVariable;
-	pthread_mutex_t m_Lock;		///< Critical section for Android/MacOSX/iOS (Android/MacOSX/iOS only)
+	pthread_mutex_t m_Lock;		///< Critical section for Android/MacOSX/iOS/Linux (Android/MacOSX/iOS/Linux only)
 #endif
 #if defined(BURGER_VITA) || defined(DOXYGEN)
 	int m_iLock;				///< Critical section ID for VITA
@@ -112,6 +116,9 @@ class Semaphore {
 	semaphore_t m_Semaphore;	///< Semaphore instance (MacOSX/iOS only)
 	task_t m_Owner;				///< Task ID of the semaphore owner (MacOSX/iOS only)
 	Word m_bInitialized;		///< \ref TRUE if the semaphore instance successfully initialized
+#endif
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	volatile Word32 m_uWaiting;	///< Number of threads sleeping on the futex (Linux only)
 #endif
 	volatile Word32 m_uCount;	///< Semaphore count value
 public:
@@ -124,15 +131,15 @@ public:
 };
 
 class ConditionVariable {
-#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
-	pthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/MacOSX/iOS only)
-	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/MacOSX/iOS only)
+#if (defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
+	pthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/MacOSX/iOS/Linux only)
+	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/MacOSX/iOS/Linux only)
 #endif
 #if (defined(BURGER_VITA)) || defined(DOXYGEN)
 	int m_iConditionVariable;	///< Condition variable instance (Vita only)
 	int m_iMutex;				///< Mutex for the condition variable (Vita only)
 #endif
-#if !(defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_SHIELD) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	CriticalSection m_CriticalSection;	///< CriticalSection for this class (Non-specialized platforms)
 	Semaphore m_WaitSemaphore;		///< Binary semaphore for forcing thread to wait for a signal (Non-specialized platforms)
 	Semaphore m_SignalsSemaphore;	///< Binary semaphore for the number of pending signals (Non-specialized platforms)
@@ -163,6 +170,10 @@ private:
 #endif
 #if (defined(BURGER_VITA)) || defined(DOXYGEN)
 	int m_iThreadID;				///< System ID of the thread (Vita only)
+#endif
+#if (defined(BURGER_LINUX)) || defined(DOXYGEN)
+	WordPtr m_uThreadHandle;		///< pthread_t of the thread (Linux only)
+	Semaphore m_Started;			///< Released by the thread once it's running (Linux only)
 #endif
 	WordPtr m_uResult;				///< Result code of the thread on exit
 public:
@@ -178,6 +189,8 @@ public:
 	BURGER_INLINE Word IsInitialized(void) const { return m_pThreadHandle!=NULL; }
 #elif defined(BURGER_VITA)
 	BURGER_INLINE Word IsInitialized(void) const { return m_iThreadID>=0; }
+#elif defined(BURGER_LINUX)
+	BURGER_INLINE Word IsInitialized(void) const { return m_uThreadHandle!=0; }
 #else 
 	BURGER_INLINE Word IsInitialized(void) const { return FALSE; }
 #endif
@@ -0,0 +1,564 @@
+/***************************************
+
+	Work stealing job scheduler
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brjobscheduler.h"
+#include "bratomic.h"
+#include "brtick.h"
+#include "brglobalmemorymanager.h"
+#include "brassert.h"
+
+/*! ************************************
+
+	\class Burger::JobScheduler
+	\brief Work stealing job scheduler
+
+	A pool of worker threads, sized to the number of CPU cores, that
+	execute small jobs in parallel. Every thread that runs jobs owns a
+	slot with its own job queue. Slot 0 belongs to the thread that
+	created the scheduler and slots 1 through GetWorkerCount() belong
+	to the worker threads.
+
+	Jobs added to a slot are taken back by the owner in last in, first
+	out order so the data they touch is still in the cache. When a
+	thread's queue is empty, it steals the oldest job from another
+	slot. The queues are guarded by a per slot spin lock, which is only
+	contested when a thread is stealing.
+
+	Jobs are passed the index of the slot that is running them, so any
+	jobs they add or wait on use the same slot. Only the thread that
+	owns a slot may pass its index.
+
+	Completion is tracked with a Counter, which is incremented by every
+	job that is added with it and decremented as each job finishes.
+	Wait(const Counter *,Word) runs queued jobs until the counter reaches
+	zero, so waiting never blocks a thread that could do work. A job
+	can be given a Counter as a dependency, it won't start until that
+	counter reaches zero.
+
+	If no worker threads can be created, all jobs are executed on the
+	calling thread during Wait(const Counter *,Word).
+
+	\note All jobs must be waited on before the scheduler is destroyed.
+		Jobs that are still queued are discarded.
+
+	\sa RunQueue or Thread
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::JobScheduler::Counter
+	\brief Count of jobs that have not completed
+
+	Pass a pointer to this class to JobScheduler::Add() for
+	each job in a group, and then call JobScheduler::Wait() to
+	wait for the entire group to finish.
+
+	\sa JobScheduler
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::JobScheduler::Counter::IsDone(void) const
+	\brief Test if all of the jobs have completed
+
+	\return \ref TRUE if the count is zero
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::JobScheduler::Counter::GetCount(void) const
+	\brief Return the number of jobs that have not completed
+
+	\return Number of jobs still queued or executing
+
+***************************************/
+
+//
+// Spin lock for a job queue, the queue is only held
+// for a few instructions so there's no need to sleep
+//
+
+static BURGER_INLINE void LockSlot(volatile Word32 *pLock)
+{
+	Word uSpinCount = 0;
+	while (!Burger::AtomicSetIfMatch(pLock,0,1)) {
+		if (++uSpinCount>=64) {
+			uSpinCount = 0;
+			Burger::Sleep(Burger::SLEEP_YIELD);
+		}
+	}
+}
+
+static BURGER_INLINE void UnlockSlot(volatile Word32 *pLock)
+{
+	Burger::AtomicSwap(pLock,0);
+}
+
+/*! ************************************
+
+	\brief Start up the worker threads
+
+	Create the worker threads and the job queues. If the number of
+	workers is \ref BURGER_MAXUINT, one thread is created for every CPU
+	core except the calling thread's. Zero workers is valid, all jobs
+	will execute on the calling thread.
+
+	\param uWorkerCount Number of worker threads to create
+	\sa GetCPUCount(void)
+
+***************************************/
+
+Burger::JobScheduler::JobScheduler(Word uWorkerCount) :
+	m_pSlots(NULL),
+	m_pThreads(NULL),
+	m_WakeUp(0),
+	m_uWorkerCount(0),
+	m_uSleeping(0),
+	m_bQuit(FALSE),
+	m_uStealCount(0)
+{
+	if (uWorkerCount==BURGER_MAXUINT) {
+		uWorkerCount = GetCPUCount()-1;
+	}
+	if (uWorkerCount>MAXWORKERS) {
+		uWorkerCount = MAXWORKERS;
+	}
+	Slot_t *pSlots = static_cast<Slot_t *>(Alloc(sizeof(Slot_t)*(uWorkerCount+1)));
+	if (pSlots) {
+		Word i = 0;
+		do {
+			pSlots[i].m_uLock = 0;
+			pSlots[i].m_uHead = 0;
+			pSlots[i].m_uTail = 0;
+			pSlots[i].m_uSlot = i;
+			pSlots[i].m_pParent = this;
+		} while (++i<=uWorkerCount);
+		m_pSlots = pSlots;
+
+		if (uWorkerCount) {
+			Thread *pThreads = static_cast<Thread *>(Alloc(sizeof(Thread)*uWorkerCount));
+			if (pThreads) {
+				m_pThreads = pThreads;
+				i = 0;
+				do {
+					new (&pThreads[i]) Thread();
+					// Stop if the platform can't create any more threads
+					if (pThreads[i].Start(WorkerThread,&pSlots[i+1])) {
+						pThreads[i].~Thread();
+						break;
+					}
+					m_uWorkerCount = i+1;
+				} while (++i<uWorkerCount);
+			}
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Shut down the worker threads
+
+	Wake all the workers, wait for them to exit and release
+	the job queues. Jobs that are still queued are not executed.
+
+***************************************/
+
+Burger::JobScheduler::~JobScheduler()
+{
+	m_bQuit = TRUE;
+	Word uWorkerCount = m_uWorkerCount;
+	if (uWorkerCount) {
+		Word i = 0;
+		do {
+			m_WakeUp.Release();
+		} while (++i<uWorkerCount);
+		Thread *pThreads = m_pThreads;
+		do {
+			pThreads->Wait();
+			pThreads->~Thread();
+			++pThreads;
+		} while (--uWorkerCount);
+	}
+	Free(m_pThreads);
+	Free(m_pSlots);
+}
+
+/***************************************
+
+	Main loop for each worker thread
+
+***************************************/
+
+WordPtr BURGER_API Burger::JobScheduler::WorkerThread(void *pData)
+{
+	Slot_t *pSlot = static_cast<Slot_t *>(pData);
+	JobScheduler *pThis = pSlot->m_pParent;
+	Word uSlot = pSlot->m_uSlot;
+	while (!pThis->m_bQuit) {
+		Job_t Job;
+		Word bDeferred;
+		if (pThis->GetJob(&Job,uSlot,&bDeferred)) {
+			pThis->Execute(&Job,uSlot);
+		} else if (bDeferred) {
+			// Jobs are waiting on a dependency, check again shortly
+			Sleep(SLEEP_YIELD);
+		} else {
+			// Announce the sleep before the final check so a
+			// job added in between will release the semaphore
+			AtomicPreIncrement(&pThis->m_uSleeping);
+			if (pThis->GetJob(&Job,uSlot,&bDeferred)) {
+				AtomicPreDecrement(&pThis->m_uSleeping);
+				pThis->Execute(&Job,uSlot);
+			} else {
+				if (!bDeferred) {
+					pThis->m_WakeUp.Acquire();
+				}
+				AtomicPreDecrement(&pThis->m_uSleeping);
+			}
+		}
+	}
+	return 0;
+}
+
+/***************************************
+
+	Add a job to the newest end of a slot's queue
+
+	Return FALSE if the queue is full
+
+***************************************/
+
+Word BURGER_API Burger::JobScheduler::Push(Word uSlot,const Job_t *pJob)
+{
+	Word uResult = FALSE;
+	if (m_pSlots) {
+		Slot_t *pSlot = &m_pSlots[uSlot];
+		LockSlot(&pSlot->m_uLock);
+		Word32 uTail = pSlot->m_uTail;
+		if ((uTail-pSlot->m_uHead)<QUEUESIZE) {
+			pSlot->m_Jobs[uTail&(QUEUESIZE-1)] = pJob[0];
+			pSlot->m_uTail = uTail+1;
+			uResult = TRUE;
+		}
+		UnlockSlot(&pSlot->m_uLock);
+		if (uResult) {
+			WakeWorkers();
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Get a job that is ready to run
+
+	Take the newest job from this slot's queue, and if it's empty,
+	steal the oldest job from another slot. If a job isn't ready
+	because of a dependency, it's moved to the oldest end of this
+	slot's queue and *pDeferred is set to TRUE.
+
+***************************************/
+
+Word BURGER_API Burger::JobScheduler::GetJob(Job_t *pOutput,Word uSlot,Word *pDeferred)
+{
+	pDeferred[0] = FALSE;
+	if (!m_pSlots) {
+		return FALSE;
+	}
+	Word uSlotCount = m_uWorkerCount+1;
+	Word uIndex = uSlot;
+	Word i = 0;
+	do {
+		Slot_t *pSlot = &m_pSlots[uIndex];
+		// Don't bother locking empty queues
+		if (pSlot->m_uHead!=pSlot->m_uTail) {
+			Word bFound = FALSE;
+			LockSlot(&pSlot->m_uLock);
+			Word32 uHead = pSlot->m_uHead;
+			Word32 uTail = pSlot->m_uTail;
+			if (uHead!=uTail) {
+				if (!i) {
+					// Owner takes the newest
+					--uTail;
+					pOutput[0] = pSlot->m_Jobs[uTail&(QUEUESIZE-1)];
+					pSlot->m_uTail = uTail;
+				} else {
+					// Thieves take the oldest
+					pOutput[0] = pSlot->m_Jobs[uHead&(QUEUESIZE-1)];
+					pSlot->m_uHead = uHead+1;
+				}
+				bFound = TRUE;
+			}
+			UnlockSlot(&pSlot->m_uLock);
+			if (bFound) {
+				if (i) {
+					AtomicPreIncrement(&m_uStealCount);
+				}
+				const Counter *pDependency = pOutput->m_pDependency;
+				if (!pDependency || !pDependency->m_uCount) {
+					return TRUE;
+				}
+				// Not ready, put it where it will be found last
+				pSlot = &m_pSlots[uSlot];
+				LockSlot(&pSlot->m_uLock);
+				uHead = pSlot->m_uHead;
+				Word bQueued = (pSlot->m_uTail-uHead)<QUEUESIZE;
+				if (bQueued) {
+					--uHead;
+					pSlot->m_Jobs[uHead&(QUEUESIZE-1)] = pOutput[0];
+					pSlot->m_uHead = uHead;
+				}
+				UnlockSlot(&pSlot->m_uLock);
+				if (!bQueued) {
+					// No room, help until the dependency is satisfied
+					Wait(pDependency,uSlot);
+					return TRUE;
+				}
+				pDeferred[0] = TRUE;
+			}
+		}
+		if (++uIndex>=uSlotCount) {
+			uIndex = 0;
+		}
+	} while (++i<uSlotCount);
+	return FALSE;
+}
+
+/***************************************
+
+	Execute a job and decrement its counter
+
+	Range jobs split off their upper half into new jobs
+	until they are no larger than the grain size so other
+	threads can steal them.
+
+***************************************/
+
+void BURGER_API Burger::JobScheduler::Execute(Job_t *pJob,Word uSlot)
+{
+	Counter *pCounter = pJob->m_pCounter;
+	if (pJob->m_pProc) {
+		pJob->m_pProc(pJob->m_pData,uSlot);
+	} else {
+		WordPtr uStart = pJob->m_uStart;
+		WordPtr uEnd = pJob->m_uEnd;
+		while ((uEnd-uStart)>pJob->m_uGrainSize) {
+			WordPtr uMiddle = uStart+((uEnd-uStart)>>1U);
+			Job_t Split = pJob[0];
+			Split.m_pDependency = NULL;
+			Split.m_uStart = uMiddle;
+			Split.m_uEnd = uEnd;
+			AtomicPreIncrement(&pCounter->m_uCount);
+			if (!Push(uSlot,&Split)) {
+				// Queue is full, do the rest here
+				AtomicPreDecrement(&pCounter->m_uCount);
+				break;
+			}
+			uEnd = uMiddle;
+		}
+		pJob->m_pRangeProc(pJob->m_pData,uStart,uEnd,uSlot);
+	}
+	if (pCounter) {
+		AtomicPreDecrement(&pCounter->m_uCount);
+	}
+}
+
+/***************************************
+
+	Wake up a sleeping worker
+
+***************************************/
+
+void BURGER_API Burger::JobScheduler::WakeWorkers(void)
+{
+	if (m_uSleeping) {
+		m_WakeUp.Release();
+	}
+}
+
+/*! ************************************
+
+	\brief Add a job
+
+	Queue a function to be called by any of the threads. If a
+	Counter is passed, it's incremented now and decremented when
+	the function returns.
+
+	If pDependency is not \ref NULL, the job will not start until
+	that counter reaches zero. The dependency must not depend on
+	this job.
+
+	If the queue is full, the job is executed immediately.
+
+	\param pProc Function to call
+	\param pData Pointer to pass to the function
+	\param pCounter Pointer to a Counter to track completion or \ref NULL
+	\param uSlot Slot of the calling thread, 0 if not called from a job
+	\param pDependency Counter that must reach zero before the job starts or \ref NULL
+	\return \ref TRUE if the job was queued, \ref FALSE if it was executed before returning
+	\sa Wait(const Counter *,Word) or ParallelFor(WordPtr,RangeProc,void *,WordPtr,Word)
+
+***************************************/
+
+Word BURGER_API Burger::JobScheduler::Add(JobProc pProc,void *pData,Counter *pCounter,Word uSlot,const Counter *pDependency)
+{
+	BURGER_ASSERT(uSlot<GetSlotCount());
+	Job_t Job;
+	Job.m_pProc = pProc;
+	Job.m_pRangeProc = NULL;
+	Job.m_pData = pData;
+	Job.m_pCounter = pCounter;
+	Job.m_pDependency = pDependency;
+	Job.m_uStart = 0;
+	Job.m_uEnd = 0;
+	Job.m_uGrainSize = 0;
+	if (pCounter) {
+		AtomicPreIncrement(&pCounter->m_uCount);
+	}
+	Word uResult = Push(uSlot,&Job);
+	if (!uResult) {
+		if (pDependency) {
+			Wait(pDependency,uSlot);
+		}
+		Execute(&Job,uSlot);
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Wait for a group of jobs to complete
+
+	Execute queued jobs, including jobs from other slots, until
+	the counter reaches zero.
+
+	\param pCounter Pointer to the Counter to wait on
+	\param uSlot Slot of the calling thread, 0 if not called from a job
+	\sa Add(JobProc,void *,Counter *,Word,const Counter *)
+
+***************************************/
+
+void BURGER_API Burger::JobScheduler::Wait(const Counter *pCounter,Word uSlot)
+{
+	BURGER_ASSERT(uSlot<GetSlotCount());
+	while (pCounter->m_uCount) {
+		Job_t Job;
+		Word bDeferred;
+		if (GetJob(&Job,uSlot,&bDeferred)) {
+			Execute(&Job,uSlot);
+		} else {
+			// The remaining jobs are running on other threads
+			Sleep(SLEEP_YIELD);
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Call a function over a range of indexes in parallel
+
+	Split the indexes 0 through uCount-1 into ranges and call pProc
+	for each range on any of the threads. The range is split in half
+	repeatedly, so idle threads steal large pieces and the calling
+	thread works through the small pieces. This function returns
+	when every index has been processed.
+
+	If the grain size is zero, the range is split into about 8 pieces
+	per thread.
+
+	\param uCount Number of indexes to process
+	\param pProc Function to call with a starting index and an index past the end
+	\param pData Pointer to pass to the function
+	\param uGrainSize Largest range to pass to the function, 0 to pick a size
+	\param uSlot Slot of the calling thread, 0 if not called from a job
+	\sa Add(JobProc,void *,Counter *,Word,const Counter *)
+
+***************************************/
+
+void BURGER_API Burger::JobScheduler::ParallelFor(WordPtr uCount,RangeProc pProc,void *pData,WordPtr uGrainSize,Word uSlot)
+{
+	if (uCount) {
+		if (!uGrainSize) {
+			uGrainSize = uCount/(static_cast<WordPtr>(GetSlotCount())*8U);
+			if (!uGrainSize) {
+				uGrainSize = 1;
+			}
+		}
+		Counter Pending;
+		Pending.m_uCount = 1;
+		Job_t Job;
+		Job.m_pProc = NULL;
+		Job.m_pRangeProc = pProc;
+		Job.m_pData = pData;
+		Job.m_pCounter = &Pending;
+		Job.m_pDependency = NULL;
+		Job.m_uStart = 0;
+		Job.m_uEnd = uCount;
+		Job.m_uGrainSize = uGrainSize;
+		Execute(&Job,uSlot);
+		Wait(&Pending,uSlot);
+	}
+}
+
+/*! ************************************
+
+	\fn Word Burger::JobScheduler::GetWorkerCount(void) const
+	\brief Return the number of worker threads
+
+	\return Number of worker threads that were started
+	\sa GetSlotCount(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::JobScheduler::GetSlotCount(void) const
+	\brief Return the number of job slots
+
+	There is one slot for each worker thread plus one for the
+	thread that created the scheduler.
+
+	\return Number of valid slot indexes
+	\sa GetWorkerCount(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::JobScheduler::GetStealCount(void) const
+	\brief Return the number of stolen jobs
+
+	Used for profiling the distribution of the work.
+
+	\return Number of jobs that were taken from another slot's queue
+
+***************************************/
+
+/*! ************************************
+
+	\brief Return the number of CPU cores
+
+	\return Number of logical CPUs available to the application, at least 1
+	\sa JobScheduler(Word)
+
+***************************************/
+
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_LINUX) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+Word BURGER_API Burger::JobScheduler::GetCPUCount(void)
+{
+	return 1;
+}
+#endif
@@ -0,0 +1,91 @@
+/***************************************
+
+	Work stealing job scheduler
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRJOBSCHEDULER_H__
+#define __BRJOBSCHEDULER_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class JobScheduler {
+	BURGER_DISABLECOPYCONSTRUCTORS(JobScheduler);
+public:
+	typedef void (BURGER_API *JobProc)(void *pData,Word uSlot);	///< Job function prototype
+	typedef void (BURGER_API *RangeProc)(void *pData,WordPtr uStart,WordPtr uEnd,Word uSlot);	///< ParallelFor() function prototype
+	enum {
+		MAXWORKERS=64,		///< Maximum number of worker threads
+		QUEUESIZE=256		///< Number of jobs each slot can hold (Power of 2)
+	};
+	class Counter {
+		BURGER_DISABLECOPYCONSTRUCTORS(Counter);
+		friend class JobScheduler;
+		volatile Word32 m_uCount;	///< Number of jobs that have not completed
+	public:
+		Counter() : m_uCount(0) {}
+		BURGER_INLINE Word IsDone(void) const { return !m_uCount; }
+		BURGER_INLINE Word32 GetCount(void) const { return m_uCount; }
+	};
+private:
+	struct Job_t {
+		JobProc m_pProc;			///< Function to call, \ref NULL for a range job
+		RangeProc m_pRangeProc;		///< Function to call for a range job
+		void *m_pData;				///< Data pointer to pass to the function
+		Counter *m_pCounter;		///< Counter to decrement on completion or \ref NULL
+		const Counter *m_pDependency;	///< Counter that must reach zero before running or \ref NULL
+		WordPtr m_uStart;			///< First index of a range job
+		WordPtr m_uEnd;				///< Index past the end of a range job
+		WordPtr m_uGrainSize;		///< Smallest range to split
+	};
+	struct Slot_t {
+		volatile Word32 m_uLock;	///< Spin lock for the queue
+		Word32 m_uHead;				///< Index of the oldest job, stolen by other threads
+		Word32 m_uTail;				///< Index past the newest job, used by the owner
+		Word m_uSlot;				///< Index of this slot
+		JobScheduler *m_pParent;	///< Scheduler that owns this slot
+		Job_t m_Jobs[QUEUESIZE];	///< Circular job queue
+	};
+	Slot_t *m_pSlots;				///< Job queue for each thread, slot 0 is the owner's
+	Thread *m_pThreads;				///< Worker threads
+	Semaphore m_WakeUp;				///< Released when jobs are added
+	Word m_uWorkerCount;			///< Number of worker threads started
+	volatile Word32 m_uSleeping;	///< Number of worker threads waiting for jobs
+	volatile Word32 m_bQuit;		///< Set to \ref TRUE to shut down the worker threads
+	volatile Word32 m_uStealCount;	///< Number of jobs taken from another slot's queue
+
+	static WordPtr BURGER_API WorkerThread(void *pData);
+	Word BURGER_API Push(Word uSlot,const Job_t *pJob);
+	Word BURGER_API GetJob(Job_t *pOutput,Word uSlot,Word *pDeferred);
+	void BURGER_API Execute(Job_t *pJob,Word uSlot);
+	void BURGER_API WakeWorkers(void);
+public:
+	JobScheduler(Word uWorkerCount=BURGER_MAXUINT);
+	~JobScheduler();
+	Word BURGER_API Add(JobProc pProc,void *pData,Counter *pCounter=NULL,Word uSlot=0,const Counter *pDependency=NULL);
+	void BURGER_API Wait(const Counter *pCounter,Word uSlot=0);
+	void BURGER_API ParallelFor(WordPtr uCount,RangeProc pProc,void *pData,WordPtr uGrainSize=0,Word uSlot=0);
+	BURGER_INLINE Word GetWorkerCount(void) const { return m_uWorkerCount; }
+	BURGER_INLINE Word GetSlotCount(void) const { return m_uWorkerCount+1; }
+	BURGER_INLINE Word32 GetStealCount(void) const { return m_uStealCount; }
+	static Word BURGER_API GetCPUCount(void);
+};
+}
+/* END */
+
+#endif
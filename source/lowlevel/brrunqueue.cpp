@@ -13,6 +13,8 @@
 
 #include "brrunqueue.h"
 #include "brglobalmemorymanager.h"
+#include "brtick.h"
+#include "brstringfunctions.h"
 
 /*! ************************************
 
@@ -25,6 +27,20 @@
 	on a demand basis, such as polling tasks and game logic objects.
 	
 	Each function is of a type of RunQueue::CallbackProc
+
+	Entries that are added with Add() are called on every call to
+	Call() in order of priority. Entries that are added with
+	AddDelayed() or AddPeriodic() wait in a timer wheel keyed off of
+	Tick::Read() and are only called once their tick arrives, so
+	waiting entries cost nothing per call.
+
+	The active entries are kept in a linked list sorted by priority
+	with a sorted array of the last entry of each priority, so adding
+	an entry is a binary search on the number of distinct priorities.
+	Removing an entry by its pointer is constant time.
+
+	If SetTiming() is enabled, every call is timed so the callbacks
+	that take the most time can be found with FindSlowest().
 	
 	\note Due to the nature of memory use, the copying of this
 	class is forbidden.
@@ -94,6 +110,12 @@
 
 Burger::RunQueue::RunQueueEntry::~RunQueueEntry()
 {
+	// Remove from the RunQueue so it can update its
+	// priority table and the execution pointer
+	if (m_pParent) {
+		m_pParent->Unlink(this);
+		m_pParent = NULL;
+	}
 	if (m_pShutdownCallback) {
 		m_pShutdownCallback(m_pData);
 	}
@@ -112,19 +134,127 @@ Burger::RunQueue::RunQueueEntry::~RunQueueEntry()
 	
 ***************************************/
 
+/*! ************************************
+
+	\fn RunQueue::CallbackProc Burger::RunQueue::RunQueueEntry::GetCallback(void) const
+	\brief Get the function pointer
+
+	\return The function that is called by RunQueue::Call()
+	\sa GetData(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn void *Burger::RunQueue::RunQueueEntry::GetData(void) const
+	\brief Get the data pointer
+
+	\return The pointer passed to the function
+	\sa GetCallback(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RunQueue::RunQueueEntry::GetPeriod(void) const
+	\brief Get the number of ticks between calls
+
+	\return Period of an entry added with RunQueue::AddPeriodic(), zero for all others
+	\sa GetDueTick(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RunQueue::RunQueueEntry::GetDueTick(void) const
+	\brief Get the tick when a timed entry will run
+
+	\return Tick::Read() value of the next call of a delayed or periodic entry
+	\sa GetPeriod(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RunQueue::RunQueueEntry::GetCallCount(void) const
+	\brief Get the number of timed calls
+
+	\return Number of calls made while RunQueue::IsTiming() was \ref TRUE
+	\sa GetTotalTime(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RunQueue::RunQueueEntry::GetLastTime(void) const
+	\brief Get the time of the last call
+
+	\return Microseconds taken by the most recent timed call
+	\sa GetMaxTime(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RunQueue::RunQueueEntry::GetMaxTime(void) const
+	\brief Get the time of the slowest call
+
+	\return Most microseconds taken by a single timed call
+	\sa GetLastTime(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::RunQueue::RunQueueEntry::GetTotalTime(void) const
+	\brief Get the time taken by all calls
+
+	\return Microseconds taken by all of the timed calls
+	\sa GetCallCount(void) const or RunQueue::FindSlowest(void) const
+	
+***************************************/
+
+/*! ************************************
+
+	\brief Clear the timing statistics
+
+	\sa RunQueue::ResetTiming(void)
+	
+***************************************/
+
+void BURGER_API Burger::RunQueue::RunQueueEntry::ResetTiming(void)
+{
+	m_uCallCount = 0;
+	m_uLastTime = 0;
+	m_uMaxTime = 0;
+	m_uTotalTime = 0;
+}
+
 
 
 
 /*! ************************************
 
-	\fn Burger::RunQueue::RunQueue()
 	\brief RunQueue constructor.
 
-	Initialize the class to contain no list. This is
-	inline due to its only zeroing out members.
+	Initialize the class to contain no list.
 	
 ***************************************/
 
+Burger::RunQueue::RunQueue() :
+	m_Entries(),
+	m_pTails(NULL),
+	m_pNextEntry(NULL),
+	m_pCurrentEntry(NULL),
+	m_uTailCount(0),
+	m_uTailMax(0),
+	m_uSerial(0),
+	m_uLastTick(0),
+	m_bTiming(FALSE),
+	m_Recurse(FALSE)
+{
+}
+
 /*! ************************************
 
 	\brief RunQueue destructor.
@@ -139,17 +269,200 @@ Burger::RunQueue::RunQueueEntry::~RunQueueEntry()
 Burger::RunQueue::~RunQueue()
 {
 	Clear();
+	Free(m_pTails);
+}
+
+/***************************************
+
+	Allocate a new entry
+
+***************************************/
+
+Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Create(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word uPriority)
+{
+	RunQueueEntry *pResult = NULL;
+	if (pProc) {
+		pResult = new (Alloc(sizeof(RunQueueEntry))) RunQueueEntry(pProc,pShutdown,pData,uPriority);
+		if (pResult) {
+			pResult->m_pParent = this;
+		}
+	}
+	return pResult;
+}
+
+/***************************************
+
+	Binary search the priority table
+
+	Return the index of the first group with a priority
+	that is less than or equal to uPriority
+
+***************************************/
+
+WordPtr BURGER_API Burger::RunQueue::FindTail(Word uPriority) const
+{
+	WordPtr uLow = 0;
+	WordPtr uHigh = m_uTailCount;
+	const PriorityTail_t *pTails = m_pTails;
+	while (uLow<uHigh) {
+		WordPtr uMiddle = (uLow+uHigh)>>1U;
+		if (pTails[uMiddle].m_uPriority>uPriority) {
+			uLow = uMiddle+1;
+		} else {
+			uHigh = uMiddle;
+		}
+	}
+	return uLow;
+}
+
+/***************************************
+
+	Insert an entry into the active list after all
+	the entries of the same or higher priority.
+	Return \ref FALSE without inserting if out of memory.
+
+***************************************/
+
+Word BURGER_API Burger::RunQueue::Activate(RunQueueEntry *pEntry)
+{
+	Word uPriority = pEntry->m_uPriority;
+	WordPtr uIndex = FindTail(uPriority);
+	PriorityTail_t *pTail = m_pTails+uIndex;
+	if ((uIndex<m_uTailCount) && (pTail->m_uPriority==uPriority)) {
+		// Append to the existing group
+		pTail->m_pLast->InsertAfter(pEntry);
+		pTail->m_pLast = pEntry;
+	} else {
+		// Make room for a new group
+		if (m_uTailCount>=m_uTailMax) {
+			Word uNewMax = m_uTailMax ? m_uTailMax*2 : 16;
+			PriorityTail_t *pNewTails = static_cast<PriorityTail_t *>(Realloc(m_pTails,sizeof(PriorityTail_t)*uNewMax));
+			if (!pNewTails) {
+				return FALSE;
+			}
+			m_pTails = pNewTails;
+			m_uTailMax = uNewMax;
+			pTail = pNewTails+uIndex;
+		}
+		MemoryMove(pTail+1,pTail,sizeof(PriorityTail_t)*(m_uTailCount-uIndex));
+		++m_uTailCount;
+		pTail->m_uPriority = uPriority;
+		pTail->m_pLast = pEntry;
+		// Insert after the lowest entry of the previous group
+		if (uIndex) {
+			pTail[-1].m_pLast->InsertAfter(pEntry);
+		} else {
+			m_Entries.InsertAfter(pEntry);
+		}
+	}
+	pEntry->m_uFlags &= ~RunQueueEntry::FLAG_WAITING;
+	pEntry->m_uAddSerial = m_uSerial;
+	return TRUE;
+}
+
+/***************************************
+
+	Insert an entry into the timer wheel
+
+***************************************/
+
+void BURGER_API Burger::RunQueue::Schedule(RunQueueEntry *pEntry,Word32 uDueTick)
+{
+	// Entries must be in a slot that hasn't been processed yet
+	if (static_cast<Int32>(uDueTick-m_uLastTick)<=0) {
+		uDueTick = m_uLastTick+1;
+	}
+	pEntry->m_uDueTick = uDueTick;
+	pEntry->m_uFlags |= RunQueueEntry::FLAG_WAITING;
+	m_TimerWheel[uDueTick&(WHEELSIZE-1)].InsertBefore(pEntry);
+}
+
+/***************************************
+
+	Remove an entry from the active list or the timer wheel
+
+***************************************/
+
+void BURGER_API Burger::RunQueue::Unlink(RunQueueEntry *pEntry)
+{
+	if (!(pEntry->m_uFlags&RunQueueEntry::FLAG_WAITING)) {
+		// Fix up the priority table if this is the last of its group
+		WordPtr uIndex = FindTail(pEntry->m_uPriority);
+		if ((uIndex<m_uTailCount) && (m_pTails[uIndex].m_pLast==pEntry)) {
+			DoublyLinkedList *pPrevious = pEntry->GetPrevious();
+			if ((pPrevious!=&m_Entries) && (static_cast<RunQueueEntry *>(pPrevious)->m_uPriority==pEntry->m_uPriority)) {
+				m_pTails[uIndex].m_pLast = static_cast<RunQueueEntry *>(pPrevious);
+			} else {
+				--m_uTailCount;
+				MemoryMove(m_pTails+uIndex,m_pTails+uIndex+1,sizeof(PriorityTail_t)*(m_uTailCount-uIndex));
+			}
+		}
+		// Keep Call() from executing a deleted entry
+		if (m_pNextEntry==pEntry) {
+			DoublyLinkedList *pNext = pEntry->GetNext();
+			m_pNextEntry = (pNext!=&m_Entries) ? static_cast<RunQueueEntry *>(pNext) : NULL;
+		}
+	}
+	if (m_pCurrentEntry==pEntry) {
+		m_pCurrentEntry = NULL;
+	}
+	pEntry->Detach();
+}
+
+/***************************************
+
+	Move all timed entries that are due into the active list
+
+***************************************/
+
+void BURGER_API Burger::RunQueue::ProcessTimers(Word32 uTick)
+{
+	Word32 uElapsed = uTick-m_uLastTick;
+	if (uElapsed) {
+		// Only check each slot once
+		if (uElapsed>WHEELSIZE) {
+			uElapsed = WHEELSIZE;
+		}
+		Word32 uSlotTick = m_uLastTick;
+		m_uLastTick = uTick;
+		do {
+			++uSlotTick;
+			DoublyLinkedList *pSlot = &m_TimerWheel[uSlotTick&(WHEELSIZE-1)];
+			DoublyLinkedList *pWork = pSlot->GetNext();
+			while (pWork!=pSlot) {
+				DoublyLinkedList *pNext = pWork->GetNext();
+				RunQueueEntry *pEntry = static_cast<RunQueueEntry *>(pWork);
+				// Entries more than one rotation away stay in the slot
+				if (static_cast<Int32>(uTick-pEntry->m_uDueTick)>=0) {
+					if (Activate(pEntry)) {
+						// Allow it to run in this pass
+						--pEntry->m_uAddSerial;
+					} else {
+						// Out of memory, try again on the next tick
+						// instead of waiting for a full rotation
+						Schedule(pEntry,uTick+1);
+					}
+				}
+				pWork = pNext;
+			}
+		} while (--uElapsed);
+	}
 }
 
 /*! ************************************
 
 	\brief Invoke every function stored within the list.
 
-	Traverse the array of functions to call and invoke each
+	Move the delayed and periodic entries whose tick has arrived into
+	the list, then traverse the list of functions to call and invoke each
 	and every one of them. The functions may add new entries
-	to the list or remove themselves if they need to. If Add()
+	to the list or remove any entry if they need to. If Add()
 	is called, execution of the new entry will be deferred until the next time
 	Call() is invoked.
+
+	\note New entries are deferred even if their priority places them
+	after the entry being called. Before the priority table was added,
+	such an entry was called in the same pass.
 	
 	The function called is of type RunQueue::CallbackProc.
 	
@@ -167,30 +480,74 @@ Burger::RunQueue::~RunQueue()
 void BURGER_API Burger::RunQueue::Call(void)
 {
 	if (!m_Recurse) {
-		// Get the master handle
-		RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());
-		if (pWork!=&m_Entries) {				// Any in the list?
-			m_Recurse = TRUE;					// Prevent recursion
-			do {
-				// Call the function
-				eReturnCode uCode = pWork->m_pCallBack(pWork->m_pData);
-				// Abort execution
-				if (uCode==ABORT) {
-					break;
-				}
+		m_Recurse = TRUE;					// Prevent recursion
+		Word32 uSerial = ++m_uSerial;
+		Word32 uTick = Tick::Read();
+		ProcessTimers(uTick);
 
-				// Next in the chain
-				RunQueueEntry *pNext = static_cast<RunQueueEntry *>(pWork->GetNext());
+		// Get the master handle
+		DoublyLinkedList *pFirst = m_Entries.GetNext();
+		m_pNextEntry = (pFirst!=&m_Entries) ? static_cast<RunQueueEntry *>(pFirst) : NULL;
+		RunQueueEntry *pWork;
+		while ((pWork = m_pNextEntry)!=NULL) {
+			// Get the next entry before the call, Unlink() will
+			// update it if the callback removes that entry
+			DoublyLinkedList *pNext = pWork->GetNext();
+			m_pNextEntry = (pNext!=&m_Entries) ? static_cast<RunQueueEntry *>(pNext) : NULL;
+
+			// Entries added during this pass wait until the next pass
+			if (pWork->m_uAddSerial==uSerial) {
+				continue;
+			}
+			m_pCurrentEntry = pWork;
 
+			// Call the function
+			eReturnCode uCode;
+			if (!m_bTiming) {
+				uCode = pWork->m_pCallBack(pWork->m_pData);
+			} else {
+				Word32 uMark = Tick::ReadMicroseconds();
+				uCode = pWork->m_pCallBack(pWork->m_pData);
+				uMark = Tick::ReadMicroseconds()-uMark;
+				// Did the callback delete its own entry?
+				if (m_pCurrentEntry) {
+					++pWork->m_uCallCount;
+					pWork->m_uLastTime = uMark;
+					if (uMark>pWork->m_uMaxTime) {
+						pWork->m_uMaxTime = uMark;
+					}
+					pWork->m_uTotalTime += uMark;
+				}
+			}
+			// Entry is still valid?
+			if (m_pCurrentEntry) {
+				m_pCurrentEntry = NULL;
 				// Dispose of this entry
 				if (uCode==DISPOSE) {
-					// Remove this entry
 					Delete(pWork);
+				} else if (pWork->m_uFlags&RunQueueEntry::FLAG_TIMED) {
+					Word32 uPeriod = pWork->m_uPeriod;
+					if (!uPeriod) {
+						// Delayed entries only run once
+						Delete(pWork);
+					} else {
+						// Keep the cadence unless it fell behind
+						Word32 uDueTick = pWork->m_uDueTick+uPeriod;
+						if (static_cast<Int32>(uDueTick-uTick)<=0) {
+							uDueTick = uTick+uPeriod;
+						}
+						Unlink(pWork);
+						Schedule(pWork,uDueTick);
+					}
 				}
-				pWork = pNext;				// Next one
-			} while (pWork!=&m_Entries);	// Any more?
-			m_Recurse = FALSE;				// I'm done, so release the lock
+			}
+			// Abort execution
+			if (uCode==ABORT) {
+				break;
+			}
 		}
+		m_pNextEntry = NULL;
+		m_Recurse = FALSE;				// I'm done, so release the lock
 	}
 }
 
@@ -203,8 +560,12 @@ void BURGER_API Burger::RunQueue::Call(void)
 	with each call to Call(). The pointer pData is not used by
 	this class and it's solely used as a parameter when the function
 	pointer is called. Priority values are used to sort the function pointers to call
-	them in a desired order. The default is RunQueue::MEDIUMPRIORITY. There is no sorting with
-	like numbered priorities.
+	them in a desired order. The default is RunQueue::MEDIUMPRIORITY. Entries with
+	like numbered priorities are called in the order they were added.
+
+	If this is called by a function invoked from Call(), the new entry
+	is not called until the next time Call() is invoked, regardless
+	of its priority.
 	
 	\param pProc Pointer to a function of type RunQueue::CallbackProc.
 	\param pShutdown Pointer to a function of type RunQueue::CallbackProc that is called when this entry is disposed of
@@ -213,32 +574,87 @@ void BURGER_API Burger::RunQueue::Call(void)
 
 	\return Returns a pointer to the created \ref RunQueueEntry if successful, \ref NULL if out of memory or if the
 	function pointer was \ref NULL.
-	\sa Remove(CallbackProc,void*).
+	\sa Remove(CallbackProc,void*) or AddDelayed(CallbackProc,CallbackProc,void*,Word32,Word)
 	
 ***************************************/
 
 Burger::RunQueue::RunQueueEntry *BURGER_API Burger::RunQueue::Add(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word uPriority)
 {
-	// Assume failure
-	RunQueueEntry *pResult = NULL;
-	if (pProc) {
-		pResult = new (Alloc(sizeof(RunQueueEntry))) RunQueueEntry(pProc,pShutdown,pData,uPriority);
-		if (pResult) {
-			RunQueueEntry *pNext = static_cast<RunQueueEntry *>(m_Entries.GetNext());
-			// No entries? No need to test priorities
-			if (pNext==&m_Entries) {
-				m_Entries.InsertAfter(pResult);	// Link it in
-			} else {
-				// Traverse the linked list until the end is 
-				// reached, or an entry with lower priority shows up
-				RunQueueEntry *pWork;
-				do {
-					pWork = pNext;
-					pNext = static_cast<RunQueueEntry *>(pNext->GetNext());
-				} while ((pNext!=&m_Entries) && (pWork->m_uPriority>uPriority));
-				pNext->InsertBefore(pResult);
-			}
+	RunQueueEntry *pResult = Create(pProc,pShutdown,pData,uPriority);
+	// Out of memory for the priority table?
+	if (pResult && !Activate(pResult)) {
+		pResult->m_pShutdownCallback = NULL;
+		Delete(pResult);
+		pResult = NULL;
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Add a function to be called once after a delay.
+
+	The function is placed in a timer wheel and not called until
+	at least uDelay ticks of Tick::Read() have passed. On that call
+	of Call() it's executed in order of priority with the other entries
+	and then it's disposed of.
+
+	A delay of zero will call the function on the next call to Call().
+	
+	\param pProc Pointer to a function of type RunQueue::CallbackProc.
+	\param pShutdown Pointer to a function of type RunQueue::CallbackProc that is called when this entry is disposed of
+	\param pData Pointer to be passed to the function when called.
+	\param uDelay Number of ticks to wait
+	\param uPriority Priority value to determine order of calling. Higher values get called first.
+
+	\return Returns a pointer to the created \ref RunQueueEntry if successful, \ref NULL if out of memory or if the
+	function pointer was \ref NULL.
+	\sa AddPeriodic(CallbackProc,CallbackProc,void*,Word32,Word) or Remove(RunQueueEntry *)
+	
+***************************************/
+
+Burger::RunQueue::RunQueueEntry *BURGER_API Burger::RunQueue::AddDelayed(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word32 uDelay,Word uPriority)
+{
+	RunQueueEntry *pResult = Create(pProc,pShutdown,pData,uPriority);
+	if (pResult) {
+		pResult->m_uFlags = RunQueueEntry::FLAG_TIMED;
+		Schedule(pResult,Tick::Read()+uDelay);
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Add a function to be called at a regular interval.
+
+	The function is placed in a timer wheel and called every uPeriod
+	ticks of Tick::Read(), starting uPeriod ticks from now. If Call()
+	isn't invoked often enough, missed calls are skipped, not queued.
+
+	The entry is removed if the function returns RunQueue::DISPOSE.
+	
+	\param pProc Pointer to a function of type RunQueue::CallbackProc.
+	\param pShutdown Pointer to a function of type RunQueue::CallbackProc that is called when this entry is disposed of
+	\param pData Pointer to be passed to the function when called.
+	\param uPeriod Number of ticks between calls (Zero is treated as 1)
+	\param uPriority Priority value to determine order of calling. Higher values get called first.
+
+	\return Returns a pointer to the created \ref RunQueueEntry if successful, \ref NULL if out of memory or if the
+	function pointer was \ref NULL.
+	\sa AddDelayed(CallbackProc,CallbackProc,void*,Word32,Word) or Remove(RunQueueEntry *)
+	
+***************************************/
+
+Burger::RunQueue::RunQueueEntry *BURGER_API Burger::RunQueue::AddPeriodic(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word32 uPeriod,Word uPriority)
+{
+	RunQueueEntry *pResult = Create(pProc,pShutdown,pData,uPriority);
+	if (pResult) {
+		if (!uPeriod) {
+			uPeriod = 1;
 		}
+		pResult->m_uFlags = RunQueueEntry::FLAG_TIMED;
+		pResult->m_uPeriod = uPeriod;
+		Schedule(pResult,Tick::Read()+uPeriod);
 	}
 	return pResult;
 }
@@ -247,7 +663,8 @@ Burger::RunQueue::RunQueueEntry *BURGER_API Burger::RunQueue::Add(CallbackProc p
 
 	\brief Return \ref TRUE if a function is in the list.
 
-	Given a function pointer, search the list to see if there is a match.
+	Given a function pointer, search the list and the
+	timer wheel to see if there is a match.
 	If a match is found, return \ref TRUE.
 	
 	\param pProc Pointer to the function.
@@ -258,19 +675,19 @@ Burger::RunQueue::RunQueueEntry *BURGER_API Burger::RunQueue::Add(CallbackProc p
 
 Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Find(CallbackProc pProc) const
 {
-	RunQueueEntry *pResult = NULL;
-	// Get the master handle
-	RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());
-	if (pWork!=&m_Entries) {							// Is it valid?
-		do {
-			if (pWork->m_pCallBack==pProc) {	// Match?
-				pResult = pWork;				// I found it
-				break;
+	Word uList = 0;
+	do {
+		// Get the master handle
+		const DoublyLinkedList *pList = GetList(uList);
+		const DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {						// Is it valid?
+			if (static_cast<const RunQueueEntry *>(pWork)->m_pCallBack==pProc) {	// Match?
+				return const_cast<RunQueueEntry *>(static_cast<const RunQueueEntry *>(pWork));	// I found it
 			}
-			pWork = static_cast<RunQueueEntry *>(pWork->GetNext());			// Follow the list
-		} while (pWork!=&m_Entries);			// Still more?
-	}
-	return pResult;
+			pWork = pWork->GetNext();				// Follow the list
+		}
+	} while (++uList<=WHEELSIZE);
+	return NULL;
 }
 
 /*! ************************************
@@ -278,8 +695,8 @@ Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Find(CallbackProc
 	\brief Return \ref TRUE if a function is in the list.
 
 	Given a function pointer and a pointer to data to pass to the
-	function pointer, search the list to see if there is a match.
-	If a match is found, return \ref TRUE.
+	function pointer, search the list and the timer wheel to see
+	if there is a match. If a match is found, return \ref TRUE.
 		
 	\param pProc Pointer to the function.
 	\param pData Void pointer to pass to the function if called.
@@ -290,33 +707,63 @@ Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Find(CallbackProc
 
 Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Find(CallbackProc pProc,void *pData) const
 {
-	RunQueueEntry *pResult = NULL;
-	// Get the master handle
-	RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());	
-	if (pWork!=&m_Entries) {							// Is it valid?
-		do {
+	Word uList = 0;
+	do {
+		// Get the master handle
+		const DoublyLinkedList *pList = GetList(uList);
+		const DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {						// Is it valid?
+			const RunQueueEntry *pEntry = static_cast<const RunQueueEntry *>(pWork);
 			// Match?
-			if ((pWork->m_pCallBack==pProc) &&
-				(pWork->m_pData==pData)) {
-				pResult = pWork;			// I found it
-				break;
+			if ((pEntry->m_pCallBack==pProc) &&
+				(pEntry->m_pData==pData)) {
+				return const_cast<RunQueueEntry *>(pEntry);	// I found it
 			}
-			pWork = static_cast<RunQueueEntry *>(pWork->GetNext());				// Follow the list
-		} while (pWork!=&m_Entries);				// Still more?
-	}
-	return pResult;
+			pWork = pWork->GetNext();				// Follow the list
+		}
+	} while (++uList<=WHEELSIZE);
+	return NULL;
+}
+
+/*! ************************************
+
+	\brief Find the entry that has used the most time.
+
+	Search all of the entries for the one with the largest
+	total time recorded while SetTiming() was enabled.
+		
+	\return \ref RunQueueEntry pointer to the slowest entry, \ref NULL if no time was recorded.
+	\sa SetTiming(Word), ResetTiming(void) or RunQueueEntry::GetTotalTime(void) const
+
+***************************************/
+
+Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::FindSlowest(void) const
+{
+	const RunQueueEntry *pResult = NULL;
+	Word64 uMaxTime = 0;
+	Word uList = 0;
+	do {
+		const DoublyLinkedList *pList = GetList(uList);
+		const DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {
+			const RunQueueEntry *pEntry = static_cast<const RunQueueEntry *>(pWork);
+			if (pEntry->m_uTotalTime>uMaxTime) {
+				uMaxTime = pEntry->m_uTotalTime;
+				pResult = pEntry;
+			}
+			pWork = pWork->GetNext();
+		}
+	} while (++uList<=WHEELSIZE);
+	return const_cast<RunQueueEntry *>(pResult);
 }
 
 /*! ************************************
 
 	\brief Remove all entries to a function from the list.
 
-	Given a function pointer and a pointer to data to pass to the
-	function pointer, search the list to see if there is a match.
-	If a match is found, remove the entry and return \ref TRUE, saying I found it.
-	
-	\note This function should not be invoked while Call() is executing.
-	It may cause a list traversal error.
+	Given a function pointer, search the list and the timer
+	wheel for matches. Every match is removed and \ref TRUE is
+	returned if any were found.
 	
 	\param pProc Pointer to the function.
 	\return \ref TRUE if the Function/Data pair was found, \ref FALSE if not.
@@ -327,17 +774,21 @@ Burger::RunQueue::RunQueueEntry * BURGER_API Burger::RunQueue::Find(CallbackProc
 Word BURGER_API Burger::RunQueue::RemoveAll(CallbackProc pProc)
 {
 	Word uResult = FALSE;
-	RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());		// Get the master handle
-	if (pWork!=&m_Entries) {							// Is it valid?
-		do {
-			RunQueueEntry *pNext = static_cast<RunQueueEntry *>(pWork->GetNext());		// Get the forward link (For unlinking)
-			if (pWork->m_pCallBack==pProc) {	// Match?
-				Delete(pWork);				// Dispose of the current record
+	Word uList = 0;
+	do {
+		// Get the master handle
+		const DoublyLinkedList *pList = GetList(uList);
+		DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {						// Is it valid?
+			DoublyLinkedList *pNext = pWork->GetNext();	// Get the forward link (For unlinking)
+			RunQueueEntry *pEntry = static_cast<RunQueueEntry *>(pWork);
+			if (pEntry->m_pCallBack==pProc) {	// Match?
+				Delete(pEntry);				// Dispose of the current record
 				uResult = TRUE;				// I deleted it
 			}
 			pWork = pNext;					// Follow the list
-		} while (pWork!=&m_Entries);		// Still more?
-	}
+		}
+	} while (++uList<=WHEELSIZE);
 	return uResult;
 }
 
@@ -346,41 +797,49 @@ Word BURGER_API Burger::RunQueue::RemoveAll(CallbackProc pProc)
 	\brief Remove a function from the list.
 
 	Given a function pointer and a pointer to data to pass to the
-	function pointer, search the list to see if there is a match.
-	If a match is found, remove the entry and return \ref TRUE, saying
-	it's been found.
+	function pointer, search the list and the timer wheel to see
+	if there is a match. If a match is found, remove the entry and
+	return \ref TRUE, saying it's been found.
 	
-	\note Functions can remove themselves from the list at execution time, but
-	you cannot remove a different function during your time quantum since
-	it might break the linked list traversal. If you wish to remove other entries,
-	you must defer this action.
+	\note Functions can remove any entry, including themselves, while
+	Call() is executing.
 	
 	\param pProc Pointer to the function.
 	\param pData Void pointer to pass to the function if called.
 	\return \ref TRUE if the Function/Data pair was found, \ref FALSE if not.
-	\sa Add(CallbackProc,CallbackProc,void*,Word), Clear() or Call().
+	\sa Add(CallbackProc,CallbackProc,void*,Word), Remove(RunQueueEntry *) or Call().
 
 ***************************************/
 
 Word BURGER_API Burger::RunQueue::Remove(CallbackProc pProc,void *pData)
 {
-	Word uResult = FALSE;
-	// Get the master handle
-	RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());		
-	if (pWork!=&m_Entries) {							// Is it valid?
-		do {
-			// Match?
-			if ((pWork->m_pCallBack==pProc) && (pWork->m_pData==pData)) {
-				Delete(pWork);		// Dispose of the current record
-				uResult = TRUE;		// I deleted it
-				break;
-			}
-			// Follow the list
-			pWork = static_cast<RunQueueEntry *>(pWork->GetNext());				
-			// Still more?
-		} while (pWork!=&m_Entries);				
+	RunQueueEntry *pEntry = Find(pProc,pData);
+	if (pEntry) {
+		Delete(pEntry);		// Dispose of the current record
+		return TRUE;		// I deleted it
 	}
-	return uResult;
+	return FALSE;
+}
+
+/*! ************************************
+
+	\brief Remove an entry.
+
+	Dispose of an entry returned by Add(), AddDelayed() or
+	AddPeriodic(). No searching is performed, so this takes the
+	same time no matter how many entries are in the queue. The
+	shutdown function, if any, is called.
+
+	This is the same as calling Delete() on the entry.
+	
+	\param pEntry Pointer to the entry to remove, \ref NULL is ignored
+	\sa Remove(CallbackProc,void*) or Add(CallbackProc,CallbackProc,void*,Word)
+
+***************************************/
+
+void BURGER_API Burger::RunQueue::Remove(RunQueueEntry *pEntry)
+{
+	Delete(pEntry);
 }
 
 /*! ************************************
@@ -398,14 +857,60 @@ Word BURGER_API Burger::RunQueue::Remove(CallbackProc pProc,void *pData)
 
 void BURGER_API Burger::RunQueue::Clear(void)
 {
-	// Get the master handle
-	RunQueueEntry *pWork = static_cast<RunQueueEntry *>(m_Entries.GetNext());	
-	if (pWork!=&m_Entries) {						// Is it valid?
-		do {
+	Word uList = 0;
+	do {
+		// Get the master handle
+		const DoublyLinkedList *pList = GetList(uList);
+		DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {						// Is it valid?
 			// Get the forward link (For unlinking)
-			RunQueueEntry *pNext = static_cast<RunQueueEntry *>(pWork->GetNext());	
-			Delete(pWork);				// Dispose of the current record
+			DoublyLinkedList *pNext = pWork->GetNext();
+			Delete(static_cast<RunQueueEntry *>(pWork));	// Dispose of the current record
 			pWork = pNext;				// Follow the list
-		} while (pWork!=&m_Entries);	// Still more?
-	}
+		}
+	} while (++uList<=WHEELSIZE);
+}
+
+/*! ************************************
+
+	\brief Clear the timing statistics of all entries
+
+	\sa SetTiming(Word) or RunQueueEntry::ResetTiming(void)
+
+***************************************/
+
+void BURGER_API Burger::RunQueue::ResetTiming(void)
+{
+	Word uList = 0;
+	do {
+		const DoublyLinkedList *pList = GetList(uList);
+		DoublyLinkedList *pWork = pList->GetNext();
+		while (pWork!=pList) {
+			static_cast<RunQueueEntry *>(pWork)->ResetTiming();
+			pWork = pWork->GetNext();
+		}
+	} while (++uList<=WHEELSIZE);
 }
+
+/*! ************************************
+
+	\fn void Burger::RunQueue::SetTiming(Word bTiming)
+	\brief Enable or disable timing of the callbacks
+
+	When enabled, Call() reads the microsecond timer before and
+	after every callback and accumulates the time in the entry.
+
+	\param bTiming \ref TRUE to time the callbacks
+	\sa IsTiming(void) const or FindSlowest(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RunQueue::IsTiming(void) const
+	\brief Return \ref TRUE if the callbacks are being timed
+
+	\return \ref TRUE if timing is enabled
+	\sa SetTiming(Word)
+
+***************************************/
@@ -46,37 +46,98 @@ public:
 		PRIORITY_LOW=0x2000000,				///< Low priority for RunQueue tasks
 		PRIORITY_LAST=0						///< Lowest priority for RunQueue tasks, executed last, do not go lower than this value
 	};
+	enum {
+		WHEELSIZE=64		///< Number of slots in the timer wheel (Power of 2)
+	};
 	typedef eReturnCode (BURGER_API *CallbackProc)(void *);
 
 	class RunQueueEntry : protected DoublyLinkedList {
 		friend class RunQueue;
+		enum {
+			FLAG_TIMED=0x01,		///< Entry is delayed or periodic
+			FLAG_WAITING=0x02		///< Entry is in the timer wheel, not the active list
+		};
 		CallbackProc m_pCallBack;	///< Function to call for this entry
 		CallbackProc m_pShutdownCallback;	///< Function to call on deletion
 		void *m_pData;				///< User supplied data pointer to call the function with
+		RunQueue *m_pParent;		///< RunQueue this entry is linked into
 		Word m_uPriority;			///< User supplied priority for inserting a new entry into the list
+		Word m_uFlags;				///< Timer wheel state flags
+		Word32 m_uDueTick;			///< Tick when a timed entry will run next
+		Word32 m_uPeriod;			///< Ticks between calls of a periodic entry, zero for a one shot
+		Word32 m_uAddSerial;		///< Value of RunQueue::m_uSerial when this entry was activated
+		Word32 m_uCallCount;		///< Number of times the function was called
+		Word32 m_uLastTime;			///< Microseconds taken by the last call
+		Word32 m_uMaxTime;			///< Most microseconds taken by a single call
+		Word64 m_uTotalTime;		///< Microseconds taken by all calls
 		RunQueueEntry(CallbackProc pCallBack,CallbackProc pShutdownCallback,void *pData,Word uPriority) :
 			m_pCallBack(pCallBack),
 			m_pShutdownCallback(pShutdownCallback),
 			m_pData(pData),
-			m_uPriority(uPriority) {}
+			m_pParent(NULL),
+			m_uPriority(uPriority),
+			m_uFlags(0),
+			m_uDueTick(0),
+			m_uPeriod(0),
+			m_uAddSerial(0),
+			m_uCallCount(0),
+			m_uLastTime(0),
+			m_uMaxTime(0),
+			m_uTotalTime(0) {}
 	public:
 		~RunQueueEntry();
 		BURGER_INLINE Word GetPriority(void) const { return m_uPriority; }
+		BURGER_INLINE CallbackProc GetCallback(void) const { return m_pCallBack; }
+		BURGER_INLINE void *GetData(void) const { return m_pData; }
+		BURGER_INLINE Word32 GetPeriod(void) const { return m_uPeriod; }
+		BURGER_INLINE Word32 GetDueTick(void) const { return m_uDueTick; }
+		BURGER_INLINE Word32 GetCallCount(void) const { return m_uCallCount; }
+		BURGER_INLINE Word32 GetLastTime(void) const { return m_uLastTime; }
+		BURGER_INLINE Word32 GetMaxTime(void) const { return m_uMaxTime; }
+		BURGER_INLINE Word64 GetTotalTime(void) const { return m_uTotalTime; }
+		void BURGER_API ResetTiming(void);
 	};
 
 private:
+	struct PriorityTail_t {
+		Word m_uPriority;			///< Priority of the entries in this group
+		RunQueueEntry *m_pLast;		///< Last entry in the active list with this priority
+	};
 	DoublyLinkedList m_Entries;	///< Head entry of the linked list
+	DoublyLinkedList m_TimerWheel[WHEELSIZE];	///< Lists of timed entries waiting for their tick
+	PriorityTail_t *m_pTails;	///< Sorted array of the last entry of each priority in m_Entries
+	RunQueueEntry *m_pNextEntry;	///< Next entry Call() will execute
+	RunQueueEntry *m_pCurrentEntry;	///< Entry Call() is executing
+	Word m_uTailCount;			///< Number of valid entries in m_pTails
+	Word m_uTailMax;			///< Number of entries allocated in m_pTails
+	Word32 m_uSerial;			///< Incremented on every call to Call()
+	Word32 m_uLastTick;			///< Last tick the timer wheel was processed for
+	Word m_bTiming;				///< \ref TRUE if callbacks are timed
 	Word m_Recurse;				///< \ref TRUE if this class is the process of executing.
+	RunQueueEntry * BURGER_API Create(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word uPriority);
+	WordPtr BURGER_API FindTail(Word uPriority) const;
+	Word BURGER_API Activate(RunQueueEntry *pEntry);
+	void BURGER_API Schedule(RunQueueEntry *pEntry,Word32 uDueTick);
+	void BURGER_API Unlink(RunQueueEntry *pEntry);
+	void BURGER_API ProcessTimers(Word32 uTick);
+	BURGER_INLINE const DoublyLinkedList *GetList(Word uIndex) const { return uIndex ? &m_TimerWheel[uIndex-1] : &m_Entries; }
 public:
-	RunQueue() : m_Entries(), m_Recurse(FALSE) {}
+	RunQueue();
 	~RunQueue();
 	void BURGER_API Call(void);
 	RunQueueEntry * BURGER_API Add(CallbackProc pProc,CallbackProc pShutdown=NULL,void *pData=NULL,Word uPriority=PRIORITY_MEDIUM);
+	RunQueueEntry * BURGER_API AddDelayed(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word32 uDelay,Word uPriority=PRIORITY_MEDIUM);
+	RunQueueEntry * BURGER_API AddPeriodic(CallbackProc pProc,CallbackProc pShutdown,void *pData,Word32 uPeriod,Word uPriority=PRIORITY_MEDIUM);
 	RunQueueEntry * BURGER_API Find(CallbackProc pProc) const;
 	RunQueueEntry * BURGER_API Find(CallbackProc pProc,void *pData) const;
+	RunQueueEntry * BURGER_API FindSlowest(void) const;
 	Word BURGER_API RemoveAll(CallbackProc pProc);
 	Word BURGER_API Remove(CallbackProc pProc,void *pData=NULL);
+	void BURGER_API Remove(RunQueueEntry *pEntry);
 	void BURGER_API Clear(void);
+	void BURGER_API ResetTiming(void);
+	BURGER_INLINE void SetTiming(Word bTiming) { m_bTiming = bTiming; }
+	BURGER_INLINE Word IsTiming(void) const { return m_bTiming; }
 };
 }
 /* END */
@@ -12,7 +12,7 @@
 ***************************************/
 
 #include "brtick.h"
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS))
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX))
 #include <time.h>
 #endif
 
@@ -50,7 +50,7 @@ Word32 Burger::Tick::s_LastTick;
 
 ***************************************/
 
-#if !(defined(BURGER_MSDOS) || defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_BEOS) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_MSDOS) || defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_BEOS) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 Word32 BURGER_API Burger::Tick::Read(void)
 {
@@ -204,7 +204,7 @@ Word BURGER_API Burger::Tick::WaitEvent(Word uCount)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
 {
@@ -237,7 +237,7 @@ Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MAC) || defined(BURGER_DS) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 Word32 BURGER_API Burger::Tick::ReadMilliseconds(void)
 {
@@ -333,7 +333,7 @@ Burger::FloatTimer::FloatTimer() :
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::FloatTimer::SetBase(void)
 {
 	// Generic version
@@ -355,10 +355,10 @@ void BURGER_API Burger::FloatTimer::Reset(void)
 {
 	SetBase();		// Set the platform specific time values
 	m_fElapsedTime = 0.0f;
-#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
 	m_uElapsedTime = 0;		// Clear the high precision value
 #endif
-#if defined(BURGER_ANDROID)
+#if defined(BURGER_ANDROID) || defined(BURGER_LINUX)
 	m_uElapsedTimeNano = 0;
 #endif
 }
@@ -375,7 +375,7 @@ void BURGER_API Burger::FloatTimer::Reset(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 float BURGER_API Burger::FloatTimer::GetTime(void)
 {
 	float fResult;
@@ -464,7 +464,7 @@ void BURGER_API Burger::FloatTimer::Unpause(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_SHIELD) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_SHIELD) || defined(BURGER_VITA) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 void BURGER_API Burger::Sleep(Word32 /* uMilliseconds */)
 {
 }
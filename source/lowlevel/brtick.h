@@ -38,15 +38,15 @@ class FloatTimer {
 #if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	double m_dReciprocalFrequency;	///< 1.0 / CPU timebase
 #endif
-#if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_ANDROID)) || defined(DOXYGEN)
+#if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_ANDROID) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	Word64 m_uBaseTime;			///< Integer time mark of the last read time in high precision
 	Word64 m_uElapsedTime;		///< Integer time mark of the elapsed time in high precision
-#if defined(BURGER_ANDROID) || defined(DOXYGEN)
+#if defined(BURGER_ANDROID) || defined(BURGER_LINUX) || defined(DOXYGEN)
 	Word64 m_uBaseTimeNano;		///< Nanosecond time for time mark
 	Word64 m_uElapsedTimeNano;	///< Nanosecond time for elapsed time
 #endif
 #endif
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_ANDROID)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_ANDROID) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	Word32 m_uBaseTime;			///< Microsecond mark of the last read time
 #endif
 	float m_fElapsedTime;		///< Last read time
@@ -18,7 +18,7 @@
 #include <nitro/rtc/ARM9/api.h>
 #endif
 
-#if !(defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_PS4) || defined(BURGER_SHIELD)) && !defined(DOXYGEN)
+#if !(defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_PS4) || defined(BURGER_SHIELD) || defined(BURGER_LINUX)) && !defined(DOXYGEN)
 #if !(defined(BURGER_MSVC) && _MSC_VER>=1900)		// Visual studio 2015 or higher has timespec defined
 struct timespec {
 	time_t tv_sec;	// seconds
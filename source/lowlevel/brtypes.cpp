@@ -78,6 +78,7 @@
 #define BURGER_ANDROID
 #define BURGER_SHIELD
 #define BURGER_OUYA
+#define BURGER_LINUX
 #define BURGER_BEOS
 
 //#define TRUE 1
@@ -473,6 +474,7 @@
 	\li \ref BURGER_ANDROID The underlying OS is Android
 	\li \ref BURGER_SHIELD
 	\li \ref BURGER_OUYA
+	\li \ref BURGER_LINUX Desktop Linux using GNU C
 	\li \ref BURGER_BEOS has been deprecated.
 	\li BURGER_APPLEIIGS has been removed.
 	\li BURGER_3DO has been removed.
@@ -1478,6 +1480,20 @@
 ***************************************/
 
 
+/*! ************************************
+
+	\def BURGER_LINUX
+	\brief Define to determine if code is being built for Linux.
+	
+	If this define exists, then you are creating code that runs on
+	desktop Linux using the GNU C compiler and the POSIX and Linux
+	kernel APIs. The CPU can be either \ref BURGER_X86, \ref BURGER_AMD64,
+	\ref BURGER_ARM or \ref BURGER_ARM64.
+	
+	\sa BURGER_ANDROID, BURGER_GNUC, BURGER_AMD64 or BURGER_MACOSX
+	
+***************************************/
+
 /*! ************************************
 
 	\def BURGER_BEOS
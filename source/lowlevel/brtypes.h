@@ -363,6 +363,51 @@
 #error Unknown CPU
 #endif
 
+// GNUC or Clang for Linux on Intel or ARM
+#elif defined(__GNUC__) && defined(__linux__)
+#define BURGER_GNUC
+#define BURGER_LINUX
+#define BURGER_ALIGN(x,s) (x) __attribute__((aligned(s)))
+#define BURGER_PREALIGN(s)
+#define BURGER_POSTALIGN(s) __attribute__((aligned(s)))
+#define BURGER_STRUCT_ALIGN
+#define BURGER_INLINE __inline__ __attribute__((always_inline))
+#define BURGER_HASWCHAR_T
+
+#if defined(__LP64__)
+#define BURGER_LONGLONG long
+#define BURGER_LONGIS64BIT
+#endif
+
+#if defined(__i386__)
+#define BURGER_X86
+#define BURGER_LITTLEENDIAN
+#define BURGER_DECLSPECNAKED int int not supported
+
+#elif defined(__x86_64__)
+#define BURGER_AMD64
+#define BURGER_LITTLEENDIAN
+#define BURGER_64BITCPU
+#define BURGER_DECLSPECNAKED int int not supported
+
+#elif defined(__arm__)
+#define BURGER_ARM
+#define BURGER_LITTLEENDIAN
+
+#if defined(__ARM_NEON__)
+#define BURGER_NEON
+#endif
+
+#elif defined(__aarch64__)
+#define BURGER_ARM64
+#define BURGER_LITTLEENDIAN
+#define BURGER_64BITCPU
+#define BURGER_NEON
+
+#else
+#error Unknown Linux CPU
+#endif
+
 // Visual Studio for Win32
 #elif defined(_MSC_VER) && defined(_M_IX86)
 
@@ -677,7 +722,13 @@ typedef __m128 Vector_128;
 #endif
 typedef __m128 Vector_128;
 
-#elif defined(BURGER_ANDROID)
+#elif defined(BURGER_LINUX) && defined(BURGER_INTELARCHITECTURE)
+#ifndef _EMMINTRIN_H_INCLUDED
+#include <emmintrin.h>
+#endif
+typedef __m128 Vector_128;
+
+#elif defined(BURGER_ANDROID) || (defined(BURGER_LINUX) && defined(BURGER_NEON))
 #ifndef __ARM_NEON_H
 #include <arm_neon.h>
 #endif
@@ -0,0 +1,497 @@
+/***************************************
+
+	Frustum and bounding volume culling
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfrustum.h"
+#include "brfloatingpoint.h"
+
+//
+// SSE versions for Intel/AMD processors. They are compiled
+// with the instruction set enabled on a per function basis and
+// only called if CPUID reports the feature
+//
+
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define FRUSTUM_SIMD
+#include "bratomic.h"
+#include <xmmintrin.h>
+
+#if defined(BURGER_MSVC)
+#define FRUSTUM_TARGET(x)
+#else
+#define FRUSTUM_TARGET(x) __attribute__((target(x)))
+#endif
+
+//
+// Planes with each component copied to all 4 lanes
+//
+
+struct FrustumSSE_t {
+	__m128 m_vNormalX[Burger::Frustum_t::PLANE_COUNT];
+	__m128 m_vNormalY[Burger::Frustum_t::PLANE_COUNT];
+	__m128 m_vNormalZ[Burger::Frustum_t::PLANE_COUNT];
+	__m128 m_vDistance[Burger::Frustum_t::PLANE_COUNT];
+};
+
+FRUSTUM_TARGET("sse") static void LoadPlanesSSE(FrustumSSE_t *pOutput,const Burger::Vector4D_t *pPlanes,Word bAbsolute)
+{
+	Word i = 0;
+	do {
+		if (bAbsolute) {
+			pOutput->m_vNormalX[i] = _mm_set1_ps(Burger::Abs(pPlanes[i].x));
+			pOutput->m_vNormalY[i] = _mm_set1_ps(Burger::Abs(pPlanes[i].y));
+			pOutput->m_vNormalZ[i] = _mm_set1_ps(Burger::Abs(pPlanes[i].z));
+		} else {
+			pOutput->m_vNormalX[i] = _mm_set1_ps(pPlanes[i].x);
+			pOutput->m_vNormalY[i] = _mm_set1_ps(pPlanes[i].y);
+			pOutput->m_vNormalZ[i] = _mm_set1_ps(pPlanes[i].z);
+		}
+		pOutput->m_vDistance[i] = _mm_set1_ps(pPlanes[i].w);
+	} while (++i<Burger::Frustum_t::PLANE_COUNT);
+}
+
+//
+// Return a 4 bit mask of the lanes where the distance
+// of X,Y,Z to every plane is at least -vRadius
+//
+
+FRUSTUM_TARGET("sse") static BURGER_INLINE Word TestLanesSSE(const FrustumSSE_t *pPlanes,const FrustumSSE_t *pAbsolute,__m128 vX,__m128 vY,__m128 vZ,__m128 vExtentX,__m128 vExtentY,__m128 vExtentZ,__m128 vRadius)
+{
+	__m128 vVisible = _mm_cmpeq_ps(vX,vX);
+	Word i = 0;
+	do {
+		__m128 vDistance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pPlanes->m_vNormalX[i],vX),_mm_mul_ps(pPlanes->m_vNormalY[i],vY)),
+			_mm_mul_ps(pPlanes->m_vNormalZ[i],vZ)),pPlanes->m_vDistance[i]);
+		__m128 vNegative = vRadius;
+		if (pAbsolute) {
+			// Project the box extents onto the plane normal
+			vNegative = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pAbsolute->m_vNormalX[i],vExtentX),_mm_mul_ps(pAbsolute->m_vNormalY[i],vExtentY)),
+				_mm_mul_ps(pAbsolute->m_vNormalZ[i],vExtentZ));
+		}
+		vNegative = _mm_sub_ps(_mm_setzero_ps(),vNegative);
+		vVisible = _mm_and_ps(vVisible,_mm_cmpge_ps(vDistance,vNegative));
+	} while (++i<Burger::Frustum_t::PLANE_COUNT);
+	return static_cast<Word>(_mm_movemask_ps(vVisible));
+}
+
+//
+// Test 4 spheres at a time, return the number of spheres tested
+//
+
+FRUSTUM_TARGET("sse") static WordPtr TestSpheresSSE(const Burger::Vector4D_t *pPlanes,Word32 *pVisible,const Burger::BoundingSphere_t *pInput,WordPtr uCount,WordPtr *pVisibleCount)
+{
+	WordPtr uBlocks = uCount>>2U;
+	if (uBlocks) {
+		FrustumSSE_t Planes;
+		LoadPlanesSSE(&Planes,pPlanes,FALSE);
+		WordPtr uVisibleCount = 0;
+		Word32 uBits = 0;
+		Word uShift = 0;
+		__m128 vZero = _mm_setzero_ps();
+		do {
+			// Center and radius are 4 floats, transpose them into lanes
+			__m128 vX = _mm_loadu_ps(&pInput[0].m_Center.x);
+			__m128 vY = _mm_loadu_ps(&pInput[1].m_Center.x);
+			__m128 vZ = _mm_loadu_ps(&pInput[2].m_Center.x);
+			__m128 vRadius = _mm_loadu_ps(&pInput[3].m_Center.x);
+			_MM_TRANSPOSE4_PS(vX,vY,vZ,vRadius);
+			Word uMask = TestLanesSSE(&Planes,NULL,vX,vY,vZ,vZero,vZero,vZero,vRadius);
+			uVisibleCount += ((uMask&1U)+((uMask>>1U)&1U))+(((uMask>>2U)&1U)+(uMask>>3U));
+			uBits |= static_cast<Word32>(uMask)<<uShift;
+			uShift += 4;
+			if (uShift==32) {
+				pVisible[0] = uBits;
+				++pVisible;
+				uBits = 0;
+				uShift = 0;
+			}
+			pInput += 4;
+		} while (--uBlocks);
+		// Write out the partial mask, the scalar code will finish it
+		if (uShift) {
+			pVisible[0] = uBits;
+		}
+		pVisibleCount[0] = uVisibleCount;
+	}
+	return uCount&(~static_cast<WordPtr>(3U));
+}
+
+//
+// Test 4 boxes at a time, return the number of boxes tested
+//
+
+FRUSTUM_TARGET("sse") static WordPtr TestBoxesSSE(const Burger::Vector4D_t *pPlanes,Word32 *pVisible,const Burger::BoundingBox_t *pInput,WordPtr uCount,WordPtr *pVisibleCount)
+{
+	WordPtr uBlocks = uCount>>2U;
+	if (uBlocks) {
+		FrustumSSE_t Planes;
+		FrustumSSE_t Absolute;
+		LoadPlanesSSE(&Planes,pPlanes,FALSE);
+		LoadPlanesSSE(&Absolute,pPlanes,TRUE);
+		WordPtr uVisibleCount = 0;
+		Word32 uBits = 0;
+		Word uShift = 0;
+		__m128 vHalf = _mm_set1_ps(0.5f);
+		do {
+			__m128 vCenter[4];
+			__m128 vExtent[4];
+			Word i = 0;
+			do {
+				// Load min.x,min.y,min.z,max.x and min.z,max.x,max.y,max.z
+				// so nothing past the end of the box is read
+				__m128 vMin = _mm_loadu_ps(&pInput[i].m_Min.x);
+				__m128 vMax = _mm_loadu_ps(&pInput[i].m_Min.z);
+				vMax = _mm_shuffle_ps(vMax,vMax,_MM_SHUFFLE(3,3,2,1));
+				vCenter[i] = _mm_mul_ps(_mm_add_ps(vMin,vMax),vHalf);
+				vExtent[i] = _mm_mul_ps(_mm_sub_ps(vMax,vMin),vHalf);
+			} while (++i<4);
+			_MM_TRANSPOSE4_PS(vCenter[0],vCenter[1],vCenter[2],vCenter[3]);
+			_MM_TRANSPOSE4_PS(vExtent[0],vExtent[1],vExtent[2],vExtent[3]);
+			Word uMask = TestLanesSSE(&Planes,&Absolute,vCenter[0],vCenter[1],vCenter[2],vExtent[0],vExtent[1],vExtent[2],vHalf);
+			uVisibleCount += ((uMask&1U)+((uMask>>1U)&1U))+(((uMask>>2U)&1U)+(uMask>>3U));
+			uBits |= static_cast<Word32>(uMask)<<uShift;
+			uShift += 4;
+			if (uShift==32) {
+				pVisible[0] = uBits;
+				++pVisible;
+				uBits = 0;
+				uShift = 0;
+			}
+			pInput += 4;
+		} while (--uBlocks);
+		if (uShift) {
+			pVisible[0] = uBits;
+		}
+		pVisibleCount[0] = uVisibleCount;
+	}
+	return uCount&(~static_cast<WordPtr>(3U));
+}
+#endif
+
+/*! ************************************
+
+	\struct Burger::BoundingSphere_t
+	\brief Sphere used for visibility tests
+
+	The layout is 4 floats so an array of spheres can be
+	loaded directly into SIMD registers.
+
+	\sa Frustum_t or BoundingBox_t
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::BoundingBox_t
+	\brief Axis aligned box used for visibility tests
+
+	\sa Frustum_t or BoundingSphere_t
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::Frustum_t
+	\brief Six planes that bound a view volume
+
+	The planes are extracted from a projection or a combined
+	view and projection matrix. The normals face into the
+	frustum, so a point is inside a plane if the dot product
+	of the point and the normal plus the plane's w is
+	greater than or equal to zero.
+
+	Bounding volumes are tested one at a time, or in arrays
+	with the results stored as a bit mask. On Intel/AMD CPUs
+	the arrays are tested 4 entries at a time with SSE.
+
+	The tests are conservative, a volume that is outside of the
+	frustum but straddles the extension of two planes near a corner
+	will be reported as visible.
+
+	\note Since this is a structure, there is no
+	constructor or destructor, so assume the data
+	is uninitialized when creating this data type.
+
+	\sa BoundingSphere_t, BoundingBox_t or Matrix4D_t
+
+***************************************/
+
+/*! ************************************
+
+	\brief Extract the planes from a matrix
+
+	Extract the frustum planes from a matrix that is used
+	with Matrix4D_t::Transform(Vector4D_t *,const Vector4D_t *) const,
+	where each row creates a clip space coordinate. Clip space is
+	assumed to be -w to w for x, y and z.
+
+	If the matrix is a projection matrix, the planes are in view
+	space. If it's a combined view and projection matrix, the planes
+	are in world space.
+
+	The planes are normalized.
+
+	\param pInput Pointer to a matrix
+	\sa TransposeSet(const Matrix4D_t *) or Normalize(void)
+
+***************************************/
+
+void BURGER_API Burger::Frustum_t::Set(const Matrix4D_t *pInput)
+{
+	const Vector4D_t *pW = &pInput->w;
+	const Vector4D_t *pRow = &pInput->x;
+	Word i = 0;
+	do {
+		// w+row and w-row
+		Vector4D_t *pPlane = &m_Planes[i*2];
+		pPlane[0].x = pW->x+pRow->x;
+		pPlane[0].y = pW->y+pRow->y;
+		pPlane[0].z = pW->z+pRow->z;
+		pPlane[0].w = pW->w+pRow->w;
+		pPlane[1].x = pW->x-pRow->x;
+		pPlane[1].y = pW->y-pRow->y;
+		pPlane[1].z = pW->z-pRow->z;
+		pPlane[1].w = pW->w-pRow->w;
+		++pRow;
+	} while (++i<3);
+	Normalize();
+}
+
+/*! ************************************
+
+	\brief Extract the planes from a transposed matrix
+
+	Extract the frustum planes from a matrix that is used
+	with Matrix4D_t::TransposeTransform(Vector4D_t *,const Vector4D_t *) const,
+	such as one created with Matrix4D_t::SetFrustum() or
+	Matrix4D_t::SetPerspective() for OpenGL.
+
+	The planes are normalized.
+
+	\param pInput Pointer to a matrix
+	\sa Set(const Matrix4D_t *) or Normalize(void)
+
+***************************************/
+
+void BURGER_API Burger::Frustum_t::TransposeSet(const Matrix4D_t *pInput)
+{
+	Matrix4D_t Transposed;
+	Transposed.Transpose(pInput);
+	Set(&Transposed);
+}
+
+/*! ************************************
+
+	\brief Normalize the planes
+
+	Scale each plane so the normal is unit length. This is required
+	for the sphere tests since the radius is compared against the
+	distance to the plane.
+
+	\sa Set(const Matrix4D_t *)
+
+***************************************/
+
+void BURGER_API Burger::Frustum_t::Normalize(void)
+{
+	Vector4D_t *pPlane = m_Planes;
+	Word i = PLANE_COUNT;
+	do {
+		float fLength = Sqrt((pPlane->x*pPlane->x)+(pPlane->y*pPlane->y)+(pPlane->z*pPlane->z));
+		if (fLength!=0.0f) {
+			fLength = 1.0f/fLength;
+			pPlane->x *= fLength;
+			pPlane->y *= fLength;
+			pPlane->z *= fLength;
+			pPlane->w *= fLength;
+		}
+		++pPlane;
+	} while (--i);
+}
+
+/*! ************************************
+
+	\brief Test if a point is inside the frustum
+
+	\param pInput Pointer to the point to test
+	\return \ref TRUE if the point is inside or on the frustum, \ref FALSE if not
+	\sa TestSphere(const BoundingSphere_t *) const
+
+***************************************/
+
+Word BURGER_API Burger::Frustum_t::TestPoint(const Vector3D_t *pInput) const
+{
+	const Vector4D_t *pPlane = m_Planes;
+	Word i = PLANE_COUNT;
+	do {
+		if ((((pPlane->x*pInput->x)+(pPlane->y*pInput->y))+(pPlane->z*pInput->z))+pPlane->w<0.0f) {
+			return FALSE;
+		}
+		++pPlane;
+	} while (--i);
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Test if a sphere is visible
+
+	\param pInput Pointer to the sphere to test
+	\return \ref TRUE if any part of the sphere may be in the frustum, \ref FALSE if it's not visible
+	\sa TestSpheres(Word32 *,const BoundingSphere_t *,WordPtr) const or TestBox(const BoundingBox_t *) const
+
+***************************************/
+
+Word BURGER_API Burger::Frustum_t::TestSphere(const BoundingSphere_t *pInput) const
+{
+	float fNegativeRadius = -pInput->m_fRadius;
+	const Vector4D_t *pPlane = m_Planes;
+	Word i = PLANE_COUNT;
+	do {
+		float fDistance = (((pPlane->x*pInput->m_Center.x)+(pPlane->y*pInput->m_Center.y))+(pPlane->z*pInput->m_Center.z))+pPlane->w;
+		if (!(fDistance>=fNegativeRadius)) {
+			return FALSE;
+		}
+		++pPlane;
+	} while (--i);
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Test if an axis aligned box is visible
+
+	The box is converted to a center and extents, and the
+	extents are projected onto each plane normal.
+
+	\param pInput Pointer to the box to test
+	\return \ref TRUE if any part of the box may be in the frustum, \ref FALSE if it's not visible
+	\sa TestBoxes(Word32 *,const BoundingBox_t *,WordPtr) const or TestSphere(const BoundingSphere_t *) const
+
+***************************************/
+
+Word BURGER_API Burger::Frustum_t::TestBox(const BoundingBox_t *pInput) const
+{
+	float fCenterX = (pInput->m_Min.x+pInput->m_Max.x)*0.5f;
+	float fCenterY = (pInput->m_Min.y+pInput->m_Max.y)*0.5f;
+	float fCenterZ = (pInput->m_Min.z+pInput->m_Max.z)*0.5f;
+	float fExtentX = (pInput->m_Max.x-pInput->m_Min.x)*0.5f;
+	float fExtentY = (pInput->m_Max.y-pInput->m_Min.y)*0.5f;
+	float fExtentZ = (pInput->m_Max.z-pInput->m_Min.z)*0.5f;
+	const Vector4D_t *pPlane = m_Planes;
+	Word i = PLANE_COUNT;
+	do {
+		float fDistance = (((pPlane->x*fCenterX)+(pPlane->y*fCenterY))+(pPlane->z*fCenterZ))+pPlane->w;
+		float fRadius = ((Abs(pPlane->x)*fExtentX)+(Abs(pPlane->y)*fExtentY))+(Abs(pPlane->z)*fExtentZ);
+		if (!(fDistance>=-fRadius)) {
+			return FALSE;
+		}
+		++pPlane;
+	} while (--i);
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Test an array of spheres for visibility
+
+	Test every sphere and set a bit in pVisible for each one that
+	may be visible. Bit 0 of pVisible[0] is the result for the
+	first sphere, bit 31 of pVisible[0] is the result for the
+	32nd sphere, bit 0 of pVisible[1] is for the 33rd and so on.
+	Unused bits in the last entry are cleared.
+
+	\param pVisible Pointer to an array of (uCount+31)/32 entries to receive the bit mask
+	\param pInput Pointer to an array of spheres
+	\param uCount Number of spheres to test
+	\return Number of visible spheres
+	\sa TestSphere(const BoundingSphere_t *) const or TestBoxes(Word32 *,const BoundingBox_t *,WordPtr) const
+
+***************************************/
+
+WordPtr BURGER_API Burger::Frustum_t::TestSpheres(Word32 *pVisible,const BoundingSphere_t *pInput,WordPtr uCount) const
+{
+	WordPtr uVisibleCount = 0;
+	WordPtr uIndex = 0;
+#if defined(FRUSTUM_SIMD)
+	if ((uCount>=4) && GetCPUID()->HasSSE()) {
+		uIndex = TestSpheresSSE(m_Planes,pVisible,pInput,uCount,&uVisibleCount);
+	}
+#endif
+	// Test the remaining spheres one at a time
+	if (uIndex<uCount) {
+		Word32 *pWork = pVisible+(uIndex>>5U);
+		// Keep the bits set by the SIMD code
+		Word32 uBits = (uIndex&31U) ? pWork[0] : 0;
+		do {
+			if (TestSphere(&pInput[uIndex])) {
+				uBits |= 1U<<(uIndex&31U);
+				++uVisibleCount;
+			}
+			if ((uIndex&31U)==31U) {
+				pWork[0] = uBits;
+				++pWork;
+				uBits = 0;
+			}
+		} while (++uIndex<uCount);
+		if (uCount&31U) {
+			pWork[0] = uBits;
+		}
+	}
+	return uVisibleCount;
+}
+
+/*! ************************************
+
+	\brief Test an array of axis aligned boxes for visibility
+
+	Test every box and set a bit in pVisible for each one that
+	may be visible. The bit mask has the same layout as the
+	one from TestSpheres(Word32 *,const BoundingSphere_t *,WordPtr) const.
+
+	\param pVisible Pointer to an array of (uCount+31)/32 entries to receive the bit mask
+	\param pInput Pointer to an array of boxes
+	\param uCount Number of boxes to test
+	\return Number of visible boxes
+	\sa TestBox(const BoundingBox_t *) const or TestSpheres(Word32 *,const BoundingSphere_t *,WordPtr) const
+
+***************************************/
+
+WordPtr BURGER_API Burger::Frustum_t::TestBoxes(Word32 *pVisible,const BoundingBox_t *pInput,WordPtr uCount) const
+{
+	WordPtr uVisibleCount = 0;
+	WordPtr uIndex = 0;
+#if defined(FRUSTUM_SIMD)
+	if ((uCount>=4) && GetCPUID()->HasSSE()) {
+		uIndex = TestBoxesSSE(m_Planes,pVisible,pInput,uCount,&uVisibleCount);
+	}
+#endif
+	if (uIndex<uCount) {
+		Word32 *pWork = pVisible+(uIndex>>5U);
+		Word32 uBits = (uIndex&31U) ? pWork[0] : 0;
+		do {
+			if (TestBox(&pInput[uIndex])) {
+				uBits |= 1U<<(uIndex&31U);
+				++uVisibleCount;
+			}
+			if ((uIndex&31U)==31U) {
+				pWork[0] = uBits;
+				++pWork;
+				uBits = 0;
+			}
+		} while (++uIndex<uCount);
+		if (uCount&31U) {
+			pWork[0] = uBits;
+		}
+	}
+	return uVisibleCount;
+}
@@ -0,0 +1,68 @@
+/***************************************
+
+	Frustum and bounding volume culling
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRFRUSTUM_H__
+#define __BRFRUSTUM_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRVECTOR3D_H__
+#include "brvector3d.h"
+#endif
+
+#ifndef __BRVECTOR4D_H__
+#include "brvector4d.h"
+#endif
+
+#ifndef __BRMATRIX4D_H__
+#include "brmatrix4d.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct BoundingSphere_t {
+	Vector3D_t m_Center;	///< Center of the sphere
+	float m_fRadius;		///< Radius of the sphere
+};
+
+struct BoundingBox_t {
+	Vector3D_t m_Min;		///< Smallest x, y and z coordinates of the box
+	Vector3D_t m_Max;		///< Largest x, y and z coordinates of the box
+};
+
+struct Frustum_t {
+	enum ePlane {
+		PLANE_LEFT,			///< Index of the left plane
+		PLANE_RIGHT,		///< Index of the right plane
+		PLANE_BOTTOM,		///< Index of the bottom plane
+		PLANE_TOP,			///< Index of the top plane
+		PLANE_NEAR,			///< Index of the near plane
+		PLANE_FAR,			///< Index of the far plane
+		PLANE_COUNT			///< Number of planes in a frustum
+	};
+	Vector4D_t m_Planes[PLANE_COUNT];	///< Normalized planes facing into the frustum, x,y,z is the normal, w is the distance
+	void BURGER_API Set(const Matrix4D_t *pInput);
+	void BURGER_API TransposeSet(const Matrix4D_t *pInput);
+	void BURGER_API Normalize(void);
+	Word BURGER_API TestPoint(const Vector3D_t *pInput) const;
+	Word BURGER_API TestSphere(const BoundingSphere_t *pInput) const;
+	Word BURGER_API TestBox(const BoundingBox_t *pInput) const;
+	WordPtr BURGER_API TestSpheres(Word32 *pVisible,const BoundingSphere_t *pInput,WordPtr uCount) const;
+	WordPtr BURGER_API TestBoxes(Word32 *pVisible,const BoundingBox_t *pInput,WordPtr uCount) const;
+};
+}
+/* END */
+
+#endif
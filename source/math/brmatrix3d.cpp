@@ -2683,6 +2683,79 @@ BURGER_DECLSPECNAKED void BURGER_API Burger::Matrix3D_t::TransformAdd(Vector3D_t
 #endif
 
 
+/*! ************************************
+
+	\brief Transform an array of vectors by a matrix
+
+	Transform each vector by the matrix, identical to calling
+	Transform(Vector3D_t *,const Vector3D_t *) const on every
+	entry. The work is done by Matrix4D_t::Transform3x3(Vector3D_t *,const Vector3D_t *,WordPtr) const
+	which uses SSE on Intel/AMD CPUs.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\param pOutput Pointer to an array of uninitialized Vector3D_t to store the results
+	\param pInput Pointer to an array of Vector3D_t to transform against this matrix
+	\param uCount Number of entries in the arrays
+	\sa Transform(Vector3D_t *,const Vector3D_t *) const or TransformAdd(Vector3D_t *,const Vector3D_t *,const Vector3D_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix3D_t::Transform(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const
+{
+	Matrix4D_t Temp;
+	Temp.Set(this);
+	Temp.Transform3x3(pOutput,pInput,uCount);
+}
+
+/*! ************************************
+
+	\brief Transform an array of vectors stored as separate arrays
+
+	\param pOutput Pointer to the Vector3DSoA_t to store the results
+	\param pInput Pointer to the Vector3DSoA_t to transform against this matrix
+	\param uCount Number of entries in each array
+	\sa Transform(Vector3D_t *,const Vector3D_t *,WordPtr) const or Vector3DSoA_t
+
+***************************************/
+
+void BURGER_API Burger::Matrix3D_t::Transform(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const
+{
+	Matrix4D_t Temp;
+	Temp.Set(this);
+	Temp.Transform3x3(pOutput,pInput,uCount);
+}
+
+/*! ************************************
+
+	\brief Transform an array of vectors and then add a point
+
+	Transform each vector by the matrix and add pTranslate, identical
+	to calling TransformAdd(Vector3D_t *,const Vector3D_t *,const Vector3D_t *) const
+	on every entry.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\param pOutput Pointer to an array of uninitialized Vector3D_t to store the results
+	\param pInput Pointer to an array of Vector3D_t to transform against this matrix
+	\param pTranslate Pointer to a Vector3D_t to add to every transformed vector
+	\param uCount Number of entries in the arrays
+	\sa TransformAdd(Vector3D_t *,const Vector3D_t *,const Vector3D_t *) const or Transform(Vector3D_t *,const Vector3D_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix3D_t::TransformAdd(Vector3D_t *pOutput,const Vector3D_t *pInput,const Vector3D_t *pTranslate,WordPtr uCount) const
+{
+	Matrix4D_t Temp;
+	Temp.Set(this);
+	Temp.x.w = pTranslate->x;
+	Temp.y.w = pTranslate->y;
+	Temp.z.w = pTranslate->z;
+	Temp.Transform(pOutput,pInput,uCount);
+}
+
 /*! ************************************
 
 	\brief Multiply a vector by a transposed matrix
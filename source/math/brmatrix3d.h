@@ -97,6 +97,9 @@ struct Matrix3D_t {
 	void BURGER_API Transform(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
 	void BURGER_API TransformAdd(Vector3D_t *pInput,const Vector3D_t *pTranslate) const;
 	void BURGER_API TransformAdd(Vector3D_t *pOutput,const Vector3D_t *pInput,const Vector3D_t *pTranslate) const;
+	void BURGER_API Transform(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const;
+	void BURGER_API Transform(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const;
+	void BURGER_API TransformAdd(Vector3D_t *pOutput,const Vector3D_t *pInput,const Vector3D_t *pTranslate,WordPtr uCount) const;
 	void BURGER_API TransposeTransform(Vector3D_t *pInput) const;
 	void BURGER_API TransposeTransform(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
 	void BURGER_API TransposeTransformAdd(Vector3D_t *pInput,const Vector3D_t *pTranslate) const;
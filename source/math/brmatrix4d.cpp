@@ -14,6 +14,24 @@
 #include "brmatrix4d.h"
 #include "brfixedmatrix4d.h"
 
+#if defined(BURGER_INTELARCHITECTURE) && (defined(BURGER_MSVC) || defined(BURGER_GNUC) || defined(BURGER_LLVM))
+#define MATRIX4D_SIMD
+#include "bratomic.h"
+#include <xmmintrin.h>
+
+#if defined(BURGER_MSVC)
+#define MATRIX4D_TARGET(x)
+#if (_MSC_VER>=1700)
+#define MATRIX4D_AVXSUPPORT
+#include <immintrin.h>
+#endif
+#else
+#define MATRIX4D_TARGET(x) __attribute__((target(x)))
+#define MATRIX4D_AVXSUPPORT
+#include <immintrin.h>
+#endif
+#endif
+
 /*! ************************************
 
 	\struct Burger::Matrix4D_t
@@ -2868,6 +2886,173 @@ void BURGER_API Burger::Matrix4D_t::SetWColumn(const Vector4D_t *pInput)
 	w.w = pInput->w;
 }
 
+//
+// SSE and AVX matrix multiply and inverse. All of the input is
+// loaded before the output is written, so the output can be
+// one of the inputs
+//
+
+#if defined(MATRIX4D_SIMD)
+
+// Combine the rows of pInput1 using the 4 entries of a row of pInput2
+MATRIX4D_TARGET("sse") static BURGER_INLINE __m128 MultiplyRowSSE(__m128 vX,__m128 vY,__m128 vZ,__m128 vW,__m128 vRow)
+{
+	__m128 vResult = _mm_mul_ps(vX,_mm_shuffle_ps(vRow,vRow,_MM_SHUFFLE(0,0,0,0)));
+	vResult = _mm_add_ps(vResult,_mm_mul_ps(vY,_mm_shuffle_ps(vRow,vRow,_MM_SHUFFLE(1,1,1,1))));
+	vResult = _mm_add_ps(vResult,_mm_mul_ps(vZ,_mm_shuffle_ps(vRow,vRow,_MM_SHUFFLE(2,2,2,2))));
+	return _mm_add_ps(vResult,_mm_mul_ps(vW,_mm_shuffle_ps(vRow,vRow,_MM_SHUFFLE(3,3,3,3))));
+}
+
+MATRIX4D_TARGET("sse") static void MultiplySSE(Burger::Matrix4D_t *pOutput,const Burger::Matrix4D_t *pInput1,const Burger::Matrix4D_t *pInput2,WordPtr uCount)
+{
+	do {
+		__m128 vX = _mm_loadu_ps(&pInput1->x.x);
+		__m128 vY = _mm_loadu_ps(&pInput1->y.x);
+		__m128 vZ = _mm_loadu_ps(&pInput1->z.x);
+		__m128 vW = _mm_loadu_ps(&pInput1->w.x);
+		__m128 vRowX = _mm_loadu_ps(&pInput2->x.x);
+		__m128 vRowY = _mm_loadu_ps(&pInput2->y.x);
+		__m128 vRowZ = _mm_loadu_ps(&pInput2->z.x);
+		__m128 vRowW = _mm_loadu_ps(&pInput2->w.x);
+		_mm_storeu_ps(&pOutput->x.x,MultiplyRowSSE(vX,vY,vZ,vW,vRowX));
+		_mm_storeu_ps(&pOutput->y.x,MultiplyRowSSE(vX,vY,vZ,vW,vRowY));
+		_mm_storeu_ps(&pOutput->z.x,MultiplyRowSSE(vX,vY,vZ,vW,vRowZ));
+		_mm_storeu_ps(&pOutput->w.x,MultiplyRowSSE(vX,vY,vZ,vW,vRowW));
+		++pInput1;
+		++pInput2;
+		++pOutput;
+	} while (--uCount);
+}
+
+#if defined(MATRIX4D_AVXSUPPORT)
+
+//
+// Calculate two rows at a time, the rows of pInput1 are
+// copied to both 128 bit halves
+//
+
+MATRIX4D_TARGET("avx") static BURGER_INLINE __m256 LoadRowTwiceAVX(const Burger::Vector4D_t *pInput)
+{
+	__m128 vRow = _mm_loadu_ps(&pInput->x);
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(vRow),vRow,1);
+}
+
+MATRIX4D_TARGET("avx") static BURGER_INLINE __m256 MultiplyRowsAVX(__m256 vX,__m256 vY,__m256 vZ,__m256 vW,__m256 vRows)
+{
+	__m256 vResult = _mm256_mul_ps(vX,_mm256_shuffle_ps(vRows,vRows,_MM_SHUFFLE(0,0,0,0)));
+	vResult = _mm256_add_ps(vResult,_mm256_mul_ps(vY,_mm256_shuffle_ps(vRows,vRows,_MM_SHUFFLE(1,1,1,1))));
+	vResult = _mm256_add_ps(vResult,_mm256_mul_ps(vZ,_mm256_shuffle_ps(vRows,vRows,_MM_SHUFFLE(2,2,2,2))));
+	return _mm256_add_ps(vResult,_mm256_mul_ps(vW,_mm256_shuffle_ps(vRows,vRows,_MM_SHUFFLE(3,3,3,3))));
+}
+
+MATRIX4D_TARGET("avx") static void MultiplyAVX(Burger::Matrix4D_t *pOutput,const Burger::Matrix4D_t *pInput1,const Burger::Matrix4D_t *pInput2,WordPtr uCount)
+{
+	do {
+		__m256 vX = LoadRowTwiceAVX(&pInput1->x);
+		__m256 vY = LoadRowTwiceAVX(&pInput1->y);
+		__m256 vZ = LoadRowTwiceAVX(&pInput1->z);
+		__m256 vW = LoadRowTwiceAVX(&pInput1->w);
+		__m256 vRowsXY = _mm256_loadu_ps(&pInput2->x.x);
+		__m256 vRowsZW = _mm256_loadu_ps(&pInput2->z.x);
+		_mm256_storeu_ps(&pOutput->x.x,MultiplyRowsAVX(vX,vY,vZ,vW,vRowsXY));
+		_mm256_storeu_ps(&pOutput->z.x,MultiplyRowsAVX(vX,vY,vZ,vW,vRowsZW));
+		++pInput1;
+		++pInput2;
+		++pOutput;
+	} while (--uCount);
+	// Avoid the AVX to SSE transition penalty
+	_mm256_zeroupper();
+}
+#endif
+
+//
+// Inverse using 2x2 sub-matrices. The 4x4 matrix is treated as
+// | A B |
+// | C D |
+// where each 2x2 matrix is stored in a register as (00,01,10,11)
+//
+
+// 2x2 matrix multiply A*B
+MATRIX4D_TARGET("sse") static BURGER_INLINE __m128 Matrix2Multiply(__m128 vA,__m128 vB)
+{
+	return _mm_add_ps(_mm_mul_ps(vA,_mm_shuffle_ps(vB,vB,_MM_SHUFFLE(3,0,3,0))),
+		_mm_mul_ps(_mm_shuffle_ps(vA,vA,_MM_SHUFFLE(2,3,0,1)),_mm_shuffle_ps(vB,vB,_MM_SHUFFLE(1,2,1,2))));
+}
+
+// 2x2 matrix adjugate multiply (A#)*B
+MATRIX4D_TARGET("sse") static BURGER_INLINE __m128 Matrix2AdjugateMultiply(__m128 vA,__m128 vB)
+{
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(vA,vA,_MM_SHUFFLE(0,0,3,3)),vB),
+		_mm_mul_ps(_mm_shuffle_ps(vA,vA,_MM_SHUFFLE(2,2,1,1)),_mm_shuffle_ps(vB,vB,_MM_SHUFFLE(1,0,3,2))));
+}
+
+// 2x2 matrix multiply adjugate A*(B#)
+MATRIX4D_TARGET("sse") static BURGER_INLINE __m128 Matrix2MultiplyAdjugate(__m128 vA,__m128 vB)
+{
+	return _mm_sub_ps(_mm_mul_ps(vA,_mm_shuffle_ps(vB,vB,_MM_SHUFFLE(0,3,0,3))),
+		_mm_mul_ps(_mm_shuffle_ps(vA,vA,_MM_SHUFFLE(2,3,0,1)),_mm_shuffle_ps(vB,vB,_MM_SHUFFLE(1,2,1,2))));
+}
+
+MATRIX4D_TARGET("sse") static Word InverseSSE(Burger::Matrix4D_t *pOutput,const Burger::Matrix4D_t *pInput)
+{
+	__m128 vX = _mm_loadu_ps(&pInput->x.x);
+	__m128 vY = _mm_loadu_ps(&pInput->y.x);
+	__m128 vZ = _mm_loadu_ps(&pInput->z.x);
+	__m128 vW = _mm_loadu_ps(&pInput->w.x);
+
+	// Sub matrices
+	__m128 vA = _mm_movelh_ps(vX,vY);
+	__m128 vB = _mm_movehl_ps(vY,vX);
+	__m128 vC = _mm_movelh_ps(vZ,vW);
+	__m128 vD = _mm_movehl_ps(vW,vZ);
+
+	// Determinants of A, B, C and D
+	__m128 vDeterminants = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(vX,vZ,_MM_SHUFFLE(2,0,2,0)),_mm_shuffle_ps(vY,vW,_MM_SHUFFLE(3,1,3,1))),
+		_mm_mul_ps(_mm_shuffle_ps(vX,vZ,_MM_SHUFFLE(3,1,3,1)),_mm_shuffle_ps(vY,vW,_MM_SHUFFLE(2,0,2,0))));
+	__m128 vDetA = _mm_shuffle_ps(vDeterminants,vDeterminants,_MM_SHUFFLE(0,0,0,0));
+	__m128 vDetB = _mm_shuffle_ps(vDeterminants,vDeterminants,_MM_SHUFFLE(1,1,1,1));
+	__m128 vDetC = _mm_shuffle_ps(vDeterminants,vDeterminants,_MM_SHUFFLE(2,2,2,2));
+	__m128 vDetD = _mm_shuffle_ps(vDeterminants,vDeterminants,_MM_SHUFFLE(3,3,3,3));
+
+	// The inverse is 1/|M| * | X Y |
+	//                        | Z W |
+	__m128 vDC = Matrix2AdjugateMultiply(vD,vC);
+	__m128 vAB = Matrix2AdjugateMultiply(vA,vB);
+	// X# = |D|A - B(D#C)
+	__m128 vResultX = _mm_sub_ps(_mm_mul_ps(vDetD,vA),Matrix2Multiply(vB,vDC));
+	// W# = |A|D - C(A#B)
+	__m128 vResultW = _mm_sub_ps(_mm_mul_ps(vDetA,vD),Matrix2Multiply(vC,vAB));
+	// Y# = |B|C - D(A#B)#
+	__m128 vResultY = _mm_sub_ps(_mm_mul_ps(vDetB,vC),Matrix2MultiplyAdjugate(vD,vAB));
+	// Z# = |C|B - A(D#C)#
+	__m128 vResultZ = _mm_sub_ps(_mm_mul_ps(vDetC,vB),Matrix2MultiplyAdjugate(vA,vDC));
+
+	// |M| = |A|*|D| + |B|*|C| - trace((A#B)(D#C))
+	__m128 vTrace = _mm_mul_ps(vAB,_mm_shuffle_ps(vDC,vDC,_MM_SHUFFLE(3,1,2,0)));
+	vTrace = _mm_add_ps(vTrace,_mm_shuffle_ps(vTrace,vTrace,_MM_SHUFFLE(1,0,3,2)));
+	vTrace = _mm_add_ps(vTrace,_mm_shuffle_ps(vTrace,vTrace,_MM_SHUFFLE(2,3,0,1)));
+	__m128 vDeterminant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(vDetA,vDetD),_mm_mul_ps(vDetB,vDetC)),vTrace);
+	if (_mm_cvtss_f32(vDeterminant)==0.0f) {
+		return FALSE;
+	}
+
+	// (1/|M|,-1/|M|,-1/|M|,1/|M|) to apply the adjugate signs
+	__m128 vReciprocal = _mm_div_ps(_mm_setr_ps(1.0f,-1.0f,-1.0f,1.0f),vDeterminant);
+	vResultX = _mm_mul_ps(vResultX,vReciprocal);
+	vResultY = _mm_mul_ps(vResultY,vReciprocal);
+	vResultZ = _mm_mul_ps(vResultZ,vReciprocal);
+	vResultW = _mm_mul_ps(vResultW,vReciprocal);
+
+	// Apply the adjugate shuffle and store as rows
+	_mm_storeu_ps(&pOutput->x.x,_mm_shuffle_ps(vResultX,vResultY,_MM_SHUFFLE(1,3,1,3)));
+	_mm_storeu_ps(&pOutput->y.x,_mm_shuffle_ps(vResultX,vResultY,_MM_SHUFFLE(0,2,0,2)));
+	_mm_storeu_ps(&pOutput->z.x,_mm_shuffle_ps(vResultZ,vResultW,_MM_SHUFFLE(1,3,1,3)));
+	_mm_storeu_ps(&pOutput->w.x,_mm_shuffle_ps(vResultZ,vResultW,_MM_SHUFFLE(0,2,0,2)));
+	return TRUE;
+}
+#endif
+
 /*! ************************************
 
 	\brief Perform a matrix multiply against this matrix
@@ -2912,6 +3097,12 @@ void BURGER_API Burger::Matrix4D_t::SetWColumn(const Vector4D_t *pInput)
 
 void BURGER_API Burger::Matrix4D_t::Multiply(const Matrix4D_t *pInput)
 {
+#if defined(MATRIX4D_SIMD)
+	if (GetCPUID()->HasSSE()) {
+		MultiplySSE(this,this,pInput,1);
+		return;
+	}
+#endif
 	float fXX=(x.x*pInput->x.x)+(y.x*pInput->x.y)+(z.x*pInput->x.z)+(w.x*pInput->x.w);
 	float fXY=(x.y*pInput->x.x)+(y.y*pInput->x.y)+(z.y*pInput->x.z)+(w.y*pInput->x.w);
 	float fXZ=(x.z*pInput->x.x)+(y.z*pInput->x.y)+(z.z*pInput->x.z)+(w.z*pInput->x.w);
@@ -2996,6 +3187,12 @@ void BURGER_API Burger::Matrix4D_t::Multiply(const Matrix4D_t *pInput)
 
 void BURGER_API Burger::Matrix4D_t::Multiply(const Matrix4D_t *pInput1,const Matrix4D_t *pInput2)
 {
+#if defined(MATRIX4D_SIMD)
+	if (GetCPUID()->HasSSE()) {
+		MultiplySSE(this,pInput1,pInput2,1);
+		return;
+	}
+#endif
 	x.x=(pInput1->x.x*pInput2->x.x)+(pInput1->y.x*pInput2->x.y)+(pInput1->z.x*pInput2->x.z)+(pInput1->w.x*pInput2->x.w);
 	x.y=(pInput1->x.y*pInput2->x.x)+(pInput1->y.y*pInput2->x.y)+(pInput1->z.y*pInput2->x.z)+(pInput1->w.y*pInput2->x.w);
 	x.z=(pInput1->x.z*pInput2->x.x)+(pInput1->y.z*pInput2->x.y)+(pInput1->z.z*pInput2->x.z)+(pInput1->w.z*pInput2->x.w);
@@ -3017,6 +3214,60 @@ void BURGER_API Burger::Matrix4D_t::Multiply(const Matrix4D_t *pInput1,const Mat
 	w.w=(pInput1->x.w*pInput2->w.x)+(pInput1->y.w*pInput2->w.y)+(pInput1->z.w*pInput2->w.z)+(pInput1->w.w*pInput2->w.w);
 }
 
+/*! ************************************
+
+	\brief Perform a matrix multiply on arrays of matrices
+
+	For each entry, multiply pInput1[i] by pInput2[i] and store the
+	result in pOutput[i], the same as calling
+	pOutput[i].Multiply(&pInput1[i],&pInput2[i]). This is intended for
+	concatenating the parent and local matrices of a scene graph.
+
+	On Intel/AMD CPUs, AVX calculates two rows at a time, otherwise
+	SSE is used to calculate one row at a time.
+
+	\note pOutput can be the same array as pInput1 or pInput2, but the
+		arrays must not otherwise overlap.
+
+	\param pOutput Pointer to an array of matrices to store the results
+	\param pInput1 Pointer to an array of matrices to multiply from
+	\param pInput2 Pointer to an array of matrices to multiply against
+	\param uCount Number of entries in the arrays
+	\sa Multiply(const Matrix4D_t *,const Matrix4D_t *)
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Multiply(Matrix4D_t *pOutput,const Matrix4D_t *pInput1,const Matrix4D_t *pInput2,WordPtr uCount)
+{
+	if (uCount) {
+#if defined(MATRIX4D_SIMD)
+		const CPUID_t *pCPUID = GetCPUID();
+#if defined(MATRIX4D_AVXSUPPORT)
+		if (pCPUID->IsAVXEnabled()) {
+			MultiplyAVX(pOutput,pInput1,pInput2,uCount);
+			return;
+		}
+#endif
+		if (pCPUID->HasSSE()) {
+			MultiplySSE(pOutput,pInput1,pInput2,uCount);
+			return;
+		}
+#endif
+		do {
+			// Multiply(const Matrix4D_t *,const Matrix4D_t *) writes
+			// to the output while reading pInput1
+			if (pOutput==pInput1) {
+				pOutput->Multiply(pInput2);
+			} else {
+				pOutput->Multiply(pInput1,pInput2);
+			}
+			++pInput1;
+			++pInput2;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
 
 /*! ************************************
 
@@ -4086,6 +4337,510 @@ void BURGER_API Burger::Matrix4D_t::TransposeTransform3x3(Vector3D_t *pOutput,co
 	pOutput->z=x.z*fX + y.z*fY + z.z*fZ;
 }
 
+//
+// Batch transforms
+//
+// The scalar loops copy the matrix into locals so the compiler
+// doesn't have to reload it after every store to the output
+//
+
+enum {
+	MATRIX4D_POINT,			// Rotate and translate
+	MATRIX4D_NORMAL,		// Rotate only
+	MATRIX4D_PERSPECTIVE	// Rotate, translate and divide by W
+};
+
+static void BURGER_API TransformScalar(const Burger::Matrix4D_t *pMatrix,Burger::Vector3D_t *pOutput,const Burger::Vector3D_t *pInput,WordPtr uCount,Word uMode)
+{
+	if (uCount) {
+		float fXX = pMatrix->x.x, fXY = pMatrix->x.y, fXZ = pMatrix->x.z, fXW = pMatrix->x.w;
+		float fYX = pMatrix->y.x, fYY = pMatrix->y.y, fYZ = pMatrix->y.z, fYW = pMatrix->y.w;
+		float fZX = pMatrix->z.x, fZY = pMatrix->z.y, fZZ = pMatrix->z.z, fZW = pMatrix->z.w;
+		float fWX = pMatrix->w.x, fWY = pMatrix->w.y, fWZ = pMatrix->w.z, fWW = pMatrix->w.w;
+		do {
+			float fX = pInput->x;
+			float fY = pInput->y;
+			float fZ = pInput->z;
+			if (uMode==MATRIX4D_NORMAL) {
+				pOutput->x = fXX*fX + fXY*fY + fXZ*fZ;
+				pOutput->y = fYX*fX + fYY*fY + fYZ*fZ;
+				pOutput->z = fZX*fX + fZY*fY + fZZ*fZ;
+			} else if (uMode==MATRIX4D_POINT) {
+				pOutput->x = fXX*fX + fXY*fY + fXZ*fZ + fXW;
+				pOutput->y = fYX*fX + fYY*fY + fYZ*fZ + fYW;
+				pOutput->z = fZX*fX + fZY*fY + fZZ*fZ + fZW;
+			} else {
+				float fW = fWX*fX + fWY*fY + fWZ*fZ + fWW;
+				pOutput->x = (fXX*fX + fXY*fY + fXZ*fZ + fXW)/fW;
+				pOutput->y = (fYX*fX + fYY*fY + fYZ*fZ + fYW)/fW;
+				pOutput->z = (fZX*fX + fZY*fY + fZZ*fZ + fZW)/fW;
+			}
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+static void BURGER_API TransformSoAScalar(const Burger::Matrix4D_t *pMatrix,const Burger::Vector3DSoA_t *pOutput,const Burger::Vector3DSoA_t *pInput,WordPtr uIndex,WordPtr uCount,Word uMode)
+{
+	if (uIndex<uCount) {
+		float fXX = pMatrix->x.x, fXY = pMatrix->x.y, fXZ = pMatrix->x.z, fXW = pMatrix->x.w;
+		float fYX = pMatrix->y.x, fYY = pMatrix->y.y, fYZ = pMatrix->y.z, fYW = pMatrix->y.w;
+		float fZX = pMatrix->z.x, fZY = pMatrix->z.y, fZZ = pMatrix->z.z, fZW = pMatrix->z.w;
+		float fWX = pMatrix->w.x, fWY = pMatrix->w.y, fWZ = pMatrix->w.z, fWW = pMatrix->w.w;
+		do {
+			float fX = pInput->m_pX[uIndex];
+			float fY = pInput->m_pY[uIndex];
+			float fZ = pInput->m_pZ[uIndex];
+			if (uMode==MATRIX4D_NORMAL) {
+				pOutput->m_pX[uIndex] = fXX*fX + fXY*fY + fXZ*fZ;
+				pOutput->m_pY[uIndex] = fYX*fX + fYY*fY + fYZ*fZ;
+				pOutput->m_pZ[uIndex] = fZX*fX + fZY*fY + fZZ*fZ;
+			} else if (uMode==MATRIX4D_POINT) {
+				pOutput->m_pX[uIndex] = fXX*fX + fXY*fY + fXZ*fZ + fXW;
+				pOutput->m_pY[uIndex] = fYX*fX + fYY*fY + fYZ*fZ + fYW;
+				pOutput->m_pZ[uIndex] = fZX*fX + fZY*fY + fZZ*fZ + fZW;
+			} else {
+				float fW = fWX*fX + fWY*fY + fWZ*fZ + fWW;
+				pOutput->m_pX[uIndex] = (fXX*fX + fXY*fY + fXZ*fZ + fXW)/fW;
+				pOutput->m_pY[uIndex] = (fYX*fX + fYY*fY + fYZ*fZ + fYW)/fW;
+				pOutput->m_pZ[uIndex] = (fZX*fX + fZY*fY + fZZ*fZ + fZW)/fW;
+			}
+		} while (++uIndex<uCount);
+	}
+}
+
+//
+// SSE and AVX versions for Intel/AMD processors. They are compiled
+// with the instruction set enabled on a per function basis and
+// only called if CPUID reports the feature
+//
+
+#if defined(MATRIX4D_SIMD)
+
+//
+// Transform 4 vectors stored as x, y and z lanes
+//
+
+MATRIX4D_TARGET("sse") static BURGER_INLINE void TransformLanesSSE(const __m128 *pMatrix,__m128 *pX,__m128 *pY,__m128 *pZ,Word uMode)
+{
+	__m128 vX = pX[0];
+	__m128 vY = pY[0];
+	__m128 vZ = pZ[0];
+	__m128 vOutX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pMatrix[0],vX),_mm_mul_ps(pMatrix[1],vY)),_mm_mul_ps(pMatrix[2],vZ));
+	__m128 vOutY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pMatrix[4],vX),_mm_mul_ps(pMatrix[5],vY)),_mm_mul_ps(pMatrix[6],vZ));
+	__m128 vOutZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pMatrix[8],vX),_mm_mul_ps(pMatrix[9],vY)),_mm_mul_ps(pMatrix[10],vZ));
+	if (uMode!=MATRIX4D_NORMAL) {
+		vOutX = _mm_add_ps(vOutX,pMatrix[3]);
+		vOutY = _mm_add_ps(vOutY,pMatrix[7]);
+		vOutZ = _mm_add_ps(vOutZ,pMatrix[11]);
+		if (uMode==MATRIX4D_PERSPECTIVE) {
+			__m128 vW = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pMatrix[12],vX),_mm_mul_ps(pMatrix[13],vY)),_mm_mul_ps(pMatrix[14],vZ)),pMatrix[15]);
+			vOutX = _mm_div_ps(vOutX,vW);
+			vOutY = _mm_div_ps(vOutY,vW);
+			vOutZ = _mm_div_ps(vOutZ,vW);
+		}
+	}
+	pX[0] = vOutX;
+	pY[0] = vOutY;
+	pZ[0] = vOutZ;
+}
+
+MATRIX4D_TARGET("sse") static void LoadMatrixSSE(__m128 *pOutput,const Burger::Matrix4D_t *pMatrix)
+{
+	const float *pInput = &pMatrix->x.x;
+	Word i = 16;
+	do {
+		pOutput[0] = _mm_set1_ps(pInput[0]);
+		++pInput;
+		++pOutput;
+	} while (--i);
+}
+
+//
+// Transform Vector3D_t arrays 4 at a time. The 4 vectors are loaded
+// as 3 registers and shuffled into x, y and z lanes. All loads are
+// done before the stores so pOutput can equal pInput.
+// Returns the number of vectors processed
+//
+
+MATRIX4D_TARGET("sse") static WordPtr TransformSSE(const Burger::Matrix4D_t *pMatrix,Burger::Vector3D_t *pOutput,const Burger::Vector3D_t *pInput,WordPtr uCount,Word uMode)
+{
+	WordPtr uBlocks = uCount>>2U;
+	if (uBlocks) {
+		__m128 Matrix[16];
+		LoadMatrixSSE(Matrix,pMatrix);
+		const float *pSource = &pInput->x;
+		float *pDest = &pOutput->x;
+		do {
+			// x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3
+			__m128 vA = _mm_loadu_ps(pSource);
+			__m128 vB = _mm_loadu_ps(pSource+4);
+			__m128 vC = _mm_loadu_ps(pSource+8);
+			__m128 vT = _mm_shuffle_ps(vB,vC,_MM_SHUFFLE(1,1,2,2));
+			__m128 vX = _mm_shuffle_ps(vA,vT,_MM_SHUFFLE(2,0,3,0));
+			vT = _mm_shuffle_ps(vA,vB,_MM_SHUFFLE(0,0,1,1));
+			__m128 vU = _mm_shuffle_ps(vB,vC,_MM_SHUFFLE(2,2,3,3));
+			__m128 vY = _mm_shuffle_ps(vT,vU,_MM_SHUFFLE(2,0,2,0));
+			vT = _mm_shuffle_ps(vA,vB,_MM_SHUFFLE(1,1,2,2));
+			__m128 vZ = _mm_shuffle_ps(vT,vC,_MM_SHUFFLE(3,0,2,0));
+
+			TransformLanesSSE(Matrix,&vX,&vY,&vZ,uMode);
+
+			// Interleave back to x y z triplets
+			vT = _mm_shuffle_ps(vX,vY,_MM_SHUFFLE(0,0,0,0));
+			vU = _mm_shuffle_ps(vZ,vX,_MM_SHUFFLE(1,1,0,0));
+			vA = _mm_shuffle_ps(vT,vU,_MM_SHUFFLE(2,0,2,0));
+			vT = _mm_shuffle_ps(vY,vZ,_MM_SHUFFLE(1,1,1,1));
+			vU = _mm_shuffle_ps(vX,vY,_MM_SHUFFLE(2,2,2,2));
+			vB = _mm_shuffle_ps(vT,vU,_MM_SHUFFLE(2,0,2,0));
+			vT = _mm_shuffle_ps(vZ,vX,_MM_SHUFFLE(3,3,2,2));
+			vU = _mm_shuffle_ps(vY,vZ,_MM_SHUFFLE(3,3,3,3));
+			vC = _mm_shuffle_ps(vT,vU,_MM_SHUFFLE(2,0,2,0));
+			_mm_storeu_ps(pDest,vA);
+			_mm_storeu_ps(pDest+4,vB);
+			_mm_storeu_ps(pDest+8,vC);
+			pSource += 12;
+			pDest += 12;
+		} while (--uBlocks);
+	}
+	return uCount&(~static_cast<WordPtr>(3U));
+}
+
+//
+// Transform Vector4D_t arrays, one vector per register
+//
+
+MATRIX4D_TARGET("sse") static void Transform4DSSE(const Burger::Matrix4D_t *pMatrix,Burger::Vector4D_t *pOutput,const Burger::Vector4D_t *pInput,WordPtr uCount)
+{
+	// Load the columns
+	__m128 vColumnX = _mm_setr_ps(pMatrix->x.x,pMatrix->y.x,pMatrix->z.x,pMatrix->w.x);
+	__m128 vColumnY = _mm_setr_ps(pMatrix->x.y,pMatrix->y.y,pMatrix->z.y,pMatrix->w.y);
+	__m128 vColumnZ = _mm_setr_ps(pMatrix->x.z,pMatrix->y.z,pMatrix->z.z,pMatrix->w.z);
+	__m128 vColumnW = _mm_setr_ps(pMatrix->x.w,pMatrix->y.w,pMatrix->z.w,pMatrix->w.w);
+	do {
+		__m128 vInput = _mm_loadu_ps(&pInput->x);
+		__m128 vResult = _mm_mul_ps(vColumnX,_mm_shuffle_ps(vInput,vInput,_MM_SHUFFLE(0,0,0,0)));
+		vResult = _mm_add_ps(vResult,_mm_mul_ps(vColumnY,_mm_shuffle_ps(vInput,vInput,_MM_SHUFFLE(1,1,1,1))));
+		vResult = _mm_add_ps(vResult,_mm_mul_ps(vColumnZ,_mm_shuffle_ps(vInput,vInput,_MM_SHUFFLE(2,2,2,2))));
+		vResult = _mm_add_ps(vResult,_mm_mul_ps(vColumnW,_mm_shuffle_ps(vInput,vInput,_MM_SHUFFLE(3,3,3,3))));
+		_mm_storeu_ps(&pOutput->x,vResult);
+		++pInput;
+		++pOutput;
+	} while (--uCount);
+}
+
+//
+// Transform Vector3DSoA_t arrays 4 at a time.
+// Returns the number of vectors processed
+//
+
+MATRIX4D_TARGET("sse") static WordPtr TransformSoASSE(const Burger::Matrix4D_t *pMatrix,const Burger::Vector3DSoA_t *pOutput,const Burger::Vector3DSoA_t *pInput,WordPtr uCount,Word uMode)
+{
+	WordPtr uEnd = uCount&(~static_cast<WordPtr>(3U));
+	if (uEnd) {
+		__m128 Matrix[16];
+		LoadMatrixSSE(Matrix,pMatrix);
+		WordPtr uIndex = 0;
+		do {
+			__m128 vX = _mm_loadu_ps(pInput->m_pX+uIndex);
+			__m128 vY = _mm_loadu_ps(pInput->m_pY+uIndex);
+			__m128 vZ = _mm_loadu_ps(pInput->m_pZ+uIndex);
+			TransformLanesSSE(Matrix,&vX,&vY,&vZ,uMode);
+			_mm_storeu_ps(pOutput->m_pX+uIndex,vX);
+			_mm_storeu_ps(pOutput->m_pY+uIndex,vY);
+			_mm_storeu_ps(pOutput->m_pZ+uIndex,vZ);
+			uIndex += 4;
+		} while (uIndex<uEnd);
+	}
+	return uEnd;
+}
+
+#if defined(MATRIX4D_AVXSUPPORT)
+
+//
+// Transform Vector3DSoA_t arrays 8 at a time.
+// Returns the number of vectors processed
+//
+
+MATRIX4D_TARGET("avx") static WordPtr TransformSoAAVX(const Burger::Matrix4D_t *pMatrix,const Burger::Vector3DSoA_t *pOutput,const Burger::Vector3DSoA_t *pInput,WordPtr uCount,Word uMode)
+{
+	WordPtr uEnd = uCount&(~static_cast<WordPtr>(7U));
+	if (uEnd) {
+		__m256 vXX = _mm256_set1_ps(pMatrix->x.x), vXY = _mm256_set1_ps(pMatrix->x.y), vXZ = _mm256_set1_ps(pMatrix->x.z), vXW = _mm256_set1_ps(pMatrix->x.w);
+		__m256 vYX = _mm256_set1_ps(pMatrix->y.x), vYY = _mm256_set1_ps(pMatrix->y.y), vYZ = _mm256_set1_ps(pMatrix->y.z), vYW = _mm256_set1_ps(pMatrix->y.w);
+		__m256 vZX = _mm256_set1_ps(pMatrix->z.x), vZY = _mm256_set1_ps(pMatrix->z.y), vZZ = _mm256_set1_ps(pMatrix->z.z), vZW = _mm256_set1_ps(pMatrix->z.w);
+		__m256 vWX = _mm256_set1_ps(pMatrix->w.x), vWY = _mm256_set1_ps(pMatrix->w.y), vWZ = _mm256_set1_ps(pMatrix->w.z), vWW = _mm256_set1_ps(pMatrix->w.w);
+		WordPtr uIndex = 0;
+		do {
+			__m256 vX = _mm256_loadu_ps(pInput->m_pX+uIndex);
+			__m256 vY = _mm256_loadu_ps(pInput->m_pY+uIndex);
+			__m256 vZ = _mm256_loadu_ps(pInput->m_pZ+uIndex);
+			__m256 vOutX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vXX,vX),_mm256_mul_ps(vXY,vY)),_mm256_mul_ps(vXZ,vZ));
+			__m256 vOutY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vYX,vX),_mm256_mul_ps(vYY,vY)),_mm256_mul_ps(vYZ,vZ));
+			__m256 vOutZ = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vZX,vX),_mm256_mul_ps(vZY,vY)),_mm256_mul_ps(vZZ,vZ));
+			if (uMode!=MATRIX4D_NORMAL) {
+				vOutX = _mm256_add_ps(vOutX,vXW);
+				vOutY = _mm256_add_ps(vOutY,vYW);
+				vOutZ = _mm256_add_ps(vOutZ,vZW);
+				if (uMode==MATRIX4D_PERSPECTIVE) {
+					__m256 vW = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vWX,vX),_mm256_mul_ps(vWY,vY)),_mm256_mul_ps(vWZ,vZ)),vWW);
+					vOutX = _mm256_div_ps(vOutX,vW);
+					vOutY = _mm256_div_ps(vOutY,vW);
+					vOutZ = _mm256_div_ps(vOutZ,vW);
+				}
+			}
+			_mm256_storeu_ps(pOutput->m_pX+uIndex,vOutX);
+			_mm256_storeu_ps(pOutput->m_pY+uIndex,vOutY);
+			_mm256_storeu_ps(pOutput->m_pZ+uIndex,vOutZ);
+			uIndex += 8;
+		} while (uIndex<uEnd);
+		// Avoid the AVX to SSE transition penalty
+		_mm256_zeroupper();
+	}
+	return uEnd;
+}
+#endif
+#endif
+
+//
+// Dispatch to the fastest version
+//
+
+static void BURGER_API TransformArray(const Burger::Matrix4D_t *pMatrix,Burger::Vector3D_t *pOutput,const Burger::Vector3D_t *pInput,WordPtr uCount,Word uMode)
+{
+#if defined(MATRIX4D_SIMD)
+	if ((uCount>=4) && Burger::GetCPUID()->HasSSE()) {
+		WordPtr uDone = TransformSSE(pMatrix,pOutput,pInput,uCount,uMode);
+		pOutput += uDone;
+		pInput += uDone;
+		uCount -= uDone;
+	}
+#endif
+	TransformScalar(pMatrix,pOutput,pInput,uCount,uMode);
+}
+
+static void BURGER_API TransformSoAArray(const Burger::Matrix4D_t *pMatrix,const Burger::Vector3DSoA_t *pOutput,const Burger::Vector3DSoA_t *pInput,WordPtr uCount,Word uMode)
+{
+	WordPtr uIndex = 0;
+#if defined(MATRIX4D_SIMD)
+	if (uCount>=4) {
+		const Burger::CPUID_t *pCPUID = Burger::GetCPUID();
+#if defined(MATRIX4D_AVXSUPPORT)
+		if (pCPUID->IsAVXEnabled()) {
+			uIndex = TransformSoAAVX(pMatrix,pOutput,pInput,uCount,uMode);
+		}
+#endif
+		if (pCPUID->HasSSE() && ((uCount-uIndex)>=4)) {
+			// Process the remaining group of 4 or the whole array
+			Burger::Vector3DSoA_t Output;
+			Burger::Vector3DSoA_t Input;
+			Output.m_pX = pOutput->m_pX+uIndex;
+			Output.m_pY = pOutput->m_pY+uIndex;
+			Output.m_pZ = pOutput->m_pZ+uIndex;
+			Input.m_pX = pInput->m_pX+uIndex;
+			Input.m_pY = pInput->m_pY+uIndex;
+			Input.m_pZ = pInput->m_pZ+uIndex;
+			uIndex += TransformSoASSE(pMatrix,&Output,&Input,uCount-uIndex,uMode);
+		}
+	}
+#endif
+	TransformSoAScalar(pMatrix,pOutput,pInput,uIndex,uCount,uMode);
+}
+
+/*! ************************************
+
+	\brief Transform an array of points by a matrix
+
+	Transform each point by the matrix, identical to calling
+	Transform(Vector3D_t *,const Vector3D_t *) const on every
+	entry. On Intel/AMD CPUs with SSE, 4 points are transformed
+	at a time.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\param pOutput Pointer to an array of uninitialized Vector3D_t to store the results
+	\param pInput Pointer to an array of Vector3D_t to transform against this matrix
+	\param uCount Number of entries in the arrays
+	\sa Transform(Vector3D_t *,const Vector3D_t *) const or Transform3x3(Vector3D_t *,const Vector3D_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Transform(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const
+{
+	TransformArray(this,pOutput,pInput,uCount,MATRIX4D_POINT);
+}
+
+/*! ************************************
+
+	\brief Transform an array of 4D vectors by a matrix
+
+	Transform each vector by the matrix, identical to calling
+	Transform(Vector4D_t *,const Vector4D_t *) const on every
+	entry. On Intel/AMD CPUs with SSE, each vector is transformed
+	with 4 wide operations.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\param pOutput Pointer to an array of uninitialized Vector4D_t to store the results
+	\param pInput Pointer to an array of Vector4D_t to transform against this matrix
+	\param uCount Number of entries in the arrays
+	\sa Transform(Vector4D_t *,const Vector4D_t *) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Transform(Vector4D_t *pOutput,const Vector4D_t *pInput,WordPtr uCount) const
+{
+	if (uCount) {
+#if defined(MATRIX4D_SIMD)
+		if (GetCPUID()->HasSSE()) {
+			Transform4DSSE(this,pOutput,pInput,uCount);
+			return;
+		}
+#endif
+		do {
+			Transform(pOutput,pInput);
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Transform an array of points stored as separate arrays
+
+	Transform each point by the matrix, the same as
+	Transform(Vector3D_t *,const Vector3D_t *,WordPtr) const
+	but the coordinates are stored in a Vector3DSoA_t. This is the
+	fastest layout, on Intel/AMD CPUs 8 points are transformed at a time
+	with AVX or 4 at a time with SSE.
+
+	The output arrays can be equal to the input arrays, but must not
+	otherwise overlap.
+
+	\param pOutput Pointer to the Vector3DSoA_t to store the results
+	\param pInput Pointer to the Vector3DSoA_t to transform against this matrix
+	\param uCount Number of entries in each array
+	\sa Transform(Vector3D_t *,const Vector3D_t *,WordPtr) const or Vector3DSoA_t
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Transform(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const
+{
+	TransformSoAArray(this,pOutput,pInput,uCount,MATRIX4D_POINT);
+}
+
+/*! ************************************
+
+	\brief Transform a point and perform a perspective divide
+
+	Transform the point by the matrix and divide the x, y and z
+	results by the calculated w. This is used to project a point
+	with a matrix created by PerspectiveFovLH(float,float,float,float).
+
+	<table border="1" style="margin-right:auto;margin-left:auto;text-align:center;width:80%">
+	<tr><th>w</th><td>(wx*x)+(wy*y)+(wz*z)+(ww)</td></tr>
+	<tr><th>x</th><td>((xx*x)+(xy*y)+(xz*z)+(xw))/w</td></tr>
+	<tr><th>y</th><td>((yx*x)+(yy*y)+(yz*z)+(yw))/w</td></tr>
+	<tr><th>z</th><td>((zx*x)+(zy*y)+(zz*z)+(zw))/w</td></tr>
+	</table>
+
+	\param pOutput Pointer to an uninitialized Vector3D_t to store the result
+	\param pInput Pointer to a Vector3D_t to transform against this matrix
+	\sa TransformPerspective(Vector3D_t *,const Vector3D_t *,WordPtr) const or Transform(Vector3D_t *,const Vector3D_t *) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::TransformPerspective(Vector3D_t *pOutput,const Vector3D_t *pInput) const
+{
+	TransformScalar(this,pOutput,pInput,1,MATRIX4D_PERSPECTIVE);
+}
+
+/*! ************************************
+
+	\brief Transform an array of points and perform a perspective divide
+
+	Transform each point by the matrix and divide by the calculated w,
+	identical to calling TransformPerspective(Vector3D_t *,const Vector3D_t *) const
+	on every entry. On Intel/AMD CPUs with SSE, 4 points are
+	transformed at a time.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\param pOutput Pointer to an array of uninitialized Vector3D_t to store the results
+	\param pInput Pointer to an array of Vector3D_t to transform against this matrix
+	\param uCount Number of entries in the arrays
+	\sa TransformPerspective(Vector3D_t *,const Vector3D_t *) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::TransformPerspective(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const
+{
+	TransformArray(this,pOutput,pInput,uCount,MATRIX4D_PERSPECTIVE);
+}
+
+/*! ************************************
+
+	\brief Transform an array of points stored as separate arrays and perform a perspective divide
+
+	\param pOutput Pointer to the Vector3DSoA_t to store the results
+	\param pInput Pointer to the Vector3DSoA_t to transform against this matrix
+	\param uCount Number of entries in each array
+	\sa TransformPerspective(Vector3D_t *,const Vector3D_t *,WordPtr) const or Vector3DSoA_t
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::TransformPerspective(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const
+{
+	TransformSoAArray(this,pOutput,pInput,uCount,MATRIX4D_PERSPECTIVE);
+}
+
+/*! ************************************
+
+	\brief Transform an array of normals by a matrix
+
+	Transform each vector by the matrix only using the x, y and z terms,
+	identical to calling Transform3x3(Vector3D_t *,const Vector3D_t *) const
+	on every entry.
+
+	pOutput can be equal to pInput, but the arrays must not
+	otherwise overlap.
+
+	\note To transform normals by a matrix with a non-uniform scale, use the
+		inverse transpose of the matrix.
+
+	\param pOutput Pointer to an array of uninitialized Vector3D_t to store the results
+	\param pInput Pointer to an array of Vector3D_t to transform against this matrix
+	\param uCount Number of entries in the arrays
+	\sa Transform3x3(Vector3D_t *,const Vector3D_t *) const or Transform(Vector3D_t *,const Vector3D_t *,WordPtr) const
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Transform3x3(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const
+{
+	TransformArray(this,pOutput,pInput,uCount,MATRIX4D_NORMAL);
+}
+
+/*! ************************************
+
+	\brief Transform an array of normals stored as separate arrays
+
+	\param pOutput Pointer to the Vector3DSoA_t to store the results
+	\param pInput Pointer to the Vector3DSoA_t to transform against this matrix
+	\param uCount Number of entries in each array
+	\sa Transform3x3(Vector3D_t *,const Vector3D_t *,WordPtr) const or Vector3DSoA_t
+
+***************************************/
+
+void BURGER_API Burger::Matrix4D_t::Transform3x3(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const
+{
+	TransformSoAArray(this,pOutput,pInput,uCount,MATRIX4D_NORMAL);
+}
+
 /*! ************************************
 	
 	\brief Rotate a matrix in the Y axis (Yaw)
@@ -4482,6 +5237,87 @@ Word BURGER_API Burger::Matrix4D_t::AffineInverse(const Matrix4D_t *pInput)
 	return bResult;
 }
 
+/*! ************************************
+
+	\brief Generate the inverse of a matrix
+
+	Calculate the full 4x4 inverse of the matrix. Unlike
+	AffineInverse(const Matrix4D_t *), this works with projection
+	matrices and matrices with a non-zero w column.
+
+	On Intel/AMD CPUs, the inverse is calculated with SSE using
+	2x2 sub-matrices, otherwise it's calculated with cofactors.
+
+	If the matrix cannot be inverted, \ref FALSE is returned and
+	the original matrix is copied as is.
+
+	\param pInput Pointer to a matrix to invert, it can be this matrix.
+	\return \ref TRUE if the inversion was successful, \ref FALSE if not
+	\sa AffineInverse(const Matrix4D_t *)
+
+***************************************/
+
+Word BURGER_API Burger::Matrix4D_t::Inverse(const Matrix4D_t *pInput)
+{
+#if defined(MATRIX4D_SIMD)
+	if (GetCPUID()->HasSSE()) {
+		if (InverseSSE(this,pInput)) {
+			return TRUE;
+		}
+		Set(pInput);
+		return FALSE;
+	}
+#endif
+	float fXX = pInput->x.x, fXY = pInput->x.y, fXZ = pInput->x.z, fXW = pInput->x.w;
+	float fYX = pInput->y.x, fYY = pInput->y.y, fYZ = pInput->y.z, fYW = pInput->y.w;
+	float fZX = pInput->z.x, fZY = pInput->z.y, fZZ = pInput->z.z, fZW = pInput->z.w;
+	float fWX = pInput->w.x, fWY = pInput->w.y, fWZ = pInput->w.z, fWW = pInput->w.w;
+
+	// 2x2 determinants of the x and y rows
+	float fS0 = fXX*fYY - fYX*fXY;
+	float fS1 = fXX*fYZ - fYX*fXZ;
+	float fS2 = fXX*fYW - fYX*fXW;
+	float fS3 = fXY*fYZ - fYY*fXZ;
+	float fS4 = fXY*fYW - fYY*fXW;
+	float fS5 = fXZ*fYW - fYZ*fXW;
+
+	// 2x2 determinants of the z and w rows
+	float fC5 = fZZ*fWW - fWZ*fZW;
+	float fC4 = fZY*fWW - fWY*fZW;
+	float fC3 = fZY*fWZ - fWY*fZZ;
+	float fC2 = fZX*fWW - fWX*fZW;
+	float fC1 = fZX*fWZ - fWX*fZZ;
+	float fC0 = fZX*fWY - fWX*fZY;
+
+	float fDeterminant = fS0*fC5 - fS1*fC4 + fS2*fC3 + fS3*fC2 - fS4*fC1 + fS5*fC0;
+	if (fDeterminant==0.0f) {
+		Set(pInput);
+		return FALSE;
+	}
+	fDeterminant = 1.0f/fDeterminant;
+
+	x.x = ( fYY*fC5 - fYZ*fC4 + fYW*fC3)*fDeterminant;
+	x.y = (-fXY*fC5 + fXZ*fC4 - fXW*fC3)*fDeterminant;
+	x.z = ( fWY*fS5 - fWZ*fS4 + fWW*fS3)*fDeterminant;
+	x.w = (-fZY*fS5 + fZZ*fS4 - fZW*fS3)*fDeterminant;
+
+	y.x = (-fYX*fC5 + fYZ*fC2 - fYW*fC1)*fDeterminant;
+	y.y = ( fXX*fC5 - fXZ*fC2 + fXW*fC1)*fDeterminant;
+	y.z = (-fWX*fS5 + fWZ*fS2 - fWW*fS1)*fDeterminant;
+	y.w = ( fZX*fS5 - fZZ*fS2 + fZW*fS1)*fDeterminant;
+
+	z.x = ( fYX*fC4 - fYY*fC2 + fYW*fC0)*fDeterminant;
+	z.y = (-fXX*fC4 + fXY*fC2 - fXW*fC0)*fDeterminant;
+	z.z = ( fWX*fS4 - fWY*fS2 + fWW*fS0)*fDeterminant;
+	z.w = (-fZX*fS4 + fZY*fS2 - fZW*fS0)*fDeterminant;
+
+	w.x = (-fYX*fC3 + fYY*fC1 - fYZ*fC0)*fDeterminant;
+	w.y = ( fXX*fC3 - fXY*fC1 + fXZ*fC0)*fDeterminant;
+	w.z = (-fWX*fS3 + fWY*fS1 - fWZ*fS0)*fDeterminant;
+	w.w = ( fZX*fS3 - fZY*fS1 + fZZ*fS0)*fDeterminant;
+	return TRUE;
+}
+
 
 /*! ************************************
 
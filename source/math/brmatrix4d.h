@@ -108,6 +108,7 @@ struct Matrix4D_t {
 	void BURGER_API SetWColumn(const Vector4D_t *pInput);
 	void BURGER_API Multiply(const Matrix4D_t *pInput);
 	void BURGER_API Multiply(const Matrix4D_t *pInput1,const Matrix4D_t *pInput2);
+	static void BURGER_API Multiply(Matrix4D_t *pOutput,const Matrix4D_t *pInput1,const Matrix4D_t *pInput2,WordPtr uCount);
 	void BURGER_API Multiply(float fScale);
 	void BURGER_API Multiply(const Matrix4D_t *pInput,float fScale);
 	void BURGER_API Multiply(float fScaleX,float fScaleY,float fScaleZ);
@@ -124,12 +125,20 @@ struct Matrix4D_t {
 	void BURGER_API Transform(Vector4D_t *pInput) const;
 	void BURGER_API Transform(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
 	void BURGER_API Transform(Vector4D_t *pOutput,const Vector4D_t *pInput) const;
+	void BURGER_API Transform(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const;
+	void BURGER_API Transform(Vector4D_t *pOutput,const Vector4D_t *pInput,WordPtr uCount) const;
+	void BURGER_API Transform(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const;
+	void BURGER_API TransformPerspective(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
+	void BURGER_API TransformPerspective(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const;
+	void BURGER_API TransformPerspective(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const;
 	void BURGER_API TransposeTransform(Vector3D_t *pInput) const;
 	void BURGER_API TransposeTransform(Vector4D_t *pInput) const;
 	void BURGER_API TransposeTransform(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
 	void BURGER_API TransposeTransform(Vector4D_t *pOutput,const Vector4D_t *pInput) const;
 	void BURGER_API Transform3x3(Vector3D_t *pInput) const;
 	void BURGER_API Transform3x3(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
+	void BURGER_API Transform3x3(Vector3D_t *pOutput,const Vector3D_t *pInput,WordPtr uCount) const;
+	void BURGER_API Transform3x3(Vector3DSoA_t *pOutput,const Vector3DSoA_t *pInput,WordPtr uCount) const;
 	void BURGER_API TransposeTransform3x3(Vector3D_t *pInput) const;
 	void BURGER_API TransposeTransform3x3(Vector3D_t *pOutput,const Vector3D_t *pInput) const;
 	void BURGER_API Yaw(float fYaw);
@@ -139,6 +148,7 @@ struct Matrix4D_t {
 	void BURGER_API Translate(float fX,float fY,float fZ);
 	void BURGER_API TransposeTranslate(float fX,float fY,float fZ);
 	Word BURGER_API AffineInverse(const Matrix4D_t *pInput);
+	Word BURGER_API Inverse(const Matrix4D_t *pInput);
 	void BURGER_API PerspectiveFovLH(float fFieldOfViewY,float fAspect,float fNear,float fFar);
 	void BURGER_API PerspectiveFovRH(float fFieldOfViewY,float fAspect,float fNear,float fFar);
 	BURGER_INLINE operator const float *() const { return &x.x; }
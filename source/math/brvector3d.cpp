@@ -1407,6 +1407,24 @@ Word BURGER_API Burger::Vector3D_t::BitwiseEqual(const Vector3D_t *pInput) const
 
 ***************************************/
 
+/*! ************************************
+
+	\struct Burger::Vector3DSoA_t
+	\brief Array of 3D vectors stored as separate arrays
+
+	Instead of storing an array of Vector3D_t structures, store all
+	of the x coordinates in one array, the y coordinates in another
+	and the z coordinates in a third. This "structure of arrays" layout
+	allows SIMD code to process 4 or 8 vectors with each instruction
+	without shuffling the data first.
+
+	The arrays are not owned by this structure, it only points to them.
+	Aligning the arrays to 32 bytes is recommended, but not required.
+
+	\sa Vector3D_t or Matrix4D_t::Transform(Vector3DSoA_t *,const Vector3DSoA_t *,WordPtr) const
+
+***************************************/
+
 /*! ************************************
 
 	\struct Burger::Word32ToVector3D_t {
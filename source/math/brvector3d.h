@@ -98,6 +98,12 @@ struct Vector3D_t {
 	BURGER_INLINE operator const float *() const { return &x; }
 };
 
+struct Vector3DSoA_t {
+	float *m_pX;	///< Pointer to an array of X coordinates
+	float *m_pY;	///< Pointer to an array of Y coordinates
+	float *m_pZ;	///< Pointer to an array of Z coordinates
+};
+
 struct Word32ToVector3D_t {
 	union {
 		Word32 x[3];		///< Value as three 32 bit unsigned integers
@@ -13,6 +13,7 @@
 
 #include "brglobalmemorymanager.h"
 #include "brstringfunctions.h"
+#include "bratomic.h"
 
 /*! ************************************
 
@@ -49,6 +50,26 @@
 ***************************************/
 
 Burger::MemoryManager *Burger::GlobalMemoryManager::g_pInstance;
+Burger::GlobalMemoryManager::Stats_t Burger::GlobalMemoryManager::g_Stats;
+Word Burger::GlobalMemoryManager::g_bStatsEnabled;
+
+/*! ************************************
+
+	\struct Burger::GlobalMemoryManager::Stats_t
+	\brief Call counters for the global memory functions
+
+	The counters are incremented atomically by Burger::Alloc(),
+	Burger::Free() and the other global memory functions
+	regardless of which MemoryManager is active. They are 32 bit
+	and wrap around on overflow.
+
+	Counting is off by default, since every thread would
+	otherwise perform a locked increment on the same cache line
+	for every allocation. Turn it on with EnableStats(Word).
+
+	\sa GetStats(Stats_t *) or Burger::MemoryManagerHandle::GetAllocationStats()
+
+***************************************/
 
 /*! ************************************
 
@@ -98,6 +119,62 @@ void BURGER_API Burger::GlobalMemoryManager::Shutdown(MemoryManager *pPrevious)
 	g_pInstance = pPrevious;
 }
 
+/*! ************************************
+
+	\brief Get the call counters for the global memory functions
+
+	\param pOutput Pointer to a Stats_t to receive a copy of the counters
+	\sa ResetStats(void)
+
+***************************************/
+
+void BURGER_API Burger::GlobalMemoryManager::GetStats(Stats_t *pOutput)
+{
+	pOutput->m_uAllocations = g_Stats.m_uAllocations;
+	pOutput->m_uFrees = g_Stats.m_uFrees;
+	pOutput->m_uReallocations = g_Stats.m_uReallocations;
+	pOutput->m_uFailures = g_Stats.m_uFailures;
+}
+
+/*! ************************************
+
+	\brief Set the call counters for the global memory functions to zero
+
+	\sa GetStats(Stats_t *)
+
+***************************************/
+
+void BURGER_API Burger::GlobalMemoryManager::ResetStats(void)
+{
+	g_Stats.m_uAllocations = 0;
+	g_Stats.m_uFrees = 0;
+	g_Stats.m_uReallocations = 0;
+	g_Stats.m_uFailures = 0;
+}
+
+/*! ************************************
+
+	\fn Burger::GlobalMemoryManager::EnableStats(Word)
+	\brief Turn the call counters on or off
+
+	When off, which is the default, the global memory functions
+	don't touch the counters at all.
+
+	\param bEnable \ref TRUE to update the counters, \ref FALSE to stop
+	\sa AreStatsEnabled(void) or GetStats(Stats_t *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::GlobalMemoryManager::AreStatsEnabled(void)
+	\brief Return \ref TRUE if the call counters are being updated
+
+	\return \ref TRUE if the counters are on
+	\sa EnableStats(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\fn Burger::GlobalMemoryManager::GetInstance(void)
@@ -123,7 +200,14 @@ void BURGER_API Burger::GlobalMemoryManager::Shutdown(MemoryManager *pPrevious)
 
 void *BURGER_API Burger::Alloc(WordPtr uSize)
 {
-	return GlobalMemoryManager::GetInstance()->Alloc(uSize);
+	if (GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uAllocations);
+	}
+	void *pResult = GlobalMemoryManager::GetInstance()->Alloc(uSize);
+	if (!pResult && uSize && GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uFailures);
+	}
+	return pResult;
 }
 
 /*! ************************************
@@ -142,9 +226,14 @@ void *BURGER_API Burger::Alloc(WordPtr uSize)
 
 void *BURGER_API Burger::AllocClear(WordPtr uSize)
 {
+	if (GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uAllocations);
+	}
 	void *pResult = GlobalMemoryManager::GetInstance()->Alloc(uSize);
 	if (pResult) {
 		MemoryClear(pResult,uSize);
+	} else if (uSize && GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uFailures);
 	}
 	return pResult;
 }
@@ -165,6 +254,9 @@ void *BURGER_API Burger::AllocClear(WordPtr uSize)
 void BURGER_API Burger::Free(const void *pInput)
 {
 	if (pInput) {
+		if (GlobalMemoryManager::g_bStatsEnabled) {
+			AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uFrees);
+		}
 		GlobalMemoryManager::GetInstance()->Free(pInput);
 	}
 }
@@ -187,7 +279,14 @@ void BURGER_API Burger::Free(const void *pInput)
 
 void *BURGER_API Burger::Realloc(const void *pInput,WordPtr uSize)
 {
-	return GlobalMemoryManager::GetInstance()->Realloc(pInput,uSize);
+	if (GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uReallocations);
+	}
+	void *pResult = GlobalMemoryManager::GetInstance()->Realloc(pInput,uSize);
+	if (!pResult && uSize && GlobalMemoryManager::g_bStatsEnabled) {
+		AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uFailures);
+	}
+	return pResult;
 }
 
 
@@ -209,12 +308,17 @@ void *BURGER_API Burger::AllocCopy(const void *pInput,WordPtr uSize)
 {
 	void *pOutput=NULL;
 	if (uSize) {			// Sanity check
+		if (GlobalMemoryManager::g_bStatsEnabled) {
+			AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uAllocations);
+		}
 		pOutput = GlobalMemoryManager::GetInstance()->Alloc(uSize);
 		if (pOutput) {			// Valid?
 			if (pInput) {		// Anything to copy?
 				// Copy it!
 				MemoryCopy(pOutput,pInput,uSize);
 			}
+		} else if (GlobalMemoryManager::g_bStatsEnabled) {
+			AtomicPostIncrement(&GlobalMemoryManager::g_Stats.m_uFailures);
 		}
 	}
 	// Return the new memory
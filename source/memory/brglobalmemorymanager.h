@@ -33,11 +33,28 @@ extern void *BURGER_API AllocCopy(const void *pInput,WordPtr uSize);
 
 class GlobalMemoryManager {
 public:
+	struct Stats_t {
+		Word32 m_uAllocations;		///< Number of calls to allocate memory
+		Word32 m_uFrees;			///< Number of calls to release memory
+		Word32 m_uReallocations;	///< Number of calls to resize memory
+		Word32 m_uFailures;			///< Number of allocations that returned \ref NULL
+	};
 	static MemoryManager * BURGER_API Init(MemoryManager *pInstance);
 	static void BURGER_API Shutdown(MemoryManager *pPrevious=NULL);
 	static BURGER_INLINE MemoryManager *GetInstance(void) { return g_pInstance; }
+	static void BURGER_API GetStats(Stats_t *pOutput);
+	static void BURGER_API ResetStats(void);
+	static BURGER_INLINE void EnableStats(Word bEnable) { g_bStatsEnabled = bEnable; }
+	static BURGER_INLINE Word AreStatsEnabled(void) { return g_bStatsEnabled; }
 private:
 	static MemoryManager *g_pInstance;	///< Pointer to the currently active memory manager
+	friend void *BURGER_API Alloc(WordPtr uSize);
+	friend void *BURGER_API AllocClear(WordPtr uSize);
+	friend void BURGER_API Free(const void *pInput);
+	friend void *BURGER_API Realloc(const void *pInput,WordPtr uSize);
+	friend void *BURGER_API AllocCopy(const void *pInput,WordPtr uSize);
+	static Stats_t g_Stats;				///< Call counters for the global memory functions
+	static Word g_bStatsEnabled;		///< \ref TRUE if g_Stats is updated
 };
 template <class T>
 T * BURGER_API New(void) {
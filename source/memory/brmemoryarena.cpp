@@ -0,0 +1,692 @@
+/***************************************
+
+	Arena based memory manager
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brmemoryarena.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\class Burger::MemoryManagerArena
+	\brief Arena (Bump pointer) memory manager
+
+	This memory manager obtains large chunks of memory from the
+	operating system and hands out allocations by advancing a
+	pointer. Individual calls to Free() are ignored, with the
+	exception of the most recent allocation, which is rolled back.
+	All of the memory is reclaimed at once with a call to Reset(),
+	which takes constant time and keeps the chunks so the next
+	frame or request doesn't have to go to the operating system.
+
+	It's intended for short lived scratch memory, such as the
+	nodes and strings created while parsing a file with
+	Burger::FileXML or Burger::FileINI when the parsed
+	data is discarded when the job is done.
+
+	\code
+	MemoryManagerGlobalArena Scratch;
+	FileINI *pINI = FileINI::New("9:settings.ini");
+	// Use the data
+	Delete(pINI);
+	// All memory is released when Scratch goes out of scope
+	\endcode
+
+	There is no locking. Each thread that needs scratch memory should
+	create its own instance and allocate from it directly.
+	Burger::MemoryManagerGlobalArena is shared by every thread, so
+	it adds a lock.
+
+	\sa Burger::MemoryManagerGlobalArena or Burger::MemoryManagerHandle
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::MemoryManagerArena::Mark_t
+	\brief Saved allocation position in a Burger::MemoryManagerArena
+
+	Filled in by GetMark(Mark_t *) const and used by
+	FreeToMark(const Mark_t *) to release all memory
+	allocated after the mark was taken.
+
+***************************************/
+
+#if !defined(DOXYGEN)
+// Size of the chunk header rounded up to alignment
+#define CHUNKHEADERSIZE ((sizeof(Chunk_t)+(ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1)))
+#endif
+
+/*! ************************************
+
+	\brief Create an arena memory manager
+
+	Initialize the jump table and set the size of the chunks
+	to obtain from the operating system. No memory is
+	allocated until the first call to Alloc(WordPtr).
+
+	\param uChunkSize Size in bytes of each chunk of memory
+
+***************************************/
+
+Burger::MemoryManagerArena::MemoryManagerArena(WordPtr uChunkSize) :
+	m_pFirst(NULL),
+	m_pCurrent(NULL),
+	m_pWork(NULL),
+	m_pEnd(NULL),
+	m_uChunkSize(uChunkSize),
+	m_uTotalSystemMemory(0)
+{
+	m_pAlloc = AllocProc;
+	m_pFree = FreeProc;
+	m_pRealloc = ReallocProc;
+	m_pShutdown = ShutdownProc;
+}
+
+/*! ************************************
+
+	\brief Release all memory
+
+	All chunks are returned to the operating system.
+
+	\sa Shutdown(void)
+
+***************************************/
+
+Burger::MemoryManagerArena::~MemoryManagerArena()
+{
+	ShutdownProc(this);
+}
+
+/*! ************************************
+
+	\fn void *Burger::MemoryManagerArena::Alloc(WordPtr uSize)
+	\brief Allocate memory
+
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa AllocProc(MemoryManager *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::MemoryManagerArena::Free(const void *pInput)
+	\brief Release memory
+
+	\param pInput \ref NULL or a pointer to memory allocated by this class
+	\sa FreeProc(MemoryManager *,const void *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void *Burger::MemoryManagerArena::Realloc(const void *pInput,WordPtr uSize)
+	\brief Resize a block of memory
+
+	\param pInput Pointer to memory to resize
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa ReallocProc(MemoryManager *,const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::MemoryManagerArena::Shutdown(void)
+	\brief Release all memory back to the operating system
+
+	\sa ShutdownProc(MemoryManager *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::MemoryManagerArena::GetTotalSystemMemory(void) const
+	\brief Return the number of bytes obtained from the operating system
+
+	\return Size in bytes of all the chunks owned by this arena
+	\sa GetTotalAllocatedMemory(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\brief Allocate memory
+
+	Advance the allocation pointer by the size of the request
+	plus a small header holding the size. If the current chunk
+	is out of space, move to the next chunk.
+
+	\param pThis Pointer to the MemoryManagerArena instance
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa Alloc(WordPtr)
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerArena::AllocProc(MemoryManager *pThis,WordPtr uSize)
+{
+	void *pResult = NULL;
+	if (uSize) {
+		MemoryManagerArena *pSelf = static_cast<MemoryManagerArena *>(pThis);
+		Word8 *pWork = pSelf->m_pWork;
+		// Space for the size and the data, rounded up
+		WordPtr uNeeded = (uSize+(ALIGNMENT+ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1));
+		// Check for overflow and available space
+		if ((uNeeded>uSize) && (static_cast<WordPtr>(pSelf->m_pEnd-pWork)>=uNeeded)) {
+			pSelf->m_pWork = pWork+uNeeded;
+			reinterpret_cast<WordPtr *>(pWork)[0] = uSize;
+			pResult = pWork+ALIGNMENT;
+		} else if (uNeeded>uSize) {
+			pResult = pSelf->AllocNewChunk(uNeeded);
+			if (pResult) {
+				reinterpret_cast<WordPtr *>(pResult)[0] = uSize;
+				pResult = static_cast<Word8 *>(pResult)+ALIGNMENT;
+			}
+		}
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Release memory
+
+	Memory is not released individually, it's reclaimed
+	with a call to Reset(). The exception is the most recent
+	allocation, whose space is reused immediately.
+
+	\param pThis Pointer to the MemoryManagerArena instance
+	\param pInput \ref NULL or a pointer to memory allocated by this class
+	\sa Free(const void *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerArena::FreeProc(MemoryManager *pThis,const void *pInput)
+{
+	if (pInput) {
+		MemoryManagerArena *pSelf = static_cast<MemoryManagerArena *>(pThis);
+		Word8 *pBlock = const_cast<Word8 *>(static_cast<const Word8 *>(pInput))-ALIGNMENT;
+		WordPtr uNeeded = (reinterpret_cast<const WordPtr *>(pBlock)[0]+(ALIGNMENT+ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1));
+		// Last allocation? Give the space back
+		if ((pBlock+uNeeded)==pSelf->m_pWork) {
+			pSelf->m_pWork = pBlock;
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Resize a block of memory
+
+	If the memory is the most recent allocation, it's
+	resized in place if the current chunk has enough space.
+	Otherwise, new memory is allocated and the data is copied.
+
+	\param pThis Pointer to the MemoryManagerArena instance
+	\param pInput Pointer to memory to resize
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa Realloc(const void *,WordPtr)
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerArena::ReallocProc(MemoryManager *pThis,const void *pInput,WordPtr uSize)
+{
+	MemoryManagerArena *pSelf = static_cast<MemoryManagerArena *>(pThis);
+	void *pResult = NULL;
+	if (!pInput) {
+		pResult = AllocProc(pSelf,uSize);
+	} else if (!uSize) {
+		FreeProc(pSelf,pInput);
+	} else {
+		Word8 *pBlock = const_cast<Word8 *>(static_cast<const Word8 *>(pInput))-ALIGNMENT;
+		WordPtr uOldSize = reinterpret_cast<const WordPtr *>(pBlock)[0];
+		WordPtr uOldNeeded = (uOldSize+(ALIGNMENT+ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1));
+		WordPtr uNeeded = (uSize+(ALIGNMENT+ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1));
+		// Resize in place if it's the last allocation and it fits
+		if ((uNeeded>uSize) && ((pBlock+uOldNeeded)==pSelf->m_pWork) &&
+			(static_cast<WordPtr>(pSelf->m_pEnd-pBlock)>=uNeeded)) {
+			pSelf->m_pWork = pBlock+uNeeded;
+			reinterpret_cast<WordPtr *>(pBlock)[0] = uSize;
+			pResult = const_cast<void *>(pInput);
+		} else if (uSize<=uOldSize) {
+			// Shrinking, keep the memory where it is
+			reinterpret_cast<WordPtr *>(pBlock)[0] = uSize;
+			pResult = const_cast<void *>(pInput);
+		} else {
+			pResult = AllocProc(pSelf,uSize);
+			if (pResult) {
+				MemoryCopy(pResult,pInput,uOldSize);
+			}
+		}
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Release all memory back to the operating system
+
+	All pointers allocated by this instance are invalid
+	after this call. The arena can still be used, new chunks
+	will be obtained as needed.
+
+	\param pThis Pointer to the MemoryManagerArena instance
+	\sa Shutdown(void) or Reset(void)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerArena::ShutdownProc(MemoryManager *pThis)
+{
+	MemoryManagerArena *pSelf = static_cast<MemoryManagerArena *>(pThis);
+	Chunk_t *pChunk = pSelf->m_pFirst;
+	if (pChunk) {
+		do {
+			Chunk_t *pNext = pChunk->m_pNext;
+			FreeSystemMemory(pChunk);
+			pChunk = pNext;
+		} while (pChunk);
+	}
+	pSelf->m_pFirst = NULL;
+	pSelf->m_pCurrent = NULL;
+	pSelf->m_pWork = NULL;
+	pSelf->m_pEnd = NULL;
+	pSelf->m_uTotalSystemMemory = 0;
+}
+
+/*! ************************************
+
+	\brief Allocate memory from the next chunk
+
+	The current chunk is out of space, so use the next
+	chunk in the chain if it's large enough, otherwise
+	obtain a new chunk from the operating system and insert
+	it after the current chunk.
+
+	\param uSize Number of bytes needed, including the size header and padding
+	\return \ref NULL if out of memory, or a pointer to the size header of the new allocation
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerArena::AllocNewChunk(WordPtr uSize)
+{
+	Chunk_t *pCurrent = m_pCurrent;
+	Chunk_t *pChunk = pCurrent ? pCurrent->m_pNext : m_pFirst;
+	if (!pChunk || ((pChunk->m_uSize-CHUNKHEADERSIZE)<uSize)) {
+		WordPtr uChunkSize = uSize+CHUNKHEADERSIZE;
+		// Overflow?
+		if (uChunkSize<uSize) {
+			return NULL;
+		}
+		if (uChunkSize<m_uChunkSize) {
+			uChunkSize = m_uChunkSize;
+		}
+		Chunk_t *pNew = static_cast<Chunk_t *>(AllocSystemMemory(uChunkSize));
+		if (!pNew) {
+			return NULL;
+		}
+		pNew->m_uSize = uChunkSize;
+		m_uTotalSystemMemory += uChunkSize;
+		// Link in after the current chunk
+		pNew->m_pNext = pChunk;
+		if (pCurrent) {
+			pCurrent->m_pNext = pNew;
+		} else {
+			m_pFirst = pNew;
+		}
+		pChunk = pNew;
+	}
+	m_pCurrent = pChunk;
+	Word8 *pResult = reinterpret_cast<Word8 *>(pChunk)+CHUNKHEADERSIZE;
+	m_pWork = pResult+uSize;
+	m_pEnd = reinterpret_cast<Word8 *>(pChunk)+pChunk->m_uSize;
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Return the size of an allocation
+
+	\param pInput \ref NULL or a pointer to memory allocated by a Burger::MemoryManagerArena
+	\return Number of bytes requested when the memory was allocated, zero if \ref NULL
+
+***************************************/
+
+WordPtr BURGER_API Burger::MemoryManagerArena::GetSize(const void *pInput)
+{
+	WordPtr uResult = 0;
+	if (pInput) {
+		uResult = reinterpret_cast<const WordPtr *>(static_cast<const Word8 *>(pInput)-ALIGNMENT)[0];
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Release all allocations
+
+	Reclaim all of the memory allocated from this arena in
+	constant time. The chunks are kept so they can be reused.
+	All pointers allocated by this instance are invalid after
+	this call.
+
+	\sa Shutdown(void) or FreeToMark(const Mark_t *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerArena::Reset(void)
+{
+	Chunk_t *pChunk = m_pFirst;
+	m_pCurrent = pChunk;
+	if (pChunk) {
+		m_pWork = reinterpret_cast<Word8 *>(pChunk)+CHUNKHEADERSIZE;
+		m_pEnd = reinterpret_cast<Word8 *>(pChunk)+pChunk->m_uSize;
+	}
+}
+
+/*! ************************************
+
+	\brief Save the current allocation position
+
+	Record the allocation position so all allocations made
+	after this call can be released with FreeToMark(const Mark_t *).
+
+	\param pOutput Pointer to a Mark_t to receive the position
+	\sa FreeToMark(const Mark_t *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerArena::GetMark(Mark_t *pOutput) const
+{
+	pOutput->m_pChunk = m_pCurrent;
+	pOutput->m_pWork = m_pWork;
+}
+
+/*! ************************************
+
+	\brief Release all allocations made after a mark
+
+	Rewind the allocation position to where it was when
+	GetMark(Mark_t *) const was called. Marks must be released
+	in the reverse order that they were taken and a Reset()
+	invalidates all marks.
+
+	\param pInput Pointer to a Mark_t filled in by GetMark(Mark_t *) const
+	\sa GetMark(Mark_t *) const or Reset(void)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerArena::FreeToMark(const Mark_t *pInput)
+{
+	Chunk_t *pChunk = static_cast<Chunk_t *>(pInput->m_pChunk);
+	// Mark taken before any memory was allocated?
+	if (!pChunk) {
+		Reset();
+	} else {
+		m_pCurrent = pChunk;
+		m_pWork = pInput->m_pWork;
+		m_pEnd = reinterpret_cast<Word8 *>(pChunk)+pChunk->m_uSize;
+	}
+}
+
+/*! ************************************
+
+	\brief Return the number of bytes in use
+
+	Walk the chunks up to the current one and total the
+	memory that has been handed out, including the size
+	headers and padding.
+
+	\return Number of bytes allocated since the last Reset()
+	\sa GetTotalSystemMemory(void) const
+
+***************************************/
+
+WordPtr BURGER_API Burger::MemoryManagerArena::GetTotalAllocatedMemory(void) const
+{
+	WordPtr uResult = 0;
+	const Chunk_t *pChunk = m_pFirst;
+	const Chunk_t *pCurrent = m_pCurrent;
+	if (pCurrent) {
+		while (pChunk!=pCurrent) {
+			// Unused space at the end of earlier chunks counts as used
+			uResult += pChunk->m_uSize-CHUNKHEADERSIZE;
+			pChunk = pChunk->m_pNext;
+		}
+		uResult += static_cast<WordPtr>(m_pWork-(reinterpret_cast<const Word8 *>(pCurrent)+CHUNKHEADERSIZE));
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Test if a pointer was allocated from this arena
+
+	Walk the chunks and check if the pointer is inside
+	of one of them. Used to tell arena memory apart from
+	memory obtained from another memory manager.
+
+	\param pInput Pointer to test
+	\return \ref TRUE if the pointer is inside of a chunk owned by this arena
+	\sa GetTotalSystemMemory(void) const
+
+***************************************/
+
+Word BURGER_API Burger::MemoryManagerArena::IsInArena(const void *pInput) const
+{
+	const Word8 *pTest = static_cast<const Word8 *>(pInput);
+	const Chunk_t *pChunk = m_pFirst;
+	while (pChunk) {
+		const Word8 *pStart = reinterpret_cast<const Word8 *>(pChunk);
+		if ((pTest>=(pStart+(CHUNKHEADERSIZE+ALIGNMENT))) && (pTest<(pStart+pChunk->m_uSize))) {
+			return TRUE;
+		}
+		pChunk = pChunk->m_pNext;
+	}
+	return FALSE;
+}
+
+/*! ************************************
+
+	\class Burger::MemoryManagerGlobalArena
+	\brief Global Arena Memory Manager helper class
+
+	This class is a helper that attaches a \ref Burger::MemoryManagerArena
+	class to the global memory manager. When this instance shuts down,
+	it will remove itself from the global memory manager and release
+	all of the memory allocated while it was active.
+
+	\note Any memory allocated while this class was the global memory
+	manager must not be used or released after this class is destroyed.
+
+	Since any thread can call Burger::Alloc(), all allocations are
+	guarded with a lock. Memory that was allocated before this class
+	was installed is passed to the previous memory manager when it's
+	released or resized.
+
+	\note Reset() can be called while other threads are allocating, but
+	GetMark(Mark_t *) const and FreeToMark(const Mark_t *) are not
+	locked, only call them when no other thread is using the arena.
+
+	\sa Burger::GlobalMemoryManager and Burger::MemoryManagerArena
+
+***************************************/
+
+/*! ************************************
+
+	\brief Attaches a \ref Burger::MemoryManagerArena class to the global memory manager.
+
+	When this class is created, it will automatically attach itself
+	to the global memory manager.
+
+	\param uChunkSize Size in bytes of each chunk of memory
+
+***************************************/
+
+Burger::MemoryManagerGlobalArena::MemoryManagerGlobalArena(WordPtr uChunkSize) :
+	MemoryManagerArena(uChunkSize),
+	m_Lock()
+{
+	m_pAlloc = AllocProc;
+	m_pFree = FreeProc;
+	m_pRealloc = ReallocProc;
+	m_pPrevious = GlobalMemoryManager::Init(this);
+}
+
+/*! ************************************
+
+	\brief Releases a Burger::MemoryManagerGlobalArena class from the global memory manager.
+
+	When this class is released, it will automatically remove itself
+	from the global memory manager.
+
+***************************************/
+
+Burger::MemoryManagerGlobalArena::~MemoryManagerGlobalArena()
+{
+	GlobalMemoryManager::Shutdown(m_pPrevious);
+}
+
+/*! ************************************
+
+	\fn void *Burger::MemoryManagerGlobalArena::Alloc(WordPtr uSize)
+	\brief Allocate memory
+
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa AllocProc(MemoryManager *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::MemoryManagerGlobalArena::Free(const void *pInput)
+	\brief Release memory
+
+	\param pInput \ref NULL or a pointer to memory to release
+	\sa FreeProc(MemoryManager *,const void *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void *Burger::MemoryManagerGlobalArena::Realloc(const void *pInput,WordPtr uSize)
+	\brief Resize a block of memory
+
+	\param pInput Pointer to memory to resize
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa ReallocProc(MemoryManager *,const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Allocate memory with the lock held
+
+	\param pThis Pointer to the MemoryManagerGlobalArena instance
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa MemoryManagerArena::AllocProc(MemoryManager *,WordPtr)
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerGlobalArena::AllocProc(MemoryManager *pThis,WordPtr uSize)
+{
+	MemoryManagerGlobalArena *pSelf = static_cast<MemoryManagerGlobalArena *>(pThis);
+	pSelf->m_Lock.Lock();
+	void *pResult = MemoryManagerArena::AllocProc(pSelf,uSize);
+	pSelf->m_Lock.Unlock();
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Release memory with the lock held
+
+	If the memory wasn't allocated from the arena, it was
+	allocated before this class was installed, so it's
+	released with the previous memory manager.
+
+	\param pThis Pointer to the MemoryManagerGlobalArena instance
+	\param pInput \ref NULL or a pointer to memory to release
+	\sa MemoryManagerArena::FreeProc(MemoryManager *,const void *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerGlobalArena::FreeProc(MemoryManager *pThis,const void *pInput)
+{
+	if (pInput) {
+		MemoryManagerGlobalArena *pSelf = static_cast<MemoryManagerGlobalArena *>(pThis);
+		pSelf->m_Lock.Lock();
+		Word bInArena = pSelf->IsInArena(pInput);
+		if (bInArena) {
+			MemoryManagerArena::FreeProc(pSelf,pInput);
+		}
+		pSelf->m_Lock.Unlock();
+		// Not mine? Let the previous manager release it
+		if (!bInArena && pSelf->m_pPrevious) {
+			pSelf->m_pPrevious->Free(pInput);
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Resize a block of memory with the lock held
+
+	If the memory wasn't allocated from the arena, it's
+	resized by the previous memory manager and remains
+	owned by it. If there is no previous memory manager,
+	the size of the memory can't be determined and
+	\ref NULL is returned.
+
+	\param pThis Pointer to the MemoryManagerGlobalArena instance
+	\param pInput Pointer to memory to resize
+	\param uSize Number of bytes requested
+	\return \ref NULL if out of memory or zero bytes were requested, valid pointer to memory if not
+	\sa MemoryManagerArena::ReallocProc(MemoryManager *,const void *,WordPtr)
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerGlobalArena::ReallocProc(MemoryManager *pThis,const void *pInput,WordPtr uSize)
+{
+	MemoryManagerGlobalArena *pSelf = static_cast<MemoryManagerGlobalArena *>(pThis);
+	void *pResult = NULL;
+	pSelf->m_Lock.Lock();
+	Word bInArena = !pInput || pSelf->IsInArena(pInput);
+	if (bInArena) {
+		pResult = MemoryManagerArena::ReallocProc(pSelf,pInput,uSize);
+	}
+	pSelf->m_Lock.Unlock();
+	if (!bInArena && pSelf->m_pPrevious) {
+		pResult = pSelf->m_pPrevious->Realloc(pInput,uSize);
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Release all allocations with the lock held
+
+	\sa MemoryManagerArena::Reset(void)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerGlobalArena::Reset(void)
+{
+	m_Lock.Lock();
+	MemoryManagerArena::Reset();
+	m_Lock.Unlock();
+}
@@ -0,0 +1,97 @@
+/***************************************
+
+	Arena based memory manager
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRMEMORYARENA_H__
+#define __BRMEMORYARENA_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRMEMORYMANAGER_H__
+#include "brmemorymanager.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class MemoryManagerArena : public MemoryManager {
+	BURGER_DISABLECOPYCONSTRUCTORS(MemoryManagerArena);
+public:
+	enum {
+		DEFAULTCHUNKSIZE=0x10000,	///< Default size of each chunk of memory taken from the system
+		// ALIGNMENT cannot be smaller than sizeof(WordPtr)
+#if defined(BURGER_MSDOS) || defined(BURGER_DS) || defined(BURGER_68K)
+		ALIGNMENT=4			///< Default memory alignment
+#else
+		ALIGNMENT=16		///< Default memory alignment
+#endif
+	};
+	struct Mark_t {
+		void *m_pChunk;			///< Chunk that was active when the mark was taken
+		Word8 *m_pWork;			///< Allocation pointer when the mark was taken
+	};
+private:
+	struct Chunk_t {
+		Chunk_t *m_pNext;		///< Next chunk in the chain
+		WordPtr m_uSize;		///< Size of this chunk in bytes, including this header
+	};
+	Chunk_t *m_pFirst;			///< First chunk of memory
+	Chunk_t *m_pCurrent;		///< Chunk that allocations are coming from
+	Word8 *m_pWork;				///< Pointer to the next free byte in the current chunk
+	Word8 *m_pEnd;				///< Pointer to the end of the current chunk
+	WordPtr m_uChunkSize;		///< Size of new chunks
+	WordPtr m_uTotalSystemMemory;	///< Total memory taken from the system
+	void *BURGER_API AllocNewChunk(WordPtr uSize);
+protected:
+	static void *BURGER_API AllocProc(MemoryManager *pThis,WordPtr uSize);
+	static void BURGER_API FreeProc(MemoryManager *pThis,const void *pInput);
+	static void *BURGER_API ReallocProc(MemoryManager *pThis,const void *pInput,WordPtr uSize);
+	static void BURGER_API ShutdownProc(MemoryManager *pThis);
+public:
+	MemoryManagerArena(WordPtr uChunkSize=DEFAULTCHUNKSIZE);
+	~MemoryManagerArena();
+	BURGER_INLINE void *Alloc(WordPtr uSize) { return AllocProc(this,uSize); }
+	BURGER_INLINE void Free(const void *pInput) { return FreeProc(this,pInput); }
+	BURGER_INLINE void *Realloc(const void *pInput,WordPtr uSize) { return ReallocProc(this,pInput,uSize); }
+	BURGER_INLINE void Shutdown(void) { ShutdownProc(this); }
+	BURGER_INLINE WordPtr GetTotalSystemMemory(void) const { return m_uTotalSystemMemory; }
+	static WordPtr BURGER_API GetSize(const void *pInput);
+	void BURGER_API Reset(void);
+	void BURGER_API GetMark(Mark_t *pOutput) const;
+	void BURGER_API FreeToMark(const Mark_t *pInput);
+	WordPtr BURGER_API GetTotalAllocatedMemory(void) const;
+	Word BURGER_API IsInArena(const void *pInput) const;
+};
+class MemoryManagerGlobalArena : public MemoryManagerArena {
+	BURGER_DISABLECOPYCONSTRUCTORS(MemoryManagerGlobalArena);
+	MemoryManager *m_pPrevious;			///< Pointer to the previous memory manager
+	CriticalSection m_Lock;				///< Lock for multithreading support
+	static void *BURGER_API AllocProc(MemoryManager *pThis,WordPtr uSize);
+	static void BURGER_API FreeProc(MemoryManager *pThis,const void *pInput);
+	static void *BURGER_API ReallocProc(MemoryManager *pThis,const void *pInput,WordPtr uSize);
+public:
+	MemoryManagerGlobalArena(WordPtr uChunkSize=DEFAULTCHUNKSIZE);
+	~MemoryManagerGlobalArena();
+	BURGER_INLINE void *Alloc(WordPtr uSize) { return AllocProc(this,uSize); }
+	BURGER_INLINE void Free(const void *pInput) { return FreeProc(this,pInput); }
+	BURGER_INLINE void *Realloc(const void *pInput,WordPtr uSize) { return ReallocProc(this,pInput,uSize); }
+	void BURGER_API Reset(void);
+};
+}
+/* END */
+
+#endif
@@ -16,6 +16,8 @@
 #include "brdebug.h"
 #include "brstringfunctions.h"
 #include "brglobalmemorymanager.h"
+#include "brtick.h"
+#include "broutputmemorystream.h"
 
 /*! ************************************
 
@@ -58,13 +60,42 @@
 
 ***************************************/
 
+/*! ************************************
+
+	\struct Burger::MemoryManagerHandle::SlabStats_t
+	\brief Statistics for a small allocation size class
+
+	Allocations of \ref SLABMAXIMUMSIZE bytes or less are
+	serviced from slabs of fixed sized blocks instead of
+	the handle list. This structure is filled in by
+	GetSlabStats() to allow the hit rate of each size
+	class to be monitored.
+
+	\sa GetSlabStats(SlabStats_t *,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::MemoryManagerHandle::FragmentationStats_t
+	\brief Statistics for memory fragmentation
+
+	Filled in by GetFragmentationStats() to monitor how fragmented the
+	free memory is and how much work compaction has performed.
+
+	\sa GetFragmentationStats(FragmentationStats_t *)
+
+***************************************/
+
 #if !defined(DOXYGEN)
 #if BURGER_MAXWORDPTR==0xFFFFFFFFU
 #define SANITYCHECK 0xDEADBEEF
 #define KILLSANITYCHECK 0xBADBADBA
+#define SLABCHECK 0x51ABBEEF
 #else
 #define SANITYCHECK 0xABCDDEADBEEFDCBAULL
 #define KILLSANITYCHECK 0xBADBADBADBADBADBULL
+#define SLABCHECK 0xABCD51ABBEEFDCBAULL
 #endif
 
 struct PointerPrefix_t {
@@ -75,8 +106,49 @@ struct PointerPrefix_t {
 	Word m_uPadding2;
 #endif
 };
+
+/***************************************
+
+	Small allocations are carved out of slabs, which are fixed
+	handles of SLABSIZE bytes. Each block has the same PointerPrefix_t
+	as a handle based allocation, but m_ppParentHandle points to
+	the Slab_t and m_uSignature is SLABCHECK so FreeProc() can
+	tell them apart.
+
+***************************************/
+
+struct Burger::MemoryManagerHandle::Slab_t {
+	Slab_t *m_pNext;			///< Next slab in the size class's partial list
+	Slab_t *m_pPrev;			///< Previous slab in the size class's partial list
+	void **m_ppHandle;			///< Handle of the memory of this slab
+	PointerPrefix_t *m_pFree;	///< Linked list of free blocks
+	WordPtr m_uBlockSize;		///< Size of each allocation, without the prefix
+	Word m_uClass;				///< Size class index
+	Word m_uUsed;				///< Number of allocated blocks
+	Word m_uTotal;				///< Number of blocks in this slab
+};
 #endif
 
+/*! ************************************
+
+	\brief Table to convert an allocation size into a size class
+
+	Index with ((uSize-1)/SLABMINIMUMSIZE) to get the
+	size class for any size from 1 to SLABMAXIMUMSIZE.
+
+***************************************/
+
+const Word8 Burger::MemoryManagerHandle::g_SlabClassTable[SLABMAXIMUMSIZE/SLABMINIMUMSIZE] = {
+	0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4,
+	5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,5,
+	6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
+	6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,
+	7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+	7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+	7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+	7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7
+};
+
 /*! ************************************
 
 	\brief Allocate fixed memory
@@ -98,6 +170,13 @@ void *BURGER_API Burger::MemoryManagerHandle::AllocProc(MemoryManager *pThis,Wor
 	void *pResult = NULL;
 	if (uSize) {
 		MemoryManagerHandle *pSelf = static_cast<MemoryManagerHandle *>(pThis);
+		// Small allocations come from the size classes
+		if (uSize<=SLABMAXIMUMSIZE) {
+			pResult = pSelf->AllocSlabBlock(uSize);
+			if (pResult) {
+				return pResult;
+			}
+		}
 		// Allocate the memory with memory for a back pointer
 		void **ppData = pSelf->AllocHandle(uSize+sizeof(PointerPrefix_t),FIXED);
 		// Got the memory?
@@ -136,9 +215,13 @@ void BURGER_API Burger::MemoryManagerHandle::FreeProc(MemoryManager *pThis,const
 	if (pInput) {
 		MemoryManagerHandle *pSelf = static_cast<MemoryManagerHandle *>(pThis);
 		PointerPrefix_t *pData = static_cast<PointerPrefix_t *>(const_cast<void *>(pInput))-1;
-		BURGER_ASSERT(pData->m_uSignature==SANITYCHECK);
-		pData->m_uSignature=KILLSANITYCHECK;
-		pSelf->FreeHandle(pData->m_ppParentHandle);
+		if (pData->m_uSignature==SLABCHECK) {
+			pSelf->FreeSlabBlock(pData);
+		} else {
+			BURGER_ASSERT(pData->m_uSignature==SANITYCHECK);
+			pData->m_uSignature=KILLSANITYCHECK;
+			pSelf->FreeHandle(pData->m_ppParentHandle);
+		}
 	}
 }
 
@@ -181,9 +264,25 @@ void *BURGER_API Burger::MemoryManagerHandle::ReallocProc(Burger::MemoryManager
 		pInput = NULL;
 	} else {
 	
+		PointerPrefix_t *pData = static_cast<PointerPrefix_t *>(const_cast<void *>(pInput))-1;
+
+		// Small blocks don't move, so get a new block and copy
+		if (pData->m_uSignature==SLABCHECK) {
+			WordPtr uOldSize = reinterpret_cast<const Slab_t *>(pData->m_ppParentHandle)->m_uBlockSize;
+			// Does it still fit?
+			if (uSize>uOldSize || (uSize<=(uOldSize>>1U) && uOldSize>SLABMINIMUMSIZE)) {
+				void *pNew = AllocProc(pSelf,uSize);
+				if (pNew) {
+					MemoryCopy(pNew,pInput,(uSize<uOldSize) ? uSize : uOldSize);
+					pSelf->FreeSlabBlock(pData);
+				}
+				pInput = pNew;
+			}
+			return const_cast<void *>(pInput);
+		}
+
 		// Convert the pointer back into a handle and perform the resize operation
 
-		PointerPrefix_t *pData = static_cast<PointerPrefix_t *>(const_cast<void *>(pInput))-1;
 		BURGER_ASSERT(pData->m_uSignature==SANITYCHECK);
 		pData->m_uSignature=KILLSANITYCHECK;
 		void **ppData = pSelf->ReallocHandle(pData->m_ppParentHandle,uSize+sizeof(PointerPrefix_t));
@@ -215,7 +314,7 @@ void *BURGER_API Burger::MemoryManagerHandle::ReallocProc(Burger::MemoryManager
 void BURGER_API Burger::MemoryManagerHandle::ShutdownProc(MemoryManager *pThis)
 {
 	MemoryManagerHandle *pSelf = static_cast<MemoryManagerHandle *>(pThis);
-	pSelf->m_Lock.Lock();
+	pSelf->LockManager();
 	// For debugging, test if all the memory is already released.
 	// If not, report it
 
@@ -236,9 +335,187 @@ void BURGER_API Burger::MemoryManagerHandle::ShutdownProc(MemoryManager *pThis)
 	}
 	pSelf->m_pFreeHandle = NULL;
 	pSelf->m_MemPurgeCallBack = NULL;
+	pSelf->m_pCompactCursor = NULL;
+
+	// The slabs were in the system memory that was just released
+	Word i = 0;
+	do {
+		SlabClass_t *pClass = &pSelf->m_SlabClasses[i];
+		pClass->m_pPartial = NULL;
+		pClass->m_Stats.m_uInUse = 0;
+		pClass->m_Stats.m_uSlabCount = 0;
+	} while (++i<SLABCLASSCOUNT);
 	pSelf->m_Lock.Unlock();
 }
 
+/*! ************************************
+
+	\brief Allocate a block of memory from a size class
+
+	Find the size class for the request and take a free block
+	from a slab of that class, creating a new slab if needed.
+	Only the lock for the size class is held while the free
+	lists are updated, so small allocations don't contend
+	with the handle chain or with other size classes.
+
+	\param uSize Number of bytes to allocate, must be 1 to \ref SLABMAXIMUMSIZE
+	\return Pointer to the memory or \ref NULL if a new slab couldn't be allocated
+	\sa FreeSlabBlock(void *)
+
+***************************************/
+
+void *BURGER_API Burger::MemoryManagerHandle::AllocSlabBlock(WordPtr uSize)
+{
+	Word uClass = g_SlabClassTable[(uSize-1)/SLABMINIMUMSIZE];
+	SlabClass_t *pClass = &m_SlabClasses[uClass];
+	LockSlabClass(pClass);
+	Slab_t *pSlab = pClass->m_pPartial;
+	if (pSlab) {
+		++pClass->m_Stats.m_uHits;
+	} else {
+		// Don't hold the lock while allocating, the
+		// garbage collector could call back to release memory
+		pClass->m_Lock.Unlock();
+		void **ppHandle = AllocHandle(SLABSIZE,FIXED);
+		if (!ppHandle) {
+			return NULL;
+		}
+
+		// Create the free list
+		pSlab = static_cast<Slab_t *>(reinterpret_cast<Handle_t *>(ppHandle)->m_pData);
+		WordPtr uBlockSize = pClass->m_Stats.m_uBlockSize;
+		WordPtr uStride = uBlockSize+sizeof(PointerPrefix_t);
+		WordPtr uHeader = (sizeof(Slab_t)+(ALIGNMENT-1))&(~static_cast<WordPtr>(ALIGNMENT-1));
+		Word uTotal = static_cast<Word>((SLABSIZE-uHeader)/uStride);
+		pSlab->m_ppHandle = ppHandle;
+		pSlab->m_uBlockSize = uBlockSize;
+		pSlab->m_uClass = uClass;
+		pSlab->m_uUsed = 0;
+		pSlab->m_uTotal = uTotal;
+		PointerPrefix_t *pBlock = reinterpret_cast<PointerPrefix_t *>(reinterpret_cast<Word8 *>(pSlab)+uHeader);
+		pSlab->m_pFree = pBlock;
+		do {
+			PointerPrefix_t *pNext = reinterpret_cast<PointerPrefix_t *>(reinterpret_cast<Word8 *>(pBlock)+uStride);
+			pBlock->m_ppParentHandle = reinterpret_cast<void **>(pSlab);
+			pBlock->m_uSignature = KILLSANITYCHECK;
+			reinterpret_cast<PointerPrefix_t **>(pBlock+1)[0] = (uTotal!=1) ? pNext : NULL;
+			pBlock = pNext;
+		} while (--uTotal);
+
+		// Link it in
+		LockSlabClass(pClass);
+		Slab_t *pFirst = pClass->m_pPartial;
+		pSlab->m_pNext = pFirst;
+		pSlab->m_pPrev = NULL;
+		if (pFirst) {
+			pFirst->m_pPrev = pSlab;
+		}
+		pClass->m_pPartial = pSlab;
+		++pClass->m_Stats.m_uMisses;
+		++pClass->m_Stats.m_uSlabCount;
+	}
+
+	// Take a block
+	PointerPrefix_t *pBlock = pSlab->m_pFree;
+	pSlab->m_pFree = reinterpret_cast<PointerPrefix_t **>(pBlock+1)[0];
+	// Out of blocks? Remove from the partial list
+	if (++pSlab->m_uUsed==pSlab->m_uTotal) {
+		Slab_t *pNext = pSlab->m_pNext;
+		pClass->m_pPartial = pNext;
+		if (pNext) {
+			pNext->m_pPrev = NULL;
+		}
+	}
+	++pClass->m_Stats.m_uInUse;
+	pClass->m_Lock.Unlock();
+	pBlock->m_uSignature = SLABCHECK;
+	return pBlock+1;
+}
+
+/*! ************************************
+
+	\brief Release a block of memory back to its size class
+
+	Return the block to its slab. If the slab is now empty and
+	the size class has other slabs with free blocks, the slab
+	is returned to the handle based memory pool.
+
+	\param pInput Pointer to the PointerPrefix_t of the block to release
+	\sa AllocSlabBlock(WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::FreeSlabBlock(void *pInput)
+{
+	PointerPrefix_t *pBlock = static_cast<PointerPrefix_t *>(pInput);
+	pBlock->m_uSignature = KILLSANITYCHECK;
+	Slab_t *pSlab = reinterpret_cast<Slab_t *>(pBlock->m_ppParentHandle);
+	SlabClass_t *pClass = &m_SlabClasses[pSlab->m_uClass];
+	LockSlabClass(pClass);
+	reinterpret_cast<PointerPrefix_t **>(pBlock+1)[0] = pSlab->m_pFree;
+	pSlab->m_pFree = pBlock;
+	// Was it full? Put it back in the partial list
+	if (pSlab->m_uUsed==pSlab->m_uTotal) {
+		Slab_t *pFirst = pClass->m_pPartial;
+		pSlab->m_pNext = pFirst;
+		pSlab->m_pPrev = NULL;
+		if (pFirst) {
+			pFirst->m_pPrev = pSlab;
+		}
+		pClass->m_pPartial = pSlab;
+	}
+	++pClass->m_Stats.m_uFrees;
+	--pClass->m_Stats.m_uInUse;
+	void **ppRelease = NULL;
+	// Keep a single empty slab to prevent thrashing
+	if (!--pSlab->m_uUsed && ((pClass->m_pPartial!=pSlab) || pSlab->m_pNext)) {
+		Slab_t *pNext = pSlab->m_pNext;
+		Slab_t *pPrev = pSlab->m_pPrev;
+		if (pNext) {
+			pNext->m_pPrev = pPrev;
+		}
+		if (pPrev) {
+			pPrev->m_pNext = pNext;
+		} else {
+			pClass->m_pPartial = pNext;
+		}
+		--pClass->m_Stats.m_uSlabCount;
+		ppRelease = pSlab->m_ppHandle;
+	}
+	pClass->m_Lock.Unlock();
+	if (ppRelease) {
+		FreeHandle(ppRelease);
+	}
+}
+
+/*! ************************************
+
+	\brief Get the statistics for a small allocation size class
+
+	Copy the counters for a size class so the hit rate of
+	the small block allocator can be monitored. Size class zero
+	holds \ref SLABMINIMUMSIZE byte blocks and each following class
+	is double the size of the previous one.
+
+	\param pOutput Pointer to a SlabStats_t structure to receive the data
+	\param uClass Size class index from 0 to \ref SLABCLASSCOUNT-1
+	\return \ref FALSE if successful, \ref TRUE if the size class is out of range
+
+***************************************/
+
+Word BURGER_API Burger::MemoryManagerHandle::GetSlabStats(SlabStats_t *pOutput,Word uClass)
+{
+	if (uClass>=SLABCLASSCOUNT) {
+		MemoryClear(pOutput,sizeof(SlabStats_t));
+		return TRUE;
+	}
+	SlabClass_t *pClass = &m_SlabClasses[uClass];
+	pClass->m_Lock.Lock();
+	pOutput[0] = pClass->m_Stats;
+	pClass->m_Lock.Unlock();
+	return FALSE;
+}
+
 
 /*! ************************************
 
@@ -616,8 +893,34 @@ Burger::MemoryManagerHandle::MemoryManagerHandle(WordPtr uDefaultMemorySize,Word
 	m_uTotalSystemMemory(0),
 	m_pFreeHandle(NULL),
 	m_uTotalHandleCount(0),
-	m_Lock()
+	m_Lock(),
+	m_pCompactCursor(NULL),
+	m_uCompactByteBudget(DEFAULTCOMPACTBYTES),
+	m_uCompactMicroseconds(DEFAULTCOMPACTMICROSECONDS),
+	m_uBytesMoved(0),
+	m_uHandlesMoved(0),
+	m_uCompactPasses(0),
+	m_uPeakAllocatedMemory(0),
+	m_uAllocationCount(0),
+	m_uFreeCount(0),
+	m_uFailureCount(0),
+	m_uSystemAllocationCount(0),
+	m_uLockCount(0),
+	m_uLockContentionCount(0)
 {
+	MemoryClear(m_Histogram,sizeof(m_Histogram));
+
+	// Initialize the size classes for small allocations
+	Word i = 0;
+	WordPtr uBlockSize = SLABMINIMUMSIZE;
+	do {
+		SlabClass_t *pClass = &m_SlabClasses[i];
+		pClass->m_pPartial = NULL;
+		MemoryClear(&pClass->m_Stats,sizeof(pClass->m_Stats));
+		pClass->m_Stats.m_uBlockSize = uBlockSize;
+		uBlockSize <<= 1U;
+	} while (++i<SLABCLASSCOUNT);
+
 	// Init my global pointers
 	m_pAlloc = AllocProc;
 	m_pFree = FreeProc;
@@ -884,7 +1187,7 @@ void ** BURGER_API Burger::MemoryManagerHandle::AllocHandle(WordPtr uSize,Word u
 	Handle_t *ppResult = NULL;
 	// Don't allocate an empty handle!
 	if (uSize) {
-		m_Lock.Lock();
+		LockManager();
 		// Initialized?
 		if (m_pSystemMemoryBlocks) {
 			// Get a new handle
@@ -931,6 +1234,7 @@ void ** BURGER_API Burger::MemoryManagerHandle::AllocHandle(WordPtr uSize,Word u
 
 									// Update the global allocated memory count.
 									m_uTotalAllocatedMemory += pNew->m_uLength;
+									RecordAllocation(pNew->m_uLength);
 									// Good allocation!
 									m_Lock.Unlock();
 									return reinterpret_cast<void **>(pNew);
@@ -987,6 +1291,7 @@ void ** BURGER_API Burger::MemoryManagerHandle::AllocHandle(WordPtr uSize,Word u
 
 									// Update the global allocated memory count.
 									m_uTotalAllocatedMemory += pNew->m_uLength;
+									RecordAllocation(pNew->m_uLength);
 									// Good allocation!
 									m_Lock.Unlock();
 									return reinterpret_cast<void **>(pNew);
@@ -1043,9 +1348,13 @@ void ** BURGER_API Burger::MemoryManagerHandle::AllocHandle(WordPtr uSize,Word u
 				// Ensure data alignment
 				ppResult->m_pData = reinterpret_cast<void*>((reinterpret_cast<WordPtr>(ppResult)+sizeof(Handle_t)+(ALIGNMENT-1)) & (~(ALIGNMENT-1)));
 				// Return the fake handle
+				RecordAllocation(uSize);
+				++m_uSystemAllocationCount;
+			} else {
+				++m_uFailureCount;
 			}
 		}
-		m_Lock.Lock();
+		m_Lock.Unlock();
 	}
 	return reinterpret_cast<void **>(ppResult);
 }
@@ -1064,7 +1373,8 @@ void BURGER_API Burger::MemoryManagerHandle::FreeHandle(void **ppInput)
 {
 	// Valid handle?
 	if (ppInput) {
-		m_Lock.Lock();
+		LockManager();
+		++m_uFreeCount;
 		// Subtract from global size.
 		Handle_t *pHandle = reinterpret_cast<Handle_t *>(ppInput);
 		m_uTotalAllocatedMemory -= pHandle->m_uLength;
@@ -1092,6 +1402,10 @@ void BURGER_API Burger::MemoryManagerHandle::FreeHandle(void **ppInput)
 				pPrev = pHandle->m_pPrevHandle;
 				pPrev->m_pNextHandle = pNext;
 				pNext->m_pPrevHandle = pPrev;
+				// Don't leave incremental compaction pointing to a dead handle
+				if (m_pCompactCursor==pHandle) {
+					m_pCompactCursor = pNext;
+				}
 				
 				// Release the memory range back into the pool
 				// if there was any memory attached to this handle
@@ -1162,7 +1476,7 @@ void ** BURGER_API Burger::MemoryManagerHandle::ReallocHandle(void **ppInput,Wor
 	if (uSize<uOldSize &&
 		// Not manually allocated?
 		(!(pHandle->m_uFlags & MALLOC))) {
-		m_Lock.Lock();
+		LockManager();
 		pHandle->m_uLength = uSize;		// Set the new size
 		uSize = (uSize+(ALIGNMENT-1))&(~(ALIGNMENT-1));		// Long word align
 		uOldSize = (uOldSize+(ALIGNMENT-1))&(~(ALIGNMENT-1));
@@ -1242,7 +1556,7 @@ void ** BURGER_API Burger::MemoryManagerHandle::RefreshHandle(void **ppInput)
 void ** BURGER_API Burger::MemoryManagerHandle::FindHandle(const void *pInput)
 {
 	// Get the first handle
-	m_Lock.Lock();
+	LockManager();
 	Handle_t *pHandle = m_LowestUsedMemory.m_pNextHandle;
 	void **ppResult = NULL;
 	// Are there handles?
@@ -1303,6 +1617,9 @@ WordPtr BURGER_API Burger::MemoryManagerHandle::GetSize(const void *pInput)
 {
 	if (pInput) {			// Null pointer?!?
 		PointerPrefix_t *pData = static_cast<PointerPrefix_t *>(const_cast<void *>(pInput))-1;
+		if (pData->m_uSignature==SLABCHECK) {
+			return reinterpret_cast<const Slab_t *>(pData->m_ppParentHandle)->m_uBlockSize;
+		}
 		BURGER_ASSERT(pData->m_uSignature==SANITYCHECK);
 		const Handle_t *pHandle = reinterpret_cast<Handle_t *>(pData->m_ppParentHandle);
 		return pHandle->m_uLength;
@@ -1329,7 +1646,7 @@ WordPtr BURGER_API Burger::MemoryManagerHandle::GetTotalFreeMemory(void)
 
 	// Add all the free memory handles
 
-	m_Lock.Lock();
+	LockManager();
 	Handle_t *pHandle = m_FreeMemoryChunks.m_pNextHandle;	// Follow the entire list
 	if (pHandle!=&m_FreeMemoryChunks) {			// List valid?
 		do {
@@ -1532,7 +1849,7 @@ void BURGER_API Burger::MemoryManagerHandle::Purge(void **ppInput)
 		if (m_MemPurgeCallBack) {
 			m_MemPurgeCallBack(m_pMemPurge,StagePurge);	// I will purge now!
 		}
-		m_Lock.Lock();
+		LockManager();
 		pHandle->m_uFlags &= (~LOCKED);		// Force unlocked
 
 		// Unlink from the purge list
@@ -1553,6 +1870,9 @@ void BURGER_API Burger::MemoryManagerHandle::Purge(void **ppInput)
 		pPrev = pHandle->m_pPrevHandle;	// Backward link
 		pNext->m_pPrevHandle = pPrev;	// Unlink me from the list
 		pPrev->m_pNextHandle = pNext;
+		if (m_pCompactCursor==pHandle) {	// Was incremental compaction going to check me?
+			m_pCompactCursor = pNext;
+		}
 
 		// Move to the purged handle list
 		// Don't harm the flags or the length!!
@@ -1587,7 +1907,7 @@ void BURGER_API Burger::MemoryManagerHandle::Purge(void **ppInput)
 Word BURGER_API Burger::MemoryManagerHandle::PurgeHandles(WordPtr uSize)
 {
 	Word uResult = FALSE;
-	m_Lock.Lock();
+	LockManager();
 	// Index to the purgeable handle list
 	Handle_t *pHandle = m_PurgeHandleFiFo.m_pPrevPurge;
 	// No purgeable memory?
@@ -1626,7 +1946,7 @@ Word BURGER_API Burger::MemoryManagerHandle::PurgeHandles(WordPtr uSize)
 
 void BURGER_API Burger::MemoryManagerHandle::CompactHandles(void)
 {
-	m_Lock.Lock();
+	LockManager();
 	// Index to the active handle list
 	Handle_t *pHandle = m_LowestUsedMemory.m_pNextHandle;
 	// Failsafe
@@ -1637,36 +1957,8 @@ void BURGER_API Burger::MemoryManagerHandle::CompactHandles(void)
 			// Valid pointer?
 			bCalledCallBack = FALSE;
 		}
-		// Skip all locked or fixed handles
 		do {
-			if (!(pHandle->m_uFlags & (LOCKED|FIXED))) {
-				// Get the previous handle
-				Handle_t *pPrev = pHandle->m_pPrevHandle;
-				// Pad to long word
-				WordPtr uSize = (pPrev->m_uLength+(ALIGNMENT-1))&(~(ALIGNMENT-1));
-				Word8 *pStartMem = static_cast<Word8 *>(pPrev->m_pData) + uSize;
-				// Any space here?
-				uSize = static_cast<WordPtr>(static_cast<Word8 *>(pHandle->m_pData) - pStartMem);
-				// If there is free space, then pack them
-				if (uSize) {
-					// Hadn't called it yet?
-					if (!bCalledCallBack) {
-						bCalledCallBack = TRUE;
-						// Alert the app
-						m_MemPurgeCallBack(m_pMemPurge,StageCompact);
-					}
-					// Save old address
-					void *pTemp = pHandle->m_pData;
-					// Set new address
-					pHandle->m_pData = pStartMem;	
-					// Release the memory
-					ReleaseMemoryRange(pTemp,pHandle->m_uLength,pPrev);
-					// Grab the memory again
-					GrabMemoryRange(pStartMem,pHandle->m_uLength,pHandle,NULL);
-					// Move the unpadded length
-					MemoryMove(pStartMem,pTemp,pHandle->m_uLength);
-				}
-			}
+			MoveHandleDown(pHandle,&bCalledCallBack);
 			// Next handle in chain
 			pHandle = pHandle->m_pNextHandle;
 		} while (pHandle!=&m_HighestUsedMemory);
@@ -1674,6 +1966,522 @@ void BURGER_API Burger::MemoryManagerHandle::CompactHandles(void)
 	m_Lock.Unlock();
 }
 
+/*! ************************************
+
+	\brief Move a handle's memory down to close a gap
+
+	If the handle is movable and there is free memory between
+	it and the previous handle, move the memory down so it
+	abuts the previous handle. The memory purge callback is
+	called with StageCompact before the first move.
+
+	\note m_Lock must be held when calling this function.
+
+	\param pHandle Pointer to the handle to move
+	\param pCalledCallBack Pointer to a flag that's \ref TRUE if the callback was already called
+	\return Number of bytes moved, zero if the handle was not moved
+	\sa CompactHandles(void) or CompactHandlesIncremental(WordPtr,Word32)
+
+***************************************/
+
+WordPtr BURGER_API Burger::MemoryManagerHandle::MoveHandleDown(Handle_t *pHandle,Word *pCalledCallBack)
+{
+	WordPtr uResult = 0;
+	// Skip all locked or fixed handles
+	if (!(pHandle->m_uFlags & (LOCKED|FIXED))) {
+		// Get the previous handle
+		Handle_t *pPrev = pHandle->m_pPrevHandle;
+		// Pad to long word
+		WordPtr uSize = (pPrev->m_uLength+(ALIGNMENT-1))&(~(ALIGNMENT-1));
+		Word8 *pStartMem = static_cast<Word8 *>(pPrev->m_pData) + uSize;
+		// Any space here?
+		uSize = static_cast<WordPtr>(static_cast<Word8 *>(pHandle->m_pData) - pStartMem);
+		// If there is free space, then pack them
+		if (uSize) {
+			// Hadn't called it yet?
+			if (!pCalledCallBack[0]) {
+				pCalledCallBack[0] = TRUE;
+				// Alert the app
+				m_MemPurgeCallBack(m_pMemPurge,StageCompact);
+			}
+			// Save old address
+			void *pTemp = pHandle->m_pData;
+			// Set new address
+			pHandle->m_pData = pStartMem;	
+			// Release the memory
+			ReleaseMemoryRange(pTemp,pHandle->m_uLength,pPrev);
+			// Grab the memory again
+			GrabMemoryRange(pStartMem,pHandle->m_uLength,pHandle,NULL);
+			// Move the unpadded length
+			MemoryMove(pStartMem,pTemp,pHandle->m_uLength);
+			uResult = pHandle->m_uLength;
+			m_uBytesMoved += uResult;
+			++m_uHandlesMoved;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Compact some of the movable blocks together
+
+	Perform a step of compaction, resuming where the previous step
+	stopped. Unlike CompactHandles(void), which moves every unlocked
+	handle in one call, this stops once uByteBudget bytes
+	were moved or uMicroseconds of time has passed, so the lock
+	that the allocators need is only held for a bounded time.
+
+	Handles that are larger than the byte budget are skipped, since
+	moving them would exceed the budget.
+
+	Memory allocations and releases can occur between steps, the
+	position is kept valid.
+
+	\param uByteBudget Maximum number of bytes to move, zero for no limit
+	\param uMicroseconds Maximum time to spend, zero for no limit
+	\return \ref TRUE if the step finished a pass over all of the handles, \ref FALSE if there is more to do
+	\sa CompactHandles(void), CompactionTask(void *) or GetFragmentationStats(FragmentationStats_t *)
+
+***************************************/
+
+Word BURGER_API Burger::MemoryManagerHandle::CompactHandlesIncremental(WordPtr uByteBudget,Word32 uMicroseconds)
+{
+	Word32 uMark = 0;
+	if (uMicroseconds) {
+		uMark = Tick::ReadMicroseconds();
+	}
+	Word uResult = FALSE;
+	LockManager();
+	Handle_t *pHandle = m_pCompactCursor;
+	// Start a new pass?
+	if (!pHandle) {
+		pHandle = m_LowestUsedMemory.m_pNextHandle;
+	}
+	Word bCalledCallBack = TRUE;		
+	if (m_MemPurgeCallBack) {
+		bCalledCallBack = FALSE;
+	}
+	WordPtr uMoved = 0;
+	while (pHandle!=&m_HighestUsedMemory) {
+		// Handles larger than the budget are never moved
+		if (!uByteBudget || (pHandle->m_uLength<=uByteBudget)) {
+			// Leave it for the next step if it doesn't fit in what's left
+			if (uByteBudget && (pHandle->m_uLength>(uByteBudget-uMoved))) {
+				break;
+			}
+			uMoved += MoveHandleDown(pHandle,&bCalledCallBack);
+		}
+		pHandle = pHandle->m_pNextHandle;
+		// Out of budget?
+		if ((uByteBudget && (uMoved>=uByteBudget)) ||
+			(uMicroseconds && ((Tick::ReadMicroseconds()-uMark)>=uMicroseconds))) {
+			break;
+		}
+	}
+	if (pHandle==&m_HighestUsedMemory) {
+		// Pass complete
+		pHandle = NULL;
+		++m_uCompactPasses;
+		uResult = TRUE;
+	}
+	m_pCompactCursor = pHandle;
+	m_Lock.Unlock();
+	return uResult;
+}
+
+/*! ************************************
+
+	\fn void Burger::MemoryManagerHandle::SetCompactBudget(WordPtr uByteBudget,Word32 uMicroseconds)
+	\brief Set the budget for CompactionTask(void *)
+
+	\param uByteBudget Maximum number of bytes to move per step, zero for no limit
+	\param uMicroseconds Maximum time to spend per step, zero for no limit
+	\sa CompactionTask(void *) or CompactHandlesIncremental(WordPtr,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\brief RunQueue task for incremental compaction
+
+	Add this function to a RunQueue with a pointer to a
+	MemoryManagerHandle as the data pointer to perform a step of
+	compaction every time the RunQueue is called. The budget
+	for each step is set with SetCompactBudget(WordPtr,Word32).
+
+	\code
+	MyRunQueue.Add(MemoryManagerHandle::CompactionTask,NULL,pMemoryManager,RunQueue::PRIORITY_LOW);
+	\endcode
+
+	\param pThis Pointer to the MemoryManagerHandle to compact
+	\return RunQueue::OKAY
+	\sa CompactHandlesIncremental(WordPtr,Word32)
+
+***************************************/
+
+Burger::RunQueue::eReturnCode BURGER_API Burger::MemoryManagerHandle::CompactionTask(void *pThis)
+{
+	MemoryManagerHandle *pSelf = static_cast<MemoryManagerHandle *>(pThis);
+	pSelf->CompactHandlesIncremental(pSelf->m_uCompactByteBudget,pSelf->m_uCompactMicroseconds);
+	return RunQueue::OKAY;
+}
+
+/*! ************************************
+
+	\brief Get the state of memory fragmentation
+
+	Scan the free memory list and report the total free
+	memory, the largest free block and the number of free blocks,
+	along with the totals for work performed by compaction.
+
+	Fragmentation is reported as the percentage of free memory
+	that is not in the largest free block, 0 means all free memory
+	is contiguous.
+
+	\param pOutput Pointer to a FragmentationStats_t to receive the data
+	\sa CompactHandlesIncremental(WordPtr,Word32)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::GetFragmentationStats(FragmentationStats_t *pOutput)
+{
+	WordPtr uFree = 0;
+	WordPtr uLargest = 0;
+	WordPtr uCount = 0;
+	LockManager();
+	const Handle_t *pHandle = m_FreeMemoryChunks.m_pNextHandle;
+	while (pHandle!=&m_FreeMemoryChunks) {
+		WordPtr uLength = pHandle->m_uLength;
+		uFree += uLength;
+		if (uLength>uLargest) {
+			uLargest = uLength;
+		}
+		++uCount;
+		pHandle = pHandle->m_pNextHandle;
+	}
+	pOutput->m_uBytesMoved = m_uBytesMoved;
+	pOutput->m_uHandlesMoved = m_uHandlesMoved;
+	pOutput->m_uCompactPasses = m_uCompactPasses;
+	m_Lock.Unlock();
+	pOutput->m_uFreeMemory = uFree;
+	pOutput->m_uLargestFreeBlock = uLargest;
+	pOutput->m_uFreeBlockCount = uCount;
+	Word uFragmentation = 0;
+	if (uFree) {
+		WordPtr uWasted = uFree-uLargest;
+		// Prevent overflow in the percentage calculation
+		while (uFree>(BURGER_MAXWORDPTR/100U)) {
+			uFree >>= 1U;
+			uWasted >>= 1U;
+		}
+		uFragmentation = static_cast<Word>((uWasted*100U)/uFree);
+	}
+	pOutput->m_uFragmentation = uFragmentation;
+}
+
+/*! ************************************
+
+	\brief Lock the memory manager
+
+	Acquire m_Lock and update the lock counters. If the lock
+	is held by another thread, the contention counter is incremented
+	before waiting. The counters are only modified while the lock
+	is held so they don't need atomic operations.
+
+	\sa GetAllocationStats(AllocationStats_t *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::LockManager(void)
+{
+	if (!m_Lock.TryLock()) {
+		m_Lock.Lock();
+		++m_uLockContentionCount;
+	}
+	++m_uLockCount;
+}
+
+/*! ************************************
+
+	\brief Lock a small allocation size class
+
+	Acquire the lock for a size class and update the
+	contention counter if another thread held the lock.
+
+	\param pClass Pointer to the size class to lock
+	\sa GetSlabStats(SlabStats_t *,Word)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::LockSlabClass(SlabClass_t *pClass)
+{
+	if (!pClass->m_Lock.TryLock()) {
+		pClass->m_Lock.Lock();
+		++pClass->m_Stats.m_uLockContentions;
+	}
+}
+
+/*! ************************************
+
+	\brief Update the statistics for a handle allocation
+
+	Increment the allocation count, update the peak memory usage
+	and add the allocation to the size histogram.
+
+	\note m_Lock must be held when calling this function.
+
+	\param uSize Size of the allocation in bytes
+	\sa GetAllocationStats(AllocationStats_t *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::RecordAllocation(WordPtr uSize)
+{
+	++m_uAllocationCount;
+	if (m_uTotalAllocatedMemory>m_uPeakAllocatedMemory) {
+		m_uPeakAllocatedMemory = m_uTotalAllocatedMemory;
+	}
+	// Find the highest set bit for the histogram
+	Word uBucket = 0;
+	uSize >>= 1U;
+	while (uSize && (uBucket<(STATSHISTOGRAMCOUNT-1))) {
+		uSize >>= 1U;
+		++uBucket;
+	}
+	++m_Histogram[uBucket];
+}
+
+/*! ************************************
+
+	\brief Take a snapshot of the allocation statistics
+
+	Copy all of the counters and scan the used handle list
+	to total the live handles and bytes by their ID. Handle IDs
+	are set with SetID(void **,Word). IDs of \ref STATSIDCOUNT-1
+	and higher, including handles that never had an ID set,
+	are totaled in the last entry of m_IDStats.
+
+	The counters are updated while the lock is already held
+	for the allocation, so they are cheap enough to leave active in
+	release builds. Only this function walks the handle list.
+
+	\param pOutput Pointer to an AllocationStats_t to receive the snapshot
+	\sa ExportStats(OutputMemoryStream *) or ResetAllocationStats(void)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::GetAllocationStats(AllocationStats_t *pOutput)
+{
+	MemoryClear(pOutput->m_IDStats,sizeof(pOutput->m_IDStats));
+	LockManager();
+	pOutput->m_uTotalAllocatedMemory = m_uTotalAllocatedMemory;
+	pOutput->m_uPeakAllocatedMemory = m_uPeakAllocatedMemory;
+	pOutput->m_uTotalSystemMemory = m_uTotalSystemMemory;
+	pOutput->m_uAllocations = m_uAllocationCount;
+	pOutput->m_uFrees = m_uFreeCount;
+	pOutput->m_uFailures = m_uFailureCount;
+	pOutput->m_uSystemAllocations = m_uSystemAllocationCount;
+	pOutput->m_uLockCount = m_uLockCount;
+	pOutput->m_uLockContentions = m_uLockContentionCount;
+	MemoryCopy(pOutput->m_Histogram,m_Histogram,sizeof(m_Histogram));
+	const Handle_t *pHandle = m_LowestUsedMemory.m_pNextHandle;
+	while (pHandle!=&m_HighestUsedMemory) {
+		Word uID = pHandle->m_uID;
+		if (uID>=(STATSIDCOUNT-1)) {
+			uID = STATSIDCOUNT-1;
+		}
+		++pOutput->m_IDStats[uID].m_uHandleCount;
+		pOutput->m_IDStats[uID].m_uBytes += pHandle->m_uLength;
+		pHandle = pHandle->m_pNextHandle;
+	}
+	m_Lock.Unlock();
+}
+
+/*! ************************************
+
+	\brief Reset the allocation statistics
+
+	Clear the allocation, release, failure and lock counters,
+	the size histogram and set the peak memory usage
+	to the current memory usage.
+
+	\sa GetAllocationStats(AllocationStats_t *)
+
+***************************************/
+
+void BURGER_API Burger::MemoryManagerHandle::ResetAllocationStats(void)
+{
+	LockManager();
+	m_uPeakAllocatedMemory = m_uTotalAllocatedMemory;
+	m_uAllocationCount = 0;
+	m_uFreeCount = 0;
+	m_uFailureCount = 0;
+	m_uSystemAllocationCount = 0;
+	m_uLockCount = 0;
+	m_uLockContentionCount = 0;
+	MemoryClear(m_Histogram,sizeof(m_Histogram));
+	m_Lock.Unlock();
+}
+
+/*! ************************************
+
+	\brief Append "key":value to a stream
+
+	\param pOutput Pointer to the stream to append to
+	\param pKey Name of the value
+	\param uValue Integer to output
+
+***************************************/
+
+static void BURGER_API AppendStat(Burger::OutputMemoryStream *pOutput,const char *pKey,WordPtr uValue)
+{
+	pOutput->Append('"');
+	pOutput->Append(pKey);
+	pOutput->Append("\":");
+	pOutput->AppendAscii(static_cast<Word64>(uValue));
+}
+
+/*! ************************************
+
+	\brief Export a snapshot of the statistics in JSON format
+
+	Take a snapshot with GetAllocationStats(AllocationStats_t *),
+	GetFragmentationStats(FragmentationStats_t *) and
+	GetSlabStats(SlabStats_t *,Word) and append it to the stream
+	as a single JSON object so it can be logged or parsed by tools.
+
+	Handle IDs with no live handles are not output. The ID
+	"other" holds all handles with an ID of \ref STATSIDCOUNT-1 or higher.
+
+	\param pOutput Pointer to the stream to receive the text
+	\return Zero if no error, non-zero if the stream ran out of memory
+	\sa GetAllocationStats(AllocationStats_t *)
+
+***************************************/
+
+Word BURGER_API Burger::MemoryManagerHandle::ExportStats(OutputMemoryStream *pOutput)
+{
+	// Take the snapshots before writing, the stream may allocate memory
+	AllocationStats_t Stats;
+	GetAllocationStats(&Stats);
+	FragmentationStats_t Fragmentation;
+	GetFragmentationStats(&Fragmentation);
+
+	pOutput->Append('{');
+	AppendStat(pOutput,"allocated",Stats.m_uTotalAllocatedMemory);
+	pOutput->Append(',');
+	AppendStat(pOutput,"peak",Stats.m_uPeakAllocatedMemory);
+	pOutput->Append(',');
+	AppendStat(pOutput,"system",Stats.m_uTotalSystemMemory);
+	pOutput->Append(',');
+	AppendStat(pOutput,"allocations",Stats.m_uAllocations);
+	pOutput->Append(',');
+	AppendStat(pOutput,"frees",Stats.m_uFrees);
+	pOutput->Append(',');
+	AppendStat(pOutput,"failures",Stats.m_uFailures);
+	pOutput->Append(',');
+	AppendStat(pOutput,"systemallocations",Stats.m_uSystemAllocations);
+	pOutput->Append(',');
+	AppendStat(pOutput,"locks",Stats.m_uLockCount);
+	pOutput->Append(',');
+	AppendStat(pOutput,"contentions",Stats.m_uLockContentions);
+
+	pOutput->Append(",\"histogram\":[");
+	Word i = 0;
+	do {
+		if (i) {
+			pOutput->Append(',');
+		}
+		pOutput->AppendAscii(static_cast<Word64>(Stats.m_Histogram[i]));
+	} while (++i<STATSHISTOGRAMCOUNT);
+
+	pOutput->Append("],\"ids\":{");
+	Word bComma = FALSE;
+	i = 0;
+	do {
+		const IDStats_t *pID = &Stats.m_IDStats[i];
+		if (pID->m_uHandleCount) {
+			if (bComma) {
+				pOutput->Append(',');
+			}
+			bComma = TRUE;
+			pOutput->Append('"');
+			if (i==(STATSIDCOUNT-1)) {
+				pOutput->Append("other");
+			} else {
+				pOutput->AppendAscii(static_cast<Word32>(i));
+			}
+			pOutput->Append("\":{");
+			AppendStat(pOutput,"handles",pID->m_uHandleCount);
+			pOutput->Append(',');
+			AppendStat(pOutput,"bytes",pID->m_uBytes);
+			pOutput->Append('}');
+		}
+	} while (++i<STATSIDCOUNT);
+
+	pOutput->Append("},\"slabs\":[");
+	i = 0;
+	do {
+		SlabStats_t Slab;
+		GetSlabStats(&Slab,i);
+		if (i) {
+			pOutput->Append(',');
+		}
+		pOutput->Append('{');
+		AppendStat(pOutput,"size",Slab.m_uBlockSize);
+		pOutput->Append(',');
+		AppendStat(pOutput,"hits",Slab.m_uHits);
+		pOutput->Append(',');
+		AppendStat(pOutput,"misses",Slab.m_uMisses);
+		pOutput->Append(',');
+		AppendStat(pOutput,"frees",Slab.m_uFrees);
+		pOutput->Append(',');
+		AppendStat(pOutput,"inuse",Slab.m_uInUse);
+		pOutput->Append(',');
+		AppendStat(pOutput,"slabs",Slab.m_uSlabCount);
+		pOutput->Append(',');
+		AppendStat(pOutput,"contentions",Slab.m_uLockContentions);
+		pOutput->Append('}');
+	} while (++i<SLABCLASSCOUNT);
+
+	pOutput->Append("],\"fragmentation\":{");
+	AppendStat(pOutput,"free",Fragmentation.m_uFreeMemory);
+	pOutput->Append(',');
+	AppendStat(pOutput,"largest",Fragmentation.m_uLargestFreeBlock);
+	pOutput->Append(',');
+	AppendStat(pOutput,"blocks",Fragmentation.m_uFreeBlockCount);
+	pOutput->Append(',');
+	AppendStat(pOutput,"percent",Fragmentation.m_uFragmentation);
+	pOutput->Append(',');
+	AppendStat(pOutput,"bytesmoved",Fragmentation.m_uBytesMoved);
+	pOutput->Append(',');
+	AppendStat(pOutput,"handlesmoved",Fragmentation.m_uHandlesMoved);
+	pOutput->Append(',');
+	AppendStat(pOutput,"passes",Fragmentation.m_uCompactPasses);
+	return pOutput->Append("}}");
+}
+
+/*! ************************************
+
+	\struct Burger::MemoryManagerHandle::IDStats_t
+	\brief Live handle totals for a handle ID
+
+	\sa AllocationStats_t or SetID(void **,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::MemoryManagerHandle::AllocationStats_t
+	\brief Snapshot of the allocation statistics
+
+	Filled in by GetAllocationStats(AllocationStats_t *).
+
+	\sa ExportStats(OutputMemoryStream *)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Display all the memory
@@ -1684,7 +2492,7 @@ void BURGER_API Burger::MemoryManagerHandle::CompactHandles(void)
 
 void BURGER_API Burger::MemoryManagerHandle::DumpHandles(void)
 {
-	m_Lock.Lock();
+	LockManager();
 	WordPtr uSize = GetTotalFreeMemory();
 	Debug::String("Total free memory with purging ");
 	Debug::String(uSize);
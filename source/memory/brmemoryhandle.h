@@ -26,8 +26,13 @@
 #include "brcriticalsection.h"
 #endif
 
+#ifndef __BRRUNQUEUE_H__
+#include "brrunqueue.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
+class OutputMemoryStream;
 class MemoryManagerHandle : public MemoryManager {
 	BURGER_DISABLECOPYCONSTRUCTORS(MemoryManagerHandle);
 public:
@@ -43,6 +48,14 @@ public:
 		MEMORYIDUNUSED=0xFFFDU,			///< Free handle ID
 		MEMORYIDFREE=0xFFFEU,			///< Internal free memory ID
 		MEMORYIDRESERVED=0xFFFFU,		///< Immutable handle ID
+		SLABCLASSCOUNT=8,				///< Number of size classes for small allocations
+		SLABMINIMUMSIZE=16,				///< Size of the smallest size class
+		SLABMAXIMUMSIZE=2048,			///< Largest allocation serviced by the size classes
+		SLABSIZE=0x10000,				///< Size of each slab of small allocations
+		DEFAULTCOMPACTBYTES=0x40000,	///< Default number of bytes moved by each step of incremental compaction
+		DEFAULTCOMPACTMICROSECONDS=500,	///< Default time limit for each step of incremental compaction
+		STATSIDCOUNT=32,				///< Number of handle IDs tracked by GetAllocationStats()
+		STATSHISTOGRAMCOUNT=32,			///< Number of power of two size buckets in the allocation histogram
 		// ALIGNMENT cannot be smaller than sizeof(void *)
 #if defined(BURGER_MSDOS) || defined(BURGER_DS) || defined(BURGER_68K)
 		ALIGNMENT=4			///< Default memory alignment
@@ -57,6 +70,41 @@ public:
 		StageGiveup			///< Critical memory stage, release all possibly freeable memory
 	};
 	typedef void (BURGER_API *MemPurgeProc)(void *pThis,eMemoryStage eStage);	///< Function prototype for user supplied garbage collection subroutine
+	struct SlabStats_t {
+		WordPtr m_uBlockSize;		///< Largest allocation serviced by this size class
+		WordPtr m_uHits;			///< Allocations serviced from a slab that had free blocks
+		WordPtr m_uMisses;			///< Allocations that needed a new slab
+		WordPtr m_uFrees;			///< Number of blocks released
+		WordPtr m_uInUse;			///< Number of blocks currently allocated
+		WordPtr m_uSlabCount;		///< Number of slabs owned by this size class
+		WordPtr m_uLockContentions;	///< Number of times the size class lock was already held by another thread
+	};
+	struct IDStats_t {
+		WordPtr m_uHandleCount;		///< Number of handles with this ID
+		WordPtr m_uBytes;			///< Number of bytes allocated to handles with this ID
+	};
+	struct AllocationStats_t {
+		WordPtr m_uTotalAllocatedMemory;	///< Bytes currently allocated by handles
+		WordPtr m_uPeakAllocatedMemory;		///< Highest value of m_uTotalAllocatedMemory
+		WordPtr m_uTotalSystemMemory;		///< Bytes obtained from the operating system
+		WordPtr m_uAllocations;				///< Number of handles allocated
+		WordPtr m_uFrees;					///< Number of handles released
+		WordPtr m_uFailures;				///< Number of failed handle allocations
+		WordPtr m_uSystemAllocations;		///< Number of handles that had to be allocated from the operating system
+		WordPtr m_uLockCount;				///< Number of times the memory manager was locked
+		WordPtr m_uLockContentions;			///< Number of times the lock was already held by another thread
+		WordPtr m_Histogram[STATSHISTOGRAMCOUNT];	///< Handle allocations by size, entry n counts sizes from 2^n to (2^(n+1))-1
+		IDStats_t m_IDStats[STATSIDCOUNT];	///< Live handles by ID, the last entry holds all IDs that are STATSIDCOUNT-1 or higher
+	};
+	struct FragmentationStats_t {
+		WordPtr m_uFreeMemory;		///< Total bytes in the free memory list
+		WordPtr m_uLargestFreeBlock;	///< Size of the largest free memory block
+		WordPtr m_uFreeBlockCount;	///< Number of free memory blocks
+		WordPtr m_uBytesMoved;		///< Total bytes moved by compaction
+		WordPtr m_uHandlesMoved;	///< Total number of handles moved by compaction
+		WordPtr m_uCompactPasses;	///< Number of completed incremental compaction passes
+		Word m_uFragmentation;		///< Percentage of free memory not in the largest free block
+	};
 private:
 	struct Handle_t {
 		void *m_pData;				///< Pointer to true memory (Must be the first entry!)
@@ -71,6 +119,12 @@ private:
 	struct SystemBlock_t {
 		SystemBlock_t *m_pNext;		///< Next block in the chain
 	};
+	struct Slab_t;
+	struct SlabClass_t {
+		Slab_t *m_pPartial;			///< Slabs with at least one free block
+		SlabStats_t m_Stats;		///< Statistics for this size class
+		CriticalSection m_Lock;		///< Lock for this size class
+	};
 	SystemBlock_t *m_pSystemMemoryBlocks;	///< Linked list of memory blocks taken from the system
 	MemPurgeProc m_MemPurgeCallBack;	///< Callback before memory purging
 	void *m_pMemPurge;					///< User pointer for memory purge
@@ -85,6 +139,22 @@ private:
 	Handle_t m_PurgeHands;			///< Purged handle list
 	Handle_t m_PurgeHandleFiFo;		///< Purged handle linked list
 	CriticalSection m_Lock;			///< Lock for multithreading support
+	SlabClass_t m_SlabClasses[SLABCLASSCOUNT];	///< Size classes for small allocations
+	Handle_t *m_pCompactCursor;		///< Next handle to examine for incremental compaction, \ref NULL to start a new pass
+	WordPtr m_uCompactByteBudget;	///< Bytes to move for each step of incremental compaction
+	Word32 m_uCompactMicroseconds;	///< Time limit for each step of incremental compaction
+	WordPtr m_uBytesMoved;			///< Total bytes moved by compaction
+	WordPtr m_uHandlesMoved;		///< Total number of handles moved by compaction
+	WordPtr m_uCompactPasses;		///< Number of completed incremental compaction passes
+	WordPtr m_uPeakAllocatedMemory;	///< Highest value of m_uTotalAllocatedMemory
+	WordPtr m_uAllocationCount;		///< Number of handles allocated
+	WordPtr m_uFreeCount;			///< Number of handles released
+	WordPtr m_uFailureCount;		///< Number of failed handle allocations
+	WordPtr m_uSystemAllocationCount;	///< Number of handles allocated from the operating system
+	WordPtr m_uLockCount;			///< Number of times m_Lock was acquired
+	WordPtr m_uLockContentionCount;	///< Number of times m_Lock was held by another thread
+	WordPtr m_Histogram[STATSHISTOGRAMCOUNT];	///< Handle allocations by power of two size
+	static const Word8 g_SlabClassTable[SLABMAXIMUMSIZE/SLABMINIMUMSIZE];
 	static void *BURGER_API AllocProc(MemoryManager *pThis,WordPtr uSize);
 	static void BURGER_API FreeProc(MemoryManager *pThis,const void *pInput);
 	static void *BURGER_API ReallocProc(MemoryManager *pThis,const void *pInput,WordPtr uSize);
@@ -93,6 +163,12 @@ private:
 	void BURGER_API GrabMemoryRange(void *pData,WordPtr uLength,Handle_t *pParent,Handle_t *pHandle);
 	void BURGER_API ReleaseMemoryRange(void *pData,WordPtr uLength,Handle_t *pParent);
 	void BURGER_API PrintHandles(const Handle_t *pFirst,const Handle_t *pLast,Word bNoCheck);
+	void *BURGER_API AllocSlabBlock(WordPtr uSize);
+	void BURGER_API FreeSlabBlock(void *pInput);
+	WordPtr BURGER_API MoveHandleDown(Handle_t *pHandle,Word *pCalledCallBack);
+	void BURGER_API LockManager(void);
+	static void BURGER_API LockSlabClass(SlabClass_t *pClass);
+	void BURGER_API RecordAllocation(WordPtr uSize);
 public:
 	MemoryManagerHandle(WordPtr uDefaultMemorySize=DEFAULTMEMORYCHUNK,Word uDefaultHandleCount=DEFAULTHANDLECOUNT,WordPtr uMinReserveSize=DEFAULTMINIMUMRESERVE);
 	~MemoryManagerHandle();
@@ -118,7 +194,16 @@ public:
 	void BURGER_API Purge(void **ppInput);
 	Word BURGER_API PurgeHandles(WordPtr uSize);
 	void BURGER_API CompactHandles(void);
+	Word BURGER_API CompactHandlesIncremental(WordPtr uByteBudget,Word32 uMicroseconds=0);
+	BURGER_INLINE void SetCompactBudget(WordPtr uByteBudget,Word32 uMicroseconds) { m_uCompactByteBudget = uByteBudget; m_uCompactMicroseconds = uMicroseconds; }
+	static RunQueue::eReturnCode BURGER_API CompactionTask(void *pThis);
+	void BURGER_API GetFragmentationStats(FragmentationStats_t *pOutput);
+	BURGER_INLINE WordPtr GetPeakAllocatedMemory(void) const { return m_uPeakAllocatedMemory; }
+	void BURGER_API GetAllocationStats(AllocationStats_t *pOutput);
+	void BURGER_API ResetAllocationStats(void);
+	Word BURGER_API ExportStats(OutputMemoryStream *pOutput);
 	void BURGER_API DumpHandles(void);
+	Word BURGER_API GetSlabStats(SlabStats_t *pOutput,Word uClass);
 };
 class MemoryManagerGlobalHandle : public MemoryManagerHandle {
 	BURGER_DISABLECOPYCONSTRUCTORS(MemoryManagerGlobalHandle);
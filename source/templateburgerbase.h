@@ -105,9 +105,13 @@
 #include "brwin1252.h"
 #include "bratomic.h"
 #include "brcriticalsection.h"
+#include "brdoublylinkedlist.h"
+#include "brrunqueue.h"
+#include "brjobscheduler.h"
 #include "brmemorymanager.h"
 #include "brmemoryansi.h"
 #include "brmemoryhandle.h"
+#include "brmemoryarena.h"
 #include "brglobalmemorymanager.h"
 #include "brstringfunctions.h"
 #include "brutf8.h"
@@ -124,6 +128,7 @@
 #include "brcrc32.h"
 #include "brsdbmhash.h"
 #include "brdjb2hash.h"
+#include "brxxhash.h"
 #include "brmd2.h"
 #include "brmd4.h"
 #include "brmd5.h"
@@ -135,6 +140,8 @@
 #include "brstring.h"
 #include "brstring16.h"
 #include "brhashmap.h"
+#include "brhashmapflat.h"
+#include "brhashmapconcurrent.h"
 #include "brfixedpoint.h"
 #include "brfloatingpoint.h"
 #include "brvector2d.h"
@@ -147,7 +154,7 @@
 #include "brmatrix4d.h"
 #include "brfixedmatrix3d.h"
 #include "brfixedmatrix4d.h"
-#include "brdoublylinkedlist.h"
+#include "brfrustum.h"
 #include "brlinkedlistpointer.h"
 #include "brlinkedlistobject.h"
 #include "brnumberstring.h"
@@ -164,7 +171,6 @@
 #include "brdirectorysearch.h"
 #include "brdosextender.h"
 #include "brautorepeat.h"
-#include "brrunqueue.h"
 #include "brdetectmultilaunch.h"
 #include "broscursor.h"
 #include "brpoint2d.h"
@@ -176,10 +182,13 @@
 #include "brcompresslbmrle.h"
 #include "brcompresslzss.h"
 #include "brcompressdeflate.h"
+#include "brcompressdeflateparallel.h"
+#include "brcompresslz4.h"
 #include "brdecompress.h"
 #include "brdecompresslbmrle.h"
 #include "brdecompresslzss.h"
 #include "brdecompressdeflate.h"
+#include "brdecompresslz4.h"
 #include "brrezfile.h"
 #include "brgameapp.h"
 #include "brrenderer.h"
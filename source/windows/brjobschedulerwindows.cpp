@@ -0,0 +1,39 @@
+/***************************************
+
+	Work stealing job scheduler, Windows version
+
+	Copyright (c) 1995-2017 by Rebecca Ann Heineman <becky@burgerbecky.com>
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brjobscheduler.h"
+
+#if defined(BURGER_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+/***************************************
+
+	Return the number of logical processors
+
+***************************************/
+
+Word BURGER_API Burger::JobScheduler::GetCPUCount(void)
+{
+	SYSTEM_INFO Info;
+	GetSystemInfo(&Info);
+	Word uCount = static_cast<Word>(Info.dwNumberOfProcessors);
+	if (!uCount) {
+		uCount = 1;
+	}
+	return uCount;
+}
+
+#endif
@@ -250,14 +250,15 @@ int BURGER_ANSIAPI main(int argc,const char **argv)
 		iResult |= TestBrfixedpoint(bVerbose);
 		iResult |= TestBrfloatingpoint(bVerbose);
 		iResult |= TestBrhashes(bVerbose);
+		iResult |= TestBrcompression(bVerbose);
+		iResult |= TestBrmatrix3d(bVerbose);
+		iResult |= TestBrmatrix4d(bVerbose);
+		iResult |= FileManagerAsyncTest(bVerbose);
 
 #if 0
 		CreateTables();
-		iResult |= TestBrmatrix3d();
-		iResult |= TestBrmatrix4d();
 		iResult |= TestBrstrings();
 		iResult |= TestBrstaticrtti();
-		iResult |= TestBrcompression();
 		iResult |= TestBrDisplay();
 		iResult |= TestDateTime();
 		iResult |= TestStdoutHelpers(bVerbose);
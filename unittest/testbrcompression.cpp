@@ -18,11 +18,17 @@
 #include "brcompresslzss.h"
 #include "brdecompresslzss.h"
 #include "brcompressdeflate.h"
+#include "brcompressdeflateparallel.h"
 #include "brdecompressdeflate.h"
+#include "brcompresslz4.h"
+#include "brdecompresslz4.h"
 #include "brstringfunctions.h"
 #include "brfixedpoint.h"
 #include "brnumberstringhex.h"
 #include "brmemoryansi.h"
+#include "brglobalmemorymanager.h"
+#include "brjobscheduler.h"
+#include "brtick.h"
 
 using namespace Burger;
 
@@ -704,6 +710,191 @@ static Word TestDeflateDecompress(void)
 }
 
 
+//
+// Create a large buffer of compressible data with a mix of
+// literals, short and long distance matches and runs
+//
+
+static const char *g_DeflateWords[16] = {
+	"burger ","library ","the ","compression ","of ","data ","window ","huffman ",
+	"a ","stream ","decoder ","with ","bits ","and ","literal ","match "
+};
+
+static void FillDeflateBuffer(Word8 *pOutput,WordPtr uLength)
+{
+	Word32 uSeed = 0x12345678U;
+	Word8 *pEnd = pOutput+uLength;
+	while (pOutput<pEnd) {
+		uSeed = (uSeed*1664525U)+1013904223U;
+		Word uSelect = static_cast<Word>(uSeed>>24U);
+		const Word8 *pSource;
+		WordPtr uCount;
+		Word8 Pattern[8];
+		if (uSelect<0xA0) {
+			// Word from the dictionary, lots of matches
+			pSource = reinterpret_cast<const Word8 *>(g_DeflateWords[uSelect&15]);
+			uCount = StringLength(g_DeflateWords[uSelect&15]);
+		} else if (uSelect<0xE0) {
+			// Random noise, mostly literals
+			Pattern[0] = static_cast<Word8>(uSeed>>8U);
+			Pattern[1] = static_cast<Word8>(uSeed>>16U);
+			pSource = Pattern;
+			uCount = 2;
+		} else if (uSelect<0xF0) {
+			// Run of a single byte
+			uCount = ((uSeed>>8U)&0x1FFU)+1;
+			if (uCount>static_cast<WordPtr>(pEnd-pOutput)) {
+				uCount = static_cast<WordPtr>(pEnd-pOutput);
+			}
+			MemoryFill(pOutput,static_cast<Word8>(uSeed>>4U),uCount);
+			pOutput += uCount;
+			continue;
+		} else {
+			// Short repeating pattern
+			Word uPatternLength = ((uSeed>>8U)%7U)+2U;
+			Word i = 0;
+			do {
+				Pattern[i] = static_cast<Word8>(uSeed>>(i+10U));
+			} while (++i<uPatternLength);
+			uCount = ((uSeed>>16U)&0xFFU)+1;
+			do {
+				if (pOutput>=pEnd) {
+					break;
+				}
+				pOutput[0] = Pattern[uCount%uPatternLength];
+				++pOutput;
+			} while (--uCount);
+			continue;
+		}
+		if (uCount>static_cast<WordPtr>(pEnd-pOutput)) {
+			uCount = static_cast<WordPtr>(pEnd-pOutput);
+		}
+		MemoryCopy(pOutput,pSource,uCount);
+		pOutput += uCount;
+	}
+}
+
+//
+// Decompress a stream in chunks of a fixed size
+//
+
+static Decompress::eError DecompressInChunks(Decompress *pDecompress,Word8 *pOutput,WordPtr uOutputLength,const Word8 *pInput,WordPtr uInputLength,WordPtr uOutputStep,WordPtr uInputStep)
+{
+	pDecompress->Reset();
+	Decompress::eError Error;
+	do {
+		WordPtr uOutputChunk = (uOutputLength<uOutputStep) ? uOutputLength : uOutputStep;
+		WordPtr uInputChunk = (uInputLength<uInputStep) ? uInputLength : uInputStep;
+		Error = pDecompress->Process(pOutput,uOutputChunk,pInput,uInputChunk);
+		WordPtr uOutputUsed = pDecompress->GetProcessedOutputSize();
+		WordPtr uInputUsed = pDecompress->GetProcessedInputSize();
+		pOutput += uOutputUsed;
+		uOutputLength -= uOutputUsed;
+		pInput += uInputUsed;
+		uInputLength -= uInputUsed;
+		// Stop on errors or if no progress can be made
+		if ((Error==Decompress::DECOMPRESS_BADINPUT) || (!uOutputUsed && !uInputUsed)) {
+			break;
+		}
+	} while (Error!=Decompress::DECOMPRESS_OKAY);
+	return Error;
+}
+
+//
+// Compare both Deflate decoders on a large stream
+//
+
+static const WordPtr g_DeflateLargeSize = 0x40000;
+
+static Word TestDeflateLarge(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize+80));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+	MemoryFill(pBuffer,0xD5,g_DeflateLargeSize+80);
+
+	CompressDeflate *pCompress = New<CompressDeflate>();
+	pCompress->Process(pRaw,g_DeflateLargeSize);
+	pCompress->Finalize();
+	WordPtr uPackedSize = pCompress->GetOutputSize();
+	Word8 *pPacked = static_cast<Word8 *>(Alloc(uPackedSize));
+	pCompress->GetOutput()->Flatten(pPacked,uPackedSize);
+	Delete(pCompress);
+
+	// Chunk sizes, the first is a single pass
+	static const WordPtr s_Steps[][2] = {
+		{g_DeflateLargeSize,g_DeflateLargeSize},
+		{1021,13},
+		{65536,4099},
+		{7,g_DeflateLargeSize}
+	};
+
+	DecompressDeflate *pTester = New<DecompressDeflate>();
+	Word uWide = 0;
+	do {
+		pTester->SetWideDecoder(uWide);
+		WordPtr i = 0;
+		do {
+			Decompress::eError Error = DecompressInChunks(pTester,pBuffer,g_DeflateLargeSize,pPacked,uPackedSize,s_Steps[i][0],s_Steps[i][1]);
+			if (Error!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("DecompressDeflate::Process() wide %u, output step %u, input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uWide,static_cast<Word>(s_Steps[i][0]),static_cast<Word>(s_Steps[i][1]),Error);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pBuffer,pRaw,g_DeflateLargeSize,"DecompressDeflate::Process(large stream)");
+		} while (++i<BURGER_ARRAYSIZE(s_Steps));
+	} while (++uWide<2);
+
+	Delete(pTester);
+	Free(pPacked);
+	Free(pBuffer);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Display the decode speed of both Deflate decoders
+//
+
+static void TestDeflateSpeed(void)
+{
+	const Word cPasses = 64;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+
+	CompressDeflate *pCompress = New<CompressDeflate>();
+	pCompress->Process(pRaw,g_DeflateLargeSize);
+	pCompress->Finalize();
+	WordPtr uPackedSize = pCompress->GetOutputSize();
+	Word8 *pPacked = static_cast<Word8 *>(Alloc(uPackedSize));
+	pCompress->GetOutput()->Flatten(pPacked,uPackedSize);
+	Delete(pCompress);
+
+	DecompressDeflate *pTester = New<DecompressDeflate>();
+	Word uWide = 0;
+	do {
+		pTester->SetWideDecoder(uWide);
+		Word uCount = cPasses;
+		Burger::FloatTimer Timer;
+		do {
+			pTester->Reset();
+			pTester->Process(pBuffer,g_DeflateLargeSize,pPacked,uPackedSize);
+		} while (--uCount);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		Message("DecompressDeflate %s decoder %u MB/s (%u to %u bytes)",uWide ? "wide" : "original",
+			static_cast<Word>(static_cast<float>(cPasses*g_DeflateLargeSize)/(1048576.0f*fTime)),static_cast<Word>(uPackedSize),static_cast<Word>(g_DeflateLargeSize));
+	} while (++uWide<2);
+
+	Delete(pTester);
+	Free(pPacked);
+	Free(pBuffer);
+	Free(pRaw);
+}
+
 //
 // Test the Deflate Compression
 // Note: Due to the size of the CompressDeflate class (384K),
@@ -800,19 +991,637 @@ static Word TestDeflateCompress(void)
 	return uFailure;
 }
 
+//
+// Compress a buffer, feeding the input in chunks of uInputStep bytes
+//
+
+static Word8 *CompressInChunks(Compress *pCompress,const Word8 *pInput,WordPtr uInputLength,WordPtr uInputStep,WordPtr *pPackedSize)
+{
+	pCompress->Init();
+	while (uInputLength) {
+		WordPtr uChunk = uInputLength;
+		if (uChunk>uInputStep) {
+			uChunk = uInputStep;
+		}
+		pCompress->Process(pInput,uChunk);
+		pInput += uChunk;
+		uInputLength -= uChunk;
+	}
+	pCompress->Finalize();
+	WordPtr uPackedSize = pCompress->GetOutputSize();
+	Word8 *pPacked = static_cast<Word8 *>(Alloc(uPackedSize));
+	pCompress->GetOutput()->Flatten(pPacked,uPackedSize);
+	pPackedSize[0] = uPackedSize;
+	return pPacked;
+}
+
+//
+// Round trip every compression level
+//
+
+static Word TestDeflateLevels(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize+80));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+	MemoryFill(pBuffer,0xD5,g_DeflateLargeSize+80);
+
+	CompressDeflate *pCompress = New<CompressDeflate>();
+	DecompressDeflate *pTester = New<DecompressDeflate>();
+
+	// Levels above the maximum are clamped
+	pCompress->SetLevel(CompressDeflate::LEVEL_OPTIMAL+5);
+	if (pCompress->GetLevel()!=CompressDeflate::LEVEL_OPTIMAL) {
+		ReportFailure("CompressDeflate::SetLevel(LEVEL_OPTIMAL+5) = %u, expected %u",TRUE,pCompress->GetLevel(),static_cast<Word>(CompressDeflate::LEVEL_OPTIMAL));
+		uFailure = TRUE;
+	}
+
+	// Source buffers and the size of the input chunks
+	static const WordPtr s_InputSteps[] = {g_DeflateLargeSize,4099};
+	Word uLevel = CompressDeflate::LEVEL_STORED;
+	do {
+		WordPtr i = 0;
+		do {
+			WordPtr uPackedSize;
+			pCompress->SetLevel(uLevel);
+			Word8 *pPacked = CompressInChunks(pCompress,RawData,sizeof(RawData),s_InputSteps[i],&uPackedSize);
+			pTester->Reset();
+			Decompress::eError Error = pTester->Process(pBuffer,sizeof(RawData),pPacked,uPackedSize);
+			if (Error!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("CompressDeflate level %u, RawData input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uLevel,static_cast<Word>(s_InputSteps[i]),Error);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pBuffer,RawData,sizeof(RawData),"CompressDeflate::SetLevel(RawData)");
+			Free(pPacked);
+
+			pPacked = CompressInChunks(pCompress,pRaw,g_DeflateLargeSize,s_InputSteps[i],&uPackedSize);
+			pTester->Reset();
+			Error = pTester->Process(pBuffer,g_DeflateLargeSize,pPacked,uPackedSize);
+			if (Error!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("CompressDeflate level %u, large stream input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uLevel,static_cast<Word>(s_InputSteps[i]),Error);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pBuffer,pRaw,g_DeflateLargeSize,"CompressDeflate::SetLevel(large stream)");
+			Free(pPacked);
+		} while (++i<BURGER_ARRAYSIZE(s_InputSteps));
+	} while (++uLevel<=CompressDeflate::LEVEL_OPTIMAL);
+
+	Delete(pTester);
+	Delete(pCompress);
+	Free(pBuffer);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Display the ratio and speed of every compression level
+//
+
+static void TestDeflateLevelSpeed(void)
+{
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+
+	CompressDeflate *pCompress = New<CompressDeflate>();
+	Word uLevel = CompressDeflate::LEVEL_STORED;
+	do {
+		Burger::FloatTimer Timer;
+		WordPtr uPackedSize;
+		pCompress->SetLevel(uLevel);
+		Word8 *pPacked = CompressInChunks(pCompress,pRaw,g_DeflateLargeSize,g_DeflateLargeSize,&uPackedSize);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		Free(pPacked);
+		Message("CompressDeflate level %u %u MB/s (%u to %u bytes, %u%%)",uLevel,
+			static_cast<Word>(static_cast<float>(g_DeflateLargeSize)/(1048576.0f*fTime)),static_cast<Word>(g_DeflateLargeSize),static_cast<Word>(uPackedSize),
+			static_cast<Word>((uPackedSize*100U)/g_DeflateLargeSize));
+	} while (++uLevel<=CompressDeflate::LEVEL_OPTIMAL);
+
+	Delete(pCompress);
+	Free(pRaw);
+}
+
+//
+// Round trip parallel compression, the output must not
+// depend on the number of threads
+//
+
+static Word TestDeflateParallel(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize+80));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+	MemoryFill(pBuffer,0xD5,g_DeflateLargeSize+80);
+
+	JobScheduler Single(0);
+	JobScheduler Many(JobScheduler::GetCPUCount()+1);
+	CompressDeflateParallel SingleCompress(&Single);
+	CompressDeflateParallel ManyCompress(&Many);
+	DecompressDeflate *pTester = New<DecompressDeflate>();
+
+	// Input chunk size, block size and dictionary use
+	static const WordPtr s_Tests[][3] = {
+		{g_DeflateLargeSize,CompressDeflateParallel::DEFAULT_BLOCKSIZE,TRUE},
+		{g_DeflateLargeSize,CompressDeflateParallel::MIN_BLOCKSIZE,TRUE},
+		{4099,CompressDeflateParallel::MIN_BLOCKSIZE,TRUE},
+		{4099,0x5000,FALSE},
+		{0,CompressDeflateParallel::MIN_BLOCKSIZE,TRUE}
+	};
+	WordPtr i = 0;
+	do {
+		const WordPtr *pTest = s_Tests[i];
+		WordPtr uLength = pTest[0] ? g_DeflateLargeSize : 0;
+		SingleCompress.SetBlockSize(pTest[1]);
+		SingleCompress.SetUseDictionary(static_cast<Word>(pTest[2]));
+		ManyCompress.SetBlockSize(pTest[1]);
+		ManyCompress.SetUseDictionary(static_cast<Word>(pTest[2]));
+
+		WordPtr uSinglePackedSize;
+		Word8 *pSinglePacked = CompressInChunks(&SingleCompress,pRaw,uLength,pTest[0],&uSinglePackedSize);
+		WordPtr uManyPackedSize;
+		Word8 *pManyPacked = CompressInChunks(&ManyCompress,pRaw,uLength,pTest[0],&uManyPackedSize);
+		if ((uSinglePackedSize!=uManyPackedSize) || MemoryCompare(pSinglePacked,pManyPacked,uSinglePackedSize)) {
+			ReportFailure("CompressDeflateParallel block size %u, dictionary %u, output differs with %u threads",TRUE,static_cast<Word>(pTest[1]),static_cast<Word>(pTest[2]),Many.GetSlotCount());
+			uFailure = TRUE;
+		}
+
+		pTester->Reset();
+		Decompress::eError Error = pTester->Process(pBuffer,uLength,pManyPacked,uManyPackedSize);
+		if (Error!=Decompress::DECOMPRESS_OKAY) {
+			ReportFailure("CompressDeflateParallel block size %u, dictionary %u, input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,static_cast<Word>(pTest[1]),static_cast<Word>(pTest[2]),static_cast<Word>(pTest[0]),Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(pBuffer,pRaw,uLength,"CompressDeflateParallel::Process()");
+		Free(pManyPacked);
+		Free(pSinglePacked);
+	} while (++i<BURGER_ARRAYSIZE(s_Tests));
+
+	Delete(pTester);
+	Free(pBuffer);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Display the speed of parallel compression compared to a single thread
+//
+
+static void TestDeflateParallelSpeed(void)
+{
+	const WordPtr uSize = g_DeflateLargeSize*32;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(uSize));
+	FillDeflateBuffer(pRaw,uSize);
+
+	CompressDeflate *pCompress = New<CompressDeflate>();
+	Burger::FloatTimer Timer;
+	WordPtr uPackedSize;
+	Free(CompressInChunks(pCompress,pRaw,uSize,uSize,&uPackedSize));
+	float fTime = Timer.GetTime();
+	if (fTime<=0.0f) {
+		fTime = 0.000001f;
+	}
+	Delete(pCompress);
+	Message("CompressDeflate 1 thread %u MB/s (%u to %u bytes)",
+		static_cast<Word>(static_cast<float>(uSize)/(1048576.0f*fTime)),static_cast<Word>(uSize),static_cast<Word>(uPackedSize));
+
+	JobScheduler Scheduler;
+	CompressDeflateParallel Parallel(&Scheduler);
+	Word uDictionary = 0;
+	do {
+		Parallel.SetUseDictionary(uDictionary);
+		Timer.Reset();
+		Free(CompressInChunks(&Parallel,pRaw,uSize,uSize,&uPackedSize));
+		fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		Message("CompressDeflateParallel %u threads, dictionary %u %u MB/s (%u to %u bytes)",Scheduler.GetSlotCount(),uDictionary,
+			static_cast<Word>(static_cast<float>(uSize)/(1048576.0f*fTime)),static_cast<Word>(uSize),static_cast<Word>(uPackedSize));
+	} while (++uDictionary<2);
+	Free(pRaw);
+}
+
+//
+// Hand made LZ4 stream, "abcd" with a 12 byte overlapping match and
+// 5 trailing literals
+//
+
+static const Word8 LZ4Compressed[] = {
+	0x48,'a','b','c','d',0x04,0x00,0x50,'1','2','3','4','5'
+};
+
+static const Word8 LZ4Decompressed[] = {
+	'a','b','c','d','a','b','c','d','a','b','c','d','a','b','c','d','1','2','3','4','5'
+};
+
+//
+// Test the LZ4 Decompression
+//
+
+static Word TestLZ4Decompress(void)
+{
+	Word uFailure = FALSE;
+	Word8 Buffer[sizeof(LZ4Decompressed)+80];
+
+	// Perform a simple decompression test and test for buffer overrun
+	DecompressLZ4 *pTester = New<DecompressLZ4>();
+
+	MemoryFill(Buffer,0xD5,sizeof(Buffer));
+	Decompress::eError Error = pTester->Process(Buffer,sizeof(LZ4Decompressed),LZ4Compressed,sizeof(LZ4Compressed));
+	if (Error!=Decompress::DECOMPRESS_OKAY) {
+		ReportFailure("DecompressLZ4::Process(Buffer,sizeof(LZ4Decompressed),LZ4Compressed,sizeof(LZ4Compressed)) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,Error);
+		uFailure = TRUE;
+	}
+	uFailure |= ReportDecompress(Buffer,LZ4Decompressed,sizeof(LZ4Decompressed),"DecompressLZ4::Process(Buffer,sizeof(LZ4Decompressed),LZ4Compressed,sizeof(LZ4Compressed))");
+
+	// Perform single byte input and output
+
+	WordPtr uSplit = 0;
+	do {
+		Error = DecompressInChunks(pTester,Buffer,sizeof(LZ4Decompressed),LZ4Compressed,sizeof(LZ4Compressed),uSplit ? 1 : sizeof(LZ4Decompressed),uSplit ? sizeof(LZ4Compressed) : 1);
+		if (Error!=Decompress::DECOMPRESS_OKAY) {
+			ReportFailure("DecompressLZ4::Process(single byte %s) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uSplit ? "output" : "input",Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(Buffer,LZ4Decompressed,sizeof(LZ4Decompressed),"DecompressLZ4::Process(single byte)");
+	} while (++uSplit<2);
+
+	// A match before the start of the data is an error
+	static const Word8 BadOffset[] = {0x10,'a',0x02,0x00,0x50,'1','2','3','4','5'};
+	pTester->Reset();
+	Error = pTester->Process(Buffer,sizeof(LZ4Decompressed),BadOffset,sizeof(BadOffset));
+	if (Error!=Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure("DecompressLZ4::Process(BadOffset) = %d, expected Decompress::DECOMPRESS_BADINPUT",TRUE,Error);
+		uFailure = TRUE;
+	}
+	MemoryFill(Buffer,0xD5,sizeof(Buffer));
+
+	// Round trip RawData with the output bisected
+
+	CompressLZ4 *pCompress = New<CompressLZ4>();
+	WordPtr uPackedSize;
+	Word8 *pPacked = CompressInChunks(pCompress,RawData,sizeof(RawData),sizeof(RawData),&uPackedSize);
+	Word8 RawBuffer[sizeof(RawData)+80];
+	MemoryFill(RawBuffer,0xD5,sizeof(RawBuffer));
+	uSplit = 1;
+	do {
+		Error = DecompressInChunks(pTester,RawBuffer,sizeof(RawData),pPacked,uPackedSize,uSplit,uPackedSize);
+		if (Error!=Decompress::DECOMPRESS_OKAY) {
+			NumberStringHex Hex(static_cast<Word32>(uSplit),LEADINGZEROS+4);
+			ReportFailure("DecompressLZ4::Process(RawBuffer,0x%s,pPacked,uPackedSize) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,Hex.GetPtr(),Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(RawBuffer,RawData,sizeof(RawData),"DecompressLZ4::Process(RawBuffer,sizeof(RawData),pPacked,uPackedSize)");
+	} while (++uSplit<=sizeof(RawData));
+	Free(pPacked);
+
+	// Empty data is a single token
+	pPacked = CompressInChunks(pCompress,RawData,0,1,&uPackedSize);
+	if ((uPackedSize!=1) || pPacked[0]) {
+		ReportFailure("CompressLZ4::GetOutputSize() = %u for no data, expected 1",TRUE,static_cast<Word>(uPackedSize));
+		uFailure = TRUE;
+	}
+	pTester->Reset();
+	Error = pTester->Process(RawBuffer,0,pPacked,uPackedSize);
+	if (Error!=Decompress::DECOMPRESS_OKAY) {
+		ReportFailure("DecompressLZ4::Process(RawBuffer,0,pPacked,1) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,Error);
+		uFailure = TRUE;
+	}
+	Free(pPacked);
+	Delete(pCompress);
+	Delete(pTester);
+	return uFailure;
+}
+
+//
+// Round trip LZ4 on a large stream
+// Note: CompressLZ4 is over 192K, so it's allocated at runtime
+//
+
+static Word TestLZ4Large(void)
+{
+	Word uFailure = FALSE;
+	const WordPtr uSize = g_DeflateLargeSize*2;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(uSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(uSize+80));
+	FillDeflateBuffer(pRaw,uSize);
+	MemoryFill(pBuffer,0xD5,uSize+80);
+
+	// The output must not depend on how the input is split
+	CompressLZ4 *pCompress = New<CompressLZ4>();
+	WordPtr uPackedSize;
+	Word8 *pPacked = CompressInChunks(pCompress,pRaw,uSize,uSize,&uPackedSize);
+	static const WordPtr s_InputSteps[] = {4099,1,0x20000};
+	WordPtr i = 0;
+	do {
+		WordPtr uChunkedSize;
+		Word8 *pChunked = CompressInChunks(pCompress,pRaw,uSize,s_InputSteps[i],&uChunkedSize);
+		if ((uChunkedSize!=uPackedSize) || MemoryCompare(pChunked,pPacked,uPackedSize)) {
+			ReportFailure("CompressLZ4::Process() input step %u, output differs",TRUE,static_cast<Word>(s_InputSteps[i]));
+			uFailure = TRUE;
+		}
+		Free(pChunked);
+	} while (++i<BURGER_ARRAYSIZE(s_InputSteps));
+	Delete(pCompress);
+
+	// Chunk sizes, the first is a single pass
+	static const WordPtr s_Steps[][2] = {
+		{uSize,uSize},
+		{1021,13},
+		{65536,4099},
+		{7,uSize}
+	};
+
+	DecompressLZ4 Original;
+	Decompress *pTester = Original.Clone();
+	i = 0;
+	do {
+		Decompress::eError Error = DecompressInChunks(pTester,pBuffer,uSize,pPacked,uPackedSize,s_Steps[i][0],s_Steps[i][1]);
+		if (Error!=Decompress::DECOMPRESS_OKAY) {
+			ReportFailure("DecompressLZ4::Process() output step %u, input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,static_cast<Word>(s_Steps[i][0]),static_cast<Word>(s_Steps[i][1]),Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(pBuffer,pRaw,uSize,"DecompressLZ4::Process(large stream)");
+	} while (++i<BURGER_ARRAYSIZE(s_Steps));
+
+	Delete(pTester);
+	Free(pPacked);
+	Free(pBuffer);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Display the compression and decompression speed of LZ4
+// compared to the other codecs
+//
+
+static void TestLZ4Speed(void)
+{
+	const Word cPasses = 32;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+
+	Compress *pCompressors[4];
+	Decompress *pDecompressors[4];
+	static const char *s_Names[4] = {"LZ4","Deflate","LZSS","ILBMRLE"};
+	pCompressors[0] = New<CompressLZ4>();
+	pDecompressors[0] = New<DecompressLZ4>();
+	pCompressors[1] = New<CompressDeflate>();
+	pDecompressors[1] = New<DecompressDeflate>();
+	pCompressors[2] = New<CompressLZSS>();
+	pDecompressors[2] = New<DecompressLZSS>();
+	pCompressors[3] = New<CompressILBMRLE>();
+	pDecompressors[3] = New<DecompressILBMRLE>();
+
+	Word i = 0;
+	do {
+		Compress *pCompress = pCompressors[i];
+		Burger::FloatTimer Timer;
+		Word uCount = cPasses;
+		do {
+			pCompress->Init();
+			pCompress->Process(pRaw,g_DeflateLargeSize);
+			pCompress->Finalize();
+		} while (--uCount);
+		float fCompressTime = Timer.GetTime();
+		if (fCompressTime<=0.0f) {
+			fCompressTime = 0.000001f;
+		}
+		WordPtr uPackedSize = pCompress->GetOutputSize();
+		Word8 *pPacked = static_cast<Word8 *>(Alloc(uPackedSize));
+		pCompress->GetOutput()->Flatten(pPacked,uPackedSize);
+
+		Decompress *pDecompress = pDecompressors[i];
+		Timer.Reset();
+		uCount = cPasses;
+		do {
+			pDecompress->Reset();
+			pDecompress->Process(pBuffer,g_DeflateLargeSize,pPacked,uPackedSize);
+		} while (--uCount);
+		float fDecompressTime = Timer.GetTime();
+		if (fDecompressTime<=0.0f) {
+			fDecompressTime = 0.000001f;
+		}
+		Free(pPacked);
+		Message("%s compress %u MB/s, decompress %u MB/s (%u to %u bytes, %u%%)",s_Names[i],
+			static_cast<Word>(static_cast<float>(cPasses*g_DeflateLargeSize)/(1048576.0f*fCompressTime)),
+			static_cast<Word>(static_cast<float>(cPasses*g_DeflateLargeSize)/(1048576.0f*fDecompressTime)),
+			static_cast<Word>(g_DeflateLargeSize),static_cast<Word>(uPackedSize),
+			static_cast<Word>((uPackedSize*100U)/g_DeflateLargeSize));
+		Delete(pDecompress);
+		Delete(pCompress);
+	} while (++i<4);
+
+	Free(pBuffer);
+	Free(pRaw);
+}
+
+//
+// Round trip both LZSS match finders and the large window
+//
+
+static Word TestLZSSMatchFinders(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(g_DeflateLargeSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(g_DeflateLargeSize+80));
+	FillDeflateBuffer(pRaw,g_DeflateLargeSize);
+	MemoryFill(pBuffer,0xD5,g_DeflateLargeSize+80);
+
+	CompressLZSS *pCompress = New<CompressLZSS>();
+	DecompressLZSS Original;
+
+	// The hash chain finder needs no data to output no data
+	pCompress->SetMatchFinder(CompressLZSS::MATCHFINDER_HASHCHAIN);
+	WordPtr uPackedSize;
+	Free(CompressInChunks(pCompress,pRaw,0,1,&uPackedSize));
+	if (uPackedSize) {
+		ReportFailure("CompressLZSS::GetOutputSize() = %u for no data, expected 0",TRUE,static_cast<Word>(uPackedSize));
+		uFailure = TRUE;
+	}
+
+	// "ab" followed by a large window match of 3 bytes at a distance of 2,
+	// which is valid even if "ab" was output in a previous call
+	static const Word8 s_LargeGood[] = {0x03,'a','b',0x01,0x00,0x00};
+	static const Word8 s_LargeGoodResult[] = {'a','b','a','b','a'};
+	Original.SetLargeWindow(TRUE);
+	Decompress::eError Error = DecompressInChunks(&Original,pBuffer,sizeof(s_LargeGoodResult),s_LargeGood,sizeof(s_LargeGood),2,sizeof(s_LargeGood));
+	if (Error!=Decompress::DECOMPRESS_OKAY) {
+		ReportFailure("DecompressLZSS::Process(s_LargeGood) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,Error);
+		uFailure = TRUE;
+	}
+	uFailure |= ReportDecompress(pBuffer,s_LargeGoodResult,sizeof(s_LargeGoodResult),"DecompressLZSS::Process(s_LargeGood)");
+
+	// A distance of 3 is before the start of the data
+	static const Word8 s_LargeBad[] = {0x03,'a','b',0x02,0x00,0x00};
+	Error = DecompressInChunks(&Original,pBuffer,sizeof(s_LargeGoodResult),s_LargeBad,sizeof(s_LargeBad),2,sizeof(s_LargeBad));
+	if (Error!=Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure("DecompressLZSS::Process(s_LargeBad) = %d, expected Decompress::DECOMPRESS_BADINPUT",TRUE,Error);
+		uFailure = TRUE;
+	}
+	MemoryFill(pBuffer,0xD5,g_DeflateLargeSize+80);
+
+	// Match finder and large window
+	static const Word s_Modes[][2] = {
+		{CompressLZSS::MATCHFINDER_TREE,FALSE},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,FALSE},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,TRUE}
+	};
+	static const WordPtr s_Steps[][2] = {
+		{g_DeflateLargeSize,g_DeflateLargeSize},
+		{1021,13},
+		{7,g_DeflateLargeSize}
+	};
+	WordPtr i = 0;
+	do {
+		pCompress->SetMatchFinder(static_cast<CompressLZSS::eMatchFinder>(s_Modes[i][0]));
+		pCompress->SetLargeWindow(s_Modes[i][1]);
+		Original.SetLargeWindow(s_Modes[i][1]);
+		Decompress *pTester = Original.Clone();
+		if (pTester->GetSignature()!=pCompress->GetSignature()) {
+			ReportFailure("DecompressLZSS::Clone() large window %u, signature mismatch",TRUE,s_Modes[i][1]);
+			uFailure = TRUE;
+		}
+
+		Word8 *pPacked = CompressInChunks(pCompress,RawData,sizeof(RawData),sizeof(RawData),&uPackedSize);
+		Error = DecompressInChunks(pTester,pBuffer,sizeof(RawData),pPacked,uPackedSize,sizeof(RawData),1);
+		if (Error!=Decompress::DECOMPRESS_OKAY) {
+			ReportFailure("DecompressLZSS::Process(RawData) match finder %u, large window %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,s_Modes[i][0],s_Modes[i][1],Error);
+			uFailure = TRUE;
+		}
+		uFailure |= ReportDecompress(pBuffer,RawData,sizeof(RawData),"DecompressLZSS::Process(RawData)");
+		Free(pPacked);
+
+		// The output must not depend on how the input is split
+		pPacked = CompressInChunks(pCompress,pRaw,g_DeflateLargeSize,g_DeflateLargeSize,&uPackedSize);
+		WordPtr uChunkedSize;
+		Word8 *pChunked = CompressInChunks(pCompress,pRaw,g_DeflateLargeSize,4099,&uChunkedSize);
+		if ((uChunkedSize!=uPackedSize) || MemoryCompare(pChunked,pPacked,uPackedSize)) {
+			ReportFailure("CompressLZSS::Process() match finder %u, large window %u, output differs with 4099 byte input",TRUE,s_Modes[i][0],s_Modes[i][1]);
+			uFailure = TRUE;
+		}
+		Free(pChunked);
+
+		WordPtr j = 0;
+		do {
+			Error = DecompressInChunks(pTester,pBuffer,g_DeflateLargeSize,pPacked,uPackedSize,s_Steps[j][0],s_Steps[j][1]);
+			if (Error!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("DecompressLZSS::Process() match finder %u, large window %u, output step %u, input step %u = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,
+					s_Modes[i][0],s_Modes[i][1],static_cast<Word>(s_Steps[j][0]),static_cast<Word>(s_Steps[j][1]),Error);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pBuffer,pRaw,g_DeflateLargeSize,"DecompressLZSS::Process(large stream)");
+		} while (++j<BURGER_ARRAYSIZE(s_Steps));
+		Free(pPacked);
+		Delete(pTester);
+	} while (++i<BURGER_ARRAYSIZE(s_Modes));
+
+	Delete(pCompress);
+	Free(pBuffer);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Display the speed and size of both LZSS match finders
+//
+
+static void TestLZSSSpeed(void)
+{
+	const WordPtr uSize = g_DeflateLargeSize*4;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(uSize));
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(uSize));
+	FillDeflateBuffer(pRaw,uSize);
+
+	// Match finder, large window and chain depth
+	static const Word s_Modes[][3] = {
+		{CompressLZSS::MATCHFINDER_TREE,FALSE,CompressLZSS::DEFAULT_CHAINDEPTH},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,FALSE,8},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,FALSE,CompressLZSS::DEFAULT_CHAINDEPTH},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,FALSE,256},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,TRUE,8},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,TRUE,CompressLZSS::DEFAULT_CHAINDEPTH},
+		{CompressLZSS::MATCHFINDER_HASHCHAIN,TRUE,256}
+	};
+	CompressLZSS *pCompress = New<CompressLZSS>();
+	DecompressLZSS Tester;
+	WordPtr i = 0;
+	do {
+		pCompress->SetMatchFinder(static_cast<CompressLZSS::eMatchFinder>(s_Modes[i][0]));
+		pCompress->SetLargeWindow(s_Modes[i][1]);
+		pCompress->SetChainDepth(s_Modes[i][2]);
+		Burger::FloatTimer Timer;
+		WordPtr uPackedSize;
+		Word8 *pPacked = CompressInChunks(pCompress,pRaw,uSize,uSize,&uPackedSize);
+		float fCompressTime = Timer.GetTime();
+		if (fCompressTime<=0.0f) {
+			fCompressTime = 0.000001f;
+		}
+
+		Tester.SetLargeWindow(s_Modes[i][1]);
+		Timer.Reset();
+		Tester.Reset();
+		Tester.Process(pBuffer,uSize,pPacked,uPackedSize);
+		float fDecompressTime = Timer.GetTime();
+		if (fDecompressTime<=0.0f) {
+			fDecompressTime = 0.000001f;
+		}
+		Free(pPacked);
+		Word uCompressSpeed = static_cast<Word>(static_cast<float>(uSize)/(1048576.0f*fCompressTime));
+		Word uDecompressSpeed = static_cast<Word>(static_cast<float>(uSize)/(1048576.0f*fDecompressTime));
+		if (s_Modes[i][0]==CompressLZSS::MATCHFINDER_TREE) {
+			Message("CompressLZSS tree, 4K window compress %u MB/s, decompress %u MB/s (%u to %u bytes, %u%%)",
+				uCompressSpeed,uDecompressSpeed,static_cast<Word>(uSize),static_cast<Word>(uPackedSize),static_cast<Word>((uPackedSize*100U)/uSize));
+		} else {
+			Message("CompressLZSS hash chain depth %u, %s window compress %u MB/s, decompress %u MB/s (%u to %u bytes, %u%%)",s_Modes[i][2],s_Modes[i][1] ? "64K" : "4K",
+				uCompressSpeed,uDecompressSpeed,static_cast<Word>(uSize),static_cast<Word>(uPackedSize),static_cast<Word>((uPackedSize*100U)/uSize));
+		}
+	} while (++i<BURGER_ARRAYSIZE(s_Modes));
+
+	Delete(pCompress);
+	Free(pBuffer);
+	Free(pRaw);
+}
+
 //
 // Test compression code
 //
 
-int BURGER_API TestBrcompression(void)
+int BURGER_API TestBrcompression(Word bVerbose)
 {
 	MemoryManagerGlobalANSI Memory;
-	Message("Running Compression tests");
+	if (bVerbose) {
+		Message("Running Compression tests");
+	}
 	Word uResult = TestILBMDecompress();
 	uResult |= TestILBMCompress();
 	uResult |= TestLZSSDecompress();
 	uResult |= TestLZSSCompress();
 	uResult |= TestDeflateDecompress();
+	uResult |= TestDeflateLarge();
 	uResult |= TestDeflateCompress();
+	uResult |= TestDeflateLevels();
+	uResult |= TestDeflateParallel();
+	uResult |= TestLZ4Decompress();
+	uResult |= TestLZ4Large();
+	uResult |= TestLZSSMatchFinders();
+
+	if (bVerbose) {
+		TestDeflateSpeed();
+		TestDeflateLevelSpeed();
+		TestDeflateParallelSpeed();
+		TestLZ4Speed();
+		TestLZSSSpeed();
+	}
+
+	if (!uResult && bVerbose) {
+		Message("Passed all Compression tests!");
+	}
 	return static_cast<int>(uResult);
 }
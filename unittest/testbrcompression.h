@@ -18,6 +18,6 @@
 #include "brtypes.h"
 #endif
 
-extern int BURGER_API TestBrcompression(void);
+extern int BURGER_API TestBrcompression(Word bVerbose);
 
 #endif
@@ -19,6 +19,13 @@
 #include "brfile.h"
 #include "brdirectorysearch.h"
 #include "brmemoryansi.h"
+#include "brcriticalsection.h"
+#include "brtick.h"
+#include "brrezfile.h"
+#include "brmemoryhandle.h"
+#include "brcompresslz4.h"
+#include "brdecompresslz4.h"
+#include "broutputmemorystream.h"
 
 #define FULLTESTS
 
@@ -1364,6 +1371,519 @@ static Word TestDirectorySearch(Word uVerbose)
 	return uFailure;
 }
 
+/***************************************
+
+	Stress test the asynchronous IO queue
+
+	Several threads issue completion callbacks as fast
+	as they can to measure how many submissions per second
+	the queue sustains as producers are added.
+
+***************************************/
+
+static Word32 g_uCallbackCount;
+
+static void BURGER_API CountCallback(FileManager::Queue_t * /* pQueue */)
+{
+	// Only the IO thread calls this
+	++g_uCallbackCount;
+}
+
+static WordPtr BURGER_API SubmitCallbacks(void *pData)
+{
+	Word uCount = static_cast<Word>(reinterpret_cast<WordPtr>(pData));
+	do {
+		FileManager::QueueCallback(NULL,CountCallback);
+	} while (--uCount);
+	return 0;
+}
+
+static Word TestAsyncQueue(Word uVerbose)
+{
+	const Word cTotalSubmissions = 240000;
+	const Word cMaxThreads = 8;
+	Word uFailure = FALSE;
+
+	Word uThreadCount = 1;
+	do {
+		g_uCallbackCount = 0;
+		Word uPerThread = cTotalSubmissions/uThreadCount;
+
+		Thread Producers[cMaxThreads];
+		FloatTimer Timer;
+		Word i = 0;
+		do {
+			Producers[i].Start(SubmitCallbacks,reinterpret_cast<void *>(static_cast<WordPtr>(uPerThread)));
+		} while (++i<uThreadCount);
+		i = 0;
+		do {
+			Producers[i].Wait();
+		} while (++i<uThreadCount);
+
+		// Wait for the IO thread to catch up
+		FileManager::FlushIO();
+		float fTime = Timer.GetTime();
+
+		Word32 uExpected = static_cast<Word32>(uPerThread*uThreadCount);
+		Word uTest = g_uCallbackCount!=uExpected;
+		uFailure |= uTest;
+		ReportFailure("FileManager::QueueCallback() with %u threads issued %u callbacks, expected %u",uTest,uThreadCount,g_uCallbackCount,uExpected);
+		if (uVerbose) {
+			if (fTime<=0.0f) {
+				fTime = 0.000001f;
+			}
+			Message("FileManager queue depth %u, %u producer(s), %u submissions per second",
+				FileManager::GetQueueDepth(),uThreadCount,static_cast<Word>(static_cast<float>(uExpected)/fTime));
+		}
+		uThreadCount <<= 1;
+	} while (uThreadCount<=cMaxThreads);
+	return uFailure;
+}
+
+/***************************************
+
+	Test asynchronous reads
+
+	Issue a stream of reads, a scatter read and reads into
+	a registered buffer and verify the data and the lengths
+	passed to the completion callbacks.
+
+***************************************/
+
+static WordPtr g_uReadLengths[8];
+static Word g_uReadCount;
+
+static void BURGER_API ReadCallback(FileManager::Queue_t *pQueue)
+{
+	if (g_uReadCount<BURGER_ARRAYSIZE(g_uReadLengths)) {
+		g_uReadLengths[g_uReadCount] = pQueue->m_uLength;
+	}
+	++g_uReadCount;
+}
+
+static Word TestAsyncRead(Word uVerbose)
+{
+	const WordPtr cFileSize = 100000;
+	Word uFailure = FALSE;
+
+	// Create a file with a known pattern
+	Word8 *pData = static_cast<Word8 *>(Alloc(cFileSize*3));
+	if (!pData) {
+		return TRUE;
+	}
+	WordPtr i = 0;
+	do {
+		pData[i] = static_cast<Word8>((i*7)+(i>>8));
+	} while (++i<cFileSize);
+	Word8 *pOutput = pData+cFileSize;
+	Word8 *pFixed = pOutput+cFileSize;
+	FileManager::SaveFile("9:asyncread.bin",pData,cFileSize);
+
+	g_uReadCount = 0;
+	MemoryClear(pOutput,cFileSize*2);
+	File TestFile;
+	TestFile.OpenAsync("9:asyncread.bin");
+
+	// Read the first 60000 bytes in chunks
+	TestFile.ReadAsync(pOutput,20000);
+	TestFile.ReadAsync(pOutput+20000,20000);
+	TestFile.ReadAsync(pOutput+40000,20000);
+	FileManager::QueueCallback(&TestFile,ReadCallback);
+
+	// Scatter read the next 30000 bytes
+	FileManager::IOVector_t Vectors[3];
+	Vectors[0].m_pBuffer = pOutput+60000;
+	Vectors[0].m_uLength = 5000;
+	Vectors[1].m_pBuffer = pOutput+65000;
+	Vectors[1].m_uLength = 15000;
+	Vectors[2].m_pBuffer = pOutput+80000;
+	Vectors[2].m_uLength = 10000;
+	TestFile.ReadVectorAsync(Vectors,3);
+	FileManager::QueueCallback(&TestFile,ReadCallback);
+
+	// Read past the end of the file
+	TestFile.ReadAsync(pOutput+90000,20000);
+	FileManager::QueueCallback(&TestFile,ReadCallback);
+	TestFile.CloseAsync();
+	FileManager::FlushIO();
+
+	Word uTest = g_uReadCount!=3;
+	uFailure |= uTest;
+	ReportFailure("File::ReadAsync() issued %u callbacks, expected 3",uTest,g_uReadCount);
+	if (!uTest) {
+		uTest = (g_uReadLengths[0]!=20000) || (g_uReadLengths[1]!=30000) || (g_uReadLengths[2]!=10000);
+		uFailure |= uTest;
+		ReportFailure("File::ReadAsync() lengths %u, %u, %u, expected 20000, 30000, 10000",uTest,
+			static_cast<Word>(g_uReadLengths[0]),static_cast<Word>(g_uReadLengths[1]),static_cast<Word>(g_uReadLengths[2]));
+	}
+	uTest = MemoryCompare(pData,pOutput,cFileSize)!=0;
+	uFailure |= uTest;
+	ReportFailure("File::ReadAsync() data mismatch",uTest);
+
+	// Fixed buffers may not be supported, but reads must still work
+	FileManager::IOVector_t Fixed;
+	Fixed.m_pBuffer = pFixed;
+	Fixed.m_uLength = cFileSize;
+	Word uRegistered = FileManager::RegisterBuffers(&Fixed,1);
+	if (uVerbose) {
+		Message("FileManager::RegisterBuffers() returned %u",uRegistered);
+	}
+	g_uReadCount = 0;
+	TestFile.OpenAsync("9:asyncread.bin");
+	TestFile.ReadAsync(pFixed,cFileSize/2);
+	TestFile.ReadAsync(pFixed+(cFileSize/2),cFileSize/2);
+	FileManager::QueueCallback(&TestFile,ReadCallback);
+	TestFile.CloseAsync();
+	FileManager::FlushIO();
+	if (uRegistered==File::OKAY) {
+		FileManager::RegisterBuffers(NULL,0);
+	}
+	uTest = (g_uReadCount!=1) || (g_uReadLengths[0]!=cFileSize/2) || (MemoryCompare(pData,pFixed,cFileSize)!=0);
+	uFailure |= uTest;
+	ReportFailure("File::ReadAsync() into a registered buffer failed",uTest);
+
+	FileManager::DeleteFile("9:asyncread.bin");
+	Free(pData);
+	return uFailure;
+}
+
+/***************************************
+
+	Create a rez file for the RezFile tests
+
+	Resources 100 through 103 alternate between data
+	stored as is and data compressed with LZ4 using
+	compressor ID 1.
+
+***************************************/
+
+static const Word g_uRezBase = 100;
+static const WordPtr g_RezSizes[] = {5000,200000,70000,3000};
+
+static Word8 RezPattern(Word uRezNum,WordPtr uIndex)
+{
+	return static_cast<Word8>(((uIndex>>4)+uRezNum)^(uIndex&0x1F));
+}
+
+static Word CreateTestRezFile(const char *pFileName)
+{
+	const Word uCount = BURGER_ARRAYSIZE(g_RezSizes);
+	Word8 *pPacked[BURGER_ARRAYSIZE(g_RezSizes)];
+	WordPtr uPackedSizes[BURGER_ARRAYSIZE(g_RezSizes)];
+
+	// Create the data for each entry, compress the odd ones
+	Word uResult = FALSE;
+	Word i = 0;
+	do {
+		WordPtr uSize = g_RezSizes[i];
+		Word8 *pData = static_cast<Word8 *>(Alloc(uSize));
+		if (pData) {
+			WordPtr j = 0;
+			do {
+				pData[j] = RezPattern(g_uRezBase+i,j);
+			} while (++j<uSize);
+			if (i&1) {
+				CompressLZ4 Packer;
+				Packer.Init();
+				Packer.Process(pData,uSize);
+				Packer.Finalize();
+				Free(pData);
+				pData = static_cast<Word8 *>(Packer.GetOutput()->Flatten(&uSize));
+			}
+		}
+		if (!pData) {
+			uResult = TRUE;
+		}
+		pPacked[i] = pData;
+		uPackedSizes[i] = uSize;
+	} while (++i<uCount);
+
+	if (!uResult) {
+		OutputMemoryStream Output;
+		// Root header
+		Word32 uMemSize = static_cast<Word32>((sizeof(Word32)*2)+(sizeof(RezFile::FileRezEntry_t)*uCount));
+		Output.Append(RezFile::g_RezFileSignature,4);
+		Output.Append(static_cast<Word32>(1));
+		Output.Append(uMemSize);
+		Output.Append("LZ4 ",4);
+		Output.Append(static_cast<Word32>(0));
+		Output.Append(static_cast<Word32>(0));
+
+		// One group with all of the entries
+		Output.Append(static_cast<Word32>(g_uRezBase));
+		Output.Append(static_cast<Word32>(uCount));
+		Word32 uFileOffset = RezFile::ROOTHEADERSIZE+uMemSize;
+		i = 0;
+		do {
+			Output.Append(uFileOffset);
+			Output.Append(static_cast<Word32>(g_RezSizes[i]));
+			Output.Append(static_cast<Word32>((i&1)<<RezFile::ENTRYFLAGSDECOMPSHIFT));
+			Output.Append(static_cast<Word32>(uPackedSizes[i]));
+			uFileOffset += static_cast<Word32>(uPackedSizes[i]);
+		} while (++i<uCount);
+
+		// The data
+		i = 0;
+		do {
+			Output.Append(pPacked[i],uPackedSizes[i]);
+		} while (++i<uCount);
+		uResult = Output.SaveFile(pFileName);
+	}
+	i = 0;
+	do {
+		Free(pPacked[i]);
+	} while (++i<uCount);
+	return uResult;
+}
+
+static Word VerifyRez(Word uRezNum,const void *pData)
+{
+	Word uResult = TRUE;
+	if (pData) {
+		const Word8 *pWork = static_cast<const Word8 *>(pData);
+		WordPtr uSize = g_RezSizes[uRezNum-g_uRezBase];
+		WordPtr i = 0;
+		do {
+			if (pWork[i]!=RezPattern(uRezNum,i)) {
+				break;
+			}
+		} while (++i<uSize);
+		uResult = i!=uSize;
+	}
+	return uResult;
+}
+
+struct RezBatch_t {
+	Word m_uCalls;		///< Number of callbacks issued
+	Word m_uBad;		///< Number of entries with bad data
+};
+
+static void BURGER_API RezBatchCallback(void *pData,Word uRezNum,void **ppData)
+{
+	RezBatch_t *pBatch = static_cast<RezBatch_t *>(pData);
+	++pBatch->m_uCalls;
+	pBatch->m_uBad += VerifyRez(uRezNum,ppData ? ppData[0] : NULL);
+}
+
+/***************************************
+
+	Test loading LZ4 compressed resources
+
+	Without a codec, compressed entries fail to load. Once
+	DecompressLZ4 is logged, every entry must match with
+	both Load() and LoadBatch(), which clones the codec
+	for its worker threads.
+
+***************************************/
+
+static Word TestRezFileLZ4(void)
+{
+	const Word uCount = BURGER_ARRAYSIZE(g_RezSizes);
+	Word uFailure = CreateTestRezFile("9:testrez.rez");
+	ReportFailure("Creating 9:testrez.rez failed",uFailure);
+	if (!uFailure) {
+		MemoryManagerHandle Handles;
+		DecompressLZ4 Unpacker;
+		RezFile Rez(&Handles);
+		Word uTest = Rez.Init("9:testrez.rez");
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"9:testrez.rez\") = %u",uTest,uTest);
+		if (!uTest) {
+			// No codec, no data
+			uTest = Rez.Load(g_uRezBase+1)!=NULL;
+			uFailure |= uTest;
+			ReportFailure("RezFile::Load() loaded LZ4 data without a decompressor",uTest);
+
+			Rez.LogDecompressor(1,&Unpacker);
+			Word i = 0;
+			do {
+				Word uRezNum = g_uRezBase+i;
+				uTest = VerifyRez(uRezNum,Rez.Load(uRezNum));
+				uFailure |= uTest;
+				ReportFailure("RezFile::Load(%u) returned bad data",uTest,uRezNum);
+				Rez.Kill(uRezNum);
+			} while (++i<uCount);
+
+			Word RezNums[uCount];
+			i = 0;
+			do {
+				RezNums[i] = g_uRezBase+i;
+			} while (++i<uCount);
+			RezBatch_t Batch;
+			Batch.m_uCalls = 0;
+			Batch.m_uBad = 0;
+			Word uFailed = Rez.LoadBatch(RezNums,uCount,RezBatchCallback,&Batch);
+			uTest = uFailed || (Batch.m_uCalls!=uCount) || Batch.m_uBad;
+			uFailure |= uTest;
+			ReportFailure("RezFile::LoadBatch() with LZ4 had %u failures, %u callbacks and %u bad entries",uTest,uFailed,Batch.m_uCalls,Batch.m_uBad);
+			i = 0;
+			do {
+				Rez.Release(g_uRezBase+i);
+			} while (++i<uCount);
+		}
+		Rez.Shutdown();
+		FileManager::DeleteFile("9:testrez.rez");
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test memory mapped rez files
+
+	Stored entries are returned from inside of the
+	mapping without using the handle memory manager,
+	compressed entries are still decompressed into handles.
+
+***************************************/
+
+static Word TestRezFileMapped(void)
+{
+	const Word uCount = BURGER_ARRAYSIZE(g_RezSizes);
+	Word uFailure = CreateTestRezFile("9:testrez.rez");
+	ReportFailure("Creating 9:testrez.rez failed",uFailure);
+	if (!uFailure) {
+		MemoryManagerHandle Handles;
+		DecompressLZ4 Unpacker;
+		RezFile Rez(&Handles);
+		Word uTest = Rez.Init("9:testrez.rez",0,TRUE) || !Rez.IsMapped();
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"9:testrez.rez\",0,TRUE) didn't map the file",uTest);
+		if (!uTest) {
+			Rez.LogDecompressor(1,&Unpacker);
+
+			// Zero copy, so no handle memory is used
+			WordPtr uAllocated = Handles.GetTotalAllocatedMemory();
+			Word bFirst = FALSE;
+			Word bSecond = TRUE;
+			const void *pFirst = Rez.Load(g_uRezBase,&bFirst);
+			const void *pSecond = Rez.Load(g_uRezBase,&bSecond);
+			Word uRezNum = 0;
+			uTest = VerifyRez(g_uRezBase,pFirst) || (pFirst!=pSecond) || !bFirst || bSecond ||
+				(Handles.GetTotalAllocatedMemory()!=uAllocated) ||
+				Rez.GetIDFromPointer(pFirst,&uRezNum,NULL,0) || (uRezNum!=g_uRezBase);
+			uFailure |= uTest;
+			ReportFailure("RezFile::Load(%u) from a mapped file failed",uTest,g_uRezBase);
+			Rez.Release(g_uRezBase);
+			Rez.Release(g_uRezBase);
+
+			// Compressed data is loaded into a handle
+			uTest = VerifyRez(g_uRezBase+1,Rez.Load(g_uRezBase+1)) || (Handles.GetTotalAllocatedMemory()==uAllocated);
+			uFailure |= uTest;
+			ReportFailure("RezFile::Load(%u) of compressed data from a mapped file failed",uTest,g_uRezBase+1);
+			Rez.Kill(g_uRezBase+1);
+
+			// Batches read straight from the mapping
+			Word RezNums[uCount];
+			Word i = 0;
+			do {
+				RezNums[i] = g_uRezBase+i;
+			} while (++i<uCount);
+			RezBatch_t Batch;
+			Batch.m_uCalls = 0;
+			Batch.m_uBad = 0;
+			Word uFailed = Rez.LoadBatch(RezNums,uCount,RezBatchCallback,&Batch);
+			uTest = uFailed || (Batch.m_uCalls!=uCount) || Batch.m_uBad;
+			uFailure |= uTest;
+			ReportFailure("RezFile::LoadBatch() from a mapped file had %u failures, %u callbacks and %u bad entries",uTest,uFailed,Batch.m_uCalls,Batch.m_uBad);
+			i = 0;
+			do {
+				Rez.Release(g_uRezBase+i);
+			} while (++i<uCount);
+		}
+		Rez.Shutdown();
+		FileManager::DeleteFile("9:testrez.rez");
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test that LoadBatch() matches Load()
+
+	Load every entry one at a time and save a copy, then
+	load them as a batch with the entries out of order, a
+	duplicate, an entry that's already cached and a resource
+	that doesn't exist, and compare the results.
+
+***************************************/
+
+struct RezCompare_t {
+	void *m_pCopies[BURGER_ARRAYSIZE(g_RezSizes)];	///< Data from single loads
+	Word m_uCalls;		///< Number of callbacks issued
+	Word m_uBad;		///< Number of entries that didn't match
+	Word m_uMissing;	///< Number of entries that didn't load
+};
+
+static void BURGER_API RezCompareCallback(void *pData,Word uRezNum,void **ppData)
+{
+	RezCompare_t *pCompare = static_cast<RezCompare_t *>(pData);
+	++pCompare->m_uCalls;
+	if (!ppData) {
+		++pCompare->m_uMissing;
+	} else {
+		Word uIndex = uRezNum-g_uRezBase;
+		if ((uIndex>=BURGER_ARRAYSIZE(g_RezSizes)) || MemoryCompare(ppData[0],pCompare->m_pCopies[uIndex],g_RezSizes[uIndex])) {
+			++pCompare->m_uBad;
+		}
+	}
+}
+
+static Word TestRezFileBatch(void)
+{
+	const Word uCount = BURGER_ARRAYSIZE(g_RezSizes);
+	Word uFailure = CreateTestRezFile("9:testrez.rez");
+	ReportFailure("Creating 9:testrez.rez failed",uFailure);
+	if (!uFailure) {
+		MemoryManagerHandle Handles;
+		DecompressLZ4 Unpacker;
+		RezFile Rez(&Handles);
+		Word uTest = Rez.Init("9:testrez.rez");
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"9:testrez.rez\") = %u",uTest,uTest);
+		if (!uTest) {
+			Rez.LogDecompressor(1,&Unpacker);
+
+			// Load them one at a time
+			RezCompare_t Compare;
+			Word i = 0;
+			do {
+				Word uRezNum = g_uRezBase+i;
+				Compare.m_pCopies[i] = AllocCopy(Rez.Load(uRezNum),g_RezSizes[i]);
+				Rez.Kill(uRezNum);
+			} while (++i<uCount);
+
+			// Keep one in the cache
+			Rez.Load(g_uRezBase+2);
+			Rez.Release(g_uRezBase+2);
+
+			static const Word s_RezNums[] = {g_uRezBase+3,g_uRezBase,g_uRezBase+1,g_uRezBase,g_uRezBase+999,g_uRezBase+2};
+			Compare.m_uCalls = 0;
+			Compare.m_uBad = 0;
+			Compare.m_uMissing = 0;
+			Word uFailed = Rez.LoadBatch(s_RezNums,BURGER_ARRAYSIZE(s_RezNums),RezCompareCallback,&Compare);
+			uTest = (uFailed!=1) || (Compare.m_uCalls!=BURGER_ARRAYSIZE(s_RezNums)) || Compare.m_uBad || (Compare.m_uMissing!=1);
+			uFailure |= uTest;
+			ReportFailure("RezFile::LoadBatch() returned %u with %u callbacks, %u mismatches and %u missing",uTest,uFailed,Compare.m_uCalls,Compare.m_uBad,Compare.m_uMissing);
+
+			// Every entry that loaded holds a reference
+			i = 0;
+			do {
+				if (s_RezNums[i]<(g_uRezBase+uCount)) {
+					Rez.Release(s_RezNums[i]);
+				}
+			} while (++i<BURGER_ARRAYSIZE(s_RezNums));
+			i = 0;
+			do {
+				Free(Compare.m_pCopies[i]);
+			} while (++i<uCount);
+		}
+		Rez.Shutdown();
+		FileManager::DeleteFile("9:testrez.rez");
+	}
+	return uFailure;
+}
+
 /***************************************
 
 	Test if setting the filename explicitly works.
@@ -1407,6 +1927,11 @@ Word FileManagerTest(Word uVerbose)
 	// Test File Manager
 	Message("Running File Manager tests");
 	uTotal |= TestPrefixes(uVerbose);
+	uTotal |= TestAsyncQueue(uVerbose);
+	uTotal |= TestAsyncRead(uVerbose);
+	uTotal |= TestRezFileLZ4();
+	uTotal |= TestRezFileMapped();
+	uTotal |= TestRezFileBatch();
 
 #if defined(FULLTESTS)
 	uTotal |= TestGetVolumeName(uVerbose);
@@ -1433,3 +1958,29 @@ Word FileManagerTest(Word uVerbose)
 	FileManager::Shutdown();
 	return uTotal;
 }
+
+/***************************************
+
+	Test only the asynchronous IO queue and RezFile loading.
+
+	The rest of FileManagerTest() has expected values for
+	specific host machines.
+
+***************************************/
+
+Word FileManagerAsyncTest(Word uVerbose)
+{
+	Word uTotal = 0;
+	MemoryManagerGlobalANSI Memory;
+	FileManager::Init();
+
+	Message("Running File Manager async tests");
+	uTotal |= TestAsyncQueue(uVerbose);
+	uTotal |= TestAsyncRead(uVerbose);
+	uTotal |= TestRezFileLZ4();
+	uTotal |= TestRezFileMapped();
+	uTotal |= TestRezFileBatch();
+
+	FileManager::Shutdown();
+	return uTotal;
+}
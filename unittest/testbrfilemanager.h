@@ -19,5 +19,6 @@
 #endif
 
 extern Word FileManagerTest(Word uVerbose);
+extern Word FileManagerAsyncTest(Word uVerbose);
 
 #endif
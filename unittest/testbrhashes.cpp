@@ -21,10 +21,20 @@
 #include "brmd4.h"
 #include "brmd5.h"
 #include "brsha1.h"
+#include "brxxhash.h"
+#include "brsdbmhash.h"
+#include "brdjb2hash.h"
 #include "brgost.h"
 #include "brstringfunctions.h"
 #include "brfixedpoint.h"
 #include "brnumberstringhex.h"
+#include "brendian.h"
+#include "brtick.h"
+#include "brhashmap.h"
+#include "brhashmapflat.h"
+#include "brhashmapconcurrent.h"
+#include "brcriticalsection.h"
+#include "brmemoryansi.h"
 
 //
 // Test Crc32B
@@ -234,6 +244,282 @@ static Word TestCRC32(void)
 	return uFailure;
 }
 
+//
+// Test CalcCRC32C()
+// "123456789" is the standard CRC check string
+//
+
+struct CRC32CTest_t {
+	const char *m_pString;
+	Word32 m_CRC32C;
+};
+
+static const CRC32CTest_t g_CRC32CTestTable[] = {
+	{"",0x00000000},
+	{"a",0xC1D04330},
+	{"abc",0x364B3FB7},
+	{"123456789",0xE3069283},
+	{"message digest",0x02BD79D0},
+	{"The quick brown fox jumps over the lazy dog",0x22620404}
+};
+
+static Word TestCRC32C(void)
+{
+	Word uFailure = FALSE;
+	const CRC32CTest_t *pWork = g_CRC32CTestTable;
+	WordPtr uCount = BURGER_ARRAYSIZE(g_CRC32CTestTable);
+	do {
+		Word32 uTester = Burger::CalcCRC32C(pWork->m_pString,Burger::StringLength(pWork->m_pString));
+		Word uTest = (uTester!=pWork->m_CRC32C);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::CalcCRC32C(\"%s\") = 0x%08X, expected 0x%08X",uTest,pWork->m_pString,uTester,pWork->m_CRC32C);
+		}
+		++pWork;
+	} while (--uCount);
+	return uFailure;
+}
+
+//
+// Test the 8 byte and hardware paths against a byte at a time
+// CRC using all alignments, lengths and split buffers
+//
+
+static Word8 g_CRCBuffer[0x10000+16];
+
+static void FillCRCBuffer(void)
+{
+	Word32 uSeed = 0x12345678U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		g_CRCBuffer[i] = static_cast<Word8>(uSeed>>16U);
+	} while (++i<sizeof(g_CRCBuffer));
+}
+
+static Word32 ReferenceCRC(const Word32 *pTable,const Word8 *pInput,WordPtr uInputLength,Word bReflected)
+{
+	Word32 uCRC = 0xFFFFFFFFU;
+	if (uInputLength) {
+		do {
+			if (bReflected) {
+				uCRC = pTable[static_cast<Word8>(pInput[0]^uCRC)] ^ (uCRC>>8U);
+			} else {
+				uCRC = pTable[pInput[0]^(uCRC>>24U)]^(uCRC<<8U);
+			}
+			++pInput;
+		} while (--uInputLength);
+	}
+	if (!bReflected) {
+		uCRC = Burger::SwapEndian::Load(uCRC);
+	}
+	return ~uCRC;
+}
+
+static Word TestCRCLengths(void)
+{
+	Word32 CRC32BTable[256];
+	Word32 CRC32Table[256];
+	Word32 CRC32CTable[256];
+	Burger::GenerateCRCTable(CRC32BTable);
+	Burger::GenerateCRCTable(CRC32Table,0x04C11DB7U,FALSE);
+	Burger::GenerateCRCTable(CRC32CTable,0x1EDC6F41U);
+	FillCRCBuffer();
+
+	Word uFailure = FALSE;
+	WordPtr uLength = 0;
+	do {
+		Word uAlign = 0;
+		do {
+			const Word8 *pInput = g_CRCBuffer+uAlign;
+			Word32 uExpected = ReferenceCRC(CRC32BTable,pInput,uLength,TRUE);
+			Word32 uTester = Burger::CalcCRC32B(pInput,uLength);
+			Word uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CalcCRC32B(Buffer+%u,%u) = 0x%08X, expected 0x%08X",uTest,uAlign,static_cast<Word>(uLength),uTester,uExpected);
+
+			uExpected = ReferenceCRC(CRC32Table,pInput,uLength,FALSE);
+			uTester = Burger::CalcCRC32(pInput,uLength);
+			uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CalcCRC32(Buffer+%u,%u) = 0x%08X, expected 0x%08X",uTest,uAlign,static_cast<Word>(uLength),uTester,uExpected);
+
+			uExpected = ReferenceCRC(CRC32CTable,pInput,uLength,TRUE);
+			uTester = Burger::CalcCRC32C(pInput,uLength);
+			uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CalcCRC32C(Buffer+%u,%u) = 0x%08X, expected 0x%08X",uTest,uAlign,static_cast<Word>(uLength),uTester,uExpected);
+		} while (++uAlign<8);
+		// Test every small length and then skip through the larger ones
+		if (uLength<300) {
+			++uLength;
+		} else {
+			uLength = (uLength*3)+7;
+		}
+	} while (uLength<=0x10000);
+
+	// Chained calls must match a single call
+	const WordPtr uTotal = 0x10000;
+	WordPtr uSplit = 1;
+	do {
+		Word32 uExpected = Burger::CalcCRC32B(g_CRCBuffer,uTotal);
+		Word32 uTester = Burger::CalcCRC32B(g_CRCBuffer+uSplit,uTotal-uSplit,Burger::CalcCRC32B(g_CRCBuffer,uSplit));
+		Word uTest = (uTester!=uExpected);
+		uFailure |= uTest;
+		ReportFailure("Burger::CalcCRC32B() split at %u = 0x%08X, expected 0x%08X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+
+		uExpected = Burger::CalcCRC32(g_CRCBuffer,uTotal);
+		uTester = Burger::CalcCRC32(g_CRCBuffer+uSplit,uTotal-uSplit,Burger::CalcCRC32(g_CRCBuffer,uSplit));
+		uTest = (uTester!=uExpected);
+		uFailure |= uTest;
+		ReportFailure("Burger::CalcCRC32() split at %u = 0x%08X, expected 0x%08X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+
+		uExpected = Burger::CalcCRC32C(g_CRCBuffer,uTotal);
+		uTester = Burger::CalcCRC32C(g_CRCBuffer+uSplit,uTotal-uSplit,Burger::CalcCRC32C(g_CRCBuffer,uSplit));
+		uTest = (uTester!=uExpected);
+		uFailure |= uTest;
+		ReportFailure("Burger::CalcCRC32C() split at %u = 0x%08X, expected 0x%08X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+		uSplit = (uSplit*5)+3;
+	} while (uSplit<uTotal);
+	return uFailure;
+}
+
+//
+// Test the SIMD paths of the Adler checksums against a byte at a time
+// version using all alignments, lengths and split buffers
+//
+
+static Word32 ReferenceAdler(const Word8 *pInput,WordPtr uInputLength,Word32 uPrime,Word uShift)
+{
+	Word32 uAdditive = 1;
+	Word32 uFactorial = 0;
+	if (uInputLength) {
+		do {
+			uAdditive = (uAdditive+pInput[0])%uPrime;
+			uFactorial = (uFactorial+uAdditive)%uPrime;
+			++pInput;
+		} while (--uInputLength);
+	}
+	return (uFactorial<<uShift)+uAdditive;
+}
+
+static Word TestAdlerLengths(void)
+{
+	Word uFailure = FALSE;
+	Word uPass = 0;
+	do {
+		// The second pass uses all 0xFF to test for overflow
+		if (uPass) {
+			Burger::MemoryFill(g_CRCBuffer,0xFF,sizeof(g_CRCBuffer));
+		}
+		WordPtr uLength = 0;
+		do {
+			Word uAlign = 0;
+			do {
+				const Word8 *pInput = g_CRCBuffer+uAlign;
+				Word32 uExpected = ReferenceAdler(pInput,uLength,65521U,16);
+				Word32 uTester = Burger::CalcAdler32(pInput,uLength);
+				Word uTest = (uTester!=uExpected);
+				uFailure |= uTest;
+				ReportFailure("Burger::CalcAdler32(Buffer+%u,%u) = 0x%08X, expected 0x%08X",uTest,uAlign,static_cast<Word>(uLength),uTester,uExpected);
+
+				uExpected = ReferenceAdler(pInput,uLength,251U,8);
+				uTester = Burger::CalcAdler16(pInput,uLength);
+				uTest = (uTester!=uExpected);
+				uFailure |= uTest;
+				ReportFailure("Burger::CalcAdler16(Buffer+%u,%u) = 0x%04X, expected 0x%04X",uTest,uAlign,static_cast<Word>(uLength),uTester,uExpected);
+			} while (++uAlign<8);
+			// Test every small length and then skip through the larger ones
+			if (uLength<300) {
+				++uLength;
+			} else {
+				uLength = (uLength*3)+7;
+			}
+		} while (uLength<=0x10000);
+
+		// Chained calls must match a single call
+		const WordPtr uTotal = 0x10000;
+		WordPtr uSplit = 1;
+		do {
+			Word32 uExpected = Burger::CalcAdler32(g_CRCBuffer,uTotal);
+			Word32 uTester = Burger::CalcAdler32(g_CRCBuffer+uSplit,uTotal-uSplit,Burger::CalcAdler32(g_CRCBuffer,uSplit));
+			Word uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CalcAdler32() split at %u = 0x%08X, expected 0x%08X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+
+			// Checksums of the two halves must combine to the whole
+			uTester = Burger::CombineAdler32(Burger::CalcAdler32(g_CRCBuffer,uSplit),Burger::CalcAdler32(g_CRCBuffer+uSplit,uTotal-uSplit),uTotal-uSplit);
+			uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CombineAdler32() split at %u = 0x%08X, expected 0x%08X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+
+			uExpected = Burger::CalcAdler16(g_CRCBuffer,uTotal);
+			uTester = Burger::CalcAdler16(g_CRCBuffer+uSplit,uTotal-uSplit,Burger::CalcAdler16(g_CRCBuffer,uSplit));
+			uTest = (uTester!=uExpected);
+			uFailure |= uTest;
+			ReportFailure("Burger::CalcAdler16() split at %u = 0x%04X, expected 0x%04X",uTest,static_cast<Word>(uSplit),uTester,uExpected);
+			uSplit = (uSplit*5)+3;
+		} while (uSplit<uTotal);
+	} while (++uPass<2);
+
+	// Restore the random data for the other tests
+	FillCRCBuffer();
+	return uFailure;
+}
+
+//
+// Display the throughput of the Adler checksums
+//
+
+static void TestAdlerSpeed(void)
+{
+	const Word cPasses = 256;
+	Word uPass = 0;
+	do {
+		Word32 uChecksum = 1;
+		Word uCount = cPasses;
+		Burger::FloatTimer Timer;
+		do {
+			if (!uPass) {
+				uChecksum = Burger::CalcAdler16(g_CRCBuffer,0x10000,uChecksum);
+			} else {
+				uChecksum = Burger::CalcAdler32(g_CRCBuffer,0x10000,uChecksum);
+			}
+		} while (--uCount);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		Message("Burger::%s() %u MB/s (0x%08X)",uPass ? "CalcAdler32" : "CalcAdler16",static_cast<Word>(static_cast<float>(cPasses)/(16.0f*fTime)),uChecksum);
+	} while (++uPass<2);
+}
+
+//
+// Display the throughput of the CRC functions
+//
+
+static void TestCRCSpeed(void)
+{
+	const Word cPasses = 256;
+	typedef Word32 (BURGER_API *CRCProc_t)(const void *,WordPtr,Word32);
+	static const char *s_Names[3] = {"CalcCRC32B","CalcCRC32","CalcCRC32C"};
+	static const CRCProc_t s_Procs[3] = {Burger::CalcCRC32B,Burger::CalcCRC32,Burger::CalcCRC32C};
+	Word i = 0;
+	do {
+		Word32 uCRC = 0;
+		Word uCount = cPasses;
+		Burger::FloatTimer Timer;
+		do {
+			uCRC = s_Procs[i](g_CRCBuffer,0x10000,uCRC);
+		} while (--uCount);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		Message("Burger::%s() %u MB/s (0x%08X)",s_Names[i],static_cast<Word>(static_cast<float>(cPasses)/(16.0f*fTime)),uCRC);
+	} while (++i<3);
+}
+
 //
 // Test CalcCRC16IBM()
 //
@@ -343,6 +629,317 @@ static Word TestSHA1(void)
 	return uFailure;
 }
 
+//
+// Hash a million letter 'a's to test the multiple block paths
+// against known values
+//
+
+static Word TestMillionA(void)
+{
+	static const Burger::MD5_t s_MD5 = {{0x77,0x07,0xD6,0xAE,0x4E,0x02,0x7C,0x70,0xEE,0xA2,0xA9,0x35,0xC2,0x29,0x6F,0x21}};
+	static const Burger::SHA1_t s_SHA1 = {{0x34,0xAA,0x97,0x3C,0xD4,0xC4,0xDA,0xA4,0xF6,0x1E,
+		0xEB,0x2B,0xDB,0xAD,0x27,0x31,0x65,0x34,0x01,0x6F}};
+	Word8 Buffer[10000];
+	Burger::MemoryFill(Buffer,'a',sizeof(Buffer));
+
+	Burger::MD5Hasher_t MD5Context;
+	Burger::SHA1Hasher_t SHA1Context;
+	MD5Context.Init();
+	SHA1Context.Init();
+	Word i = 0;
+	do {
+		MD5Context.Process(Buffer,sizeof(Buffer));
+		SHA1Context.Process(Buffer,sizeof(Buffer));
+	} while (++i<100);
+	MD5Context.Finalize();
+	SHA1Context.Finalize();
+
+	Word uFailure = static_cast<Word>(Burger::MemoryCompare(&MD5Context.m_Hash,&s_MD5,sizeof(s_MD5)));
+	if (uFailure) {
+		ReportFailure("Burger::MD5Hasher_t a million 'a's = 0x%02X%02X%02X%02X, expected 0x7707D6AE",uFailure,MD5Context.m_Hash.m_Hash[0],MD5Context.m_Hash.m_Hash[1],MD5Context.m_Hash.m_Hash[2],MD5Context.m_Hash.m_Hash[3]);
+	}
+	Word uTest = static_cast<Word>(Burger::MemoryCompare(&SHA1Context.m_Hash,&s_SHA1,sizeof(s_SHA1)));
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::SHA1Hasher_t a million 'a's = 0x%02X%02X%02X%02X, expected 0x34AA973C",uTest,SHA1Context.m_Hash.m_Hash[0],SHA1Context.m_Hash.m_Hash[1],SHA1Context.m_Hash.m_Hash[2],SHA1Context.m_Hash.m_Hash[3]);
+	}
+	return uFailure;
+}
+
+//
+// Test HashMultiple() against Hash() with uneven lengths and group sizes
+//
+
+static Word TestHashMultiple(void)
+{
+	const void *Inputs[19];
+	WordPtr Lengths[19];
+	Burger::MD5_t MD5Output[19];
+	Burger::SHA1_t SHA1Output[19];
+
+	// Mix of similar and very different lengths, some less than a block
+	Word i = 0;
+	do {
+		Inputs[i] = g_CRCBuffer+(i*97);
+		Lengths[i] = (i&3) ? (4096+(i*131)) : (i*7);
+	} while (++i<19);
+
+	Word uFailure = FALSE;
+	WordPtr uCount = 0;
+	do {
+		Burger::HashMultiple(MD5Output,Inputs,Lengths,uCount);
+		Burger::HashMultiple(SHA1Output,Inputs,Lengths,uCount);
+		i = 0;
+		if (uCount) {
+			do {
+				Burger::MD5_t MD5Test;
+				Burger::Hash(&MD5Test,Inputs[i],Lengths[i]);
+				Word uTest = static_cast<Word>(Burger::MemoryCompare(&MD5Test,&MD5Output[i],sizeof(MD5Test)));
+				uFailure |= uTest;
+				if (uTest) {
+					ReportFailure("Burger::HashMultiple(MD5_t) count %u, entry %u, length %u",uTest,static_cast<Word>(uCount),i,static_cast<Word>(Lengths[i]));
+				}
+				Burger::SHA1_t SHA1Test;
+				Burger::Hash(&SHA1Test,Inputs[i],Lengths[i]);
+				uTest = static_cast<Word>(Burger::MemoryCompare(&SHA1Test,&SHA1Output[i],sizeof(SHA1Test)));
+				uFailure |= uTest;
+				if (uTest) {
+					ReportFailure("Burger::HashMultiple(SHA1_t) count %u, entry %u, length %u",uTest,static_cast<Word>(uCount),i,static_cast<Word>(Lengths[i]));
+				}
+			} while (++i<uCount);
+		}
+	} while (++uCount<=19);
+	return uFailure;
+}
+
+//
+// Display the throughput of hashing one buffer at a time
+// versus several buffers at once
+//
+
+static void TestHashSpeed(void)
+{
+	const Word cPasses = 256;
+	const void *Inputs[8];
+	WordPtr Lengths[8];
+	Word i = 0;
+	do {
+		Inputs[i] = g_CRCBuffer+(i*0x2000);
+		Lengths[i] = 0x2000;
+	} while (++i<8);
+
+	Burger::MD5_t MD5Output[8];
+	Burger::SHA1_t SHA1Output[8];
+	Word uPass = 0;
+	do {
+		Burger::FloatTimer Timer;
+		Word uCount = cPasses;
+		do {
+			switch (uPass) {
+			case 0:
+				i = 0;
+				do {
+					Burger::Hash(&MD5Output[i],Inputs[i],Lengths[i]);
+				} while (++i<8);
+				break;
+			case 1:
+				Burger::HashMultiple(MD5Output,Inputs,Lengths,8);
+				break;
+			case 2:
+				i = 0;
+				do {
+					Burger::Hash(&SHA1Output[i],Inputs[i],Lengths[i]);
+				} while (++i<8);
+				break;
+			default:
+				Burger::HashMultiple(SHA1Output,Inputs,Lengths,8);
+				break;
+			}
+		} while (--uCount);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		static const char *s_Names[4] = {"Hash(MD5_t)","HashMultiple(MD5_t)","Hash(SHA1_t)","HashMultiple(SHA1_t)"};
+		Message("Burger::%s %u MB/s",s_Names[uPass],static_cast<Word>(static_cast<float>(cPasses)/(16.0f*fTime)));
+	} while (++uPass<4);
+}
+
+//
+// Test xxHash64
+// Codes generated with the reference xxHash library
+//
+
+struct XXHash64Test_t {
+	const char *m_pString;
+	Word64 m_uHash;			// Seed of zero
+	Word64 m_uHashSeed;		// Seed of 0x1234567
+};
+
+static const XXHash64Test_t g_XXHash64TestTable[] = {
+	{"",0xEF46DB3751D8E999ULL,0x7ADD8165952A2CF0ULL},
+	{"a",0xD24EC4F1A98C6E5BULL,0x28295D7981302C17ULL},
+	{"abc",0x44BC2CF5AD770999ULL,0xF59EAB63A01ABF9EULL},
+	{"message digest",0x066ED728FCEEB3BEULL,0xF5FE06A16A47CC1EULL},
+	{"abcdefghijklmnopqrstuvwxyz",0xCFE1F278FA89835CULL,0x5E3AE4900ED97AD0ULL},
+	{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",0xAAA46907D3047814ULL,0x15B506538BAEC544ULL},
+	{"12345678901234567890123456789012345678901234567890123456789012345678901234567890",0xE04A477F19EE145DULL,0x6A4BA9178680BB4CULL}
+};
+
+static Word TestXXHash64(void)
+{
+	Word uFailure = FALSE;
+	const XXHash64Test_t *pWork = g_XXHash64TestTable;
+	WordPtr uCount = BURGER_ARRAYSIZE(g_XXHash64TestTable);
+	do {
+		WordPtr uLength = Burger::StringLength(pWork->m_pString);
+		Word64 uHash = Burger::XXHash64(pWork->m_pString,uLength);
+		Word uTest = uHash!=pWork->m_uHash;
+		uHash = Burger::XXHash64(pWork->m_pString,uLength,0x1234567);
+		uTest |= uHash!=pWork->m_uHashSeed;
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::XXHash64(\"%s\") = 0x%08X%08X, expected 0x%08X%08X",uTest,pWork->m_pString,static_cast<Word32>(uHash>>32U),static_cast<Word32>(uHash),static_cast<Word32>(pWork->m_uHashSeed>>32U),static_cast<Word32>(pWork->m_uHashSeed));
+		}
+
+		// Split the data at every position and hash with the multi-pass hasher
+		WordPtr uSplit = 0;
+		do {
+			Burger::XXHash64Hasher_t Context;
+			Context.Init(0x1234567);
+			Context.Process(pWork->m_pString,uSplit);
+			Context.Process(pWork->m_pString+uSplit,uLength-uSplit);
+			Context.Finalize();
+			uTest = Context.m_uHash!=pWork->m_uHashSeed;
+			uFailure |= uTest;
+			if (uTest) {
+				ReportFailure("Burger::XXHash64Hasher_t(\"%s\") split at %u",uTest,pWork->m_pString,static_cast<Word>(uSplit));
+			}
+		} while (++uSplit<=uLength);
+		++pWork;
+	} while (--uCount);
+
+	// Case insensitive hashing on short and long data
+	Word8 Upper[1000];
+	Word8 Lower[1000];
+	WordPtr i = 0;
+	do {
+		Word8 uChar = static_cast<Word8>('A'+(i%26));
+		Upper[i] = uChar;
+		Lower[i] = static_cast<Word8>(uChar+32);
+	} while (++i<sizeof(Upper));
+	static const WordPtr s_Lengths[5] = {0,5,31,256,1000};
+	i = 0;
+	do {
+		Word64 uHash = Burger::XXHash64Case(Upper,s_Lengths[i],99);
+		Word uTest = (uHash!=Burger::XXHash64(Lower,s_Lengths[i],99)) || (uHash!=Burger::XXHash64Case(Lower,s_Lengths[i],99));
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::XXHash64Case() length %u",uTest,static_cast<Word>(s_Lengths[i]));
+		}
+	} while (++i<BURGER_ARRAYSIZE(s_Lengths));
+
+	// Random bytes, to test the characters around 'A' and 'Z' and high ASCII
+	i = 0;
+	do {
+		Lower[i] = static_cast<Word8>(Burger::ToLower(g_CRCBuffer[i]));
+	} while (++i<sizeof(Lower));
+	Word uTest = Burger::XXHash64Case(g_CRCBuffer,sizeof(Lower))!=Burger::XXHash64(Lower,sizeof(Lower));
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::XXHash64Case() with random data",uTest);
+	}
+	return uFailure;
+}
+
+//
+// Display the throughput of the general purpose hashes
+//
+
+static void TestXXHash64Speed(void)
+{
+	const Word cPasses = 256;
+	Word uPass = 0;
+	do {
+		Word64 uHash = 0;
+		Word uCount = cPasses;
+		Burger::FloatTimer Timer;
+		do {
+			switch (uPass) {
+			case 0:
+				uHash += Burger::SDBMHash(g_CRCBuffer,0x10000);
+				break;
+			case 1:
+				uHash += Burger::DJB2HashXor(g_CRCBuffer,0x10000);
+				break;
+			case 2:
+				uHash += Burger::XXHash64Case(g_CRCBuffer,0x10000);
+				break;
+			default:
+				uHash += Burger::XXHash64(g_CRCBuffer,0x10000);
+				break;
+			}
+		} while (--uCount);
+		float fTime = Timer.GetTime();
+		if (fTime<=0.0f) {
+			fTime = 0.000001f;
+		}
+		static const char *s_Names[4] = {"SDBMHash","DJB2HashXor","XXHash64Case","XXHash64"};
+		Message("Burger::%s() %u MB/s (0x%08X)",s_Names[uPass],static_cast<Word>(static_cast<float>(cPasses)/(16.0f*fTime)),static_cast<Word32>(uHash));
+	} while (++uPass<4);
+}
+
+//
+// Time HashMap lookups of long String keys with a hash function
+//
+
+static void TimeLongKeys(const char *pName,WordPtr (BURGER_API *pHashProc)(const void *,WordPtr))
+{
+	const Word cCount = 256;
+	const Word cKeyLength = 120;
+	Burger::String Keys[cCount];
+	char Buffer[cKeyLength];
+	Word i = 0;
+	do {
+		// Pathnames with a long common prefix
+		Word j = 0;
+		do {
+			Buffer[j] = static_cast<char>('a'+(g_CRCBuffer[(i*cKeyLength)+j]%26U));
+		} while (++j<cKeyLength);
+		Burger::MemoryCopy(Buffer,"data:textures:level:",20);
+		Keys[i].Set(Buffer,cKeyLength);
+	} while (++i<cCount);
+
+	Burger::HashMap<Burger::String,Word32> Map(pHashProc);
+	i = 0;
+	do {
+		Map.add(Keys[i],i);
+	} while (++i<cCount);
+
+	Burger::FloatTimer Timer;
+	Word32 uSum = 0;
+	Word uPass = 0;
+	do {
+		i = 0;
+		do {
+			const Word32 *pData = Map.GetData(Keys[i]);
+			if (pData) {
+				uSum += pData[0];
+			}
+		} while (++i<cCount);
+	} while (++uPass<1000);
+	float fFind = Timer.GetTime();
+	Message("HashMap<String,Word32> with %s %u lookups/ms (%u)",pName,
+		static_cast<Word>(static_cast<float>(cCount*1000)/(fFind*1000.0f+0.001f)),uSum);
+}
+
+static void TestLongKeySpeed(void)
+{
+	Burger::MemoryManagerGlobalANSI Memory;
+	TimeLongKeys("DJB2StringHashXorFunctor",Burger::DJB2StringHashXorFunctor);
+	TimeLongKeys("XXHash64StringFunctor",Burger::XXHash64StringFunctor);
+}
+
 //
 // Test GOST
 //
@@ -364,6 +961,330 @@ static Word TestGOST(void)
 	} while (--uCount);
 	return uFailure;
 }
+//
+// Test HashMapFlat
+//
+
+static Word32 HashMapTestKey(Word32 uIndex)
+{
+	// Spread the keys so they aren't sequential
+	return (uIndex*2654435761U)^0x5A5A5A5AU;
+}
+
+static Word TestHashMapFlat(void)
+{
+	Burger::MemoryManagerGlobalANSI Memory;
+	const Word cCount = 20000;
+	Word uFailure = FALSE;
+	Burger::HashMapFlat<Word32,Word32> Map;
+
+	Word i = 0;
+	do {
+		Map.add(HashMapTestKey(i),i);
+	} while (++i<cCount);
+	Word uTest = Map.GetEntryCount()!=cCount;
+	uFailure |= uTest;
+	ReportFailure("HashMapFlat::GetEntryCount() = %u, expected %u",uTest,static_cast<Word>(Map.GetEntryCount()),cCount);
+
+	// Erase the odd entries
+	i = 1;
+	do {
+		Map.erase(HashMapTestKey(i));
+		i += 2;
+	} while (i<cCount);
+
+	i = 0;
+	do {
+		const Word32 *pData = Map.GetData(HashMapTestKey(i));
+		if (i&1) {
+			uTest = pData!=NULL;
+		} else {
+			uTest = !pData || (pData[0]!=i);
+		}
+		uFailure |= uTest;
+		ReportFailure("HashMapFlat::GetData(0x%08X) failed on entry %u",uTest,HashMapTestKey(i),i);
+	} while (++i<cCount);
+
+	// Reuse the erased entries
+	i = 1;
+	do {
+		Map[HashMapTestKey(i)] = i;
+		i += 2;
+	} while (i<cCount);
+
+	// Iterate over the table and copy it
+	Burger::HashMapFlat<Word32,Word32> Copy(Map);
+	Word uIterated = 0;
+	Burger::HashMapFlat<Word32,Word32>::const_iterator it = Copy.begin();
+	while (it!=Copy.end()) {
+		uTest = it->first!=HashMapTestKey(it->second);
+		uFailure |= uTest;
+		ReportFailure("HashMapFlat::const_iterator has key 0x%08X for data %u",uTest,it->first,it->second);
+		++uIterated;
+		++it;
+	}
+	uTest = (uIterated!=cCount) || (Copy.GetEntryCount()!=cCount);
+	uFailure |= uTest;
+	ReportFailure("HashMapFlat copy iterated %u entries, expected %u",uTest,uIterated,cCount);
+
+	// Erase while iterating
+	Burger::HashMapFlat<Word32,Word32>::iterator it2 = Copy.begin();
+	while (it2!=Copy.end()) {
+		Copy.erase(it2);
+		++it2;
+	}
+	uTest = !Copy.IsEmpty() || (Copy.begin()!=Copy.end());
+	uFailure |= uTest;
+	ReportFailure("HashMapFlat::erase() left %u entries",uTest,static_cast<Word>(Copy.GetEntryCount()));
+
+	// Case insensitive strings
+	Burger::HashMapFlatStringCase<Word> StringMap;
+	StringMap.Set(Burger::String("Burgerlib"),1);
+	StringMap.Set(Burger::String("BURGERLIB"),2);
+	StringMap.Set(Burger::String("Becky"),3);
+	Word uValue = 0;
+	uTest = (StringMap.GetEntryCount()!=2) || !StringMap.GetData(Burger::String("burgerLIB"),&uValue) || (uValue!=2);
+	uFailure |= uTest;
+	ReportFailure("HashMapFlatStringCase::GetData(\"burgerLIB\") = %u, expected 2",uTest,uValue);
+	return uFailure;
+}
+
+//
+// Compare the throughput of HashMap and HashMapFlat
+//
+
+template<class T>
+static void TimeHashMap(const char *pName)
+{
+	const Word cCount = 200000;
+	T Map;
+	Burger::FloatTimer Timer;
+	Word i = 0;
+	do {
+		Map.add(HashMapTestKey(i),i);
+	} while (++i<cCount);
+	float fInsert = Timer.GetTime();
+
+	Timer.Reset();
+	Word32 uSum = 0;
+	Word uPass = 0;
+	do {
+		i = 0;
+		do {
+			// Half of the lookups miss
+			const Word32 *pData = Map.GetData(HashMapTestKey(i+(uPass&1)*cCount));
+			if (pData) {
+				uSum += pData[0];
+			}
+		} while (++i<cCount);
+	} while (++uPass<4);
+	float fFind = Timer.GetTime();
+
+	Timer.Reset();
+	i = 0;
+	do {
+		Map.erase(HashMapTestKey(i));
+	} while (++i<cCount);
+	float fErase = Timer.GetTime();
+	Message("%s insert %u/ms, find %u/ms, erase %u/ms (%u)",pName,
+		static_cast<Word>(static_cast<float>(cCount)/(fInsert*1000.0f+0.001f)),
+		static_cast<Word>(static_cast<float>(cCount*4)/(fFind*1000.0f+0.001f)),
+		static_cast<Word>(static_cast<float>(cCount)/(fErase*1000.0f+0.001f)),uSum);
+}
+
+static void TestHashMapSpeed(void)
+{
+	Burger::MemoryManagerGlobalANSI Memory;
+	TimeHashMap<Burger::HashMap<Word32,Word32> >("HashMap<Word32,Word32>");
+	TimeHashMap<Burger::HashMapFlat<Word32,Word32> >("HashMapFlat<Word32,Word32>");
+}
+
+//
+// Test HashMapConcurrent
+//
+
+typedef Burger::HashMapConcurrent<Word32,Word32> ConcurrentMap_t;
+
+struct ConcurrentTest_t {
+	ConcurrentMap_t *m_pMap;		// Shared hash
+	Word m_uThread;					// Thread number
+	Word m_uCount;					// Number of keys for this thread
+	Word m_uFailures;				// Number of failed operations
+};
+
+static WordPtr BURGER_API ConcurrentInsert(void *pData)
+{
+	ConcurrentTest_t *pTest = static_cast<ConcurrentTest_t *>(pData);
+	Word uBase = pTest->m_uThread*pTest->m_uCount;
+	Word i = 0;
+	do {
+		if (!pTest->m_pMap->Insert(HashMapTestKey(uBase+i),uBase+i)) {
+			++pTest->m_uFailures;
+		}
+		// Read back a key from this thread
+		Word32 uValue;
+		if (!pTest->m_pMap->GetData(HashMapTestKey(uBase+(i>>1)),&uValue) || (uValue!=(uBase+(i>>1)))) {
+			++pTest->m_uFailures;
+		}
+	} while (++i<pTest->m_uCount);
+	// Erase the odd keys
+	i = 1;
+	do {
+		if (!pTest->m_pMap->Erase(HashMapTestKey(uBase+i))) {
+			++pTest->m_uFailures;
+		}
+		i += 2;
+	} while (i<pTest->m_uCount);
+	return 0;
+}
+
+static Word TestHashMapConcurrent(void)
+{
+	const Word cThreads = 4;
+	const Word cCount = 5000;
+	Burger::MemoryManagerGlobalANSI Memory;
+	ConcurrentMap_t Map;
+	ConcurrentTest_t Tests[cThreads];
+	Burger::Thread Threads[cThreads];
+	Word i = 0;
+	do {
+		Tests[i].m_pMap = &Map;
+		Tests[i].m_uThread = i;
+		Tests[i].m_uCount = cCount;
+		Tests[i].m_uFailures = 0;
+		Threads[i].Start(ConcurrentInsert,&Tests[i]);
+	} while (++i<cThreads);
+	Word uFailure = FALSE;
+	i = 0;
+	do {
+		Threads[i].Wait();
+		Word uTest = Tests[i].m_uFailures!=0;
+		uFailure |= uTest;
+		ReportFailure("HashMapConcurrent thread %u had %u failed operations",uTest,i,Tests[i].m_uFailures);
+	} while (++i<cThreads);
+
+	Word uTest = Map.GetEntryCount()!=((cThreads*cCount)/2);
+	uFailure |= uTest;
+	ReportFailure("HashMapConcurrent::GetEntryCount() = %u, expected %u",uTest,static_cast<Word>(Map.GetEntryCount()),(cThreads*cCount)/2);
+	i = 0;
+	do {
+		uTest = Map.IsPresent(HashMapTestKey(i))==(i&1);
+		uFailure |= uTest;
+		ReportFailure("HashMapConcurrent::IsPresent(0x%08X) failed on entry %u",uTest,HashMapTestKey(i),i);
+	} while (++i<(cThreads*cCount));
+	return uFailure;
+}
+
+//
+// Compare a single locked HashMap with HashMapConcurrent
+// as the number of threads increases
+//
+
+struct ContentionTest_t {
+	ConcurrentMap_t *m_pConcurrent;				// Sharded hash or NULL
+	Burger::HashMap<Word32,Word32> *m_pHashMap;	// Single hash
+	Burger::CriticalSection *m_pLock;			// Lock for the single hash
+	Word m_uThread;								// Thread number
+	Word32 m_uSum;								// Sum of the data found
+	Word m_uContentions;						// Times the single hash lock was held by another thread
+};
+
+static const Word g_uContentionKeys = 4096;
+static const Word g_uContentionOperations = 100000;
+
+static WordPtr BURGER_API ContentionThread(void *pData)
+{
+	ContentionTest_t *pTest = static_cast<ContentionTest_t *>(pData);
+	Word32 uSum = 0;
+	Word uContentions = 0;
+	Word32 uSeed = pTest->m_uThread*0x9E3779B9U;
+	Word i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		Word32 uKey = HashMapTestKey((uSeed>>8U)%g_uContentionKeys);
+		// One write for every 16 reads
+		Word bWrite = !((uSeed>>4U)&15U);
+		if (pTest->m_pConcurrent) {
+			if (bWrite) {
+				pTest->m_pConcurrent->Set(uKey,i);
+			} else {
+				Word32 uValue;
+				if (pTest->m_pConcurrent->GetData(uKey,&uValue)) {
+					uSum += uValue;
+				}
+			}
+		} else {
+			// Count the same way as the sharded hash does
+			if (!pTest->m_pLock->TryLock()) {
+				pTest->m_pLock->Lock();
+				++uContentions;
+			}
+			if (bWrite) {
+				pTest->m_pHashMap->Set(uKey,i);
+			} else {
+				const Word32 *pValue = pTest->m_pHashMap->GetData(uKey);
+				if (pValue) {
+					uSum += pValue[0];
+				}
+			}
+			pTest->m_pLock->Unlock();
+		}
+	} while (++i<g_uContentionOperations);
+	pTest->m_uSum = uSum;
+	pTest->m_uContentions = uContentions;
+	return 0;
+}
+
+static void TestHashMapContention(void)
+{
+	const Word cMaxThreads = 8;
+	Burger::MemoryManagerGlobalANSI Memory;
+	ConcurrentMap_t Concurrent;
+	Burger::HashMap<Word32,Word32> HashMap;
+	Burger::CriticalSection Lock;
+	Word i = 0;
+	do {
+		Concurrent.Set(HashMapTestKey(i),i);
+		HashMap.Set(HashMapTestKey(i),i);
+	} while (++i<g_uContentionKeys);
+
+	Word uThreadCount = 1;
+	do {
+		Word uPass = 0;
+		do {
+			ContentionTest_t Tests[cMaxThreads];
+			Burger::Thread Threads[cMaxThreads];
+			Concurrent.ResetContentionCount();
+			Burger::FloatTimer Timer;
+			i = 0;
+			do {
+				Tests[i].m_pConcurrent = uPass ? &Concurrent : NULL;
+				Tests[i].m_pHashMap = &HashMap;
+				Tests[i].m_pLock = &Lock;
+				Tests[i].m_uThread = i;
+				Threads[i].Start(ContentionThread,&Tests[i]);
+			} while (++i<uThreadCount);
+			Word uContentions = 0;
+			i = 0;
+			do {
+				Threads[i].Wait();
+				uContentions += Tests[i].m_uContentions;
+			} while (++i<uThreadCount);
+			float fTime = Timer.GetTime();
+			if (uPass) {
+				uContentions = static_cast<Word>(Concurrent.GetContentionCount());
+			}
+			if (fTime<=0.0f) {
+				fTime = 0.000001f;
+			}
+			Message("%s, %u thread(s), %u operations/ms, %u contentions",uPass ? "HashMapConcurrent" : "HashMap+CriticalSection",
+				uThreadCount,static_cast<Word>(static_cast<float>(g_uContentionOperations*uThreadCount)/(fTime*1000.0f)),
+				uContentions);
+		} while (++uPass<2);
+		uThreadCount <<= 1;
+	} while (uThreadCount<=cMaxThreads);
+}
+
 //
 // Test hash code
 //
@@ -378,12 +1299,30 @@ int BURGER_API TestBrhashes(Word bVerbose)
 	uResult |= TestAdler32();
 	uResult |= TestCRC32B();
 	uResult |= TestCRC32();
+	uResult |= TestCRC32C();
+	uResult |= TestCRCLengths();
+	uResult |= TestAdlerLengths();
 	uResult |= TestCRC16IBM();
 	uResult |= TestMD2();
 	uResult |= TestMD4();
 	uResult |= TestMD5();
 	uResult |= TestSHA1();
+	uResult |= TestMillionA();
+	uResult |= TestHashMultiple();
+	uResult |= TestXXHash64();
 	uResult |= TestGOST();
+	uResult |= TestHashMapFlat();
+	uResult |= TestHashMapConcurrent();
+
+	if (bVerbose) {
+		TestCRCSpeed();
+		TestAdlerSpeed();
+		TestHashSpeed();
+		TestXXHash64Speed();
+		TestLongKeySpeed();
+		TestHashMapSpeed();
+		TestHashMapContention();
+	}
 
 	if (!uResult && bVerbose) {
 		Message("Passed all Hashing tests!");
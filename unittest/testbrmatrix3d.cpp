@@ -66,19 +66,82 @@ static Word TestMultiply(void)
 	return uResult;
 }
 
+//
+// Test the array transforms against the single vector functions
+//
+
+static Word TestBatchTransform(void)
+{
+	const WordPtr cCount = 23;		// Not a multiple of 4 or 8
+	Word uResult = 0;
+	Matrix3D_t Matrix;
+	Matrix.SetYXZ(0.5f,-0.25f,1.25f);
+	Vector3D_t Translate;
+	Translate.Set(3.0f,-5.0f,7.0f);
+
+	Vector3D_t Input[cCount];
+	Vector3D_t Output[cCount];
+	Vector3D_t OutputAdd[cCount];
+	float SoAInput[3][cCount];
+	float SoAOutput[3][cCount];
+	WordPtr i = 0;
+	do {
+		float fValue = static_cast<float>(static_cast<int>(i));
+		Input[i].Set(fValue*0.5f-3.0f,7.0f-fValue,fValue*fValue*0.125f);
+		SoAInput[0][i] = Input[i].x;
+		SoAInput[1][i] = Input[i].y;
+		SoAInput[2][i] = Input[i].z;
+	} while (++i<cCount);
+
+	Vector3DSoA_t SoAIn;
+	SoAIn.m_pX = SoAInput[0];
+	SoAIn.m_pY = SoAInput[1];
+	SoAIn.m_pZ = SoAInput[2];
+	Vector3DSoA_t SoAOut;
+	SoAOut.m_pX = SoAOutput[0];
+	SoAOut.m_pY = SoAOutput[1];
+	SoAOut.m_pZ = SoAOutput[2];
+
+	Matrix.Transform(Output,Input,cCount);
+	Matrix.TransformAdd(OutputAdd,Input,&Translate,cCount);
+	Matrix.Transform(&SoAOut,&SoAIn,cCount);
+	i = 0;
+	do {
+		Vector3D_t Expected;
+		Matrix.Transform(&Expected,&Input[i]);
+		Vector3D_t SoAResult;
+		SoAResult.Set(SoAOutput[0][i],SoAOutput[1][i],SoAOutput[2][i]);
+		Word uTest = !Expected.Equal(&Output[i],0.0001f) || !Expected.Equal(&SoAResult,0.0001f);
+		Matrix.TransformAdd(&Expected,&Input[i],&Translate);
+		uTest |= !Expected.Equal(&OutputAdd[i],0.0001f);
+		if (uTest) {
+			ReportFailure("Matrix3D_t batch transform entry %u",uTest,static_cast<Word>(i));
+			uResult = 1;
+			break;
+		}
+	} while (++i<cCount);
+	return uResult;
+}
+
 //
 // Perform all the tests for the Burgerlib FP Math library
 //
 
-int BURGER_API TestBrmatrix3d(void)
+int BURGER_API TestBrmatrix3d(Word bVerbose)
 {
 #if !defined(BURGER_68K)
 
 	Word uTotal;	// Assume no failures
 
-	Message("Running Matrix3D tests");
+	if (bVerbose) {
+		Message("Running Matrix3D tests");
+	}
 	uTotal = TestMultiply();
+	uTotal |= TestBatchTransform();
 
+	if (!uTotal && bVerbose) {
+		Message("Passed all Matrix3D tests!");
+	}
 	return static_cast<int>(uTotal);
 #else
 	return 0;
@@ -18,6 +18,6 @@
 #include "brtypes.h"
 #endif
 
-extern int BURGER_API TestBrmatrix3d(void);
+extern int BURGER_API TestBrmatrix3d(Word bVerbose);
 
 #endif
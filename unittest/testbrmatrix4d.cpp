@@ -14,7 +14,11 @@
 #include "testbrmatrix4d.h"
 #include "common.h"
 #include "brmatrix4d.h"
+#include "brfrustum.h"
 #include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryansi.h"
+#include "brtick.h"
 
 using namespace Burger;
 
@@ -100,19 +104,659 @@ static Word TestMultiply(void)
 	return uResult;
 }
 
+//
+// Fill matrices with values from -4 to 4
+//
+
+static void FillMatrices(Matrix4D_t *pOutput,WordPtr uCount,Word32 uSeed)
+{
+	float *pWork = &pOutput->x.x;
+	WordPtr i = uCount*16;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		pWork[0] = static_cast<float>(static_cast<int>(uSeed>>16U)&0x3FF)*(1.0f/128.0f)-4.0f;
+		++pWork;
+	} while (--i);
+}
+
+//
+// Return TRUE if two matrices don't match within a range
+//
+
+static Word MatrixDiffers(const Matrix4D_t *pInput1,const Matrix4D_t *pInput2,float fRange)
+{
+	const float *pA = &pInput1->x.x;
+	const float *pB = &pInput2->x.x;
+	Word i = 0;
+	do {
+		if (Abs(pA[i]-pB[i])>fRange) {
+			return TRUE;
+		}
+	} while (++i<16);
+	return FALSE;
+}
+
+//
+// Test the matrix multiply against the formula
+// and the array multiply against the single multiply
+//
+
+static Word TestMultiplyArray(void)
+{
+	const WordPtr cCount = 9;
+	Word uResult = 0;
+	Matrix4D_t Input1[cCount];
+	Matrix4D_t Input2[cCount];
+	Matrix4D_t Output[cCount];
+	Matrix4D_t Expected;
+	FillMatrices(Input1,cCount,0x3141592U);
+	FillMatrices(Input2,cCount,0x2718281U);
+
+	WordPtr i = 0;
+	do {
+		// Scalar reference
+		const Matrix4D_t *pA = &Input1[i];
+		const Matrix4D_t *pB = &Input2[i];
+		Word uRow = 0;
+		do {
+			const Vector4D_t *pRow = &(&pB->x)[uRow];
+			Vector4D_t *pOutput = &(&Expected.x)[uRow];
+			pOutput->x = (pA->x.x*pRow->x)+(pA->y.x*pRow->y)+(pA->z.x*pRow->z)+(pA->w.x*pRow->w);
+			pOutput->y = (pA->x.y*pRow->x)+(pA->y.y*pRow->y)+(pA->z.y*pRow->z)+(pA->w.y*pRow->w);
+			pOutput->z = (pA->x.z*pRow->x)+(pA->y.z*pRow->y)+(pA->z.z*pRow->z)+(pA->w.z*pRow->w);
+			pOutput->w = (pA->x.w*pRow->x)+(pA->y.w*pRow->y)+(pA->z.w*pRow->z)+(pA->w.w*pRow->w);
+		} while (++uRow<4);
+
+		Matrix4D_t Test;
+		Test.Multiply(pA,pB);
+		Word uTest = MatrixDiffers(&Test,&Expected,0.0001f);
+		Test = *pA;
+		Test.Multiply(pB);
+		uTest |= MatrixDiffers(&Test,&Expected,0.0001f);
+		if (uTest) {
+			ReportFailure("Matrix4D_t::Multiply(const Matrix4D_t *,const Matrix4D_t *) entry %u",uTest,static_cast<Word>(i));
+			uResult = 1;
+		}
+	} while (++i<cCount);
+
+	Matrix4D_t::Multiply(Output,Input1,Input2,cCount);
+	i = 0;
+	do {
+		Expected.Multiply(&Input1[i],&Input2[i]);
+		Word uTest = MatrixDiffers(&Output[i],&Expected,0.0001f);
+		if (uTest) {
+			ReportFailure("Matrix4D_t::Multiply(Matrix4D_t *,const Matrix4D_t *,const Matrix4D_t *,WordPtr) entry %u",uTest,static_cast<Word>(i));
+			uResult = 1;
+		}
+	} while (++i<cCount);
+
+	// Multiply in place
+	Matrix4D_t::Multiply(Input1,Input1,Input2,cCount);
+	Word uTest = MemoryCompare(Input1,Output,sizeof(Output))!=0;
+	ReportFailure("Matrix4D_t::Multiply(Matrix4D_t *,const Matrix4D_t *,const Matrix4D_t *,WordPtr) in place",uTest);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Test Inverse() by multiplying with the original matrix
+//
+
+static Word TestInverse(void)
+{
+	const WordPtr cCount = 16;
+	Word uResult = 0;
+	Matrix4D_t Input[cCount];
+	FillMatrices(Input,cCount,0x1234567U);
+
+	Matrix4D_t Identity;
+	Identity.Identity();
+	WordPtr i = 0;
+	do {
+		// Make the matrix diagonally dominant so it's well conditioned
+		Input[i].x.x += 16.0f;
+		Input[i].y.y += 16.0f;
+		Input[i].z.z += 16.0f;
+		Input[i].w.w += 16.0f;
+		Matrix4D_t Inverse;
+		Word uTest = !Inverse.Inverse(&Input[i]);
+		Matrix4D_t Test;
+		Test.Multiply(&Input[i],&Inverse);
+		uTest |= MatrixDiffers(&Test,&Identity,0.0001f);
+		// Invert in place
+		Test = Input[i];
+		Test.Inverse(&Test);
+		uTest |= MatrixDiffers(&Test,&Inverse,0.0f);
+		if (uTest) {
+			ReportFailure("Matrix4D_t::Inverse() entry %u",uTest,static_cast<Word>(i));
+			uResult = 1;
+		}
+	} while (++i<cCount);
+
+	// Affine matrices must match AffineInverse()
+	Matrix4D_t Affine;
+	Affine.SetYXZ(0.5f,-0.25f,1.25f);
+	Affine.w.x = 3.0f;
+	Affine.w.y = -5.0f;
+	Affine.w.z = 7.0f;
+	Matrix4D_t Expected;
+	Expected.AffineInverse(&Affine);
+	Matrix4D_t Test;
+	Word uTest = !Test.Inverse(&Affine);
+	uTest |= MatrixDiffers(&Test,&Expected,0.0001f);
+	ReportFailure("Matrix4D_t::Inverse() != Matrix4D_t::AffineInverse()",uTest);
+	uResult |= uTest;
+
+	// Singular matrices fail and copy the input
+	Matrix4D_t Singular = Affine;
+	Singular.y = Singular.x;
+	uTest = Test.Inverse(&Singular)!=FALSE;
+	uTest |= MemoryCompare(&Test,&Singular,sizeof(Test))!=0;
+	ReportFailure("Matrix4D_t::Inverse() of a singular matrix",uTest);
+	uResult |= uTest;
+	return uResult;
+}
+
+//
+// Fill an array with points that are not too large so
+// the perspective divide stays in range
+//
+
+static void FillPoints(Vector3D_t *pOutput,WordPtr uCount)
+{
+	Word32 uSeed = 0x12345679U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		pOutput[i].x = static_cast<float>(static_cast<int>(uSeed>>16U)&0x3FF)*(1.0f/128.0f)-4.0f;
+		uSeed = (uSeed*1103515245U)+12345U;
+		pOutput[i].y = static_cast<float>(static_cast<int>(uSeed>>16U)&0x3FF)*(1.0f/128.0f)-4.0f;
+		uSeed = (uSeed*1103515245U)+12345U;
+		pOutput[i].z = static_cast<float>(static_cast<int>(uSeed>>16U)&0x3FF)*(1.0f/128.0f)+8.0f;
+	} while (++i<uCount);
+}
+
+//
+// Test the array and structure of arrays transforms against
+// the single vector functions
+//
+
+static Word TestBatchTransform(void)
+{
+	const WordPtr cCount = 37;		// Not a multiple of 4 or 8
+	Word uResult = 0;
+	Matrix4D_t Matrix;
+	Matrix.SetYXZ(0.5f,-0.25f,1.25f);
+	Matrix.x.w = 3.0f;
+	Matrix.y.w = -5.0f;
+	Matrix.z.w = 7.0f;
+
+	// w = z for the perspective divide
+	Matrix4D_t Perspective = Matrix;
+	Perspective.w.x = 0.0f;
+	Perspective.w.y = 0.0f;
+	Perspective.w.z = 1.0f;
+	Perspective.w.w = 0.0f;
+
+	Vector3D_t Input[cCount+1];
+	Vector3D_t Output[cCount+1];
+	Vector3D_t Expected;
+	float SoAInput[3][cCount];
+	float SoAOutput[3][cCount];
+	FillPoints(Input,cCount+1);
+
+	Word uMode = 0;
+	do {
+		// Start at an odd offset to test misaligned arrays
+		WordPtr uStart = 0;
+		do {
+			WordPtr uCount = cCount-uStart;
+			Vector3DSoA_t SoAIn;
+			SoAIn.m_pX = SoAInput[0];
+			SoAIn.m_pY = SoAInput[1];
+			SoAIn.m_pZ = SoAInput[2];
+			Vector3DSoA_t SoAOut;
+			SoAOut.m_pX = SoAOutput[0]+uStart;
+			SoAOut.m_pY = SoAOutput[1]+uStart;
+			SoAOut.m_pZ = SoAOutput[2]+uStart;
+			WordPtr i = 0;
+			do {
+				SoAInput[0][i] = Input[i+uStart].x;
+				SoAInput[1][i] = Input[i+uStart].y;
+				SoAInput[2][i] = Input[i+uStart].z;
+			} while (++i<uCount);
+
+			if (!uMode) {
+				Matrix.Transform(Output+uStart,Input+uStart,uCount);
+				Matrix.Transform(&SoAOut,&SoAIn,uCount);
+			} else if (uMode==1) {
+				Matrix.Transform3x3(Output+uStart,Input+uStart,uCount);
+				Matrix.Transform3x3(&SoAOut,&SoAIn,uCount);
+			} else {
+				Perspective.TransformPerspective(Output+uStart,Input+uStart,uCount);
+				Perspective.TransformPerspective(&SoAOut,&SoAIn,uCount);
+			}
+			i = 0;
+			do {
+				const Vector3D_t *pInput = &Input[i+uStart];
+				if (!uMode) {
+					Matrix.Transform(&Expected,pInput);
+				} else if (uMode==1) {
+					Matrix.Transform3x3(&Expected,pInput);
+				} else {
+					Perspective.TransformPerspective(&Expected,pInput);
+				}
+				Vector3D_t SoAResult;
+				SoAResult.x = SoAOut.m_pX[i];
+				SoAResult.y = SoAOut.m_pY[i];
+				SoAResult.z = SoAOut.m_pZ[i];
+				Word uTest = !Expected.Equal(&Output[i+uStart],0.0001f) || !Expected.Equal(&SoAResult,0.0001f);
+				if (uTest) {
+					ReportFailure("Matrix4D_t batch transform mode %u, entry %u = %g,%g,%g / %g,%g,%g, expected %g,%g,%g",uTest,
+						uMode,static_cast<Word>(i+uStart),Output[i+uStart].x,Output[i+uStart].y,Output[i+uStart].z,
+						SoAResult.x,SoAResult.y,SoAResult.z,Expected.x,Expected.y,Expected.z);
+					uResult = 1;
+					break;
+				}
+			} while (++i<uCount);
+		} while (++uStart<4);
+	} while (++uMode<3);
+
+	// Transforming in place must give the same answer
+	Vector3D_t InPlace[cCount];
+	MemoryCopy(InPlace,Input,sizeof(InPlace));
+	Matrix.Transform(InPlace,InPlace,cCount);
+	Matrix.Transform(Output,Input,cCount);
+	Word uTest = MemoryCompare(InPlace,Output,sizeof(InPlace))!=0;
+	ReportFailure("Matrix4D_t::Transform(Vector3D_t *,const Vector3D_t *,WordPtr) in place",uTest);
+	uResult |= uTest;
+
+	// Vector4D_t arrays
+	Vector4D_t Input4D[cCount];
+	Vector4D_t Output4D[cCount];
+	WordPtr i = 0;
+	do {
+		Input4D[i].x = Input[i].x;
+		Input4D[i].y = Input[i].y;
+		Input4D[i].z = Input[i].z;
+		Input4D[i].w = static_cast<float>(static_cast<int>(i&3U))-1.5f;
+	} while (++i<cCount);
+	Perspective.Transform(Output4D,Input4D,cCount);
+	i = 0;
+	do {
+		Vector4D_t Expected4D;
+		Perspective.Transform(&Expected4D,&Input4D[i]);
+		uTest = (Abs(Expected4D.x-Output4D[i].x)>0.0001f) || (Abs(Expected4D.y-Output4D[i].y)>0.0001f) ||
+			(Abs(Expected4D.z-Output4D[i].z)>0.0001f) || (Abs(Expected4D.w-Output4D[i].w)>0.0001f);
+		if (uTest) {
+			ReportFailure("Matrix4D_t::Transform(Vector4D_t *,const Vector4D_t *,WordPtr) entry %u",uTest,static_cast<Word>(i));
+			uResult = 1;
+			break;
+		}
+	} while (++i<cCount);
+	return uResult;
+}
+
+//
+// Compare the speed of the batch transforms
+//
+
+static void TestBatchTransformSpeed(void)
+{
+	const WordPtr cCount = 4096;
+	const Word cPasses = 256;
+	Vector3D_t *pInput = static_cast<Vector3D_t *>(Alloc(sizeof(Vector3D_t)*cCount*2));
+	float *pSoA = static_cast<float *>(Alloc(sizeof(float)*cCount*6));
+	if (pInput && pSoA) {
+		Vector3D_t *pOutput = pInput+cCount;
+		FillPoints(pInput,cCount);
+		Vector3DSoA_t SoAIn;
+		SoAIn.m_pX = pSoA;
+		SoAIn.m_pY = pSoA+cCount;
+		SoAIn.m_pZ = pSoA+(cCount*2);
+		Vector3DSoA_t SoAOut;
+		SoAOut.m_pX = pSoA+(cCount*3);
+		SoAOut.m_pY = pSoA+(cCount*4);
+		SoAOut.m_pZ = pSoA+(cCount*5);
+		WordPtr i = 0;
+		do {
+			SoAIn.m_pX[i] = pInput[i].x;
+			SoAIn.m_pY[i] = pInput[i].y;
+			SoAIn.m_pZ[i] = pInput[i].z;
+		} while (++i<cCount);
+
+		Matrix4D_t Matrix;
+		Matrix.SetYXZ(0.5f,-0.25f,1.25f);
+		Matrix.x.w = 3.0f;
+		Matrix.y.w = -5.0f;
+		Matrix.z.w = 7.0f;
+
+		Word j = 0;
+		do {
+			Word uPasses = cPasses;
+			FloatTimer Timer;
+			do {
+				if (!j) {
+					i = 0;
+					do {
+						Matrix.Transform(&pOutput[i],&pInput[i]);
+					} while (++i<cCount);
+				} else if (j==1) {
+					Matrix.Transform(pOutput,pInput,cCount);
+				} else {
+					Matrix.Transform(&SoAOut,&SoAIn,cCount);
+				}
+			} while (--uPasses);
+			float fTime = Timer.GetTime();
+			if (fTime<=0.0f) {
+				fTime = 0.000001f;
+			}
+			static const char *s_Names[3] = {"Transform() per point","Transform() array","Transform() SoA"};
+			Message("Matrix4D_t::%s %u Mpoints/s",s_Names[j],static_cast<Word>(static_cast<float>(cPasses*cCount)/(1000000.0f*fTime)));
+		} while (++j<3);
+	}
+	Free(pSoA);
+	Free(pInput);
+}
+
+//
+// Compare the speed of the matrix multiplies and inverses
+//
+
+static void TestMultiplySpeed(void)
+{
+	const WordPtr cCount = 1024;
+	const Word cPasses = 256;
+	Matrix4D_t *pBuffer = static_cast<Matrix4D_t *>(Alloc(sizeof(Matrix4D_t)*cCount*3));
+	if (pBuffer) {
+		Matrix4D_t *pParents = pBuffer;
+		Matrix4D_t *pLocals = pBuffer+cCount;
+		Matrix4D_t *pOutput = pBuffer+(cCount*2);
+		FillMatrices(pParents,cCount,0x3141592U);
+		FillMatrices(pLocals,cCount,0x2718281U);
+		Word j = 0;
+		do {
+			Word uPasses = cPasses;
+			FloatTimer Timer;
+			do {
+				WordPtr i = 0;
+				if (!j) {
+					do {
+						pOutput[i].Multiply(&pParents[i],&pLocals[i]);
+					} while (++i<cCount);
+				} else if (j==1) {
+					Matrix4D_t::Multiply(pOutput,pParents,pLocals,cCount);
+				} else if (j==2) {
+					do {
+						pOutput[i].AffineInverse(&pLocals[i]);
+					} while (++i<cCount);
+				} else {
+					do {
+						pOutput[i].Inverse(&pLocals[i]);
+					} while (++i<cCount);
+				}
+			} while (--uPasses);
+			float fTime = Timer.GetTime();
+			if (fTime<=0.0f) {
+				fTime = 0.000001f;
+			}
+			static const char *s_Names[4] = {"Multiply() per matrix","Multiply() array","AffineInverse()","Inverse()"};
+			Message("Matrix4D_t::%s %u Kmatrices/s",s_Names[j],static_cast<Word>(static_cast<float>(cPasses*cCount)/(1000.0f*fTime)));
+		} while (++j<4);
+	}
+	Free(pBuffer);
+}
+
+//
+// Fill spheres and boxes that are scattered in front of and
+// around a camera looking down -z
+//
+
+static void FillVolumes(BoundingSphere_t *pSpheres,BoundingBox_t *pBoxes,WordPtr uCount)
+{
+	Word32 uSeed = 0x2468ACE1U;
+	WordPtr i = 0;
+	do {
+		float fValues[6];
+		Word j = 0;
+		do {
+			uSeed = (uSeed*1103515245U)+12345U;
+			fValues[j] = static_cast<float>(static_cast<int>(uSeed>>16U)&0x3FF)*(1.0f/1024.0f);
+		} while (++j<6);
+		float fX = fValues[0]*80.0f-40.0f;
+		float fY = fValues[1]*80.0f-40.0f;
+		float fZ = fValues[2]*-120.0f+10.0f;
+		pSpheres[i].m_Center.x = fX;
+		pSpheres[i].m_Center.y = fY;
+		pSpheres[i].m_Center.z = fZ;
+		pSpheres[i].m_fRadius = fValues[3]*4.0f;
+		pBoxes[i].m_Min.x = fX;
+		pBoxes[i].m_Min.y = fY;
+		pBoxes[i].m_Min.z = fZ;
+		pBoxes[i].m_Max.x = fX+fValues[3]*6.0f;
+		pBoxes[i].m_Max.y = fY+fValues[4]*6.0f;
+		pBoxes[i].m_Max.z = fZ+fValues[5]*6.0f;
+	} while (++i<uCount);
+}
+
+//
+// Test the frustum plane extraction and the culling tests
+//
+
+static Word TestFrustum(void)
+{
+	Word uResult = 0;
+	Matrix4D_t Projection;
+	Projection.SetFrustum(-1.0f,1.0f,-1.0f,1.0f,1.0f,100.0f);
+	Frustum_t Frustum;
+	Frustum.TransposeSet(&Projection);
+
+	// Set() with the transposed matrix must give the same planes
+	Matrix4D_t Transposed;
+	Transposed.Transpose(&Projection);
+	Frustum_t Frustum2;
+	Frustum2.Set(&Transposed);
+	Word uTest = MemoryCompare(&Frustum,&Frustum2,sizeof(Frustum))!=0;
+	ReportFailure("Frustum_t::Set() doesn't match Frustum_t::TransposeSet()",uTest);
+	uResult |= uTest;
+
+	// Points, at z = -10 the frustum is -10 to 10 wide
+	static const float s_Points[][4] = {
+		{0.0f,0.0f,-10.0f,1.0f},
+		{9.0f,-9.0f,-10.0f,1.0f},
+		{0.0f,0.0f,10.0f,0.0f},
+		{0.0f,0.0f,-0.5f,0.0f},
+		{0.0f,0.0f,-200.0f,0.0f},
+		{11.0f,0.0f,-10.0f,0.0f},
+		{0.0f,-11.0f,-10.0f,0.0f}
+	};
+	WordPtr i = 0;
+	do {
+		Vector3D_t Point;
+		Point.x = s_Points[i][0];
+		Point.y = s_Points[i][1];
+		Point.z = s_Points[i][2];
+		Word uExpected = s_Points[i][3]!=0.0f;
+		uTest = Frustum.TestPoint(&Point)!=uExpected;
+		ReportFailure("Frustum_t::TestPoint(%g,%g,%g) != %u",uTest,Point.x,Point.y,Point.z,uExpected);
+		uResult |= uTest;
+	} while (++i<BURGER_ARRAYSIZE(s_Points));
+
+	// A sphere 1 unit past the right edge at z = -10 is 0.707 units away
+	BoundingSphere_t Sphere;
+	Sphere.m_Center.x = 11.0f;
+	Sphere.m_Center.y = 0.0f;
+	Sphere.m_Center.z = -10.0f;
+	Sphere.m_fRadius = 0.5f;
+	uTest = Frustum.TestSphere(&Sphere)!=FALSE;
+	ReportFailure("Frustum_t::TestSphere() didn't cull the sphere",uTest);
+	uResult |= uTest;
+	Sphere.m_fRadius = 1.0f;
+	uTest = Frustum.TestSphere(&Sphere)!=TRUE;
+	ReportFailure("Frustum_t::TestSphere() culled the sphere",uTest);
+	uResult |= uTest;
+
+	// A box that straddles the right plane and one behind the camera
+	BoundingBox_t Box;
+	Box.m_Min.x = 9.0f;
+	Box.m_Min.y = -1.0f;
+	Box.m_Min.z = -11.0f;
+	Box.m_Max.x = 12.0f;
+	Box.m_Max.y = 1.0f;
+	Box.m_Max.z = -9.0f;
+	uTest = Frustum.TestBox(&Box)!=TRUE;
+	ReportFailure("Frustum_t::TestBox() culled the box",uTest);
+	uResult |= uTest;
+	Box.m_Min.z = 0.0f;
+	Box.m_Max.z = 5.0f;
+	uTest = Frustum.TestBox(&Box)!=FALSE;
+	ReportFailure("Frustum_t::TestBox() didn't cull the box",uTest);
+	uResult |= uTest;
+
+	// Use a rotated camera for the array tests
+	Matrix4D_t Camera;
+	Camera.TransposeSetYXZ(0.25f,-0.125f,0.5f);
+	Camera.TransposeTranslate(1.0f,-2.0f,3.0f);
+	Matrix4D_t ViewProjection;
+	ViewProjection.Multiply(&Camera,&Projection);
+	Frustum.TransposeSet(&ViewProjection);
+
+	// Test every count from 0 to 69 to check the partial masks
+	const WordPtr cCount = 69;
+	BoundingSphere_t Spheres[cCount];
+	BoundingBox_t Boxes[cCount];
+	FillVolumes(Spheres,Boxes,cCount);
+	WordPtr uCount = 0;
+	do {
+		Word32 SphereMask[4];
+		Word32 BoxMask[4];
+		MemoryFill(SphereMask,0xAA,sizeof(SphereMask));
+		MemoryFill(BoxMask,0x55,sizeof(BoxMask));
+		WordPtr uSphereCount = Frustum.TestSpheres(SphereMask,Spheres,uCount);
+		WordPtr uBoxCount = Frustum.TestBoxes(BoxMask,Boxes,uCount);
+		Word32 ExpectedSpheres[4];
+		Word32 ExpectedBoxes[4];
+		MemoryFill(ExpectedSpheres,0xAA,sizeof(ExpectedSpheres));
+		MemoryFill(ExpectedBoxes,0x55,sizeof(ExpectedBoxes));
+		WordPtr uExpectedSpheres = 0;
+		WordPtr uExpectedBoxes = 0;
+		i = 0;
+		while (i<uCount) {
+			if (!(i&31U)) {
+				ExpectedSpheres[i>>5U] = 0;
+				ExpectedBoxes[i>>5U] = 0;
+			}
+			if (Frustum.TestSphere(&Spheres[i])) {
+				ExpectedSpheres[i>>5U] |= 1U<<(i&31U);
+				++uExpectedSpheres;
+			}
+			if (Frustum.TestBox(&Boxes[i])) {
+				ExpectedBoxes[i>>5U] |= 1U<<(i&31U);
+				++uExpectedBoxes;
+			}
+			++i;
+		}
+		uTest = (uSphereCount!=uExpectedSpheres) || MemoryCompare(SphereMask,ExpectedSpheres,sizeof(SphereMask));
+		ReportFailure("Frustum_t::TestSpheres(%u) = %u, expected %u",uTest,static_cast<Word>(uCount),static_cast<Word>(uSphereCount),static_cast<Word>(uExpectedSpheres));
+		uResult |= uTest;
+		uTest = (uBoxCount!=uExpectedBoxes) || MemoryCompare(BoxMask,ExpectedBoxes,sizeof(BoxMask));
+		ReportFailure("Frustum_t::TestBoxes(%u) = %u, expected %u",uTest,static_cast<Word>(uCount),static_cast<Word>(uBoxCount),static_cast<Word>(uExpectedBoxes));
+		uResult |= uTest;
+		// Make sure that the test data has both visible and culled volumes
+		if (uCount==(cCount-1)) {
+			uTest = (!uSphereCount || (uSphereCount==uCount) || !uBoxCount || (uBoxCount==uCount));
+			ReportFailure("Frustum_t test data is all visible or all culled",uTest);
+			uResult |= uTest;
+		}
+	} while (++uCount<cCount);
+	return uResult;
+}
+
+//
+// Compare the speed of the single and array culling tests
+//
+
+static void TestFrustumSpeed(void)
+{
+	const WordPtr cCount = 4096;
+	const Word cPasses = 256;
+	BoundingSphere_t *pSpheres = static_cast<BoundingSphere_t *>(Alloc(sizeof(BoundingSphere_t)*cCount));
+	BoundingBox_t *pBoxes = static_cast<BoundingBox_t *>(Alloc(sizeof(BoundingBox_t)*cCount));
+	Word32 *pVisible = static_cast<Word32 *>(Alloc(sizeof(Word32)*(cCount/32)));
+	if (pSpheres && pBoxes && pVisible) {
+		FillVolumes(pSpheres,pBoxes,cCount);
+		Matrix4D_t Projection;
+		Projection.SetFrustum(-1.0f,1.0f,-1.0f,1.0f,1.0f,100.0f);
+		Frustum_t Frustum;
+		Frustum.TransposeSet(&Projection);
+
+		WordPtr uVisible = 0;
+		Word j = 0;
+		do {
+			Word uPasses = cPasses;
+			FloatTimer Timer;
+			do {
+				WordPtr i = 0;
+				if (!j) {
+					do {
+						uVisible += Frustum.TestSphere(&pSpheres[i]);
+					} while (++i<cCount);
+				} else if (j==1) {
+					uVisible += Frustum.TestSpheres(pVisible,pSpheres,cCount);
+				} else if (j==2) {
+					do {
+						uVisible += Frustum.TestBox(&pBoxes[i]);
+					} while (++i<cCount);
+				} else {
+					uVisible += Frustum.TestBoxes(pVisible,pBoxes,cCount);
+				}
+			} while (--uPasses);
+			float fTime = Timer.GetTime();
+			if (fTime<=0.0f) {
+				fTime = 0.000001f;
+			}
+			static const char *s_Names[4] = {"TestSphere()","TestSpheres()","TestBox()","TestBoxes()"};
+			Message("Frustum_t::%s %u Mvolumes/s",s_Names[j],static_cast<Word>(static_cast<float>(cPasses*cCount)/(1000000.0f*fTime)));
+		} while (++j<4);
+		// Use the result so the loops aren't removed
+		if (!uVisible) {
+			Message("Frustum_t culled every volume");
+		}
+	}
+	Free(pVisible);
+	Free(pBoxes);
+	Free(pSpheres);
+}
+
 //
 // Perform all the tests for the Burgerlib FP Math library
 //
 
-int BURGER_API TestBrmatrix4d(void)
+int BURGER_API TestBrmatrix4d(Word bVerbose)
 {
 #if !defined(BURGER_68K)
 
 	Word uTotal;	// Assume no failures
 
-	Message("Running Matrix4D tests");
+	if (bVerbose) {
+		Message("Running Matrix4D tests");
+	}
 	uTotal = TestMultiply();
+	uTotal |= TestMultiplyArray();
+	uTotal |= TestInverse();
+	uTotal |= TestBatchTransform();
+	uTotal |= TestFrustum();
+
+	if (bVerbose) {
+		MemoryManagerGlobalANSI Memory;
+		TestBatchTransformSpeed();
+		TestMultiplySpeed();
+		TestFrustumSpeed();
+	}
 
+	if (!uTotal && bVerbose) {
+		Message("Passed all Matrix4D tests!");
+	}
 	return static_cast<int>(uTotal);
 #else
 	return 0;
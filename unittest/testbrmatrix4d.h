@@ -18,6 +18,6 @@
 #include "brtypes.h"
 #endif
 
-extern int BURGER_API TestBrmatrix4d(void);
+extern int BURGER_API TestBrmatrix4d(Word bVerbose);
 
 #endif
@@ -17,6 +17,16 @@
 #include "bratomic.h"
 #include "brfloatingpoint.h"
 #include "brglobals.h"
+#include "brjobscheduler.h"
+#include "brrunqueue.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryansi.h"
+#include "brmemoryhandle.h"
+#include "brmemoryarena.h"
+#include "broutputmemorystream.h"
+#include "brcriticalsection.h"
+#include "brstringfunctions.h"
+#include "brtick.h"
 #include "common.h"
 #include <stdio.h>
 
@@ -425,6 +435,13 @@ static Word BURGER_API TestPlatformMacros(Word bVerbose)
 	++uTest;
 #endif
 
+#if defined(BURGER_LINUX)
+	if (bVerbose) {
+		Message("BURGER_LINUX is defined");
+	}
+	++uTest;
+#endif
+
 	//
 	// Android and their sub platforms
 	//
@@ -897,6 +914,7 @@ static void BURGER_API ShowCPUFeatures(Word bVerbose)
 			Message("CPUID_t.m_uCPUID7EBX = 0x%08X",MyID.m_uCPUID7EBX);
 			Message("CPUID_t.m_uCPUID7ECX = 0x%08X",MyID.m_uCPUID7ECX);
 			Message("CPUID_t.m_uCPUID7EDX = 0x%08X",MyID.m_uCPUID7EDX);
+			Message("CPUID_t.m_uXGETBV0 = 0x%08X",MyID.m_uXGETBV0);
 			Message("CPUID_t.m_uCPUType = %u",static_cast<Word>(MyID.m_uCPUType));
 			Message("CPUID_t.m_CPUName = %s",MyID.m_CPUName);
 			Message("CPUID_t.m_BrandName = %s",MyID.m_BrandName);
@@ -942,6 +960,15 @@ static void BURGER_API ShowCPUFeatures(Word bVerbose)
 			if (MyID.HasAVX()) {
 				Message("HasAVX");
 			}
+			if (MyID.IsAVXEnabled()) {
+				Message("IsAVXEnabled");
+			}
+			if (MyID.HasAVX2()) {
+				Message("HasAVX2");
+			}
+			if (MyID.HasSHA()) {
+				Message("HasSHA");
+			}
 			if (MyID.HasCMPXCHG16B()) {
 				Message("HasCMPXCHG16B");
 			}
@@ -1152,6 +1179,845 @@ static void BURGER_API ShowPlatformFeatures(Word bVerbose)
 #endif
 }
 
+/***************************************
+
+	Test the RunQueue
+
+***************************************/
+
+struct RunQueueTest_t {
+	Burger::RunQueue *m_pQueue;		// Queue being tested
+	Burger::RunQueue::RunQueueEntry *m_pVictim;	// Entry to remove during a call
+	Word m_uCount;					// Number of calls made
+	char m_Order[16];				// Order of the calls
+};
+
+static RunQueueTest_t g_RunQueueTest;
+
+static Burger::RunQueue::eReturnCode BURGER_API RecordCall(void *pData)
+{
+	if (g_RunQueueTest.m_uCount<(sizeof(g_RunQueueTest.m_Order)-1)) {
+		g_RunQueueTest.m_Order[g_RunQueueTest.m_uCount] = static_cast<char>(reinterpret_cast<WordPtr>(pData));
+	}
+	++g_RunQueueTest.m_uCount;
+	return Burger::RunQueue::OKAY;
+}
+
+static Burger::RunQueue::eReturnCode BURGER_API DisposeCall(void *pData)
+{
+	RecordCall(pData);
+	return Burger::RunQueue::DISPOSE;
+}
+
+static Burger::RunQueue::eReturnCode BURGER_API RemoveVictim(void *pData)
+{
+	RecordCall(pData);
+	// Remove another entry and add a new one during Call()
+	g_RunQueueTest.m_pQueue->Remove(g_RunQueueTest.m_pVictim);
+	g_RunQueueTest.m_pQueue->Add(RecordCall,NULL,reinterpret_cast<void *>('N'),Burger::RunQueue::PRIORITY_FIRST);
+	return Burger::RunQueue::OKAY;
+}
+
+static Burger::RunQueue::eReturnCode BURGER_API RemoveSelf(void *pData)
+{
+	RecordCall(pData);
+	g_RunQueueTest.m_pQueue->Remove(RemoveSelf,pData);
+	return Burger::RunQueue::OKAY;
+}
+
+static Burger::RunQueue::eReturnCode BURGER_API AddLower(void *pData)
+{
+	RecordCall(pData);
+	g_RunQueueTest.m_pQueue->Add(RecordCall,NULL,reinterpret_cast<void *>('L'),1);
+	return Burger::RunQueue::OKAY;
+}
+
+static Burger::RunQueue::eReturnCode BURGER_API SlowCall(void * /* pData */)
+{
+	Burger::Sleep(2);
+	return Burger::RunQueue::OKAY;
+}
+
+static Word BURGER_API RunQueueOrder(const char *pExpected)
+{
+	g_RunQueueTest.m_Order[g_RunQueueTest.m_uCount] = 0;
+	g_RunQueueTest.m_pQueue->Call();
+	g_RunQueueTest.m_Order[g_RunQueueTest.m_uCount] = 0;
+	Word uTest = Burger::StringCompare(g_RunQueueTest.m_Order,pExpected)!=0;
+	ReportFailure("RunQueue::Call() order was \"%s\", expected \"%s\"",uTest,g_RunQueueTest.m_Order,pExpected);
+	g_RunQueueTest.m_uCount = 0;
+	return uTest;
+}
+
+static Word BURGER_API TestRunQueue(void)
+{
+	Burger::RunQueue Queue;
+	g_RunQueueTest.m_pQueue = &Queue;
+	g_RunQueueTest.m_uCount = 0;
+
+	// Higher priorities first, like priorities in the order added
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('c'),5);
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('a'),10);
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('d'),5);
+	Burger::RunQueue::RunQueueEntry *pLast = Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('e'),1);
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('b'),10);
+	Word uFailure = RunQueueOrder("abcde");
+
+	// Remove by handle, the last of its priority
+	Queue.Remove(pLast);
+	uFailure |= RunQueueOrder("abcd");
+	pLast = Queue.Add(DisposeCall,NULL,reinterpret_cast<void *>('x'),5);
+	uFailure |= RunQueueOrder("abcdx");
+	uFailure |= RunQueueOrder("abcd");
+
+	// Remove another entry and add one while executing
+	Burger::RunQueue::RunQueueEntry *pVictim = Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('v'),7);
+	g_RunQueueTest.m_pVictim = pVictim;
+	Burger::RunQueue::RunQueueEntry *pRemover = Queue.Add(RemoveVictim,NULL,reinterpret_cast<void *>('r'),8);
+	uFailure |= RunQueueOrder("abrcd");
+	Queue.Remove(pRemover);
+	uFailure |= RunQueueOrder("Nabcd");
+	Queue.Add(RemoveSelf,NULL,reinterpret_cast<void *>('s'),20);
+	uFailure |= RunQueueOrder("Nsabcd");
+	uFailure |= RunQueueOrder("Nabcd");
+	Queue.RemoveAll(RecordCall);
+	uFailure |= RunQueueOrder("");
+
+	// Entries added during Call() wait for the next pass, even
+	// if they are placed after entries that haven't been called yet
+	Burger::RunQueue::RunQueueEntry *pAdder = Queue.Add(AddLower,NULL,reinterpret_cast<void *>('A'),10);
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('z'),5);
+	uFailure |= RunQueueOrder("Az");
+	Queue.Remove(pAdder);
+	uFailure |= RunQueueOrder("zL");
+	Queue.RemoveAll(RecordCall);
+
+	// Delayed and periodic entries
+	Burger::Tick::WaitOneTick();
+	Queue.AddDelayed(RecordCall,NULL,reinterpret_cast<void *>('D'),2);
+	Burger::RunQueue::RunQueueEntry *pPeriodic = Queue.AddPeriodic(RecordCall,NULL,reinterpret_cast<void *>('P'),1,1);
+	Word uTest = (Queue.Find(RecordCall,reinterpret_cast<void *>('D'))==NULL) || (pPeriodic->GetPeriod()!=1);
+	ReportFailure("RunQueue::Find() didn't find a timed entry",uTest);
+	uFailure |= uTest;
+	uFailure |= RunQueueOrder("");
+	Burger::Tick::WaitOneTick();
+	uFailure |= RunQueueOrder("P");
+	Burger::Tick::WaitOneTick();
+	Burger::Tick::WaitOneTick();
+	uFailure |= RunQueueOrder("DP");
+	Burger::Tick::WaitOneTick();
+	uFailure |= RunQueueOrder("P");
+	uTest = Queue.Find(RecordCall,reinterpret_cast<void *>('D'))!=NULL;
+	ReportFailure("RunQueue::AddDelayed() entry wasn't disposed of",uTest);
+	uFailure |= uTest;
+	Queue.Remove(pPeriodic);
+	Burger::Tick::WaitOneTick();
+	uFailure |= RunQueueOrder("");
+
+	// Timing statistics
+	Queue.SetTiming(TRUE);
+	Queue.Add(RecordCall,NULL,reinterpret_cast<void *>('a'));
+	Burger::RunQueue::RunQueueEntry *pSlow = Queue.Add(SlowCall);
+	Queue.Call();
+	Queue.Call();
+	uTest = (Queue.FindSlowest()!=pSlow) || (pSlow->GetCallCount()!=2) || (pSlow->GetMaxTime()<1000U);
+	ReportFailure("RunQueue::FindSlowest() didn't find the slow entry",uTest);
+	uFailure |= uTest;
+	Queue.ResetTiming();
+	uTest = (Queue.FindSlowest()!=NULL) || pSlow->GetCallCount();
+	ReportFailure("RunQueue::ResetTiming() didn't clear the timing",uTest);
+	uFailure |= uTest;
+	return uFailure;
+}
+
+/***************************************
+
+	Test the job scheduler
+
+***************************************/
+
+struct JobTest_t {
+	Word32 *m_pOutput;				// Array to fill
+	volatile Word32 m_uCallCount;	// Number of calls made
+	volatile Word32 m_uFlag;		// Set by the first group of jobs
+	volatile Word32 m_uBadOrder;	// Set if a dependency was ignored
+	Burger::JobScheduler *m_pScheduler;		// Scheduler for nested jobs
+};
+
+static void BURGER_API FillRange(void *pData,WordPtr uStart,WordPtr uEnd,Word /* uSlot */)
+{
+	JobTest_t *pTest = static_cast<JobTest_t *>(pData);
+	Burger::AtomicPreIncrement(&pTest->m_uCallCount);
+	do {
+		pTest->m_pOutput[uStart] += static_cast<Word32>(uStart)*3U+1U;
+	} while (++uStart<uEnd);
+}
+
+static void BURGER_API CountJob(void *pData,Word /* uSlot */)
+{
+	JobTest_t *pTest = static_cast<JobTest_t *>(pData);
+	Burger::AtomicPreIncrement(&pTest->m_uCallCount);
+}
+
+static void BURGER_API FirstJob(void *pData,Word /* uSlot */)
+{
+	JobTest_t *pTest = static_cast<JobTest_t *>(pData);
+	Burger::Sleep(1);
+	Burger::AtomicPreIncrement(&pTest->m_uFlag);
+}
+
+static void BURGER_API SecondJob(void *pData,Word /* uSlot */)
+{
+	JobTest_t *pTest = static_cast<JobTest_t *>(pData);
+	if (pTest->m_uFlag!=4) {
+		Burger::AtomicSwap(&pTest->m_uBadOrder,1);
+	}
+}
+
+static void BURGER_API NestedJob(void *pData,Word uSlot)
+{
+	JobTest_t *pTest = static_cast<JobTest_t *>(pData);
+	pTest->m_pScheduler->ParallelFor(1000,FillRange,pTest,7,uSlot);
+}
+
+static Word BURGER_API TestJobScheduler(Burger::JobScheduler *pScheduler)
+{
+	const Word cCount = 10007;
+	Word uFailure = 0;
+	Word32 Output[cCount];
+	JobTest_t Test;
+	Test.m_pOutput = Output;
+	Test.m_pScheduler = pScheduler;
+
+	// Every index must be visited exactly once
+	Burger::MemoryClear(Output,sizeof(Output));
+	Test.m_uCallCount = 0;
+	pScheduler->ParallelFor(cCount,FillRange,&Test);
+	Word i = 0;
+	do {
+		if (Output[i]!=(i*3U+1U)) {
+			break;
+		}
+	} while (++i<cCount);
+	Word uTest = i!=cCount;
+	ReportFailure("Burger::JobScheduler::ParallelFor() index %u was wrong with %u workers",uTest,i,pScheduler->GetWorkerCount());
+	uFailure |= uTest;
+
+	// A grain size of 1 calls the function for every index
+	Burger::MemoryClear(Output,sizeof(Output));
+	Test.m_uCallCount = 0;
+	pScheduler->ParallelFor(500,FillRange,&Test,1);
+	uTest = Test.m_uCallCount!=500;
+	ReportFailure("Burger::JobScheduler::ParallelFor() made %u calls, expected 500",uTest,Test.m_uCallCount);
+	uFailure |= uTest;
+
+	// Add more jobs than a queue can hold
+	Burger::JobScheduler::Counter Counter;
+	Test.m_uCallCount = 0;
+	i = 0;
+	do {
+		pScheduler->Add(CountJob,&Test,&Counter);
+	} while (++i<(Burger::JobScheduler::QUEUESIZE*2));
+	pScheduler->Wait(&Counter);
+	uTest = (Test.m_uCallCount!=(Burger::JobScheduler::QUEUESIZE*2)) || !Counter.IsDone();
+	ReportFailure("Burger::JobScheduler::Add() made %u calls, expected %u",uTest,Test.m_uCallCount,Burger::JobScheduler::QUEUESIZE*2);
+	uFailure |= uTest;
+
+	// Jobs that depend on another group must run after it
+	Burger::JobScheduler::Counter First;
+	Burger::JobScheduler::Counter Second;
+	Test.m_uFlag = 0;
+	Test.m_uBadOrder = 0;
+	i = 0;
+	do {
+		pScheduler->Add(SecondJob,&Test,&Second,0,&First);
+	} while (++i<4);
+	i = 0;
+	do {
+		pScheduler->Add(FirstJob,&Test,&First);
+	} while (++i<4);
+	pScheduler->Wait(&Second);
+	uTest = (Test.m_uBadOrder!=0) || (Test.m_uFlag!=4);
+	ReportFailure("Burger::JobScheduler::Add() ran a job before its dependency",uTest);
+	uFailure |= uTest;
+
+	// Jobs can start a ParallelFor() on their own slot
+	Burger::MemoryClear(Output,sizeof(Output));
+	pScheduler->Add(NestedJob,&Test,&Counter);
+	pScheduler->Add(NestedJob,&Test,&Counter);
+	pScheduler->Wait(&Counter);
+	i = 0;
+	do {
+		if (Output[i]!=((i*3U+1U)*2U)) {
+			break;
+		}
+	} while (++i<1000);
+	uTest = i!=1000;
+	ReportFailure("Burger::JobScheduler nested ParallelFor() index %u was wrong",uTest,i);
+	uFailure |= uTest;
+	return uFailure;
+}
+
+//
+// Time a ParallelFor() with enough work per index
+// to show the scaling
+//
+
+static void BURGER_API SpinRange(void *pData,WordPtr uStart,WordPtr uEnd,Word /* uSlot */)
+{
+	float *pOutput = static_cast<float *>(pData);
+	do {
+		float fValue = static_cast<float>(uStart);
+		Word i = 0;
+		do {
+			fValue = fValue*0.999f+1.0f;
+		} while (++i<256);
+		pOutput[uStart] = fValue;
+	} while (++uStart<uEnd);
+}
+
+static void BURGER_API TestJobSchedulerSpeed(Burger::JobScheduler *pScheduler)
+{
+	const WordPtr cCount = 65536;
+	float *pBuffer = static_cast<float *>(Burger::Alloc(sizeof(float)*cCount));
+	if (pBuffer) {
+		Burger::FloatTimer Timer;
+		SpinRange(pBuffer,0,cCount,0);
+		float fSerial = Timer.GetTime();
+		Timer.Reset();
+		Word32 uSteals = pScheduler->GetStealCount();
+		pScheduler->ParallelFor(cCount,SpinRange,pBuffer);
+		float fParallel = Timer.GetTime();
+		if (fParallel<=0.0f) {
+			fParallel = 0.000001f;
+		}
+		Message("Burger::JobScheduler::ParallelFor() %u threads, %g ms serial, %g ms parallel, %u steals",pScheduler->GetSlotCount(),
+			fSerial*1000.0f,fParallel*1000.0f,pScheduler->GetStealCount()-uSteals);
+	}
+	Burger::Free(pBuffer);
+}
+
+static Word BURGER_API TestJobSchedulers(Word bVerbose)
+{
+	Word uFailure;
+	{
+		// Test with no worker threads
+		Burger::JobScheduler Single(0);
+		uFailure = TestJobScheduler(&Single);
+	}
+	{
+		// Test with more workers than CPUs to force stealing
+		Burger::JobScheduler Many(Burger::JobScheduler::GetCPUCount()+2);
+		uFailure |= TestJobScheduler(&Many);
+	}
+	if (bVerbose) {
+		Burger::MemoryManagerGlobalANSI Memory;
+		Burger::JobScheduler Default;
+		Message("Burger::JobScheduler::GetCPUCount() = %u",Burger::JobScheduler::GetCPUCount());
+		TestJobSchedulerSpeed(&Default);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test starting threads
+
+	Thread::Start() waits for the new thread to signal that
+	it's running. Start and stop threads many times so a
+	thread that touches a dead startup semaphore is caught.
+
+***************************************/
+
+static WordPtr BURGER_API ThreadStartProc(void *pData)
+{
+	return reinterpret_cast<WordPtr>(pData)+1;
+}
+
+static Word BURGER_API TestThreadStart(void)
+{
+	Word uFailure = FALSE;
+	Burger::Thread Test;
+	Word i = 0;
+	do {
+		Word uTest = Test.Start(ThreadStartProc,reinterpret_cast<void *>(static_cast<WordPtr>(i)));
+		Test.Wait();
+		uTest |= Test.GetResult()!=static_cast<WordPtr>(i+1);
+		uFailure |= uTest;
+		ReportFailure("Burger::Thread::Start() pass %u returned %u",uTest,i,static_cast<Word>(Test.GetResult()));
+		if (uTest) {
+			break;
+		}
+	} while (++i<1000);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the out of memory path of the handle manager
+
+	When the pool is full, AllocHandle() calls CompactHandles()
+	with the lock held, so this deadlocks if the lock
+	isn't recursive.
+
+***************************************/
+
+static Word BURGER_API TestHandleOutOfMemory(void)
+{
+	Burger::MemoryManagerHandle Handles(0x10000);
+	void **ppMovable = Handles.AllocHandle(0x20000);
+	void **ppFixed = Handles.AllocHandle(0x20000,Burger::MemoryManagerHandle::FIXED);
+	Word uFailure = !ppMovable || !ppFixed;
+	ReportFailure("Burger::MemoryManagerHandle::AllocHandle() larger than the pool failed",uFailure);
+	Handles.FreeHandle(ppMovable);
+	Handles.FreeHandle(ppFixed);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the small allocation size classes
+
+	Check the sizes on each side of every class boundary
+	go to the right class, that blocks are reused and that
+	Realloc() moves blocks only when the class changes.
+
+***************************************/
+
+static Word BURGER_API TestSlabAllocator(void)
+{
+	Burger::MemoryManagerHandle Handles(0x100000);
+	Burger::MemoryManagerHandle::SlabStats_t Before;
+	Burger::MemoryManagerHandle::SlabStats_t After;
+	Word uFailure = FALSE;
+
+	// Sizes at the edges of each class
+	Word uClass = 0;
+	WordPtr uBlockSize = Burger::MemoryManagerHandle::SLABMINIMUMSIZE;
+	do {
+		WordPtr uLow = (uBlockSize>>1U)+1;
+		if (!uClass) {
+			uLow = 1;
+		}
+		WordPtr uSize = uLow;
+		do {
+			Handles.GetSlabStats(&Before,uClass);
+			void *pBlock = Handles.Alloc(uSize);
+			Handles.GetSlabStats(&After,uClass);
+			Word uTest = !pBlock || (reinterpret_cast<WordPtr>(pBlock)&(Burger::MemoryManagerHandle::ALIGNMENT-1)) ||
+				(After.m_uBlockSize!=uBlockSize) || (After.m_uInUse!=(Before.m_uInUse+1)) ||
+				(Burger::MemoryManagerHandle::GetSize(pBlock)!=uBlockSize);
+			Handles.Free(pBlock);
+			Handles.GetSlabStats(&After,uClass);
+			uTest |= (After.m_uInUse!=Before.m_uInUse) || (After.m_uFrees!=(Before.m_uFrees+1));
+			uFailure |= uTest;
+			ReportFailure("Burger::MemoryManagerHandle::Alloc(%u) didn't use the %u byte size class",uTest,static_cast<Word>(uSize),static_cast<Word>(uBlockSize));
+			uSize = (uSize==uLow) ? uBlockSize : 0;
+		} while (uSize);
+		uBlockSize <<= 1U;
+	} while (++uClass<Burger::MemoryManagerHandle::SLABCLASSCOUNT);
+
+	// One byte too large for the size classes
+	WordPtr uInUse = 0;
+	uClass = 0;
+	do {
+		Handles.GetSlabStats(&Before,uClass);
+		uInUse += Before.m_uInUse;
+	} while (++uClass<Burger::MemoryManagerHandle::SLABCLASSCOUNT);
+	void *pLarge = Handles.Alloc(Burger::MemoryManagerHandle::SLABMAXIMUMSIZE+1);
+	uClass = 0;
+	do {
+		Handles.GetSlabStats(&After,uClass);
+		uInUse -= After.m_uInUse;
+	} while (++uClass<Burger::MemoryManagerHandle::SLABCLASSCOUNT);
+	Word uTest = !pLarge || uInUse || (Burger::MemoryManagerHandle::GetSize(pLarge)<=Burger::MemoryManagerHandle::SLABMAXIMUMSIZE);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerHandle::Alloc(%u) used a size class",uTest,static_cast<Word>(Burger::MemoryManagerHandle::SLABMAXIMUMSIZE+1));
+	Handles.Free(pLarge);
+
+	// Freed blocks are reused
+	void *pFirst = Handles.Alloc(40);
+	Handles.Free(pFirst);
+	Handles.GetSlabStats(&Before,2);
+	void *pSecond = Handles.Alloc(64);
+	Handles.GetSlabStats(&After,2);
+	uTest = (pFirst!=pSecond) || (After.m_uHits!=(Before.m_uHits+1)) || (After.m_uMisses!=Before.m_uMisses);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerHandle::Alloc() didn't reuse a freed block",uTest);
+
+	// Realloc() only moves when the size class changes
+	Burger::MemoryFill(pSecond,0x3C,64);
+	uTest = Handles.Realloc(pSecond,50)!=pSecond;
+	Word8 *pGrown = static_cast<Word8 *>(Handles.Realloc(pSecond,100));
+	uTest |= !pGrown || (pGrown==pSecond) || (Burger::MemoryManagerHandle::GetSize(pGrown)!=128) ||
+		(pGrown[0]!=0x3C) || (pGrown[63]!=0x3C);
+	Word8 *pShrunk = static_cast<Word8 *>(Handles.Realloc(pGrown,20));
+	uTest |= !pShrunk || (Burger::MemoryManagerHandle::GetSize(pShrunk)!=32) || (pShrunk[19]!=0x3C);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerHandle::Realloc() of a small block failed",uTest);
+	Handles.Free(pShrunk);
+	return uFailure;
+}
+
+/***************************************
+
+	Test incremental compaction
+
+	Leave gaps between handles and compact one handle
+	per step. Release the handle that the next step will
+	examine, first with FreeHandle() and then with Purge(),
+	and make sure compaction continues with the next handle
+	and no data is damaged.
+
+***************************************/
+
+static void BURGER_API FillHandle(void **ppData,Word uIndex)
+{
+	Burger::MemoryFill(ppData[0],static_cast<Word8>(uIndex+1),0x1000);
+}
+
+static Word BURGER_API CheckHandle(void **ppData,Word uIndex)
+{
+	const Word8 *pData = static_cast<const Word8 *>(ppData[0]);
+	Word i = 0;
+	do {
+		if (pData[i]!=static_cast<Word8>(uIndex+1)) {
+			return TRUE;
+		}
+	} while (++i<0x1000);
+	return FALSE;
+}
+
+static Word BURGER_API TestIncrementalCompaction(void)
+{
+	Burger::MemoryManagerHandle Handles(0x100000);
+	void **Blocks[8];
+	Word i = 0;
+	do {
+		Blocks[i] = Handles.AllocHandle(0x1000);
+		if (!Blocks[i]) {
+			ReportFailure("Burger::MemoryManagerHandle::AllocHandle() failed",TRUE);
+			return TRUE;
+		}
+		FillHandle(Blocks[i],i);
+	} while (++i<BURGER_ARRAYSIZE(Blocks));
+
+	// Leave a gap below every odd handle
+	i = 0;
+	do {
+		Handles.FreeHandle(Blocks[i]);
+	} while ((i+=2)<BURGER_ARRAYSIZE(Blocks));
+
+	Burger::MemoryManagerHandle::FragmentationStats_t Before;
+	Burger::MemoryManagerHandle::FragmentationStats_t After;
+	Handles.GetFragmentationStats(&Before);
+
+	// Moves handle 1, stops before handle 3
+	Word uTest = Handles.CompactHandlesIncremental(0x1000);
+	Handles.GetFragmentationStats(&After);
+	uTest |= After.m_uHandlesMoved!=(Before.m_uHandlesMoved+1);
+
+	// Free the handle the cursor is on, handle 5 is next
+	Handles.FreeHandle(Blocks[3]);
+	uTest |= Handles.CompactHandlesIncremental(0x1000);
+	Handles.GetFragmentationStats(&After);
+	uTest |= After.m_uHandlesMoved!=(Before.m_uHandlesMoved+2);
+
+	// Purge the handle the cursor is on, nothing is left
+	Handles.Purge(Blocks[7]);
+	uTest |= !Handles.CompactHandlesIncremental(0x1000);
+	Handles.GetFragmentationStats(&After);
+	uTest |= (After.m_uHandlesMoved!=(Before.m_uHandlesMoved+2)) || (After.m_uCompactPasses!=(Before.m_uCompactPasses+1)) ||
+		(After.m_uBytesMoved!=(Before.m_uBytesMoved+0x2000));
+	uTest |= CheckHandle(Blocks[1],1) || CheckHandle(Blocks[5],5) || (Blocks[7][0]!=NULL);
+
+	// A new pass starts at the bottom
+	uTest |= !Handles.CompactHandlesIncremental(0);
+	Handles.GetFragmentationStats(&After);
+	uTest |= After.m_uCompactPasses!=(Before.m_uCompactPasses+2);
+	ReportFailure("Burger::MemoryManagerHandle::CompactHandlesIncremental() lost its place after a release",uTest);
+	Handles.FreeHandle(Blocks[1]);
+	Handles.FreeHandle(Blocks[5]);
+	Handles.FreeHandle(Blocks[7]);
+	return uTest;
+}
+
+/***************************************
+
+	Test the allocation statistics
+
+***************************************/
+
+static Word BURGER_API TestAllocationStats(void)
+{
+	Burger::MemoryManagerHandle Handles(0x100000);
+	Handles.ResetAllocationStats();
+
+	// 3 handles with ID 5, one with ID 6, release one of the ID 5 handles
+	void **Blocks[4];
+	Word i = 0;
+	do {
+		WordPtr uSize = (i==3) ? 0x300 : 0x1000;
+		Blocks[i] = Handles.AllocHandle(uSize);
+		if (!Blocks[i]) {
+			ReportFailure("Burger::MemoryManagerHandle::AllocHandle() failed",TRUE);
+			return TRUE;
+		}
+		Handles.SetID(Blocks[i],(i==3) ? 6U : 5U);
+	} while (++i<BURGER_ARRAYSIZE(Blocks));
+	Handles.FreeHandle(Blocks[0]);
+
+	Burger::MemoryManagerHandle::AllocationStats_t Stats;
+	Handles.GetAllocationStats(&Stats);
+	Word uTest = (Stats.m_uAllocations!=4) || (Stats.m_uFrees!=1) || (Stats.m_uFailures!=0);
+	// 0x1000 is in the 2^12 bucket and 0x300 is in the 2^9 bucket
+	uTest |= (Stats.m_Histogram[12]!=3) || (Stats.m_Histogram[9]!=1);
+	uTest |= (Stats.m_IDStats[5].m_uHandleCount!=2) || (Stats.m_IDStats[5].m_uBytes!=0x2000);
+	uTest |= (Stats.m_IDStats[6].m_uHandleCount!=1) || (Stats.m_IDStats[6].m_uBytes!=0x300);
+	// The peak was reached before the release
+	uTest |= Stats.m_uPeakAllocatedMemory<(Stats.m_uTotalAllocatedMemory+0x1000);
+	ReportFailure("Burger::MemoryManagerHandle::GetAllocationStats() returned the wrong counts",uTest);
+	Word uFailure = uTest;
+
+	// The JSON export has the same counts
+	Burger::OutputMemoryStream Output;
+	uTest = Handles.ExportStats(&Output);
+	uTest |= Output.Append('\0');
+	WordPtr uLength;
+	char *pText = static_cast<char *>(Output.Flatten(&uLength));
+	if (!pText) {
+		uTest = TRUE;
+	} else {
+		uTest |= (pText[0]!='{') || (pText[uLength-2]!='}');
+		uTest |= !Burger::StringString(pText,"\"allocations\":4,");
+		uTest |= !Burger::StringString(pText,"\"frees\":1,");
+		uTest |= !Burger::StringString(pText,"\"5\":{\"handles\":2,\"bytes\":8192}");
+		uTest |= !Burger::StringString(pText,"\"6\":{\"handles\":1,\"bytes\":768}");
+		uTest |= !Burger::StringString(pText,"\"fragmentation\":{");
+		Burger::Free(pText);
+	}
+	ReportFailure("Burger::MemoryManagerHandle::ExportStats() didn't match the statistics",uTest);
+	uFailure |= uTest;
+
+	// Reset clears the counters but keeps the live handles
+	Handles.ResetAllocationStats();
+	Handles.GetAllocationStats(&Stats);
+	uTest = (Stats.m_uAllocations!=0) || (Stats.m_uFrees!=0) || (Stats.m_Histogram[12]!=0) ||
+		(Stats.m_IDStats[5].m_uHandleCount!=2) || (Stats.m_uPeakAllocatedMemory!=Stats.m_uTotalAllocatedMemory);
+	ReportFailure("Burger::MemoryManagerHandle::ResetAllocationStats() failed",uTest);
+	uFailure |= uTest;
+
+	i = 1;
+	do {
+		Handles.FreeHandle(Blocks[i]);
+	} while (++i<BURGER_ARRAYSIZE(Blocks));
+	return uFailure;
+}
+
+/***************************************
+
+	Test the arena memory manager
+
+***************************************/
+
+static Word BURGER_API TestMemoryArena(void)
+{
+	Burger::MemoryManagerArena Arena(0x1000);
+
+	// Allocations are aligned and remember their size
+	Word8 *pFirst = static_cast<Word8 *>(Arena.Alloc(100));
+	Word8 *pSecond = static_cast<Word8 *>(Arena.Alloc(200));
+	Word uFailure = !pFirst || !pSecond || (Arena.Alloc(0)!=NULL);
+	ReportFailure("Burger::MemoryManagerArena::Alloc() failed",uFailure);
+	if (uFailure) {
+		return uFailure;
+	}
+	Word uTest = (reinterpret_cast<WordPtr>(pFirst)&(Burger::MemoryManagerArena::ALIGNMENT-1)) ||
+		(Burger::MemoryManagerArena::GetSize(pFirst)!=100) || (Burger::MemoryManagerArena::GetSize(pSecond)!=200) ||
+		!Arena.IsInArena(pSecond) || Arena.IsInArena(&uTest);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Alloc() returned a bad block",uTest);
+
+	// Only the last allocation is given back
+	Arena.Free(pSecond);
+	void *pThird = Arena.Alloc(50);
+	uTest = pThird!=pSecond;
+	Arena.Free(pFirst);
+	uTest |= Arena.Alloc(10)==pFirst;
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Free() didn't roll back only the last allocation",uTest);
+
+	// The last allocation grows in place, others are copied
+	Word8 *pLast = static_cast<Word8 *>(Arena.Alloc(16));
+	uTest = Arena.Realloc(pLast,400)!=pLast;
+	Burger::MemoryFill(pFirst,0x5A,100);
+	Word8 *pMoved = static_cast<Word8 *>(Arena.Realloc(pFirst,300));
+	uTest |= !pMoved || (pMoved==pFirst) || (Burger::MemoryManagerArena::GetSize(pMoved)!=300) ||
+		(pMoved[0]!=0x5A) || (pMoved[99]!=0x5A);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Realloc() failed",uTest);
+
+	// Running out of the chunk gets more memory from the system
+	WordPtr uSystem = Arena.GetTotalSystemMemory();
+	void *pBig = Arena.Alloc(0x2000);
+	uTest = !pBig || (Arena.GetTotalSystemMemory()<=uSystem) || !Arena.IsInArena(pBig);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Alloc() didn't add a chunk when full",uTest);
+
+	// Marks
+	Burger::MemoryManagerArena::Mark_t Mark;
+	Arena.GetMark(&Mark);
+	WordPtr uUsed = Arena.GetTotalAllocatedMemory();
+	void *pMarked = Arena.Alloc(0x800);
+	Arena.Alloc(0x800);
+	Arena.FreeToMark(&Mark);
+	uTest = (Arena.GetTotalAllocatedMemory()!=uUsed) || (Arena.Alloc(0x800)!=pMarked);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::FreeToMark() didn't restore the mark",uTest);
+
+	// Reset keeps the chunks
+	uSystem = Arena.GetTotalSystemMemory();
+	Arena.Reset();
+	uTest = Arena.GetTotalAllocatedMemory() || (Arena.GetTotalSystemMemory()!=uSystem) || (Arena.Alloc(100)!=pFirst);
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Reset() failed",uTest);
+
+	Arena.Shutdown();
+	uTest = Arena.GetTotalSystemMemory()!=0;
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerArena::Shutdown() didn't release the chunks",uTest);
+	return uFailure;
+}
+
+/***************************************
+
+	Test installing the arena as the global memory manager
+
+***************************************/
+
+struct ArenaThread_t {
+	Word m_uThread;		///< Value to fill the blocks with
+	Word m_uBad;		///< Number of failed allocations or overwritten blocks
+};
+
+static WordPtr BURGER_API ArenaThreadProc(void *pData)
+{
+	ArenaThread_t *pThread = static_cast<ArenaThread_t *>(pData);
+	Word8 *Blocks[256];
+	Word i = 0;
+	do {
+		WordPtr uSize = (i&31)+1;
+		Word8 *pBlock = static_cast<Word8 *>(Burger::Alloc(uSize));
+		Blocks[i] = pBlock;
+		if (pBlock) {
+			Burger::MemoryFill(pBlock,static_cast<Word8>(pThread->m_uThread),uSize);
+		}
+	} while (++i<BURGER_ARRAYSIZE(Blocks));
+	i = 0;
+	do {
+		const Word8 *pBlock = Blocks[i];
+		if (!pBlock) {
+			++pThread->m_uBad;
+		} else {
+			WordPtr uSize = (i&31)+1;
+			do {
+				--uSize;
+				if (pBlock[uSize]!=static_cast<Word8>(pThread->m_uThread)) {
+					++pThread->m_uBad;
+					break;
+				}
+			} while (uSize);
+		}
+	} while (++i<BURGER_ARRAYSIZE(Blocks));
+	return 0;
+}
+
+static Word BURGER_API TestGlobalArena(void)
+{
+	Burger::MemoryManagerGlobalANSI Memory;
+	Burger::MemoryManager *pANSI = Burger::GlobalMemoryManager::GetInstance();
+	Word8 *pOld = static_cast<Word8 *>(Burger::Alloc(64));
+	Burger::MemoryFill(pOld,0xA5,64);
+	Word uFailure;
+	{
+		Burger::MemoryManagerGlobalArena Arena(0x1000);
+		uFailure = Burger::GlobalMemoryManager::GetInstance()!=&Arena;
+		ReportFailure("Burger::MemoryManagerGlobalArena didn't install itself",uFailure);
+
+		void *pNew = Burger::Alloc(32);
+		Word uTest = !pNew || !Arena.IsInArena(pNew) || Arena.IsInArena(pOld);
+		uFailure |= uTest;
+		ReportFailure("Burger::MemoryManagerGlobalArena::Alloc() failed",uTest);
+
+		// Memory from before the arena stays with the previous manager
+		pOld = static_cast<Word8 *>(Burger::Realloc(pOld,128));
+		uTest = !pOld || Arena.IsInArena(pOld) || (pOld[0]!=0xA5) || (pOld[63]!=0xA5);
+		uFailure |= uTest;
+		ReportFailure("Burger::MemoryManagerGlobalArena::Realloc() didn't forward a foreign pointer",uTest);
+		Burger::Free(pNew);
+
+		// Allocate from several threads at once
+		const Word cThreads = 4;
+		ArenaThread_t Tests[cThreads];
+		Burger::Thread Threads[cThreads];
+		Word i = 0;
+		do {
+			Tests[i].m_uThread = i+1;
+			Tests[i].m_uBad = 0;
+			Threads[i].Start(ArenaThreadProc,&Tests[i]);
+		} while (++i<cThreads);
+		uTest = FALSE;
+		i = 0;
+		do {
+			Threads[i].Wait();
+			uTest |= Tests[i].m_uBad!=0;
+		} while (++i<cThreads);
+		uFailure |= uTest;
+		ReportFailure("Burger::MemoryManagerGlobalArena failed allocating from several threads",uTest);
+	}
+	Word uTest = Burger::GlobalMemoryManager::GetInstance()!=pANSI;
+	uFailure |= uTest;
+	ReportFailure("Burger::MemoryManagerGlobalArena didn't restore the previous manager",uTest);
+	Burger::Free(pOld);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the global memory call counters
+
+***************************************/
+
+static Word BURGER_API TestGlobalStats(void)
+{
+	Burger::MemoryManagerGlobalANSI Memory;
+	Burger::GlobalMemoryManager::Stats_t Before;
+	Burger::GlobalMemoryManager::Stats_t After;
+
+	// Nothing is counted until the counters are enabled
+	Burger::GlobalMemoryManager::GetStats(&Before);
+	void *pData = Burger::Alloc(100);
+	Burger::Free(pData);
+	Burger::GlobalMemoryManager::GetStats(&After);
+	Word uTest = Burger::GlobalMemoryManager::AreStatsEnabled() ||
+		(After.m_uAllocations!=Before.m_uAllocations) || (After.m_uFrees!=Before.m_uFrees);
+
+	// 2 allocations, 1 resize and 2 releases
+	Burger::GlobalMemoryManager::EnableStats(TRUE);
+	Burger::GlobalMemoryManager::ResetStats();
+	pData = Burger::Alloc(100);
+	void *pCopy = Burger::AllocCopy(pData,100);
+	pData = Burger::Realloc(pData,200);
+	Burger::Free(pData);
+	Burger::Free(pCopy);
+	Burger::GlobalMemoryManager::EnableStats(FALSE);
+	Burger::GlobalMemoryManager::GetStats(&After);
+	uTest |= (After.m_uAllocations!=2) || (After.m_uReallocations!=1) ||
+		(After.m_uFrees!=2) || (After.m_uFailures!=0);
+	ReportFailure("Burger::GlobalMemoryManager::GetStats() returned the wrong counts",uTest);
+	return uTest;
+}
+
 /***************************************
 
 	Perform the tests for the macros and compiler
@@ -1175,6 +2041,16 @@ int BURGER_API TestBrtypes(Word bVerbose)
 	uFailure |= TestPlatformMacros(bVerbose);
 	uFailure |= TestDataChunkSize(bVerbose);
 	uFailure |= TestStructureAlignment(bVerbose);
+	uFailure |= TestRunQueue();
+	uFailure |= TestJobSchedulers(bVerbose);
+	uFailure |= TestThreadStart();
+	uFailure |= TestHandleOutOfMemory();
+	uFailure |= TestSlabAllocator();
+	uFailure |= TestIncrementalCompaction();
+	uFailure |= TestAllocationStats();
+	uFailure |= TestMemoryArena();
+	uFailure |= TestGlobalArena();
+	uFailure |= TestGlobalStats();
 
 	// Print messages about features found on the platform
 